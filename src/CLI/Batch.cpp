@@ -0,0 +1,119 @@
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/algorithm/string/trim.hpp>
+#include <boost/nowide/fstream.hpp>
+#include <boost/nowide/iostream.hpp>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+
+#include "libslic3r/libslic3r.h"
+#include "libslic3r/Print.hpp"
+#include "libslic3r/SLAPrint.hpp"
+
+#include "CLI.hpp"
+
+namespace Slic3r::CLI {
+
+struct BatchJob
+{
+    // The job line as shown by the summary.
+    std::string                 line;
+    std::vector<std::string>    args;
+    bool                        success { false };
+    double                      seconds { 0. };
+};
+
+static bool load_manifest(const std::string& manifest, std::vector<BatchJob>& jobs)
+{
+    boost::nowide::ifstream is(manifest);
+    if (!is) {
+        boost::nowide::cerr << "Cannot open the batch manifest " << manifest << std::endl;
+        return false;
+    }
+    auto add_job = [&jobs](const std::string& line) { jobs.push_back({ line, split_job(line) }); };
+    std::vector<std::string> inputs;
+    std::vector<std::string> overlays;
+    for (std::string line; std::getline(is, line);) {
+        boost::algorithm::trim(line);
+        if (line.empty() || line.front() == '#')
+            continue;
+        if (boost::starts_with(line, "input:"))
+            inputs.emplace_back(boost::algorithm::trim_copy(line.substr(6)));
+        else if (boost::starts_with(line, "overlay:"))
+            overlays.emplace_back(boost::algorithm::trim_copy(line.substr(8)));
+        else
+            add_job(line);
+    }
+    if (overlays.empty())
+        for (const std::string& input : inputs)
+            add_job(input);
+    else if (inputs.empty())
+        for (const std::string& overlay : overlays)
+            add_job(overlay);
+    else
+        for (const std::string& input : inputs)
+            for (const std::string& overlay : overlays)
+                add_job(input + " " + overlay);
+    return true;
+}
+
+static bool run_batch_job(Session& session, const std::vector<std::string>& args)
+{
+    Data cli;
+    cli.session = &session;
+    // Loading, arranging and applying the models accesses global state, only the slicing runs concurrently.
+    cli.global_state_lock = std::unique_lock<std::mutex>(session.global_state_mutex);
+    if (!setup_job(cli, args))
+        return false;
+
+    PrinterTechnology   printer_technology = get_printer_technology(cli.overrides_config);
+    DynamicPrintConfig  print_config;
+    std::vector<Model>  models;
+    try {
+        return load_print_data(models, print_config, printer_technology, cli) &&
+               process_transform(cli, print_config, models) &&
+               process_actions(cli, print_config, models);
+    } catch (const std::exception& ex) {
+        boost::nowide::cerr << ex.what() << std::endl;
+        return false;
+    }
+}
+
+int run_batch(const std::string& manifest, size_t num_concurrent, const JobArenaConfig& arena_config)
+{
+    std::vector<BatchJob> jobs;
+    if (!load_manifest(manifest, jobs))
+        return 1;
+
+    // The jobs share the parsed configuration files and the models, but each job slices with its own Print.
+    Session session;
+    session.fff_print.reset();
+    session.sla_print.reset();
+
+    const auto          batch_start = std::chrono::steady_clock::now();
+    std::atomic<size_t> next_job { 0 };
+    // The jobs share a single task arena, thus a job waiting for the global state lock yields its share
+    // of the worker threads to the jobs slicing meanwhile.
+    execute_in_shared_job_arena(arena_config, num_concurrent, [&jobs, &next_job, &session](size_t /* thread_idx */) {
+        for (size_t idx = next_job ++; idx < jobs.size(); idx = next_job ++) {
+            BatchJob&  job   = jobs[idx];
+            const auto start = std::chrono::steady_clock::now();
+            job.success = run_batch_job(session, job.args);
+            job.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+    });
+    const double batch_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - batch_start).count();
+
+    size_t num_failed = 0;
+    boost::nowide::cout << "Batch summary:" << std::endl;
+    for (size_t idx = 0; idx < jobs.size(); ++ idx) {
+        const BatchJob& job = jobs[idx];
+        num_failed += ! job.success;
+        boost::nowide::cout << std::setw(5) << idx + 1 << std::setw(10) << std::fixed << std::setprecision(2) << job.seconds << " s  "
+            << (job.success ? "OK    " : "ERROR ") << job.line << std::endl;
+    }
+    boost::nowide::cout << jobs.size() << " jobs, " << num_failed << " failed, total time " << std::fixed << std::setprecision(2) << batch_seconds << " s" << std::endl;
+    return num_failed == 0 ? 0 : 1;
+}
+
+}
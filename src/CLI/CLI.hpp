@@ -1,17 +1,59 @@
 #pragma once
 
+#include <ctime>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
 #include "libslic3r/Model.hpp"
+#include "libslic3r/Thread.hpp"
 #include "CLI_DynamicPrintConfig.hpp"
 
 #ifdef SLIC3R_GUI
 #include "slic3r/GUI/GUI_Init.hpp"
 #endif
 
+namespace Slic3r {
+    class Print;
+    class SLAPrint;
+}
+
 namespace Slic3r::CLI
 {
+    // State kept alive between the jobs of a slicing server (see run_server()) or shared by the jobs of a batch (see run_batch()).
+    class Session
+    {
+    public:
+        Session();
+        ~Session();
+
+        // Load a model geometry, reuse the model loaded by one of the previous jobs if the file did not change.
+        // The copy keeps the object IDs of the cached model, thus Print::apply() recognizes the unchanged objects.
+        Model                       load_model(const std::string& input_file);
+        // Load a config file (--load), reuse the config parsed by one of the previous jobs if the file did not change.
+        // The substitutions are only returned to the job, which parsed the file.
+        ConfigSubstitutions         load_config(const std::string& file, ForwardCompatibilitySubstitutionRule rule, DynamicPrintConfig& config);
+
+        // Reused between the jobs, so that Print::apply() only invalidates what has changed.
+        // Null for a batch, whose jobs run concurrently, each with its own Print.
+        std::unique_ptr<Print>      fff_print;
+        std::unique_ptr<SLAPrint>   sla_print;
+
+        // Held by a batch job while it loads, arranges and applies its models, which accesses global state (the multiple beds).
+        std::mutex                  global_state_mutex;
+
+    private:
+        struct CachedConfig {
+            std::time_t                             mtime;
+            ForwardCompatibilitySubstitutionRule    rule;
+            DynamicPrintConfig                      config;
+        };
+        std::map<std::string, std::pair<std::time_t, Model>> m_models;
+        std::map<std::string, CachedConfig>                  m_configs;
+    };
+
     // struct which is filled from comand line input
     struct Data
     {
@@ -25,6 +67,11 @@ namespace Slic3r::CLI
 
         std::vector<std::string>    input_files;
 
+        // Not null if the data is a job of a slicing server or of a batch.
+        Session*                    session { nullptr };
+        // Locks Session::global_state_mutex while a batch job runs, released by process_actions() while slicing.
+        std::unique_lock<std::mutex> global_state_lock;
+
         bool empty() {
             return input_files.empty()
                 && input_config.empty()
@@ -41,6 +88,10 @@ namespace Slic3r::CLI
     // Implemented in Setup.cpp
 
     bool    setup(Data& cli, int argc, char** argv);
+    // Parse the command line of a single job of a slicing server, the global setup is not repeated.
+    bool    setup_job(Data& cli, const std::vector<std::string>& args);
+    // Task arena limits of a job given by --threads, --numa-node and --low-priority.
+    JobArenaConfig  job_arena_config(const Data& cli);
 
     // Implemented in LoadPrintData.cpp
 
@@ -61,6 +112,20 @@ namespace Slic3r::CLI
     bool    process_profiles_sharing(const Data& cli);
     bool    process_actions(Data& cli, const DynamicPrintConfig& print_config, std::vector<Model>& models);
 
+    // Implemented in Server.cpp
+
+            // Accept slicing jobs at localhost:port until a "quit" job is received.
+            // A job is a single line with the command line parameters of a CLI invocation.
+    int     run_server(int port);
+            // Split the job line into the command line parameters. Parameters containing spaces are to be quoted.
+    std::vector<std::string> split_job(const std::string& line);
+
+    // Implemented in Batch.cpp
+
+            // Execute the jobs of a batch manifest, num_concurrent of them at the same time in a single task arena.
+            // Print a timing summary of the jobs. Returns non-zero if any of the jobs failed.
+    int     run_batch(const std::string& manifest, size_t num_concurrent, const JobArenaConfig& arena_config);
+
     // Implemented in GuiParams.cpp
 #ifdef SLIC3R_GUI
             // set data for init GUI parameters
@@ -72,7 +72,7 @@ static bool load_print_config(DynamicPrintConfig &print_config, PrinterTechnolog
             DynamicPrintConfig  config;
             ConfigSubstitutions config_substitutions;
             try {
-                config_substitutions = config.load(file, config_substitution_rule);
+                config_substitutions = cli.session ? cli.session->load_config(file, config_substitution_rule, config) : config.load(file, config_substitution_rule);
             }
             catch (std::exception& ex) {
                 boost::nowide::cerr << "Error while reading config file \"" << file << "\": " << ex.what() << std::endl;
@@ -132,7 +132,7 @@ static bool process_input_files(std::vector<Model>& models, DynamicPrintConfig&
             if (has_full_config_from_profiles(cli) || !FileReader::is_project_file(file)) {
                 // we have full banch of options from profiles set
                 // so, just load a geometry
-                model = FileReader::load_model(file);
+                model = cli.session ? cli.session->load_model(file) : FileReader::load_model(file);
             }
             else {
                 // load model and configuration from the file
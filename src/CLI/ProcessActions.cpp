@@ -13,6 +13,8 @@
 #include <boost/nowide/iostream.hpp>
 #include <boost/nowide/fstream.hpp>
 #include <boost/dll/runtime_symbol_info.hpp>
+#include <oneapi/tbb/task_group.h>
+#include <mutex>
 
 #include "libslic3r/libslic3r.h"
 #if !SLIC3R_OPENGL_ES
@@ -21,6 +23,7 @@
 #include "libslic3r/Config.hpp"
 #include "libslic3r/Geometry.hpp"
 #include "libslic3r/GCode/PostProcessor.hpp"
+#include "libslic3r/GCode/ThumbnailRenderer.hpp"
 #include "libslic3r/Model.hpp"
 #include "libslic3r/Preset.hpp"
 #include <arrange-wrapper/ModelArrange.hpp>
@@ -35,6 +38,7 @@
 #include "libslic3r/PNGReadWrite.hpp"
 #include "libslic3r/MultipleBeds.hpp"
 #include "libslic3r/BuildVolume.hpp"
+#include "libslic3r/Utils/JsonUtils.hpp"
 
 #include "CLI/CLI.hpp"
 #include "CLI/ProfilesSharingUtils.hpp"
@@ -199,29 +203,36 @@ static ThumbnailData resize_and_crop(const std::vector<unsigned char>& data, int
 }
 
 
-static std::function<ThumbnailsList(const ThumbnailsParams&)> get_thumbnail_generator_cli(const std::string& filename)
+// Thumbnails are taken from the thumbnail stored in a 3MF input file. If there is none, they are rendered from the model
+// of the print by the software renderer, as there is no OpenGL context to render them with in the command line slicer.
+static std::function<ThumbnailsList(const ThumbnailsParams&)> get_thumbnail_generator_cli(const std::string& filename, const Print& print)
 {
+    ThumbnailsGeneratorCallback render_thumbnails = GCodeThumbnails::make_software_thumbnail_generator(print.model(),
+        GCodeThumbnails::extruder_colors_from_config(print.config().extruder_colour.values, print.config().filament_colour.values));
+
     if (boost::iends_with(filename, ".3mf")) {
-        return [filename](const ThumbnailsParams& params) {
+        return [filename, render_thumbnails](const ThumbnailsParams& params) {
             ThumbnailsList list_out;
 
             mz_zip_archive archive;
             mz_zip_zero_struct(&archive);
 
             if (!open_zip_reader(&archive, filename))
-                return list_out;
+                return render_thumbnails(params);
             mz_uint num_entries = mz_zip_reader_get_num_files(&archive);
             mz_zip_archive_file_stat stat;
 
             int index = mz_zip_reader_locate_file(&archive, "Metadata/thumbnail.png", nullptr, 0);
-            if (index < 0 || !mz_zip_reader_file_stat(&archive, index, &stat))
-                return list_out;
+            if (index < 0 || !mz_zip_reader_file_stat(&archive, index, &stat)) {
+                close_zip_reader(&archive);
+                return render_thumbnails(params);
+            }
             std::string buffer;
             buffer.resize(int(stat.m_uncomp_size));
             mz_bool res = mz_zip_reader_extract_file_to_mem(&archive, stat.m_filename, buffer.data(), (size_t)stat.m_uncomp_size, 0);
-            if (res == 0)
-                return list_out;
             close_zip_reader(&archive);
+            if (res == 0)
+                return render_thumbnails(params);
 
             std::vector<unsigned char> data;
             unsigned width = 0;
@@ -249,7 +260,7 @@ static std::function<ThumbnailsList(const ThumbnailsParams&)> get_thumbnail_gene
         };
     }
 
-    return [](const ThumbnailsParams&) ->ThumbnailsList { return {}; };
+    return render_thumbnails;
 }
 
 static void update_instances_outside_state(Model& model, const DynamicPrintConfig& config)
@@ -260,6 +271,140 @@ static void update_instances_outside_state(Model& model, const DynamicPrintConfi
     model.update_print_volume_state(build_volume);
 }
 
+// Append "_bed<n>" to the output file name, keeping the extension.
+static std::string bed_output_path(const std::string &path, int bed_idx)
+{
+    boost::filesystem::path p(path);
+    return (p.parent_path() / (p.stem().string() + "_bed" + std::to_string(bed_idx + 1) + p.extension().string())).string();
+}
+
+// Slice all occupied beds of a FFF model concurrently. Each bed gets its own Print, all the Prints are processed
+// by tasks of a single tbb::task_group, thus they share the default TBB arena and its work stealing scheduler.
+static bool export_gcode_all_beds(Model& model, const DynamicPrintConfig& print_config, const std::string& output, bool low_memory)
+{
+    struct BedJob {
+        int         bed_idx;
+        Model       model;
+        Print       print;
+        std::string outfile;
+        std::string error;
+    };
+
+    update_instances_outside_state(model, print_config);
+
+    std::vector<std::unique_ptr<BedJob>> jobs;
+    for (int bed_idx = 0; bed_idx < s_multiple_beds.get_number_of_beds(); ++ bed_idx)
+        if (s_multiple_beds.is_bed_occupied(bed_idx)) {
+            auto job = std::make_unique<BedJob>();
+            job->bed_idx = bed_idx;
+            MultipleBedsUtils::with_single_bed_model_fff(model, bed_idx, [&model, &job, bed_idx]() {
+                job->model = model;
+                // All the beds are processed with the first bed active, thus the per bed data is moved to the first bed.
+                job->model.get_wipe_tower_vector().front()                = model.wipe_tower(bed_idx);
+                job->model.get_custom_gcode_per_print_z_vector().front()  = model.get_custom_gcode_per_print_z_vector()[bed_idx];
+            });
+            for (ModelObject *mo : job->model.objects)
+                job->print.auto_assign_extruders(mo);
+            job->print.set_low_memory(low_memory);
+            jobs.emplace_back(std::move(job));
+        }
+
+    // Print::apply() and Print::process() access the active bed through Model::wipe_tower() and Model::custom_gcode_per_print_z().
+    s_multiple_beds.set_active_bed(0);
+
+    std::mutex cout_mutex;
+    for (std::unique_ptr<BedJob> &job : jobs) {
+        job->print.apply(job->model, print_config);
+        if (std::string err = job->print.validate(); ! err.empty()) {
+            boost::nowide::cerr << "Bed " << job->bed_idx + 1 << ": " << err << std::endl;
+            return false;
+        }
+        job->print.set_status_callback([&cout_mutex, bed_idx = job->bed_idx](const PrintBase::SlicingStatus& s) {
+            if (s.percent >= 0) {
+                std::lock_guard<std::mutex> lock(cout_mutex);
+                printf("[bed %d] %3d%s %s\n", bed_idx + 1, s.percent, "% =>", s.text.c_str());
+                std::fflush(stdout);
+            }
+        });
+    }
+
+    tbb::task_group group;
+    for (std::unique_ptr<BedJob> &job : jobs)
+        if (! job->print.empty())
+            group.run([&job, &output]() {
+                try {
+                    job->print.process();
+                    const std::string input_file = job->print.model().objects.empty() ? "" : job->print.model().objects.front()->input_file;
+                    job->outfile = job->print.export_gcode(bed_output_path(job->print.output_filepath(output), job->bed_idx), nullptr,
+                        get_thumbnail_generator_cli(input_file, job->print));
+                } catch (const std::exception &ex) {
+                    job->error = ex.what();
+                }
+            });
+    group.wait();
+
+    bool ok = true;
+    for (std::unique_ptr<BedJob> &job : jobs) {
+        if (job->print.empty()) {
+            boost::nowide::cout << "Nothing to print on bed " << job->bed_idx + 1 << "." << std::endl;
+            continue;
+        }
+        if (! job->error.empty()) {
+            boost::nowide::cerr << "Bed " << job->bed_idx + 1 << ": " << job->error << std::endl;
+            ok = false;
+            continue;
+        }
+        std::string outfile       = job->outfile;
+        std::string outfile_final = job->print.print_statistics().finalize_output_path(outfile);
+        if (outfile != outfile_final) {
+            if (Slic3r::rename_file(outfile, outfile_final)) {
+                boost::nowide::cerr << "Renaming file " << outfile << " to " << outfile_final << " failed" << std::endl;
+                return false;
+            }
+            outfile = outfile_final;
+        }
+        // Run the post-processing scripts if defined.
+        run_post_process_scripts(outfile, job->print.full_print_config());
+        boost::nowide::cout << "Slicing result of bed " << job->bed_idx + 1 << " exported to " << outfile << std::endl;
+    }
+    return ok;
+}
+
+// Print time and material estimates filled in by Print::estimate_gcode_statistics() as JSON.
+static std::string estimate_to_json(const PrintStatistics& stats)
+{
+    namespace pt = boost::property_tree;
+
+    pt::ptree time_node;
+    time_node.put("normal_s", stats.normal_print_time_seconds);
+    time_node.put("normal", stats.estimated_normal_print_time);
+    if (stats.estimated_silent_print_time != "N/A") {
+        time_node.put("silent_s", stats.silent_print_time_seconds);
+        time_node.put("silent", stats.estimated_silent_print_time);
+    }
+
+    pt::ptree extruders_node;
+    for (const auto& [extruder_id, volume] : stats.filament_stats) {
+        pt::ptree extruder_node;
+        extruder_node.put("extruder", extruder_id + 1);
+        extruder_node.put("volume_mm3", volume);
+        extruders_node.push_back(std::make_pair("", extruder_node));
+    }
+
+    pt::ptree filament_node;
+    filament_node.put("used_mm", stats.total_used_filament);
+    filament_node.put("volume_mm3", stats.total_extruded_volume);
+    filament_node.put("weight_g", stats.total_weight);
+    filament_node.put("cost", stats.total_cost);
+    filament_node.add_child("extruders", extruders_node);
+
+    pt::ptree root;
+    root.add_child("print_time", time_node);
+    root.add_child("filament", filament_node);
+    root.put("toolchanges", stats.total_toolchanges);
+    return write_json_with_post_process(root);
+}
+
 bool process_actions(Data& cli, const DynamicPrintConfig& print_config, std::vector<Model>& models)
 {
     DynamicPrintConfig& actions     = cli.actions_config;
@@ -319,8 +464,14 @@ bool process_actions(Data& cli, const DynamicPrintConfig& print_config, std::vec
             return 1;
     }
 
-    if (actions.has("slice") || actions.has("export_gcode") || actions.has("export_sla")) {
+    if (actions.has("slice") || actions.has("export_gcode") || actions.has("export_sla") || actions.has("estimate")) {
         PrinterTechnology       printer_technology = Preset::printer_technology(print_config);
+        // Only the print time and the material usage are requested, don't export anything.
+        const bool              estimate = actions.has("estimate");
+        if (estimate && printer_technology == ptSLA) {
+            boost::nowide::cerr << "error: the estimate is only available for an FFF configuration" << std::endl;
+            return 1;
+        }
         if (actions.has("export_gcode") && printer_technology == ptSLA) {
             boost::nowide::cerr << "error: cannot export G-code for an FFF configuration" << std::endl;
             return 1;
@@ -349,8 +500,18 @@ bool process_actions(Data& cli, const DynamicPrintConfig& print_config, std::vec
                     arrange_objects(model, bed, arrange_cfg);
             }
 
-            Print       fff_print;
-            SLAPrint    sla_print;
+            const bool low_memory = cli.misc_config.has("low_memory") && cli.misc_config.opt_bool("low_memory");
+            if (printer_technology == ptFFF && ! estimate && cli.misc_config.has("parallel_beds") && cli.misc_config.opt_bool("parallel_beds")) {
+                if (! export_gcode_all_beds(model, print_config, output, low_memory))
+                    return false;
+                continue;
+            }
+
+            // A slicing server keeps the Print objects between the jobs.
+            Print       fff_print_local;
+            SLAPrint    sla_print_local;
+            Print      &fff_print = cli.session && cli.session->fff_print ? *cli.session->fff_print : fff_print_local;
+            SLAPrint   &sla_print = cli.session && cli.session->sla_print ? *cli.session->sla_print : sla_print_local;
             sla_print.set_status_callback( [](const PrintBase::SlicingStatus& s) {
                 if (s.percent >= 0) { // FIXME: is this sufficient?
                     printf("%3d%s %s\n", s.percent, "% =>", s.text.c_str());
@@ -383,11 +544,34 @@ bool process_actions(Data& cli, const DynamicPrintConfig& print_config, std::vec
             else
                 try {
                 std::string outfile_final;
+                if (printer_technology == ptSLA)
+                    // The print is exported just once, write the layers into the archive as they are rasterized.
+                    sla_print.set_rasterize_on_export(true);
+                else {
+                    // The G-code is exported just once, release the data as soon as it is not needed anymore.
+                    fff_print.set_low_memory(low_memory);
+                    // Keep the console output of the estimate parseable as JSON.
+                    if (estimate)
+                        fff_print.set_status_silent();
+                    else
+                        fff_print.set_status_default();
+                }
+                // Slicing and the export do not access the global state, let the other jobs of a batch load their models meanwhile.
+                if (cli.global_state_lock.owns_lock())
+                    cli.global_state_lock.unlock();
+                if (estimate) {
+                    fff_print.process();
+                    fff_print.estimate_gcode_statistics();
+                    boost::nowide::cout << estimate_to_json(fff_print.print_statistics()) << std::endl;
+                    if (cli.global_state_lock.mutex() != nullptr && ! cli.global_state_lock.owns_lock())
+                        cli.global_state_lock.lock();
+                    continue;
+                }
                 print->process();
                 if (printer_technology == ptFFF) {
                     // The outfile is processed by a PlaceholderParser.
                     const std::string input_file = fff_print.model().objects.empty() ? "" : fff_print.model().objects.front()->input_file;
-                    outfile = fff_print.export_gcode(outfile, nullptr, get_thumbnail_generator_cli(input_file));
+                    outfile = fff_print.export_gcode(outfile, nullptr, get_thumbnail_generator_cli(input_file, fff_print));
                     outfile_final = fff_print.print_statistics().finalize_output_path(outfile);
                 }
                 else {
@@ -411,7 +595,8 @@ bool process_actions(Data& cli, const DynamicPrintConfig& print_config, std::vec
                 boost::nowide::cerr << ex.what() << std::endl;
                 return false;
             }
-
+            if (cli.global_state_lock.mutex() != nullptr && ! cli.global_state_lock.owns_lock())
+                cli.global_state_lock.lock();
         }
     }
 
@@ -1,6 +1,8 @@
 #include "../PrusaSlicer.hpp"
 #include "CLI.hpp"
 
+#include "libslic3r/Trace.hpp"
+
 namespace Slic3r::CLI {
 
 int run(int argc, char** argv)
@@ -9,6 +11,13 @@ int run(int argc, char** argv)
     if (!setup(cli, argc, argv))
         return 1;
 
+    if (cli.misc_config.has("server"))
+        return run_server(cli.misc_config.opt_int("server"));
+
+    if (cli.misc_config.has("batch"))
+        return run_batch(cli.misc_config.opt_string("batch"),
+            cli.misc_config.has("batch_jobs") ? size_t(std::max(cli.misc_config.opt_int("batch_jobs"), 1)) : 1, job_arena_config(cli));
+
     if (process_profiles_sharing(cli))
         return 1;
 
@@ -34,7 +43,13 @@ int run(int argc, char** argv)
     if (!process_transform(cli, print_config, models))
         return 1;
 
-    if (!process_actions(cli, print_config, models))
+    bool actions_processed = false;
+    execute_in_job_arena(job_arena_config(cli), [&]() { actions_processed = process_actions(cli, print_config, models); });
+    if (cli.misc_config.has("trace")) {
+        Trace::stop();
+        Trace::write_chrome_trace(cli.misc_config.opt_string("trace"));
+    }
+    if (!actions_processed)
         return 1;
 
     if (start_gui) {
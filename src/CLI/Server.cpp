@@ -0,0 +1,115 @@
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/read_until.hpp>
+#include <boost/asio/streambuf.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/algorithm/string/trim.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/nowide/iostream.hpp>
+#include <boost/tokenizer.hpp>
+
+#include "libslic3r/libslic3r.h"
+#include "libslic3r/FileReader.hpp"
+#include "libslic3r/Print.hpp"
+#include "libslic3r/SLAPrint.hpp"
+
+#include "CLI.hpp"
+
+namespace Slic3r::CLI {
+
+Session::Session() : fff_print(std::make_unique<Print>()), sla_print(std::make_unique<SLAPrint>()) {}
+Session::~Session() = default;
+
+Model Session::load_model(const std::string& input_file)
+{
+    const std::time_t mtime = boost::filesystem::last_write_time(input_file);
+    if (auto it = m_models.find(input_file); it != m_models.end() && it->second.first == mtime)
+        return it->second.second;
+    Model model = FileReader::load_model(input_file);
+    m_models[input_file] = { mtime, model };
+    return model;
+}
+
+ConfigSubstitutions Session::load_config(const std::string& file, ForwardCompatibilitySubstitutionRule rule, DynamicPrintConfig& config)
+{
+    const std::time_t mtime = boost::filesystem::last_write_time(file);
+    if (auto it = m_configs.find(file); it != m_configs.end() && it->second.mtime == mtime && it->second.rule == rule) {
+        config = it->second.config;
+        return {};
+    }
+    ConfigSubstitutions substitutions = config.load(file, rule);
+    m_configs[file] = { mtime, rule, config };
+    return substitutions;
+}
+
+std::vector<std::string> split_job(const std::string& line)
+{
+    std::vector<std::string> out;
+    boost::tokenizer<boost::escaped_list_separator<char>> tokens(line, boost::escaped_list_separator<char>('\\', ' ', '"'));
+    for (const std::string& token : tokens)
+        if (!token.empty())
+            out.emplace_back(token);
+    return out;
+}
+
+static bool run_job(Session& session, const std::vector<std::string>& args)
+{
+    Data cli;
+    cli.session = &session;
+    if (!setup_job(cli, args))
+        return false;
+
+    PrinterTechnology   printer_technology = get_printer_technology(cli.overrides_config);
+    DynamicPrintConfig  print_config;
+    std::vector<Model>  models;
+    try {
+        bool ok = false;
+        // Each job runs in its own task arena, thus the jobs may differ in the number of threads, NUMA node and priority.
+        execute_in_job_arena(job_arena_config(cli), [&]() {
+            ok = load_print_data(models, print_config, printer_technology, cli) &&
+                 process_transform(cli, print_config, models) &&
+                 process_actions(cli, print_config, models);
+        });
+        return ok;
+    } catch (const std::exception& ex) {
+        boost::nowide::cerr << ex.what() << std::endl;
+        return false;
+    }
+}
+
+int run_server(int port)
+{
+    using boost::asio::ip::tcp;
+
+    Session session;
+    try {
+        boost::asio::io_context io_context;
+        // Only accept local connections.
+        tcp::acceptor acceptor(io_context, tcp::endpoint(boost::asio::ip::address_v4::loopback(), port));
+        boost::nowide::cout << "Slicing server is listening at 127.0.0.1:" << port << std::endl;
+        for (;;) {
+            tcp::socket socket(io_context);
+            acceptor.accept(socket);
+            boost::system::error_code ec;
+            boost::asio::streambuf    buffer;
+            boost::asio::read_until(socket, buffer, '\n', ec);
+            if (ec && ec != boost::asio::error::eof)
+                continue;
+            std::string line { std::istreambuf_iterator<char>(&buffer), std::istreambuf_iterator<char>() };
+            line = line.substr(0, line.find('\n'));
+            boost::algorithm::trim(line);
+            if (line == "quit") {
+                boost::asio::write(socket, boost::asio::buffer(std::string("OK\n")), ec);
+                break;
+            }
+            const bool success = run_job(session, split_job(line));
+            boost::asio::write(socket, boost::asio::buffer(std::string(success ? "OK\n" : "ERROR\n")), ec);
+        }
+    } catch (const std::exception& ex) {
+        boost::nowide::cerr << "Slicing server failed: " << ex.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+}
@@ -10,6 +10,8 @@
 #include "libslic3r/PrintConfig.hpp"
 #include "libslic3r/Platform.hpp"
 #include "libslic3r/Utils.hpp"
+#include "libslic3r/SliceCache.hpp"
+#include "libslic3r/Trace.hpp"
 #include "libslic3r/Thread.hpp"
 #include "libslic3r/BlacklistedLibraryCheck.hpp"
 #include "libslic3r/Utils/DirectoriesUtils.hpp"
@@ -330,6 +332,12 @@ bool setup(Data& cli, int argc, char** argv)
 
     set_data_dir(cli.misc_config.has("datadir") ? cli.misc_config.opt_string("datadir") : get_default_datadir());
 
+    if (cli.misc_config.has("slice_cache"))
+        SliceCache::set_cache_dir(cli.misc_config.opt_string("slice_cache"));
+
+    if (cli.misc_config.has("trace"))
+        Trace::start();
+
 #ifdef SLIC3R_GUI
     if (cli.misc_config.has("webdev")) {
         Utils::ServiceConfig::instance().set_webdev_enabled(cli.misc_config.opt_bool("webdev"));
@@ -338,4 +346,25 @@ bool setup(Data& cli, int argc, char** argv)
     return true;
 }
 
+bool setup_job(Data& cli, const std::vector<std::string>& args)
+{
+    // read() skips the first argument, which is the application name.
+    std::vector<const char*> argv { SLIC3R_APP_KEY };
+    for (const std::string& arg : args)
+        argv.emplace_back(arg.c_str());
+    return read(cli, int(argv.size()), argv.data());
+}
+
+JobArenaConfig job_arena_config(const Data& cli)
+{
+    JobArenaConfig config;
+    if (cli.misc_config.has("threads"))
+        config.max_concurrency = size_t(std::max(cli.misc_config.opt_int("threads"), 1));
+    if (cli.misc_config.has("numa_node"))
+        config.numa_node = cli.misc_config.opt_int("numa_node");
+    if (cli.misc_config.has("low_priority"))
+        config.low_priority = cli.misc_config.opt_bool("low_priority");
+    return config;
+}
+
 }
\ No newline at end of file
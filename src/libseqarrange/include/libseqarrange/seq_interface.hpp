@@ -15,6 +15,8 @@
 
 /*----------------------------------------------------------------*/
 
+#include <chrono>
+
 #include "libslic3r/Polygon.hpp"
 #include "libslic3r/Geometry/ConvexHull.hpp"
 
@@ -68,9 +70,15 @@ struct SolverConfiguration
     
     void set_DecimationPrecision(DecimationPrecision decimation_precision);
     void set_ObjectGroupSize(int object_group_size);
+    void set_SchedulingTimeBudget(int scheduling_time_budget);
+    void set_PlateCandidates(int plate_candidates);
 
     void setup(const PrinterGeometry &printer_geometry);
 
+    /* starts measuring the scheduling time budget, called when scheduling begins */
+    void start_SchedulingTimeBudget();
+    bool is_SchedulingTimeBudgetExhausted() const;
+
     static double convert_DecimationPrecision2Tolerance(DecimationPrecision decimation_precision);
 
     int bounding_box_size_optimization_step;
@@ -86,7 +94,24 @@ struct SolverConfiguration
     int temporal_spread;
 
     DecimationPrecision decimation_precision;   
-    std::string optimization_timeout;    
+    std::string optimization_timeout;
+
+    /*
+      Time budget for the whole scheduling in milliseconds, 0 means unlimited.
+      Once the budget is exhausted, the scheduling stops shrinking the bounding
+      box of the objects and keeps the best arrangement found so far, objects
+      not placed yet are tried only against the whole plate.
+     */
+    int scheduling_time_budget;
+    std::chrono::steady_clock::time_point scheduling_deadline;
+
+    /*
+      Number of candidate partitions of the objects solved in parallel for
+      each plate, each in its own solver context. The candidates differ in
+      the object group size and the one placing the most objects onto the
+      plate is kept. 1 means the plates are solved serially as before.
+     */
+    int plate_candidates;
 };
 
     
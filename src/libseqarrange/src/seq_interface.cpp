@@ -35,6 +35,9 @@ const int SEQ_MINIMUM_BOUNDING_BOX_SIZE           = 16;
 
 const int SEQ_MAX_REFINES                         =  2;
 
+const int SEQ_SCHEDULING_TIME_BUDGET              =  0;
+const int SEQ_PLATE_CANDIDATES                    =  1;
+
 
 /*----------------------------------------------------------------*/
     
@@ -110,6 +113,8 @@ SolverConfiguration::SolverConfiguration()
     , temporal_spread(SEQ_SCHEDULING_TEMPORAL_SPREAD)
     , decimation_precision(SEQ_DECIMATION_PRECISION_LOW)
     , optimization_timeout(SEQ_Z3_SOLVER_TIMEOUT)
+    , scheduling_time_budget(SEQ_SCHEDULING_TIME_BUDGET)
+    , plate_candidates(SEQ_PLATE_CANDIDATES)
 {
 	/* nothing */
 }
@@ -124,6 +129,8 @@ SolverConfiguration::SolverConfiguration(const PrinterGeometry &printer_geometry
     , temporal_spread(SEQ_SCHEDULING_TEMPORAL_SPREAD)
     , decimation_precision(SEQ_DECIMATION_PRECISION_LOW)
     , optimization_timeout(SEQ_Z3_SOLVER_TIMEOUT)
+    , scheduling_time_budget(SEQ_SCHEDULING_TIME_BUDGET)
+    , plate_candidates(SEQ_PLATE_CANDIDATES)
 {
     setup(printer_geometry);
 }
@@ -173,6 +180,30 @@ void SolverConfiguration::set_ObjectGroupSize(int _object_group_size)
 {
     object_group_size = _object_group_size;
 }
+
+
+void SolverConfiguration::set_SchedulingTimeBudget(int _scheduling_time_budget)
+{
+    scheduling_time_budget = _scheduling_time_budget;
+}
+
+
+void SolverConfiguration::set_PlateCandidates(int _plate_candidates)
+{
+    plate_candidates = _plate_candidates;
+}
+
+
+void SolverConfiguration::start_SchedulingTimeBudget()
+{
+    scheduling_deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(scheduling_time_budget);
+}
+
+
+bool SolverConfiguration::is_SchedulingTimeBudgetExhausted() const
+{
+    return scheduling_time_budget > 0 && std::chrono::steady_clock::now() >= scheduling_deadline;
+}
     
     
 /*----------------------------------------------------------------*/
@@ -363,12 +394,15 @@ bool is_scheduled(int i, const std::vector<int> &decided_polygons)
 }
 
 
-void schedule_ObjectsForSequentialPrint(const SolverConfiguration        &solver_configuration,
+void schedule_ObjectsForSequentialPrint(const SolverConfiguration        &_solver_configuration,
 					const PrinterGeometry            &printer_geometry,
 					const std::vector<ObjectToPrint> &objects_to_print,
 					std::vector<ScheduledPlate>      &scheduled_plates,
 					std::function<void(int)>          progress_callback)
 {
+    SolverConfiguration solver_configuration(_solver_configuration);
+    solver_configuration.start_SchedulingTimeBudget();
+    
     #ifdef PROFILE
     clock_t start, finish;
     start = clock();	
@@ -383,6 +417,9 @@ void schedule_ObjectsForSequentialPrint(const SolverConfiguration        &solver
     std::map<int, int> original_index_map;
     std::vector<SolvableObject> solvable_objects;
 
+    /* indices of objects with distinct geometry that were already prepared */
+    std::vector<int> prepared_objects;
+
     #ifdef DEBUG
     {
 	printf("  Preparing objects ...\n");
@@ -399,23 +436,41 @@ void schedule_ObjectsForSequentialPrint(const SolverConfiguration        &solver
 
 	SolvableObject solvable_object;
 	original_index_map[i] = objects_to_print[i].id;
-	    
-	prepare_ExtruderPolygons(solver_configuration,
-				 printer_geometry,
-				 objects_to_print[i],
-				 convex_level_polygons,
-				 box_level_polygons,
-				 extruder_convex_level_polygons,
-				 extruder_box_level_polygons,
-				 true);
 
-	prepare_ObjectPolygons(solver_configuration,
-			       convex_level_polygons,
-			       box_level_polygons,
-			       extruder_convex_level_polygons,
-			       extruder_box_level_polygons,
-			       solvable_object.polygon,
-			       solvable_object.unreachable_polygons);
+	/* instances of the same object have the same geometry, decimate it only once */
+	bool prepared = false;
+	for (unsigned int j = 0; j < prepared_objects.size(); ++j)
+	{
+	    if (objects_to_print[prepared_objects[j]].pgns_at_height == objects_to_print[i].pgns_at_height)
+	    {
+		solvable_object.polygon = solvable_objects[prepared_objects[j]].polygon;
+		solvable_object.unreachable_polygons = solvable_objects[prepared_objects[j]].unreachable_polygons;
+		prepared = true;
+		break;
+	    }
+	}
+
+	if (!prepared)
+	{
+	    prepare_ExtruderPolygons(solver_configuration,
+				     printer_geometry,
+				     objects_to_print[i],
+				     convex_level_polygons,
+				     box_level_polygons,
+				     extruder_convex_level_polygons,
+				     extruder_box_level_polygons,
+				     true);
+
+	    prepare_ObjectPolygons(solver_configuration,
+				   convex_level_polygons,
+				   box_level_polygons,
+				   extruder_convex_level_polygons,
+				   extruder_box_level_polygons,
+				   solvable_object.polygon,
+				   solvable_object.unreachable_polygons);
+
+	    prepared_objects.push_back(i);
+	}
 
 	solvable_object.id = objects_to_print[i].id;
 	solvable_object.lepox_to_next = objects_to_print[i].glued_to_next;
@@ -456,17 +511,17 @@ void schedule_ObjectsForSequentialPrint(const SolverConfiguration        &solver
 	
 	bool optimized;
 
-	optimized = optimize_SubglobalConsequentialPolygonNonoverlappingBinaryCentered(solver_configuration,
-										       poly_positions_X,
-										       poly_positions_Y,
-										       times_T,
-										       solvable_objects,
-										       trans_bed_lepox,
-										       decided_polygons,
-										       remaining_polygons,
-										       progress_object_phases_done,
-										       progress_object_phases_total,
-										       progress_callback);
+	optimized = optimize_SubglobalConsequentialPolygonNonoverlappingBinaryCenteredSpeculative(solver_configuration,
+												  poly_positions_X,
+												  poly_positions_Y,
+												  times_T,
+												  solvable_objects,
+												  trans_bed_lepox,
+												  decided_polygons,
+												  remaining_polygons,
+												  progress_object_phases_done,
+												  progress_object_phases_total,
+												  progress_callback);
 	
 	#ifdef DEBUG
 	{
@@ -603,11 +658,14 @@ void schedule_ObjectsForSequentialPrint(const SolverConfiguration        &solver
     
 /*----------------------------------------------------------------*/
             
-int schedule_ObjectsForSequentialPrint(const SolverConfiguration        &solver_configuration,
+int schedule_ObjectsForSequentialPrint(const SolverConfiguration        &_solver_configuration,
 				       const std::vector<ObjectToPrint> &objects_to_print,
 				       std::vector<ScheduledPlate>      &scheduled_plates,
 				       std::function<void(int)>          progress_callback)
 {
+    SolverConfiguration solver_configuration(_solver_configuration);
+    solver_configuration.start_SchedulingTimeBudget();
+    
     #ifdef PROFILE
     clock_t start, finish;
     start = clock();	
@@ -873,17 +931,17 @@ int schedule_ObjectsForSequentialPrint(const SolverConfiguration        &solver_
 	
 	bool optimized;
 	
-	optimized = optimize_SubglobalConsequentialPolygonNonoverlappingBinaryCentered(solver_configuration,
-										       poly_positions_X,
-										       poly_positions_Y,
-										       times_T,
-										       solvable_objects,
-										       trans_bed_lepox,
-										       decided_polygons,
-										       remaining_polygons,
-										       progress_object_phases_done,
-										       progress_object_phases_total,
-										       progress_callback);	
+	optimized = optimize_SubglobalConsequentialPolygonNonoverlappingBinaryCenteredSpeculative(solver_configuration,
+												  poly_positions_X,
+												  poly_positions_Y,
+												  times_T,
+												  solvable_objects,
+												  trans_bed_lepox,
+												  decided_polygons,
+												  remaining_polygons,
+												  progress_object_phases_done,
+												  progress_object_phases_total,
+												  progress_callback);	
 	
 	#ifdef DEBUG
 	{
@@ -1053,13 +1111,16 @@ void setup_ExtruderUnreachableZones(const SolverConfiguration                 &s
 }
 
 
-int schedule_ObjectsForSequentialPrint(const SolverConfiguration                        &solver_configuration,
+int schedule_ObjectsForSequentialPrint(const SolverConfiguration                        &_solver_configuration,
 				       const std::vector<ObjectToPrint>                 &objects_to_print,
 				       const std::vector<std::vector<Slic3r::Polygon> > &convex_unreachable_zones,
 				       const std::vector<std::vector<Slic3r::Polygon> > &box_unreachable_zones,
 				       std::vector<ScheduledPlate>                      &scheduled_plates,
 				       std::function<void(int)>                          progress_callback)
 {
+    SolverConfiguration solver_configuration(_solver_configuration);
+    solver_configuration.start_SchedulingTimeBudget();
+    
     #ifdef PROFILE
     clock_t start, finish;
     start = clock();	
@@ -1211,17 +1272,17 @@ int schedule_ObjectsForSequentialPrint(const SolverConfiguration
 	
 	bool optimized;
 	
-	optimized = optimize_SubglobalConsequentialPolygonNonoverlappingBinaryCentered(solver_configuration,
-										       poly_positions_X,
-										       poly_positions_Y,
-										       times_T,
-										       solvable_objects,
-										       trans_bed_lepox,
-										       decided_polygons,
-										       remaining_polygons,
-										       progress_object_phases_done,
-										       progress_object_phases_total,
-										       progress_callback);	
+	optimized = optimize_SubglobalConsequentialPolygonNonoverlappingBinaryCenteredSpeculative(solver_configuration,
+												  poly_positions_X,
+												  poly_positions_Y,
+												  times_T,
+												  solvable_objects,
+												  trans_bed_lepox,
+												  decided_polygons,
+												  remaining_polygons,
+												  progress_object_phases_done,
+												  progress_object_phases_total,
+												  progress_callback);	
 
 	
 	#ifdef DEBUG
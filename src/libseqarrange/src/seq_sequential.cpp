@@ -9,6 +9,9 @@
  */
 /*================================================================*/
 
+#include <thread>
+#include <exception>
+
 #include <libslic3r/SVG.hpp>
 #include <libslic3r/Geometry/ConvexHull.hpp>
 
@@ -9512,6 +9515,16 @@ bool optimize_ConsequentialWeakPolygonNonoverlappingBinaryCentered(z3::solver
 	#endif
 
 	bool size_solvable = false;
+
+	/* the time budget is exhausted, keep the best bounding box found so far or try the whole plate */
+	if (solver_configuration.is_SchedulingTimeBudgetExhausted())
+	{
+	    if (solving_result)
+	    {
+		break;
+	    }
+	    _inner_half_box = _outer_half_box;
+	}
 	
 	coord_t box_min_x = (_outer_half_box.min.x() + _inner_half_box.min.x()) / 2;
 	coord_t box_max_x = (_outer_half_box.max.x() + _inner_half_box.max.x()) / 2;
@@ -9863,6 +9876,16 @@ bool optimize_ConsequentialWeakPolygonNonoverlappingBinaryCentered(z3::solver
 	#endif
 
 	bool size_solvable = false;
+
+	/* the time budget is exhausted, keep the best bounding polygon found so far or try the whole plate */
+	if (solver_configuration.is_SchedulingTimeBudgetExhausted())
+	{
+	    if (solving_result)
+	    {
+		break;
+	    }
+	    _inner_half_polygon = _outer_half_polygon;
+	}
 	
 	Polygon bounding_polygon;
 
@@ -11684,6 +11707,130 @@ bool optimize_SubglobalConsequentialPolygonNonoverlappingBinaryCentered(const So
 }
 
 
+bool optimize_SubglobalConsequentialPolygonNonoverlappingBinaryCenteredSpeculative(const SolverConfiguration         &solver_configuration,
+										   std::vector<Rational>             &dec_values_X,
+										   std::vector<Rational>             &dec_values_Y,
+										   std::vector<Rational>             &dec_values_T,
+										   const std::vector<SolvableObject> &solvable_objects,
+										   bool                               trans_bed_lepox,
+										   std::vector<int>                  &decided_polygons,
+										   std::vector<int>                  &remaining_polygons,
+										   int                               &progress_object_phases_done,
+										   int                                progress_total_object_phases,
+										   std::function<void(int)>           progress_callback)
+{
+    if (solver_configuration.plate_candidates <= 1)
+    {
+	return optimize_SubglobalConsequentialPolygonNonoverlappingBinaryCentered(solver_configuration,
+										  dec_values_X,
+										  dec_values_Y,
+										  dec_values_T,
+										  solvable_objects,
+										  trans_bed_lepox,
+										  decided_polygons,
+										  remaining_polygons,
+										  progress_object_phases_done,
+										  progress_total_object_phases,
+										  progress_callback);
+    }
+
+    struct PlateCandidate
+    {
+	SolverConfiguration solver_configuration;
+	std::vector<Rational> dec_values_X;
+	std::vector<Rational> dec_values_Y;
+	std::vector<Rational> dec_values_T;
+	std::vector<int> decided_polygons;
+	std::vector<int> remaining_polygons;
+	int progress_object_phases_done;
+	bool optimized = false;
+	std::exception_ptr exception;
+    };
+
+    std::vector<PlateCandidate> candidates(solver_configuration.plate_candidates);
+
+    /* candidates alternate object group sizes around the configured one, the first candidate is the configured one */
+    for (unsigned int k = 0; k < candidates.size(); ++k)
+    {
+	int group_size_shift = (k % 2 == 1) ? (int)(k + 1) / 2 : -(int)k / 2;
+	
+	candidates[k].solver_configuration = solver_configuration;
+	candidates[k].solver_configuration.object_group_size = MAX(1, solver_configuration.object_group_size + group_size_shift);
+	candidates[k].progress_object_phases_done = progress_object_phases_done;
+    }
+
+    /* every candidate has its own Z3 context, only the first one reports progress */
+    std::vector<std::thread> candidate_threads;
+    
+    for (unsigned int k = 0; k < candidates.size(); ++k)
+    {
+	candidate_threads.emplace_back([&candidates, k, &solvable_objects, trans_bed_lepox, progress_total_object_phases, &progress_callback]()
+	{
+	    PlateCandidate &candidate = candidates[k];
+	    std::function<void(int)> candidate_progress_callback = (k == 0) ? progress_callback : [](int progress){};
+	    
+	    try
+	    {
+		candidate.optimized = optimize_SubglobalConsequentialPolygonNonoverlappingBinaryCentered(candidate.solver_configuration,
+													 candidate.dec_values_X,
+													 candidate.dec_values_Y,
+													 candidate.dec_values_T,
+													 solvable_objects,
+													 trans_bed_lepox,
+													 candidate.decided_polygons,
+													 candidate.remaining_polygons,
+													 candidate.progress_object_phases_done,
+													 progress_total_object_phases,
+													 candidate_progress_callback);
+	    }
+	    catch (...)
+	    {
+		candidate.exception = std::current_exception();
+	    }
+	});
+    }
+    for (auto& candidate_thread: candidate_threads)
+    {
+	candidate_thread.join();
+    }
+
+    /* the candidate placing the most objects onto the plate wins, ties are resolved by the lower candidate index */
+    int best_candidate = -1;
+
+    for (unsigned int k = 0; k < candidates.size(); ++k)
+    {
+	if (candidates[k].exception)
+	{
+	    std::rethrow_exception(candidates[k].exception);
+	}
+	if (candidates[k].optimized)
+	{
+	    if (best_candidate < 0 || candidates[k].decided_polygons.size() > candidates[best_candidate].decided_polygons.size())
+	    {
+		best_candidate = k;
+	    }
+	}
+    }
+
+    if (best_candidate < 0)
+    {
+	decided_polygons.clear();
+	remaining_polygons.clear();
+	
+	return false;
+    }
+    
+    dec_values_X = candidates[best_candidate].dec_values_X;
+    dec_values_Y = candidates[best_candidate].dec_values_Y;
+    dec_values_T = candidates[best_candidate].dec_values_T;
+    decided_polygons = candidates[best_candidate].decided_polygons;
+    remaining_polygons = candidates[best_candidate].remaining_polygons;
+    progress_object_phases_done = candidates[best_candidate].progress_object_phases_done;
+    
+    return true;
+}
+
+
 /*----------------------------------------------------------------*/
 
 } // namespace Sequential
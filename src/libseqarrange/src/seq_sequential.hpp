@@ -1678,6 +1678,23 @@ bool optimize_SubglobalConsequentialPolygonNonoverlappingBinaryCentered(const So
 									int                                               progress_total_object_phases,
 									std::function<void(int)>                          progress_callback = [](int progress){});    
 
+/*
+  Solves the plate for several candidate object group sizes in parallel and
+  keeps the candidate that places the most objects onto the plate. Falls back
+  to the above when solver_configuration.plate_candidates is at most one.
+ */
+bool optimize_SubglobalConsequentialPolygonNonoverlappingBinaryCenteredSpeculative(const SolverConfiguration                        &solver_configuration,
+										   std::vector<Rational>                            &dec_values_X,
+										   std::vector<Rational>                            &dec_values_Y,
+										   std::vector<Rational>                            &dec_values_T,
+										   const std::vector<SolvableObject>                &solvable_objects,
+										   bool                                              trans_bed_lepox,
+										   std::vector<int>                                 &decided_polygons,
+										   std::vector<int>                                 &remaining_polygons,
+										   int                                              &progress_object_phases_done,
+										   int                                               progress_total_object_phases,
+										   std::function<void(int)>                          progress_callback = [](int progress){});
+
 /*----------------------------------------------------------------*/
 
 } // namespace Sequential
@@ -1247,6 +1247,338 @@ TEST_CASE("Interface test 6", "[Sequential Arrangement Interface]")
 }
 
 
+TEST_CASE("Interface test 7", "[Sequential Arrangement Interface]")
+//void interface_test_7(void)
+{
+    #ifdef DEBUG
+    clock_t start, finish;
+    #endif
+    
+    INFO("Testing interface 7 ...");
+
+    #ifdef DEBUG
+    start = clock();
+    #endif
+
+    SolverConfiguration solver_configuration;
+    solver_configuration.decimation_precision = SEQ_DECIMATION_PRECISION_LOW;
+    solver_configuration.object_group_size = 4;
+    solver_configuration.set_SchedulingTimeBudget(1);
+    solver_configuration.plate_bounding_box = BoundingBox({0,0}, {SEQ_PRUSA_MK3S_X_SIZE / SEQ_SLICER_SCALE_FACTOR, SEQ_PRUSA_MK3S_Y_SIZE / SEQ_SLICER_SCALE_FACTOR});
+
+    #ifdef DEBUG
+    {
+	printf("Loading objects ...\n");
+    }
+    #endif
+    std::vector<ObjectToPrint> objects_to_print = load_exported_data_from_text(arrange_data_export_text);
+    REQUIRE(objects_to_print.size() > 0);
+    
+    #ifdef DEBUG
+    {
+	printf("Loading objects ... finished\n");
+    }
+    #endif
+
+    PrinterGeometry printer_geometry;
+
+    #ifdef DEBUG
+    {    
+	printf("Loading printer geometry ...\n");
+    }
+    #endif
+    int result = load_printer_geometry_from_text(printer_geometry_mk4_compatibility_text, printer_geometry);
+    
+    REQUIRE(result == 0);    
+    if (result != 0)
+    {
+	#ifdef DEBUG
+	{
+	    printf("Cannot load printer geometry (code: %d).\n", result);
+	}
+	#endif
+	return;
+    }
+    solver_configuration.setup(printer_geometry);
+    #ifdef DEBUG
+    {
+	printf("Loading printer geometry ... finished\n");
+    }
+    #endif
+    
+    std::vector<ScheduledPlate> scheduled_plates;
+    #ifdef DEBUG
+    {    
+	printf("Scheduling objects for sequential print ...\n");
+    }
+    #endif
+
+    scheduled_plates = schedule_ObjectsForSequentialPrint(solver_configuration,
+							  printer_geometry,
+							  objects_to_print,
+							  [](int progress) {
+                                                                             #ifdef DEBUG
+							                     { printf("Progress: %d\n", progress); }
+                                                                             #endif
+							                     REQUIRE(progress >= 0);
+									     REQUIRE(progress <= 100); });
+
+    #ifdef DEBUG
+    {    
+	printf("Object scheduling for sequential print SUCCESSFUL !\n");
+    }
+    #endif
+
+    #ifdef DEBUG
+    {    
+	printf("Number of plates: %ld\n", scheduled_plates.size());
+    }
+    #endif
+    REQUIRE(scheduled_plates.size() > 0);    
+
+    /* even with the time budget exhausted all objects are scheduled */
+    unsigned int total_scheduled_objects = 0;
+    for (const auto& scheduled_plate: scheduled_plates)
+    {
+	total_scheduled_objects += scheduled_plate.scheduled_objects.size();
+    }
+    REQUIRE(total_scheduled_objects == objects_to_print.size());
+
+    for (unsigned int plate = 0; plate < scheduled_plates.size(); ++plate)
+    {
+        #ifdef DEBUG
+	{	
+	    printf("  Number of objects on plate: %ld\n", scheduled_plates[plate].scheduled_objects.size());
+	}
+	#endif
+	
+	REQUIRE(scheduled_plates[plate].scheduled_objects.size() > 0);	
+	
+	for (const auto& scheduled_object: scheduled_plates[plate].scheduled_objects)
+	{
+            #ifdef DEBUG
+	    {	    
+		cout << "    ID: " << scheduled_object.id << "  X: " << scheduled_object.x << "  Y: " << scheduled_object.y << endl;
+	    }
+	    #endif		
+	    BoundingBox plate_box = get_extents(printer_geometry.plate);
+	    
+	    REQUIRE(scheduled_object.x >= plate_box.min.x());
+	    REQUIRE(scheduled_object.x <= plate_box.max.x());
+	    REQUIRE(scheduled_object.y >= plate_box.min.y());
+	    REQUIRE(scheduled_object.y <= plate_box.max.y());		
+	}
+    }
+    
+    #ifdef DEBUG
+    finish = clock();    
+    {    
+	printf("Solving time: %.3f\n", (finish - start) / (double)CLOCKS_PER_SEC);
+    }
+    start = clock();    
+    #endif
+
+    #ifdef DEBUG
+    {    
+	printf("Checking sequential printability ...\n");
+    }
+    #endif
+
+    bool printable = check_ScheduledObjectsForSequentialPrintability(solver_configuration,
+								     printer_geometry,
+								     objects_to_print,
+								     scheduled_plates);
+
+    #ifdef DEBUG
+    {    
+	printf("  Scheduled/arranged objects are sequentially printable: %s\n", (printable ? "YES" : "NO"));
+    }
+    #endif
+    REQUIRE(printable);    
+
+    #ifdef DEBUG
+    {    
+	printf("Checking sequential printability ... finished\n");
+    }
+    finish = clock();    
+    #endif
+
+    #ifdef DEBUG
+    {    
+	printf("Checking time: %.3f\n", (finish - start) / (double)CLOCKS_PER_SEC);
+    }
+    #endif
+    
+    INFO("Testing interface 7 ... finished");
+}
+
+
+TEST_CASE("Interface test 8", "[Sequential Arrangement Interface]")
+//void interface_test_8(void)
+{
+    #ifdef DEBUG
+    clock_t start, finish;
+    #endif
+    
+    INFO("Testing interface 8 ...");
+
+    #ifdef DEBUG
+    start = clock();
+    #endif
+
+    SolverConfiguration solver_configuration;
+    solver_configuration.decimation_precision = SEQ_DECIMATION_PRECISION_LOW;
+    solver_configuration.object_group_size = 4;
+    solver_configuration.set_PlateCandidates(3);
+    solver_configuration.plate_bounding_box = BoundingBox({0,0}, {SEQ_PRUSA_MK3S_X_SIZE / SEQ_SLICER_SCALE_FACTOR, SEQ_PRUSA_MK3S_Y_SIZE / SEQ_SLICER_SCALE_FACTOR});
+
+    #ifdef DEBUG
+    {
+	printf("Loading objects ...\n");
+    }
+    #endif
+    std::vector<ObjectToPrint> objects_to_print = load_exported_data_from_text(arrange_data_export_text);
+    REQUIRE(objects_to_print.size() > 0);
+    
+    #ifdef DEBUG
+    {
+	printf("Loading objects ... finished\n");
+    }
+    #endif
+
+    PrinterGeometry printer_geometry;
+
+    #ifdef DEBUG
+    {    
+	printf("Loading printer geometry ...\n");
+    }
+    #endif
+    int result = load_printer_geometry_from_text(printer_geometry_mk4_compatibility_text, printer_geometry);
+    
+    REQUIRE(result == 0);    
+    if (result != 0)
+    {
+	#ifdef DEBUG
+	{
+	    printf("Cannot load printer geometry (code: %d).\n", result);
+	}
+	#endif
+	return;
+    }
+    solver_configuration.setup(printer_geometry);
+    #ifdef DEBUG
+    {
+	printf("Loading printer geometry ... finished\n");
+    }
+    #endif
+    
+    std::vector<ScheduledPlate> scheduled_plates;
+    #ifdef DEBUG
+    {    
+	printf("Scheduling objects for sequential print ...\n");
+    }
+    #endif
+
+    scheduled_plates = schedule_ObjectsForSequentialPrint(solver_configuration,
+							  printer_geometry,
+							  objects_to_print,
+							  [](int progress) {
+                                                                             #ifdef DEBUG
+							                     { printf("Progress: %d\n", progress); }
+                                                                             #endif
+							                     REQUIRE(progress >= 0);
+									     REQUIRE(progress <= 100); });
+
+    #ifdef DEBUG
+    {    
+	printf("Object scheduling for sequential print SUCCESSFUL !\n");
+    }
+    #endif
+
+    #ifdef DEBUG
+    {    
+	printf("Number of plates: %ld\n", scheduled_plates.size());
+    }
+    #endif
+    REQUIRE(scheduled_plates.size() > 0);    
+
+    /* all objects are scheduled whichever candidate wins */
+    unsigned int total_scheduled_objects = 0;
+    for (const auto& scheduled_plate: scheduled_plates)
+    {
+	total_scheduled_objects += scheduled_plate.scheduled_objects.size();
+    }
+    REQUIRE(total_scheduled_objects == objects_to_print.size());
+
+    for (unsigned int plate = 0; plate < scheduled_plates.size(); ++plate)
+    {
+        #ifdef DEBUG
+	{	
+	    printf("  Number of objects on plate: %ld\n", scheduled_plates[plate].scheduled_objects.size());
+	}
+	#endif
+	
+	REQUIRE(scheduled_plates[plate].scheduled_objects.size() > 0);	
+	
+	for (const auto& scheduled_object: scheduled_plates[plate].scheduled_objects)
+	{
+            #ifdef DEBUG
+	    {	    
+		cout << "    ID: " << scheduled_object.id << "  X: " << scheduled_object.x << "  Y: " << scheduled_object.y << endl;
+	    }
+	    #endif		
+	    BoundingBox plate_box = get_extents(printer_geometry.plate);
+	    
+	    REQUIRE(scheduled_object.x >= plate_box.min.x());
+	    REQUIRE(scheduled_object.x <= plate_box.max.x());
+	    REQUIRE(scheduled_object.y >= plate_box.min.y());
+	    REQUIRE(scheduled_object.y <= plate_box.max.y());		
+	}
+    }
+    
+    #ifdef DEBUG
+    finish = clock();    
+    {    
+	printf("Solving time: %.3f\n", (finish - start) / (double)CLOCKS_PER_SEC);
+    }
+    start = clock();    
+    #endif
+
+    #ifdef DEBUG
+    {    
+	printf("Checking sequential printability ...\n");
+    }
+    #endif
+
+    bool printable = check_ScheduledObjectsForSequentialPrintability(solver_configuration,
+								     printer_geometry,
+								     objects_to_print,
+								     scheduled_plates);
+
+    #ifdef DEBUG
+    {    
+	printf("  Scheduled/arranged objects are sequentially printable: %s\n", (printable ? "YES" : "NO"));
+    }
+    #endif
+    REQUIRE(printable);    
+
+    #ifdef DEBUG
+    {    
+	printf("Checking sequential printability ... finished\n");
+    }
+    finish = clock();    
+    #endif
+
+    #ifdef DEBUG
+    {    
+	printf("Checking time: %.3f\n", (finish - start) / (double)CLOCKS_PER_SEC);
+    }
+    #endif
+    
+    INFO("Testing interface 8 ... finished");
+}
+
+
 /*----------------------------------------------------------------*/
 
 
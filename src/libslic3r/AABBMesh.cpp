@@ -5,6 +5,7 @@
 #include "AABBMesh.hpp"
 
 #include <libslic3r/AABBTreeIndirect.hpp>
+#include <libslic3r/MeshCache.hpp>
 #include <libslic3r/TriangleMesh.hpp>
 #include <igl/Hit.h>
 #include <algorithm>
@@ -20,11 +21,12 @@ namespace Slic3r {
 
 class AABBMesh::AABBImpl {
 private:
-    AABBTreeIndirect::Tree3f m_tree;
-    double                   m_triangle_ray_epsilon;
+    // Shared with the copies of the AABBMesh and possibly with the other users of the mesh, see cached_aabb_tree().
+    std::shared_ptr<const AABBTreeIndirect::Tree3f> m_tree;
+    double                                          m_triangle_ray_epsilon;
 
 public:
-    void init(const indexed_triangle_set &its, bool calculate_epsilon)
+    void init(const indexed_triangle_set &its, bool calculate_epsilon, std::shared_ptr<const AABBTreeIndirect::Tree3f> tree = {})
     {
         m_triangle_ray_epsilon = 0.000001;
         if (calculate_epsilon) {
@@ -33,8 +35,8 @@ public:
             if (l > 0)
                 m_triangle_ray_epsilon = 0.000001 * l * l;
         }
-        m_tree = AABBTreeIndirect::build_aabb_tree_over_indexed_triangle_set(
-            its.vertices, its.indices);
+        m_tree = tree ? std::move(tree) : std::make_shared<AABBTreeIndirect::Tree3f>(
+            AABBTreeIndirect::build_aabb_tree_over_indexed_triangle_set(its.vertices, its.indices));
     }
 
     void intersect_ray(const indexed_triangle_set &its,
@@ -43,7 +45,18 @@ public:
                        igl::Hit &                  hit)
     {
         AABBTreeIndirect::intersect_ray_first_hit(its.vertices, its.indices,
-                                                  m_tree, s, dir, hit, m_triangle_ray_epsilon);
+                                                  *m_tree, s, dir, hit, m_triangle_ray_epsilon);
+    }
+
+    template<size_t N>
+    void intersect_rays(const indexed_triangle_set   &its,
+                        const std::array<Vec3d, N>   &s,
+                        const std::array<Vec3d, N>   &dir,
+                        size_t                        num_rays,
+                        std::array<igl::Hit, N>      &hits)
+    {
+        AABBTreeIndirect::intersect_rays_first_hit(its.vertices, its.indices,
+                                                   *m_tree, s, dir, num_rays, hits, m_triangle_ray_epsilon);
     }
 
     void intersect_ray(const indexed_triangle_set &its,
@@ -52,7 +65,7 @@ public:
                        std::vector<igl::Hit> &     hits)
     {
         AABBTreeIndirect::intersect_ray_all_hits(its.vertices, its.indices,
-                                                 m_tree, s, dir, hits, m_triangle_ray_epsilon);
+                                                 *m_tree, s, dir, hits, m_triangle_ray_epsilon);
     }
 
     double squared_distance(const indexed_triangle_set & its,
@@ -64,7 +77,7 @@ public:
         Vec3d  closest_vec3d(closest);
         double dist =
             AABBTreeIndirect::squared_distance_to_indexed_triangle_set(
-                its.vertices, its.indices, m_tree, point, idx_unsigned,
+                its.vertices, its.indices, *m_tree, point, idx_unsigned,
                 closest_vec3d);
         i       = int(idx_unsigned);
         closest = closest_vec3d;
@@ -82,7 +95,7 @@ AABBMesh::AABBMesh(const indexed_triangle_set &tmesh, bool calculate_epsilon)
     : m_tm(&tmesh)
     , m_aabb(new AABBImpl())
     , m_vfidx{tmesh}
-    , m_fnidx{its_face_neighbors(tmesh)}
+    , m_fnidx{std::make_shared<std::vector<Vec3i>>(its_face_neighbors(tmesh))}
 {
     init(tmesh, calculate_epsilon);
 }
@@ -91,11 +104,20 @@ AABBMesh::AABBMesh(const TriangleMesh &mesh, bool calculate_epsilon)
     : m_tm(&mesh.its)
     , m_aabb(new AABBImpl())
     , m_vfidx{mesh.its}
-    , m_fnidx{its_face_neighbors(mesh.its)}
+    , m_fnidx{std::make_shared<std::vector<Vec3i>>(its_face_neighbors(mesh.its))}
 {
     init(mesh, calculate_epsilon);
 }
 
+AABBMesh::AABBMesh(const std::shared_ptr<const TriangleMesh> &mesh, bool calculate_epsilon)
+    : m_tm(&mesh->its)
+    , m_aabb(new AABBImpl())
+    , m_vfidx{mesh->its}
+    , m_fnidx{cached_face_neighbors(mesh)}
+{
+    m_aabb->init(*m_tm, calculate_epsilon, cached_aabb_tree(mesh));
+}
+
 AABBMesh::~AABBMesh() {}
 
 AABBMesh::AABBMesh(const AABBMesh &other)
@@ -183,6 +205,44 @@ AABBMesh::query_ray_hit(const Vec3d &s, const Vec3d &dir) const
     return ret;
 }
 
+void AABBMesh::query_ray_hit(const Vec3d *s, const Vec3d *dir, size_t num_rays, hit_result *hits) const
+{
+#ifdef SLIC3R_HOLE_RAYCASTER
+    if (! m_holes.empty()) {
+        for (size_t i = 0; i < num_rays; ++ i)
+            hits[i] = this->query_ray_hit(s[i], dir[i]);
+        return;
+    }
+#endif
+
+    // 8 rays per packet vectorize well with both float and double coordinates.
+    static constexpr const size_t PacketSize = 8;
+    std::array<Vec3d, PacketSize>    sources;
+    std::array<Vec3d, PacketSize>    dirs;
+    std::array<igl::Hit, PacketSize> packet_hits;
+    for (size_t begin = 0; begin < num_rays; begin += PacketSize) {
+        const size_t num = std::min(PacketSize, num_rays - begin);
+        for (size_t i = 0; i < num; ++ i) {
+            assert(is_approx(dir[begin + i].norm(), 1.));
+            sources[i] = s[begin + i];
+            dirs[i]    = dir[begin + i];
+        }
+        m_aabb->intersect_rays(*m_tm, sources, dirs, num, packet_hits);
+        for (size_t i = 0; i < num; ++ i) {
+            const igl::Hit &hit = packet_hits[i];
+            hit_result     &ret = hits[begin + i];
+            ret          = hit_result(*this);
+            ret.m_t      = double(hit.t);
+            ret.m_dir    = dirs[i];
+            ret.m_source = sources[i];
+            if (! std::isinf(hit.t) && ! std::isnan(hit.t)) {
+                ret.m_normal  = this->normal_by_face_id(hit.id);
+                ret.m_face_id = hit.id;
+            }
+        }
+    }
+}
+
 std::vector<AABBMesh::hit_result>
 AABBMesh::query_ray_hits(const Vec3d &s, const Vec3d &dir) const
 {
@@ -40,7 +40,7 @@ class AABBMesh {
 
     std::unique_ptr<AABBImpl> m_aabb;
     VertexFaceIndex m_vfidx;    // vertex-face index
-    std::vector<Vec3i> m_fnidx; // face-neighbor index
+    std::shared_ptr<const std::vector<Vec3i>> m_fnidx; // face-neighbor index
 
 #ifdef SLIC3R_HOLE_RAYCASTER
     // This holds a copy of holes in the mesh. Initialized externally
@@ -56,6 +56,9 @@ public:
     // If set to false, a default epsilon is used, which works for "reasonable" meshes.
     explicit AABBMesh(const indexed_triangle_set &tmesh, bool calculate_epsilon = false);
     explicit AABBMesh(const TriangleMesh &mesh, bool calculate_epsilon = false);
+    // The AABB tree and the face-neighbor index are shared with the other users of the mesh, see MeshCache.hpp.
+    // The referenced mesh must stay valid, the AABBMesh does not keep it alive.
+    explicit AABBMesh(const std::shared_ptr<const TriangleMesh> &mesh, bool calculate_epsilon = false);
     
     AABBMesh(const AABBMesh& other);
     AABBMesh& operator=(const AABBMesh&);
@@ -125,6 +128,10 @@ public:
 
     // Casting a ray on the mesh, returns the distance where the hit occures.
     hit_result query_ray_hit(const Vec3d &s, const Vec3d &dir) const;
+
+    // Same as query_ray_hit() for each of the num_rays rays. The rays are traced through the AABB tree in packets,
+    // which is considerably faster for coherent rays, for example the rays sampling the surface of a support beam.
+    void query_ray_hit(const Vec3d *s, const Vec3d *dir, size_t num_rays, hit_result *hits) const;
     
     // Casts a ray on the mesh and returns all hits
     std::vector<hit_result> query_ray_hits(const Vec3d &s, const Vec3d &dir) const;
@@ -142,7 +149,7 @@ public:
     const indexed_triangle_set * get_triangle_mesh() const { return m_tm; }
 
     const VertexFaceIndex &vertex_face_index() const { return m_vfidx; }
-    const std::vector<Vec3i> &face_neighbor_index() const { return m_fnidx; }
+    const std::vector<Vec3i> &face_neighbor_index() const { return *m_fnidx; }
 };
 
 
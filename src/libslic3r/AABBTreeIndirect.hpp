@@ -11,12 +11,18 @@
 #define slic3r_AABBTreeIndirect_hpp_
 
 #include <algorithm>
+#include <array>
+#include <cstdint>
 #include <limits>
 #include <type_traits>
 #include <vector>
 
 #include <Eigen/Geometry>
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_invoke.h>
+
 #include "BoundingBox.hpp"
 #include "Utils.hpp" // for next_highest_power_of_2()
 
@@ -55,6 +61,10 @@ public:
         inner = size_t(-2)
     };
 
+    // Subtrees over at least this number of entities are built in parallel. Smaller trees are built serially,
+    // as they are often built for each layer inside an already parallel loop.
+    static constexpr size_t parallel_build_threshold = 8192;
+
     // Single node of the implicit balanced AABB tree. There are no links to the children nodes,
     // as these links are calculated implicitely using a power of two rule.
     struct Node {
@@ -149,8 +159,15 @@ private:
 		// Insert an inner node into the tree. Inner node does not reference any input entity (triangle, line segment etc).
 		m_nodes[node].idx  = inner;
 		m_nodes[node].bbox = bbox;
-        build_recursive(input, node * 2 + 1, left, center);
-		build_recursive(input, node * 2 + 2, center + 1, right);
+		// The subtrees are built over disjoint ranges of the input into disjoint nodes.
+		if (right - left >= parallel_build_threshold)
+			tbb::parallel_invoke(
+				[this, &input, node, left, center]() { build_recursive(input, node * 2 + 1, left, center); },
+				[this, &input, node, center, right]() { build_recursive(input, node * 2 + 2, center + 1, right); });
+		else {
+	        build_recursive(input, node * 2 + 1, left, center);
+			build_recursive(input, node * 2 + 2, center + 1, right);
+		}
 	}
 
 	// Partition the input m_nodes <left, right> at "k" and "dimension" using the QuickSelect method:
@@ -696,15 +713,14 @@ inline Tree<3, typename VertexType::Scalar> build_aabb_tree_over_indexed_triangl
         VectorType 	m_centroid;
 	};
 
-	std::vector<InputType> input;
-	input.reserve(faces.size());
+	std::vector<InputType> input(faces.size());
     const VectorType veps(eps, eps, eps);
-	for (size_t i = 0; i < faces.size(); ++ i) {
+    auto make_input = [&vertices, &faces, &input, &veps](size_t i) {
         const IndexedFaceType &face = faces[i];
 		const VertexType &v1 = vertices[face(0)];
 		const VertexType &v2 = vertices[face(1)];
 		const VertexType &v3 = vertices[face(2)];
-		InputType n;
+		InputType &n = input[i];
         n.m_idx      = i;
         n.m_centroid = (1./3.) * (v1 + v2 + v3);
         n.m_bbox = BoundingBox(v1, v1);
@@ -712,8 +728,15 @@ inline Tree<3, typename VertexType::Scalar> build_aabb_tree_over_indexed_triangl
         n.m_bbox.extend(v3);
         n.m_bbox.min() -= veps;
         n.m_bbox.max() += veps;
-        input.emplace_back(n);
-	}
+	};
+	if (faces.size() >= TreeType::parallel_build_threshold)
+		tbb::parallel_for(tbb::blocked_range<size_t>(0, faces.size()), [&make_input](const tbb::blocked_range<size_t> &range) {
+			for (size_t i = range.begin(); i < range.end(); ++ i)
+				make_input(i);
+		});
+	else
+		for (size_t i = 0; i < faces.size(); ++ i)
+			make_input(i);
 
 	TreeType out;
 	out.build(std::move(input));
@@ -791,6 +814,145 @@ inline bool intersect_ray_all_hits(
 	return ! hits.empty();
 }
 
+// Find the first intersections of a packet of rays with indexed triangle set, see intersect_ray_first_hit().
+// The rays are traced through the tree together: a node is visited once for all the rays hitting its bounding box
+// and its bounding box is tested against all the rays of the packet by a single loop, which the compiler vectorizes.
+// This is considerably faster than tracing the rays one by one if the rays are coherent, for example the rays sampling
+// a cylinder around a support tree beam. Only the first num_rays <= N rays of the packet are traced.
+// hits[i].t is infinity if the i-th ray does not hit anything. Returns the number of rays hitting the triangle set.
+template<size_t N, typename VertexType, typename IndexedFaceType, typename TreeType, typename VectorType>
+inline size_t intersect_rays_first_hit(
+	// Indexed triangle set - 3D vertices.
+	const std::vector<VertexType> 		&vertices,
+	// Indexed triangle set - triangular faces, references to vertices.
+	const std::vector<IndexedFaceType> 	&faces,
+	// AABBTreeIndirect::Tree over vertices & faces, bounding boxes built with the accuracy of vertices.
+	const TreeType 						&tree,
+	// Origins of the rays.
+	const std::array<VectorType, N>		&origins,
+	// Directions of the rays.
+	const std::array<VectorType, N>		&dirs,
+	// Number of the rays of the packet to trace.
+	size_t 								 num_rays,
+	// First intersections of the rays with the indexed triangle set.
+	std::array<igl::Hit, N>				&hits,
+	// Epsilon for the ray-triangle intersection, it should be proportional to an average triangle edge length.
+	const double 						 eps = 0.000001)
+{
+    static_assert(N <= 32, "The rays of a packet are masked by 32 bit masks");
+    using Scalar = typename VectorType::Scalar;
+    constexpr Scalar Infty = std::numeric_limits<Scalar>::infinity();
+    assert(num_rays <= N);
+
+    for (igl::Hit &hit : hits)
+        hit = igl::Hit { -1, -1, 0.f, 0.f, std::numeric_limits<float>::infinity() };
+    if (tree.empty() || num_rays == 0)
+        return 0;
+
+    // Structure of arrays of the rays for the vectorized bounding box tests. The unused rays never hit anything.
+    std::array<Scalar, N> ox, oy, oz, ix, iy, iz, tmax;
+    for (size_t i = 0; i < N; ++ i) {
+        const bool  used   = i < num_rays;
+        VectorType  invdir = used ? VectorType(dirs[i].cwiseInverse()) : VectorType(1, 1, 1);
+        ox[i]   = used ? origins[i].x() : Scalar(0);
+        oy[i]   = used ? origins[i].y() : Scalar(0);
+        oz[i]   = used ? origins[i].z() : Scalar(0);
+        ix[i]   = invdir.x();
+        iy[i]   = invdir.y();
+        iz[i]   = invdir.z();
+        tmax[i] = used ? Infty : Scalar(0);
+    }
+
+    // Slab test of the rays of in_mask against a bounding box. Returns the mask of the rays entering the box before their closest hit
+    // found so far and the smallest entry parameter of these rays. A NaN produced by a ray parallel to a slab, starting on its boundary,
+    // is ignored by the std::min / std::max below, thus such a ray is not culled.
+    auto test_box = [&](const auto &bbox, uint32_t in_mask, Scalar &tnear) {
+        const auto bmin = bbox.min().template cast<Scalar>().eval();
+        const auto bmax = bbox.max().template cast<Scalar>().eval();
+        std::array<Scalar, N> tns;
+        for (size_t i = 0; i < N; ++ i) {
+            Scalar t1 = (bmin.x() - ox[i]) * ix[i], t2 = (bmax.x() - ox[i]) * ix[i];
+            Scalar tn = std::max(-Infty, std::min(t1, t2)), tf = std::min(Infty, std::max(t1, t2));
+            t1 = (bmin.y() - oy[i]) * iy[i];
+            t2 = (bmax.y() - oy[i]) * iy[i];
+            tn = std::max(tn, std::min(t1, t2));
+            tf = std::min(tf, std::max(t1, t2));
+            t1 = (bmin.z() - oz[i]) * iz[i];
+            t2 = (bmax.z() - oz[i]) * iz[i];
+            tn = std::max(tn, std::min(t1, t2));
+            tf = std::min(tf, std::max(t1, t2));
+            tns[i] = tn <= tf && tf > Scalar(0) && tn < tmax[i] ? tn : Infty;
+        }
+        uint32_t mask = 0;
+        tnear = Infty;
+        for (size_t i = 0; i < N; ++ i)
+            if (tns[i] != Infty && (in_mask & (uint32_t(1) << i))) {
+                mask |= uint32_t(1) << i;
+                tnear = std::min(tnear, tns[i]);
+            }
+        return mask;
+    };
+
+    // Depth first traversal, visiting the child entered first by the rays first, so that the farther child is likely culled
+    // by the hits found in the nearer one. The tree is balanced, thus its depth is at most log2 of the number of nodes,
+    // while at most one sibling per level waits on the stack.
+    struct Entry { size_t node_idx; uint32_t mask; };
+    std::array<Entry, 2 * std::numeric_limits<size_t>::digits> stack;
+    size_t stack_size = 0;
+    Scalar tnear;
+    if (uint32_t mask = test_box(tree.node(0).bbox, num_rays == 32 ? ~ uint32_t(0) : (uint32_t(1) << num_rays) - 1, tnear); mask != 0)
+        stack[stack_size ++] = { 0, mask };
+    while (stack_size > 0) {
+        const Entry  entry = stack[-- stack_size];
+        const auto  &node  = tree.node(entry.node_idx);
+        assert(node.is_valid());
+        uint32_t     mask  = entry.mask;
+        size_t       num_active = 0;
+        for (uint32_t m = mask; m != 0; m &= m - 1)
+            ++ num_active;
+        if (node.is_leaf()) {
+            const auto face = faces[node.idx];
+            for (size_t i = 0; i < num_rays; ++ i)
+                if (mask & (uint32_t(1) << i)) {
+                    double t, u, v;
+                    if (detail::intersect_triangle(origins[i], dirs[i], vertices[face(0)], vertices[face(1)], vertices[face(2)], t, u, v, eps) &&
+                        t > 0. && t < tmax[i]) {
+                        hits[i] = igl::Hit { int(node.idx), -1, float(u), float(v), float(t) };
+                        tmax[i] = Scalar(t);
+                    }
+                }
+        } else if (num_active <= 3) {
+            // Just a few rays left. Testing the boxes of the whole packet for a few rays does not pay off, trace the rays alone.
+            for (size_t i = 0; i < num_rays; ++ i)
+                if (mask & (uint32_t(1) << i)) {
+                    auto ray_intersector = detail::RayIntersector<VertexType, IndexedFaceType, TreeType, VectorType> {
+                        vertices, faces, tree, origins[i], dirs[i], VectorType(ix[i], iy[i], iz[i]), eps
+                    };
+                    if (igl::Hit hit; detail::intersect_ray_recursive_first_hit(ray_intersector, entry.node_idx, tmax[i], hit) && hit.t < tmax[i]) {
+                        hits[i] = hit;
+                        tmax[i] = Scalar(hit.t);
+                    }
+                }
+        } else {
+            assert(stack_size + 2 <= stack.size());
+            Scalar   tnear_left, tnear_right;
+            uint32_t mask_left  = test_box(tree.node(entry.node_idx * 2 + 1).bbox, mask, tnear_left);
+            uint32_t mask_right = test_box(tree.node(entry.node_idx * 2 + 2).bbox, mask, tnear_right);
+            Entry    left { entry.node_idx * 2 + 1, mask_left };
+            Entry    right { entry.node_idx * 2 + 2, mask_right };
+            if (tnear_left < tnear_right)
+                std::swap(left, right);
+            // Push the farther child first, so that the nearer one is traced first.
+            if (left.mask)
+                stack[stack_size ++] = left;
+            if (right.mask)
+                stack[stack_size ++] = right;
+        }
+    }
+
+    return std::count_if(hits.begin(), hits.begin() + num_rays, [](const igl::Hit &hit) { return hit.id >= 0; });
+}
+
 // Finding a closest triangle, its closest point and squared distance to the closest point
 // on a 3D indexed triangle set using a pre-built AABBTreeIndirect::Tree.
 // Closest point to triangle test will be performed with the accuracy of VectorType::Scalar
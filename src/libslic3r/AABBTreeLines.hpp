@@ -15,6 +15,9 @@
 #include <type_traits>
 #include <vector>
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
 namespace Slic3r { namespace AABBTreeLines {
 
 namespace detail {
@@ -219,17 +222,23 @@ inline AABBTreeIndirect::Tree<LineType::Dim, typename LineType::Scalar> build_aa
         VectorType  m_centroid;
     };
 
-    std::vector<InputType> input;
-    input.reserve(lines.size());
-    for (size_t i = 0; i < lines.size(); ++i) {
+    std::vector<InputType> input(lines.size());
+    auto make_input = [&lines, &input](size_t i) {
         const LineType &line = lines[i];
-        InputType       n;
+        InputType      &n    = input[i];
         n.m_idx      = i;
         n.m_centroid = (line.a + line.b) * 0.5;
         n.m_bbox     = BoundingBox(line.a, line.a);
         n.m_bbox.extend(line.b);
-        input.emplace_back(n);
-    }
+    };
+    if (lines.size() >= TreeType::parallel_build_threshold)
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, lines.size()), [&make_input](const tbb::blocked_range<size_t> &range) {
+            for (size_t i = range.begin(); i < range.end(); ++i)
+                make_input(i);
+        });
+    else
+        for (size_t i = 0; i < lines.size(); ++i)
+            make_input(i);
 
     TreeType out;
     out.build(std::move(input));
@@ -13,7 +13,7 @@ class PrintRegionConfig;
 
 struct PerimeterRegion;
 
-using ExPolygons       = std::vector<ExPolygon>;
+using ExPolygons       = std::vector<ExPolygon, PointsAllocator<ExPolygon>>;
 using PerimeterRegions = std::vector<PerimeterRegion>;
 } // namespace Slic3r
 
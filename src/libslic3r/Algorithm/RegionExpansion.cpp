@@ -9,6 +9,8 @@
 #include <libslic3r/ClipperUtils.hpp>
 #include <libslic3r/Utils.hpp>
 #include <clipper/clipper_z.hpp>
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
 #include <numeric>
 #include <cmath>
 #include <iterator>
@@ -421,24 +423,42 @@ static Polygons propagate_wave_from_boundary(
 // Resulting regions are sorted by boundary id and source id.
 std::vector<RegionExpansion> propagate_waves(const WaveSeeds &seeds, const ExPolygons &boundary, const RegionExpansionParameters &params)
 {
-    std::vector<RegionExpansion> out;
-    ClipperLib::Paths            paths;
-    ClipperLib::ClipperOffset co;
-    co.ArcTolerance       = params.arc_tolerance;
-    co.ShortestEdgeLength = params.shortest_edge_length;
+    // Ranges of seeds sharing the same source and boundary, each range is expanded independently of the others.
+    std::vector<std::pair<size_t, size_t>> seed_ranges;
     for (auto it_seed = seeds.begin(); it_seed != seeds.end();) {
         auto it = it_seed;
-        paths.clear();
-        for (; it != seeds.end() && it->boundary == it_seed->boundary && it->src == it_seed->src; ++ it)
-            paths.emplace_back(it->path);
-        // Propagate the wavefront while clipping it with the trimmed boundary.
-        // Collect the expanded polygons, merge them with the source polygons.
-        RegionExpansion re;
-        for (Polygon &polygon : propagate_wave_from_boundary(co, paths, boundary[it_seed->boundary], params.initial_step, params.other_step, params.num_other_steps, params.max_inflation))
-            out.push_back({ std::move(polygon), it_seed->src, it_seed->boundary });
+        for (; it != seeds.end() && it->boundary == it_seed->boundary && it->src == it_seed->src; ++ it) ;
+        seed_ranges.emplace_back(it_seed - seeds.begin(), it - seeds.begin());
         it_seed = it;
     }
 
+    // The wave propagation costs a Clipper offset and a Clipper intersection per step, while the ranges
+    // are usually numerous and small, thus the ranges are expanded in parallel.
+    std::vector<Polygons> expanded(seed_ranges.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, seed_ranges.size()), [&seeds, &boundary, &params, &seed_ranges, &expanded](const tbb::blocked_range<size_t> &range) {
+        ClipperLib::Paths         paths;
+        ClipperLib::ClipperOffset co;
+        co.ArcTolerance       = params.arc_tolerance;
+        co.ShortestEdgeLength = params.shortest_edge_length;
+        for (size_t i = range.begin(); i < range.end(); ++ i) {
+            paths.clear();
+            for (size_t iseed = seed_ranges[i].first; iseed < seed_ranges[i].second; ++ iseed)
+                paths.emplace_back(seeds[iseed].path);
+            // Propagate the wavefront while clipping it with the trimmed boundary.
+            expanded[i] = propagate_wave_from_boundary(co, paths, boundary[seeds[seed_ranges[i].first].boundary],
+                params.initial_step, params.other_step, params.num_other_steps, params.max_inflation);
+        }
+    });
+
+    // Collect the expanded polygons in the order of the seeds.
+    std::vector<RegionExpansion> out;
+    out.reserve(std::accumulate(expanded.begin(), expanded.end(), size_t(0), [](size_t acc, const Polygons &polygons) { return acc + polygons.size(); }));
+    for (size_t i = 0; i < seed_ranges.size(); ++ i) {
+        const WaveSeed &seed = seeds[seed_ranges[i].first];
+        for (Polygon &polygon : expanded[i])
+            out.push_back({ std::move(polygon), seed.src, seed.boundary });
+    }
+
     return out;
 }
 
@@ -515,7 +535,7 @@ std::vector<Polygons> expand_expolygons(const ExPolygons &src, const ExPolygons
     return out;
 }
 
-std::vector<ExPolygon> merge_expansions_into_expolygons(ExPolygons &&src, std::vector<RegionExpansion> &&expanded)
+ExPolygons merge_expansions_into_expolygons(ExPolygons &&src, std::vector<RegionExpansion> &&expanded)
 {
     // expanded regions will be merged into source regions, thus they will be re-sorted by source id.
     std::sort(expanded.begin(), expanded.end(), [](const auto &l, const auto &r) { return l.src_id < r.src_id; });
@@ -568,7 +588,7 @@ std::vector<ExPolygon> merge_expansions_into_expolygons(ExPolygons &&src, std::v
     return out;
 }
 
-std::vector<ExPolygon> expand_merge_expolygons(ExPolygons &&src, const ExPolygons &boundary, const RegionExpansionParameters &params)
+ExPolygons expand_merge_expolygons(ExPolygons &&src, const ExPolygons &boundary, const RegionExpansionParameters &params)
 {
     // expanded regions are sorted by boundary id and source id
     std::vector<RegionExpansion> expanded = propagate_waves(src, boundary, params);
@@ -116,9 +116,9 @@ std::vector<Polygons> expand_expolygons(const ExPolygons &src, const ExPolygons
     size_t max_nr_steps);
 
 // Merge src with expansions, return the merged expolygons.
-std::vector<ExPolygon> merge_expansions_into_expolygons(ExPolygons &&src, std::vector<RegionExpansion> &&expanded);
+ExPolygons merge_expansions_into_expolygons(ExPolygons &&src, std::vector<RegionExpansion> &&expanded);
 
-std::vector<ExPolygon> expand_merge_expolygons(ExPolygons &&src, const ExPolygons &boundary, const RegionExpansionParameters &params);
+ExPolygons expand_merge_expolygons(ExPolygons &&src, const ExPolygons &boundary, const RegionExpansionParameters &params);
 
 } // Algorithm
 } // Slic3r
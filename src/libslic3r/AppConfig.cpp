@@ -66,6 +66,12 @@ void AppConfig::set_defaults()
         // Disable background processing by default as it is not stable.
         if (get("background_processing").empty())
             set("background_processing", "0");
+        if (get("speculative_slicing").empty())
+            set("speculative_slicing", "1");
+        if (get("coarse_preview_slicing").empty())
+            set("coarse_preview_slicing", "1");
+        if (get("show_performance_overlay").empty())
+            set("show_performance_overlay", "0");
         // Enable support issues alerts by default
         if (get("alert_when_supports_needed").empty())
             set("alert_when_supports_needed", "1");
@@ -332,12 +332,13 @@ Points SkeletalTrapezoidation::discretize(const VD::edge_type& vd_edge, const st
 SkeletalTrapezoidation::SkeletalTrapezoidation(const Polygons& polys, const BeadingStrategy& beading_strategy,
                                                double transitioning_angle, coord_t discretization_step_size,
                                                coord_t transition_filter_dist, coord_t allowed_filter_deviation,
-                                               coord_t beading_propagation_transition_dist
+                                               coord_t beading_propagation_transition_dist, std::function<void()> throw_on_cancel
     ): transitioning_angle(transitioning_angle),
     discretization_step_size(discretization_step_size),
     transition_filter_dist(transition_filter_dist),
     allowed_filter_deviation(allowed_filter_deviation),
     beading_propagation_transition_dist(beading_propagation_transition_dist),
+    throw_on_cancel(std::move(throw_on_cancel)),
     beading_strategy(beading_strategy)
 {
     constructFromPolygons(polys);
@@ -376,6 +377,7 @@ void SkeletalTrapezoidation::constructFromPolygons(const Polygons& polys)
 
     VD voronoi_diagram;
     voronoi_diagram.construct_voronoi(segments.cbegin(), segments.cend());
+    this->check_canceled();
 
 #ifdef ARACHNE_DEBUG_VORONOI
     {
@@ -385,7 +387,11 @@ void SkeletalTrapezoidation::constructFromPolygons(const Polygons& polys)
 #endif
 
     assert(this->graph.edges.empty() && this->graph.nodes.empty() && this->vd_edge_to_he_edge.empty() && this->vd_node_to_he_node.empty());
+    size_t num_cells_processed = 0;
     for (const VD::cell_type &cell : voronoi_diagram.cells()) {
+        // Transferring a cell is cheap, check for cancellation once per a batch of cells.
+        if ((++ num_cells_processed & 0x3FF) == 0)
+            this->check_canceled();
         if (!cell.incident_edge())
             continue; // There is no spoon
 
@@ -444,6 +450,7 @@ void SkeletalTrapezoidation::constructFromPolygons(const Polygons& polys)
 #ifdef ARACHNE_DEBUG
     assert(Geometry::VoronoiUtilsCgal::is_voronoi_diagram_planar_intersection(voronoi_diagram));
 #endif
+    this->check_canceled();
 
     separatePointyQuadEndNodes();
 
@@ -507,6 +514,7 @@ void SkeletalTrapezoidation::generateToolpaths(std::vector<VariableWidthLines> &
     export_graph_to_svg(debug_out_path("ST-updateIsCentral-final-%d.svg", iRun), this->graph, this->outline);
 #endif
 
+    this->check_canceled();
     filterCentral(central_filter_dist);
 
 #ifdef ARACHNE_DEBUG
@@ -516,30 +524,35 @@ void SkeletalTrapezoidation::generateToolpaths(std::vector<VariableWidthLines> &
     if (filter_outermost_central_edges)
         filterOuterCentral();
 
+    this->check_canceled();
     updateBeadCount();
 
 #ifdef ARACHNE_DEBUG
     export_graph_to_svg(debug_out_path("ST-updateBeadCount-final-%d.svg", iRun), this->graph, this->outline);
 #endif
 
+    this->check_canceled();
     filterNoncentralRegions();
 
 #ifdef ARACHNE_DEBUG
     export_graph_to_svg(debug_out_path("ST-filterNoncentralRegions-final-%d.svg", iRun), this->graph, this->outline);
 #endif
 
+    this->check_canceled();
     generateTransitioningRibs();
 
 #ifdef ARACHNE_DEBUG
     export_graph_to_svg(debug_out_path("ST-generateTransitioningRibs-final-%d.svg", iRun), this->graph, this->outline);
 #endif
 
+    this->check_canceled();
     generateExtraRibs();
 
 #ifdef ARACHNE_DEBUG
     export_graph_to_svg(debug_out_path("ST-generateExtraRibs-final-%d.svg", iRun), this->graph, this->outline);
 #endif
 
+    this->check_canceled();
     generateSegments();
 
 #ifdef ARACHNE_DEBUG
@@ -10,6 +10,7 @@
 #include <utility> // pair
 #include <list>
 #include <vector>
+#include <functional>
 
 #include "utils/HalfEdgeGraph.hpp"
 #include "utils/PolygonsSegmentIndex.hpp"
@@ -71,6 +72,7 @@ class SkeletalTrapezoidation
     coord_t beading_propagation_transition_dist; //!< When there are different beadings propagated from below and from above, use this transitioning distance
     static constexpr coord_t central_filter_dist = scaled<coord_t>(0.02); //!< Filter areas marked as 'central' smaller than this
     static constexpr coord_t snap_dist = scaled<coord_t>(0.02); //!< Generic arithmatic inaccuracy. Only used to determine whether a transition really needs to insert an extra edge.
+    std::function<void()> throw_on_cancel; //!< Called periodically, throws if the background processing was canceled. May be empty.
 
     /*!
      * The strategy to use to fill a certain shape with lines.
@@ -102,6 +104,8 @@ public:
      * \param beading_propagation_transition_dist When there are different
      * beadings propagated from below and from above, use this transitioning
      * distance.
+     * \param throw_on_cancel Called periodically while building the graph and
+     * generating the toolpaths, expected to throw if the processing was canceled.
      */
     SkeletalTrapezoidation(const Polygons& polys,
                            const BeadingStrategy& beading_strategy,
@@ -109,7 +113,8 @@ public:
     , coord_t discretization_step_size
     , coord_t transition_filter_dist
     , coord_t allowed_filter_deviation
-    , coord_t beading_propagation_transition_dist);
+    , coord_t beading_propagation_transition_dist
+    , std::function<void()> throw_on_cancel = nullptr);
 
     /*!
      * A skeletal graph through the polygons that we need to fill with beads.
@@ -164,6 +169,8 @@ protected:
      */
     void constructFromPolygons(const Polygons& polys);
 
+    void check_canceled() const { if (throw_on_cancel) throw_on_cancel(); }
+
     /*!
      * mapping each voronoi VD edge to the corresponding halfedge HE edge
      * In case the result segment is discretized, we map the VD edge to the *last* HE edge
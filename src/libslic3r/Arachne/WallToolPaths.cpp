@@ -32,7 +32,8 @@ namespace Slic3r::Arachne
 
 WallToolPaths::WallToolPaths(const Polygons& outline, const coord_t bead_width_0, const coord_t bead_width_x,
                              const size_t inset_count, const coord_t wall_0_inset, const coordf_t layer_height,
-                             const PrintObjectConfig &print_object_config, const PrintConfig &print_config)
+                             const PrintObjectConfig &print_object_config, const PrintConfig &print_config,
+                             std::function<void()> throw_on_cancel)
     : outline(outline)
     , bead_width_0(bead_width_0)
     , bead_width_x(bead_width_x)
@@ -47,6 +48,7 @@ WallToolPaths::WallToolPaths(const Polygons& outline, const coord_t bead_width_0
     , wall_transition_length(scaled<coord_t>(print_object_config.wall_transition_length.value))
     , toolpaths_generated(false)
     , print_object_config(print_object_config)
+    , throw_on_cancel(std::move(throw_on_cancel))
 {
     assert(!print_config.nozzle_diameter.empty());
     this->min_nozzle_diameter = float(*std::min_element(print_config.nozzle_diameter.values.begin(), print_config.nozzle_diameter.values.end()));
@@ -477,6 +479,8 @@ const std::vector<VariableWidthLines> &WallToolPaths::generate()
     fixSelfIntersections(epsilon_offset, prepared_outline);
     removeDegenerateVerts(prepared_outline);
     removeSmallAreas(prepared_outline, small_area_length * small_area_length, false);
+    if (this->throw_on_cancel)
+        this->throw_on_cancel();
 
     // The functions above could produce intersecting polygons that could cause a crash inside Arachne.
     // Applying Clipper union should be enough to get rid of this issue.
@@ -522,9 +526,12 @@ const std::vector<VariableWidthLines> &WallToolPaths::generate()
         discretization_step_size,
         transition_filter_dist,
         allowed_filter_deviation,
-        wall_transition_length
+        wall_transition_length,
+        this->throw_on_cancel
     );
     wall_maker.generateToolpaths(toolpaths);
+    if (this->throw_on_cancel)
+        this->throw_on_cancel();
 
     stitchToolPaths(toolpaths, this->bead_width_x);
 
@@ -5,8 +5,13 @@
 #define UTILS_HALF_EDGE_GRAPH_H
 
 
+#include <algorithm>
 #include <list>
 #include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
 
 
 
@@ -15,16 +20,104 @@
 
 namespace Slic3r::Arachne
 {
+
+// Storage of the elements of a single std::list of a HalfEdgeGraph.
+// The list nodes are allocated from large blocks, thus the nodes and edges created one after the other
+// are stored next to each other and there is no heap allocation per node or per edge.
+// Released elements are reused by the following allocations, the blocks are released together with the graph.
+class HalfEdgeGraphArena
+{
+public:
+    HalfEdgeGraphArena() = default;
+    HalfEdgeGraphArena(const HalfEdgeGraphArena &) = delete;
+    HalfEdgeGraphArena &operator=(const HalfEdgeGraphArena &) = delete;
+
+    void *allocate(size_t size, size_t align)
+    {
+        if (m_cell_size == 0 && align <= alignof(std::max_align_t))
+            // The first allocation is a list node, all the list nodes have the same size.
+            m_cell_size = cell_size(size, align);
+        if (! this->is_cell(size, align))
+            // Not a list node, for example a debug proxy of the container.
+            return ::operator new(size);
+        if (m_free != nullptr) {
+            void *out = m_free;
+            m_free    = m_free->next;
+            return out;
+        }
+        if (m_block_used == m_block_cells) {
+            // Grow the blocks geometrically, so that small graphs do not waste memory and large graphs are not fragmented.
+            m_block_cells = std::clamp<size_t>(m_blocks.size() * m_block_cells, 64, 8192);
+            m_blocks.emplace_back(new std::byte[m_block_cells * m_cell_size]);
+            m_block_used = 0;
+        }
+        return m_blocks.back().get() + m_cell_size * m_block_used ++;
+    }
+
+    void deallocate(void *p, size_t size, size_t align)
+    {
+        if (this->is_cell(size, align)) {
+            FreeCell *cell = static_cast<FreeCell*>(p);
+            cell->next = m_free;
+            m_free     = cell;
+        } else
+            ::operator delete(p);
+    }
+
+private:
+    struct FreeCell { FreeCell *next; };
+
+    static size_t cell_size(size_t size, size_t align) { return std::max((size + align - 1) / align * align, sizeof(FreeCell)); }
+    bool          is_cell(size_t size, size_t align) const
+        { return m_cell_size != 0 && align <= alignof(std::max_align_t) && cell_size(size, align) == m_cell_size; }
+
+    std::vector<std::unique_ptr<std::byte[]>> m_blocks;
+    size_t                                    m_cell_size   { 0 };
+    size_t                                    m_block_cells { 0 };
+    size_t                                    m_block_used  { 0 };
+    FreeCell                                 *m_free        { nullptr };
+};
+
+template<class T>
+class HalfEdgeGraphAllocator
+{
+public:
+    using value_type = T;
+
+    explicit HalfEdgeGraphAllocator(HalfEdgeGraphArena *arena) : arena(arena) {}
+    template<class U> HalfEdgeGraphAllocator(const HalfEdgeGraphAllocator<U> &other) : arena(other.arena) {}
+
+    T*   allocate(size_t n) { return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T))); }
+    void deallocate(T *p, size_t n) { arena->deallocate(p, n * sizeof(T), alignof(T)); }
+
+    template<class U> bool operator==(const HalfEdgeGraphAllocator<U> &rhs) const { return arena == rhs.arena; }
+    template<class U> bool operator!=(const HalfEdgeGraphAllocator<U> &rhs) const { return arena != rhs.arena; }
+
+    HalfEdgeGraphArena *arena;
+};
+
 template<class node_data_t, class edge_data_t, class derived_node_t, class derived_edge_t> // types of data contained in nodes and edges
 class HalfEdgeGraph
 {
 public:
     using edge_t = derived_edge_t;
     using node_t = derived_node_t;
-    using Edges = std::list<edge_t>;
-    using Nodes = std::list<node_t>;
-    Edges edges;
-    Nodes nodes;
+    using Edges = std::list<edge_t, HalfEdgeGraphAllocator<edge_t>>;
+    using Nodes = std::list<node_t, HalfEdgeGraphAllocator<node_t>>;
+
+    HalfEdgeGraph() = default;
+    // The lists point to the arenas of this graph.
+    HalfEdgeGraph(const HalfEdgeGraph &) = delete;
+    HalfEdgeGraph &operator=(const HalfEdgeGraph &) = delete;
+
+private:
+    // Declared before the lists, so that the lists are destroyed first.
+    HalfEdgeGraphArena m_edges_arena;
+    HalfEdgeGraphArena m_nodes_arena;
+
+public:
+    Edges edges { typename Edges::allocator_type(&m_edges_arena) };
+    Nodes nodes { typename Nodes::allocator_type(&m_nodes_arena) };
 };
 
 } // namespace Slic3r::Arachne
@@ -6,6 +6,7 @@
 #include "libslic3r/PresetBundle.hpp"
 #include "libslic3r/BuildVolume.hpp"
 
+#include <set>
 #include <string>
 
 #include "boost/regex.hpp"
@@ -138,7 +139,7 @@ static Sequential::SolverConfiguration get_solver_config(const Sequential::Print
 	return Sequential::SolverConfiguration(printer_geometry);
 }
 
-static std::vector<Sequential::ObjectToPrint> get_objects_to_print(const Model& model, const Sequential::PrinterGeometry& printer_geometry, int selected_bed)
+static std::vector<Sequential::ObjectToPrint> get_objects_to_print(const Model& model, const Sequential::PrinterGeometry& printer_geometry, int selected_bed, SeqConflictCache* cache = nullptr)
 {
 	// First extract the heights of interest.
 	std::vector<double> heights;
@@ -149,7 +150,8 @@ static std::vector<Sequential::ObjectToPrint> get_objects_to_print(const Model&
 	// Now collect all objects and projections of convex hull above respective heights.
 	std::vector<std::pair<Sequential::ObjectToPrint, std::vector<Sequential::ObjectToPrint>>> objects; // first = object id, the vector = ids of its instances
 	for (const ModelObject* mo : model.objects) {
-		const TriangleMesh& raw_mesh = mo->raw_mesh();
+		// Only calculated if the hulls are not cached.
+		std::optional<TriangleMesh> raw_mesh;
 		coord_t height = scaled(mo->instance_bounding_box(0).size().z());
 		std::vector<Sequential::ObjectToPrint> instances;
 		for (const ModelInstance* mi : mo->instances) {
@@ -161,10 +163,16 @@ static std::vector<Sequential::ObjectToPrint> get_objects_to_print(const Model&
 			if (mi->printable) {
 				instances.emplace_back(Sequential::ObjectToPrint{int(mi->id().id), true, height, {}});
 
+				if (cache) {
+					instances.back().pgns_at_height = cache->convex_hulls(*mo, *mi, heights);
+					continue;
+				}
+				if (! raw_mesh)
+					raw_mesh = mo->raw_mesh();
 				for (double height : heights) {
 					// It seems that zero level in the object instance is mi->get_offset().z(), however need to have bed as zero level,
 					// hence substracting mi->get_offset().z() from height seems to be an easy hack
-					Polygon pgn = its_convex_hull_2d_above(raw_mesh.its, mi->get_matrix_no_offset().cast<float>(), height - mi->get_offset().z());
+					Polygon pgn = its_convex_hull_2d_above(raw_mesh->its, mi->get_matrix_no_offset().cast<float>(), height - mi->get_offset().z());
 					instances.back().pgns_at_height.emplace_back(std::make_pair(scaled(height), pgn));
 				}
 			}
@@ -337,11 +345,66 @@ void SeqArrange::apply_seq_arrange(Model& model) const
 
 
 
-std::optional<std::pair<std::string, std::string> > check_seq_conflict(const Model& model, const ConfigBase& config)
+bool SeqConflictCache::HullsKey::operator==(const HullsKey& rhs) const
+{
+	if (parts.size() != rhs.parts.size() || offset_z != rhs.offset_z || heights != rhs.heights || ! trafo_no_offset.isApprox(rhs.trafo_no_offset, 0.))
+		return false;
+	for (size_t i = 0; i < parts.size(); ++ i)
+		if (parts[i].first != rhs.parts[i].first || ! parts[i].second.isApprox(rhs.parts[i].second, 0.))
+			return false;
+	return true;
+}
+
+const std::vector<std::pair<coord_t, Polygon>>& SeqConflictCache::convex_hulls(const ModelObject& mo, const ModelInstance& mi, const std::vector<double>& heights)
+{
+	HullsKey key;
+	for (const ModelVolume* v : mo.volumes)
+		if (v->is_model_part())
+			key.parts.emplace_back(v->get_mesh_shared_ptr(), v->get_matrix());
+	key.trafo_no_offset = mi.get_matrix_no_offset();
+	key.offset_z 		= mi.get_offset().z();
+	key.heights 		= heights;
+
+	Hulls& hulls = m_hulls[mi.id()];
+	hulls.used = true;
+	if (hulls.key == key && hulls.pgns_at_height.size() == heights.size())
+		return hulls.pgns_at_height;
+
+	// Same as in get_objects_to_print(), see the comment there.
+	TriangleMesh raw_mesh = mo.raw_mesh();
+	hulls.pgns_at_height.clear();
+	for (double height : heights)
+		hulls.pgns_at_height.emplace_back(scaled(height),
+			its_convex_hull_2d_above(raw_mesh.its, key.trafo_no_offset.cast<float>(), height - key.offset_z));
+	hulls.key = std::move(key);
+	return hulls.pgns_at_height;
+}
+
+void SeqConflictCache::drop_unused_hulls()
+{
+	for (auto it = m_hulls.begin(); it != m_hulls.end();)
+		if (it->second.used) {
+			it->second.used = false;
+			++ it;
+		} else
+			it = m_hulls.erase(it);
+}
+
+static bool printer_geometry_equal(const Sequential::PrinterGeometry& lhs, const Sequential::PrinterGeometry& rhs)
+{
+	return lhs.plate == rhs.plate && lhs.convex_heights == rhs.convex_heights && lhs.box_heights == rhs.box_heights && lhs.extruder_slices == rhs.extruder_slices;
+}
+
+static bool objects_to_print_equal(const std::vector<Sequential::ObjectToPrint>& lhs, const std::vector<Sequential::ObjectToPrint>& rhs)
+{
+	return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin(), [](const Sequential::ObjectToPrint& l, const Sequential::ObjectToPrint& r) {
+		return l.id == r.id && l.glued_to_next == r.glued_to_next && l.total_height == r.total_height && l.pgns_at_height == r.pgns_at_height;
+	});
+}
+
+std::optional<std::pair<std::string, std::string> > check_seq_conflict(const Model& model, const ConfigBase& config, SeqConflictCache* cache)
 {
 	Sequential::PrinterGeometry printer_geometry = get_printer_geometry(config);
-	Sequential::SolverConfiguration solver_config = get_solver_config(printer_geometry);
-	std::vector<Sequential::ObjectToPrint> objects = get_objects_to_print(model, printer_geometry, -1);
 
 	if (printer_geometry.extruder_slices.empty()) {
 		// If there are no data for extruder (such as extruder_clearance_radius set to 0),
@@ -349,27 +412,47 @@ std::optional<std::pair<std::string, std::string> > check_seq_conflict(const Mod
 	        return {};
 	}
 
-	Sequential::ScheduledPlate plate;
-	for (const ModelObject* mo : model.objects) {
-		int inst_id = -1;
-		for (const ModelInstance* mi : mo->instances) {
-			++inst_id;
+	// Only the instances on the active bed are checked against each other.
+	const int active_bed = s_multiple_beds.get_active_bed();
+	std::vector<Sequential::ObjectToPrint> objects = get_objects_to_print(model, printer_geometry, active_bed, cache);
+	if (cache)
+		cache->drop_unused_hulls();
 
-			auto it = s_multiple_beds.get_inst_map().find(mi->id());
-			if (it == s_multiple_beds.get_inst_map().end() || it->second != s_multiple_beds.get_active_bed())
-				continue;
+	std::set<int> objects_ids;
+	for (const Sequential::ObjectToPrint& otp : objects)
+		objects_ids.insert(otp.id);
 
+	Sequential::ScheduledPlate plate;
+	const Vec3d offset = s_multiple_beds.get_bed_translation(active_bed);
+	for (const ModelObject* mo : model.objects)
+		for (const ModelInstance* mi : mo->instances)
 			// Is this instance in objects to print? It may be unprintable or something.
-			auto it2 = std::find_if(objects.begin(), objects.end(), [&mi](const Sequential::ObjectToPrint& otp) { return otp.id == mi->id().id; });
-			if (it2 == objects.end())
-				continue;
-
-			Vec3d offset = s_multiple_beds.get_bed_translation(s_multiple_beds.get_active_bed());
-			plate.scheduled_objects.emplace_back(mi->id().id, scaled(mi->get_offset().x() - offset.x()), scaled(mi->get_offset().y() - offset.y()));
+			if (objects_ids.count(int(mi->id().id)))
+				plate.scheduled_objects.emplace_back(mi->id().id, scaled(mi->get_offset().x() - offset.x()), scaled(mi->get_offset().y() - offset.y()));
+
+	std::optional<std::pair<int,int>> conflict;
+	std::vector<std::tuple<int, coord_t, coord_t>> scheduled;
+	if (cache) {
+		scheduled.reserve(plate.scheduled_objects.size());
+		for (const Sequential::ScheduledObject& so : plate.scheduled_objects)
+			scheduled.emplace_back(so.id, so.x, so.y);
+	}
+	if (cache && cache->m_valid && cache->m_scheduled == scheduled &&
+		printer_geometry_equal(cache->m_printer_geometry, printer_geometry) && objects_to_print_equal(cache->m_objects, objects)) {
+		// Nothing moved since the last check.
+		conflict = cache->m_conflict;
+	} else {
+		Sequential::SolverConfiguration solver_config = get_solver_config(printer_geometry);
+		conflict = Sequential::check_ScheduledObjectsForSequentialConflict(solver_config, printer_geometry, objects, std::vector<Sequential::ScheduledPlate>(1, plate));
+		if (cache) {
+			cache->m_valid 			  = true;
+			cache->m_printer_geometry = std::move(printer_geometry);
+			cache->m_objects 		  = std::move(objects);
+			cache->m_scheduled 		  = std::move(scheduled);
+			cache->m_conflict 		  = conflict;
 		}
 	}
 
-	std::optional<std::pair<int,int>> conflict = Sequential::check_ScheduledObjectsForSequentialConflict(solver_config, printer_geometry, objects, std::vector<Sequential::ScheduledPlate>(1, plate));
 	if (conflict) {
 		std::pair<std::string, std::string> names;
 		for (const ModelObject* mo : model.objects)
@@ -2,6 +2,16 @@
 #define libslic3r_Arrange_Helper_hpp
 
 #include "libseqarrange/seq_interface.hpp"
+#include "libslic3r/ObjectID.hpp"
+#include "libslic3r/Point.hpp"
+
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 
 
@@ -9,13 +19,59 @@ namespace Slic3r {
 
 	class Model;
 	class ConfigBase;
+	class ModelObject;
+	class ModelInstance;
+	class TriangleMesh;
 
 	class ExceptionCannotAttemptSeqArrange : public std::exception {};
 	class ExceptionCannotApplySeqArrange : public std::exception {};
 
 	void arrange_model_sequential(Model& model, const ConfigBase& config);
     
-	std::optional<std::pair<std::string, std::string>> check_seq_conflict(const Model& model, const ConfigBase& config);
+	class SeqConflictCache;
+
+	// If cache is provided, the convex hulls of the instances are reused from the previous calls and the check itself
+	// is skipped if none of its inputs changed.
+	std::optional<std::pair<std::string, std::string>> check_seq_conflict(const Model& model, const ConfigBase& config, SeqConflictCache* cache = nullptr);
+
+	// Data of the last check_seq_conflict() call, which is repeated after each slicing of a sequential print,
+	// while mostly just the instances being moved on the bed.
+	class SeqConflictCache {
+	public:
+		// Convex hulls of the instance above the heights, calculated again only if the model parts of the object
+		// or the instance transformation (apart from the XY offset) changed.
+		const std::vector<std::pair<coord_t, Polygon>>& convex_hulls(const ModelObject& mo, const ModelInstance& mi, const std::vector<double>& heights);
+
+	private:
+		friend std::optional<std::pair<std::string, std::string>> check_seq_conflict(const Model& model, const ConfigBase& config, SeqConflictCache* cache);
+
+		struct HullsKey {
+			// Shared pointers keep the meshes alive, thus a different mesh may not be allocated at the same address.
+			std::vector<std::pair<std::shared_ptr<const TriangleMesh>, Transform3d>> parts;
+			Transform3d 			trafo_no_offset;
+			double 					offset_z;
+			std::vector<double> 	heights;
+
+			bool operator==(const HullsKey& rhs) const;
+		};
+		struct Hulls {
+			HullsKey 									 key;
+			std::vector<std::pair<coord_t, Polygon>>	 pgns_at_height;
+			// Was the entry used by the current check? Entries not used are dropped at its end.
+			bool 										 used { false };
+		};
+		void 											 drop_unused_hulls();
+
+		// Indexed by the ModelInstance ID.
+		std::map<ObjectID, Hulls> 						 m_hulls;
+
+		// Inputs and the result of the last check.
+		bool 											 m_valid { false };
+		Sequential::PrinterGeometry 					 m_printer_geometry;
+		std::vector<Sequential::ObjectToPrint> 			 m_objects;
+		std::vector<std::tuple<int, coord_t, coord_t>> 	 m_scheduled;
+		std::optional<std::pair<int, int>> 				 m_conflict;
+	};
 
 	// This is just a helper class to collect data for seq. arrangement, running the arrangement
 	// and applying the results to model. It is here so the processing itself can be offloaded
@@ -88,6 +88,51 @@ void BridgeDetector::initialize()
     */
 }
 
+// Intersect the edges with the horizontal scanlines y = y0 + i * dy, i < num_scanlines, of a coordinate system rotated by -angle.
+// The intersections of the i-th scanline are returned sorted in out_x[out_idx[i], out_idx[i + 1]).
+// An edge is intersected by the scanlines in the half open interval of its y span, so that a scanline passing
+// through a vertex is counted exactly once and the even-odd rule applies.
+static void scanline_intersections(
+    const Lines &edges, double angle, coord_t y0, coord_t dy, size_t num_scanlines, 
+    std::vector<size_t> &out_idx, std::vector<double> &out_x)
+{
+    const double s = sin(angle);
+    const double c = cos(angle);
+    auto rotate = [s, c](const Point &p) { return Vec2d(c * double(p.x()) + s * double(p.y()), c * double(p.y()) - s * double(p.x())); };
+    auto scanline_range = [y0, dy, num_scanlines](double ya, double yb) {
+        if (ya > yb)
+            std::swap(ya, yb);
+        double first = std::max(0., std::ceil((ya - double(y0)) / double(dy)));
+        double last  = std::min(double(num_scanlines), std::ceil((yb - double(y0)) / double(dy)));
+        return first < last ? std::make_pair(size_t(first), size_t(last)) : std::make_pair(size_t(0), size_t(0));
+    };
+
+    // Count the intersections per scanline.
+    out_idx.assign(num_scanlines + 1, 0);
+    for (const Line &edge : edges) {
+        auto [i_first, i_last] = scanline_range(rotate(edge.a).y(), rotate(edge.b).y());
+        for (size_t i = i_first; i < i_last; ++ i)
+            ++ out_idx[i + 1];
+    }
+    for (size_t i = 1; i <= num_scanlines; ++ i)
+        out_idx[i] += out_idx[i - 1];
+
+    // Fill in the intersections.
+    out_x.assign(out_idx.back(), 0.);
+    std::vector<size_t> cursor(out_idx.begin(), out_idx.end() - 1);
+    for (const Line &edge : edges) {
+        Vec2d a = rotate(edge.a);
+        Vec2d b = rotate(edge.b);
+        auto [i_first, i_last] = scanline_range(a.y(), b.y());
+        for (size_t i = i_first; i < i_last; ++ i) {
+            double y = double(y0 + coord_t(i) * dy);
+            out_x[cursor[i] ++] = a.x() + (y - a.y()) * (b.x() - a.x()) / (b.y() - a.y());
+        }
+    }
+    for (size_t i = 0; i < num_scanlines; ++ i)
+        std::sort(out_x.begin() + out_idx[i], out_x.begin() + out_idx[i + 1]);
+}
+
 bool BridgeDetector::detect_angle(double bridge_direction_override)
 {
     if (this->_edges.empty() || this->_anchor_regions.empty()) 
@@ -111,42 +156,46 @@ bool BridgeDetector::detect_angle(double bridge_direction_override)
     /*  we'll now try several directions using a rudimentary visibility check:
         bridge in several directions and then sum the length of lines having both
         endpoints within anchors */
+    // The test lines are horizontal scanlines in a coordinate system rotated by -angle. Instead of clipping them
+    // with Clipper and testing their end points against the anchors polygon by polygon, the edges of the clip area
+    // and of the anchors are intersected with the scanlines and the intervals are evaluated with the even-odd rule.
+    const Lines         clip_edges   = to_lines(clip_area);
+    const Lines         anchor_edges = to_lines(this->_anchor_regions);
+    std::vector<size_t> clip_idx, anchor_idx;
+    std::vector<double> clip_x, anchor_x;
         
     bool have_coverage = false;
     for (size_t i_angle = 0; i_angle < candidates.size(); ++ i_angle)
     {
         const double angle = candidates[i_angle].angle;
 
-        Lines lines;
-        {
-            // Get an oriented bounding box around _anchor_regions.
-            BoundingBox bbox = get_extents_rotated(this->_anchor_regions, - angle);
-            // Cover the region with line segments.
-            lines.reserve((bbox.max(1) - bbox.min(1) + this->spacing) / this->spacing);
-            double s = sin(angle);
-            double c = cos(angle);
-            //FIXME Vojtech: The lines shall be spaced half the line width from the edge, but then 
-            // some of the test cases fail. Need to adjust the test cases then?
-//            for (coord_t y = bbox.min(1) + this->spacing / 2; y <= bbox.max(1); y += this->spacing)
-            for (coord_t y = bbox.min(1); y <= bbox.max(1); y += this->spacing)
-                lines.push_back(Line(
-                    Point((coord_t)round(c * bbox.min(0) - s * y), (coord_t)round(c * y + s * bbox.min(0))),
-                    Point((coord_t)round(c * bbox.max(0) - s * y), (coord_t)round(c * y + s * bbox.max(0)))));
-        }
+        // Get an oriented bounding box around _anchor_regions.
+        BoundingBox bbox = get_extents_rotated(this->_anchor_regions, - angle);
+        //FIXME Vojtech: The lines shall be spaced half the line width from the edge, but then 
+        // some of the test cases fail. Need to adjust the test cases then?
+        const size_t num_scanlines = size_t((bbox.max(1) - bbox.min(1)) / this->spacing) + 1;
+        scanline_intersections(clip_edges,   angle, bbox.min(1), this->spacing, num_scanlines, clip_idx,   clip_x);
+        scanline_intersections(anchor_edges, angle, bbox.min(1), this->spacing, num_scanlines, anchor_idx, anchor_x);
 
         double total_length = 0;
         double max_length = 0;
-        {
-            Lines clipped_lines = intersection_ln(lines, clip_area);
-            for (size_t i = 0; i < clipped_lines.size(); ++i) {
-                const Line &line = clipped_lines[i];
-                if (expolygons_contain(this->_anchor_regions, line.a) && expolygons_contain(this->_anchor_regions, line.b)) {
+        for (size_t i = 0; i < num_scanlines; ++ i) {
+            auto anchor_begin = anchor_x.begin() + anchor_idx[i];
+            auto anchor_end   = anchor_x.begin() + anchor_idx[i + 1];
+            if (anchor_begin == anchor_end)
+                continue;
+            auto anchored = [anchor_begin, anchor_end](double x) { return ((std::lower_bound(anchor_begin, anchor_end, x) - anchor_begin) & 1) == 1; };
+            for (size_t j = clip_idx[i]; j + 1 < clip_idx[i + 1]; j += 2) {
+                // Interval of the scanline inside the clip area, limited by the bounding box of the anchors.
+                double x0 = std::max(clip_x[j], double(bbox.min(0)));
+                double x1 = std::min(clip_x[j + 1], double(bbox.max(0)));
+                if (x0 < x1 && anchored(x0) && anchored(x1)) {
                     // This line could be anchored.
-                    double len = line.length();
+                    double len = x1 - x0;
                     total_length += len;
                     max_length = std::max(max_length, len);
                 }
-            }        
+            }
         }
         if (total_length == 0.)
             continue;
@@ -7,7 +7,9 @@
 #include <oneapi/tbb/blocked_range.h>
 #include <oneapi/tbb/parallel_for.h>
 #include <algorithm>
+#include <limits>
 #include <numeric>
+#include <optional>
 #include <unordered_set>
 #include <mutex>
 #include <cmath>
@@ -81,11 +83,11 @@ static ExPolygons get_print_object_bottom_layer_expolygons(const PrintObject &pr
 // Returns ExPolygons of bottom layer for every print object in Print after elephant foot compensation.
 static std::vector<ExPolygons> get_print_bottom_layers_expolygons(const Print &print)
 {
-    std::vector<ExPolygons> bottom_layers_expolygons;
-    bottom_layers_expolygons.reserve(print.objects().size());
-    for (const PrintObject *object : print.objects())
-        bottom_layers_expolygons.emplace_back(get_print_object_bottom_layer_expolygons(*object));
-
+    std::vector<ExPolygons> bottom_layers_expolygons(print.objects().size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, print.objects().size()), [&print, &bottom_layers_expolygons](const tbb::blocked_range<size_t> &range) {
+        for (size_t print_object_idx = range.begin(); print_object_idx < range.end(); ++ print_object_idx)
+            bottom_layers_expolygons[print_object_idx] = get_print_object_bottom_layer_expolygons(*print.objects()[print_object_idx]);
+    });
     return bottom_layers_expolygons;
 }
 
@@ -150,28 +152,147 @@ static ConstPrintObjectPtrs get_top_level_objects_with_brim(const Print &print,
     return top_level_objects_with_brim;
 }
 
-static Polygons top_level_outer_brim_islands(const ConstPrintObjectPtrs &top_level_objects_with_brim, const double scaled_resolution)
+// Outer brim islands of a single object, not translated to the instances of the object yet.
+struct ObjectBrimIslands
 {
-    Polygons islands;
-    for (const PrintObject *object : top_level_objects_with_brim) {
-        if (!object->has_brim())
-            continue;
+    const PrintObject *object;
+    Polygons           islands;
+};
 
-        //FIXME how about the brim type?
-        auto     brim_separation = float(scale_(object->config().brim_separation.value));
-        Polygons islands_object;
-        for (const ExPolygon &ex_poly : get_print_object_bottom_layer_expolygons(*object)) {
-            Polygons contour_offset = offset(ex_poly.contour, brim_separation, ClipperLib::jtSquare);
-            for (Polygon &poly : contour_offset)
-                poly.douglas_peucker(scaled_resolution);
+static std::vector<ObjectBrimIslands> top_level_outer_brim_islands(const Print                   &print,
+                                                                   const ConstPrintObjectPtrs    &top_level_objects_with_brim,
+                                                                   const std::vector<ExPolygons> &bottom_layers_expolygons,
+                                                                   const double                   scaled_resolution)
+{
+    assert(print.objects().size() == bottom_layers_expolygons.size());
+    std::vector<ObjectBrimIslands> out;
+    for (const PrintObject *object : top_level_objects_with_brim)
+        if (object->has_brim())
+            out.push_back({ object, {} });
+
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, out.size()), [&print, &bottom_layers_expolygons, &out, scaled_resolution](const tbb::blocked_range<size_t> &range) {
+        for (size_t idx = range.begin(); idx < range.end(); ++ idx) {
+            const PrintObject *object           = out[idx].object;
+            const size_t       print_object_idx = std::find(print.objects().begin(), print.objects().end(), object) - print.objects().begin();
+            assert(print_object_idx < bottom_layers_expolygons.size());
+            //FIXME how about the brim type?
+            auto brim_separation = float(scale_(object->config().brim_separation.value));
+            for (const ExPolygon &ex_poly : bottom_layers_expolygons[print_object_idx]) {
+                Polygons contour_offset = offset(ex_poly.contour, brim_separation, ClipperLib::jtSquare);
+                for (Polygon &poly : contour_offset)
+                    poly.douglas_peucker(scaled_resolution);
+
+                polygons_append(out[idx].islands, std::move(contour_offset));
+            }
+        }
+    });
+    return out;
+}
 
-            polygons_append(islands_object, std::move(contour_offset));
+// Expand the outer brim islands by num_loops brim lines, returns the brim lines before merging.
+// The brims of two instances can only interact if the bounding boxes of their islands inflated by the brim width overlap,
+// therefore the instances are clustered by their bounding boxes and the clusters are expanded independently in parallel.
+// The brim lines of an instance not interacting with any other instance are generated once per object and translated.
+static Polygons top_level_outer_brim_loops(const std::vector<ObjectBrimIslands> &objects_islands,
+                                           const size_t                          num_loops,
+                                           const Flow                           &flow,
+                                           const double                          scaled_resolution,
+                                           PrintTryCancel                        try_cancel)
+{
+    const auto spacing = float(flow.scaled_spacing());
+    const auto margin  = coord_t(spacing * float(num_loops + 1)) + SCALED_EPSILON;
+
+    struct InstanceIslands {
+        size_t               object_idx;
+        const PrintInstance *instance;
+        BoundingBox          bbox;
+    };
+    std::vector<InstanceIslands> instances;
+    for (size_t object_idx = 0; object_idx < objects_islands.size(); ++ object_idx)
+        if (const ObjectBrimIslands &object_islands = objects_islands[object_idx]; ! object_islands.islands.empty()) {
+            BoundingBox bbox = get_extents(object_islands.islands);
+            bbox.offset(margin);
+            for (const PrintInstance &instance : object_islands.object->instances()) {
+                instances.push_back({ object_idx, &instance, bbox });
+                instances.back().bbox.translate(instance.shift);
+            }
         }
 
-        for (const PrintInstance &instance : object->instances())
-            append_and_translate(islands, islands_object, instance);
+    // Union-find of the instances with overlapping bounding boxes, sweeping along the X axis.
+    std::vector<size_t> parent(instances.size());
+    std::iota(parent.begin(), parent.end(), 0);
+    auto find_root = [&parent](size_t idx) {
+        while (parent[idx] != idx)
+            idx = parent[idx] = parent[parent[idx]];
+        return idx;
+    };
+    {
+        std::vector<size_t> sorted(instances.size());
+        std::iota(sorted.begin(), sorted.end(), 0);
+        std::sort(sorted.begin(), sorted.end(), [&instances](size_t l, size_t r) { return instances[l].bbox.min.x() < instances[r].bbox.min.x(); });
+        for (size_t i = 0; i < sorted.size(); ++ i)
+            for (size_t j = i + 1; j < sorted.size() && instances[sorted[j]].bbox.min.x() <= instances[sorted[i]].bbox.max.x(); ++ j)
+                if (instances[sorted[i]].bbox.overlap(instances[sorted[j]].bbox))
+                    parent[find_root(sorted[i])] = find_root(sorted[j]);
     }
-    return islands;
+    std::vector<std::vector<size_t>> clusters;
+    {
+        std::vector<size_t> root_to_cluster(instances.size(), std::numeric_limits<size_t>::max());
+        for (size_t idx = 0; idx < instances.size(); ++ idx) {
+            size_t &cluster_idx = root_to_cluster[find_root(idx)];
+            if (cluster_idx == std::numeric_limits<size_t>::max()) {
+                cluster_idx = clusters.size();
+                clusters.emplace_back();
+            }
+            clusters[cluster_idx].emplace_back(idx);
+        }
+    }
+
+    // Jobs: expansion of the untranslated islands of an object shared by its isolated instances, or expansion of a cluster.
+    std::vector<Polygons> object_loops(objects_islands.size());
+    std::vector<Polygons> cluster_loops(clusters.size());
+    std::vector<char>     object_loops_needed(objects_islands.size(), false);
+    std::vector<size_t>   jobs;
+    for (size_t cluster_idx = 0; cluster_idx < clusters.size(); ++ cluster_idx)
+        if (clusters[cluster_idx].size() > 1)
+            jobs.emplace_back(cluster_idx);
+        else if (size_t object_idx = instances[clusters[cluster_idx].front()].object_idx; ! object_loops_needed[object_idx]) {
+            object_loops_needed[object_idx] = true;
+            jobs.emplace_back(clusters.size() + object_idx);
+        }
+
+    auto expand_islands = [num_loops, spacing, scaled_resolution, &try_cancel](Polygons islands) {
+        Polygons loops;
+        for (size_t i = 0; i < num_loops; ++ i) {
+            try_cancel();
+            islands = expand(islands, spacing, ClipperLib::jtSquare);
+            for (Polygon &poly : islands)
+                poly.douglas_peucker(scaled_resolution);
+            polygons_append(loops, shrink(islands, 0.5f * spacing));
+        }
+        return loops;
+    };
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, jobs.size(), 1),
+        [&jobs, &clusters, &instances, &objects_islands, &object_loops, &cluster_loops, &expand_islands](const tbb::blocked_range<size_t> &range) {
+            for (size_t job_idx = range.begin(); job_idx < range.end(); ++ job_idx)
+                if (size_t job = jobs[job_idx]; job < clusters.size()) {
+                    Polygons islands;
+                    for (size_t idx : clusters[job])
+                        append_and_translate(islands, objects_islands[instances[idx].object_idx].islands, *instances[idx].instance);
+                    cluster_loops[job] = expand_islands(std::move(islands));
+                } else
+                    object_loops[job - clusters.size()] = expand_islands(objects_islands[job - clusters.size()].islands);
+        });
+
+    Polygons loops;
+    for (size_t cluster_idx = 0; cluster_idx < clusters.size(); ++ cluster_idx)
+        if (clusters[cluster_idx].size() > 1)
+            polygons_append(loops, std::move(cluster_loops[cluster_idx]));
+        else {
+            const InstanceIslands &instance = instances[clusters[cluster_idx].front()];
+            append_and_translate(loops, object_loops[instance.object_idx], *instance.instance);
+        }
+    return loops;
 }
 
 static ExPolygons top_level_outer_brim_area(const Print                   &print,
@@ -185,41 +306,48 @@ static ExPolygons top_level_outer_brim_area(const Print                   &print
     for (const PrintObject *object : top_level_objects_with_brim)
         top_level_objects_idx.insert(object->id().id);
 
-    ExPolygons brim_area;
-    ExPolygons no_brim_area;
-    for(size_t print_object_idx = 0; print_object_idx < print.objects().size(); ++print_object_idx) {
-        const PrintObject *object            = print.objects()[print_object_idx];
-        const BrimType     brim_type         = object->config().brim_type.value;
-        const float        brim_separation   = scale_(object->config().brim_separation.value);
-        const float        brim_width        = scale_(object->config().brim_width.value);
-        const bool         is_top_outer_brim = top_level_objects_idx.find(object->id().id) != top_level_objects_idx.end();
-
-        ExPolygons brim_area_object;
-        ExPolygons no_brim_area_object;
-        for (const ExPolygon &ex_poly : bottom_layers_expolygons[print_object_idx]) {
-            if ((brim_type == BrimType::btOuterOnly || brim_type == BrimType::btOuterAndInner) && is_top_outer_brim)
-                append(brim_area_object, diff_ex(offset(ex_poly.contour, brim_width + brim_separation, ClipperLib::jtSquare), offset(ex_poly.contour, brim_separation, ClipperLib::jtSquare)));
-
-            // After 7ff76d07684858fd937ef2f5d863f105a10f798e offset and shrink don't work with CW polygons (holes), so let's make it CCW.
-            Polygons ex_poly_holes_reversed = ex_poly.holes;
-            polygons_reverse(ex_poly_holes_reversed);
-            if (brim_type == BrimType::btOuterOnly || brim_type == BrimType::btNoBrim)
-                append(no_brim_area_object, shrink_ex(ex_poly_holes_reversed, no_brim_offset, ClipperLib::jtSquare));
-
-            if (brim_type == BrimType::btInnerOnly || brim_type == BrimType::btNoBrim)
-                append(no_brim_area_object, diff_ex(offset(ex_poly.contour, no_brim_offset, ClipperLib::jtSquare), ex_poly_holes_reversed));
-
-            if (brim_type != BrimType::btNoBrim)
-                append(no_brim_area_object, offset_ex(ExPolygon(ex_poly.contour), brim_separation, ClipperLib::jtSquare));
-
-            no_brim_area_object.emplace_back(ex_poly.contour);
+    // The areas are calculated per object in parallel, then translated to the instances.
+    std::vector<ExPolygons> brim_area_objects(print.objects().size());
+    std::vector<ExPolygons> no_brim_area_objects(print.objects().size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, print.objects().size()),
+        [&print, &bottom_layers_expolygons, &top_level_objects_idx, &brim_area_objects, &no_brim_area_objects, no_brim_offset](const tbb::blocked_range<size_t> &range) {
+        for (size_t print_object_idx = range.begin(); print_object_idx < range.end(); ++ print_object_idx) {
+            const PrintObject *object            = print.objects()[print_object_idx];
+            const BrimType     brim_type         = object->config().brim_type.value;
+            const float        brim_separation   = scale_(object->config().brim_separation.value);
+            const float        brim_width        = scale_(object->config().brim_width.value);
+            const bool         is_top_outer_brim = top_level_objects_idx.find(object->id().id) != top_level_objects_idx.end();
+
+            ExPolygons &brim_area_object    = brim_area_objects[print_object_idx];
+            ExPolygons &no_brim_area_object = no_brim_area_objects[print_object_idx];
+            for (const ExPolygon &ex_poly : bottom_layers_expolygons[print_object_idx]) {
+                if ((brim_type == BrimType::btOuterOnly || brim_type == BrimType::btOuterAndInner) && is_top_outer_brim)
+                    append(brim_area_object, diff_ex(offset(ex_poly.contour, brim_width + brim_separation, ClipperLib::jtSquare), offset(ex_poly.contour, brim_separation, ClipperLib::jtSquare)));
+
+                // After 7ff76d07684858fd937ef2f5d863f105a10f798e offset and shrink don't work with CW polygons (holes), so let's make it CCW.
+                Polygons ex_poly_holes_reversed = ex_poly.holes;
+                polygons_reverse(ex_poly_holes_reversed);
+                if (brim_type == BrimType::btOuterOnly || brim_type == BrimType::btNoBrim)
+                    append(no_brim_area_object, shrink_ex(ex_poly_holes_reversed, no_brim_offset, ClipperLib::jtSquare));
+
+                if (brim_type == BrimType::btInnerOnly || brim_type == BrimType::btNoBrim)
+                    append(no_brim_area_object, diff_ex(offset(ex_poly.contour, no_brim_offset, ClipperLib::jtSquare), ex_poly_holes_reversed));
+
+                if (brim_type != BrimType::btNoBrim)
+                    append(no_brim_area_object, offset_ex(ExPolygon(ex_poly.contour), brim_separation, ClipperLib::jtSquare));
+
+                no_brim_area_object.emplace_back(ex_poly.contour);
+            }
         }
+    });
 
-        for (const PrintInstance &instance : object->instances()) {
-            append_and_translate(brim_area, brim_area_object, instance);
-            append_and_translate(no_brim_area, no_brim_area_object, instance);
+    ExPolygons brim_area;
+    ExPolygons no_brim_area;
+    for (size_t print_object_idx = 0; print_object_idx < print.objects().size(); ++ print_object_idx)
+        for (const PrintInstance &instance : print.objects()[print_object_idx]->instances()) {
+            append_and_translate(brim_area, brim_area_objects[print_object_idx], instance);
+            append_and_translate(no_brim_area, no_brim_area_objects[print_object_idx], instance);
         }
-    }
 
     return diff_ex(brim_area, no_brim_area);
 }
@@ -305,68 +433,95 @@ static std::vector<InnerBrimExPolygons> inner_brim_area(const Print
     for (const PrintObject *object : top_level_objects_with_brim)
         top_level_objects_idx.insert(object->id().id);
 
-    std::vector<ExPolygons> brim_area_innermost(print.objects().size());
-    ExPolygons              brim_area;
-    ExPolygons              no_brim_area;
-    Polygons                holes_reversed;
-
-    // polygon_idx must correspond to idx generated inside has_polygons_nothing_inside()
-    size_t polygon_idx = 0;
-    for(size_t print_object_idx = 0; print_object_idx < print.objects().size(); ++print_object_idx) {
-        const PrintObject *object          = print.objects()[print_object_idx];
-        const BrimType     brim_type       = object->config().brim_type.value;
-        const float        brim_separation = scale_(object->config().brim_separation.value);
-        const float        brim_width      = scale_(object->config().brim_width.value);
-        const bool         top_outer_brim  = top_level_objects_idx.find(object->id().id) != top_level_objects_idx.end();
-
-        ExPolygons brim_area_innermost_object;
-        ExPolygons brim_area_object;
-        ExPolygons no_brim_area_object;
-        Polygons   holes_reversed_object;
-        for (const ExPolygon &ex_poly : bottom_layers_expolygons[print_object_idx]) {
-            if (brim_type == BrimType::btOuterOnly || brim_type == BrimType::btOuterAndInner) {
-                if (top_outer_brim)
-                    no_brim_area_object.emplace_back(ex_poly);
-                else
-                    append(brim_area_object, diff_ex(offset(ex_poly.contour, brim_width + brim_separation, ClipperLib::jtSquare), offset(ex_poly.contour, brim_separation, ClipperLib::jtSquare)));
-            }
-
-            // After 7ff76d07684858fd937ef2f5d863f105a10f798e offset and shrink don't work with CW polygons (holes), so let's make it CCW.
-            Polygons ex_poly_holes_reversed = ex_poly.holes;
-            polygons_reverse(ex_poly_holes_reversed);
-            for ([[maybe_unused]] const PrintInstance &instance : object->instances()) {
-                ++polygon_idx; // Increase idx because of the contour of the ExPolygon.
-
-                if (brim_type == BrimType::btInnerOnly || brim_type == BrimType::btOuterAndInner)
-                    for(const Polygon &hole : ex_poly_holes_reversed) {
-                        size_t hole_idx = &hole - &ex_poly_holes_reversed.front();
-                        if (has_nothing_inside[polygon_idx + hole_idx])
-                            append(brim_area_innermost_object, shrink_ex({hole}, brim_separation, ClipperLib::jtSquare));
-                        else
-                            append(brim_area_object, diff_ex(shrink_ex({hole}, brim_separation, ClipperLib::jtSquare), shrink_ex({hole}, brim_width + brim_separation, ClipperLib::jtSquare)));
-                    }
+    // polygon_idx must correspond to idx generated inside has_polygons_nothing_inside(), calculate the first polygon_idx of each object.
+    std::vector<size_t> first_polygon_idx(print.objects().size() + 1, 0);
+    for (size_t print_object_idx = 0; print_object_idx < print.objects().size(); ++print_object_idx) {
+        size_t num_polygons = 0;
+        for (const ExPolygon &ex_poly : bottom_layers_expolygons[print_object_idx])
+            num_polygons += 1 + ex_poly.holes.size();
+        first_polygon_idx[print_object_idx + 1] = first_polygon_idx[print_object_idx] + num_polygons * print.objects()[print_object_idx]->instances().size();
+    }
+    assert(first_polygon_idx.back() == has_nothing_inside.size());
+
+    // The areas are calculated per object in parallel, then translated to the instances.
+    struct ObjectInnerBrimArea {
+        ExPolygons brim_area_innermost;
+        ExPolygons brim_area;
+        ExPolygons no_brim_area;
+        Polygons   holes_reversed;
+    };
+    std::vector<ObjectInnerBrimArea> object_areas(print.objects().size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, print.objects().size()),
+        [&print, &bottom_layers_expolygons, &has_nothing_inside, &top_level_objects_idx, &first_polygon_idx, &object_areas, no_brim_offset](const tbb::blocked_range<size_t> &range) {
+        for (size_t print_object_idx = range.begin(); print_object_idx < range.end(); ++ print_object_idx) {
+            const PrintObject   *object          = print.objects()[print_object_idx];
+            const BrimType       brim_type       = object->config().brim_type.value;
+            const float          brim_separation = scale_(object->config().brim_separation.value);
+            const float          brim_width      = scale_(object->config().brim_width.value);
+            const bool           top_outer_brim  = top_level_objects_idx.find(object->id().id) != top_level_objects_idx.end();
+            ObjectInnerBrimArea &area            = object_areas[print_object_idx];
+            size_t               polygon_idx     = first_polygon_idx[print_object_idx];
+
+            for (const ExPolygon &ex_poly : bottom_layers_expolygons[print_object_idx]) {
+                if (brim_type == BrimType::btOuterOnly || brim_type == BrimType::btOuterAndInner) {
+                    if (top_outer_brim)
+                        area.no_brim_area.emplace_back(ex_poly);
+                    else
+                        append(area.brim_area, diff_ex(offset(ex_poly.contour, brim_width + brim_separation, ClipperLib::jtSquare), offset(ex_poly.contour, brim_separation, ClipperLib::jtSquare)));
+                }
 
-                polygon_idx += ex_poly.holes.size(); // Increase idx for every hole of the ExPolygon.
-            }
+                // After 7ff76d07684858fd937ef2f5d863f105a10f798e offset and shrink don't work with CW polygons (holes), so let's make it CCW.
+                Polygons ex_poly_holes_reversed = ex_poly.holes;
+                polygons_reverse(ex_poly_holes_reversed);
+                // The brim areas of a hole are the same for all the instances, calculate them once.
+                std::vector<std::optional<ExPolygons>> hole_innermost(ex_poly_holes_reversed.size());
+                std::vector<std::optional<ExPolygons>> hole_normal(ex_poly_holes_reversed.size());
+                for ([[maybe_unused]] const PrintInstance &instance : object->instances()) {
+                    ++polygon_idx; // Increase idx because of the contour of the ExPolygon.
+
+                    if (brim_type == BrimType::btInnerOnly || brim_type == BrimType::btOuterAndInner)
+                        for (size_t hole_idx = 0; hole_idx < ex_poly_holes_reversed.size(); ++ hole_idx) {
+                            const Polygon &hole = ex_poly_holes_reversed[hole_idx];
+                            if (has_nothing_inside[polygon_idx + hole_idx]) {
+                                if (! hole_innermost[hole_idx])
+                                    hole_innermost[hole_idx] = shrink_ex({hole}, brim_separation, ClipperLib::jtSquare);
+                                append(area.brim_area_innermost, *hole_innermost[hole_idx]);
+                            } else {
+                                if (! hole_normal[hole_idx])
+                                    hole_normal[hole_idx] = diff_ex(shrink_ex({hole}, brim_separation, ClipperLib::jtSquare), shrink_ex({hole}, brim_width + brim_separation, ClipperLib::jtSquare));
+                                append(area.brim_area, *hole_normal[hole_idx]);
+                            }
+                        }
+
+                    polygon_idx += ex_poly.holes.size(); // Increase idx for every hole of the ExPolygon.
+                }
 
-            if (brim_type == BrimType::btInnerOnly || brim_type == BrimType::btNoBrim)
-                append(no_brim_area_object, diff_ex(offset(ex_poly.contour, no_brim_offset, ClipperLib::jtSquare), ex_poly_holes_reversed));
+                if (brim_type == BrimType::btInnerOnly || brim_type == BrimType::btNoBrim)
+                    append(area.no_brim_area, diff_ex(offset(ex_poly.contour, no_brim_offset, ClipperLib::jtSquare), ex_poly_holes_reversed));
 
-            if (brim_type == BrimType::btOuterOnly || brim_type == BrimType::btNoBrim)
-                append(no_brim_area_object, diff_ex(ex_poly.contour, shrink_ex(ex_poly_holes_reversed, no_brim_offset, ClipperLib::jtSquare)));
+                if (brim_type == BrimType::btOuterOnly || brim_type == BrimType::btNoBrim)
+                    append(area.no_brim_area, diff_ex(ex_poly.contour, shrink_ex(ex_poly_holes_reversed, no_brim_offset, ClipperLib::jtSquare)));
 
-            append(holes_reversed_object, ex_poly_holes_reversed);
+                append(area.holes_reversed, std::move(ex_poly_holes_reversed));
+            }
+            append(area.no_brim_area, offset_ex(bottom_layers_expolygons[print_object_idx], brim_separation, ClipperLib::jtSquare));
+            assert(polygon_idx == first_polygon_idx[print_object_idx + 1]);
         }
-        append(no_brim_area_object, offset_ex(bottom_layers_expolygons[print_object_idx], brim_separation, ClipperLib::jtSquare));
+    });
 
-        for (const PrintInstance &instance : object->instances()) {
-            append_and_translate(brim_area_innermost[print_object_idx], brim_area_innermost_object, instance);
-            append_and_translate(brim_area, brim_area_object, instance);
-            append_and_translate(no_brim_area, no_brim_area_object, instance);
-            append_and_translate(holes_reversed, holes_reversed_object, instance);
+    std::vector<ExPolygons> brim_area_innermost(print.objects().size());
+    ExPolygons              brim_area;
+    ExPolygons              no_brim_area;
+    Polygons                holes_reversed;
+    for (size_t print_object_idx = 0; print_object_idx < print.objects().size(); ++print_object_idx) {
+        const ObjectInnerBrimArea &area = object_areas[print_object_idx];
+        for (const PrintInstance &instance : print.objects()[print_object_idx]->instances()) {
+            append_and_translate(brim_area_innermost[print_object_idx], area.brim_area_innermost, instance);
+            append_and_translate(brim_area, area.brim_area, instance);
+            append_and_translate(no_brim_area, area.no_brim_area, instance);
+            append_and_translate(holes_reversed, area.holes_reversed, instance);
         }
     }
-    assert(polygon_idx == has_nothing_inside.size());
 
     ExPolygons brim_area_innermost_merged;
     // Append all innermost brim areas.
@@ -525,20 +680,12 @@ ExtrusionEntityCollection make_brim(const Print &print, PrintTryCancel try_cance
     Flow                    flow                        = print.brim_flow();
     std::vector<ExPolygons> bottom_layers_expolygons    = get_print_bottom_layers_expolygons(print);
     ConstPrintObjectPtrs    top_level_objects_with_brim = get_top_level_objects_with_brim(print, bottom_layers_expolygons);
-    Polygons                islands                     = top_level_outer_brim_islands(top_level_objects_with_brim, scaled_resolution);
+    std::vector<ObjectBrimIslands> islands              = top_level_outer_brim_islands(print, top_level_objects_with_brim, bottom_layers_expolygons, scaled_resolution);
     ExPolygons              islands_area_ex             = top_level_outer_brim_area(print, top_level_objects_with_brim, bottom_layers_expolygons, float(flow.scaled_spacing()));
     islands_area                                        = to_polygons(islands_area_ex);
 
-    Polygons        loops;
     size_t          num_loops = size_t(floor(max_brim_width(print.objects()) / flow.spacing()));
-    for (size_t i = 0; i < num_loops; ++i) {
-        try_cancel();
-        islands = expand(islands, float(flow.scaled_spacing()), ClipperLib::jtSquare);
-        for (Polygon &poly : islands) 
-            poly.douglas_peucker(scaled_resolution);
-        polygons_append(loops, shrink(islands, 0.5f * float(flow.scaled_spacing())));
-    }
-    loops = union_pt_chained_outside_in(loops);
+    Polygons        loops     = union_pt_chained_outside_in(top_level_outer_brim_loops(islands, num_loops, flow, scaled_resolution, try_cancel));
 
     std::vector<Polylines> loops_pl_by_levels;
     {
@@ -570,7 +717,7 @@ ExtrusionEntityCollection make_brim(const Print &print, PrintTryCancel try_cance
 
     {
         SVG svg(debug_out_path("brim-%d.svg", irun).c_str(), get_extents(all_loops));
-        svg.draw(union_ex(islands), "blue");
+        svg.draw(union_ex(loops), "blue");
         svg.draw(islands_area_ex, "green");
         svg.draw(all_loops, "black", coord_t(scale_(0.1)));
     }
@@ -581,7 +728,7 @@ ExtrusionEntityCollection make_brim(const Print &print, PrintTryCancel try_cance
 #ifdef BRIM_DEBUG_TO_SVG
     {
         SVG svg(debug_out_path("brim-connected-%d.svg", irun).c_str(), get_extents(all_loops));
-        svg.draw(union_ex(islands), "blue");
+        svg.draw(union_ex(loops), "blue");
         svg.draw(islands_area_ex, "green");
         svg.draw(all_loops, "black", coord_t(scale_(0.1)));
     }
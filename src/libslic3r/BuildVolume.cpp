@@ -10,6 +10,7 @@
 #include <limits>
 #include <cassert>
 #include <cstddef>
+#include <optional>
 
 #include "ClipperUtils.hpp"
 #include "Geometry/ConvexHull.hpp"
@@ -202,10 +203,12 @@ static inline BuildVolume::ObjectState rectangle_test(const indexed_triangle_set
 #endif
 
 // Trim the input transformed triangle mesh with print bed and test the remaining vertices with is_inside callback.
+// The mesh vertices were transformed by transform_vertices(), they are shifted by offset to the coordinate system of a bed.
 // Return inside / colliding / outside state.
 template<typename InsideFn>
-BuildVolume::ObjectState object_state_templ(const indexed_triangle_set &its, const Transform3f &trafo, bool may_be_below_bed, InsideFn is_inside)
+BuildVolume::ObjectState object_state_templ(const indexed_triangle_set &its, const std::vector<Vec3f> &vertices, const Vec3f &offset, bool may_be_below_bed, InsideFn is_inside)
 {
+    assert(vertices.size() == its.vertices.size());
     size_t num_inside = 0;
     size_t num_above  = 0;
     bool   inside     = false;
@@ -217,12 +220,12 @@ BuildVolume::ObjectState object_state_templ(const indexed_triangle_set &its, con
         // Slower test, needs to clip the object edges with the print bed plane.
         // 1) Allocate transformed vertices with their position with respect to print bed surface.
         std::vector<char> sides;
-        sides.reserve(its.vertices.size());
+        sides.reserve(vertices.size());
 
         const auto sign = [](const stl_vertex& pt) { return pt.z() > world_min_z ? 1 : pt.z() < world_min_z ? -1 : 0; };
 
-        for (const stl_vertex &v : its.vertices) {
-            const stl_vertex pt = trafo * v;
+        for (const stl_vertex &v : vertices) {
+            const stl_vertex pt = v + offset;
             const int        s = sign(pt);
             sides.emplace_back(s);
             if (s >= 0) {
@@ -241,7 +244,7 @@ BuildVolume::ObjectState object_state_templ(const indexed_triangle_set &its, con
         // 2) Calculate intersections of triangle edges with the build surface.
         inside  = num_inside > 0;
         outside = num_inside < num_above;
-        if (num_above < its.vertices.size() && ! (inside && outside)) {
+        if (num_above < vertices.size() && ! (inside && outside)) {
             // Not completely above the build surface and status may still change by testing edges intersecting the build platform.
             for (const stl_triangle_vertex_indices &tri : its.indices) {
                 const int s[3] = { sides[tri(0)], sides[tri(1)], sides[tri(2)] };
@@ -251,8 +254,8 @@ BuildVolume::ObjectState object_state_templ(const indexed_triangle_set &its, con
                     for (int iedge = 0; iedge < 3; ++ iedge) {
                         if (s[iprev] * s[iedge] == -1) {
                             // edge intersects the build surface. Calculate intersection point.
-                            const stl_vertex p1 = trafo * its.vertices[tri(iprev)];
-                            const stl_vertex p2 = trafo * its.vertices[tri(iedge)];
+                            const stl_vertex p1 = vertices[tri(iprev)] + offset;
+                            const stl_vertex p2 = vertices[tri(iedge)] + offset;
                             assert(sign(p1) == s[iprev]);
                             assert(sign(p2) == s[iedge]);
                             assert((p1.z() - world_min_z) * (p2.z() - world_min_z) < 0);
@@ -272,9 +275,9 @@ BuildVolume::ObjectState object_state_templ(const indexed_triangle_set &its, con
     {
         // Much simpler and faster code, not clipping the object with the print bed.
         assert(! may_be_below_bed);
-        num_above = its.vertices.size();
-        for (const stl_vertex &v : its.vertices) {
-            const stl_vertex pt = trafo * v;
+        num_above = vertices.size();
+        for (const stl_vertex &v : vertices) {
+            const stl_vertex pt = v + offset;
             assert(pt.z() >= world_min_z);
             if (is_inside(pt))
                 ++ num_inside;
@@ -286,12 +289,62 @@ BuildVolume::ObjectState object_state_templ(const indexed_triangle_set &its, con
     return inside ? (outside ? BuildVolume::ObjectState::Colliding : BuildVolume::ObjectState::Inside) : BuildVolume::ObjectState::Outside;
 }
 
-BuildVolume::ObjectState BuildVolume::object_state(const indexed_triangle_set& its, const Transform3f& trafo_orig, bool may_be_below_bed, bool ignore_bottom, int* bed_idx) const
+// Classify the object by the bounding box of its transformed vertices shifted by offset, without testing the vertices.
+// All the is_inside tests are convex, thus if all corners of the bounding box are inside, so are all the tested points.
+// reject_box is a 2D bounding box of the area accepted by is_inside. Returns std::nullopt if the vertices need to be tested.
+template<typename InsideFn>
+std::optional<BuildVolume::ObjectState> object_state_bbox_templ(const BoundingBox3Base<Vec3f> &bbox_orig, const Vec3f &offset, bool may_be_below_bed,
+    const BoundingBoxf &reject_box, InsideFn is_inside)
+{
+    static constexpr const auto world_min_z = float(-BuildVolume::SceneEpsilon);
+    const BoundingBox3Base<Vec3f> bbox(bbox_orig.min + offset, bbox_orig.max + offset);
+    if (may_be_below_bed && bbox.max.z() < world_min_z)
+        // All vertices are below the print bed.
+        return BuildVolume::ObjectState::Below;
+    if (reject_box.defined && (bbox.max.x() < reject_box.min.x() || bbox.min.x() > reject_box.max.x() ||
+        bbox.max.y() < reject_box.min.y() || bbox.min.y() > reject_box.max.y()))
+        // All the tested points including the intersections of edges with the print bed are outside.
+        return BuildVolume::ObjectState::Outside;
+    // Only the points above the print bed are tested if the object may be below the print bed.
+    const float min_z = may_be_below_bed ? std::max(bbox.min.z(), world_min_z) : bbox.min.z();
+    for (const float z : { min_z, bbox.max.z() })
+        for (const float y : { bbox.min.y(), bbox.max.y() })
+            for (const float x : { bbox.min.x(), bbox.max.x() })
+                if (! is_inside(Vec3f(x, y, z)))
+                    return std::nullopt;
+    return BuildVolume::ObjectState::Inside;
+}
+
+template<typename InsideFn>
+BuildVolume::ObjectState object_state_bed_templ(const indexed_triangle_set &its, const std::vector<Vec3f> &vertices, const BoundingBox3Base<Vec3f> &bbox,
+    const Vec3f &offset, bool may_be_below_bed, const BoundingBoxf &reject_box, InsideFn is_inside)
+{
+    if (! vertices.empty())
+        if (std::optional<BuildVolume::ObjectState> state = object_state_bbox_templ(bbox, offset, may_be_below_bed, reject_box, is_inside); state)
+            return *state;
+    return object_state_templ(its, vertices, offset, may_be_below_bed, is_inside);
+}
+
+BuildVolume::ObjectState BuildVolume::object_state(const indexed_triangle_set& its, const Transform3f& trafo, bool may_be_below_bed, bool ignore_bottom, int* bed_idx) const
 {
     ObjectState out = ObjectState::Outside;
     if (bed_idx)
         *bed_idx = -1;
 
+    // The vertices are transformed once and shifted to the coordinate system of each bed tested.
+    std::vector<Vec3f>      vertices;
+    BoundingBox3Base<Vec3f> bbox;
+    vertices.reserve(its.vertices.size());
+    for (const stl_vertex &v : its.vertices)
+        vertices.emplace_back(trafo * v);
+    if (! vertices.empty()) {
+        bbox.min = bbox.max = vertices.front();
+        for (const Vec3f &v : vertices) {
+            bbox.min = bbox.min.cwiseMin(v);
+            bbox.max = bbox.max.cwiseMax(v);
+        }
+    }
+
     // When loading an old project with more than the maximum number of beds,
     // we still want to move the objects to the respective positions.
     // Max beds number is momentarily increased when doing the rearrange, so use it.
@@ -302,8 +355,7 @@ BuildVolume::ObjectState BuildVolume::object_state(const indexed_triangle_set& i
     for (int bed_id = 0; bed_id <= max_bed; ++bed_id) {
 
 
-    Transform3f trafo = trafo_orig;
-    trafo.pretranslate(-s_multiple_beds.get_bed_translation(bed_id).cast<float>());
+    const Vec3f offset = - s_multiple_beds.get_bed_translation(bed_id).cast<float>();
 
     switch (m_type) {
     case Type::Rectangle:
@@ -317,24 +369,32 @@ BuildVolume::ObjectState BuildVolume::object_state(const indexed_triangle_set& i
         // The following test correctly interprets intersection of a non-convex object with a rectangular build volume.
         //return rectangle_test(its, trafo, to_2d(build_volume.min), to_2d(build_volume.max), build_volume.max.z());
         //FIXME This test does NOT correctly interprets intersection of a non-convex object with a rectangular build volume.
-        out = object_state_templ(its, trafo, may_be_below_bed, [build_volumef](const Vec3f& pt) { return build_volumef.contains(pt); });
+        out = object_state_bed_templ(its, vertices, bbox, offset, may_be_below_bed, { to_2d(build_volume.min), to_2d(build_volume.max) },
+            [build_volumef](const Vec3f& pt) { return build_volumef.contains(pt); });
         break;
     }
     case Type::Circle:
     {
         Geometry::Circlef circle { unscaled<float>(m_circle.center), unscaled<float>(m_circle.radius + SceneEpsilon) };
+        const BoundingBoxf reject_box { (circle.center.array() - circle.radius).cast<double>(), (circle.center.array() + circle.radius).cast<double>() };
         out = m_max_print_height == 0.0 ?
-            object_state_templ(its, trafo, may_be_below_bed, [circle](const Vec3f& pt) { return circle.contains(to_2d(pt)); }) :
-            object_state_templ(its, trafo, may_be_below_bed, [circle, z = m_max_print_height + SceneEpsilon](const Vec3f& pt) { return pt.z() < z && circle.contains(to_2d(pt)); });
+            object_state_bed_templ(its, vertices, bbox, offset, may_be_below_bed, reject_box, [circle](const Vec3f& pt) { return circle.contains(to_2d(pt)); }) :
+            object_state_bed_templ(its, vertices, bbox, offset, may_be_below_bed, reject_box, [circle, z = m_max_print_height + SceneEpsilon](const Vec3f& pt) { return pt.z() < z && circle.contains(to_2d(pt)); });
         break;
     }
     case Type::Convex:
     //FIXME doing test on convex hull until we learn to do test on non-convex polygons efficiently.
     case Type::Custom:
+    {
+        BoundingBoxf reject_box;
+        for (const std::vector<Vec2d> *chain : { &m_top_bottom_convex_hull_decomposition_scene.first, &m_top_bottom_convex_hull_decomposition_scene.second })
+            for (const Vec2d &pt : *chain)
+                reject_box.merge(pt);
         out = m_max_print_height == 0.0 ?
-            object_state_templ(its, trafo, may_be_below_bed, [this](const Vec3f& pt) { return Geometry::inside_convex_polygon(m_top_bottom_convex_hull_decomposition_scene, to_2d(pt).cast<double>()); }) :
-            object_state_templ(its, trafo, may_be_below_bed, [this, z = m_max_print_height + SceneEpsilon](const Vec3f& pt) { return pt.z() < z && Geometry::inside_convex_polygon(m_top_bottom_convex_hull_decomposition_scene, to_2d(pt).cast<double>()); });
+            object_state_bed_templ(its, vertices, bbox, offset, may_be_below_bed, reject_box, [this](const Vec3f& pt) { return Geometry::inside_convex_polygon(m_top_bottom_convex_hull_decomposition_scene, to_2d(pt).cast<double>()); }) :
+            object_state_bed_templ(its, vertices, bbox, offset, may_be_below_bed, reject_box, [this, z = m_max_print_height + SceneEpsilon](const Vec3f& pt) { return pt.z() < z && Geometry::inside_convex_polygon(m_top_bottom_convex_hull_decomposition_scene, to_2d(pt).cast<double>()); });
         break;
+    }
     case Type::Invalid:
     default:
         out = ObjectState::Inside;
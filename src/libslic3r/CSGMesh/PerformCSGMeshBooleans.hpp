@@ -7,6 +7,10 @@
 
 #include <stack>
 #include <vector>
+#include <optional>
+#include <algorithm>
+
+#include <boost/container_hash/hash.hpp>
 
 #include "CSGMesh.hpp"
 
@@ -45,6 +49,8 @@ MeshBoolean::cgal::CGALMeshPtr get_cgalmesh(const CSGPartT &csgpart)
 namespace detail_cgal {
 
 using MeshBoolean::cgal::CGALMeshPtr;
+using MeshBoolean::cgal::CGALMeshKey;
+using MeshBoolean::cgal::CGALMeshCache;
 
 inline void perform_csg(CSGType op, CGALMeshPtr &dst, CGALMeshPtr &src)
 {
@@ -69,16 +75,101 @@ inline void perform_csg(CSGType op, CGALMeshPtr &dst, CGALMeshPtr &src)
     }
 }
 
+// Reduce the operands of consecutive parts with the same operation into one
+// operand, A - B - C is A - (B + C), A * B * C is A * (B * C). Independent pairs
+// are processed in parallel. The result is left in the first element, operands
+// which failed to convert (nullptr) are skipped as in perform_csg.
+inline void reduce_csg_operands(CSGType op, std::vector<CGALMeshPtr> &operands)
+{
+    operands.erase(std::remove(operands.begin(), operands.end(), nullptr), operands.end());
+
+    CSGType reduce_op = op == CSGType::Intersection ? CSGType::Intersection : CSGType::Union;
+
+    while (operands.size() > 1) {
+        size_t pairs = operands.size() / 2;
+        execution::for_each(ex_tbb, size_t(0), pairs, [&operands, reduce_op](size_t i) {
+            perform_csg(reduce_op, operands[2 * i], operands[2 * i + 1]);
+        }, execution::max_concurrency(ex_tbb));
+
+        for (size_t i = 1; i < pairs; ++i)
+            operands[i] = std::move(operands[2 * i]);
+
+        if (operands.size() % 2)
+            operands[pairs++] = std::move(operands.back());
+
+        operands.resize(pairs);
+    }
+}
+
+// Key of the transformed mesh of the csg part for the CGALMeshCache.
+template<class CSGPartT> CGALMeshKey get_cgalmesh_key(const CSGPartT &csgpart)
+{
+    CGALMeshKey key;
+
+    if (const indexed_triangle_set *its = get_mesh(csgpart)) {
+        key.vertices = its->vertices.size();
+        key.faces    = its->indices.size();
+
+        for (const stl_vertex &v : its->vertices)
+            for (int c = 0; c < 3; ++c)
+                boost::hash_combine(key.hash, v(c));
+
+        for (const stl_triangle_vertex_indices &f : its->indices)
+            for (int c = 0; c < 3; ++c)
+                boost::hash_combine(key.hash, f(c));
+    }
+
+    Transform3f tr = get_transform(csgpart);
+    for (Eigen::Index i = 0; i < tr.matrix().size(); ++i)
+        boost::hash_combine(key.hash, tr.matrix().data()[i]);
+
+    return key;
+}
+
 template<class Ex, class It>
-std::vector<CGALMeshPtr> get_cgalptrs(Ex policy, const Range<It> &csgrange)
+std::vector<CGALMeshKey> get_cgalmesh_keys(Ex policy, const Range<It> &csgrange)
 {
-    std::vector<CGALMeshPtr> ret(csgrange.size());
+    std::vector<CGALMeshKey> ret(csgrange.size());
     execution::for_each(policy, size_t(0), csgrange.size(),
                         [&csgrange, &ret](size_t i) {
         auto it = csgrange.begin();
         std::advance(it, i);
+        ret[i] = get_cgalmesh_key(*it);
+    });
+
+    return ret;
+}
+
+// Same as get_cgalmesh, the converted meshes are shared through the CGALMeshCache.
+template<class CSGPartT>
+CGALMeshPtr get_cached_cgalmesh(const CSGPartT &csgpart, const CGALMeshKey &key)
+{
+    // Stack operations without a mesh are left to get_cgalmesh
+    if (!get_mesh(csgpart))
+        return get_cgalmesh(csgpart);
+
+    CGALMeshPtr ret = CGALMeshCache::global().find(key);
+    if (!ret) {
+        ret = get_cgalmesh(csgpart);
+        if (ret)
+            CGALMeshCache::global().insert(key, *ret);
+    }
+
+    return ret;
+}
+
+template<class Ex, class It>
+std::vector<CGALMeshPtr> get_cgalptrs(Ex policy, const Range<It> &csgrange,
+                                      const std::vector<CGALMeshKey> &keys,
+                                      size_t first = 0)
+{
+    std::vector<CGALMeshPtr> ret(csgrange.size());
+    execution::for_each(policy, first, csgrange.size(),
+                        [&csgrange, &ret, &keys](size_t i) {
+        auto it = csgrange.begin();
+        std::advance(it, i);
         auto &csgpart = *it;
-        ret[i]        = get_cgalmesh(csgpart);
+        ret[i]        = get_cached_cgalmesh(csgpart, keys[i]);
     });
 
     return ret;
@@ -87,6 +178,10 @@ std::vector<CGALMeshPtr> get_cgalptrs(Ex policy, const Range<It> &csgrange)
 } // namespace detail
 
 // Process the sequence of CSG parts with CGAL.
+// The operands of consecutive parts with the same operation are reduced in
+// parallel. The intermediate results of the top level are cached, so when
+// only the parts towards the end of the sequence change, the booleans of the
+// preceding parts are not repeated.
 template<class It>
 void perform_csgmesh_booleans(MeshBoolean::cgal::CGALMeshPtr &cgalm,
                               const Range<It>                &csgrange)
@@ -97,43 +192,124 @@ void perform_csgmesh_booleans(MeshBoolean::cgal::CGALMeshPtr &cgalm,
 
     struct Frame {
         CSGType op; CGALMeshPtr cgalptr;
+
+        // Pending operands of consecutive parts with the same operation
+        CSGType run_op = CSGType::Union;
+        std::vector<CGALMeshPtr> run;
+
         explicit Frame(CSGType csgop = CSGType::Union)
             : op{csgop}
             , cgalptr{MeshBoolean::cgal::triangle_mesh_to_cgal(indexed_triangle_set{})}
         {}
+
+        void flush()
+        {
+            if (run.empty())
+                return;
+
+            reduce_csg_operands(run_op, run);
+            if (!run.empty())
+                perform_csg(run_op, cgalptr, run.front());
+
+            run.clear();
+        }
     };
 
+    std::vector<CGALMeshKey> keys = get_cgalmesh_keys(ex_tbb, csgrange);
+
+    // Keys of the results of the parts up to the given index, only valid where
+    // the part ends at the top level of the stack.
+    std::vector<CGALMeshKey> prefix_keys(keys.size());
+    std::vector<bool> is_top_level(keys.size());
+    CGALMeshKey prefix;
+    size_t depth = 1;
+    size_t csgidx = 0;
+    for (auto &csgpart : csgrange) {
+        if (get_stack_operation(csgpart) == CSGStackOp::Push)
+            ++depth;
+
+        if (get_stack_operation(csgpart) == CSGStackOp::Pop && depth > 1)
+            --depth;
+
+        boost::hash_combine(prefix.hash, keys[csgidx].hash);
+        boost::hash_combine(prefix.hash, int(get_operation(csgpart)));
+        boost::hash_combine(prefix.hash, int(get_stack_operation(csgpart)));
+        prefix.vertices += keys[csgidx].vertices;
+        prefix.faces     = csgidx + 1;
+
+        prefix_keys[csgidx]  = prefix;
+        is_top_level[csgidx] = depth == 1;
+        ++csgidx;
+    }
+
     std::stack opstack{std::vector<Frame>{}};
 
     opstack.push(Frame{});
 
-    std::vector<CGALMeshPtr> cgalmeshes = get_cgalptrs(ex_tbb, csgrange);
+    // Resume from the longest cached prefix
+    size_t first = 0;
+    for (size_t i = keys.size(); i > 0; --i) {
+        if (!is_top_level[i - 1])
+            continue;
 
-    size_t csgidx = 0;
+        if (CGALMeshPtr cached = CGALMeshCache::global().find(prefix_keys[i - 1])) {
+            opstack.top().cgalptr = std::move(cached);
+            first = i;
+            break;
+        }
+    }
+
+    std::vector<CGALMeshPtr> cgalmeshes = get_cgalptrs(ex_tbb, csgrange, keys, first);
+
+    // Index of the last part included in the top level frame, its result is
+    // cached whenever the pending operands of the top level are applied.
+    size_t top_last = first;
+    auto add_operand = [&opstack, &prefix_keys, &top_last](CSGType op, CGALMeshPtr &&m, size_t idx) {
+        Frame &fr = opstack.top();
+        if (!fr.run.empty() && fr.run_op != op) {
+            fr.flush();
+            if (opstack.size() == 1 && top_last > 0 && fr.cgalptr)
+                CGALMeshCache::global().insert(prefix_keys[top_last - 1], *fr.cgalptr);
+        }
+
+        fr.run_op = op;
+        fr.run.emplace_back(std::move(m));
+
+        if (opstack.size() == 1)
+            top_last = idx + 1;
+    };
+
+    csgidx = 0;
     for (auto &csgpart : csgrange) {
+        size_t idx = csgidx++;
+        if (idx < first)
+            continue;
 
         auto op = get_operation(csgpart);
-        CGALMeshPtr &cgalptr = cgalmeshes[csgidx++];
+        CGALMeshPtr &cgalptr = cgalmeshes[idx];
 
-        if (get_stack_operation(csgpart) == CSGStackOp::Push) {
+        if (get_stack_operation(csgpart) == CSGStackOp::Push)
             opstack.push(Frame{op});
-            op = CSGType::Union;
-        }
 
-        Frame *top = &opstack.top();
-
-        perform_csg(get_operation(csgpart), top->cgalptr, cgalptr);
+        add_operand(get_operation(csgpart), std::move(cgalptr), idx);
 
         if (get_stack_operation(csgpart) == CSGStackOp::Pop) {
+            Frame *top = &opstack.top();
+            top->flush();
             CGALMeshPtr src = std::move(top->cgalptr);
             auto popop = opstack.top().op;
             opstack.pop();
-            CGALMeshPtr &dst = opstack.top().cgalptr;
-            perform_csg(popop, dst, src);
+            add_operand(popop, std::move(src), idx);
         }
     }
 
-    cgalm = std::move(opstack.top().cgalptr);
+    Frame &top = opstack.top();
+    bool has_pending = !top.run.empty();
+    top.flush();
+    if (has_pending && opstack.size() == 1 && top_last > 0 && top.cgalptr)
+        CGALMeshCache::global().insert(prefix_keys[top_last - 1], *top.cgalptr);
+
+    cgalm = std::move(top.cgalptr);
 }
 
 // Check if all requirements for doing mesh booleans are met by the input csgrange.
@@ -144,39 +320,51 @@ It check_csgmesh_booleans(const Range<It> &csgrange, Visitor &&vfn)
 {
     using namespace detail_cgal;
 
-    std::vector<CGALMeshPtr> cgalmeshes(csgrange.size());
-    auto check_part = [&csgrange, &cgalmeshes](size_t i)
+    std::vector<bool> valid(csgrange.size(), false);
+    auto check_part = [&csgrange, &valid](size_t i)
     {
         auto it = csgrange.begin();
         std::advance(it, i);
         auto &csgpart = *it;
-        auto m = get_cgalmesh(csgpart);
 
         // mesh can be nullptr if this is a stack push or pull
         if (!get_mesh(csgpart) && get_stack_operation(csgpart) != CSGStackOp::Continue) {
-            cgalmeshes[i] = MeshBoolean::cgal::triangle_mesh_to_cgal(indexed_triangle_set{});
+            valid[i] = true;
             return;
         }
 
-        try {
-            if (!m || MeshBoolean::cgal::empty(*m))
-                return;
+        CGALMeshKey key = get_cgalmesh_key(csgpart);
+        if (std::optional<bool> cached = CGALMeshCache::global().find_validity(key)) {
+            valid[i] = *cached;
+            return;
+        }
 
-            if (MeshBoolean::cgal::does_self_intersect(*m))
-                return;
+        auto m = get_cached_cgalmesh(csgpart, key);
 
-            if (!MeshBoolean::cgal::does_bound_a_volume(*m))
-                return;
-        }
-        catch (...) { return; }
+        valid[i] = [&m] {
+            try {
+                if (!m || MeshBoolean::cgal::empty(*m))
+                    return false;
+
+                if (MeshBoolean::cgal::does_self_intersect(*m))
+                    return false;
+
+                if (!MeshBoolean::cgal::does_bound_a_volume(*m))
+                    return false;
+            }
+            catch (...) { return false; }
+
+            return true;
+        }();
 
-        cgalmeshes[i] = std::move(m);
+        if (m)
+            CGALMeshCache::global().insert_validity(key, valid[i]);
     };
     execution::for_each(ex_tbb, size_t(0), csgrange.size(), check_part);
 
     It ret = csgrange.end();
     for (size_t i = 0; i < csgrange.size(); ++i) {
-        if (!cgalmeshes[i]) {
+        if (!valid[i]) {
             auto it = csgrange.begin();
             std::advance(it, i);
             vfn(it);
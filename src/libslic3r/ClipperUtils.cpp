@@ -303,6 +303,24 @@ bool has_duplicate_points(const ClipperLib::PolyTree &polytree)
 }
 #endif
 
+// ClipperOffset shared by the offset functions running on the same thread, cleared and set up for a new offset.
+// Reusing the ClipperOffset recycles its working buffers instead of allocating them for each offset call.
+// The returned object is only valid until the next call of clipper_offset() on the same thread.
+static ClipperLib::ClipperOffset& clipper_offset(float delta, ClipperLib::JoinType joinType, double miterLimit)
+{
+    thread_local ClipperLib::ClipperOffset co;
+    co.Clear();
+    if (joinType == jtRound) {
+        co.ArcTolerance = miterLimit;
+        co.MiterLimit   = ClipperLib::ClipperOffset().MiterLimit;
+    } else {
+        co.ArcTolerance = ClipperLib::ClipperOffset().ArcTolerance;
+        co.MiterLimit   = miterLimit;
+    }
+    co.ShortestEdgeLength = std::abs(delta * ClipperOffsetShortestEdgeFactor);
+    return co;
+}
+
 // Offset CCW contours outside, CW contours (holes) inside.
 // Don't calculate union of the output paths.
 template<typename PathsProvider>
@@ -310,15 +328,10 @@ static ClipperLib::Paths raw_offset(PathsProvider &&paths, float offset, Clipper
 {
     CLIPPER_UTILS_TIME_LIMIT_MILLIS(CLIPPER_UTILS_TIME_LIMIT_DEFAULT);
 
-    ClipperLib::ClipperOffset co;
+    ClipperLib::ClipperOffset &co = clipper_offset(offset, joinType, miterLimit);
     ClipperLib::Paths out;
     out.reserve(paths.size());
     ClipperLib::Paths out_this;
-    if (joinType == jtRound)
-        co.ArcTolerance = miterLimit;
-    else
-        co.MiterLimit = miterLimit;
-    co.ShortestEdgeLength = std::abs(offset * ClipperOffsetShortestEdgeFactor);
     for (const ClipperLib::Path &path : paths) {
         co.Clear();
         // Execute reorients the contours so that the outer most contour has a positive area. Thus the output
@@ -344,6 +357,71 @@ static ClipperLib::Paths safety_offset(PathsProvider &&paths)
     return raw_offset(std::forward<PathsProvider>(paths), ClipperSafetyOffset, DefaultJoinType, DefaultMiterLimit);
 }
 
+// Bounding boxes of paths sorted by their left side to find out quickly, whether a bounding box overlaps any of them.
+class PathsBoundingBoxes
+{
+public:
+    template<class TPaths>
+    explicit PathsBoundingBoxes(TPaths &&paths)
+    {
+        for (const ClipperLib::Path &path : paths)
+            if (! path.empty()) {
+                m_bboxes.emplace_back(path);
+                m_max_width = std::max(m_max_width, m_bboxes.back().max.x() - m_bboxes.back().min.x());
+            }
+        std::sort(m_bboxes.begin(), m_bboxes.end(), [](const BoundingBox &l, const BoundingBox &r) { return l.min.x() < r.min.x(); });
+    }
+
+    bool empty() const { return m_bboxes.empty(); }
+
+    // Touching bounding boxes are considered overlapping.
+    bool overlap(const BoundingBox &bbox) const
+    {
+        // Only the bounding boxes starting at most m_max_width left of bbox may reach it.
+        auto it = std::lower_bound(m_bboxes.begin(), m_bboxes.end(), bbox.min.x() - m_max_width,
+            [](const BoundingBox &l, coord_t x) { return l.min.x() < x; });
+        for (; it != m_bboxes.end() && it->min.x() <= bbox.max.x(); ++ it)
+            if (it->overlap(bbox))
+                return true;
+        return false;
+    }
+
+private:
+    std::vector<BoundingBox> m_bboxes;
+    coord_t                  m_max_width { 0 };
+};
+
+// Add the paths to the clipper, skipping those which do not overlap the bounding boxes of the other operand, if they cannot
+// influence the result. Only the paths overlapping the other operand interact with it, the Clipper running time grows superlinearly
+// with the number of edges, which is noticeable if a layer contains many small islands, for example on a plate with many objects.
+// Returns false if the result is known to be empty.
+template<class TSubj, class TClip>
+static bool clipper_add_overlapping_paths(ClipperLib::Clipper &clipper, const ClipperLib::ClipType clipType, TSubj &&subject, TClip &&clip)
+{
+    // Outside of the bounding boxes of a path, the winding number of the path is zero, whatever the fill type is.
+    // The result of an intersection and of a difference lies inside the subject, the result of an intersection lies inside the clip.
+    assert(clipType == ClipperLib::ctIntersection || clipType == ClipperLib::ctDifference);
+    const PathsBoundingBoxes subject_bboxes(subject);
+    if (subject_bboxes.empty())
+        return false;
+    bool              clip_added = false;
+    for (const ClipperLib::Path &path : clip)
+        if (! path.empty() && subject_bboxes.overlap(BoundingBox(path))) {
+            clipper.AddPath(path, ClipperLib::ptClip, true);
+            clip_added = true;
+        }
+    if (clipType == ClipperLib::ctIntersection) {
+        if (! clip_added)
+            return false;
+        const PathsBoundingBoxes clip_bboxes(clip);
+        for (const ClipperLib::Path &path : subject)
+            if (! path.empty() && clip_bboxes.overlap(BoundingBox(path)))
+                clipper.AddPath(path, ClipperLib::ptSubject, true);
+    } else
+        clipper.AddPaths(subject, ClipperLib::ptSubject, true);
+    return true;
+}
+
 template<class TResult, class TSubj, class TClip>
 TResult clipper_do(
     const ClipperLib::ClipType     clipType,
@@ -354,8 +432,13 @@ TResult clipper_do(
     CLIPPER_UTILS_TIME_LIMIT_MILLIS(CLIPPER_UTILS_TIME_LIMIT_DEFAULT);
 
     ClipperLib::Clipper clipper;
-    clipper.AddPaths(std::forward<TSubj>(subject), ClipperLib::ptSubject, true);
-    clipper.AddPaths(std::forward<TClip>(clip),    ClipperLib::ptClip,    true);
+    if (clipType == ClipperLib::ctIntersection || clipType == ClipperLib::ctDifference) {
+        if (! clipper_add_overlapping_paths(clipper, clipType, subject, clip))
+            return TResult();
+    } else {
+        clipper.AddPaths(std::forward<TSubj>(subject), ClipperLib::ptSubject, true);
+        clipper.AddPaths(std::forward<TClip>(clip),    ClipperLib::ptClip,    true);
+    }
     TResult retval;
     clipper.Execute(clipType, retval, fillType, fillType);
     return retval;
@@ -473,17 +556,10 @@ static int offset_expolygon_inner(const Slic3r::ExPolygon &expoly, const float d
     CLIPPER_UTILS_TIME_LIMIT_MILLIS(CLIPPER_UTILS_TIME_LIMIT_DEFAULT);
 
     // 1) Offset the outer contour.
+    ClipperLib::ClipperOffset &co = clipper_offset(delta, joinType, miterLimit);
     ClipperLib::Paths contours;
-    {
-        ClipperLib::ClipperOffset co;
-        if (joinType == jtRound)
-            co.ArcTolerance = miterLimit;
-        else
-            co.MiterLimit = miterLimit;
-        co.ShortestEdgeLength = std::abs(delta * ClipperOffsetShortestEdgeFactor);
-        co.AddPath(expoly.contour.points, joinType, ClipperLib::etClosedPolygon);
-        co.Execute(contours, delta);
-    }
+    co.AddPath(expoly.contour.points, joinType, ClipperLib::etClosedPolygon);
+    co.Execute(contours, delta);
     if (contours.empty())
         // No need to try to offset the holes.
         return 0;
@@ -496,12 +572,7 @@ static int offset_expolygon_inner(const Slic3r::ExPolygon &expoly, const float d
         ClipperLib::Paths holes;
         {
             for (const Polygon &hole : expoly.holes) {
-                ClipperLib::ClipperOffset co;
-                if (joinType == jtRound)
-                    co.ArcTolerance = miterLimit;
-                else
-                    co.MiterLimit = miterLimit;
-                co.ShortestEdgeLength = std::abs(delta * ClipperOffsetShortestEdgeFactor);
+                co.Clear();
                 co.AddPath(hole.points, joinType, ClipperLib::etClosedPolygon);
                 ClipperLib::Paths out2;
                 // Execute reorients the contours so that the outer most contour has a positive area. Thus the output
@@ -412,28 +412,43 @@ void ConfigBase::apply_only(const ConfigBase &other, const t_config_option_keys
     }
 }
 
+// Iterate over the keys of a config, call the fn. Returns true on early exit by fn().
+// Keys of a static config are cached, thus they are not copied.
+template<typename Fn>
+static inline bool config_keys_iterate(const ConfigBase &config, Fn fn)
+{
+    auto iterate = [&fn](const t_config_option_keys &keys) {
+        for (const t_config_option_key &opt_key : keys)
+            if (fn(opt_key))
+                return true;
+        return false;
+    };
+    const StaticConfig *static_config = dynamic_cast<const StaticConfig*>(&config);
+    return static_config ? iterate(static_config->keys_ref()) : iterate(config.keys());
+}
+
 // Are the two configs equal? Ignoring options not present in both configs.
 bool ConfigBase::equals(const ConfigBase &other) const
 { 
-    for (const t_config_option_key &opt_key : this->keys()) {
+    return ! config_keys_iterate(*this, [this, &other](const t_config_option_key &opt_key) {
         const ConfigOption *this_opt  = this->option(opt_key);
         const ConfigOption *other_opt = other.option(opt_key);
-        if (this_opt != nullptr && other_opt != nullptr && *this_opt != *other_opt)
-            return false;
-    }
-    return true;
+        return this_opt != nullptr && other_opt != nullptr && *this_opt != *other_opt;
+    });
 }
 
 // Returns options differing in the two configs, ignoring options not present in both configs.
 t_config_option_keys ConfigBase::diff(const ConfigBase &other) const
 {
     t_config_option_keys diff;
-    for (const t_config_option_key &opt_key : this->keys()) {
+    config_keys_iterate(*this, [this, &other, &diff](const t_config_option_key &opt_key) {
         const ConfigOption *this_opt  = this->option(opt_key);
         const ConfigOption *other_opt = other.option(opt_key);
         if (this_opt != nullptr && other_opt != nullptr && *this_opt != *other_opt)
             diff.emplace_back(opt_key);
-    }
+        // Continue iterating.
+        return false;
+    });
     return diff;
 }
 
@@ -441,12 +456,14 @@ t_config_option_keys ConfigBase::diff(const ConfigBase &other) const
 t_config_option_keys ConfigBase::equal(const ConfigBase &other) const
 {
     t_config_option_keys equal;
-    for (const t_config_option_key &opt_key : this->keys()) {
+    config_keys_iterate(*this, [this, &other, &equal](const t_config_option_key &opt_key) {
         const ConfigOption *this_opt  = this->option(opt_key);
         const ConfigOption *other_opt = other.option(opt_key);
         if (this_opt != nullptr && other_opt != nullptr && *this_opt == *other_opt)
             equal.emplace_back(opt_key);
-    }
+        // Continue iterating.
+        return false;
+    });
     return equal;
 }
 
@@ -1056,8 +1073,9 @@ void ConfigBase::null_nullables()
 
 DynamicConfig::DynamicConfig(const ConfigBase& rhs, const t_config_option_keys& keys)
 {
+    this->options.reserve(keys.size());
 	for (const t_config_option_key& opt_key : keys)
-		this->options[opt_key] = std::unique_ptr<ConfigOption>(rhs.option(opt_key)->clone());
+		this->option_slot(opt_key).reset(rhs.option(opt_key)->clone());
 }
 
 bool DynamicConfig::operator==(const DynamicConfig &rhs) const
@@ -1076,20 +1094,16 @@ bool DynamicConfig::operator==(const DynamicConfig &rhs) const
 // Remove options with all nil values, those are optional and it does not help to hold them.
 size_t DynamicConfig::remove_nil_options()
 {
-	size_t cnt_removed = 0;
-	for (auto it = options.begin(); it != options.end();)
-		if (it->second->is_nil()) {
-			it = options.erase(it);
-			++ cnt_removed;
-		} else
-			++ it;
+	auto   it          = std::remove_if(options.begin(), options.end(), [](const auto &kvp) { return kvp.second->is_nil(); });
+	size_t cnt_removed = options.end() - it;
+	options.erase(it, options.end());
 	return cnt_removed;
 }
 
 ConfigOption* DynamicConfig::optptr(const t_config_option_key &opt_key, bool create)
 {
-    auto it = options.find(opt_key);
-    if (it != options.end())
+    auto it = this->lower_bound_option(opt_key);
+    if (it != options.end() && it->first == opt_key)
         // Option was found.
         return it->second.get();
     if (! create)
@@ -1105,13 +1119,13 @@ ConfigOption* DynamicConfig::optptr(const t_config_option_key &opt_key, bool cre
         // Let the parent decide what to do if the opt_key is not defined by this->def().
         return nullptr;
     ConfigOption *opt = optdef->create_default_option();
-    this->options.emplace_hint(it, opt_key, std::unique_ptr<ConfigOption>(opt));
+    this->options.emplace(it, opt_key, std::unique_ptr<ConfigOption>(opt));
     return opt;
 }
 
 const ConfigOption* DynamicConfig::optptr(const t_config_option_key &opt_key) const
 {
-    auto it = options.find(opt_key);
+    auto it = this->find_option(opt_key);
     return (it == options.end()) ? nullptr : it->second.get();
 }
 
@@ -1153,8 +1167,8 @@ t_config_option_keys StaticConfig::keys() const
 template<typename Fn>
 static inline bool dynamic_config_iterate(const DynamicConfig &lhs, const DynamicConfig &rhs, Fn fn)
 {
-    std::map<t_config_option_key, std::unique_ptr<ConfigOption>>::const_iterator i = lhs.cbegin();
-    std::map<t_config_option_key, std::unique_ptr<ConfigOption>>::const_iterator j = rhs.cbegin();
+    DynamicConfig::OptionStorage::const_iterator i = lhs.cbegin();
+    DynamicConfig::OptionStorage::const_iterator j = rhs.cbegin();
     while (i != lhs.cend() && j != rhs.cend())
         if (i->first < j->first)
             ++ i;
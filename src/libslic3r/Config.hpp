@@ -2782,8 +2782,9 @@ public:
     {
         assert(this->def() == nullptr || this->def() == rhs.def());
         this->clear();
+        this->options.reserve(rhs.options.size());
         for (const auto &kvp : rhs.options)
-            this->options[kvp.first].reset(kvp.second->clone());
+            this->options.emplace_back(kvp.first, kvp.second->clone());
         return *this;
     }
 
@@ -2804,15 +2805,15 @@ public:
     {
         assert(this->def() == nullptr || this->def() == rhs.def());
         for (const auto &kvp : rhs.options) {
-            auto it = this->options.find(kvp.first);
-            if (it == this->options.end())
-                this->options[kvp.first].reset(kvp.second->clone());
+            std::unique_ptr<ConfigOption> &opt = this->option_slot(kvp.first);
+            if (! opt)
+                opt.reset(kvp.second->clone());
             else {
-                assert(it->second->type() == kvp.second->type());
-                if (it->second->type() == kvp.second->type())
-                    *it->second = *kvp.second;
+                assert(opt->type() == kvp.second->type());
+                if (opt->type() == kvp.second->type())
+                    *opt = *kvp.second;
                 else
-                    it->second.reset(kvp.second->clone());
+                    opt.reset(kvp.second->clone());
             }
         }
         return *this;
@@ -2824,13 +2825,9 @@ public:
     {
         assert(this->def() == nullptr || this->def() == rhs.def());
         for (auto &kvp : rhs.options) {
-            auto it = this->options.find(kvp.first);
-            if (it == this->options.end()) {
-                this->options.insert(std::make_pair(kvp.first, std::move(kvp.second)));
-            } else {
-                assert(it->second->type() == kvp.second->type());
-                it->second = std::move(kvp.second);
-            }
+            std::unique_ptr<ConfigOption> &opt = this->option_slot(kvp.first);
+            assert(! opt || opt->type() == kvp.second->type());
+            opt = std::move(kvp.second);
         }
         rhs.options.clear();
         return *this;
@@ -2851,7 +2848,7 @@ public:
 
     bool erase(const t_config_option_key &opt_key)
     { 
-        auto it = this->options.find(opt_key);
+        auto it = this->find_option(opt_key);
         if (it == this->options.end())
             return false;
         this->options.erase(it);
@@ -2877,14 +2874,10 @@ public:
     // Be careful, as this method does not test the existence of opt_key in this->def().
     bool                    set_key_value(const std::string &opt_key, ConfigOption *opt)
     {
-        auto it = this->options.find(opt_key);
-        if (it == this->options.end()) {
-            this->options[opt_key].reset(opt);
-            return true;
-        } else {
-            it->second.reset(opt);
-            return false;
-        }
+        std::unique_ptr<ConfigOption> &slot = this->option_slot(opt_key);
+        bool                           added = ! slot;
+        slot.reset(opt);
+        return added;
     }
 
     // Are the two configs equal? Ignoring options not present in both configs.
@@ -2894,12 +2887,38 @@ public:
     // Returns options being equal in the two configs, ignoring options not present in both configs.
     t_config_option_keys equal(const DynamicConfig &other) const;
 
-    std::map<t_config_option_key, std::unique_ptr<ConfigOption>>::const_iterator cbegin() const { return options.cbegin(); }
-    std::map<t_config_option_key, std::unique_ptr<ConfigOption>>::const_iterator cend()   const { return options.cend(); }
-    size_t                        												 size()   const { return options.size(); }
+    // Options sorted by their keys.
+    using OptionStorage = std::vector<std::pair<t_config_option_key, std::unique_ptr<ConfigOption>>>;
+    OptionStorage::const_iterator cbegin() const { return options.cbegin(); }
+    OptionStorage::const_iterator cend()   const { return options.cend(); }
+    size_t                        size()   const { return options.size(); }
 
 private:
-    std::map<t_config_option_key, std::unique_ptr<ConfigOption>> options;
+    OptionStorage::iterator       lower_bound_option(const t_config_option_key &opt_key)
+        { return std::lower_bound(options.begin(), options.end(), opt_key, [](const auto &kvp, const t_config_option_key &key) { return kvp.first < key; }); }
+    OptionStorage::const_iterator lower_bound_option(const t_config_option_key &opt_key) const
+        { return std::lower_bound(options.begin(), options.end(), opt_key, [](const auto &kvp, const t_config_option_key &key) { return kvp.first < key; }); }
+    OptionStorage::iterator       find_option(const t_config_option_key &opt_key)
+        { auto it = this->lower_bound_option(opt_key); return (it != options.end() && it->first == opt_key) ? it : options.end(); }
+    OptionStorage::const_iterator find_option(const t_config_option_key &opt_key) const
+        { auto it = this->lower_bound_option(opt_key); return (it != options.end() && it->first == opt_key) ? it : options.end(); }
+    // Find the option of a given key, insert an empty slot if it does not exist yet.
+    std::unique_ptr<ConfigOption>& option_slot(const t_config_option_key &opt_key)
+    {
+        // Keys inserted in ascending order, for example when copying from another config, are just appended.
+        if (options.empty() || options.back().first < opt_key) {
+            options.emplace_back(opt_key, nullptr);
+            return options.back().second;
+        }
+        auto it = this->lower_bound_option(opt_key);
+        if (it == options.end() || it->first != opt_key)
+            it = options.emplace(it, opt_key, nullptr);
+        return it->second;
+    }
+
+    // A vector sorted by the keys instead of a std::map: The lookups by binary search are cache friendly,
+    // a copy of a config does not allocate a tree node per option.
+    OptionStorage options;
 
 	friend class cereal::access;
 	template<class Archive> void serialize(Archive &ar) { ar(options); }
@@ -2915,6 +2934,8 @@ public:
     /// Gets list of config option names for each config option of this->def, which has a static counter-part defined by the derived object
     /// and which could be resolved by this->optptr(key) call.
     t_config_option_keys keys() const;
+    // Reference to the cached list of keys.
+    virtual const t_config_option_keys& keys_ref() const = 0;
 
 protected:
     /// Set all statically defined config options to their defaults defined by this->def().
@@ -19,6 +19,9 @@
 #include "libslic3r/ExPolygon.hpp"
 #include "libslic3r/Point.hpp"
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
 // #define EDGE_GRID_DEBUG_OUTPUT
 
 #if 0
@@ -142,6 +145,11 @@ void EdgeGrid::Grid::create(const ExPolygons &expolygons, coord_t resolution)
 }
 
 // m_contours has been initialized. Now fill in the edge grid.
+// Below this number of line segments, the grid is rasterized serially, as the grids of small contours are often created
+// for each layer inside an already parallel loop.
+static constexpr size_t parallel_rasterization_threshold = 16384;
+static constexpr size_t parallel_rasterization_chunk     = 4096;
+
 void EdgeGrid::Grid::create_from_m_contours(coord_t resolution)
 {
 	assert(resolution > 0);
@@ -165,6 +173,14 @@ void EdgeGrid::Grid::create_from_m_contours(coord_t resolution)
 	m_rows = (m_bbox.max(1) - m_bbox.min(1) + m_resolution - 1) / m_resolution;
 	m_cells.assign(m_rows * m_cols, Cell());
 
+	size_t num_segments = 0;
+	for (const Contour &contour : m_contours)
+		num_segments += contour.num_segments();
+	if (num_segments >= parallel_rasterization_threshold) {
+		this->rasterize_m_contours_parallel(num_segments);
+		return;
+	}
+
 	// 3) First round of contour rasterization, count the edges per grid cell.
 	for (size_t i = 0; i < m_contours.size(); ++ i) {
 		const Contour &contour = m_contours[i];
@@ -336,6 +352,63 @@ void EdgeGrid::Grid::create_from_m_contours(coord_t resolution)
 	}
 }
 
+void EdgeGrid::Grid::rasterize_m_contours_parallel(size_t num_segments)
+{
+	// Index of the first line segment of each contour in the sequence of line segments of all the contours.
+	std::vector<size_t> contour_begin(m_contours.size() + 1, 0);
+	for (size_t i = 0; i < m_contours.size(); ++ i)
+		contour_begin[i + 1] = contour_begin[i] + m_contours[i].num_segments();
+
+	// 1) Rasterize the chunks of line segments in parallel, collect the cells hit by each line segment.
+	struct Hit {
+		size_t cell;
+		size_t contour;
+		size_t segment;
+	};
+	std::vector<std::vector<Hit>> hits((num_segments + parallel_rasterization_chunk - 1) / parallel_rasterization_chunk);
+	tbb::parallel_for(tbb::blocked_range<size_t>(0, hits.size(), 1), [this, num_segments, &contour_begin, &hits](const tbb::blocked_range<size_t> &range) {
+		for (size_t ichunk = range.begin(); ichunk < range.end(); ++ ichunk) {
+			size_t begin = ichunk * parallel_rasterization_chunk;
+			size_t end   = std::min(begin + parallel_rasterization_chunk, num_segments);
+			size_t i     = std::upper_bound(contour_begin.begin(), contour_begin.end(), begin) - contour_begin.begin() - 1;
+			std::vector<Hit> &out = hits[ichunk];
+			out.reserve(end - begin);
+			for (size_t k = begin; k < end; ++ k) {
+				while (k >= contour_begin[i + 1])
+					++ i;
+				const Contour &contour = m_contours[i];
+				const size_t   j       = k - contour_begin[i];
+				auto visitor = [this, &out, i, j](coord_t iy, coord_t ix) {
+					out.push_back({ iy * m_cols + ix, i, j });
+					// Continue traversing the grid along the edge.
+					return true;
+				};
+				this->visit_cells_intersecting_line(contour.segment_start(j), contour.segment_end(j), visitor);
+			}
+		}
+	});
+
+	// 2) Count the edges per grid cell, prefix sum the numbers of hits per cells to get an index into m_cell_data.
+	for (const std::vector<Hit> &chunk : hits)
+		for (const Hit &hit : chunk)
+			++ m_cells[hit.cell].end;
+	size_t cnt = m_cells.front().end;
+	for (size_t i = 1; i < m_cells.size(); ++ i) {
+		m_cells[i].begin = cnt;
+		cnt += m_cells[i].end;
+		m_cells[i].end = cnt;
+	}
+
+	// 3) Fill in m_cell_data in the order of the chunks, thus the edges of a cell are ordered by their contours and line segments
+	// the same way as if rasterized serially.
+	m_cell_data.assign(cnt, std::pair<size_t, size_t>(size_t(-1), size_t(-1)));
+	for (Cell &cell : m_cells)
+		cell.end = cell.begin;
+	for (const std::vector<Hit> &chunk : hits)
+		for (const Hit &hit : chunk)
+			m_cell_data[m_cells[hit.cell].end ++] = std::make_pair(hit.contour, hit.segment);
+}
+
 #if 0
 // Divide, round to a grid coordinate.
 // Divide x/y, round down. y is expected to be positive.
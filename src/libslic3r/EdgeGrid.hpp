@@ -382,6 +382,8 @@ protected:
 	};
 
 	void create_from_m_contours(coord_t resolution);
+	// Rasterize m_contours into the allocated m_cells by chunks of line segments in parallel, to be used for large inputs.
+	void rasterize_m_contours_parallel(size_t num_segments);
 #if 0
 	bool line_cell_intersect(const Point &p1, const Point &p2, const Cell &cell);
 #endif
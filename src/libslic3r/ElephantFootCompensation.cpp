@@ -22,6 +22,9 @@
 #include "libslic3r/Point.hpp"
 #include "libslic3r/Polygon.hpp"
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
 // #define CONTOUR_DISTANCE_DEBUG_SVG
 
 namespace Slic3r {
@@ -389,27 +392,38 @@ std::vector<float> contour_distance2(const EdgeGrid::Grid &grid, const size_t id
                 Vec2d        v       = (pt_next - pt_this).cast<double>();
                 return cross2(v, pt - pt_this.cast<double>()) > 0.;
             }
-		} visitor(grid, idx_contour, resampled_point_parameters, 0.5 * compensation * M_PI, search_radius);
+		};
 
-		out.reserve(contour.size());
+		out.assign(contour.size(), 0.f);
 		Point radius_vector(search_radius, search_radius);
-		for (const Point &pt : contour) {
-			visitor.init(contour, pt);
-			grid.visit_cells_intersecting_box(BoundingBox(pt - radius_vector, pt + radius_vector), visitor);
-			out.emplace_back(float(visitor.found ? std::min(visitor.distance, search_radius) : search_radius));
-
-#if 0
-//#ifdef CONTOUR_DISTANCE_DEBUG_SVG
-			if (out.back() < search_radius) {
-				SVG svg(debug_out_path("contour_distance_filtered-%d-%d.svg", iRun, int(&pt - contour.data())).c_str(), bbox);
-				svg.draw(expoly_grid);
-				svg.draw_outline(Polygon(contour), "blue", scale_(0.01));
-				svg.draw(pt, "green", coord_t(scale_(0.1)));
-				svg.draw(visitor.closest_point, "red", coord_t(scale_(0.1)));
-				printf("contour_distance_filtered-%d-%d.svg - distance %lf\n", iRun, int(&pt - contour.data()), unscale<double>(out.back()));
+		// The distances of the contour points are independent, evaluate them in parallel for long contours.
+		auto contour_distance_range = [&](size_t begin, size_t end) {
+			Visitor visitor(grid, idx_contour, resampled_point_parameters, 0.5 * compensation * M_PI, search_radius);
+			for (size_t idx_point = begin; idx_point < end; ++ idx_point) {
+				const Point &pt = contour[idx_point];
+				visitor.init(contour, pt);
+				grid.visit_cells_intersecting_box(BoundingBox(pt - radius_vector, pt + radius_vector), visitor);
+				out[idx_point] = float(visitor.found ? std::min(visitor.distance, search_radius) : search_radius);
+	
+	#if 0
+	//#ifdef CONTOUR_DISTANCE_DEBUG_SVG
+				if (out[idx_point] < search_radius) {
+					SVG svg(debug_out_path("contour_distance_filtered-%d-%d.svg", iRun, int(&pt - contour.data())).c_str(), bbox);
+					svg.draw(expoly_grid);
+					svg.draw_outline(Polygon(contour), "blue", scale_(0.01));
+					svg.draw(pt, "green", coord_t(scale_(0.1)));
+					svg.draw(visitor.closest_point, "red", coord_t(scale_(0.1)));
+					printf("contour_distance_filtered-%d-%d.svg - distance %lf\n", iRun, int(&pt - contour.data()), unscale<double>(out[idx_point]));
+				}
+	#endif /* CONTOUR_DISTANCE_DEBUG_SVG */
 			}
-#endif /* CONTOUR_DISTANCE_DEBUG_SVG */
-		}
+		};
+		if (contour.size() >= 4096)
+			tbb::parallel_for(tbb::blocked_range<size_t>(0, contour.size(), 1024), [&contour_distance_range](const tbb::blocked_range<size_t> &range) {
+				contour_distance_range(range.begin(), range.end());
+			});
+		else
+			contour_distance_range(0, contour.size());
 #ifdef CONTOUR_DISTANCE_DEBUG_SVG
 		if (out.back() < search_radius) {
 			SVG svg(debug_out_path("contour_distance_filtered-final-%d.svg", iRun).c_str(), bbox);
@@ -427,9 +441,13 @@ std::vector<float> contour_distance2(const EdgeGrid::Grid &grid, const size_t id
 Points resample_polygon(const Points &contour, double dist, std::vector<ResampledPoint> &resampled_point_parameters)
 {
 	Points out;
-	out.reserve(contour.size());
-	resampled_point_parameters.reserve(contour.size());
     if (contour.size() > 2) {
+		// Count the resampled points first to allocate the output at once.
+		size_t num_points = 0;
+		for (size_t i = 0, j = contour.size() - 1; i < contour.size(); j = i ++)
+			num_points += std::max<size_t>(1, size_t(ceil((contour[i] - contour[j]).cast<double>().norm() / dist)));
+		out.reserve(num_points);
+		resampled_point_parameters.reserve(num_points);
     	Vec2d  pt_prev  = contour.back().cast<double>();
     	for (const Point &pt : contour) {
 			size_t idx_this = &pt - contour.data();
@@ -638,20 +656,31 @@ ExPolygon  elephant_foot_compensation(const ExPolygon  &input, const Flow &exter
 
 ExPolygons elephant_foot_compensation(const ExPolygons &input, const Flow &external_perimeter_flow, const double compensation)
 {
-	ExPolygons out;
-	out.reserve(input.size());
-	for (const ExPolygon &expoly : input)
-		out.emplace_back(elephant_foot_compensation(expoly, external_perimeter_flow, compensation));
-	return out;
+    double min_contour_width = double(external_perimeter_flow.width() + external_perimeter_flow.spacing());
+    return elephant_foot_compensation(input, min_contour_width, compensation);
 }
 
 ExPolygons elephant_foot_compensation(const ExPolygons &input, double min_contour_width, const double compensation)
 {
-	ExPolygons out;
-	out.reserve(input.size());
-	for (const ExPolygon &expoly : input)
-		out.emplace_back(elephant_foot_compensation(expoly, min_contour_width, compensation));
+	// The ExPolygons are compensated independently.
+	ExPolygons out(input.size());
+	tbb::parallel_for(tbb::blocked_range<size_t>(0, input.size(), 1), [&input, &out, min_contour_width, compensation](const tbb::blocked_range<size_t> &range) {
+		for (size_t i = range.begin(); i < range.end(); ++ i)
+			out[i] = elephant_foot_compensation(input[i], min_contour_width, compensation);
+	});
 	return out;
 }
 
+ExPolygons ElephantFootCompensationCache::compensate(const ExPolygons &input, const Flow &external_perimeter_flow, const double compensation)
+{
+    double min_contour_width = double(external_perimeter_flow.width() + external_perimeter_flow.spacing());
+    if (min_contour_width != m_min_contour_width || compensation != m_compensation || input != m_input) {
+        m_output            = elephant_foot_compensation(input, min_contour_width, compensation);
+        m_input             = input;
+        m_min_contour_width = min_contour_width;
+        m_compensation      = compensation;
+    }
+    return m_output;
+}
+
 } // namespace Slic3r
@@ -19,6 +19,22 @@ ExPolygons elephant_foot_compensation(const ExPolygons &input, double min_counto
 ExPolygon  elephant_foot_compensation(const ExPolygon  &input, const Flow &external_perimeter_flow, const double compensation);
 ExPolygons elephant_foot_compensation(const ExPolygons &input, const Flow &external_perimeter_flow, const double compensation);
 
+// Caches the Elephant foot compensation of the 1st layer of a PrintObject. The compensation is calculated again
+// with each posSlice, though the 1st layer slices often did not change, for example if only unrelated region settings changed.
+class ElephantFootCompensationCache
+{
+public:
+    ExPolygons  compensate(const ExPolygons &input, const Flow &external_perimeter_flow, const double compensation);
+    void        clear() { *this = ElephantFootCompensationCache(); }
+
+private:
+    // Input of the last compensation, compared exactly.
+    ExPolygons  m_input;
+    double      m_min_contour_width { 0. };
+    double      m_compensation      { 0. };
+    ExPolygons  m_output;
+};
+
 } // Slic3r
 
 #endif /* slic3r_ElephantFootCompensation_hpp_ */
@@ -1657,6 +1657,30 @@ indexed_triangle_set Emboss::polygons2model(const ExPolygons &shape2d,
         polygons2model_duplicit(shape2d, projection, points, duplicits);
 }
 
+indexed_triangle_set Emboss::glyph2model(const ExPolygons &glyph_shape, int unicode, double depth, const Transform3d &tr, GlyphMeshes &cache)
+{
+    if (glyph_shape.empty())
+        return {};
+
+    // move glyph to origin to be able reuse mesh on other place of text
+    Point origin = get_extents(glyph_shape).min;
+    ExPolygons shape = glyph_shape; // copy
+    translate(shape, -origin);
+
+    GlyphMesh &glyph_mesh = cache[unicode];
+    if (glyph_mesh.depth != depth || glyph_mesh.shape != shape) {
+        glyph_mesh.its   = polygons2model(shape, ProjectZ(depth));
+        glyph_mesh.shape = std::move(shape);
+        glyph_mesh.depth = depth;
+    }
+
+    indexed_triangle_set result = glyph_mesh.its; // copy
+    Transform3d tr_from_origin = tr * Eigen::Translation<double, 3>(origin.x(), origin.y(), 0.);
+    for (Vec3f &v : result.vertices)
+        v = (tr_from_origin * v.cast<double>()).cast<float>();
+    return result;
+}
+
 std::pair<Vec3d, Vec3d> Emboss::ProjectZ::create_front_back(const Point &p) const
 {
     Vec3d front(p.x(), p.y(), 0.);
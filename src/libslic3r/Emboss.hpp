@@ -70,6 +70,20 @@ namespace Emboss
     };
     // cache for glyph by unicode
     using Glyphs = std::map<int, Glyph>;
+
+    // mesh of one glyph extruded along Z axis
+    struct GlyphMesh
+    {
+        // Shape of glyph moved to have minimum of its bounding box in origin.
+        // Mesh is reused only for the same shape, because the font properties could change.
+        ExPolygons shape;
+        double depth = 0.;
+
+        // NOTE: not transformed, in shape coordinates
+        indexed_triangle_set its;
+    };
+    // cache for extruded glyph by unicode
+    using GlyphMeshes = std::map<int, GlyphMesh>;
         
     /// <summary>
     /// keep information from file about font 
@@ -129,10 +143,15 @@ namespace Emboss
         // main thread only clear cache by set to another shared_ptr
         std::shared_ptr<Emboss::Glyphs> cache;
 
+        // Cache for meshes of glyphs embossed per glyph
+        // IMPORTANT: accessible only in plater job thread !!!
+        std::shared_ptr<Emboss::GlyphMeshes> mesh_cache;
+
         FontFileWithCache() : font_file(nullptr), cache(nullptr) {}
         explicit FontFileWithCache(std::unique_ptr<FontFile> font_file)
             : font_file(std::move(font_file))
             , cache(std::make_shared<Emboss::Glyphs>())
+            , mesh_cache(std::make_shared<Emboss::GlyphMeshes>())
         {}
         bool has_value() const { return font_file != nullptr && cache != nullptr; }
     };
@@ -321,6 +340,18 @@ namespace Emboss
     /// <param name="projection">Define transformation from 2d to 3d(orientation, position, scale, ...)</param>
     /// <returns>Projected shape into space</returns>
     indexed_triangle_set polygons2model(const ExPolygons &shape2d, const IProjection& projection);
+
+    /// <summary>
+    /// Create triangle model of one glyph extruded along Z axis
+    /// Glyphs of the same shape (up to translation) and depth are extruded only once and instanced from cache
+    /// </summary>
+    /// <param name="glyph_shape">Shape of glyph on its place in text</param>
+    /// <param name="unicode">Key to cache</param>
+    /// <param name="depth">Depth of extrusion in shape scale, same as ProjectZ</param>
+    /// <param name="tr">Transformation of extruded glyph</param>
+    /// <param name="cache">In/Out cache of glyph meshes</param>
+    /// <returns>Transformed glyph model, same as polygons2model with ProjectTransform(ProjectZ(depth), tr)</returns>
+    indexed_triangle_set glyph2model(const ExPolygons &glyph_shape, int unicode, double depth, const Transform3d &tr, GlyphMeshes &cache);
     
     /// <summary>
     /// Suggest wanted up vector of embossed text by emboss direction
@@ -12,10 +12,13 @@
 ///|/
 #include <ankerl/unordered_dense.h>
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <cmath>
 #include <limits>
 #include <cstring>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
 
 #include "BoundingBox.hpp"
 #include "ExPolygon.hpp"
@@ -224,10 +227,58 @@ void ExPolygon::simplify(double tolerance, ExPolygons* expolygons) const
     append(*expolygons, this->simplify(tolerance));
 }
 
+// Medial axis of a rectangle without holes, which is the segment connecting the centers of its short sides,
+// as it would be produced by the Voronoi based extraction below including the extension of its endpoints.
+// Returns false if the expolygon is not a rectangle up to SCALED_EPSILON.
+static bool rectangle_medial_axis(const ExPolygon &expolygon, double min_width, double max_width, ThickPolylines *polylines)
+{
+    const Points &pts = expolygon.contour.points;
+    if (! expolygon.holes.empty() || pts.size() != 4)
+        return false;
+
+    std::array<Vec2d, 4>  edges;
+    std::array<double, 4> lengths;
+    for (size_t i = 0; i < 4; ++ i) {
+        edges[i]   = (pts[(i + 1) % 4] - pts[i]).cast<double>();
+        lengths[i] = edges[i].norm();
+        if (lengths[i] < SCALED_EPSILON)
+            return false;
+    }
+    for (size_t i = 0; i < 4; ++ i)
+        if (std::abs(edges[i].dot(edges[(i + 1) % 4])) > SCALED_EPSILON * lengths[i])
+            return false;
+
+    // The short sides are the ends of the medial axis.
+    size_t first = lengths[0] + lengths[2] <= lengths[1] + lengths[3] ? 0 : 1;
+    size_t last  = first + 2;
+    double w0    = lengths[first];
+    double w1    = lengths[last];
+    if ((w0 < min_width && w1 < min_width) || (w0 > max_width && w1 > max_width))
+        // Too thin or too thick along its whole length.
+        return true;
+
+    auto center = [&pts](size_t i) { return Point((pts[i].x() + pts[(i + 1) % 4].x()) / 2, (pts[i].y() + pts[(i + 1) % 4].y()) / 2); };
+    ThickPolyline polyline;
+    polyline.points    = { center(first), center(last) };
+    polyline.width     = { w0, w1 };
+    polyline.endpoints = { true, true };
+    // Too short polylines are removed the same way as below.
+    if (polyline.length() >= 2. * std::max(w0, w1))
+        polylines->emplace_back(std::move(polyline));
+    return true;
+}
+
 void ExPolygon::medial_axis(double min_width, double max_width, ThickPolylines* polylines) const
 {
+    if (rectangle_medial_axis(*this, min_width, max_width, polylines))
+        return;
+
+    // Voronoi diagram shared by the medial axis extractions running on the same thread, thus by the thin walls
+    // and the gap fill of a layer region. Reusing it recycles its storage instead of allocating it for each expolygon.
+    thread_local Slic3r::Geometry::VoronoiDiagram vd;
+
     // init helper object
-    Slic3r::Geometry::MedialAxis ma(min_width, max_width, *this);
+    Slic3r::Geometry::MedialAxis ma(min_width, max_width, *this, &vd);
     
     // compute the Voronoi diagram and extract medial axis polylines
     ThickPolylines pp;
@@ -334,6 +385,22 @@ void ExPolygon::medial_axis(double min_width, double max_width, ThickPolylines*
     polylines->insert(polylines->end(), pp.begin(), pp.end());
 }
 
+void medial_axis(const ExPolygons &expolygons, double min_width, double max_width, ThickPolylines *polylines)
+{
+    if (expolygons.size() == 1) {
+        expolygons.front().medial_axis(min_width, max_width, polylines);
+        return;
+    }
+    std::vector<ThickPolylines> per_expolygon(expolygons.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, expolygons.size(), 1),
+        [&expolygons, &per_expolygon, min_width, max_width](const tbb::blocked_range<size_t> &range) {
+            for (size_t i = range.begin(); i < range.end(); ++ i)
+                expolygons[i].medial_axis(min_width, max_width, &per_expolygon[i]);
+        });
+    for (ThickPolylines &pp : per_expolygon)
+        append(*polylines, std::move(pp));
+}
+
 void ExPolygon::medial_axis(double min_width, double max_width, Polylines* polylines) const
 {
     ThickPolylines tp;
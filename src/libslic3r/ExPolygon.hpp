@@ -35,7 +35,7 @@ namespace Slic3r {
 
 class ExPolygon;
 
-using ExPolygons = std::vector<ExPolygon>;
+using ExPolygons = std::vector<ExPolygon, PointsAllocator<ExPolygon>>;
 
 class ExPolygon
 {
@@ -495,6 +495,10 @@ bool has_duplicate_points(const ExPolygons &expolys);
 bool remove_same_neighbor(ExPolygons &expolys);
 
 bool remove_sticks(ExPolygon &poly);
+
+// Medial axis of each expolygon, the expolygons are processed in parallel.
+// The polylines are appended in the order of the expolygons.
+void medial_axis(const ExPolygons &expolygons, double min_width, double max_width, ThickPolylines *polylines);
 void keep_largest_contour_only(ExPolygons &polygons);
 
 inline double      area(const ExPolygon &poly) { return poly.area(); }
@@ -129,6 +129,67 @@ T accumulate(const EP &ep,
         std::max(granularity, size_t(1)));
 }
 
+// An inclusive prefix scan with the execution policy passed as argument.
+// Writes merge(init, access(from), ..., access(i)) into out[i - from] for
+// each integral index i in [from, to) and returns the total. mergefn has to
+// be associative and has T(const T&, const T&) signature, accessfn has T(I)
+// signature. The output is the same for all execution policies.
+template<class EP,
+         class I,
+         class OutIt,
+         class MergeFn,
+         class T,
+         class AccessFn,
+         class = ExecutionPolicyOnly<EP> >
+IntegerOnly<I, T> scan(const EP & ep,
+                       I          from,
+                       I          to,
+                       OutIt      out,
+                       const T &  init,
+                       MergeFn && mergefn,
+                       AccessFn &&accessfn,
+                       size_t     granularity = 1)
+{
+    return AsTraits<EP>::scan(ep, from, to, out, init,
+                              std::forward<MergeFn>(mergefn),
+                              std::forward<AccessFn>(accessfn),
+                              std::max(granularity, size_t(1)));
+}
+
+// Run independent tasks with the execution policy passed as argument and
+// wait for all of them to finish. Tasks of a dependency graph may be
+// expressed by nesting invoke() calls or by calling invoke() consecutively.
+template<class EP, class... Fns, class = ExecutionPolicyOnly<EP>>
+void invoke(const EP &ep, Fns &&...fns)
+{
+    AsTraits<EP>::invoke(ep, std::forward<Fns>(fns)...);
+}
+
+// A two stage pipeline with the execution policy passed as argument.
+// transformfn has R(I) signature if I is an integral type and
+// R(I::value_type &) if I is an iterator type, its results are passed to
+// consumefn with void(R&&) signature. The transformations may run
+// concurrently, while consumefn is always called serially in the order of
+// the input. At most max_tokens items are in flight, zero means twice the
+// max_concurrency().
+template<class EP,
+         class I,
+         class TransformFn,
+         class ConsumeFn,
+         class = ExecutionPolicyOnly<EP> >
+void pipeline(const EP &    ep,
+              I             from,
+              I             to,
+              TransformFn &&transformfn,
+              ConsumeFn &&  consumefn,
+              size_t        max_tokens = 0)
+{
+    AsTraits<EP>::pipeline(ep, from, to,
+                           std::forward<TransformFn>(transformfn),
+                           std::forward<ConsumeFn>(consumefn),
+                           max_tokens > 0 ? max_tokens : 2 * max_concurrency(ep));
+}
+
 } // namespace execution_policy
 } // namespace Slic3r
 
@@ -80,6 +80,39 @@ public:
         return acc;
     }
 
+    template<class I, class OutIt, class MergeFn, class T, class AccessFn>
+    static T scan(const EP &,
+                  I          from,
+                  I          to,
+                  OutIt      out,
+                  const T &  init,
+                  MergeFn  &&mergefn,
+                  AccessFn &&access,
+                  size_t   /*granularity*/ = 1
+                  )
+    {
+        T acc = init;
+        loop_(from, to, [&](I i) { acc = mergefn(acc, access(i)); out[i - from] = acc; });
+        return acc;
+    }
+
+    template<class... Fns>
+    static void invoke(const EP &, Fns &&...fns)
+    {
+        (fns(), ...);
+    }
+
+    template<class I, class TransformFn, class ConsumeFn>
+    static void pipeline(const EP &,
+                         I              from,
+                         I              to,
+                         TransformFn  &&transformfn,
+                         ConsumeFn    &&consumefn,
+                         size_t       /*max_tokens*/)
+    {
+        loop_(from, to, [&](auto &i) { consumefn(transformfn(i)); });
+    }
+
     static size_t max_concurrency(const EP &) { return 1; }
 };
 
@@ -6,12 +6,26 @@
 #define EXECUTIONTBB_HPP
 
 #include <mutex>
+#include <optional>
+#include <iterator>
 
 #include <tbb/spin_mutex.h>
 #include <tbb/parallel_for.h>
+#include <tbb/parallel_invoke.h>
 #include <tbb/parallel_reduce.h>
+#include <tbb/parallel_scan.h>
 #include <tbb/task_arena.h>
 
+// See GCode.cpp, the pipeline interface differs between TBB 2017 and oneTBB.
+#if ! defined(TBB_VERSION_MAJOR)
+    #include <tbb/version.h>
+#endif
+#if TBB_VERSION_MAJOR >= 2021
+    #include <tbb/parallel_pipeline.h>
+#else
+    #include <tbb/pipeline.h>
+#endif
+
 #include "Execution.hpp"
 
 namespace Slic3r {
@@ -37,6 +51,18 @@ private:
         for (I i = range.begin(); i < range.end(); ++i) fn(i);
     }
 
+    template<class I>
+    static IntegerOnly<I, I> item_(I i) { return i; }
+
+    template<class It>
+    static IteratorOnly<It, typename std::iterator_traits<It>::reference> item_(It it) { return *it; }
+
+#if TBB_VERSION_MAJOR >= 2021
+    using FilterMode = tbb::filter_mode;
+#else
+    using FilterMode = tbb::filter;
+#endif
+
 public:
     using SpinningMutex = tbb::spin_mutex;
     using BlockingMutex = std::mutex;
@@ -71,6 +97,81 @@ public:
             std::forward<MergeFn>(mergefn));
     }
 
+    template<class I, class OutIt, class MergeFn, class T, class AccessFn>
+    static T scan(const ExecutionTBB &,
+                  I          from,
+                  I          to,
+                  OutIt      out,
+                  const T   &init,
+                  MergeFn  &&mergefn,
+                  AccessFn &&accessfn,
+                  size_t     granularity = 1
+                  )
+    {
+        if (from >= to)
+            return init;
+
+        // A merge function does not provide its identity, an empty partial sum stands for it.
+        // init is merged with the first item only, thus it is not accumulated by the partial sums.
+        using Sum = std::optional<T>;
+        const Sum total = tbb::parallel_scan(
+            tbb::blocked_range{from, to, granularity}, Sum{},
+            [&](const tbb::blocked_range<I> &range, Sum sum, bool is_final) {
+                for (I i = range.begin(); i < range.end(); ++i) {
+                    if (sum)
+                        sum = mergefn(*sum, accessfn(i));
+                    else if (i == from)
+                        sum = mergefn(init, accessfn(i));
+                    else
+                        sum = accessfn(i);
+                    if (is_final)
+                        out[i - from] = *sum;
+                }
+                return sum;
+            },
+            [&mergefn](const Sum &left, const Sum &right) {
+                return ! left ? right : ! right ? left : Sum{mergefn(*left, *right)};
+            });
+        return *total;
+    }
+
+    template<class... Fns>
+    static void invoke(const ExecutionTBB &, Fns &&...fns)
+    {
+        if constexpr (sizeof...(Fns) > 1)
+            tbb::parallel_invoke(std::forward<Fns>(fns)...);
+        else
+            (fns(), ...);
+    }
+
+    template<class I, class TransformFn, class ConsumeFn>
+    static void pipeline(const ExecutionTBB &,
+                         I              from,
+                         I              to,
+                         TransformFn  &&transformfn,
+                         ConsumeFn    &&consumefn,
+                         size_t         max_tokens)
+    {
+        using R = remove_cvref_t<decltype(transformfn(item_(from)))>;
+        // Items are passed through the pipeline by their offsets, iterators may not be trivially constructible as TBB tokens require.
+        const size_t count = size_t(to - from);
+        size_t       next  = 0;
+        tbb::parallel_pipeline(max_tokens,
+            tbb::make_filter<void, size_t>(FilterMode::serial_in_order, [&next, count](tbb::flow_control &fc) -> size_t {
+                if (next == count) {
+                    fc.stop();
+                    return count;
+                }
+                return next ++;
+            }) &
+            tbb::make_filter<size_t, R>(FilterMode::parallel, [&transformfn, from](size_t offset) -> R {
+                return transformfn(item_(I(from + offset)));
+            }) &
+            tbb::make_filter<R, void>(FilterMode::serial_in_order, [&consumefn](R r) {
+                consumefn(std::move(r));
+            }));
+    }
+
     static size_t max_concurrency(const ExecutionTBB &)
     {
         return tbb::this_task_arena::max_concurrency();
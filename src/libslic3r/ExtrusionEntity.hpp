@@ -32,7 +32,7 @@ namespace Slic3r {
 
 class ExPolygon;
 
-using ExPolygons = std::vector<ExPolygon>;
+using ExPolygons = std::vector<ExPolygon, PointsAllocator<ExPolygon>>;
 class ExtrusionEntityCollection;
 class Extruder;
 
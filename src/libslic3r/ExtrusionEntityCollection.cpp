@@ -37,10 +37,12 @@ ExtrusionEntityCollection::ExtrusionEntityCollection(const ExtrusionPaths &paths
 
 ExtrusionEntityCollection& ExtrusionEntityCollection::operator=(const ExtrusionEntityCollection &other)
 {
-    this->entities      = other.entities;
-    for (size_t i = 0; i < this->entities.size(); ++i)
-        this->entities[i] = this->entities[i]->clone();
-    this->no_sort       = other.no_sort;
+    if (this != &other) {
+        // Release the entities owned so far, they would leak otherwise.
+        this->clear();
+        this->append(other.entities);
+        this->no_sort = other.no_sort;
+    }
     return *this;
 }
 
@@ -119,28 +121,40 @@ size_t ExtrusionEntityCollection::items_count() const
 }
 
 // Returns a single vector of pointers to all non-collection items contained in this one.
-ExtrusionEntityCollection ExtrusionEntityCollection::flatten(bool preserve_ordering) const
+std::vector<const ExtrusionEntity*> ExtrusionEntityCollection::flatten_view(bool preserve_ordering) const
 {
 	struct Flatten {
 		Flatten(bool preserve_ordering) : preserve_ordering(preserve_ordering) {}
-		ExtrusionEntityCollection out;
-		bool   					  preserve_ordering;
+		std::vector<const ExtrusionEntity*> out;
+		bool   								preserve_ordering;
 		void recursive_do(const ExtrusionEntityCollection &collection) {
-		    if (collection.no_sort && preserve_ordering) {
-		    	// Don't flatten whatever happens below this level.
-		    	out.append(collection);
-		    } else {
-				for (const ExtrusionEntity *entity : collection.entities)
-					if (entity->is_collection())
-						this->recursive_do(*static_cast<const ExtrusionEntityCollection*>(entity));
-					else
-						out.append(*entity);
-			}
+			for (const ExtrusionEntity *entity : collection.entities)
+				if (entity->is_collection() && ! (preserve_ordering && static_cast<const ExtrusionEntityCollection*>(entity)->no_sort))
+					this->recursive_do(*static_cast<const ExtrusionEntityCollection*>(entity));
+				else
+					out.emplace_back(entity);
 		}
 	} flatten(preserve_ordering);
 
-	flatten.recursive_do(*this);
-    return flatten.out;
+	if (this->no_sort && preserve_ordering) {
+		// Don't flatten whatever happens below this level.
+		flatten.out.emplace_back(this);
+	} else {
+		flatten.out.reserve(this->items_count());
+		flatten.recursive_do(*this);
+	}
+    return std::move(flatten.out);
+}
+
+// Returns a copy of all non-collection items contained in this one, see flatten_view().
+ExtrusionEntityCollection ExtrusionEntityCollection::flatten(bool preserve_ordering) const
+{
+    const std::vector<const ExtrusionEntity*> entities = this->flatten_view(preserve_ordering);
+    ExtrusionEntityCollection out;
+    out.entities.reserve(entities.size());
+    for (const ExtrusionEntity *entity : entities)
+        out.entities.emplace_back(entity->clone());
+    return out;
 }
 
 double ExtrusionEntityCollection::min_mm3_per_mm() const
@@ -137,6 +137,9 @@ public:
     /// You should be iterating over flatten().entities if you are interested in the underlying ExtrusionEntities (and don't care about hierarchy).
     /// \param preserve_ordering Flag to method that will flatten if and only if the underlying collection is sortable when True (default: False).
     ExtrusionEntityCollection flatten(bool preserve_ordering = false) const;
+    /// Returns pointers to the same items as flatten() would copy, in the same order, without cloning them.
+    /// The items remain owned by this ExtrusionEntityCollection, use this to traverse the underlying ExtrusionEntities read-only.
+    std::vector<const ExtrusionEntity*> flatten_view(bool preserve_ordering = false) const;
     double min_mm3_per_mm() const override;
     double total_volume() const override { double volume=0.; for (const auto& ent : entities) volume+=ent->total_volume(); return volume; }
 
@@ -1,4 +1,4 @@
-#include <random>
+#include <cstdint>
 
 #include "libslic3r/Algorithm/LineSegmentation/LineSegmentation.hpp"
 #include "libslic3r/Arachne/utils/ExtrusionJunction.hpp"
@@ -14,42 +14,90 @@ using namespace Slic3r;
 
 namespace Slic3r::Feature::FuzzySkin {
 
-// Produces a random value between 0 and 1. Thread-safe.
-static double random_value()
+// Counter based random number generator: the n-th value of a sequence only depends on the seed and on n.
+// Unlike a thread local std::mt19937 seeded from std::random_device, the fuzzy skin is then the same in every run,
+// independent of the thread generating it, and producing a value is just a few multiplications.
+class CounterRandom
 {
-    thread_local std::random_device rd;
-    // Hash thread ID for random number seed if no hardware rng seed is available
-    thread_local std::mt19937                           gen(rd.entropy() > 0 ? rd() : std::hash<std::thread::id>()(std::this_thread::get_id()));
-    thread_local std::uniform_real_distribution<double> dist(0.0, 1.0);
-    return dist(gen);
+public:
+    explicit CounterRandom(uint64_t seed) : m_key(mix(seed)) {}
+
+    // Produces a random value between 0 and 1.
+    double next() { return double(mix(m_key + (++m_counter) * 0x9E3779B97F4A7C15ull) >> 11) * (1. / double(uint64_t(1) << 53)); }
+
+private:
+    // SplitMix64 finalizer.
+    static uint64_t mix(uint64_t z)
+    {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    uint64_t m_key;
+    uint64_t m_counter { 0 };
+};
+
+// The same outline on consecutive layers must not be fuzzified the same way, otherwise the fuzzy skin forms vertical ridges.
+static uint64_t fuzzy_skin_seed(const uint64_t seed, const Point &first_point)
+{
+    return seed ^ (uint64_t(uint32_t(first_point.x())) << 32) ^ uint64_t(uint32_t(first_point.y()));
+}
+
+static uint64_t fuzzy_skin_seed(const size_t layer_idx, const size_t perimeter_idx)
+{
+    return (uint64_t(layer_idx) << 40) ^ (uint64_t(perimeter_idx) << 20);
 }
 
-void fuzzy_polyline(Points &poly, const bool closed, const double fuzzy_skin_thickness, const double fuzzy_skin_point_distance)
+// Resample the polyline at random distances and move the new points randomly perpendicular to the source segment.
+// The kernel is shared by the classic and the Arachne perimeters. It calls emit(point, source_idx) for each new point,
+// where source_idx is the index of the end point of the source segment.
+// If copy_duplicate_points is set, the end point of a zero length segment is emitted unchanged and an open polyline
+// keeps its first point, otherwise the first point of an open polyline is dropped.
+template<typename PointAt, typename Emit>
+static void fuzzy_points(const size_t num_points, PointAt &&point_at, const bool closed, const bool copy_duplicate_points,
+                         const double fuzzy_skin_thickness, const double fuzzy_skin_point_distance, const uint64_t seed, Emit &&emit)
 {
     const double min_dist_between_points = fuzzy_skin_point_distance * 3. / 4.; // hardcoded: the point distance may vary between 3/4 and 5/4 the supplied value
     const double range_random_point_dist = fuzzy_skin_point_distance / 2.;
-    double       dist_left_over          = random_value() * (min_dist_between_points / 2.); // the distance to be traversed on the line before making the first new point
 
-    Points out;
-    out.reserve(poly.size());
+    CounterRandom random(fuzzy_skin_seed(seed, point_at(0)));
+    double        dist_left_over = random.next() * (min_dist_between_points / 2.); // the distance to be traversed on the line before making the first new point
 
-    // Skip the first point for open polyline.
-    Point *p0 = closed ? &poly.back() : &poly.front();
-    for (auto it_pt1 = closed ? poly.begin() : std::next(poly.begin()); it_pt1 != poly.end(); ++it_pt1) {
-        Point &p1 = *it_pt1;
+    size_t idx_p0 = closed ? num_points - 1 : 0;
+    for (size_t idx_p1 = (closed || copy_duplicate_points) ? 0 : 1; idx_p1 < num_points; ++idx_p1) {
+        const Point &p0 = point_at(idx_p0);
+        const Point &p1 = point_at(idx_p1);
+        if (copy_duplicate_points && p0 == p1) {
+            emit(p1, idx_p1);
+            continue;
+        }
 
         // 'a' is the (next) new point between p0 and p1
-        Vec2d  p0p1      = (p1 - *p0).cast<double>();
-        double p0p1_size = p0p1.norm();
-        double p0pa_dist = dist_left_over;
-        for (; p0pa_dist < p0p1_size; p0pa_dist += min_dist_between_points + random_value() * range_random_point_dist) {
-            double r = random_value() * (fuzzy_skin_thickness * 2.) - fuzzy_skin_thickness;
-            out.emplace_back(*p0 + (p0p1 * (p0pa_dist / p0p1_size) + perp(p0p1).cast<double>().normalized() * r).cast<coord_t>());
+        const Vec2d  p0p1      = (p1 - p0).cast<double>();
+        const double p0p1_size = p0p1.norm();
+        double       p0pa_dist = dist_left_over;
+        if (p0pa_dist < p0p1_size) {
+            // The direction and the normal are constant along the segment.
+            const Vec2d dir    = p0p1 / p0p1_size;
+            const Vec2d normal = perp(dir);
+            for (; p0pa_dist < p0p1_size; p0pa_dist += min_dist_between_points + random.next() * range_random_point_dist) {
+                const double r = random.next() * (fuzzy_skin_thickness * 2.) - fuzzy_skin_thickness;
+                emit(p0 + (dir * p0pa_dist + normal * r).cast<coord_t>(), idx_p1);
+            }
         }
 
         dist_left_over = p0pa_dist - p0p1_size;
-        p0             = &p1;
+        idx_p0         = idx_p1;
     }
+}
+
+void fuzzy_polyline(Points &poly, const bool closed, const double fuzzy_skin_thickness, const double fuzzy_skin_point_distance, const uint64_t seed)
+{
+    Points out;
+    out.reserve(poly.size());
+    fuzzy_points(poly.size(), [&poly](size_t idx) -> const Point& { return poly[idx]; }, closed, false, fuzzy_skin_thickness, fuzzy_skin_point_distance, seed,
+        [&out](const Point &pt, size_t /* source_idx */) { out.emplace_back(pt); });
 
     while (out.size() < 3) {
         size_t point_idx = poly.size() - 2;
@@ -66,39 +114,17 @@ void fuzzy_polyline(Points &poly, const bool closed, const double fuzzy_skin_thi
     }
 }
 
-void fuzzy_polygon(Polygon &polygon, double fuzzy_skin_thickness, double fuzzy_skin_point_distance)
+void fuzzy_polygon(Polygon &polygon, double fuzzy_skin_thickness, double fuzzy_skin_point_distance, const uint64_t seed)
 {
-    fuzzy_polyline(polygon.points, true, fuzzy_skin_thickness, fuzzy_skin_point_distance);
+    fuzzy_polyline(polygon.points, true, fuzzy_skin_thickness, fuzzy_skin_point_distance, seed);
 }
 
-void fuzzy_extrusion_line(Arachne::ExtrusionLine &ext_lines, const double fuzzy_skin_thickness, const double fuzzy_skin_point_distance)
+void fuzzy_extrusion_line(Arachne::ExtrusionLine &ext_lines, const double fuzzy_skin_thickness, const double fuzzy_skin_point_distance, const uint64_t seed)
 {
-    const double min_dist_between_points = fuzzy_skin_point_distance * 3. / 4.; // hardcoded: the point distance may vary between 3/4 and 5/4 the supplied value
-    const double range_random_point_dist = fuzzy_skin_point_distance / 2.;
-    double       dist_left_over          = random_value() * (min_dist_between_points / 2.); // the distance to be traversed on the line before making the first new point
-
-    Arachne::ExtrusionJunction *p0 = &ext_lines.front();
     Arachne::ExtrusionJunctions out;
     out.reserve(ext_lines.size());
-    for (auto &p1 : ext_lines) {
-        if (p0->p == p1.p) {
-            // Copy the first point.
-            out.emplace_back(p1.p, p1.w, p1.perimeter_index);
-            continue;
-        }
-
-        // 'a' is the (next) new point between p0 and p1
-        Vec2d  p0p1      = (p1.p - p0->p).cast<double>();
-        double p0p1_size = p0p1.norm();
-        double p0pa_dist = dist_left_over;
-        for (; p0pa_dist < p0p1_size; p0pa_dist += min_dist_between_points + random_value() * range_random_point_dist) {
-            double r = random_value() * (fuzzy_skin_thickness * 2.) - fuzzy_skin_thickness;
-            out.emplace_back(p0->p + (p0p1 * (p0pa_dist / p0p1_size) + perp(p0p1).cast<double>().normalized() * r).cast<coord_t>(), p1.w, p1.perimeter_index);
-        }
-
-        dist_left_over = p0pa_dist - p0p1_size;
-        p0             = &p1;
-    }
+    fuzzy_points(ext_lines.size(), [&ext_lines](size_t idx) -> const Point& { return ext_lines[idx].p; }, false, true, fuzzy_skin_thickness, fuzzy_skin_point_distance, seed,
+        [&ext_lines, &out](const Point &pt, size_t source_idx) { out.emplace_back(pt, ext_lines[source_idx].w, ext_lines[source_idx].perimeter_index); });
 
     while (out.size() < 3) {
         size_t point_idx = ext_lines.size() - 2;
@@ -141,7 +167,8 @@ Polygon apply_fuzzy_skin(const Polygon &polygon, const PrintRegionConfig &base_c
     auto apply_fuzzy_skin_on_polygon = [&layer_idx, &perimeter_idx, &is_contour](const Polygon &polygon, const PrintRegionConfig &config) -> Polygon {
         if (should_fuzzify(config, layer_idx, perimeter_idx, is_contour)) {
             Polygon fuzzified_polygon = polygon;
-            fuzzy_polygon(fuzzified_polygon, scaled<double>(config.fuzzy_skin_thickness.value), scaled<double>(config.fuzzy_skin_point_dist.value));
+            fuzzy_polygon(fuzzified_polygon, scaled<double>(config.fuzzy_skin_thickness.value), scaled<double>(config.fuzzy_skin_point_dist.value),
+                          fuzzy_skin_seed(layer_idx, perimeter_idx));
 
             return fuzzified_polygon;
         } else {
@@ -163,7 +190,8 @@ Polygon apply_fuzzy_skin(const Polygon &polygon, const PrintRegionConfig &base_c
     for (PolylineRegionSegment &segment : segments) {
         const PrintRegionConfig &config = segment.config;
         if (should_fuzzify(config, layer_idx, perimeter_idx, is_contour)) {
-            fuzzy_polyline(segment.polyline.points, false, scaled<double>(config.fuzzy_skin_thickness.value), scaled<double>(config.fuzzy_skin_point_dist.value));
+            fuzzy_polyline(segment.polyline.points, false, scaled<double>(config.fuzzy_skin_thickness.value), scaled<double>(config.fuzzy_skin_point_dist.value),
+                           fuzzy_skin_seed(layer_idx, perimeter_idx));
         }
 
         assert(!segment.polyline.empty());
@@ -194,7 +222,8 @@ Arachne::ExtrusionLine apply_fuzzy_skin(const Arachne::ExtrusionLine &extrusion,
     if (perimeter_regions.empty()) {
         if (should_fuzzify(base_config, layer_idx, perimeter_idx, is_contour)) {
             ExtrusionLine fuzzified_extrusion = extrusion;
-            fuzzy_extrusion_line(fuzzified_extrusion, scaled<double>(base_config.fuzzy_skin_thickness.value), scaled<double>(base_config.fuzzy_skin_point_dist.value));
+            fuzzy_extrusion_line(fuzzified_extrusion, scaled<double>(base_config.fuzzy_skin_thickness.value), scaled<double>(base_config.fuzzy_skin_point_dist.value),
+                                 fuzzy_skin_seed(layer_idx, perimeter_idx));
 
             return fuzzified_extrusion;
         } else {
@@ -208,7 +237,8 @@ Arachne::ExtrusionLine apply_fuzzy_skin(const Arachne::ExtrusionLine &extrusion,
     for (ExtrusionRegionSegment &segment : segments) {
         const PrintRegionConfig &config = segment.config;
         if (should_fuzzify(config, layer_idx, perimeter_idx, is_contour)) {
-            fuzzy_extrusion_line(segment.extrusion, scaled<double>(config.fuzzy_skin_thickness.value), scaled<double>(config.fuzzy_skin_point_dist.value));
+            fuzzy_extrusion_line(segment.extrusion, scaled<double>(config.fuzzy_skin_thickness.value), scaled<double>(config.fuzzy_skin_point_dist.value),
+                                 fuzzy_skin_seed(layer_idx, perimeter_idx));
         }
 
         assert(!segment.extrusion.empty());
@@ -1,6 +1,8 @@
 #ifndef libslic3r_FuzzySkin_hpp_
 #define libslic3r_FuzzySkin_hpp_
 
+#include <cstdint>
+
 namespace Slic3r::Arachne {
 struct ExtrusionLine;
 } // namespace Slic3r::Arachne
@@ -11,9 +13,10 @@ struct Parameters;
 
 namespace Slic3r::Feature::FuzzySkin {
 
-void fuzzy_polygon(Polygon &polygon, double fuzzy_skin_thickness, double fuzzy_skin_point_distance);
+// The fuzzy skin is deterministic: the same seed and the same input always produce the same output.
+void fuzzy_polygon(Polygon &polygon, double fuzzy_skin_thickness, double fuzzy_skin_point_distance, uint64_t seed = 0);
 
-void fuzzy_extrusion_line(Arachne::ExtrusionLine &ext_lines, double fuzzy_skin_thickness, double fuzzy_skin_point_dist);
+void fuzzy_extrusion_line(Arachne::ExtrusionLine &ext_lines, double fuzzy_skin_thickness, double fuzzy_skin_point_dist, uint64_t seed = 0);
 
 bool should_fuzzify(const PrintRegionConfig &config, size_t layer_idx, size_t perimeter_idx, bool is_contour);
 
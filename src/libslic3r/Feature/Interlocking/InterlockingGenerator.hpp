@@ -104,7 +104,7 @@ private:
      * Expand the meshes into each other where they need it, namely when a thin strip of material needs to be attached.
      * \param has_all_meshes Only do this special handling if there's actually microstructure nearby that needs to be adhered to.
      */
-    void handleThinAreas(const std::unordered_set<GridPoint3>& has_all_meshes) const;
+    void handleThinAreas(const VoxelGrid& has_all_meshes) const;
 
     /*!
      * Compute the voxels overlapping with the shell of both models.
@@ -113,17 +113,18 @@ private:
      * \param kernel The dilation kernel to give the returned voxel shell more thickness
      * \return The shell voxels for mesh a and those for mesh b
      */
-    std::vector<std::unordered_set<GridPoint3>> getShellVoxels(const DilationKernel& kernel) const;
+    std::vector<VoxelGrid> getShellVoxels(const DilationKernel& kernel) const;
 
     /*!
      * Compute the voxels overlapping with the shell of some layers.
      * This includes the walls, but also top/bottom skin.
+     * The layers are voxelised in parallel.
      *
      * \param layers The layer outlines for which to compute the shell voxels
      * \param kernel The dilation kernel to give the returned voxel shell more thickness
-     * \param[out] cells The output cells which elong to the shell
+     * \return The cells which belong to the shell
      */
-    void addBoundaryCells(const std::vector<ExPolygons>& layers, const DilationKernel& kernel, std::unordered_set<GridPoint3>& cells) const;
+    VoxelGrid getBoundaryCells(const std::vector<ExPolygons>& layers, const DilationKernel& kernel) const;
 
     /*!
      * Compute the regions occupied by both models.
@@ -145,7 +146,7 @@ private:
      * \param cells The cells where we want to apply the interlocking structure.
      * \param layer_regions The total volume of the two meshes combined (and small gaps closed)
      */
-    void applyMicrostructureToOutlines(const std::unordered_set<GridPoint3>& cells, const std::vector<ExPolygons>& layer_regions) const;
+    void applyMicrostructureToOutlines(const VoxelGrid& cells, const std::vector<ExPolygons>& layer_regions) const;
 
     static const coord_t ignored_gap_ = 100u; //!< Distance between models to be considered next to each other so that an interlocking structure will be generated there
 
@@ -2,6 +2,10 @@
 // CuraEngine is released under the terms of the AGPLv3 or higher.
 
 #include <boost/log/trivial.hpp>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_reduce.h>
+
+#include <bitset>
 
 #include "VoxelUtils.hpp"
 #include "libslic3r/Geometry.hpp"
@@ -47,6 +51,149 @@ DilationKernel::DilationKernel(GridPoint3 kernel_size, DilationKernel::Type type
     }
 }
 
+bool VoxelGrid::isEmpty(const Block &block)
+{
+    for (uint64_t word : block)
+        if (word != 0)
+            return false;
+    return true;
+}
+
+bool VoxelGrid::empty() const
+{
+    for (const auto &[block_position, block] : m_blocks)
+        if (!isEmpty(block))
+            return false;
+    return true;
+}
+
+size_t VoxelGrid::size() const
+{
+    size_t count = 0;
+    for (const auto &[block_position, block] : m_blocks)
+        for (uint64_t word : block)
+            count += std::bitset<64>(word).count();
+    return count;
+}
+
+void VoxelGrid::insert(const GridPoint3 &p)
+{
+    m_blocks[blockPosition(p)][wordIndex(p)] |= bitMask(p);
+}
+
+void VoxelGrid::erase(const GridPoint3 &p)
+{
+    if (auto it = m_blocks.find(blockPosition(p)); it != m_blocks.end()) {
+        it->second[wordIndex(p)] &= ~bitMask(p);
+        if (isEmpty(it->second))
+            m_blocks.erase(it);
+    }
+}
+
+bool VoxelGrid::contains(const GridPoint3 &p) const
+{
+    auto it = m_blocks.find(blockPosition(p));
+    return it != m_blocks.end() && (it->second[wordIndex(p)] & bitMask(p)) != 0;
+}
+
+void VoxelGrid::unite(const VoxelGrid &other)
+{
+    for (const auto &[block_position, other_block] : other.m_blocks) {
+        Block &block = m_blocks.try_emplace(block_position, Block{}).first->second;
+        for (int z = 0; z < block_size; ++ z)
+            block[z] |= other_block[z];
+    }
+}
+
+void VoxelGrid::intersect(const VoxelGrid &other)
+{
+    decltype(m_blocks) blocks;
+    for (const auto &[block_position, block] : m_blocks)
+        if (auto it = other.m_blocks.find(block_position); it != other.m_blocks.end()) {
+            Block result;
+            for (int z = 0; z < block_size; ++ z)
+                result[z] = block[z] & it->second[z];
+            if (!isEmpty(result))
+                blocks.emplace(block_position, result);
+        }
+    m_blocks = std::move(blocks);
+}
+
+void VoxelGrid::subtract(const VoxelGrid &other)
+{
+    decltype(m_blocks) blocks;
+    for (const auto &[block_position, block] : m_blocks) {
+        Block result = block;
+        if (auto it = other.m_blocks.find(block_position); it != other.m_blocks.end())
+            for (int z = 0; z < block_size; ++ z)
+                result[z] &= ~it->second[z];
+        if (!isEmpty(result))
+            blocks.emplace(block_position, result);
+    }
+    m_blocks = std::move(blocks);
+}
+
+void VoxelGrid::eraseBelowZ(coord_t min_z)
+{
+    decltype(m_blocks) blocks;
+    for (const auto &[block_position, block] : m_blocks) {
+        Block result = block;
+        for (int z = 0; z < block_size; ++ z)
+            if (block_position.z() * block_size + z < min_z)
+                result[z] = 0;
+        if (!isEmpty(result))
+            blocks.emplace(block_position, result);
+    }
+    m_blocks = std::move(blocks);
+}
+
+VoxelGrid VoxelGrid::dilated(const DilationKernel &kernel) const
+{
+    std::vector<std::pair<GridPoint3, const Block*>> blocks;
+    blocks.reserve(m_blocks.size());
+    for (const auto &[block_position, block] : m_blocks)
+        blocks.emplace_back(block_position, &block);
+
+    // Each task dilates a subset of the blocks into its own grid, the grids are united at the end.
+    return tbb::parallel_reduce(tbb::blocked_range<size_t>(0, blocks.size()), VoxelGrid{},
+        [&blocks, &kernel](const tbb::blocked_range<size_t> &range, VoxelGrid out) {
+            for (size_t i = range.begin(); i < range.end(); ++ i)
+                forEachInBlock(blocks[i].first, *blocks[i].second, [&kernel, &out](const GridPoint3 &p) {
+                    for (const GridPoint3 &rel : kernel.relative_cells_)
+                        out.insert(p + rel);
+                });
+            return out;
+        },
+        [](VoxelGrid lhs, const VoxelGrid &rhs) {
+            lhs.unite(rhs);
+            return lhs;
+        });
+}
+
+std::vector<GridPoint3> VoxelGrid::cells() const
+{
+    std::vector<GridPoint3> out;
+    out.reserve(this->size());
+    this->forEach([&out](const GridPoint3 &p) { out.emplace_back(p); });
+    return out;
+}
+
+// Offset half a cell when using an even kernel.
+static Vec3crd dilated_polygons_translation(const Vec3crd &cell_size, const DilationKernel &kernel)
+{
+    GridPoint3 k = kernel.kernel_size_;
+    k.x() %= 2;
+    k.y() %= 2;
+    k.z() %= 2;
+    return (Vec3crd(1, 1, 1) - k).array() * cell_size.array() / 2;
+}
+
+static Vec3crd dilated_areas_translation(const Vec3crd &cell_size, const DilationKernel &kernel)
+{
+    // offset half a cell so that the dots of spreadDotsArea are centered on the middle of the cell isntead of the lower corners.
+    return dilated_polygons_translation(cell_size, kernel).array() - cell_size.array() / 2;
+}
+
 bool VoxelUtils::walkLine(Vec3crd start, Vec3crd end, const std::function<bool(GridPoint3)>& process_cell_func) const
 {
     Vec3crd diff = end - start;
@@ -117,11 +264,7 @@ bool VoxelUtils::walkPolygons(const ExPolygon& polys, coord_t z, const std::func
 bool VoxelUtils::walkDilatedPolygons(const ExPolygon& polys, coord_t z, const DilationKernel& kernel, const std::function<bool(GridPoint3)>& process_cell_func) const
 {
     ExPolygon translated = polys;
-    GridPoint3 k = kernel.kernel_size_;
-    k.x() %= 2;
-    k.y() %= 2;
-    k.z() %= 2;
-    const Vec3crd translation = (Vec3crd(1, 1, 1) - k).array() * cell_size_.array() / 2;
+    const Vec3crd translation = dilated_polygons_translation(cell_size_, kernel);
     if (translation.x() && translation.y())
     {
         translated.translate(Point(translation.x(), translation.y()));
@@ -152,12 +295,7 @@ bool VoxelUtils::_walkAreas(const ExPolygon &ex_polygon, coord_t z, const std::f
 bool VoxelUtils::walkDilatedAreas(const ExPolygon& polys, coord_t z, const DilationKernel& kernel, const std::function<bool(GridPoint3)>& process_cell_func) const
 {
     ExPolygon translated = polys;
-    GridPoint3 k = kernel.kernel_size_;
-    k.x() %= 2;
-    k.y() %= 2;
-    k.z() %= 2;
-    const Vec3crd translation = (Vec3crd(1, 1, 1) - k).array() * cell_size_.array() / 2 // offset half a cell when using an even kernel
-                               - cell_size_.array() / 2; // offset half a cell so that the dots of spreadDotsArea are centered on the middle of the cell isntead of the lower corners.
+    const Vec3crd translation = dilated_areas_translation(cell_size_, kernel);
     if (translation.x() && translation.y())
     {
         translated.translate(Point(translation.x(), translation.y()));
@@ -178,4 +316,34 @@ std::function<bool(GridPoint3)> VoxelUtils::dilate(const DilationKernel& kernel,
         return true;
     };
 }
+
+void VoxelUtils::markDilatedPolygons(const ExPolygons& polys, coord_t z, const DilationKernel& kernel, VoxelGrid& cells) const
+{
+    const Vec3crd translation = dilated_polygons_translation(cell_size_, kernel);
+    const std::function<bool(GridPoint3)> mark = [&cells](GridPoint3 p) {
+        cells.insert(p);
+        return true;
+    };
+    for (const ExPolygon& poly : polys) {
+        ExPolygon translated = poly;
+        if (translation.x() && translation.y())
+            translated.translate(Point(translation.x(), translation.y()));
+        walkPolygons(translated, z + translation.z(), mark);
+    }
+}
+
+void VoxelUtils::markDilatedAreas(const ExPolygons& polys, coord_t z, const DilationKernel& kernel, VoxelGrid& cells) const
+{
+    const Vec3crd translation = dilated_areas_translation(cell_size_, kernel);
+    const std::function<bool(GridPoint3)> mark = [&cells](GridPoint3 p) {
+        cells.insert(p);
+        return true;
+    };
+    for (const ExPolygon& poly : polys) {
+        ExPolygon translated = poly;
+        if (translation.x() && translation.y())
+            translated.translate(Point(translation.x(), translation.y()));
+        _walkAreas(translated, z + translation.z(), mark);
+    }
+}
 } // namespace cura
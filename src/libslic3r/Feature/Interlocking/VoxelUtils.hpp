@@ -5,6 +5,11 @@
 #define UTILS_VOXEL_UTILS_H
 
 #include <functional>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <ankerl/unordered_dense.h>
 
 #include "libslic3r/Polygon.hpp"
 #include "libslic3r/ExPolygon.hpp"
@@ -53,6 +58,79 @@ struct DilationKernel
     DilationKernel(GridPoint3 kernel_size, Type type);
 };
 
+/*!
+ * Sparse set of voxel cells.
+ *
+ * The cells are stored as bitsets of blocks of 8x8x8 cells, only the blocks containing some cell are allocated.
+ * Nearby cells share a block, thus the set operations process 64 cells at once and the memory footprint
+ * is a fraction of std::unordered_set<GridPoint3>.
+ */
+class VoxelGrid
+{
+public:
+    bool   empty() const;
+    size_t size() const;
+
+    void insert(const GridPoint3 &p);
+    void erase(const GridPoint3 &p);
+    bool contains(const GridPoint3 &p) const;
+
+    // Set operations, modifying this grid.
+    void unite(const VoxelGrid &other);
+    void intersect(const VoxelGrid &other);
+    void subtract(const VoxelGrid &other);
+
+    // Remove all cells with z coordinate below min_z.
+    void eraseBelowZ(coord_t min_z);
+
+    /*!
+     * Dilate all the cells with a kernel, the blocks are processed in parallel.
+     * The result is the same as if each cell was dilated by VoxelUtils::dilate().
+     */
+    VoxelGrid dilated(const DilationKernel &kernel) const;
+
+    // All the cells, the cells of a single block are consecutive.
+    std::vector<GridPoint3> cells() const;
+
+    template<typename Fn> void forEach(Fn &&fn) const
+    {
+        for (const auto &[block_position, block] : m_blocks)
+            forEachInBlock(block_position, block, fn);
+    }
+
+private:
+    static constexpr int block_bits = 3;
+    static constexpr int block_size = 1 << block_bits;
+    // One word per z coordinate of the block, one bit per xy position.
+    using Block = std::array<uint64_t, block_size>;
+
+    struct BlockPositionHash
+    {
+        using is_avalanching = void;
+        uint64_t operator()(const GridPoint3 &p) const noexcept
+        {
+            return ankerl::unordered_dense::hash<uint64_t>{}(
+                (uint64_t(uint32_t(p.x())) << 42) ^ (uint64_t(uint32_t(p.y())) << 21) ^ uint64_t(uint32_t(p.z())));
+        }
+    };
+
+    static GridPoint3 blockPosition(const GridPoint3 &p) { return GridPoint3(p.x() >> block_bits, p.y() >> block_bits, p.z() >> block_bits); }
+    static int        wordIndex(const GridPoint3 &p) { return p.z() & (block_size - 1); }
+    static uint64_t   bitMask(const GridPoint3 &p) { return uint64_t(1) << (((p.y() & (block_size - 1)) << block_bits) | (p.x() & (block_size - 1))); }
+    static bool       isEmpty(const Block &block);
+
+    template<typename Fn> static void forEachInBlock(const GridPoint3 &block_position, const Block &block, Fn &&fn)
+    {
+        const GridPoint3 origin = block_position * block_size;
+        for (int z = 0; z < block_size; ++ z)
+            for (uint64_t word = block[z], bit = 0; word != 0; word >>= 1, ++ bit)
+                if (word & 1)
+                    fn(GridPoint3(origin.x() + coord_t(bit & (block_size - 1)), origin.y() + coord_t(bit >> block_bits), origin.z() + z));
+    }
+
+    ankerl::unordered_dense::map<GridPoint3, Block, BlockPositionHash> m_blocks;
+};
+
 /*!
  * Utility class for walking over a 3D voxel grid.
  *
@@ -157,6 +235,20 @@ public:
      */
     std::function<bool(GridPoint3)> dilate(const DilationKernel& kernel, const std::function<bool(GridPoint3)>& process_cell_func) const;
 
+    /*!
+     * Mark the voxels which the line segments of the polygons cross, without dilation.
+     * The polygons are translated the same way as by walkDilatedPolygons(), thus dilating \p cells by the same kernel afterwards
+     * results in the cells processed by walkDilatedPolygons().
+     */
+    void markDilatedPolygons(const ExPolygons& polys, coord_t z, const DilationKernel& kernel, VoxelGrid& cells) const;
+
+    /*!
+     * Mark the voxels inside the area of the polygons, without dilation.
+     * The polygons are translated the same way as by walkDilatedAreas(), thus dilating \p cells by the same kernel afterwards
+     * results in the cells processed by walkDilatedAreas().
+     */
+    void markDilatedAreas(const ExPolygons& polys, coord_t z, const DilationKernel& kernel, VoxelGrid& cells) const;
+
     GridPoint3 toGridPoint(const Point &point, const Vec3crd &offset) const
     {
         return toGridPoint(Vec3crd(point.x(), point.y(), 0) + offset);
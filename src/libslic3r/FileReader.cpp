@@ -76,6 +76,8 @@ static Model read_model_from_file(const std::string& input_file, LoadAttributes
         for (ModelObject* o : model.objects)
             o->input_file = input_file;
 
+    ModelProcessing::deduplicate_meshes(model);
+
     if (options & LoadAttribute::AddDefaultInstances)
         model.add_default_instances();
 
@@ -110,6 +112,8 @@ static Model read_all_from_file(const std::string& input_file,
     for (ModelObject* o : model.objects)
         o->input_file = input_file;
 
+    ModelProcessing::deduplicate_meshes(model);
+
     if (options & LoadAttribute::AddDefaultInstances)
         model.add_default_instances();
 
@@ -7,6 +7,8 @@
 ///|/
 ///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
 ///|/
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
 #include <oneapi/tbb/scalable_allocator.h>
 #include <boost/container/vector.hpp>
 #include <memory>
@@ -548,14 +550,32 @@ void Layer::make_fills(FillAdaptive::Octree* adaptive_fill_octree, FillAdaptive:
         params.layer_height               = layerm.layer()->height;
         params.prefer_clockwise_movements = this->object()->print()->config().prefer_clockwise_movements;
 
-        for (ExPolygon &expoly : surface_fill.expolygons) {
+        // The ensuring infill does not modify the filler, thus its expolygons are filled in parallel up front.
+        std::vector<ThickPolylines> ensuring_thick_polylines;
+        if (surface_fill.params.pattern == ipEnsuring && surface_fill.expolygons.size() > 1) {
+            f->spacing = surface_fill.params.spacing;
+            ensuring_thick_polylines.assign(surface_fill.expolygons.size(), {});
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, surface_fill.expolygons.size()), [&](const tbb::blocked_range<size_t> &range) {
+                for (size_t i = range.begin(); i < range.end(); ++ i) {
+                    Surface surface(surface_fill.surface, surface_fill.expolygons[i]);
+                    try {
+                        ensuring_thick_polylines[i] = f->fill_surface_arachne(&surface, params);
+                    } catch (InfillFailedException &) {
+                    }
+                }
+            });
+        }
+
+        for (size_t expoly_idx = 0; expoly_idx < surface_fill.expolygons.size(); ++ expoly_idx) {
 			// Spacing is modified by the filler to indicate adjustments. Reset it for each expolygon.
 			f->spacing = surface_fill.params.spacing;
-			surface_fill.surface.expolygon = std::move(expoly);
+			surface_fill.surface.expolygon = std::move(surface_fill.expolygons[expoly_idx]);
             Polylines      polylines;
             ThickPolylines thick_polylines;
 			try {
-                if (params.use_arachne)
+                if (! ensuring_thick_polylines.empty())
+                    thick_polylines = std::move(ensuring_thick_polylines[expoly_idx]);
+                else if (params.use_arachne)
                     thick_polylines = f->fill_surface_arachne(&surface_fill.surface, params);
                 else
 				    polylines = f->fill_surface(&surface_fill.surface, params);
@@ -751,7 +771,7 @@ Polylines Layer::generate_sparse_infill_polylines_for_anchoring(FillAdaptive::Oc
 }
 
 // Create ironing extrusions over top surfaces.
-void Layer::make_ironing()
+std::vector<Layer::IroningFill> Layer::generate_ironing() const
 {
 	// LayerRegion::slices contains surfaces marked with SurfaceType.
 	// Here we want to collect top surfaces extruded with the same extruder.
@@ -802,8 +822,8 @@ void Layer::make_ironing()
 				   this->angle == rhs.angle;
 		}
 
-		LayerRegion *layerm;
-		uint32_t     region_id;
+		const LayerRegion *layerm;
+		uint32_t           region_id;
 
 		// IdeaMaker: ironing
 		// ironing flowrate (5% percent)
@@ -824,7 +844,7 @@ void Layer::make_ironing()
     double default_layer_height = this->object()->config().layer_height;
 
 	for (uint32_t region_id = 0; region_id < uint32_t(this->regions().size()); ++region_id)
-		if (LayerRegion *layerm = this->get_region(region_id); ! layerm->slices().empty()) {
+		if (const LayerRegion *layerm = this->get_region(region_id); ! layerm->slices().empty()) {
 			IroningParams ironing_params;
 			const PrintRegionConfig &config = layerm->region().config();
 			if (config.ironing && 
@@ -852,6 +872,9 @@ void Layer::make_ironing()
 				by_extruder.emplace_back(ironing_params);
 			}
 		}
+	std::vector<IroningFill> out;
+	if (by_extruder.empty())
+		return out;
 	std::sort(by_extruder.begin(), by_extruder.end());
 
     FillRectilinear 	fill;
@@ -946,25 +969,32 @@ void Layer::make_ironing()
 				polylines = fill.fill_surface(&surface_fill, fill_params);
 			} catch (InfillFailedException &) {
 			}
-	        if (! polylines.empty()) {
-		        // Save into layer.
-				auto fill_begin = uint32_t(ironing_params.layerm->fills().size());
-				ExtrusionEntityCollection *eec = nullptr;
-		        ironing_params.layerm->m_fills.entities.push_back(eec = new ExtrusionEntityCollection());
-		        // Don't sort the ironing infill lines as they are monotonicly ordered.
-				eec->no_sort = true;
-		        extrusion_entities_append_paths(
-		            eec->entities, std::move(polylines),
+	        if (! polylines.empty())
+				out.push_back({ ironing_params.region_id, std::move(polylines),
 					ExtrusionAttributes{ ExtrusionRole::Ironing,
 						ExtrusionFlow{ flow_mm3_per_mm, extrusion_width, float(extrusion_height) }
-					});
-				insert_fills_into_islands(*this, ironing_params.region_id, fill_begin, uint32_t(ironing_params.layerm->fills().size()));
-		    }
+					} });
 		}
 
 		// Regions up to j were processed.
 		i = j;
 	}
+	return out;
+}
+
+void Layer::apply_ironing(std::vector<IroningFill> &&ironing_fills)
+{
+	for (IroningFill &ironing_fill : ironing_fills) {
+		// Save into layer.
+		LayerRegion *layerm = this->get_region(ironing_fill.region_id);
+		auto fill_begin = uint32_t(layerm->fills().size());
+		ExtrusionEntityCollection *eec = nullptr;
+		layerm->m_fills.entities.push_back(eec = new ExtrusionEntityCollection());
+		// Don't sort the ironing infill lines as they are monotonicly ordered.
+		eec->no_sort = true;
+		extrusion_entities_append_paths(eec->entities, std::move(ironing_fill.polylines), ironing_fill.attributes);
+		insert_fills_into_islands(*this, ironing_fill.region_id, fill_begin, uint32_t(layerm->fills().size()));
+	}
 }
 
 } // namespace Slic3r
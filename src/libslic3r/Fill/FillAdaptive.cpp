@@ -35,6 +35,8 @@
 // Boost pool: Don't use mutexes to synchronize memory allocation.
 #define BOOST_POOL_NO_MT
 #include <boost/pool/object_pool.hpp>
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
 #include <boost/geometry.hpp>
 #include <boost/geometry/geometries/segment.hpp>
 
@@ -271,15 +273,19 @@ struct Octree
 {
     // Octree will allocate its Cubes from the pool. The pool only supports deletion of the complete pool,
     // perfect for building up our octree.
-    boost::object_pool<Cube>    pool;
-    Cube*                       root_cube { nullptr };
-    Vec3d                       origin;
-    std::vector<CubeProperties> cubes_properties;
+    boost::object_pool<Cube>                pool;
+    // The subtrees of the children of the root cube are built in parallel, each allocating from its own pool.
+    std::array<boost::object_pool<Cube>, 8> child_pools;
+    Cube*                                   root_cube { nullptr };
+    Vec3d                                   origin;
+    std::vector<CubeProperties>             cubes_properties;
 
     Octree(const Vec3d &origin, const std::vector<CubeProperties> &cubes_properties)
         : root_cube(pool.construct(origin)), origin(origin), cubes_properties(cubes_properties) {}
 
-    void insert_triangle(const Vec3d &a, const Vec3d &b, const Vec3d &c, Cube *current_cube, const BoundingBoxf3 &current_bbox, int depth);
+    // Insert a triangle into the i-th child of current_cube, allocate the new cubes from cube_pool.
+    void insert_triangle_into_child(const Vec3d &a, const Vec3d &b, const Vec3d &c, Cube *current_cube, const BoundingBoxf3 &current_bbox, int depth, size_t i, boost::object_pool<Cube> &cube_pool);
+    void insert_triangle(const Vec3d &a, const Vec3d &b, const Vec3d &c, Cube *current_cube, const BoundingBoxf3 &current_bbox, int depth, boost::object_pool<Cube> &cube_pool);
 };
 
 void OctreeDeleter::operator()(Octree *p) {
@@ -1493,23 +1499,29 @@ OctreePtr build_octree(
         double edge_length_half = 0.5 * cubes_properties.back().edge_length;
         Vec3d  diag_half(edge_length_half, edge_length_half, edge_length_half);
         int    max_depth = int(cubes_properties.size()) - 1;
-        auto process_triangle = [octree_ptr, max_depth, diag_half](const Vec3d &a, const Vec3d &b, const Vec3d &c) {
-            octree_ptr->insert_triangle(
-                a, b, c,
-                octree_ptr->root_cube,
-                BoundingBoxf3(octree_ptr->root_cube->center - diag_half, octree_ptr->root_cube->center + diag_half),
-                max_depth);
-        };
         auto up_vector = support_overhangs_only ? Vec3d(transform_to_octree() * Vec3d(0., 0., 1.)) : Vec3d();
-        for (auto &tri : triangle_mesh.indices) {
-            auto a = triangle_mesh.vertices[tri[0]].cast<double>();
-            auto b = triangle_mesh.vertices[tri[1]].cast<double>();
-            auto c = triangle_mesh.vertices[tri[2]].cast<double>();
-            if (! support_overhangs_only || is_overhang_triangle(a, b, c, up_vector))
-                process_triangle(a, b, c);
-        }
-        for (size_t i = 0; i < overhang_triangles.size(); i += 3)
-            process_triangle(overhang_triangles[i], overhang_triangles[i + 1], overhang_triangles[i + 2]);
+        // The subtrees of the children of the root cube are independent, therefore they are densified in parallel.
+        // The resulting octree does not depend on the order in which the triangles are inserted.
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, 8, 1), [&](const tbb::blocked_range<size_t> &range) {
+            for (size_t child_idx = range.begin(); child_idx < range.end(); ++ child_idx) {
+                auto process_triangle = [octree_ptr, max_depth, diag_half, child_idx](const Vec3d &a, const Vec3d &b, const Vec3d &c) {
+                    octree_ptr->insert_triangle_into_child(
+                        a, b, c,
+                        octree_ptr->root_cube,
+                        BoundingBoxf3(octree_ptr->root_cube->center - diag_half, octree_ptr->root_cube->center + diag_half),
+                        max_depth, child_idx, octree_ptr->child_pools[child_idx]);
+                };
+                for (auto &tri : triangle_mesh.indices) {
+                    auto a = triangle_mesh.vertices[tri[0]].cast<double>();
+                    auto b = triangle_mesh.vertices[tri[1]].cast<double>();
+                    auto c = triangle_mesh.vertices[tri[2]].cast<double>();
+                    if (! support_overhangs_only || is_overhang_triangle(a, b, c, up_vector))
+                        process_triangle(a, b, c);
+                }
+                for (size_t i = 0; i < overhang_triangles.size(); i += 3)
+                    process_triangle(overhang_triangles[i], overhang_triangles[i + 1], overhang_triangles[i + 2]);
+            }
+        });
         {
             // Transform the octree to world coordinates to reduce computation when extracting infill lines.
             auto rot = transform_to_world().toRotationMatrix();
@@ -1521,7 +1533,7 @@ OctreePtr build_octree(
     return octree;
 }
 
-void Octree::insert_triangle(const Vec3d &a, const Vec3d &b, const Vec3d &c, Cube *current_cube, const BoundingBoxf3 &current_bbox, int depth)
+void Octree::insert_triangle_into_child(const Vec3d &a, const Vec3d &b, const Vec3d &c, Cube *current_cube, const BoundingBoxf3 &current_bbox, int depth, size_t i, boost::object_pool<Cube> &cube_pool)
 {
     assert(current_cube);
     assert(depth > 0);
@@ -1531,30 +1543,34 @@ void Octree::insert_triangle(const Vec3d &a, const Vec3d &b, const Vec3d &c, Cub
     // Squared radius of a sphere around the child cube.
     // const double r2_cube = Slic3r::sqr(0.5 * this->cubes_properties[depth].height + EPSILON);
 
-    for (size_t i = 0; i < 8; ++ i) {
-        const Vec3d &child_center_dir = child_centers[i];
-        // Calculate a slightly expanded bounding box of a child cube to cope with triangles touching a cube wall and other numeric errors.
-        // We will rather densify the octree a bit more than necessary instead of missing a triangle.
-        BoundingBoxf3 bbox;
-        for (int k = 0; k < 3; ++ k) {
-            if (child_center_dir[k] == -1.) {
-                bbox.min[k] = current_bbox.min[k];
-                bbox.max[k] = current_cube->center[k] + EPSILON;
-            } else {
-                bbox.min[k] = current_cube->center[k] - EPSILON;
-                bbox.max[k] = current_bbox.max[k];
-            }
-        }
-        Vec3d child_center = current_cube->center + (child_center_dir * (this->cubes_properties[depth].edge_length / 2.));
-        //if (dist2_to_triangle(a, b, c, child_center) < r2_cube) {
-        // dist2_to_triangle and r2_cube are commented out too.
-        if (triangle_AABB_intersects(a, b, c, bbox)) {
-            if (! current_cube->children[i])
-                current_cube->children[i] = this->pool.construct(child_center);
-            if (depth > 0)
-                this->insert_triangle(a, b, c, current_cube->children[i], bbox, depth);
+    const Vec3d &child_center_dir = child_centers[i];
+    // Calculate a slightly expanded bounding box of a child cube to cope with triangles touching a cube wall and other numeric errors.
+    // We will rather densify the octree a bit more than necessary instead of missing a triangle.
+    BoundingBoxf3 bbox;
+    for (int k = 0; k < 3; ++ k) {
+        if (child_center_dir[k] == -1.) {
+            bbox.min[k] = current_bbox.min[k];
+            bbox.max[k] = current_cube->center[k] + EPSILON;
+        } else {
+            bbox.min[k] = current_cube->center[k] - EPSILON;
+            bbox.max[k] = current_bbox.max[k];
         }
     }
+    Vec3d child_center = current_cube->center + (child_center_dir * (this->cubes_properties[depth].edge_length / 2.));
+    //if (dist2_to_triangle(a, b, c, child_center) < r2_cube) {
+    // dist2_to_triangle and r2_cube are commented out too.
+    if (triangle_AABB_intersects(a, b, c, bbox)) {
+        if (! current_cube->children[i])
+            current_cube->children[i] = cube_pool.construct(child_center);
+        if (depth > 0)
+            this->insert_triangle(a, b, c, current_cube->children[i], bbox, depth, cube_pool);
+    }
+}
+
+void Octree::insert_triangle(const Vec3d &a, const Vec3d &b, const Vec3d &c, Cube *current_cube, const BoundingBoxf3 &current_bbox, int depth, boost::object_pool<Cube> &cube_pool)
+{
+    for (size_t i = 0; i < 8; ++ i)
+        this->insert_triangle_into_child(a, b, c, current_cube, current_bbox, depth, i, cube_pool);
 }
 
 } // namespace FillAdaptive
@@ -15,6 +15,9 @@
 #include <iterator>
 #include <queue>
 
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
+
 #include "libslic3r/ClipperUtils.hpp"
 #include "libslic3r/ShortestPath.hpp"
 #include "libslic3r/Arachne/WallToolPaths.hpp"
@@ -321,20 +324,23 @@ ThickPolylines make_fill_polylines(
         vertical_lines.back().b = Point{vertical_lines.back().a.x(), y_max};
     }
 
+    // The vertical lines are clipped against the shared AABB tree of the walls independently of each other.
     std::vector<Lines> polygon_sections(n_vlines);
-    for (size_t i = 0; i < n_vlines; i++) {
-        const auto intersections = area_walls.intersections_with_line<true>(vertical_lines[i]);
-
-        for (int intersection_idx = 0; intersection_idx < int(intersections.size()) - 1; intersection_idx++) {
-            const auto &a = intersections[intersection_idx];
-            const auto &b = intersections[intersection_idx + 1];
-            if (area_walls.outside((a.first + b.first) / 2) < 0) {
-                if (std::abs(a.first.y() - b.first.y()) > scaled_spacing) {
-                    polygon_sections[i].emplace_back(a.first, b.first);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, n_vlines), [&](const tbb::blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i < range.end(); i++) {
+            const auto intersections = area_walls.intersections_with_line<true>(vertical_lines[i]);
+
+            for (int intersection_idx = 0; intersection_idx < int(intersections.size()) - 1; intersection_idx++) {
+                const auto &a = intersections[intersection_idx];
+                const auto &b = intersections[intersection_idx + 1];
+                if (area_walls.outside((a.first + b.first) / 2) < 0) {
+                    if (std::abs(a.first.y() - b.first.y()) > scaled_spacing) {
+                        polygon_sections[i].emplace_back(a.first, b.first);
+                    }
                 }
             }
         }
-    }
+    });
 
     if (stop_vibrations) {
         polygon_sections = filter_vibrating_extrusions(polygon_sections);
@@ -456,10 +462,16 @@ ThickPolylines make_fill_polylines(
         // svg.draw(vertical_lines, "black", scale_(0.1));
         // svg.Close();
 
-        for (ExPolygon &ex_poly : gaps_for_additional_filling) {
-            BoundingBox            ex_bb       = ex_poly.contour.bounding_box();
-            coord_t                loops_count = (std::max(ex_bb.size().x(), ex_bb.size().y()) + scaled_spacing - 1) / scaled_spacing;
-            Polygons               polygons    = to_polygons(ex_poly);
+        // All the gaps are filled by a single Arachne run, thus the skeletal trapezoidation (medial axis) is built once
+        // for the whole surface instead of once per gap.
+        if (!gaps_for_additional_filling.empty()) {
+            coord_t  loops_count = 0;
+            Polygons polygons;
+            for (const ExPolygon &ex_poly : gaps_for_additional_filling) {
+                const BoundingBox ex_bb = ex_poly.contour.bounding_box();
+                loops_count = std::max(loops_count, (std::max(ex_bb.size().x(), ex_bb.size().y()) + scaled_spacing - 1) / scaled_spacing);
+                polygons_append(polygons, to_polygons(ex_poly));
+            }
             Arachne::WallToolPaths wall_tool_paths(polygons, scaled_spacing, scaled_spacing, loops_count, 0, params.layer_height,
                                                    *fill->print_object_config, *fill->print_config);
             if (std::vector<Arachne::VariableWidthLines> loops = wall_tool_paths.getToolPaths(); !loops.empty()) {
@@ -482,7 +494,7 @@ ThickPolylines make_fill_polylines(
                         if (const bool extrusion_reverse = params.prefer_clockwise_movements ? !extrusion->is_contour() : extrusion->is_contour(); extrusion_reverse)
                             thick_polyline.reverse();
 
-                        thick_polyline.start_at_index(nearest_point_index(thick_polyline.points, ex_bb.min));
+                        thick_polyline.start_at_index(nearest_point_index(thick_polyline.points, BoundingBox(thick_polyline.points).min));
                         thick_polyline.clip_end(scaled_spacing * 0.5);
                     }
 
@@ -7,6 +7,7 @@
 #include <algorithm>
 #include <vector>
 #include <cstddef>
+#include <memory>
 
 #include "../ClipperUtils.hpp"
 #include "../ShortestPath.hpp"
@@ -112,6 +113,40 @@ static std::vector<Vec2d> make_one_period(double width, double scaleFactor, doub
     return points;
 }
 
+// One period of the waves depends on the layer z, on the scale and on the tolerance only, thus it is shared by all the surfaces
+// of a layer with the same density and spacing, including the surfaces of other objects printed at the same z.
+// The periods calculated last by this thread are kept, as the evaluation of f() with refinement up to tolerance is costly.
+static std::shared_ptr<const std::vector<Vec2d>> make_one_period_cached(double width, double scaleFactor, double z_cos, double z_sin, bool vertical, bool flip, double tolerance)
+{
+    struct Entry {
+        // Only the length of the period up to width is dependent on width.
+        double limit;
+        double scale_factor;
+        double z_cos;
+        double z_sin;
+        bool   vertical;
+        bool   flip;
+        double tolerance;
+        std::shared_ptr<const std::vector<Vec2d>> points;
+    };
+    static constexpr const size_t max_entries = 16;
+    thread_local std::vector<Entry> cache;
+
+    const double limit = std::min(2*M_PI, width);
+    if (auto it = std::find_if(cache.begin(), cache.end(), [&](const Entry &e) {
+            return e.limit == limit && e.scale_factor == scaleFactor && e.z_cos == z_cos && e.z_sin == z_sin && e.vertical == vertical && e.flip == flip && e.tolerance == tolerance;
+        }); it != cache.end()) {
+        // Move the entry to the front, the least recently used ones are dropped.
+        std::rotate(cache.begin(), it, it + 1);
+        return cache.front().points;
+    }
+    if (cache.size() == max_entries)
+        cache.pop_back();
+    cache.insert(cache.begin(), Entry{ limit, scaleFactor, z_cos, z_sin, vertical, flip, tolerance,
+        std::make_shared<const std::vector<Vec2d>>(make_one_period(width, scaleFactor, z_cos, z_sin, vertical, flip, tolerance)) });
+    return cache.front().points;
+}
+
 static Polylines make_gyroid_waves(double gridZ, double density_adjusted, double line_spacing, double width, double height)
 {
     const double scaleFactor = scale_(line_spacing) / density_adjusted;
@@ -137,18 +172,19 @@ static Polylines make_gyroid_waves(double gridZ, double density_adjusted, double
         std::swap(width,height);
     }
 
-    std::vector<Vec2d> one_period_odd = make_one_period(width, scaleFactor, z_cos, z_sin, vertical, flip, tolerance); // creates one period of the waves, so it doesn't have to be recalculated all the time
+    // creates one period of the waves, so it doesn't have to be recalculated all the time
+    std::shared_ptr<const std::vector<Vec2d>> one_period_odd  = make_one_period_cached(width, scaleFactor, z_cos, z_sin, vertical, flip, tolerance);
     flip = !flip;                                                                   // even polylines are a bit shifted
-    std::vector<Vec2d> one_period_even = make_one_period(width, scaleFactor, z_cos, z_sin, vertical, flip, tolerance);
+    std::shared_ptr<const std::vector<Vec2d>> one_period_even = make_one_period_cached(width, scaleFactor, z_cos, z_sin, vertical, flip, tolerance);
     Polylines result;
 
     for (double y0 = lower_bound; y0 < upper_bound + EPSILON; y0 += M_PI) {
         // creates odd polylines
-        result.emplace_back(make_wave(one_period_odd, width, height, y0, scaleFactor, z_cos, z_sin, vertical, flip));
+        result.emplace_back(make_wave(*one_period_odd, width, height, y0, scaleFactor, z_cos, z_sin, vertical, flip));
         // creates even polylines
         y0 += M_PI;
         if (y0 < upper_bound + EPSILON) {
-            result.emplace_back(make_wave(one_period_even, width, height, y0, scaleFactor, z_cos, z_sin, vertical, flip));
+            result.emplace_back(make_wave(*one_period_even, width, height, y0, scaleFactor, z_cos, z_sin, vertical, flip));
         }
     }
 
@@ -8,6 +8,9 @@
 #include <utility>
 #include <cassert>
 
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
+
 #include "TreeNode.hpp"
 #include "../../ClipperUtils.hpp"
 #include "../../Layer.hpp"
@@ -62,33 +65,46 @@ Generator::Generator(const PrintObject &print_object, const coordf_t fill_densit
     m_prune_length                                    = coord_t(layer_thickness * std::tan(lightning_infill_prune_angle));
     m_straightening_max_distance                      = coord_t(layer_thickness * std::tan(lightning_infill_straightening_angle));
 
-    generateInitialInternalOverhangs(print_object, throw_on_cancel_callback);
-    generateTrees(print_object, throw_on_cancel_callback);
+    std::vector<Polygons> infill_outlines = collectInfillOutlines(print_object, throw_on_cancel_callback);
+    generateInitialInternalOverhangs(infill_outlines, throw_on_cancel_callback);
+    generateTrees(print_object, std::move(infill_outlines), throw_on_cancel_callback);
 }
 
-void Generator::generateInitialInternalOverhangs(const PrintObject &print_object, const std::function<void()> &throw_on_cancel_callback)
+std::vector<Polygons> Generator::collectInfillOutlines(const PrintObject &print_object, const std::function<void()> &throw_on_cancel_callback)
 {
-    m_overhang_per_layer.resize(print_object.layers().size());
+    std::vector<Polygons> infill_outlines(print_object.layers().size(), Polygons());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, print_object.layers().size()),
+        [&print_object, &infill_outlines, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
+            for (size_t layer_id = range.begin(); layer_id < range.end(); ++ layer_id) {
+                throw_on_cancel_callback();
+                for (const LayerRegion *layerm : print_object.get_layer(int(layer_id))->regions())
+                    for (const Surface &surface : layerm->fill_surfaces())
+                        if (surface.surface_type == stInternal || surface.surface_type == stInternalVoid)
+                            append(infill_outlines[layer_id], to_polygons(surface.expolygon));
+                infill_outlines[layer_id] = union_(infill_outlines[layer_id]);
+            }
+        });
+    return infill_outlines;
+}
 
-    Polygons infill_area_above;
-    // Iterate from top to bottom, to subtract the overhang areas above from the overhang areas on the layer below, to get only overhang in the top layer where it is overhanging.
-    for (int layer_nr = int(print_object.layers().size()) - 1; layer_nr >= 0; --layer_nr) {
-        throw_on_cancel_callback();
-        Polygons infill_area_here;
-        for (const LayerRegion* layerm : print_object.get_layer(layer_nr)->regions())
-            for (const Surface& surface : layerm->fill_surfaces())
-                if (surface.surface_type == stInternal || surface.surface_type == stInternalVoid)
-                    append(infill_area_here, to_polygons(surface.expolygon));
-
-        infill_area_here = union_(infill_area_here);
-        // Remove the part of the infill area that is already supported by the walls.
-        Polygons overhang = diff(offset(infill_area_here, -float(m_wall_supporting_radius)), infill_area_above);
-        // Filter out unprintable polygons and near degenerated polygons (three almost collinear points and so).
-        overhang = opening(overhang, float(SCALED_EPSILON), float(SCALED_EPSILON));
-
-        m_overhang_per_layer[layer_nr] = overhang;
-        infill_area_above = std::move(infill_area_here);
-    }
+void Generator::generateInitialInternalOverhangs(const std::vector<Polygons> &infill_outlines, const std::function<void()> &throw_on_cancel_callback)
+{
+    m_overhang_per_layer.assign(infill_outlines.size(), Polygons());
+
+    // Subtract the infill area above from the infill area on the layer below, to get only overhang in the top layer where it is overhanging.
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, infill_outlines.size()),
+        [this, &infill_outlines, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
+            for (size_t layer_nr = range.begin(); layer_nr < range.end(); ++ layer_nr) {
+                throw_on_cancel_callback();
+                const Polygons &infill_area_here  = infill_outlines[layer_nr];
+                const Polygons  empty;
+                const Polygons &infill_area_above = layer_nr + 1 < infill_outlines.size() ? infill_outlines[layer_nr + 1] : empty;
+                // Remove the part of the infill area that is already supported by the walls.
+                Polygons overhang = diff(offset(infill_area_here, -float(m_wall_supporting_radius)), infill_area_above);
+                // Filter out unprintable polygons and near degenerated polygons (three almost collinear points and so).
+                m_overhang_per_layer[layer_nr] = opening(overhang, float(SCALED_EPSILON), float(SCALED_EPSILON));
+            }
+        });
 }
 
 const Layer& Generator::getTreesForLayer(const size_t& layer_id) const
@@ -97,23 +113,10 @@ const Layer& Generator::getTreesForLayer(const size_t& layer_id) const
     return m_lightning_layers[layer_id];
 }
 
-void Generator::generateTrees(const PrintObject &print_object, const std::function<void()> &throw_on_cancel_callback)
+void Generator::generateTrees(const PrintObject &print_object, std::vector<Polygons> &&infill_outlines, const std::function<void()> &throw_on_cancel_callback)
 {
     m_lightning_layers.resize(print_object.layers().size());
 
-    std::vector<Polygons> infill_outlines(print_object.layers().size(), Polygons());
-
-    // For-each layer from top to bottom:
-    for (int layer_id = int(print_object.layers().size()) - 1; layer_id >= 0; layer_id--) {
-        throw_on_cancel_callback();
-        for (const LayerRegion *layerm : print_object.get_layer(layer_id)->regions())
-            for (const Surface &surface : layerm->fill_surfaces())
-                if (surface.surface_type == stInternal || surface.surface_type == stInternalVoid)
-                    append(infill_outlines[layer_id], to_polygons(surface.expolygon));
-
-        infill_outlines[layer_id] = union_(infill_outlines[layer_id]);
-    }
-
     // For various operations its beneficial to quickly locate nearby features on the polygon:
     const size_t top_layer_id = print_object.layers().size() - 1;
     EdgeGrid::Grid outlines_locator(get_extents(infill_outlines[top_layer_id]).inflated(SCALED_EPSILON));
@@ -131,10 +134,14 @@ void Generator::generateTrees(const PrintObject &print_object, const std::functi
 
         current_lightning_layer.generateNewTrees(m_overhang_per_layer[layer_id], current_outlines, current_outlines_bbox, outlines_locator, m_supporting_radius, m_wall_supporting_radius, throw_on_cancel_callback);
         current_lightning_layer.reconnectRoots(to_be_reconnected_tree_roots, current_outlines, current_outlines_bbox, outlines_locator, m_supporting_radius, m_wall_supporting_radius);
+        // The overhangs of this layer are supported now, release them.
+        m_overhang_per_layer[layer_id] = Polygons();
 
         // Initialize trees for next lower layer from the current one.
-        if (layer_id == 0)
-            return;
+        if (layer_id == 0) {
+            current_lightning_layer.releaseTrees();
+            break;
+        }
 
         const Polygons &below_outlines      = infill_outlines[layer_id - 1];
         BoundingBox     below_outlines_bbox = get_extents(below_outlines).inflated(SCALED_EPSILON);
@@ -150,7 +157,13 @@ void Generator::generateTrees(const PrintObject &print_object, const std::functi
         std::vector<NodeSPtr>& lower_trees = m_lightning_layers[layer_id - 1].tree_roots;
         for (auto& tree : current_lightning_layer.tree_roots)
             tree->propagateToNextLayer(lower_trees, below_outlines, outlines_locator, m_prune_length, m_straightening_max_distance, locator_cell_size / 2);
+        // Only the layer below is being worked on from now on, keep just the lines of this layer
+        // to bound the memory held by the trees of the layers already processed.
+        current_lightning_layer.releaseTrees();
+        infill_outlines[layer_id] = Polygons();
     }
+    m_overhang_per_layer.clear();
+    m_overhang_per_layer.shrink_to_fit();
 }
 
 } // namespace Slic3r::FillLightning
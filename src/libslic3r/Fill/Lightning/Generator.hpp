@@ -72,12 +72,20 @@ protected:
      * only when support is generated. For this pattern, we also need to
      * generate overhang areas for the inside of the model.
      */
-    void generateInitialInternalOverhangs(const PrintObject &print_object, const std::function<void()> &throw_on_cancel_callback);
+    void generateInitialInternalOverhangs(const std::vector<Polygons> &infill_outlines, const std::function<void()> &throw_on_cancel_callback);
+
+    /*!
+     * Collect the internal infill areas of all layers, each united.
+     */
+    static std::vector<Polygons> collectInfillOutlines(const PrintObject &print_object, const std::function<void()> &throw_on_cancel_callback);
 
     /*!
      * Calculate the tree structure of all layers.
+     *
+     * The trees of a layer are replaced by their polylines once propagated to the layer below,
+     * the infill outlines are released as the layers are processed.
      */
-    void generateTrees(const PrintObject &print_object, const std::function<void()> &throw_on_cancel_callback);
+    void generateTrees(const PrintObject &print_object, std::vector<Polygons> &&infill_outlines, const std::function<void()> &throw_on_cancel_callback);
 
     float m_infill_extrusion_width;
 
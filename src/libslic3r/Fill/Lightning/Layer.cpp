@@ -442,14 +442,28 @@ static unsigned int moveInside(const Polygons& polygons, Point& from, int distan
 
 Polylines Layer::convertToLines(const Polygons& limit_to_outline, const coord_t line_overlap) const
 {
-    if (tree_roots.empty())
+    if (tree_roots.empty() && tree_polylines.empty())
         return {};
 
     Polylines result_lines;
     for (const auto &tree : tree_roots)
         tree->convertToPolylines(result_lines, line_overlap);
+    for (const Polylines &tree : tree_polylines) {
+        Polylines lines = tree;
+        Node::removeJunctionOverlap(lines, line_overlap);
+        append(result_lines, std::move(lines));
+    }
 
     return intersection_pl(result_lines, limit_to_outline);
 }
 
+void Layer::releaseTrees()
+{
+    tree_polylines.reserve(tree_polylines.size() + tree_roots.size());
+    for (const NodeSPtr &tree : tree_roots)
+        tree->convertToRawPolylines(tree_polylines.emplace_back());
+    tree_roots.clear();
+    tree_roots.shrink_to_fit();
+}
+
 } // namespace Slic3r::Lightning
@@ -42,6 +42,8 @@ class Layer
 {
 public:
     std::vector<NodeSPtr> tree_roots;
+    //! Polylines of the trees, one Polylines per tree, once the trees were released by \ref releaseTrees(.).
+    std::vector<Polylines> tree_polylines;
 
     void generateNewTrees
     (
@@ -88,6 +90,12 @@ public:
 
     Polylines convertToLines(const Polygons& limit_to_outline, coord_t line_overlap) const;
 
+    /*!
+     * Replace the trees by their polylines, once the trees have been propagated to the layer below and only their lines
+     * are needed. The polylines take a fraction of the memory of the tree nodes.
+     */
+    void releaseTrees();
+
     coord_t getWeightedDistance(const Point& boundary_loc, const Point& unsupported_location);
 
     void fillLocator(SparseNodeGrid& tree_node_locator, const BoundingBox& current_outlines_bbox);
@@ -344,12 +344,18 @@ coord_t Node::prune(const coord_t& pruning_distance)
 void Node::convertToPolylines(Polylines &output, const coord_t line_overlap) const
 {
     Polylines result;
-    result.emplace_back();
-    convertToPolylines(0, result);
+    convertToRawPolylines(result);
     removeJunctionOverlap(result, line_overlap);
     append(output, std::move(result));
 }
 
+void Node::convertToRawPolylines(Polylines &output) const
+{
+    size_t first_idx = output.size();
+    output.emplace_back();
+    convertToPolylines(first_idx, output);
+}
+
 void Node::convertToPolylines(size_t long_line_idx, Polylines &output) const
 {
     if (m_children.empty()) {
@@ -370,7 +376,7 @@ void Node::convertToPolylines(size_t long_line_idx, Polylines &output) const
     }
 }
 
-void Node::removeJunctionOverlap(Polylines &result_lines, const coord_t line_overlap) const
+void Node::removeJunctionOverlap(Polylines &result_lines, const coord_t line_overlap)
 {
     const coord_t reduction    = line_overlap;
     size_t        res_line_idx = 0;
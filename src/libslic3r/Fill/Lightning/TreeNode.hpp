@@ -250,6 +250,18 @@ public:
      */
     void convertToPolylines(Polylines &output, coord_t line_overlap) const;
 
+    /*!
+     * Convert the tree into polylines as \ref convertToPolylines(.), but without shortening the lines at the junctions.
+     *
+     * \param output all branches in this tree connected into polylines, to be finished by \ref removeJunctionOverlap(.)
+     */
+    void convertToRawPolylines(Polylines &output) const;
+
+    /*!
+     * Shorten the polylines of a single tree produced by \ref convertToRawPolylines(.) at the junctions by \p line_overlap.
+     */
+    static void removeJunctionOverlap(Polylines &polylines, coord_t line_overlap);
+
     /*! If this was ever a direct child of the root, it'll have a previous grounding location.
      *
      * This needs to be known when roots are reconnected, so that the last (higher) layer is supported by the next one.
@@ -269,8 +281,6 @@ protected:
      */
     void convertToPolylines(size_t long_line_idx, Polylines &output) const;
 
-    void removeJunctionOverlap(Polylines &polylines, coord_t line_overlap) const;
-
     bool m_is_root;
     Point m_p;
     std::weak_ptr<Node> m_parent;
@@ -17,6 +17,7 @@
 
 #include "3mf.hpp"
 
+#include <functional>
 #include <limits>
 #include <stdexcept>
 #include <optional>
@@ -35,6 +36,9 @@
 #include <boost/property_tree/xml_parser.hpp>
 namespace pt = boost::property_tree;
 
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
+
 #include <expat.h>
 #include <Eigen/Dense>
 #include <LocalesUtils.hpp>
@@ -533,6 +537,8 @@ namespace Slic3r {
         ~_3MF_Importer();
 
         bool load_model_from_file(const std::string& filename, Model& model, DynamicPrintConfig& config, ConfigSubstitutionContext& config_substitutions, bool check_version);
+        // Load the print config and the wipe tower placement only, without decompressing the geometry.
+        bool load_config_from_file(const std::string& filename, Model& model, DynamicPrintConfig& config, ConfigSubstitutionContext& config_substitutions);
         unsigned int version() const { return m_version; }
         boost::optional<Semver> prusaslicer_generator_version() const { return m_prusaslicer_generator_version; }
 
@@ -640,7 +646,12 @@ namespace Slic3r {
         bool _handle_start_config_metadata(const char** attributes, unsigned int num_attributes);
         bool _handle_end_config_metadata();
 
-        bool _generate_volumes(ModelObject& object, const Geometry& geometry, const ObjectMetadata::VolumeMetadataList& volumes, ConfigSubstitutionContext& config_substitutions);
+        // Split the geometry of an object into the meshes of its volumes. Only reads the importer state, thus it may be called
+        // for multiple objects in parallel. Returns an error message on failure.
+        std::string _create_volume_meshes(const Geometry& geometry, const ObjectMetadata::VolumeMetadataList& volumes, std::vector<TriangleMesh>& meshes) const;
+        // Add the volumes to the object, using the meshes precalculated by _create_volume_meshes() if provided.
+        bool _generate_volumes(ModelObject& object, const Geometry& geometry, const ObjectMetadata::VolumeMetadataList& volumes, ConfigSubstitutionContext& config_substitutions,
+            std::vector<TriangleMesh>* meshes = nullptr);
 
         // callbacks to parse the .rels file
         static void XMLCALL _handle_start_relationships_element(void *userData, const char *name, const char **attributes);
@@ -700,6 +711,49 @@ namespace Slic3r {
         return _load_model_from_file(filename, model, config, config_substitutions);
     }
 
+    bool _3MF_Importer::load_config_from_file(const std::string& filename, Model& model, DynamicPrintConfig& config, ConfigSubstitutionContext& config_substitutions)
+    {
+        clear_errors();
+        m_prusaslicer_generator_version.reset();
+        // The version is stored in the metadata of the model file, read just its header.
+        if (std::optional<Semver> version = is_project_3mf(filename).second; version)
+            m_prusaslicer_generator_version = *version;
+
+        mz_zip_archive archive;
+        mz_zip_zero_struct(&archive);
+        if (!open_zip_reader(&archive, filename)) {
+            add_error("Unable to open the file");
+            return false;
+        }
+        ScopeGuard guard([&archive]() { close_zip_reader(&archive); });
+
+        mz_zip_archive_file_stat stat;
+        mz_zip_archive_file_stat print_config_stat{ std::numeric_limits<mz_uint32>::max() };
+        bool has_wipe_tower_information = false;
+        for (mz_uint i = 0; i < mz_zip_reader_get_num_files(&archive); ++i) {
+            if (mz_zip_reader_file_stat(&archive, i, &stat)) {
+                std::string name(stat.m_filename);
+                std::replace(name.begin(), name.end(), '\\', '/');
+                if (boost::algorithm::iequals(name, PRINT_CONFIG_FILE)) {
+                    _extract_print_config_from_archive(archive, stat, config, config_substitutions, filename);
+                    print_config_stat = stat;
+                } else if (boost::algorithm::iequals(name, WIPE_TOWER_INFORMATION_FILE)) {
+                    _extract_wipe_tower_information_from_archive(archive, stat, model);
+                    has_wipe_tower_information = true;
+                }
+            }
+        }
+        if (! has_wipe_tower_information) {
+            // Project from before PS 2.9.0, see _load_model_from_file().
+            model.get_wipe_tower_vector().front().position.x() = 180;
+            model.get_wipe_tower_vector().front().position.y() = 140;
+            model.get_wipe_tower_vector().front().rotation = 0.;
+            if (print_config_stat.m_file_index != std::numeric_limits<mz_uint32>::max())
+                _extract_wipe_tower_information_from_archive_legacy(archive, print_config_stat, model);
+        }
+        return true;
+    }
+
     void _3MF_Importer::_destroy_xml_parser()
     {
         if (m_xml_parser != nullptr) {
@@ -920,7 +974,41 @@ namespace Slic3r {
             }
         }
 
+        // Volumes of the objects, which were not saved by PrusaSlicer: The entire geometry as a single volume.
+        std::map<PathId, ObjectMetadata::VolumeMetadataList> single_volumes;
+        auto object_volumes = [this, &single_volumes](const IdToModelObjectMap::value_type& object, const Geometry& geometry) -> const ObjectMetadata::VolumeMetadataList& {
+            if (IdToMetadataMap::iterator obj_metadata = m_objects_metadata.find(object.first.second); obj_metadata != m_objects_metadata.end())
+                return obj_metadata->second.volumes;
+            return single_volumes.insert({ object.first, ObjectMetadata::VolumeMetadataList(1, { 0, (unsigned int)geometry.triangles.size() - 1 }) }).first->second;
+        };
+
+        // Splitting the geometries into the meshes of the volumes and calculating their statistics is the most expensive part
+        // of loading a project with many objects, thus it is done for all the objects in parallel.
+        struct ObjectMeshes
+        {
+            const Geometry*                           geometry { nullptr };
+            const ObjectMetadata::VolumeMetadataList* volumes  { nullptr };
+            std::vector<TriangleMesh>                 meshes;
+            std::string                               error;
+        };
+        std::vector<ObjectMeshes> objects_meshes;
+        objects_meshes.reserve(m_objects.size());
+        for (const IdToModelObjectMap::value_type& object : m_objects) {
+            ObjectMeshes& object_meshes = objects_meshes.emplace_back();
+            if (IdToGeometryMap::const_iterator obj_geometry = m_geometries.find(object.first); obj_geometry != m_geometries.end()) {
+                object_meshes.geometry = &obj_geometry->second;
+                object_meshes.volumes  = &object_volumes(object, obj_geometry->second);
+            }
+        }
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, objects_meshes.size(), 1), [this, &objects_meshes](const tbb::blocked_range<size_t>& range) {
+            for (size_t i = range.begin(); i < range.end(); ++ i)
+                if (ObjectMeshes& object_meshes = objects_meshes[i]; object_meshes.geometry != nullptr)
+                    object_meshes.error = _create_volume_meshes(*object_meshes.geometry, *object_meshes.volumes, object_meshes.meshes);
+        });
+
+        size_t object_idx = 0;
         for (const IdToModelObjectMap::value_type& object : m_objects) {
+            ObjectMeshes& object_meshes = objects_meshes[object_idx ++];
             if (object.second >= int(m_model->objects.size())) {
                 add_error("Unable to find object");
                 return false;
@@ -954,9 +1042,6 @@ namespace Slic3r {
                 model_object->sla_drain_holes = std::move(obj_drain_holes->second);
             }
 
-            ObjectMetadata::VolumeMetadataList volumes;
-            ObjectMetadata::VolumeMetadataList* volumes_ptr = nullptr;
-
             IdToMetadataMap::iterator obj_metadata = m_objects_metadata.find(object.first.second);
             if (obj_metadata != m_objects_metadata.end()) {
                 // config data has been found, this model was saved using slic3r pe
@@ -968,21 +1053,14 @@ namespace Slic3r {
                     else
                         model_object->config.set_deserialize(metadata.key, metadata.value, config_substitutions);
                 }
-
-                // select object's detected volumes
-                volumes_ptr = &obj_metadata->second.volumes;
             }
-            else {
-                // config data not found, this model was not saved using slic3r pe
-
-                // add the entire geometry as the single volume to generate
-                volumes.emplace_back(0, (int)obj_geometry->second.triangles.size() - 1);
+            // otherwise config data not found, this model was not saved using slic3r pe, the entire geometry is a single volume
 
-                // select as volumes
-                volumes_ptr = &volumes;
+            if (! object_meshes.error.empty()) {
+                add_error(object_meshes.error);
+                return false;
             }
-
-            if (!_generate_volumes(*model_object, obj_geometry->second, *volumes_ptr, config_substitutions))
+            if (!_generate_volumes(*model_object, obj_geometry->second, *object_meshes.volumes, config_substitutions, &object_meshes.meshes))
                 return false;
 
             // Apply cut information for object if any was loaded
@@ -2538,51 +2616,29 @@ namespace Slic3r {
         return true;
     }
 
-    bool _3MF_Importer::_generate_volumes(ModelObject& object, const Geometry& geometry, const ObjectMetadata::VolumeMetadataList& volumes, ConfigSubstitutionContext& config_substitutions)
+    std::string _3MF_Importer::_create_volume_meshes(const Geometry& geometry, const ObjectMetadata::VolumeMetadataList& volumes, std::vector<TriangleMesh>& meshes) const
     {
-        if (!object.volumes.empty()) {
-            add_error("Found invalid volumes count");
-            return false;
-        }
-
         unsigned int geo_tri_count = (unsigned int)geometry.triangles.size();
-        unsigned int renamed_volumes_count = 0;
 
+        meshes.clear();
+        meshes.reserve(volumes.size());
         for (const ObjectMetadata::VolumeMetadata& volume_data : volumes) {
-            if (geo_tri_count <= volume_data.first_triangle_id || geo_tri_count <= volume_data.last_triangle_id || volume_data.last_triangle_id < volume_data.first_triangle_id) {
-                add_error("Found invalid triangle id");
-                return false;
-            }
-
-            Transform3d volume_matrix_to_object = Transform3d::Identity();
-            bool        has_transform 		    = false;
-            // extract the volume transformation from the volume's metadata, if present
-            for (const Metadata& metadata : volume_data.metadata) {
-                if (metadata.key == MATRIX_KEY) {
-                    volume_matrix_to_object = Slic3r::Geometry::transform3d_from_string(metadata.value);
-                    has_transform 			= ! volume_matrix_to_object.isApprox(Transform3d::Identity(), 1e-10);
-                    break;
-                }
-            }
+            if (geo_tri_count <= volume_data.first_triangle_id || geo_tri_count <= volume_data.last_triangle_id || volume_data.last_triangle_id < volume_data.first_triangle_id)
+                return "Found invalid triangle id";
 
             // splits volume out of imported geometry
             indexed_triangle_set its;
             its.indices.assign(geometry.triangles.begin() + volume_data.first_triangle_id, geometry.triangles.begin() + volume_data.last_triangle_id + 1);
-            const size_t triangles_count = its.indices.size();
-            if (triangles_count == 0) {
-                add_error("An empty triangle mesh found");
-                return false;
-            }
+            if (its.indices.empty())
+                return "An empty triangle mesh found";
 
             {
                 int min_id = its.indices.front()[0];
                 int max_id = min_id;
                 for (const Vec3i& face : its.indices) {
                     for (const int tri_id : face) {
-                        if (tri_id < 0 || tri_id >= int(geometry.vertices.size())) {
-                            add_error("Found invalid vertex id");
-                            return false;
-                        }
+                        if (tri_id < 0 || tri_id >= int(geometry.vertices.size()))
+                            return "Found invalid vertex id";
                         min_id = std::min(min_id, tri_id);
                         max_id = std::max(max_id, tri_id);
                     }
@@ -2602,7 +2658,48 @@ namespace Slic3r {
                 // Remove the vertices, that are not referenced by any face.
                 its_compactify_vertices(its, true);
 
-            TriangleMesh triangle_mesh(std::move(its), volume_data.mesh_stats);
+            meshes.emplace_back(std::move(its), volume_data.mesh_stats);
+        }
+
+        return {};
+    }
+
+    bool _3MF_Importer::_generate_volumes(ModelObject& object, const Geometry& geometry, const ObjectMetadata::VolumeMetadataList& volumes, ConfigSubstitutionContext& config_substitutions,
+        std::vector<TriangleMesh>* meshes)
+    {
+        if (!object.volumes.empty()) {
+            add_error("Found invalid volumes count");
+            return false;
+        }
+
+        std::vector<TriangleMesh> volume_meshes;
+        if (meshes == nullptr) {
+            if (std::string error = _create_volume_meshes(geometry, volumes, volume_meshes); ! error.empty()) {
+                add_error(error);
+                return false;
+            }
+            meshes = &volume_meshes;
+        }
+        assert(meshes->size() == volumes.size());
+
+        unsigned int renamed_volumes_count = 0;
+
+        for (size_t volume_idx = 0; volume_idx < volumes.size(); ++ volume_idx) {
+            const ObjectMetadata::VolumeMetadata& volume_data = volumes[volume_idx];
+
+            Transform3d volume_matrix_to_object = Transform3d::Identity();
+            bool        has_transform 		    = false;
+            // extract the volume transformation from the volume's metadata, if present
+            for (const Metadata& metadata : volume_data.metadata) {
+                if (metadata.key == MATRIX_KEY) {
+                    volume_matrix_to_object = Slic3r::Geometry::transform3d_from_string(metadata.value);
+                    has_transform 			= ! volume_matrix_to_object.isApprox(Transform3d::Identity(), 1e-10);
+                    break;
+                }
+            }
+
+            TriangleMesh& triangle_mesh   = (*meshes)[volume_idx];
+            const size_t  triangles_count = triangle_mesh.its.indices.size();
 
             if (m_version == 0) {
                 // if the 3mf was not produced by PrusaSlicer and there is only one instance,
@@ -2768,6 +2865,14 @@ namespace Slic3r {
             }
         };
 
+        // Mesh of an object formatted in advance to be written into the model file.
+        struct FormattedMesh
+        {
+            std::string xml;
+            VolumeToOffsetsMap volumes_offsets;
+            std::string error;
+        };
+
         typedef std::vector<BuildItem> BuildItemsList;
         typedef std::map<int, ObjectData> IdToObjectDataMap;
 
@@ -2776,6 +2881,8 @@ namespace Slic3r {
 
     public:
         bool save_model_to_file(const std::string& filename, Model& model, const DynamicPrintConfig* config, bool fullpath_sources, const ThumbnailData* thumbnail_data, bool zip64);
+        // Copy the src_filename project with its print config replaced, without recompressing the other entries.
+        bool save_config_to_file(const std::string& src_filename, const std::string& filename, const Model& model, const DynamicPrintConfig* config);
         static void add_transformation(std::stringstream &stream, const Transform3d &tr);
     private:
         void _publish(Model &model);
@@ -2784,8 +2891,14 @@ namespace Slic3r {
         bool _add_thumbnail_file_to_archive(mz_zip_archive& archive, const ThumbnailData& thumbnail_data);
         bool _add_relationships_file_to_archive(mz_zip_archive& archive);
         bool _add_model_file_to_archive(const std::string& filename, mz_zip_archive& archive, const Model& model, IdToObjectDataMap& objects_data);
-        bool _add_object_to_model_stream(mz_zip_writer_staged_context &context, unsigned int& object_id, ModelObject& object, BuildItemsList& build_items, VolumeToOffsetsMap& volumes_offsets);
-        bool _add_mesh_to_object_stream(mz_zip_writer_staged_context &context, ModelObject& object, VolumeToOffsetsMap& volumes_offsets);        
+        // If formatted_mesh is provided, its XML is written instead of formatting the mesh of the object.
+        bool _add_object_to_model_stream(mz_zip_writer_staged_context &context, unsigned int& object_id, ModelObject& object, BuildItemsList& build_items, VolumeToOffsetsMap& volumes_offsets,
+            FormattedMesh* formatted_mesh = nullptr);
+        bool _add_mesh_to_object_stream(mz_zip_writer_staged_context &context, ModelObject& object, VolumeToOffsetsMap& volumes_offsets);
+        // Format the mesh of the object into output_buffer. If flush is set, it is called to write out output_buffer whenever it grows large
+        // and at the end. Does not touch the exporter, thus the meshes of multiple objects may be formatted in parallel.
+        static bool _format_mesh(const ModelObject& object, VolumeToOffsetsMap& volumes_offsets, std::string& output_buffer,
+            const std::function<bool(std::string&)>& flush, std::string& error);
         bool _add_build_to_model_stream(std::stringstream& stream, const BuildItemsList& build_items);
         bool _add_cut_information_file_to_archive(mz_zip_archive& archive, Model& model);
         bool _add_layer_height_profile_file_to_archive(mz_zip_archive& archive, Model& model);
@@ -2806,6 +2919,53 @@ namespace Slic3r {
         return _save_model_to_file(filename, model, config, thumbnail_data);
     }
 
+    bool _3MF_Exporter::save_config_to_file(const std::string& src_filename, const std::string& filename, const Model& model, const DynamicPrintConfig* config)
+    {
+        clear_errors();
+
+        mz_zip_archive src_archive;
+        mz_zip_zero_struct(&src_archive);
+        if (!open_zip_reader(&src_archive, src_filename)) {
+            add_error("Unable to open the file");
+            return false;
+        }
+        ScopeGuard src_guard([&src_archive]() { close_zip_reader(&src_archive); });
+
+        mz_zip_archive archive;
+        mz_zip_zero_struct(&archive);
+        if (!open_zip_writer(&archive, filename)) {
+            add_error("Unable to open the file");
+            return false;
+        }
+        auto fail = [this, &archive, &filename](const char* error) {
+            add_error(error);
+            close_zip_writer(&archive);
+            boost::filesystem::remove(filename);
+            return false;
+        };
+
+        mz_zip_archive_file_stat stat;
+        for (mz_uint i = 0; i < mz_zip_reader_get_num_files(&src_archive); ++i) {
+            if (! mz_zip_reader_file_stat(&src_archive, i, &stat))
+                return fail("Unable to read the source archive");
+            std::string name(stat.m_filename);
+            std::replace(name.begin(), name.end(), '\\', '/');
+            // The compressed data of all the other entries are copied verbatim.
+            if (! boost::algorithm::iequals(name, PRINT_CONFIG_FILE) && ! mz_zip_writer_add_from_zip_reader(&archive, &src_archive, i))
+                return fail("Unable to copy the archive entry");
+        }
+
+        // Adds slic3r print config file ("Metadata/Slic3r_PE.config").
+        if (config != nullptr && ! _add_print_config_file_to_archive(archive, *config, model))
+            return fail("Unable to add print config file to archive");
+
+        if (!mz_zip_writer_finalize_archive(&archive))
+            return fail("Unable to finalize the archive");
+
+        close_zip_writer(&archive);
+        return true;
+    }
+
     bool _3MF_Exporter::_save_model_to_file(const std::string& filename, Model& model, const DynamicPrintConfig* config, const ThumbnailData* thumbnail_data)
     {
         mz_zip_archive archive;
@@ -3066,25 +3226,62 @@ namespace Slic3r {
         // Instance transformations, indexed by the 3MF object ID (which is a linear serialization of all instances of all ModelObjects).
         BuildItemsList build_items;
 
+        std::vector<ModelObject*> objects;
+        std::copy_if(model.objects.begin(), model.objects.end(), std::back_inserter(objects), [](const ModelObject* obj) { return obj != nullptr; });
+        auto triangles_count = [](const ModelObject* obj) {
+            size_t count = 0;
+            for (const ModelVolume* volume : obj->volumes)
+                if (volume != nullptr)
+                    count += volume->mesh().its.indices.size();
+            return count;
+        };
+
         // The object_id here is a one based identifier of the first instance of a ModelObject in the 3MF file, where
         // all the object instances of all ModelObjects are stored and indexed in a 1 based linear fashion.
         // Therefore the list of object_ids here may not be continuous.
         unsigned int object_id = 1;
-        for (ModelObject* obj : model.objects) {
-            if (obj == nullptr)
-                continue;
+        // Formatting the meshes together with their painting is the most expensive part of storing a project of many objects,
+        // thus the meshes of a batch of objects are formatted in parallel, then written in order. The number of triangles
+        // of a batch is limited to limit the memory of the formatted meshes, larger objects are formatted while being written.
+        static constexpr const size_t max_batch_triangles = 1 << 20;
+        for (size_t batch_begin = 0; batch_begin < objects.size();) {
+            size_t batch_end       = batch_begin;
+            size_t batch_triangles = 0;
+            for (; batch_end < objects.size(); ++ batch_end) {
+                size_t count = triangles_count(objects[batch_end]);
+                if (batch_end > batch_begin && batch_triangles + count > max_batch_triangles)
+                    break;
+                batch_triangles += count;
+            }
+            std::vector<FormattedMesh> formatted_meshes;
+            if (batch_triangles <= max_batch_triangles) {
+                formatted_meshes.assign(batch_end - batch_begin, {});
+                tbb::parallel_for(tbb::blocked_range<size_t>(batch_begin, batch_end, 1), [&objects, &formatted_meshes, batch_begin](const tbb::blocked_range<size_t>& range) {
+                    // The numeric locales are set per thread.
+                    CNumericLocalesSetter locales_setter;
+                    for (size_t i = range.begin(); i < range.end(); ++ i) {
+                        FormattedMesh& formatted_mesh = formatted_meshes[i - batch_begin];
+                        _format_mesh(*objects[i], formatted_mesh.volumes_offsets, formatted_mesh.xml, {}, formatted_mesh.error);
+                    }
+                });
+            }
 
-            // Index of an object in the 3MF file corresponding to the 1st instance of a ModelObject.
-            unsigned int curr_id = object_id;
-            IdToObjectDataMap::iterator object_it = objects_data.insert({ curr_id, ObjectData(obj) }).first;
-            // Store geometry of all ModelVolumes contained in a single ModelObject into a single 3MF indexed triangle set object.
-            // object_it->second.volumes_offsets will contain the offsets of the ModelVolumes in that single indexed triangle set.
-            // object_id will be increased to point to the 1st instance of the next ModelObject.
-            if (!_add_object_to_model_stream(context, object_id, *obj, build_items, object_it->second.volumes_offsets)) {
-                add_error("Unable to add object to archive");
-                mz_zip_writer_add_staged_finish(&context);
-                return false;
+            for (size_t i = batch_begin; i < batch_end; ++ i) {
+                ModelObject* obj = objects[i];
+                // Index of an object in the 3MF file corresponding to the 1st instance of a ModelObject.
+                unsigned int curr_id = object_id;
+                IdToObjectDataMap::iterator object_it = objects_data.insert({ curr_id, ObjectData(obj) }).first;
+                // Store geometry of all ModelVolumes contained in a single ModelObject into a single 3MF indexed triangle set object.
+                // object_it->second.volumes_offsets will contain the offsets of the ModelVolumes in that single indexed triangle set.
+                // object_id will be increased to point to the 1st instance of the next ModelObject.
+                if (!_add_object_to_model_stream(context, object_id, *obj, build_items, object_it->second.volumes_offsets,
+                        formatted_meshes.empty() ? nullptr : &formatted_meshes[i - batch_begin])) {
+                    add_error("Unable to add object to archive");
+                    mz_zip_writer_add_staged_finish(&context);
+                    return false;
+                }
             }
+            batch_begin = batch_end;
         }
 
         {
@@ -3113,7 +3310,8 @@ namespace Slic3r {
         return true;
     }
 
-    bool _3MF_Exporter::_add_object_to_model_stream(mz_zip_writer_staged_context &context, unsigned int& object_id, ModelObject& object, BuildItemsList& build_items, VolumeToOffsetsMap& volumes_offsets)
+    bool _3MF_Exporter::_add_object_to_model_stream(mz_zip_writer_staged_context &context, unsigned int& object_id, ModelObject& object, BuildItemsList& build_items, VolumeToOffsetsMap& volumes_offsets,
+        FormattedMesh* formatted_mesh)
     {
         std::stringstream stream;
         reset_stream(stream);
@@ -3129,8 +3327,20 @@ namespace Slic3r {
             if (id == 0) {
                 std::string buf = stream.str();
                 reset_stream(stream);
-                if ((! buf.empty() && ! mz_zip_writer_add_staged_data(&context, buf.data(), buf.size())) ||
-                    ! _add_mesh_to_object_stream(context, object, volumes_offsets)) {
+                bool mesh_added = buf.empty() || mz_zip_writer_add_staged_data(&context, buf.data(), buf.size());
+                if (mesh_added && formatted_mesh == nullptr)
+                    mesh_added = _add_mesh_to_object_stream(context, object, volumes_offsets);
+                else if (mesh_added) {
+                    if (! formatted_mesh->error.empty()) {
+                        add_error(formatted_mesh->error);
+                        mesh_added = false;
+                    } else if (! mz_zip_writer_add_staged_data(&context, formatted_mesh->xml.data(), formatted_mesh->xml.size())) {
+                        add_error("Error during writing or compression");
+                        mesh_added = false;
+                    } else
+                        volumes_offsets = std::move(formatted_mesh->volumes_offsets);
+                }
+                if (! mesh_added) {
                     add_error("Unable to add mesh to archive");
                     return false;
                 }
@@ -3179,16 +3389,28 @@ namespace Slic3r {
     bool _3MF_Exporter::_add_mesh_to_object_stream(mz_zip_writer_staged_context &context, ModelObject& object, VolumeToOffsetsMap& volumes_offsets)
     {
         std::string output_buffer;
+        std::string error;
+        if (! _format_mesh(object, volumes_offsets, output_buffer,
+                [&context](std::string &buf) { return mz_zip_writer_add_staged_data(&context, buf.data(), buf.size()) != 0; }, error)) {
+            add_error(error);
+            return false;
+        }
+        return true;
+    }
+
+    bool _3MF_Exporter::_format_mesh(const ModelObject& object, VolumeToOffsetsMap& volumes_offsets, std::string& output_buffer,
+        const std::function<bool(std::string&)>& flush_buffer, std::string& error)
+    {
         output_buffer += "   <";
         output_buffer += MESH_TAG;
         output_buffer += ">\n    <";
         output_buffer += VERTICES_TAG;
         output_buffer += ">\n";
 
-        auto flush = [this, &output_buffer, &context](bool force = false) {
-            if ((force && ! output_buffer.empty()) || output_buffer.size() >= 65536 * 16) {
-                if (! mz_zip_writer_add_staged_data(&context, output_buffer.data(), output_buffer.size())) {
-                    add_error("Error during writing or compression");
+        auto flush = [&output_buffer, &flush_buffer, &error](bool force = false) {
+            if (flush_buffer && ((force && ! output_buffer.empty()) || output_buffer.size() >= 65536 * 16)) {
+                if (! flush_buffer(output_buffer)) {
+                    error = "Error during writing or compression";
                     return false;
                 }
                 output_buffer.clear();
@@ -3236,7 +3458,7 @@ namespace Slic3r {
 
             const indexed_triangle_set &its = volume->mesh().its;
             if (its.vertices.empty()) {
-                add_error("Found invalid mesh");
+                error = "Found invalid mesh";
                 return false;
             }
 
@@ -4011,6 +4233,44 @@ bool load_3mf(
     return res;
 }
 
+bool load_3mf_config(
+    const char* path,
+    DynamicPrintConfig& config,
+    ConfigSubstitutionContext& config_substitutions,
+    Model* model,
+    boost::optional<Semver> &prusaslicer_generator_version
+)
+{
+    if (path == nullptr || model == nullptr)
+        return false;
+
+    // All import should use "C" locales for number formatting.
+    CNumericLocalesSetter locales_setter;
+    _3MF_Importer         importer;
+    bool res = importer.load_config_from_file(path, *model, config, config_substitutions);
+    importer.log_errors();
+    handle_legacy_project_loaded(config, importer.prusaslicer_generator_version());
+    prusaslicer_generator_version = importer.prusaslicer_generator_version();
+
+    return res;
+}
+
+bool store_3mf_config(const char* src_path, const char* path, const Model* model, const DynamicPrintConfig* config)
+{
+    // All export should use "C" locales for number formatting.
+    CNumericLocalesSetter locales_setter;
+
+    if (src_path == nullptr || path == nullptr || model == nullptr)
+        return false;
+
+    _3MF_Exporter exporter;
+    bool res = exporter.save_config_to_file(src_path, path, *model, config);
+    if (!res)
+        exporter.log_errors();
+
+    return res;
+}
+
 bool store_3mf(const char* path, Model* model, const DynamicPrintConfig* config, bool fullpath_sources, const ThumbnailData* thumbnail_data, bool zip64)
 {
     // All export should use "C" locales for number formatting.
@@ -59,6 +59,20 @@ namespace Slic3r {
         boost::optional<Semver> &prusaslicer_generator_version
     );
 
+    // Load just the print config of a 3mf project and the wipe tower placement into the given model. The geometry, which is
+    // the bulk of a project, is left compressed in the file, thus this is much faster than load_3mf() for tools changing just the settings.
+    extern bool load_3mf_config(
+        const char* path,
+        DynamicPrintConfig& config,
+        ConfigSubstitutionContext& config_substitutions,
+        Model* model,
+        boost::optional<Semver> &prusaslicer_generator_version
+    );
+
+    // Save a copy of the src_path 3mf project with its print config replaced by the given config. The other entries including
+    // the geometry are copied without being decompressed. The model provides the wipe tower placement loaded by load_3mf_config().
+    extern bool store_3mf_config(const char* src_path, const char* path, const Model* model, const DynamicPrintConfig* config);
+
     // Save the given model and the config data contained in the given Print into a 3mf file.
     // The model could be modified during the export process if meshes are not repaired or have no shared vertices
     extern bool store_3mf(const char* path, Model* model, const DynamicPrintConfig* config, bool fullpath_sources, const ThumbnailData* thumbnail_data = nullptr, bool zip64 = true);
@@ -26,11 +26,9 @@
 
 namespace Slic3r {
 
-bool load_obj(const char *path, TriangleMesh *meshptr)
+// Parse the OBJ file line by line with all its data, then convert the faces into an indexed triangle set.
+static bool load_obj_sequential(const char *path, indexed_triangle_set &its)
 {
-    if (meshptr == nullptr)
-        return false;
-    
     // Parse the OBJ file.
     ObjParser::ObjData data;
     if (! ObjParser::objparse(path, data)) {
@@ -63,7 +61,7 @@ bool load_obj(const char *path, TriangleMesh *meshptr)
     }
     
     // Convert ObjData into indexed triangle set.
-    indexed_triangle_set its;
+    its.clear();
     size_t num_vertices = data.coordinates.size() / 4;
     its.vertices.reserve(num_vertices);
     its.indices.reserve(num_faces + num_quads);
@@ -96,6 +94,19 @@ bool load_obj(const char *path, TriangleMesh *meshptr)
                     its.indices.emplace_back(indices[0], indices[2], indices[3]);
             }
         }
+    return true;
+}
+
+bool load_obj(const char *path, TriangleMesh *meshptr)
+{
+    if (meshptr == nullptr)
+        return false;
+
+    // Most files contain just vertices and triangles or quads, which are parsed in parallel. Anything else is left
+    // to the sequential parser, which also reports the errors.
+    indexed_triangle_set its;
+    if (! ObjParser::objparse_triangles(path, its) && ! load_obj_sequential(path, its))
+        return false;
 
     *meshptr = TriangleMesh(std::move(its));
     if (meshptr->empty()) {
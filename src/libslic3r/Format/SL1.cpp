@@ -278,7 +278,7 @@ std::unique_ptr<sla::RasterBase> SL1Archive::create_raster() const
 
 sla::RasterEncoder SL1Archive::get_encoder() const
 {
-    return sla::PNGRasterEncoder{};
+    return m_encoder;
 }
 
 static void write_thumbnail(Zipper &zipper, const ThumbnailData &data)
@@ -299,10 +299,7 @@ static void write_thumbnail(Zipper &zipper, const ThumbnailData &data)
     }
 }
 
-void SL1Archive::export_print(Zipper               &zipper,
-                              const SLAPrint       &print,
-                              const ThumbnailsList &thumbnails,
-                              const std::string    &prjname)
+std::string SL1Archive::export_header(Zipper &zipper, const SLAPrint &print, const std::string &prjname)
 {
     std::string project =
         prjname.empty() ?
@@ -316,29 +313,65 @@ void SL1Archive::export_print(Zipper               &zipper,
 
     fill_slicerconf(slicerconf, print);
 
-    try {
-        zipper.add_entry("config.ini");
-        zipper << to_ini(iniconf);
-        zipper.add_entry("prusaslicer.ini");
-        zipper << to_ini(slicerconf);
+    zipper.add_entry("config.ini");
+    zipper << to_ini(iniconf);
+    zipper.add_entry("prusaslicer.ini");
+    zipper << to_ini(slicerconf);
+
+    zipper.add_entry("config.json");
+    zipper << to_json(print, iniconf);
 
-        zipper.add_entry("config.json");
-        zipper << to_json(print, iniconf);
+    return project;
+}
 
-        size_t i = 0;
-        for (const sla::EncodedRaster &rst : m_layers) {
+void SL1Archive::export_layer(Zipper &zipper, const std::string &project, size_t idx, const std::string &extension,
+                              const Zipper::CompressedEntry &compressed)
+{
+    std::string imgname = project + string_printf("%.5d", int(idx)) + "." +
+                          extension;
 
-            std::string imgname = project + string_printf("%.5d", i++) + "." +
-                                  rst.extension();
+    zipper.add_entry(imgname, compressed);
+}
 
-            zipper.add_entry(imgname.c_str(), rst.data(), rst.size());
-        }
+void SL1Archive::export_thumbnails(Zipper &zipper, const ThumbnailsList &thumbnails)
+{
+    for (const ThumbnailData& data : thumbnails)
+        if (data.is_valid())
+            write_thumbnail(zipper, data);
 
-        for (const ThumbnailData& data : thumbnails)
-            if (data.is_valid())
-                write_thumbnail(zipper, data);
+    zipper.finalize();
+}
 
-        zipper.finalize();
+void SL1Archive::export_print(Zipper               &zipper,
+                              const SLAPrint       &print,
+                              const ThumbnailsList &thumbnails,
+                              const std::string    &prjname)
+{
+    try {
+        std::string project = export_header(zipper, print, prjname);
+
+        // Compress the layers in parallel, only adding them to the archive is serial.
+        using CompressedLayer = std::pair<size_t, Zipper::CompressedEntry>;
+        size_t next_idx = 0;
+        tbb::parallel_pipeline(2 * execution::max_concurrency(ex_tbb),
+            tbb::make_filter<void, size_t>(tbb::filter_mode::serial_in_order,
+                [this, &next_idx](tbb::flow_control &fc) -> size_t {
+                    if (next_idx == m_layers.size()) {
+                        fc.stop();
+                        return 0;
+                    }
+                    return next_idx ++;
+                }) &
+            tbb::make_filter<size_t, CompressedLayer>(tbb::filter_mode::parallel,
+                [this, &zipper](size_t idx) {
+                    return CompressedLayer{ idx, zipper.compress_entry(m_layers[idx].data(), m_layers[idx].size()) };
+                }) &
+            tbb::make_filter<CompressedLayer, void>(tbb::filter_mode::serial_in_order,
+                [this, &zipper, &project](CompressedLayer layer) {
+                    export_layer(zipper, project, layer.first, m_layers[layer.first].extension(), layer.second);
+                }));
+
+        export_thumbnails(zipper, thumbnails);
     } catch(std::exception& e) {
         BOOST_LOG_TRIVIAL(error) << e.what();
         // Rethrow the exception
@@ -351,11 +384,46 @@ void SL1Archive::export_print(const std::string     fname,
                               const ThumbnailsList &thumbnails,
                               const std::string    &prjname)
 {
-    Zipper zipper{fname, Zipper::FAST_COMPRESSION};
+    Zipper zipper{fname, zip_compression()};
 
     export_print(zipper, print, thumbnails, prjname);
 }
 
+void SL1Archive::draw_and_export_print(const std::string     fname,
+                                       const SLAPrint       &print,
+                                       size_t                layer_num,
+                                       const DrawLayerFn    &drawfn,
+                                       const CancelFn       &cancelfn,
+                                       const ThumbnailsList &thumbnails,
+                                       const std::string    &prjname)
+{
+    Zipper zipper{fname, zip_compression()};
+
+    try {
+        std::string project = export_header(zipper, print, prjname);
+
+        // The layers are written into the archive in order as they are rasterized,
+        // thus only a few encoded layers per worker thread are held in memory.
+        // The layers are compressed by the worker threads as well.
+        using CompressedLayer = std::pair<std::string, Zipper::CompressedEntry>;
+        stream_layers(layer_num, drawfn,
+            [&zipper](size_t, sla::EncodedRaster &&rst) {
+                return CompressedLayer{ rst.extension(), zipper.compress_entry(rst.data(), rst.size()) };
+            },
+            [&zipper, &project](size_t idx, CompressedLayer &&layer) { export_layer(zipper, project, idx, layer.first, layer.second); },
+            cancelfn, 2 * execution::max_concurrency(ex_tbb));
+
+        if (cancelfn())
+            return;
+
+        export_thumbnails(zipper, thumbnails);
+    } catch(std::exception& e) {
+        BOOST_LOG_TRIVIAL(error) << e.what();
+        // Rethrow the exception
+        throw;
+    }
+}
+
 } // namespace Slic3r
 
 // /////////////////////////////////////////////////////////////////////////////
@@ -453,7 +521,8 @@ namespace {
 ExPolygons rings_to_expolygons(const std::vector<marchsq::Ring> &rings,
                                double px_w, double px_h)
 {
-    auto polys = reserve_vector<ExPolygon>(rings.size());
+    ExPolygons polys;
+    polys.reserve(rings.size());
 
     for (const marchsq::Ring &ring : rings) {
         Polygon poly; Points &pts = poly.points;
@@ -503,7 +572,10 @@ std::vector<ExPolygons> extract_slices_from_sla_archive(
             png::ImageGreyscale img;
             png::ReadBuf        rb{arch.entries[i].buf.data(),
                             arch.entries[i].buf.size()};
-            if (!png::decode_png(rb, img)) return;
+            bool decoded = png::decode_png(rb, img);
+            // Release the compressed layer early, the whole archive may not fit into memory twice.
+            std::vector<uint8_t>().swap(arch.entries[i].buf);
+            if (!decoded) return;
 
             constexpr uint8_t isoval = 128;
             auto              rings = marchsq::execute(img, isoval, win);
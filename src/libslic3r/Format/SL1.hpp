@@ -16,7 +16,8 @@
 namespace Slic3r {
 
 class SL1Archive: public SLAArchiveWriter {
-    SLAPrinterConfig m_cfg;
+    SLAPrinterConfig   m_cfg;
+    sla::RasterEncoder m_encoder = sla::PNGRasterEncoder{};
     
 protected:
     std::unique_ptr<sla::RasterBase> create_raster() const override;
@@ -30,16 +31,36 @@ protected:
                       const ThumbnailsList &thumbnails,
                       const std::string    &projectname);
 
+    // Parts of export_print(), shared with the streamed export. Returns the project name.
+    static std::string export_header(Zipper &zipper, const SLAPrint &print, const std::string &projectname);
+    // The layer is compressed by zipper.compress_entry() beforehand, possibly on a worker thread.
+    static void        export_layer(Zipper &zipper, const std::string &project, size_t idx, const std::string &extension,
+                                    const Zipper::CompressedEntry &compressed);
+    static void        export_thumbnails(Zipper &zipper, const ThumbnailsList &thumbnails);
+
+    virtual Zipper::e_compression zip_compression() const { return Zipper::FAST_COMPRESSION; }
+
 public:
 
     SL1Archive() = default;
-    explicit SL1Archive(const SLAPrinterConfig &cfg): m_cfg(cfg) {}
-    explicit SL1Archive(SLAPrinterConfig &&cfg): m_cfg(std::move(cfg)) {}
+    // The encoder of the layer images, selected per archive format by SLAArchiveFormatRegistry.
+    explicit SL1Archive(const SLAPrinterConfig &cfg, sla::RasterEncoder encoder = sla::PNGRasterEncoder{})
+        : m_cfg(cfg), m_encoder(std::move(encoder)) {}
+    explicit SL1Archive(SLAPrinterConfig &&cfg, sla::RasterEncoder encoder = sla::PNGRasterEncoder{})
+        : m_cfg(std::move(cfg)), m_encoder(std::move(encoder)) {}
 
     void export_print(const std::string     fname,
                       const SLAPrint       &print,
                       const ThumbnailsList &thumbnails,
                       const std::string    &projectname = "") override;
+
+    void draw_and_export_print(const std::string     fname,
+                               const SLAPrint       &print,
+                               size_t                layer_num,
+                               const DrawLayerFn    &drawfn,
+                               const CancelFn       &cancelfn,
+                               const ThumbnailsList &thumbnails,
+                               const std::string    &projectname = "") override;
 };
 
 class SL1Reader: public SLAArchiveReader {
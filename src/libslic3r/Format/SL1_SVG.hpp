@@ -28,12 +28,12 @@ protected:
     std::unique_ptr<sla::RasterBase> create_raster() const override;
     sla::RasterEncoder get_encoder() const override;
 
-public:
+    // Export code is completely identical to SL1, only the compression level
+    // is elevated, as the SL1 has already compressed PNGs with deflate,
+    // but the svg is just text.
+    Zipper::e_compression zip_compression() const override { return Zipper::TIGHT_COMPRESSION; }
 
-    void export_print(const std::string     fname,
-                      const SLAPrint       &print,
-                      const ThumbnailsList &thumbnails,
-                      const std::string    &projectname = "") override;
+public:
 
     using SL1Archive::SL1Archive;
 };
@@ -29,8 +29,8 @@ class Registry {
                 "sl1",                      // main extension
                 {"sl1s", "zip"},            // extension aliases
 
-                // Writer factory
-                [] (const auto &cfg) { return std::make_unique<SL1Archive>(cfg); },
+                // Writer factory. Encoding the layers by the default PNG encoder took a good part of the export time.
+                [] (const auto &cfg) { return std::make_unique<SL1Archive>(cfg, sla::PNGRasterEncoderFast{}); },
 
                 // Reader factory
                 [] (const std::string &fname, SLAImportQuality quality, const ProgrFn &progr) {
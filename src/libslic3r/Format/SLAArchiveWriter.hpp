@@ -6,10 +6,16 @@
 #define SLAARCHIVE_HPP
 
 #include <stddef.h>
+#include <oneapi/tbb/parallel_pipeline.h>
+#include <algorithm>
 #include <vector>
 #include <memory>
 #include <string>
 #include <cstddef>
+#include <functional>
+#include <optional>
+#include <type_traits>
+#include <utility>
 
 #include "libslic3r/SLA/RasterBase.hpp"
 #include "libslic3r/Execution/ExecutionTBB.hpp"
@@ -31,6 +37,15 @@ protected:
 public:
     virtual ~SLAArchiveWriter() = default;
 
+    // Memory held by the encoded rasters drawn by draw_layers().
+    size_t memory_used() const
+    {
+        size_t out = m_layers.capacity() * sizeof(sla::EncodedRaster);
+        for (const sla::EncodedRaster &layer : m_layers)
+            out += layer.size();
+        return out;
+    }
+
     // Fn have to be thread safe: void(sla::RasterBase& raster, size_t lyrid);
     template<class Fn, class CancelFn, class EP = ExecutionTBB>
     void draw_layers(
@@ -53,12 +68,94 @@ public:
             execution::max_concurrency(ep));
     }
 
+    // Rasterize and encode the layers in parallel, but hand them over to sinkfn serially and in the order of the layers,
+    // as soon as all the layers below are done. At most max_in_flight layers are rasterized or waiting for sinkfn
+    // at the same time, thus unlike draw_layers() the memory consumption does not grow with the number of layers.
+    // The encoded layers are passed through preparefn on the worker threads first, thus the archive formats
+    // may compress the layers in parallel and leave just writing them to the serial sinkfn.
+    // Fn have to be thread safe: void(sla::RasterBase& raster, size_t lyrid);
+    // PrepareFn have to be thread safe: Prepared(size_t lyrid, sla::EncodedRaster &&raster);
+    // SinkFn: void(size_t lyrid, Prepared &&prepared);
+    template<class Fn, class PrepareFn, class SinkFn, class CancelFn>
+    void stream_layers(
+        size_t       layer_num,
+        Fn &&        drawfn,
+        PrepareFn && preparefn,
+        SinkFn &&    sinkfn,
+        CancelFn     cancelfn,
+        size_t       max_in_flight)
+    {
+        using Prepared      = std::decay_t<std::invoke_result_t<PrepareFn, size_t, sla::EncodedRaster&&>>;
+        using PreparedLayer = std::pair<size_t, std::optional<Prepared>>;
+        size_t next_idx = 0;
+        tbb::parallel_pipeline(std::max<size_t>(max_in_flight, 1),
+            tbb::make_filter<void, size_t>(tbb::filter_mode::serial_in_order,
+                [layer_num, &next_idx, &cancelfn](tbb::flow_control &fc) -> size_t {
+                    if (next_idx == layer_num || cancelfn()) {
+                        fc.stop();
+                        return 0;
+                    }
+                    return next_idx ++;
+                }) &
+            tbb::make_filter<size_t, PreparedLayer>(tbb::filter_mode::parallel,
+                [this, &drawfn, &preparefn, &cancelfn](size_t idx) {
+                    PreparedLayer out{ idx, std::nullopt };
+                    if (! cancelfn()) {
+                        auto rst = create_raster();
+                        drawfn(*rst, idx);
+                        out.second.emplace(preparefn(idx, rst->encode(get_encoder())));
+                    }
+                    return out;
+                }) &
+            tbb::make_filter<PreparedLayer, void>(tbb::filter_mode::serial_in_order,
+                [&sinkfn, &cancelfn](PreparedLayer layer) {
+                    if (layer.second && ! cancelfn())
+                        sinkfn(layer.first, std::move(*layer.second));
+                }));
+    }
+
+    // SinkFn: void(size_t lyrid, sla::EncodedRaster &&raster);
+    template<class Fn, class SinkFn, class CancelFn>
+    void stream_layers(
+        size_t     layer_num,
+        Fn &&      drawfn,
+        SinkFn &&  sinkfn,
+        CancelFn   cancelfn,
+        size_t     max_in_flight)
+    {
+        stream_layers(layer_num, std::forward<Fn>(drawfn),
+            [](size_t, sla::EncodedRaster &&rst) { return std::move(rst); },
+            std::forward<SinkFn>(sinkfn), cancelfn, max_in_flight);
+    }
+
     // Export the print into an archive using the provided filename.
     virtual void export_print(const std::string     fname,
                               const SLAPrint       &print,
                               const ThumbnailsList &thumbnails,
                               const std::string    &projectname = "") = 0;
 
+    using DrawLayerFn = std::function<void(sla::RasterBase&, size_t)>;
+    using CancelFn    = std::function<bool()>;
+
+    // Rasterize the layers during the export instead of keeping all of them
+    // encoded in memory by draw_layers() until export_print() is called.
+    // The default implementation draws all the layers first, archive formats
+    // able to write the layers in order override it to stream them.
+    virtual void draw_and_export_print(const std::string     fname,
+                                       const SLAPrint       &print,
+                                       size_t                layer_num,
+                                       const DrawLayerFn    &drawfn,
+                                       const CancelFn       &cancelfn,
+                                       const ThumbnailsList &thumbnails,
+                                       const std::string    &projectname = "")
+    {
+        draw_layers(layer_num, drawfn, cancelfn);
+        if (! cancelfn())
+            export_print(fname, print, thumbnails, projectname);
+        m_layers.clear();
+        m_layers.shrink_to_fit();
+    }
+
     // Factory method to create an archiver instance
     static std::unique_ptr<SLAArchiveWriter> create(
         const std::string &archtype, const SLAPrinterConfig &);
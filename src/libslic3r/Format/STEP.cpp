@@ -12,7 +12,14 @@
 #include <boost/filesystem.hpp>
 #include <boost/dll/runtime_symbol_info.hpp>
 #include <boost/log/trivial.hpp>
+#include <boost/nowide/fstream.hpp>
 
+#include <miniz.h>
+
+#include <algorithm>
+#include <list>
+#include <mutex>
+#include <optional>
 #include <string>
 #include <functional>
 
@@ -27,7 +34,7 @@
 namespace Slic3r {
 
 #if __APPLE__
-extern "C" bool load_step_internal(const char *path, OCCTResult* res);
+extern "C" bool load_step_internal(const char *path, OCCTResult* res, double linear_deflection, double angular_deflection);
 #endif
 
 LoadStepFn get_load_step_fn()
@@ -80,40 +87,132 @@ LoadStepFn get_load_step_fn()
     return load_step_fn;
 }
 
-bool load_step(const char *path, Model *model /*BBS:, ImportStepProgressFn proFn*/)
+namespace {
+
+struct TessellatedStepKey
+{
+    size_t   file_size;
+    uint32_t file_crc;
+    double   linear_deflection;
+    double   angular_deflection;
+
+    bool operator==(const TessellatedStepKey &rhs) const {
+        return file_size == rhs.file_size && file_crc == rhs.file_crc &&
+               linear_deflection == rhs.linear_deflection && angular_deflection == rhs.angular_deflection;
+    }
+};
+
+struct TessellatedStep
+{
+    TessellatedStepKey        key;
+    std::vector<std::string>  volume_names;
+    std::vector<TriangleMesh> meshes;
+};
+
+// Cache of the last tessellated STEP files, the most recently used first.
+class TessellatedStepCache
 {
-    OCCTResult occt_object;
+public:
+    static constexpr const size_t max_entries = 4;
+
+    bool find(const TessellatedStepKey &key, TessellatedStep &out) {
+        std::scoped_lock lock(m_mutex);
+        auto it = std::find_if(m_entries.begin(), m_entries.end(), [&key](const TessellatedStep &entry) { return entry.key == key; });
+        if (it == m_entries.end())
+            return false;
+        m_entries.splice(m_entries.begin(), m_entries, it);
+        out = m_entries.front();
+        return true;
+    }
 
-    LoadStepFn load_step_fn = get_load_step_fn();
+    void insert(const TessellatedStep &entry) {
+        std::scoped_lock lock(m_mutex);
+        m_entries.remove_if([&entry](const TessellatedStep &other) { return other.key == entry.key; });
+        m_entries.push_front(entry);
+        if (m_entries.size() > max_entries)
+            m_entries.pop_back();
+    }
 
-    if (!load_step_fn)
-        return false;
+private:
+    std::mutex                 m_mutex;
+    std::list<TessellatedStep> m_entries;
+};
 
-    load_step_fn(path, &occt_object);
+TessellatedStepCache& tessellated_step_cache()
+{
+    static TessellatedStepCache cache;
+    return cache;
+}
+
+// Identify a file by its content. Hashing the file is much faster than tessellating it.
+std::optional<TessellatedStepKey> tessellated_step_key(const char *path, double linear_deflection, double angular_deflection)
+{
+    boost::nowide::ifstream file(path, std::ios::binary);
+    if (! file.good())
+        return std::nullopt;
+    TessellatedStepKey key { 0, mz_uint32(MZ_CRC32_INIT), linear_deflection, angular_deflection };
+    std::vector<char> buffer(1 << 20);
+    while (file) {
+        file.read(buffer.data(), std::streamsize(buffer.size()));
+        if (size_t len = size_t(file.gcount()); len > 0) {
+            key.file_crc   = uint32_t(mz_crc32(key.file_crc, reinterpret_cast<const unsigned char*>(buffer.data()), len));
+            key.file_size += len;
+        }
+    }
+    if (file.bad())
+        return std::nullopt;
+    return key;
+}
+
+} // namespace
+
+bool load_step(const char *path, Model *model /*BBS:, ImportStepProgressFn proFn*/, double linear_deflection, double angular_deflection)
+{
+    std::optional<TessellatedStepKey> key = tessellated_step_key(path, linear_deflection, angular_deflection);
+    TessellatedStep tessellated;
+    if (! key || ! tessellated_step_cache().find(*key, tessellated)) {
+        OCCTResult occt_object;
+
+        LoadStepFn load_step_fn = get_load_step_fn();
+
+        if (!load_step_fn)
+            return false;
+
+        load_step_fn(path, &occt_object, linear_deflection, angular_deflection);
+
+        assert(! occt_object.volumes.empty());
+
+        for (OCCTVolume &volume : occt_object.volumes) {
+            tessellated.volume_names.emplace_back(std::move(volume.volume_name));
+            tessellated.meshes.emplace_back().from_facets(std::move(volume.facets));
+        }
+        if (key) {
+            tessellated.key = *key;
+            tessellated_step_cache().insert(tessellated);
+        }
+    }
 
-    assert(! occt_object.volumes.empty());
-    
-    assert(boost::algorithm::iends_with(occt_object.object_name, ".stp")
-        || boost::algorithm::iends_with(occt_object.object_name, ".step"));
-    occt_object.object_name.erase(occt_object.object_name.find("."));
-    assert(! occt_object.object_name.empty());
+    // The object name is the file name without the suffix, it is not cached as the same file may be stored under different names.
+    std::string object_name = boost::filesystem::path(path).filename().string();
+    assert(boost::algorithm::iends_with(object_name, ".stp")
+        || boost::algorithm::iends_with(object_name, ".step"));
+    object_name.erase(object_name.find("."));
+    assert(! object_name.empty());
 
 
     ModelObject* new_object = model->add_object();
     new_object->input_file = path;
-    if (new_object->volumes.size() == 1 && ! occt_object.volumes.front().volume_name.empty())
+    if (new_object->volumes.size() == 1 && ! tessellated.volume_names.front().empty())
         new_object->name = new_object->volumes.front()->name;
     else
-        new_object->name = occt_object.object_name;
+        new_object->name = object_name;
 
-    for (size_t i = 0; i < occt_object.volumes.size(); ++i) {
-        TriangleMesh triangle_mesh;
-        triangle_mesh.from_facets(std::move(occt_object.volumes[i].facets));
-        ModelVolume* new_volume = new_object->add_volume(std::move(triangle_mesh));
+    for (size_t i = 0; i < tessellated.meshes.size(); ++i) {
+        ModelVolume* new_volume = new_object->add_volume(std::move(tessellated.meshes[i]));
 
-        new_volume->name = occt_object.volumes[i].volume_name.empty()
+        new_volume->name = tessellated.volume_names[i].empty()
                        ? std::string("Part") + std::to_string(i + 1)
-                       : occt_object.volumes[i].volume_name;
+                       : tessellated.volume_names[i];
         new_volume->source.input_file = path;
         new_volume->source.object_idx = (int)model->objects.size() - 1;
         new_volume->source.volume_idx = (int)new_object->volumes.size() - 1;
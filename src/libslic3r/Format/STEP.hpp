@@ -15,8 +15,16 @@ class Model;
 
 //typedef std::function<void(int load_stage, int current, int total, bool& cancel)> ImportStepProgressFn;
 
+// Default maximum distance of the tessellation from the surface in millimeters
+// and the maximum angle between the normals of the neighbor triangles in radians.
+constexpr const double STEP_DEFAULT_LINEAR_DEFLECTION  = 0.005;
+constexpr const double STEP_DEFAULT_ANGULAR_DEFLECTION = 1.;
+
 // Load a step file into a provided model.
-extern bool load_step(const char *path_str, Model *model /*LMBBS:, ImportStepProgressFn proFn = nullptr*/);
+// The tessellated solids of the last loaded files are cached by the file content and the deflections,
+// thus loading the same file again does not tessellate it again.
+extern bool load_step(const char *path_str, Model *model /*LMBBS:, ImportStepProgressFn proFn = nullptr*/,
+    double linear_deflection = STEP_DEFAULT_LINEAR_DEFLECTION, double angular_deflection = STEP_DEFAULT_ANGULAR_DEFLECTION);
 
 }; // namespace Slic3r
 
@@ -10,6 +10,21 @@
 #include <string>
 #include <utility>
 #include <cstring>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+#include <vector>
+
+#include <boost/endian/conversion.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <boost/log/trivial.hpp>
+
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
+
+#include <fast_float.h>
 
 #include "libslic3r/Model.hpp"
 #include "libslic3r/TriangleMesh.hpp"
@@ -23,10 +38,174 @@
 
 namespace Slic3r {
 
+namespace {
+
+// Test for a binary STL file the same way as admesh does: any of the 128 bytes following the label is not ASCII.
+bool is_binary_stl(const char *begin, const char *end)
+{
+    if (size_t(end - begin) < size_t(HEADER_SIZE) + 128)
+        // admesh reads these bytes to detect the file type.
+        return false;
+    for (const char *c = begin + size_t(HEADER_SIZE); c < begin + size_t(HEADER_SIZE) + 128; ++ c)
+        if (static_cast<unsigned char>(*c) > 127)
+            return true;
+    return false;
+}
+
+bool parse_binary_stl(const char *begin, const char *end, std::vector<Vec3f> &corners)
+{
+    const size_t size = size_t(end - begin);
+    if ((size - size_t(HEADER_SIZE)) % size_t(SIZEOF_STL_FACET) != 0 || size < size_t(STL_MIN_FILE_SIZE))
+        return false;
+    // Number of facets is derived from the file size, as admesh does. The number in the header is not trusted.
+    const size_t num_facets = (size - size_t(HEADER_SIZE)) / size_t(SIZEOF_STL_FACET);
+    corners.assign(num_facets * 3, Vec3f::Zero());
+    bool valid = true;
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_facets, 4096),
+        [begin, &corners, &valid](const tbb::blocked_range<size_t> &range) {
+            for (size_t i = range.begin(); i < range.end(); ++ i) {
+                // Skip the normal.
+                const char *facet = begin + size_t(HEADER_SIZE) + i * size_t(SIZEOF_STL_FACET) + 3 * sizeof(float);
+                for (size_t j = 0; j < 3; ++ j) {
+                    Vec3f &pt = corners[i * 3 + j];
+                    for (size_t k = 0; k < 3; ++ k) {
+                        uint32_t bits;
+                        memcpy(&bits, facet + (j * 3 + k) * sizeof(float), sizeof(float));
+                        bits = boost::endian::little_to_native(bits);
+                        memcpy(&pt[k], &bits, sizeof(float));
+                    }
+                    if (! std::isfinite(pt.x()) || ! std::isfinite(pt.y()) || ! std::isfinite(pt.z()))
+                        valid = false;
+                }
+            }
+        });
+    return valid;
+}
+
+// Parse an ASCII STL file. Text following the endloop / endfacet keywords and multiple solids are tolerated the same
+// way as by admesh, the facet normals are ignored.
+bool parse_ascii_stl(const char *begin, const char *end, std::vector<Vec3f> &corners)
+{
+    auto is_space  = [](char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f'; };
+    const char *c = begin;
+    auto skip_spaces = [&c, end, &is_space]() { for (; c < end && is_space(*c); ++ c) ; };
+    // Old Mac files use CR only as a line separator.
+    auto skip_line   = [&c, end]() { for (; c < end && *c != '\n' && *c != '\r'; ++ c) ; };
+    auto next_token  = [&c, end, &is_space, &skip_spaces]() {
+        skip_spaces();
+        const char *token = c;
+        for (; c < end && ! is_space(*c); ++ c) ;
+        return std::string_view(token, c - token);
+    };
+    auto parse_float = [&c, end, &skip_spaces](float &out) {
+        skip_spaces();
+        if (c < end && *c == '+')
+            ++ c;
+        auto [ptr, ec] = fast_float::from_chars(c, end, out);
+        if (ec != std::errc() || ! std::isfinite(out))
+            return false;
+        c = ptr;
+        return true;
+    };
+
+    corners.clear();
+    // Number of vertices of the current facet, -1 outside of a facet.
+    int num_vertices = -1;
+    for (;;) {
+        std::string_view token = next_token();
+        if (token.empty())
+            break;
+        if (token == "solid" || token == "endsolid") {
+            // The name may contain spaces.
+            skip_line();
+        } else if (token == "facet") {
+            if (num_vertices != -1 || next_token() != "normal")
+                return false;
+            // The normal may be mangled, for example contain "not a number" values. It is not needed anyway.
+            for (int i = 0; i < 3; ++ i)
+                if (next_token().empty())
+                    return false;
+            num_vertices = 0;
+        } else if (token == "outer") {
+            if (num_vertices != 0 || next_token() != "loop")
+                return false;
+        } else if (token == "vertex") {
+            Vec3f pt;
+            if (num_vertices < 0 || num_vertices >= 3 || ! parse_float(pt.x()) || ! parse_float(pt.y()) || ! parse_float(pt.z()))
+                return false;
+            corners.emplace_back(pt);
+            ++ num_vertices;
+        } else if (token == "endloop") {
+            skip_line();
+        } else if (token == "endfacet") {
+            if (num_vertices != 3)
+                return false;
+            num_vertices = -1;
+            skip_line();
+        } else
+            return false;
+    }
+    return num_vertices == -1 && ! corners.empty();
+}
+
+} // namespace
+
+bool load_stl_indexed(const char *path, indexed_triangle_set &its)
+{
+    its.clear();
+    boost::iostreams::mapped_file_source mapping;
+    try {
+        // boost::filesystem::path is UTF-8 aware, see boost::nowide::nowide_filesystem().
+        const boost::filesystem::path fpath(path);
+        if (boost::filesystem::file_size(fpath) > 0)
+            mapping.open(fpath);
+    } catch (const std::exception &ex) {
+        BOOST_LOG_TRIVIAL(debug) << "load_stl_indexed: failed to memory map " << path << ": " << ex.what();
+        return false;
+    }
+    if (! mapping.is_open())
+        return false;
+
+    const char *begin = mapping.data();
+    const char *end   = begin + mapping.size();
+    std::vector<Vec3f> corners;
+    if (! (is_binary_stl(begin, end) ? parse_binary_stl(begin, end, corners) : parse_ascii_stl(begin, end, corners)))
+        return false;
+    if (corners.size() >= size_t(std::numeric_limits<int>::max()))
+        return false;
+    // Weld the corners of the facets with exactly the same coordinates into shared vertices, numbered by their first occurrence.
+    its.indices.assign(corners.size() / 3, stl_triangle_vertex_indices::Zero());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, its.indices.size(), 4096), [&its](const tbb::blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i < range.end(); ++ i)
+            its.indices[i] = stl_triangle_vertex_indices(int(i * 3), int(i * 3 + 1), int(i * 3 + 2));
+    });
+    its.vertices = std::move(corners);
+    its_merge_vertices(its);
+    return true;
+}
+
+// The STL file is loaded directly if the loaded mesh is a single closed and consistently oriented part with
+// positive volume and no degenerate facets. admesh would not repair anything on such a mesh.
+static bool load_stl_without_repair(const char *path, TriangleMesh &mesh)
+{
+    indexed_triangle_set its;
+    if (! load_stl_indexed(path, its) || its.indices.empty())
+        return false;
+    for (const stl_triangle_vertex_indices &face : its.indices)
+        if (face(0) == face(1) || face(1) == face(2) || face(2) == face(0))
+            return false;
+    TriangleMesh loaded(std::move(its));
+    const TriangleMeshStats &stats = loaded.stats();
+    if (stats.open_edges != 0 || stats.number_of_parts != 1 || ! (stats.volume > 0))
+        return false;
+    mesh = std::move(loaded);
+    return true;
+}
+
 bool load_stl(const char *path, Model *model, const char *object_name_in)
 {
     TriangleMesh mesh;
-    if (! mesh.ReadSTLFile(path)) {
+    if (! load_stl_without_repair(path, mesh) && ! mesh.ReadSTLFile(path)) {
 //    die "Failed to open $file\n" if !-e $path;
         return false;
     }
@@ -10,6 +10,8 @@
 #ifndef slic3r_Format_STL_hpp_
 #define slic3r_Format_STL_hpp_
 
+struct indexed_triangle_set;
+
 namespace Slic3r {
 
 class TriangleMesh;
@@ -19,6 +21,11 @@ class Model;
 // Load an STL file into a provided model.
 extern bool load_stl(const char *path, Model *model, const char *object_name = nullptr);
 
+// Read a binary or ASCII STL file directly into an indexed triangle set, welding the vertices of exactly the same
+// coordinates. The file is memory mapped, binary facets are parsed and the vertices are welded in parallel.
+// Unlike TriangleMesh::ReadSTLFile() no repair is performed. Returns false if the file could not be read or parsed.
+extern bool load_stl_indexed(const char *path, indexed_triangle_set &its);
+
 extern bool store_stl(const char *path, TriangleMesh *mesh, bool binary);
 extern bool store_stl(const char *path, ModelObject *model_object, bool binary);
 extern bool store_stl(const char *path, Model *model, bool binary);
@@ -7,6 +7,7 @@
 #include "libslic3r/miniz_extension.hpp"
 #include "libslic3r/Exception.hpp"
 #include "libslic3r/PrintConfig.hpp"
+#include "libslic3r/Execution/ExecutionTBB.hpp"
 
 #include <boost/property_tree/ini_parser.hpp>
 #include <boost/filesystem/path.hpp>
@@ -68,6 +69,9 @@ ZipperArchive read_zipper_archive(const std::string &zipfname,
 
     mz_uint num_entries = mz_zip_reader_get_num_files(&zip.arch);
 
+    // Entries to be extracted into arch.entries with their lower case names.
+    std::vector<std::pair<std::string, mz_uint>> selected;
+
     for (mz_uint i = 0; i < num_entries; ++i) {
         mz_zip_archive_file_stat entry;
 
@@ -97,17 +101,32 @@ ZipperArchive read_zipper_archive(const std::string &zipfname,
                 continue;
             }
 
-            auto it = std::lower_bound(
-                arch.entries.begin(), arch.entries.end(),
-                EntryBuffer{{}, name},
-                [](const EntryBuffer &r1, const EntryBuffer &r2) {
-                    return std::less<std::string>()(r1.fname, r2.fname);
-                });
-
-            arch.entries.insert(it, read_entry(entry, zip, name));
+            selected.emplace_back(std::move(name), i);
         }
     }
 
+    std::stable_sort(selected.begin(), selected.end(),
+                     [](const auto &e1, const auto &e2) { return e1.first < e2.first; });
+    arch.entries.resize(selected.size());
+
+    // The entries (e.g. the PNG layers of an SLA archive) are decompressed in parallel.
+    // Reading of a miniz archive is not thread safe, thus each chunk of entries is read
+    // through its own reader of the zip file.
+    size_t num_chunks = std::min(selected.size(), execution::max_concurrency(ex_tbb));
+    execution::for_each(
+        ex_tbb, size_t(0), num_chunks,
+        [&zipfname, &selected, &arch, num_chunks](size_t chunk) {
+            const size_t begin = selected.size() * chunk / num_chunks;
+            const size_t end   = selected.size() * (chunk + 1) / num_chunks;
+            Arch         chunk_zip(zipfname);
+            for (size_t i = begin; i < end; ++i) {
+                mz_zip_archive_file_stat entry;
+                if (!mz_zip_reader_file_stat(&chunk_zip.arch, selected[i].second, &entry))
+                    throw Slic3r::FileIOError(chunk_zip.get_errorstr());
+                arch.entries[i] = read_entry(entry, chunk_zip, selected[i].first);
+            }
+        });
+
     return arch;
 }
 
@@ -2,10 +2,17 @@
 ///|/
 ///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
 ///|/
+#include <boost/filesystem/operations.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
 #include <boost/log/trivial.hpp>
 #include <boost/nowide/cstdio.hpp>
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
 #include <LocalesUtils.hpp>
 #include <fast_float.h>
+#include <algorithm>
+#include <charconv>
+#include <limits>
 #include <new>
 #include <system_error>
 #include <utility>
@@ -14,6 +21,8 @@
 #include <cstdlib>
 #include <cstring>
 
+#include "admesh/stl.h"
+
 #include "objparser.hpp"
 
 namespace ObjParser {
@@ -432,6 +441,179 @@ bool objparse(std::istream &stream, ObjData &data)
     return true;
 }
 
+// Vertex positions and faces of a chunk of lines of an OBJ file.
+struct ObjChunkTriangles
+{
+	std::vector<stl_vertex>  vertices;
+	// Three vertex indices per triangle. The relative (negative) references are resolved against the vertices of this chunk.
+	std::vector<int>         indices;
+	// Positions in indices referencing vertices relative to the end of the chunk, to be offset by the vertices of the preceding chunks.
+	std::vector<size_t>      relative;
+	bool                     valid { true };
+};
+
+// Parse the lines <begin, end) of an OBJ file, see obj_parseline() for the syntax. Returns false if a line is not parsed
+// exactly the same way as by obj_parseline() or if it contains a non triangular non quad face.
+static bool obj_parse_chunk_triangles(const char *begin, const char *end, ObjChunkTriangles &chunk)
+{
+	auto is_ws  = [](char c) { return c == ' ' || c == '\t'; };
+	auto is_eol = [](char c) { return c == '\r' || c == '\n'; };
+	for (const char *line = begin; line < end;) {
+		const char *line_end = line;
+		while (line_end < end && ! is_eol(*line_end))
+			++ line_end;
+		const char *c = line;
+		auto eat_ws = [&c, line_end, &is_ws]() { while (c < line_end && is_ws(*c)) ++ c; };
+		auto parse_float = [&c, line_end](float &out) {
+			double val = 0.;
+			auto [pend, ec] = fast_float::from_chars(c, line_end, val);
+			if (pend == c || ec == std::errc::result_out_of_range)
+				return false;
+			c   = pend;
+			out = float(val);
+			return true;
+		};
+		eat_ws();
+		if (c < line_end && *c == 'v' && c + 1 < line_end && is_ws(c[1])) {
+			// v x y z [w], extra data following is ignored.
+			++ c;
+			stl_vertex pt;
+			for (int i = 0; i < 3; ++ i) {
+				eat_ws();
+				if (! parse_float(pt[i]) || (i < 2 && (c == line_end || ! is_ws(*c))) || (c < line_end && ! is_ws(*c)))
+					return false;
+			}
+			eat_ws();
+			if (float w; c < line_end && (! parse_float(w) || (c < line_end && ! is_ws(*c))))
+				return false;
+			chunk.vertices.emplace_back(pt);
+		} else if (c < line_end && *c == 'f') {
+			// f v1[/vt1][/vn1] v2[/vt2][/vn2] v3[/vt3][/vn3] [v4[/vt4][/vn4]]
+			++ c;
+			int  idx[4];
+			bool relative[4];
+			int  cnt = 0;
+			eat_ws();
+			while (c < line_end) {
+				if (cnt == 4)
+					return false;
+				int v = 0;
+				auto [pend, ec] = std::from_chars(c, line_end, v);
+				if (pend == c || ec != std::errc() || v == 0)
+					return false;
+				c = pend;
+				// Skip the texture and normal indices, the texture index may be missing.
+				for (int i = 0; i < 2 && c < line_end && *c == '/'; ++ i) {
+					if (++ c < line_end && *c == '/' && i == 0)
+						continue;
+					const char *num = c;
+					if (c < line_end && *c == '-')
+						++ c;
+					const char *digits = c;
+					while (c < line_end && *c >= '0' && *c <= '9')
+						++ c;
+					if (c == digits || c == num)
+						return false;
+				}
+				if (c < line_end && ! is_ws(*c))
+					return false;
+				relative[cnt] = v < 0;
+				idx[cnt ++]   = v < 0 ? v + int(chunk.vertices.size()) : v - 1;
+				eat_ws();
+			}
+			if (cnt < 3)
+				return false;
+			// Triangulate a quad the same way as load_obj() does.
+			auto add_triangle = [&chunk, &idx, &relative](int a, int b, int c) {
+				for (int i : { a, b, c }) {
+					if (relative[i])
+						chunk.relative.emplace_back(chunk.indices.size());
+					chunk.indices.emplace_back(idx[i]);
+				}
+			};
+			add_triangle(0, 1, 2);
+			if (cnt == 4)
+				add_triangle(0, 2, 3);
+		} else if (c < line_end && *c == 'v' && c + 1 < line_end && (c[1] == 't' || c[1] == 'n' || c[1] == 'p')) {
+			// Texture coordinates, normals and parameters are not needed.
+		} else if (c < line_end && *c == 'v')
+			return false;
+		// Comments, object, group, smoothing group and material definitions do not modify the geometry.
+		line = line_end;
+		while (line < end && is_eol(*line))
+			++ line;
+	}
+	return true;
+}
+
+bool objparse_triangles(const char *path, indexed_triangle_set &its)
+{
+	its.clear();
+	boost::iostreams::mapped_file_source mapping;
+	try {
+		const boost::filesystem::path fpath(path);
+		if (boost::filesystem::file_size(fpath) > 0)
+			mapping.open(fpath);
+	} catch (const std::exception &ex) {
+		BOOST_LOG_TRIVIAL(debug) << "ObjParser: failed to memory map " << path << ": " << ex.what();
+		return false;
+	}
+	if (! mapping.is_open())
+		return false;
+
+	// Split the file into chunks at line boundaries.
+	const char *begin = mapping.data();
+	const char *end   = begin + mapping.size();
+	constexpr size_t chunk_size = 1 << 20;
+	std::vector<const char*> chunk_begins { begin };
+	for (const char *c = begin + chunk_size; c < end; c += chunk_size) {
+		c = static_cast<const char*>(memchr(c, '\n', end - c));
+		if (c == nullptr)
+			break;
+		chunk_begins.emplace_back(++ c);
+	}
+	chunk_begins.emplace_back(end);
+
+	std::vector<ObjChunkTriangles> chunks(chunk_begins.size() - 1);
+	tbb::parallel_for(tbb::blocked_range<size_t>(0, chunks.size(), 1), [&chunk_begins, &chunks](const tbb::blocked_range<size_t> &range) {
+		for (size_t i = range.begin(); i < range.end(); ++ i)
+			chunks[i].valid = obj_parse_chunk_triangles(chunk_begins[i], chunk_begins[i + 1], chunks[i]);
+	});
+
+	// Merge the chunks.
+	std::vector<size_t> vertices_offsets(chunks.size() + 1, 0);
+	std::vector<size_t> indices_offsets(chunks.size() + 1, 0);
+	for (size_t i = 0; i < chunks.size(); ++ i) {
+		if (! chunks[i].valid)
+			return false;
+		vertices_offsets[i + 1] = vertices_offsets[i] + chunks[i].vertices.size();
+		indices_offsets[i + 1]  = indices_offsets[i] + chunks[i].indices.size();
+	}
+	if (vertices_offsets.back() >= size_t(std::numeric_limits<int>::max()))
+		return false;
+	const int num_vertices = int(vertices_offsets.back());
+	its.vertices.resize(num_vertices);
+	its.indices.resize(indices_offsets.back() / 3);
+	tbb::parallel_for(tbb::blocked_range<size_t>(0, chunks.size(), 1), [&](const tbb::blocked_range<size_t> &range) {
+		for (size_t i = range.begin(); i < range.end(); ++ i) {
+			ObjChunkTriangles &chunk = chunks[i];
+			std::copy(chunk.vertices.begin(), chunk.vertices.end(), its.vertices.begin() + vertices_offsets[i]);
+			for (size_t r : chunk.relative)
+				chunk.indices[r] += int(vertices_offsets[i]);
+			for (size_t j = 0; j < chunk.indices.size(); j += 3) {
+				stl_triangle_vertex_indices &face = its.indices[(indices_offsets[i] + j) / 3];
+				for (int k = 0; k < 3; ++ k) {
+					int idx = chunk.indices[j + k];
+					if (idx < 0 || idx >= num_vertices)
+						chunk.valid = false;
+					face[k] = idx;
+				}
+			}
+		}
+	});
+	return std::all_of(chunks.begin(), chunks.end(), [](const ObjChunkTriangles &chunk) { return chunk.valid; });
+}
+
 template<typename T> 
 bool savevector(FILE *pFile, const std::vector<T> &v)
 {
@@ -10,6 +10,8 @@
 #include <vector>
 #include <istream>
 
+struct indexed_triangle_set;
+
 namespace ObjParser {
 
 struct ObjVertex
@@ -105,6 +107,13 @@ struct ObjData {
 extern bool objparse(const char *path, ObjData &data);
 extern bool objparse(std::istream &stream, ObjData &data);
 
+// Parse just the vertex positions and the triangular or quad faces into an indexed triangle set, the quads are split
+// into triangles the same way as load_obj() does. The file is memory mapped and split at line boundaries into chunks,
+// which are parsed in parallel. Returns false if the file could not be read, if it contains other faces or invalid
+// vertex references, or if it contains anything the line by line objparse() would interpret differently.
+// Then objparse() shall be used.
+extern bool objparse_triangles(const char *path, indexed_triangle_set &its);
+
 extern bool objbinsave(const char *path, const ObjData &data);
 
 extern bool objbinload(const char *path, ObjData &data);
@@ -44,17 +44,23 @@
 #include "Utils.hpp"
 #include "ClipperUtils.hpp"
 #include "libslic3r.h"
+#include "LayerSpill.hpp"
 #include "LocalesUtils.hpp"
 #include "format.hpp"
 #include "Time.hpp"
+#include "Trace.hpp"
 
 #include <algorithm>
+#include <condition_variable>
 #include <cstdlib>
 #include <chrono>
+#include <deque>
+#include <mutex>
 #include <math.h>
 #include <optional>
 #include <string>
 #include <string_view>
+#include <unordered_map>
 
 #include <boost/algorithm/string.hpp>
 #include <boost/algorithm/string/find.hpp>
@@ -68,7 +74,9 @@
 
 #include "SVG.hpp"
 
+#include <tbb/blocked_range.h>
 #include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
 
 // Intel redesigned some TBB interface considerably when merging TBB with their oneAPI set of libraries, see GH #7332.
 // We are using quite an old TBB 2017 U7. Before we update our build servers, let's use the old API, which is deprecated in up to date TBB.
@@ -675,6 +683,41 @@ void GCodeGenerator::do_export(Print* print, const char* path, GCodeProcessorRes
     print->set_done(psGCodeExport);
 }
 
+void GCodeGenerator::do_estimate(Print* print)
+{
+    CNumericLocalesSetter locales_setter;
+
+    if (! print->step_state_with_timestamp(psGCodeExport).enabled)
+        return;
+
+    // The warnings of the G-code generator and processor are reported through the active step.
+    print->set_started(psGCodeExport);
+
+    BOOST_LOG_TRIVIAL(info) << "Estimating G-code statistics..." << log_memory_info();
+
+    m_processor.initialize(std::string());
+    m_processor.set_print(print);
+    m_processor.get_binary_data() = bgcode::binarize::BinaryData();
+    {
+        GCodeOutputStream file(nullptr, m_processor);
+        this->_do_export(*print, file, nullptr);
+    }
+
+    if (! m_placeholder_parser_integration.failed_templates.empty()) {
+        std::string msg = "G-code statistics estimation failed due to invalid custom G-code sections:\n\n";
+        for (const auto &name_and_error : m_placeholder_parser_integration.failed_templates)
+            msg += name_and_error.first + "\n" + name_and_error.second + "\n";
+        throw Slic3r::PlaceholderParserError(msg);
+    }
+
+    // Without the post-processing, the time estimates are not written into the G-code.
+    m_processor.finalize(false);
+    DoExport::update_print_estimated_stats(m_processor, m_writer.extruders(), print->m_print_statistics);
+
+    BOOST_LOG_TRIVIAL(info) << "Estimating G-code statistics finished" << log_memory_info();
+    print->set_done(psGCodeExport);
+}
+
 // free functions called by GCodeGenerator::_do_export()
 namespace DoExport {
     static void init_gcode_processor(const PrintConfig& config, GCodeProcessor& processor, bool& silent_time_estimator_enabled)
@@ -959,7 +1002,7 @@ void GCodeGenerator::_do_export(Print& print, GCodeOutputStream &file, Thumbnail
             throw Slic3r::ExportError(error_str);
         }
 
-        if (!thumbnails.empty())
+        if (!thumbnails.empty() && thumbnail_cb != nullptr)
             GCodeThumbnails::generate_binary_thumbnails(
                 thumbnail_cb, binary_data.thumbnails, thumbnails,
                 [&print]() { print.throw_if_canceled(); });
@@ -1258,8 +1301,10 @@ void GCodeGenerator::_do_export(Print& print, GCodeOutputStream &file, Thumbnail
     // Collect custom seam data from all objects.
     std::function<void(void)> throw_if_canceled_func = [&print]() { print.throw_if_canceled();};
 
+    // The seams are reused from the previous export unless the perimeters or the seam settings changed,
+    // thus changing just the speeds or the temperatures does not place the seams again.
     const Seams::Params params{Seams::Placer::get_params(print.full_print_config())};
-    m_seam_placer.init(print.objects(), params, throw_if_canceled_func);
+    m_seam_placer.init(print.objects(), params, throw_if_canceled_func, true);
 
     if (! (has_wipe_tower && print.config().single_extruder_multi_material_priming)) {
         // Set initial extruder only after custom start G-code.
@@ -1320,6 +1365,9 @@ void GCodeGenerator::_do_export(Print& print, GCodeOutputStream &file, Thumbnail
             // Process all layers of a single object instance (sequential mode) with a parallel pipeline:
             // Generate G-code, run the filters (vase mode, cooling buffer), run the G-code analyser
             // and export G-code into file.
+            // The layers of an object are exported once per instance, release them after the last instance was exported.
+            m_release_exported_layers = print.low_memory() && std::none_of(print_object_instance_sequential_active + 1, print_object_instances_ordering.cend(),
+                [&object](const PrintInstance *instance) { return instance->print_object == &object; }) ? &print : nullptr;
             this->process_layers(print, tool_ordering, collect_layers_to_print(object),
                 *print_object_instance_sequential_active - object.instances().data(), 
                 smooth_path_cache_global, file);
@@ -1392,8 +1440,31 @@ void GCodeGenerator::_do_export(Print& print, GCodeOutputStream &file, Thumbnail
         // Process all layers of all objects (non-sequential mode) with a parallel pipeline:
         // Generate G-code, run the filters (vase mode, cooling buffer), run the G-code analyser
         // and export G-code into file.
+        m_release_exported_layers = print.low_memory() ? &print : nullptr;
+        std::optional<LayerSpill> layer_spill;
+        if (print.low_memory()) {
+            // All the data derived from the extrusions of all layers was collected above. Move the extrusions out of core,
+            // the export pipeline loads them back a few layers ahead of the G-code generator and releases them once exported.
+            layer_spill.emplace();
+            // The extrusions will not be restored into the layers, which will not be exported.
+            print.m_low_memory_released = true;
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, layers_to_print.size()), [&layers_to_print, &layer_spill, &print](const tbb::blocked_range<size_t> &range) {
+                for (size_t idx = range.begin(); idx < range.end(); ++ idx) {
+                    print.throw_if_canceled();
+                    for (const ObjectLayerToPrint &layer : layers_to_print[idx].second) {
+                        if (layer.object_layer)
+                            layer_spill->spill(*layer.object_layer);
+                        if (layer.support_layer)
+                            layer_spill->spill(*layer.support_layer);
+                    }
+                }
+            });
+            layer_spill->finalize();
+            m_layer_spill = &*layer_spill;
+        }
         this->process_layers(print, tool_ordering, print_object_instances_ordering, layers_to_print, 
             smooth_path_cache_global, file);
+        m_layer_spill = nullptr;
         file.write(m_label_objects.maybe_stop_instance());
         if (m_wipe_tower)
             // Purge the extruder, pull out the active filament.
@@ -1500,6 +1571,31 @@ void GCodeGenerator::_do_export(Print& print, GCodeOutputStream &file, Thumbnail
     print.throw_if_canceled();
 }
 
+// Returns the smooth paths of a single object or support layer. They are cached with the layer and reused by the following
+// G-code exports until one of the steps producing the extrusions of the layer is executed again.
+template<typename Interpolate>
+static const GCode::SmoothPathCache& layer_smooth_path_cache(
+    const Layer                                             &layer,
+    std::initializer_list<PrintObjectStep>                   steps,
+    const GCode::SmoothPathCache::InterpolationParameters   &params,
+    Interpolate                                            &&interpolate)
+{
+    std::vector<size_t> timestamps;
+    timestamps.reserve(steps.size());
+    for (PrintObjectStep step : steps)
+        timestamps.emplace_back(layer.object()->step_state_with_timestamp(step).timestamp);
+    if (std::shared_ptr<GCode::LayerSmoothPathCache> &cached = layer.smooth_path_cache; ! cached ||
+        cached->params.tolerance != params.tolerance || cached->params.fit_circle_tolerance != params.fit_circle_tolerance ||
+        cached->timestamps != timestamps) {
+        auto fresh = std::make_shared<GCode::LayerSmoothPathCache>();
+        fresh->params     = params;
+        fresh->timestamps = std::move(timestamps);
+        interpolate(fresh->cache);
+        cached = std::move(fresh);
+    }
+    return layer.smooth_path_cache->cache;
+}
+
 // Fill in cache of smooth paths for perimeters, fills and supports of the given object layers.
 // Based on params, the paths are either decimated to sparser polylines, or interpolated with circular arches.
 void GCodeGenerator::smooth_path_interpolate(
@@ -1507,14 +1603,24 @@ void GCodeGenerator::smooth_path_interpolate(
     const GCode::SmoothPathCache::InterpolationParameters   &params, 
     GCode::SmoothPathCache                                  &out)
 {
-    if (const Layer *layer = object_layer_to_print.object_layer; layer) {
-        for (const LayerRegion *layerm : layer->regions()) {
-            out.interpolate_add(layerm->perimeters(), params);
-            out.interpolate_add(layerm->fills(), params);
-        }
-    }
+    if (const Layer *layer = object_layer_to_print.object_layer; layer)
+        out.add(layer_smooth_path_cache(*layer, { posPerimeters, posInfill, posIroning }, params,
+            [layer, &params](GCode::SmoothPathCache &cache) {
+                for (const LayerRegion *layerm : layer->regions()) {
+                    cache.interpolate_add(layerm->perimeters(), params);
+                    cache.interpolate_add(layerm->fills(), params);
+                }
+            }));
     if (const SupportLayer *layer = object_layer_to_print.support_layer; layer)
-        out.interpolate_add(layer->support_fills, params);
+        out.add(layer_smooth_path_cache(*layer, { posSupportMaterial }, params,
+            [layer, &params](GCode::SmoothPathCache &cache) { cache.interpolate_add(layer->support_fills, params); }));
+}
+
+// Number of layers in flight in the process_layers() pipeline. With more tokens, more layers are interpolated
+// and post-processed in parallel, however each token keeps the G-code of a whole layer in memory.
+static size_t process_layers_num_tokens()
+{
+    return std::clamp<size_t>(2 * size_t(tbb::this_task_arena::max_concurrency()), 12, 64);
 }
 
 // Process all layers of all objects (non-sequential mode) with a parallel pipeline:
@@ -1530,25 +1636,33 @@ void GCodeGenerator::process_layers(
 {
     size_t layer_to_print_idx = 0;
     const GCode::SmoothPathCache::InterpolationParameters interpolation_params = interpolation_parameters(print.config());
-    const auto smooth_path_interpolator = tbb::make_filter<void, std::pair<size_t, GCode::SmoothPathCache>>(slic3r_tbb_filtermode::serial_in_order,
-        [this, &print, &layers_to_print, &layer_to_print_idx, &interpolation_params](tbb::flow_control &fc) -> std::pair<size_t, GCode::SmoothPathCache> {
-            if (layer_to_print_idx >= layers_to_print.size()) {
-                if (layer_to_print_idx == layers_to_print.size() + (m_pressure_equalizer ? 1 : 0)) {
-                    fc.stop();
-                    return {};
-                } else {
-                    // Pressure equalizer need insert empty input. Because it returns one layer back.
-                    // Insert NOP (no operation) layer;
-                    return { layer_to_print_idx ++, {} };
+    const auto layer_indices = tbb::make_filter<void, size_t>(slic3r_tbb_filtermode::serial_in_order,
+        [this, &layers_to_print, &layer_to_print_idx](tbb::flow_control &fc) -> size_t {
+            // Pressure equalizer need insert empty input. Because it returns one layer back.
+            if (layer_to_print_idx == layers_to_print.size() + (m_pressure_equalizer ? 1 : 0))
+                fc.stop();
+            return layer_to_print_idx ++;
+        });
+    // Smooth path interpolation of a layer does not depend on the other layers, thus it runs in parallel.
+    const auto smooth_path_interpolator = tbb::make_filter<size_t, std::pair<size_t, GCode::SmoothPathCache>>(slic3r_tbb_filtermode::parallel,
+        [&print, &layers_to_print, &interpolation_params, layer_spill = m_layer_spill](size_t idx) -> std::pair<size_t, GCode::SmoothPathCache> {
+            if (idx >= layers_to_print.size())
+                // Insert NOP (no operation) layer;
+                return { idx, {} };
+            print.throw_if_canceled();
+            Trace::Span trace_span("G-code smooth path interpolation", "GCode", int64_t(idx));
+            GCode::SmoothPathCache smooth_path_cache;
+            for (const ObjectLayerToPrint &l : layers_to_print[idx].second) {
+                if (layer_spill) {
+                    // This stage runs ahead of the G-code generator, thus it prefetches the spilled layers.
+                    if (l.object_layer)
+                        layer_spill->restore(*l.object_layer);
+                    if (l.support_layer)
+                        layer_spill->restore(*l.support_layer);
                 }
-            } else {
-                print.throw_if_canceled();
-                size_t idx = layer_to_print_idx ++;
-                GCode::SmoothPathCache smooth_path_cache;
-                for (const ObjectLayerToPrint &l : layers_to_print[idx].second)
-                    GCodeGenerator::smooth_path_interpolate(l, interpolation_params, smooth_path_cache);
-                return { idx, std::move(smooth_path_cache) };
+                GCodeGenerator::smooth_path_interpolate(l, interpolation_params, smooth_path_cache);
             }
+            return { idx, std::move(smooth_path_cache) };
         });
     const auto generator = tbb::make_filter<std::pair<size_t, GCode::SmoothPathCache>, LayerResult>(slic3r_tbb_filtermode::serial_in_order,
         [this, &print, &tool_ordering, &print_object_instances_ordering, &layers_to_print, &smooth_path_cache_global](
@@ -1564,9 +1678,12 @@ void GCodeGenerator::process_layers(
                 if (m_wipe_tower && layer_tools.has_wipe_tower)
                     m_wipe_tower->next_layer();
                 print.throw_if_canceled();
-                return this->process_layer(print, layer.second, layer_tools, 
+                Trace::Span trace_span("G-code process layer", "GCode", int64_t(layer_to_print_idx));
+                LayerResult result = this->process_layer(print, layer.second, layer_tools, 
                     GCode::SmoothPathCaches{ smooth_path_cache_global, in.second }, 
                     &layer == &layers_to_print.back(), &print_object_instances_ordering, size_t(-1));
+                this->release_exported_layers(layer.second);
+                return result;
             }
         });
     // The pipeline is variable: The vase mode filter is optional.
@@ -1574,36 +1691,55 @@ void GCodeGenerator::process_layers(
         [spiral_vase = this->m_spiral_vase.get(), &layers_to_print](LayerResult in) -> LayerResult {
             if (in.nop_layer_result)
                 return in;
+            Trace::Span trace_span("G-code spiral vase", "GCode", int64_t(in.layer_id));
             spiral_vase->enable(in.spiral_vase_enable);
             bool last_layer = in.layer_id == layers_to_print.size() - 1;
             return { spiral_vase->process_layer(std::move(in.gcode), last_layer), in.layer_id, in.spiral_vase_enable, in.cooling_buffer_flush};
         });
     const auto pressure_equalizer = tbb::make_filter<LayerResult, LayerResult>(slic3r_tbb_filtermode::serial_in_order,
         [pressure_equalizer = this->m_pressure_equalizer.get()](LayerResult in) -> LayerResult {
+            Trace::Span trace_span("G-code pressure equalizer", "GCode", int64_t(in.layer_id));
             return pressure_equalizer->process_layer(std::move(in));
         });
-    const auto cooling = tbb::make_filter<LayerResult, std::string>(slic3r_tbb_filtermode::serial_in_order,
-        [cooling_buffer = this->m_cooling_buffer.get()](LayerResult in) -> std::string {
-             if (in.nop_layer_result)
-                return in.gcode;
-
-             return cooling_buffer->process_layer(std::move(in.gcode), in.layer_id, in.cooling_buffer_flush);
+    // The cooling buffer tracks the position, the extruder and the fan speed in order, while the slow down of a layer
+    // does not depend on the other layers, thus it runs in parallel.
+    const auto cooling_prepare = tbb::make_filter<LayerResult, CoolingBuffer::LayerGCode>(slic3r_tbb_filtermode::serial_in_order,
+        [cooling_buffer = this->m_cooling_buffer.get()](LayerResult in) -> CoolingBuffer::LayerGCode {
+            if (in.nop_layer_result) {
+                CoolingBuffer::LayerGCode out;
+                out.gcode = std::move(in.gcode);
+                return out;
+            }
+            Trace::Span trace_span("G-code cooling buffer prepare", "GCode", int64_t(in.layer_id));
+            return cooling_buffer->prepare_layer(std::move(in.gcode), in.layer_id, in.cooling_buffer_flush);
+        });
+    const auto cooling_process = tbb::make_filter<CoolingBuffer::LayerGCode, CoolingBuffer::LayerGCode>(slic3r_tbb_filtermode::parallel,
+        [cooling_buffer = this->m_cooling_buffer.get()](CoolingBuffer::LayerGCode in) -> CoolingBuffer::LayerGCode {
+            Trace::Span trace_span("G-code cooling buffer", "GCode", int64_t(in.layer_id));
+            cooling_buffer->cool_down_layer(in);
+            return in;
         });
-    const auto find_replace = tbb::make_filter<std::string, std::string>(slic3r_tbb_filtermode::serial_in_order,
+    const auto cooling_finalize = tbb::make_filter<CoolingBuffer::LayerGCode, std::string>(slic3r_tbb_filtermode::serial_in_order,
+        [cooling_buffer = this->m_cooling_buffer.get()](CoolingBuffer::LayerGCode in) -> std::string {
+            return cooling_buffer->finalize_layer(std::move(in));
+        });
+    // GCodeFindReplace is stateless, the layers are processed in parallel and reordered by the output filter.
+    const auto find_replace = tbb::make_filter<std::string, std::string>(slic3r_tbb_filtermode::parallel,
         [find_replace = this->m_find_replace.get()](std::string s) -> std::string {
+            Trace::Span trace_span("G-code find replace", "GCode");
             return find_replace->process_layer(std::move(s));
         });
     const auto output = tbb::make_filter<std::string, void>(slic3r_tbb_filtermode::serial_in_order,
-        [&output_stream](std::string s) { output_stream.write(s); }
+        [&output_stream](std::string s) { Trace::Span trace_span("G-code output", "GCode"); output_stream.write(s); }
     );
 
-    tbb::filter<void, LayerResult> pipeline_to_layerresult = smooth_path_interpolator & generator;
+    tbb::filter<void, LayerResult> pipeline_to_layerresult = layer_indices & smooth_path_interpolator & generator;
     if (m_spiral_vase)
         pipeline_to_layerresult = pipeline_to_layerresult & spiral_vase;
     if (m_pressure_equalizer)
         pipeline_to_layerresult = pipeline_to_layerresult & pressure_equalizer;
 
-    tbb::filter<LayerResult, std::string> pipeline_to_string = cooling;
+    tbb::filter<LayerResult, std::string> pipeline_to_string = cooling_prepare & cooling_process & cooling_finalize;
     if (m_find_replace)
         pipeline_to_string = pipeline_to_string & find_replace;
 
@@ -1612,7 +1748,9 @@ void GCodeGenerator::process_layers(
     TBBLocalesSetter locales_setter;
     // The pipeline elements are joined using const references, thus no copying is performed.
     output_stream.find_replace_supress();
-    tbb::parallel_pipeline(12, pipeline_to_layerresult & pipeline_to_string & output);
+    output_stream.start_async();
+    tbb::parallel_pipeline(process_layers_num_tokens(), pipeline_to_layerresult & pipeline_to_string & output);
+    output_stream.stop_async();
     output_stream.find_replace_enable();
 }
 
@@ -1629,24 +1767,24 @@ void GCodeGenerator::process_layers(
 {
     size_t layer_to_print_idx = 0;
     const GCode::SmoothPathCache::InterpolationParameters interpolation_params = interpolation_parameters(print.config());
-    const auto smooth_path_interpolator = tbb::make_filter<void, std::pair<size_t, GCode::SmoothPathCache>> (slic3r_tbb_filtermode::serial_in_order,
-        [this, &print, &layers_to_print, &layer_to_print_idx, interpolation_params](tbb::flow_control &fc) -> std::pair<size_t, GCode::SmoothPathCache> {
-            if (layer_to_print_idx >= layers_to_print.size()) {
-                if (layer_to_print_idx == layers_to_print.size() + (m_pressure_equalizer ? 1 : 0)) {
-                    fc.stop();
-                    return {};
-                } else {
-                    // Pressure equalizer need insert empty input. Because it returns one layer back.
-                    // Insert NOP (no operation) layer;
-                    return { layer_to_print_idx ++, {} };
-                }
-            } else {
-                print.throw_if_canceled();
-                size_t idx = layer_to_print_idx ++;
-                GCode::SmoothPathCache smooth_path_cache;
-                GCodeGenerator::smooth_path_interpolate(layers_to_print[idx], interpolation_params, smooth_path_cache);
-                return { idx, std::move(smooth_path_cache) };
-            }
+    const auto layer_indices = tbb::make_filter<void, size_t>(slic3r_tbb_filtermode::serial_in_order,
+        [this, &layers_to_print, &layer_to_print_idx](tbb::flow_control &fc) -> size_t {
+            // Pressure equalizer need insert empty input. Because it returns one layer back.
+            if (layer_to_print_idx == layers_to_print.size() + (m_pressure_equalizer ? 1 : 0))
+                fc.stop();
+            return layer_to_print_idx ++;
+        });
+    // Smooth path interpolation of a layer does not depend on the other layers, thus it runs in parallel.
+    const auto smooth_path_interpolator = tbb::make_filter<size_t, std::pair<size_t, GCode::SmoothPathCache>>(slic3r_tbb_filtermode::parallel,
+        [&print, &layers_to_print, &interpolation_params](size_t idx) -> std::pair<size_t, GCode::SmoothPathCache> {
+            if (idx >= layers_to_print.size())
+                // Insert NOP (no operation) layer;
+                return { idx, {} };
+            print.throw_if_canceled();
+            Trace::Span trace_span("G-code smooth path interpolation", "GCode", int64_t(idx));
+            GCode::SmoothPathCache smooth_path_cache;
+            GCodeGenerator::smooth_path_interpolate(layers_to_print[idx], interpolation_params, smooth_path_cache);
+            return { idx, std::move(smooth_path_cache) };
         });
     const auto generator = tbb::make_filter<std::pair<size_t, GCode::SmoothPathCache>, LayerResult>(slic3r_tbb_filtermode::serial_in_order,
         [this, &print, &tool_ordering, &layers_to_print, &smooth_path_cache_global, single_object_idx](std::pair<size_t, GCode::SmoothPathCache> in) -> LayerResult {
@@ -1658,9 +1796,13 @@ void GCodeGenerator::process_layers(
             } else {
                 ObjectLayerToPrint &layer = layers_to_print[layer_to_print_idx];
                 print.throw_if_canceled();
-                return this->process_layer(print, { std::move(layer) }, tool_ordering.tools_for_layer(layer.print_z()), 
+                Trace::Span trace_span("G-code process layer", "GCode", int64_t(layer_to_print_idx));
+                ObjectsLayerToPrint layers { layer };
+                LayerResult result = this->process_layer(print, layers, tool_ordering.tools_for_layer(layer.print_z()), 
                     GCode::SmoothPathCaches{ smooth_path_cache_global, in.second }, 
                     &layer == &layers_to_print.back(), nullptr, single_object_idx);
+                this->release_exported_layers(layers);
+                return result;
             }
         });
     // The pipeline is variable: The vase mode filter is optional.
@@ -1668,35 +1810,55 @@ void GCodeGenerator::process_layers(
         [spiral_vase = this->m_spiral_vase.get(), &layers_to_print](LayerResult in)->LayerResult {
             if (in.nop_layer_result)
                 return in;
+            Trace::Span trace_span("G-code spiral vase", "GCode", int64_t(in.layer_id));
             spiral_vase->enable(in.spiral_vase_enable);
             bool last_layer = in.layer_id == layers_to_print.size() - 1;
             return { spiral_vase->process_layer(std::move(in.gcode), last_layer), in.layer_id, in.spiral_vase_enable, in.cooling_buffer_flush };
         });
     const auto pressure_equalizer = tbb::make_filter<LayerResult, LayerResult>(slic3r_tbb_filtermode::serial_in_order,
         [pressure_equalizer = this->m_pressure_equalizer.get()](LayerResult in) -> LayerResult {
+             Trace::Span trace_span("G-code pressure equalizer", "GCode", int64_t(in.layer_id));
              return pressure_equalizer->process_layer(std::move(in));
         });
-    const auto cooling = tbb::make_filter<LayerResult, std::string>(slic3r_tbb_filtermode::serial_in_order,
-        [cooling_buffer = this->m_cooling_buffer.get()](LayerResult in)->std::string {
-            if (in.nop_layer_result)
-                return in.gcode;
-            return cooling_buffer->process_layer(std::move(in.gcode), in.layer_id, in.cooling_buffer_flush);
+    // The cooling buffer tracks the position, the extruder and the fan speed in order, while the slow down of a layer
+    // does not depend on the other layers, thus it runs in parallel.
+    const auto cooling_prepare = tbb::make_filter<LayerResult, CoolingBuffer::LayerGCode>(slic3r_tbb_filtermode::serial_in_order,
+        [cooling_buffer = this->m_cooling_buffer.get()](LayerResult in) -> CoolingBuffer::LayerGCode {
+            if (in.nop_layer_result) {
+                CoolingBuffer::LayerGCode out;
+                out.gcode = std::move(in.gcode);
+                return out;
+            }
+            Trace::Span trace_span("G-code cooling buffer prepare", "GCode", int64_t(in.layer_id));
+            return cooling_buffer->prepare_layer(std::move(in.gcode), in.layer_id, in.cooling_buffer_flush);
+        });
+    const auto cooling_process = tbb::make_filter<CoolingBuffer::LayerGCode, CoolingBuffer::LayerGCode>(slic3r_tbb_filtermode::parallel,
+        [cooling_buffer = this->m_cooling_buffer.get()](CoolingBuffer::LayerGCode in) -> CoolingBuffer::LayerGCode {
+            Trace::Span trace_span("G-code cooling buffer", "GCode", int64_t(in.layer_id));
+            cooling_buffer->cool_down_layer(in);
+            return in;
         });
-    const auto find_replace = tbb::make_filter<std::string, std::string>(slic3r_tbb_filtermode::serial_in_order,
+    const auto cooling_finalize = tbb::make_filter<CoolingBuffer::LayerGCode, std::string>(slic3r_tbb_filtermode::serial_in_order,
+        [cooling_buffer = this->m_cooling_buffer.get()](CoolingBuffer::LayerGCode in) -> std::string {
+            return cooling_buffer->finalize_layer(std::move(in));
+        });
+    // GCodeFindReplace is stateless, the layers are processed in parallel and reordered by the output filter.
+    const auto find_replace = tbb::make_filter<std::string, std::string>(slic3r_tbb_filtermode::parallel,
         [find_replace = this->m_find_replace.get()](std::string s) -> std::string {
+            Trace::Span trace_span("G-code find replace", "GCode");
             return find_replace->process_layer(std::move(s));
         });
     const auto output = tbb::make_filter<std::string, void>(slic3r_tbb_filtermode::serial_in_order,
-        [&output_stream](std::string s) { output_stream.write(s); }
+        [&output_stream](std::string s) { Trace::Span trace_span("G-code output", "GCode"); output_stream.write(s); }
     );
 
-    tbb::filter<void, LayerResult> pipeline_to_layerresult = smooth_path_interpolator & generator;
+    tbb::filter<void, LayerResult> pipeline_to_layerresult = layer_indices & smooth_path_interpolator & generator;
     if (m_spiral_vase)
         pipeline_to_layerresult = pipeline_to_layerresult & spiral_vase;
     if (m_pressure_equalizer)
         pipeline_to_layerresult = pipeline_to_layerresult & pressure_equalizer;
 
-    tbb::filter<LayerResult, std::string> pipeline_to_string = cooling;
+    tbb::filter<LayerResult, std::string> pipeline_to_string = cooling_prepare & cooling_process & cooling_finalize;
     if (m_find_replace)
         pipeline_to_string = pipeline_to_string & find_replace;
 
@@ -1705,7 +1867,9 @@ void GCodeGenerator::process_layers(
     TBBLocalesSetter locales_setter;
     // The pipeline elements are joined using const references, thus no copying is performed.
     output_stream.find_replace_supress();
-    tbb::parallel_pipeline(12, pipeline_to_layerresult & pipeline_to_string & output);
+    output_stream.start_async();
+    tbb::parallel_pipeline(process_layers_num_tokens(), pipeline_to_layerresult & pipeline_to_string & output);
+    output_stream.stop_async();
     output_stream.find_replace_enable();
 }
 
@@ -2380,6 +2544,79 @@ static inline double get_seam_gap_distance_value(const PrintConfig &config, cons
 
 using GCode::ExtrusionOrder::InstancePoint;
 
+// Because the G-code export has 1um resolution, don't generate segments shorter
+// than 1.5 microns, thus empty path segments will not be produced by G-code export.
+static const double seam_point_merge_distance_threshold{scaled<double>(0.0015)};
+
+// Perimeter loop split at its seam, before the seam gap is applied.
+struct SeamSplitLoop
+{
+    GCode::SmoothPath path;
+    std::size_t       wipe_offset{0};
+    bool              flipped{false};
+};
+
+using SeamSplitLoops = std::unordered_map<const ExtrusionLoop *, SeamSplitLoop>;
+
+// Unless the seam is placed nearest to the previous position, the seam of a perimeter loop depends neither
+// on the instance being printed nor on the travel to it. The perimeter loops of all the object layers are thus
+// split at their seams in parallel and shared by all instances, instead of placing the seams one instance after another.
+static SeamSplitLoops split_perimeter_loops_at_seams(
+    const Print &print,
+    const GCode::ObjectsLayerToPrint &layers,
+    const Seams::Placer &seam_placer,
+    const GCode::SmoothPathCache &smooth_path_cache,
+    const double scaled_resolution
+) {
+    struct LoopToSplit
+    {
+        const Layer         *layer;
+        const PrintRegion   *region;
+        const ExtrusionLoop *loop;
+        bool                 flipped;
+    };
+
+    std::vector<LoopToSplit> loops;
+    for (const GCode::ObjectLayerToPrint &layer_to_print : layers) {
+        const Layer *layer = layer_to_print.object_layer;
+        if (layer == nullptr || layer->object()->config().seam_position.value == spNearest)
+            continue;
+
+        for (const LayerRegion *layerm : layer->regions()) {
+            const PrintRegion &region = print.get_print_region(layerm->region().print_region_id());
+            for (const ExtrusionEntity *perimeter : layerm->perimeters().entities) {
+                assert(dynamic_cast<const ExtrusionEntityCollection *>(perimeter));
+                for (const ExtrusionEntity *ee : *static_cast<const ExtrusionEntityCollection *>(perimeter)) {
+                    if (auto loop = dynamic_cast<const ExtrusionLoop *>(ee); loop != nullptr && loop->role().is_perimeter()) {
+                        // Same orientation as chosen by GCode::ExtrusionOrder::extract_perimeter_extrusions().
+                        const bool is_hole = loop->is_clockwise();
+                        loops.push_back({layer, &region, loop, print.config().prefer_clockwise_movements ? !is_hole : is_hole});
+                    }
+                }
+            }
+        }
+    }
+
+    std::vector<SeamSplitLoop> split_loops(loops.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, loops.size()), [&loops, &split_loops, &seam_placer, &smooth_path_cache, scaled_resolution](const tbb::blocked_range<size_t> &range) {
+        for (size_t loop_idx = range.begin(); loop_idx < range.end(); ++loop_idx) {
+            const LoopToSplit &loop = loops[loop_idx];
+            const boost::variant<Point, Seams::Scarf::Scarf> seam{
+                seam_placer.place_seam(loop.layer, loop.region, *loop.loop, loop.flipped, Point::Zero())};
+            SeamSplitLoop &split_loop = split_loops[loop_idx];
+            std::tie(split_loop.path, split_loop.wipe_offset) = GCode::split_with_seam(
+                *loop.loop, seam, loop.flipped, smooth_path_cache, scaled_resolution, seam_point_merge_distance_threshold);
+            split_loop.flipped = loop.flipped;
+        }
+    });
+
+    SeamSplitLoops out;
+    out.reserve(loops.size());
+    for (size_t loop_idx = 0; loop_idx < loops.size(); ++loop_idx)
+        out.emplace(loops[loop_idx].loop, std::move(split_loops[loop_idx]));
+    return out;
+}
+
 struct SmoothPathGenerator
 {
     const Seams::Placer &seam_placer;
@@ -2387,6 +2624,8 @@ struct SmoothPathGenerator
     double scaled_resolution;
     const PrintConfig &config;
     bool enable_loop_clipping;
+    // Perimeter loops with the seam placed independently of the previous position.
+    const SeamSplitLoops &seam_split_loops;
 
     GCode::ExtrusionOrder::PathSmoothingResult operator()(
         const Layer *layer,
@@ -2401,9 +2640,6 @@ struct SmoothPathGenerator
         std::size_t wipe_offset{0};
 
         if (auto loop = dynamic_cast<const ExtrusionLoop *>(extrusion_entity)) {
-            // Because the G-code export has 1um resolution, don't generate segments shorter
-            // than 1.5 microns, thus empty path segments will not be produced by G-code export.
-            const auto seam_point_merge_distance_threshold{scaled<double>(0.0015)};
             const GCode::SmoothPathCache &smooth_path_cache{
                 loop->role().is_perimeter() ? smooth_path_caches.layer_local() :
                                               smooth_path_caches.global()};
@@ -2411,13 +2647,18 @@ struct SmoothPathGenerator
                 previous_position ? previous_position->local_point : Point::Zero()};
 
             if (!config.spiral_vase && loop->role().is_perimeter() && layer != nullptr && region != nullptr) {
-                boost::variant<Point, Seams::Scarf::Scarf> seam{
-                    this->seam_placer
-                        .place_seam(layer, region, *loop, extrusion_reference.flipped(), previous_point)};
-                std::tie(result, wipe_offset) = split_with_seam(
-                    *loop, seam, extrusion_reference.flipped(), smooth_path_cache,
-                    scaled_resolution, seam_point_merge_distance_threshold
-                );
+                if (auto it = seam_split_loops.find(loop); it != seam_split_loops.end() && it->second.flipped == extrusion_reference.flipped()) {
+                    result      = it->second.path;
+                    wipe_offset = it->second.wipe_offset;
+                } else {
+                    boost::variant<Point, Seams::Scarf::Scarf> seam{
+                        this->seam_placer
+                            .place_seam(layer, region, *loop, extrusion_reference.flipped(), previous_point)};
+                    std::tie(result, wipe_offset) = split_with_seam(
+                        *loop, seam, extrusion_reference.flipped(), smooth_path_cache,
+                        scaled_resolution, seam_point_merge_distance_threshold
+                    );
+                }
             } else {
                 result = smooth_path_cache.resolve_or_fit_split_with_seam(
                     *loop, extrusion_reference.flipped(), scaled_resolution, previous_point,
@@ -2482,12 +2723,16 @@ std::vector<GCode::ExtrusionOrder::ExtruderExtrusions> GCodeGenerator::get_sorte
             Skirt::make_skirt_loops_per_extruder_1st_layer(print, layer_tools, m_skirt_done) :
             Skirt::make_skirt_loops_per_extruder_other_layers(print, layer_tools, m_skirt_done)};
 
+    const SeamSplitLoops seam_split_loops{m_config.spiral_vase ? SeamSplitLoops{} :
+        split_perimeter_loops_at_seams(print, layers, m_seam_placer, smooth_path_caches.layer_local(), m_scaled_resolution)};
+
     const SmoothPathGenerator smooth_path{
         m_seam_placer,
         smooth_path_caches,
         m_scaled_resolution,
         m_config,
-        m_enable_loop_clipping
+        m_enable_loop_clipping,
+        seam_split_loops
     };
 
     using GCode::ExtrusionOrder::ExtruderExtrusions;
@@ -2960,6 +3205,18 @@ void GCodeGenerator::encode_full_config(const Print& print, std::vector<std::pai
     config.shrink_to_fit();
 }
 
+void GCodeGenerator::release_exported_layers(const ObjectsLayerToPrint &layers)
+{
+    if (m_release_exported_layers == nullptr)
+        return;
+    for (const ObjectLayerToPrint &layer : layers) {
+        if (layer.object_layer)
+            m_release_exported_layers->release_layer_extrusions(*layer.object_layer);
+        if (layer.support_layer)
+            m_release_exported_layers->release_layer_extrusions(*layer.support_layer);
+    }
+}
+
 void GCodeGenerator::set_extruders(const std::vector<unsigned int> &extruder_ids)
 {
     m_writer.set_extruders(extruder_ids);
@@ -3207,18 +3464,47 @@ std::string GCodeGenerator::extrude_support(const std::vector<GCode::ExtrusionOr
     return gcode;
 }
 
+// Bounded queue of G-code blocks consumed by a background thread.
+struct GCodeGenerator::GCodeOutputStream::AsyncWriter
+{
+    // Maximum number of queued blocks (layers), limits the memory consumed if writing is the bottleneck.
+    static constexpr const size_t   max_queued = 8;
+
+    std::mutex                      mutex;
+    std::condition_variable         cond_not_empty;
+    std::condition_variable         cond_not_full;
+    std::deque<std::string>         queue;
+    // No more blocks will be queued.
+    bool                            finished { false };
+    // Exception thrown by write_sync() on the background thread.
+    std::exception_ptr              exception;
+    boost::thread                   thread;
+};
+
+GCodeGenerator::GCodeOutputStream::GCodeOutputStream(FILE *f, GCodeProcessor &processor) : f(f), m_processor(processor) {}
+
+GCodeGenerator::GCodeOutputStream::~GCodeOutputStream()
+{
+    this->close();
+}
+
 bool GCodeGenerator::GCodeOutputStream::is_error() const 
 {
-    return ::ferror(this->f);
+    assert(! m_async);
+    return this->f && ::ferror(this->f);
 }
 
 void GCodeGenerator::GCodeOutputStream::flush()
 { 
-    ::fflush(this->f);
+    assert(! m_async);
+    if (this->f)
+        ::fflush(this->f);
 }
 
 void GCodeGenerator::GCodeOutputStream::close()
 { 
+    // The background thread is only running here if G-code export threw an exception.
+    this->join_async(true);
     if (this->f) {
         ::fclose(this->f);
         this->f = nullptr;
@@ -3230,12 +3516,86 @@ void GCodeGenerator::GCodeOutputStream::write(const char *what)
     if (what != nullptr) {
         //FIXME don't allocate a string, maybe process a batch of lines?
         std::string gcode(m_find_replace ? m_find_replace->process_layer(what) : what);
-        // writes string to file
-        fwrite(gcode.c_str(), 1, gcode.size(), this->f);
-        m_processor.process_buffer(gcode);
+        if (m_async) {
+            {
+                std::unique_lock<std::mutex> lock(m_async->mutex);
+                m_async->cond_not_full.wait(lock, [this]() { return m_async->queue.size() < AsyncWriter::max_queued || m_async->exception; });
+                // If the background thread failed, the exception is rethrown by stop_async().
+                if (! m_async->exception)
+                    m_async->queue.emplace_back(std::move(gcode));
+            }
+            m_async->cond_not_empty.notify_one();
+        } else
+            this->write_sync(gcode);
     }
 }
 
+void GCodeGenerator::GCodeOutputStream::write_sync(const std::string &gcode)
+{
+    // writes string to file
+    if (this->f)
+        fwrite(gcode.c_str(), 1, gcode.size(), this->f);
+    m_processor.process_buffer(gcode);
+}
+
+void GCodeGenerator::GCodeOutputStream::start_async()
+{
+    assert(! m_async);
+    m_async = std::make_unique<AsyncWriter>();
+    m_async->thread = create_thread([this, &async = *m_async]() {
+        set_current_thread_name("slic3r_gcode_output");
+        // GCodeProcessor parses numbers, thus the locales have to be set to "C" on this thread as well.
+        thread_data().tbb_worker_thread_set_c_locales();
+        for (;;) {
+            std::string gcode;
+            {
+                std::unique_lock<std::mutex> lock(async.mutex);
+                async.cond_not_empty.wait(lock, [&async]() { return ! async.queue.empty() || async.finished; });
+                if (async.queue.empty())
+                    // Finished and drained.
+                    break;
+                gcode = std::move(async.queue.front());
+                async.queue.pop_front();
+            }
+            async.cond_not_full.notify_one();
+            try {
+                this->write_sync(gcode);
+            } catch (...) {
+                {
+                    std::scoped_lock<std::mutex> lock(async.mutex);
+                    async.exception = std::current_exception();
+                    async.queue.clear();
+                }
+                async.cond_not_full.notify_all();
+                break;
+            }
+        }
+    });
+}
+
+std::exception_ptr GCodeGenerator::GCodeOutputStream::join_async(bool discard)
+{
+    if (! m_async)
+        return nullptr;
+    {
+        std::scoped_lock<std::mutex> lock(m_async->mutex);
+        m_async->finished = true;
+        if (discard)
+            m_async->queue.clear();
+    }
+    m_async->cond_not_empty.notify_one();
+    m_async->thread.join();
+    std::exception_ptr exception = m_async->exception;
+    m_async.reset();
+    return exception;
+}
+
+void GCodeGenerator::GCodeOutputStream::stop_async()
+{
+    if (std::exception_ptr exception = this->join_async(false); exception)
+        std::rethrow_exception(exception);
+}
+
 void GCodeGenerator::GCodeOutputStream::writeln(const std::string &what)
 {
     if (! what.empty())
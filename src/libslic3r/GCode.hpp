@@ -44,6 +44,7 @@
 #include "EdgeGrid.hpp"
 #include "tcbspan/span.hpp"
 
+#include <exception>
 #include <memory>
 #include <map>
 #include <string>
@@ -54,6 +55,7 @@ namespace Slic3r {
 
 // Forward declarations.
 class GCodeGenerator;
+class LayerSpill;
 struct WipeTowerData;
 
 namespace { struct Item; }
@@ -113,6 +115,10 @@ public:
     // throws std::runtime_exception on error,
     // throws CanceledException through print->throw_if_canceled().
     void            do_export(Print* print, const char* path, GCodeProcessorResult* result = nullptr, ThumbnailsGeneratorCallback thumbnail_cb = nullptr);
+    // Only calculate the print time and material estimates into print->print_statistics(): The G-code is generated
+    // and parsed by the G-code processor, but it is not written into a file, no thumbnails are rendered
+    // and the G-code is not post-processed.
+    void            do_estimate(Print* print);
 
     // Exported for the helper classes (OozePrevention, Wipe) and for the Perl binding for unit tests.
     const Vec2d&    origin() const { return m_origin; }
@@ -179,8 +185,9 @@ private:
 
     class GCodeOutputStream {
     public:
-        GCodeOutputStream(FILE *f, GCodeProcessor &processor) : f(f), m_processor(processor) {}
-        ~GCodeOutputStream() { this->close(); }
+        // With f == nullptr, the G-code is only parsed by the processor, see do_estimate().
+        GCodeOutputStream(FILE *f, GCodeProcessor &processor);
+        ~GCodeOutputStream();
 
         // Set a find-replace post-processor to modify the G-code before GCodePostProcessor.
         // It is being set to null inside process_layers(), because the find-replace process
@@ -207,13 +214,27 @@ private:
         // Formats and write into a file the given data. 
         void write_format(const char* format, ...);
 
+        // Between start_async() and stop_async(), write() only queues the G-code, which is then written into the file
+        // and parsed by the G-code processor on a background thread, so that the output overlaps with generating
+        // the following layers. stop_async() waits until the queue is empty and rethrows an exception
+        // thrown by the background thread.
+        void start_async();
+        void stop_async();
+
     private:
+        // Write into the file and parse with the G-code processor.
+        void write_sync(const std::string &gcode);
+        // Stop the background thread, optionally dropping the G-code not yet written.
+        std::exception_ptr join_async(bool discard);
+
+        struct AsyncWriter;
         FILE             *f { nullptr };
         // Find-replace post-processor to be called before GCodePostProcessor.
         GCodeFindReplace *m_find_replace { nullptr };
         // If suppressed, the backoup holds m_find_replace.
         GCodeFindReplace *m_find_replace_backup { nullptr };
         GCodeProcessor   &m_processor;
+        std::unique_ptr<AsyncWriter> m_async;
     };
     void            _do_export(Print &print, GCodeOutputStream &file, ThumbnailsGeneratorCallback thumbnail_cb);
 
@@ -274,6 +295,9 @@ private:
         const GCode::SmoothPathCache            &smooth_path_cache_global,
         GCodeOutputStream                       &output_stream);
 
+    // Low memory mode: Release the extrusions of the layers, of which the G-code was just generated, see Print::set_low_memory().
+    void            release_exported_layers(const ObjectsLayerToPrint &layers);
+
     void            set_extruders(const std::vector<unsigned int> &extruder_ids);
     std::string     preamble();
     std::string change_layer(
@@ -466,6 +490,10 @@ private:
     std::string                         m_pending_pre_extrusion_gcode;
     // Pointer to currently exporting PrintObject and instance index.
     GCode::PrintObjectInstance          m_current_instance;
+    // Set in the low memory mode, if the layers will not be exported again, see release_exported_layers().
+    Print                              *m_release_exported_layers { nullptr };
+    // Set in the low memory mode, if the extrusions of the layers were spilled to disk before the layers are exported.
+    LayerSpill                         *m_layer_spill { nullptr };
 
     bool                                m_silent_time_estimator_enabled;
 
@@ -1259,8 +1259,42 @@ Polyline AvoidCrossingPerimeters::travel_to(const GCodeGenerator &gcodegen, cons
 
 // ************************************* AvoidCrossingPerimeters::init_layer() *****************************************
 
+// Top surfaces of the layer, they are excluded from the internal boundary by get_boundary().
+static ExPolygons top_surfaces(const Layer &layer)
+{
+    ExPolygons out;
+    for (const LayerRegion *layer_region : layer.regions())
+        for (const Surface &surface : layer_region->fill_surfaces())
+            if (surface.is_top())
+                out.emplace_back(surface.expolygon);
+    return out;
+}
+
+// Returns true if the boundaries of layer would be the same as the boundaries of prev_layer.
+// That is the case for the consecutive layers of prismatic objects.
+static bool same_boundaries(const Layer &prev_layer, const Layer &layer)
+{
+    // The internal boundary of a support layer depends on the object layer below.
+    return &prev_layer == &layer || (prev_layer.object() == layer.object() &&
+        dynamic_cast<const SupportLayer*>(&prev_layer) == nullptr && dynamic_cast<const SupportLayer*>(&layer) == nullptr &&
+        prev_layer.lslices == layer.lslices &&
+        get_external_perimeter_width(prev_layer) == get_external_perimeter_width(layer) &&
+        get_perimeter_spacing(prev_layer) == get_perimeter_spacing(layer) &&
+        top_surfaces(prev_layer) == top_surfaces(layer));
+}
+
 void AvoidCrossingPerimeters::init_layer(const Layer &layer)
 {
+    if (m_layer != nullptr && same_boundaries(*m_layer, layer)) {
+        // Reuse the offsetted lslices, their grid and the internal boundary if it was already initialized by travel_to().
+        // The external boundary is collected from the layers of all objects at the same print_z, it is only reused if there is a single object.
+        if (m_layer->print_z != layer.print_z && layer.object()->print()->objects().size() > 1)
+            m_external.clear();
+        m_layer = &layer;
+        return;
+    }
+    m_layer = &layer;
+
     m_internal.clear();
     m_external.clear();
     m_lslices_offset.clear();
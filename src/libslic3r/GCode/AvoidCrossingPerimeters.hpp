@@ -77,6 +77,8 @@ private:
     Boundary m_internal;
     // Store all needed data for travels outside object
     Boundary m_external;
+    // Layer the above data was initialized for by init_layer(). The data is reused for the following layers with the same islands.
+    const Layer *m_layer { nullptr };
 };
 
 } // namespace Slic3r
@@ -6,9 +6,8 @@
 #include "ConflictChecker.hpp"
 
 #include <oneapi/tbb/blocked_range.h>
-#include <oneapi/tbb/concurrent_vector.h>
 #include <oneapi/tbb/parallel_for.h>
-#include <map>
+#include <atomic>
 #include <functional>
 #include <cmath>
 #include <cstdint>
@@ -286,19 +285,81 @@ std::pair<std::vector<ExtrusionPaths>, std::vector<ExtrusionPaths>> getAllLayers
 ConflictComputeOpt ConflictChecker::find_inter_of_lines(const LineWithIDs &lines)
 {
     using namespace RasterizationImpl;
-    std::map<IndexPair, std::vector<int>> indexToLine;
 
-    for (int i = 0; i < (int)lines.size(); ++i) {
-        const LineWithID &l1      = lines[i];
-        auto              indexes = line_rasterization(l1._line);
-        for (auto index : indexes) {
-            const auto &possibleIntersectIdxs = indexToLine[index];
-            for (auto possibleIntersectIdx : possibleIntersectIdxs) {
-                const LineWithID &l2 = lines[possibleIntersectIdx];
-                if (auto interRes = line_intersect(l1, l2); interRes.has_value()) { return interRes; }
+    // Bounding boxes of the lines of the individual instances. A line may only intersect a line of another instance
+    // if it reaches into the bounding box of that instance, which rules out most of the lines of a typical layer.
+    // The degenerate (axis aligned) boxes of single lines are valid here, thus BoundingBox::defined is not used.
+    struct InstanceBox
+    {
+        int   obj_id;
+        int   inst_id;
+        Point min;
+        Point max;
+    };
+    auto overlap = [](const Point &min1, const Point &max1, const Point &min2, const Point &max2) {
+        return min1.x() <= max2.x() && min2.x() <= max1.x() && min1.y() <= max2.y() && min2.y() <= max1.y();
+    };
+    std::vector<InstanceBox> instances;
+    std::vector<int>         line_instance(lines.size());
+    for (size_t i = 0; i < lines.size(); ++i) {
+        const LineWithID &l    = lines[i];
+        const Point       lmin = l._line.a.cwiseMin(l._line.b);
+        const Point       lmax = l._line.a.cwiseMax(l._line.b);
+        // There are just a few instances, a linear search starting with the instance of the previous line is fast enough.
+        int idx = i == 0 ? -1 : line_instance[i - 1];
+        if (idx == -1 || instances[idx].obj_id != l._obj_id || instances[idx].inst_id != l._inst_id) {
+            auto it = std::find_if(instances.begin(), instances.end(),
+                [&l](const InstanceBox &ib) { return ib.obj_id == l._obj_id && ib.inst_id == l._inst_id; });
+            if (it == instances.end()) {
+                instances.push_back({ l._obj_id, l._inst_id, lmin, lmax });
+                line_instance[i] = int(instances.size()) - 1;
+                continue;
             }
-            indexToLine[index].push_back(i);
+            idx = int(it - instances.begin());
         }
+        line_instance[i] = idx;
+        instances[idx].min = instances[idx].min.cwiseMin(lmin);
+        instances[idx].max = instances[idx].max.cwiseMax(lmax);
+    }
+
+    // For each instance, the other instances its bounding box overlaps with.
+    std::vector<std::vector<int>> neighbors(instances.size());
+    bool                          any_overlap = false;
+    for (size_t i = 0; i < instances.size(); ++i)
+        for (size_t j = i + 1; j < instances.size(); ++j)
+            if (overlap(instances[i].min, instances[i].max, instances[j].min, instances[j].max)) {
+                neighbors[i].push_back(int(j));
+                neighbors[j].push_back(int(i));
+                any_overlap = true;
+            }
+    if (! any_overlap)
+        return {};
+
+    // Hash the candidate lines into the 1mm grid. The (cell, line) pairs are sorted, so that the lines sharing a cell
+    // are stored next to each other, which is much cheaper than maintaining a map of vectors.
+    std::vector<std::pair<uint64_t, int>> cells;
+    for (int i = 0; i < (int)lines.size(); ++i) {
+        const LineWithID &l    = lines[i];
+        const Point       lmin = l._line.a.cwiseMin(l._line.b);
+        const Point       lmax = l._line.a.cwiseMax(l._line.b);
+        const std::vector<int> &nbrs = neighbors[line_instance[i]];
+        if (std::none_of(nbrs.begin(), nbrs.end(),
+                [&](int n) { return overlap(lmin, lmax, instances[n].min, instances[n].max); }))
+            continue;
+        for (const IndexPair &index : line_rasterization(l._line))
+            cells.emplace_back((uint64_t(uint32_t(index.first)) << 32) | uint64_t(uint32_t(index.second)), i);
+    }
+    std::sort(cells.begin(), cells.end());
+
+    for (auto it_begin = cells.begin(); it_begin != cells.end();) {
+        auto it_end = std::find_if(it_begin, cells.end(), [key = it_begin->first](const auto &c) { return c.first != key; });
+        for (auto it1 = it_begin; it1 != it_end; ++it1)
+            for (auto it2 = it_begin; it2 != it1; ++it2)
+                // Lines of the same instance never conflict, skip them before calculating the intersection.
+                if (line_instance[it1->second] != line_instance[it2->second])
+                    if (auto interRes = line_intersect(lines[it1->second], lines[it2->second]); interRes.has_value())
+                        return interRes;
+        it_begin = it_end;
     }
     return {};
 }
@@ -345,28 +406,27 @@ ConflictResultOpt ConflictChecker::find_inter_of_lines_in_diff_objs(SpanOfConstP
         layersLines.push_back(std::move(lines));
     }
 
-    bool                                   find = false;
-    tbb::concurrent_vector<std::pair<ConflictComputeResult,double>> conflict;
+    // Index of the lowest layer with a conflict found so far. Only the lowest conflict is reported,
+    // thus the layers above it are not checked anymore.
+    std::atomic<size_t>             lowest_conflict(layersLines.size());
+    std::vector<ConflictComputeOpt> conflicts(layersLines.size());
 
     tbb::parallel_for(tbb::blocked_range<size_t>(0, layersLines.size()), [&](tbb::blocked_range<size_t> range) {
-        for (size_t i = range.begin(); i < range.end(); i++) {
-            auto interRes = find_inter_of_lines(layersLines[i]);
-            if (interRes.has_value()) {
-                find = true;
-                conflict.emplace_back(*interRes, heights[i]);
+        for (size_t i = range.begin(); i < range.end() && i < lowest_conflict.load(std::memory_order_relaxed); i++) {
+            conflicts[i] = find_inter_of_lines(layersLines[i]);
+            if (conflicts[i].has_value()) {
+                size_t lowest = lowest_conflict.load(std::memory_order_relaxed);
+                while (i < lowest && ! lowest_conflict.compare_exchange_weak(lowest, i)) ;
                 break;
             }
         }
     });
 
-    if (find) {
-        std::sort(conflict.begin(), conflict.end(), [](const std::pair<ConflictComputeResult, double>& i1, const std::pair<ConflictComputeResult, double>& i2) {
-            return i1.second < i2.second;
-        });
-
-        const void *ptr1           = conflictQueue.idToObjsPtr(conflict[0].first._obj1);
-        const void *ptr2           = conflictQueue.idToObjsPtr(conflict[0].first._obj2);
-        double      conflictHeight = conflict[0].second;
+    if (size_t idx = lowest_conflict.load(); idx < layersLines.size()) {
+        const ConflictComputeResult &conflict = *conflicts[idx];
+        const void *ptr1           = conflictQueue.idToObjsPtr(conflict._obj1);
+        const void *ptr2           = conflictQueue.idToObjsPtr(conflict._obj2);
+        double      conflictHeight = heights[idx];
         if (ptr1 == &wtptr || ptr2 == &wtptr) {
             assert(! wipe_tower_data.z_and_depth_pairs.empty());
             if (ptr2 == &wtptr) { std::swap(ptr1, ptr2); }
@@ -341,6 +341,13 @@ finished:
 }
 
 std::string CoolingBuffer::process_layer(std::string &&gcode, size_t layer_id, bool flush)
+{
+    LayerGCode layer = this->prepare_layer(std::move(gcode), layer_id, flush);
+    this->cool_down_layer(layer);
+    return this->finalize_layer(std::move(layer));
+}
+
+CoolingBuffer::LayerGCode CoolingBuffer::prepare_layer(std::string &&gcode, size_t layer_id, bool flush)
 {
     // Cache the input G-code.
     if (m_gcode.empty())
@@ -348,21 +355,103 @@ std::string CoolingBuffer::process_layer(std::string &&gcode, size_t layer_id, b
     else
         m_gcode += gcode;
 
-    std::string out;
+    LayerGCode out;
+    out.layer_id = layer_id;
     if (flush) {
         // This is either an object layer or the very last print layer. Calculate cool down over the collected support layers
         // and one object layer.
-        std::vector<PerExtruderAdjustments> per_extruder_adjustments = this->parse_layer_gcode(m_gcode, m_current_pos);
-        float layer_time_stretched = this->calculate_layer_slowdown(per_extruder_adjustments);
-        out = this->apply_layer_cooldown(m_gcode, layer_id, layer_time_stretched, per_extruder_adjustments);
+        out.gcode          = std::move(m_gcode);
+        out.cool_down      = true;
+        out.start_pos      = m_current_pos;
+        out.start_extruder = m_current_extruder;
+        this->update_state_after_layer(out.gcode);
         m_gcode.clear();
     }
     return out;
 }
 
+void CoolingBuffer::cool_down_layer(LayerGCode &layer) const
+{
+    if (layer.cool_down) {
+        std::array<float, 5> current_pos = layer.start_pos;
+        std::vector<PerExtruderAdjustments> per_extruder_adjustments = this->parse_layer_gcode(layer.gcode, current_pos, layer.start_extruder);
+        float layer_time_stretched = this->calculate_layer_slowdown(per_extruder_adjustments);
+        layer.gcode = this->apply_layer_cooldown(layer.gcode, layer.layer_id, layer_time_stretched, per_extruder_adjustments,
+            layer.start_extruder, layer.fan_speed_first, layer.fan_speed_last);
+    }
+}
+
+std::string CoolingBuffer::finalize_layer(LayerGCode &&layer)
+{
+    if (layer.cool_down) {
+        // Only here the fan speed at the end of the previous layer is known.
+        if (layer.fan_speed_first != m_fan_speed)
+            layer.gcode.insert(0, GCodeWriter::set_fan(m_config.gcode_flavor, m_config.gcode_comments, layer.fan_speed_first));
+        m_fan_speed = layer.fan_speed_last;
+    }
+    return std::move(layer.gcode);
+}
+
+// The position and the extruder at the end of the layer are the values last set by the layer G-code, thus the G-code
+// is scanned backwards until all of them are found, which is much cheaper than parse_layer_gcode() parsing all the lines.
+// The axes are parsed the same way as by parse_layer_gcode(), so that both produce the same state.
+void CoolingBuffer::update_state_after_layer(const std::string &gcode)
+{
+    const char         extrusion_axis = get_extrusion_axis(m_config)[0];
+    const unsigned int all_axes       = (1 << 5) - 1;
+    unsigned int       resolved_axes  = 0;
+    bool               extruder_resolved = false;
+
+    const char *begin    = gcode.c_str();
+    const char *line_end = begin + gcode.size();
+    while ((resolved_axes != all_axes || ! extruder_resolved) && line_end > begin) {
+        const char *line_start = line_end;
+        while (line_start > begin && line_start[-1] != '\n')
+            -- line_start;
+        std::string_view sline(line_start, line_end - line_start);
+        line_end = line_start == begin ? begin : line_start - 1;
+
+        if (boost::starts_with(sline, "G0 ") || boost::starts_with(sline, "G1 ") || boost::starts_with(sline, "G2 ") ||
+            boost::starts_with(sline, "G3 ") || boost::starts_with(sline, "G92 ")) {
+            if (resolved_axes == all_axes - (1 << AxisIdx::Z) && sline.find('Z') == std::string_view::npos)
+                // Only Z is missing, which is set by a few lines only.
+                continue;
+            std::array<float, 5> new_pos;
+            unsigned int         line_axes = 0;
+            for (auto c = sline.begin() + 3;;) {
+                // Skip whitespaces.
+                for (; c != sline.end() && (*c == ' ' || *c == '\t'); ++ c);
+                if (c == sline.end() || *c == ';')
+                    break;
+                size_t axis = (*c >= 'X' && *c <= 'Z') ? (*c - 'X') :
+                              (*c == extrusion_axis) ? AxisIdx::E : (*c == 'F') ? AxisIdx::F : size_t(-1);
+                if (axis != size_t(-1)) {
+                    // The value is left unchanged if it could not be parsed.
+                    if (auto [pend, ec] = fast_float::from_chars(&*(++ c), sline.data() + sline.size(), new_pos[axis]); ec == std::errc())
+                        line_axes |= 1 << axis;
+                }
+                // Skip this word.
+                for (; c != sline.end() && *c != ' ' && *c != '\t'; ++ c);
+            }
+            for (size_t axis = 0; axis < 5; ++ axis)
+                if ((line_axes & ~resolved_axes) & (1 << axis))
+                    // Convert mm/min to mm/sec.
+                    m_current_pos[axis] = axis == AxisIdx::F ? new_pos[axis] / 60.f : new_pos[axis];
+            resolved_axes |= line_axes;
+        } else if (! extruder_resolved && boost::starts_with(sline, m_toolchange_prefix)) {
+            unsigned int new_extruder = 0;
+            auto res = std::from_chars(sline.data() + m_toolchange_prefix.size(), sline.data() + sline.size(), new_extruder);
+            if (res.ec != std::errc::invalid_argument && new_extruder < m_num_extruders) {
+                m_current_extruder = new_extruder;
+                extruder_resolved  = true;
+            }
+        }
+    }
+}
+
 // Parse the layer G-code for the moves, which could be adjusted.
 // Return the list of parsed lines, bucketed by an extruder.
-std::vector<PerExtruderAdjustments> CoolingBuffer::parse_layer_gcode(const std::string &gcode, std::array<float, 5> &current_pos) const
+std::vector<PerExtruderAdjustments> CoolingBuffer::parse_layer_gcode(const std::string &gcode, std::array<float, 5> &current_pos, unsigned int current_extruder) const
 {
     std::vector<PerExtruderAdjustments> per_extruder_adjustments(m_extruder_ids.size());
     std::vector<size_t>                 map_extruder_to_per_extruder_adjustment(m_num_extruders, 0);
@@ -376,7 +465,6 @@ std::vector<PerExtruderAdjustments> CoolingBuffer::parse_layer_gcode(const std::
         map_extruder_to_per_extruder_adjustment[extruder_id] = i;
     }
 
-    unsigned int      current_extruder  = m_current_extruder;
     PerExtruderAdjustments *adjustment  = &per_extruder_adjustments[map_extruder_to_per_extruder_adjustment[current_extruder]];
     const char       *line_start = gcode.c_str();
     const char       *line_end   = line_start;
@@ -738,7 +826,7 @@ static inline void extruder_range_slow_down_non_proportional(
 }
 
 // Calculate slow down for all the extruders.
-float CoolingBuffer::calculate_layer_slowdown(std::vector<PerExtruderAdjustments> &per_extruder_adjustments)
+float CoolingBuffer::calculate_layer_slowdown(std::vector<PerExtruderAdjustments> &per_extruder_adjustments) const
 {
     // Sort the extruders by an increasing slowdown_below_layer_time.
     // The layers with a lower slowdown_below_layer_time are slowed down
@@ -807,7 +895,13 @@ std::string CoolingBuffer::apply_layer_cooldown(
     // Total time of this layer after slow down, used to control the fan.
     float                                   layer_time,
     // Per extruder list of G-code lines and their cool down attributes.
-    std::vector<PerExtruderAdjustments>    &per_extruder_adjustments)
+    std::vector<PerExtruderAdjustments>    &per_extruder_adjustments,
+    // Extruder active at the start of the layer.
+    unsigned int                            current_extruder,
+    // Fan speed requested at the start of the layer, it is emitted by finalize_layer() if it differs from the previous layer.
+    int                                    &fan_speed_first,
+    // Fan speed at the end of the layer.
+    int                                    &fan_speed_last) const
 {
     // First sort the adjustment lines by of multiple extruders by their position in the source G-code.
     std::vector<const CoolingLine*> lines;
@@ -826,8 +920,9 @@ std::string CoolingBuffer::apply_layer_cooldown(
     new_gcode.reserve(gcode.size() * 2);
     bool bridge_fan_control = false;
     int  bridge_fan_speed   = 0;
-    auto change_extruder_set_fan = [this, layer_id, layer_time, &new_gcode, &bridge_fan_control, &bridge_fan_speed](const int requested_fan_speed = -1) {
-#define EXTRUDER_CONFIG(OPT) m_config.OPT.get_at(m_current_extruder)
+    int  fan_speed          = -1;
+    auto extruder_fan_speed = [this, layer_id, layer_time, &current_extruder, &bridge_fan_control, &bridge_fan_speed](const int requested_fan_speed = -1) {
+#define EXTRUDER_CONFIG(OPT) m_config.OPT.get_at(current_extruder)
         const int min_fan_speed            = EXTRUDER_CONFIG(min_fan_speed);
         // Is the fan speed ramp enabled?
         const int full_fan_speed_layer     = EXTRUDER_CONFIG(full_fan_speed_layer);
@@ -890,16 +985,19 @@ std::string CoolingBuffer::apply_layer_cooldown(
             fan_speed_new = std::clamp(requested_fan_speed, requested_fan_speed_limits.min_speed, requested_fan_speed_limits.max_speed);
         }
 
-        if (fan_speed_new != m_fan_speed) {
-            m_fan_speed = fan_speed_new;
-            new_gcode  += GCodeWriter::set_fan(m_config.gcode_flavor, m_config.gcode_comments, m_fan_speed);
+        return fan_speed_new;
+    };
+    auto change_extruder_set_fan = [this, &extruder_fan_speed, &fan_speed, &new_gcode](const int requested_fan_speed = -1) {
+        if (int fan_speed_new = extruder_fan_speed(requested_fan_speed); fan_speed_new != fan_speed) {
+            fan_speed  = fan_speed_new;
+            new_gcode += GCodeWriter::set_fan(m_config.gcode_flavor, m_config.gcode_comments, fan_speed);
         }
     };
 
     const char         *pos               = gcode.c_str();
     int                 current_feedrate  = 0;
 
-    change_extruder_set_fan();
+    fan_speed = fan_speed_first = extruder_fan_speed();
     for (const CoolingLine *line : lines) {
         const char *line_start  = gcode.c_str() + line->line_start;
         const char *line_end    = gcode.c_str() + line->line_end;
@@ -908,8 +1006,8 @@ std::string CoolingBuffer::apply_layer_cooldown(
         if (line->type & CoolingLine::TYPE_SET_TOOL) {
             unsigned int new_extruder = 0;
             auto res = std::from_chars(line_start + m_toolchange_prefix.size(), line_end, new_extruder);
-            if (res.ec != std::errc::invalid_argument && new_extruder != m_current_extruder) {
-                m_current_extruder = new_extruder;
+            if (res.ec != std::errc::invalid_argument && new_extruder != current_extruder) {
+                current_extruder = new_extruder;
                 change_extruder_set_fan();
             }
             new_gcode.append(line_start, line_end - line_start);
@@ -922,7 +1020,7 @@ std::string CoolingBuffer::apply_layer_cooldown(
                 new_gcode += GCodeWriter::set_fan(m_config.gcode_flavor, m_config.gcode_comments, bridge_fan_speed);
         } else if (line->type & CoolingLine::TYPE_BRIDGE_FAN_END) {
             if (bridge_fan_control)
-                new_gcode += GCodeWriter::set_fan(m_config.gcode_flavor, m_config.gcode_comments, m_fan_speed);
+                new_gcode += GCodeWriter::set_fan(m_config.gcode_flavor, m_config.gcode_comments, fan_speed);
         } else if (line->type & CoolingLine::TYPE_EXTRUDE_END) {
             // Just remove this comment.
         } else if (line->type & (CoolingLine::TYPE_ADJUSTABLE | CoolingLine::TYPE_ADJUSTABLE_EMPTY | CoolingLine::TYPE_EXTERNAL_PERIMETER | CoolingLine::TYPE_WIPE | CoolingLine::TYPE_HAS_F)) {
@@ -1012,6 +1110,8 @@ std::string CoolingBuffer::apply_layer_cooldown(
     if (pos < gcode_end)
         new_gcode.append(pos, gcode_end - pos);
 
+    fan_speed_last = fan_speed;
+
     // There should be no empty G1 lines emitted.
     assert(new_gcode.find("G1\n") == std::string::npos);
     return new_gcode;
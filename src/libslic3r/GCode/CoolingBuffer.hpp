@@ -46,13 +46,38 @@ public:
     std::string process_layer(const std::string &gcode, size_t layer_id, bool flush)
         { return this->process_layer(std::string(gcode), layer_id, flush); }
 
+    // process_layer() split into three stages, so that the G-code export pipeline may cool down the layers in parallel:
+    // prepare_layer() and finalize_layer() have to be called in the layer order, cool_down_layer() may be called
+    // for multiple layers concurrently.
+    struct LayerGCode {
+        std::string             gcode;
+        size_t                  layer_id { 0 };
+        // Is the G-code to be cooled down? If not, it is passed through unmodified.
+        bool                    cool_down { false };
+        // State at the start of the layer, filled in by prepare_layer().
+        std::array<float, 5>    start_pos;
+        unsigned int            start_extruder { 0 };
+        // Fan speed requested at the start and at the end of the layer, filled in by cool_down_layer().
+        int                     fan_speed_first { -1 };
+        int                     fan_speed_last { -1 };
+    };
+    // Collect the support layers until an object layer is flushed, advance the position and the extruder over the layer.
+    LayerGCode  prepare_layer(std::string &&gcode, size_t layer_id, bool flush);
+    // Slow down the layer and control the fan, does not modify the CoolingBuffer.
+    void        cool_down_layer(LayerGCode &layer) const;
+    // Emit the fan speed at the start of the layer if it differs from the previous layer, return the layer G-code.
+    std::string finalize_layer(LayerGCode &&layer);
+
 private:
 	CoolingBuffer& operator=(const CoolingBuffer&) = delete;
-    std::vector<PerExtruderAdjustments> parse_layer_gcode(const std::string &gcode, std::array<float, 5> &current_pos) const;
-    float       calculate_layer_slowdown(std::vector<PerExtruderAdjustments> &per_extruder_adjustments);
+    std::vector<PerExtruderAdjustments> parse_layer_gcode(const std::string &gcode, std::array<float, 5> &current_pos, unsigned int current_extruder) const;
+    // Update m_current_pos and m_current_extruder to the state at the end of the layer G-code.
+    void        update_state_after_layer(const std::string &gcode);
+    float       calculate_layer_slowdown(std::vector<PerExtruderAdjustments> &per_extruder_adjustments) const;
     // Apply slow down over G-code lines stored in per_extruder_adjustments, enable fan if needed.
     // Returns the adjusted G-code.
-    std::string apply_layer_cooldown(const std::string &gcode, size_t layer_id, float layer_time, std::vector<PerExtruderAdjustments> &per_extruder_adjustments);
+    std::string apply_layer_cooldown(const std::string &gcode, size_t layer_id, float layer_time, std::vector<PerExtruderAdjustments> &per_extruder_adjustments,
+                                     unsigned int current_extruder, int &fan_speed_first, int &fan_speed_last) const;
 
     // G-code snippet cached for the support layers preceding an object layer.
     std::string                 m_gcode;
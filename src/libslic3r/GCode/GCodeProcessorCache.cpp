@@ -0,0 +1,328 @@
+#include "GCodeProcessor.hpp"
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/log/trivial.hpp>
+#include <boost/nowide/fstream.hpp>
+#include <algorithm>
+#include <cstring>
+#include <functional>
+
+#include "libslic3r/Exception.hpp"
+#include "libslic3r/Utils.hpp"
+
+namespace Slic3r {
+
+// Cache of the GCodeProcessorResult of G-code files opened by the G-code viewer.
+// The cache is read by the same build that wrote it, thus the plain old data is stored in its in-memory representation.
+// A cache is only valid for the file of the same path, size and modification time it was created from.
+
+static constexpr const char     CacheMagic[4]   = { 'P', 'S', 'G', 'C' };
+static constexpr const uint32_t CacheVersion    = 1;
+// Processing of small G-codes is faster than reading and writing their cache.
+static constexpr const uint64_t CacheMinFileSize = 16 * 1024 * 1024;
+// The caches of large G-codes are large as well, only the most recently stored ones are kept.
+static constexpr const size_t   CacheMaxFiles    = 3;
+
+static boost::filesystem::path gcode_cache_dir()
+{
+    return boost::filesystem::path(data_dir()) / "cache" / "gcodeviewer";
+}
+
+struct GCodeCacheKey
+{
+    std::string path;
+    uint64_t    file_size { 0 };
+    int64_t     mtime { 0 };
+};
+
+static GCodeCacheKey gcode_cache_key(const std::string &filename)
+{
+    const boost::filesystem::path path = boost::filesystem::canonical(filename);
+    return { path.string(), uint64_t(boost::filesystem::file_size(path)), int64_t(boost::filesystem::last_write_time(path)) };
+}
+
+static boost::filesystem::path gcode_cache_path(const GCodeCacheKey &key)
+{
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.cache", (unsigned long long)std::hash<std::string>()(key.path));
+    return gcode_cache_dir() / name;
+}
+
+class GCodeCacheWriter
+{
+public:
+    explicit GCodeCacheWriter(boost::nowide::ofstream &out) : m_out(out) {}
+
+    template<typename T>
+    void pod(const T &value) { m_out.write(reinterpret_cast<const char*>(&value), sizeof(T)); }
+    void str(const std::string &value) { this->pod(uint64_t(value.size())); m_out.write(value.data(), value.size()); }
+    template<typename T>
+    void pods(const std::vector<T> &values) {
+        this->pod(uint64_t(values.size()));
+        m_out.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+    }
+    void strs(const std::vector<std::string> &values) {
+        this->pod(uint64_t(values.size()));
+        for (const std::string &value : values)
+            this->str(value);
+    }
+
+private:
+    boost::nowide::ofstream &m_out;
+};
+
+class GCodeCacheReader
+{
+public:
+    GCodeCacheReader(boost::nowide::ifstream &in, uint64_t size) : m_in(in), m_remaining(size) {}
+
+    template<typename T>
+    T pod() {
+        T value;
+        this->read(reinterpret_cast<char*>(&value), sizeof(T));
+        return value;
+    }
+    std::string str() {
+        std::string value(this->count(1), '\0');
+        this->read(value.data(), value.size());
+        return value;
+    }
+    template<typename T>
+    void pods(std::vector<T> &values) {
+        values.resize(this->count(sizeof(T)));
+        this->read(reinterpret_cast<char*>(values.data()), values.size() * sizeof(T));
+    }
+    void strs(std::vector<std::string> &values) {
+        values.resize(this->count(sizeof(uint64_t)));
+        for (std::string &value : values)
+            value = this->str();
+    }
+    // Number of items to be read, validated against the size of the file to not allocate nonsense on a corrupted cache.
+    size_t count(size_t item_size) {
+        const auto cnt = this->pod<uint64_t>();
+        if (cnt * item_size > m_remaining)
+            throw Slic3r::RuntimeError("Corrupted G-code cache");
+        return size_t(cnt);
+    }
+
+private:
+    void read(char *data, size_t size) {
+        if (size > m_remaining || ! m_in.read(data, size))
+            throw Slic3r::RuntimeError("Truncated G-code cache");
+        m_remaining -= size;
+    }
+
+    boost::nowide::ifstream &m_in;
+    uint64_t                 m_remaining;
+};
+
+static void write_header(GCodeCacheWriter &writer, const GCodeCacheKey &key)
+{
+    for (char c : CacheMagic)
+        writer.pod(c);
+    writer.pod(CacheVersion);
+    writer.pod(uint32_t(sizeof(GCodeProcessorResult::MoveVertex)));
+    writer.str(key.path);
+    writer.pod(key.file_size);
+    writer.pod(key.mtime);
+}
+
+static bool read_header(GCodeCacheReader &reader, const GCodeCacheKey &key)
+{
+    for (char c : CacheMagic)
+        if (reader.pod<char>() != c)
+            return false;
+    return reader.pod<uint32_t>() == CacheVersion &&
+           reader.pod<uint32_t>() == uint32_t(sizeof(GCodeProcessorResult::MoveVertex)) &&
+           reader.str() == key.path &&
+           reader.pod<uint64_t>() == key.file_size &&
+           reader.pod<int64_t>() == key.mtime;
+}
+
+static void write_result(GCodeCacheWriter &writer, const GCodeProcessorResult &result)
+{
+    writer.str(result.filename);
+    writer.pod(result.is_binary_file);
+    writer.pods(result.moves);
+    writer.pod(uint64_t(result.lines_ends.size()));
+    for (const std::vector<size_t> &lines_ends : result.lines_ends)
+        writer.pods(lines_ends);
+    writer.pods(result.bed_shape);
+    writer.pod(result.max_print_height);
+    writer.pod(result.z_offset);
+    writer.str(result.settings_ids.print);
+    writer.strs(result.settings_ids.filament);
+    writer.str(result.settings_ids.printer);
+    writer.pod(uint64_t(result.extruders_count));
+    writer.pod(result.backtrace_enabled);
+    writer.strs(result.extruder_colors);
+    writer.pods(result.filament_diameters);
+    writer.pods(result.filament_densities);
+    writer.pods(result.filament_cost);
+
+    const PrintEstimatedStatistics &stats = result.print_statistics;
+    writer.pods(stats.volumes_per_color_change);
+    writer.pod(uint64_t(stats.volumes_per_extruder.size()));
+    for (const auto &[extruder_id, volume] : stats.volumes_per_extruder) {
+        writer.pod(uint64_t(extruder_id));
+        writer.pod(volume);
+    }
+    writer.pod(uint64_t(stats.used_filaments_per_role.size()));
+    for (const auto &[role, used] : stats.used_filaments_per_role) {
+        writer.pod(role);
+        writer.pod(used.first);
+        writer.pod(used.second);
+    }
+    writer.pod(uint64_t(stats.cost_per_extruder.size()));
+    for (const auto &[extruder_id, cost] : stats.cost_per_extruder) {
+        writer.pod(uint64_t(extruder_id));
+        writer.pod(cost);
+    }
+    for (const PrintEstimatedStatistics::Mode &mode : stats.modes) {
+        writer.pod(mode.time);
+        writer.pod(uint64_t(mode.custom_gcode_times.size()));
+        for (const auto &[type, times] : mode.custom_gcode_times) {
+            writer.pod(int32_t(type));
+            writer.pod(times.first);
+            writer.pod(times.second);
+        }
+    }
+
+    writer.pod(uint64_t(result.custom_gcode_per_print_z.size()));
+    for (const CustomGCode::Item &item : result.custom_gcode_per_print_z) {
+        writer.pod(item.print_z);
+        writer.pod(int32_t(item.type));
+        writer.pod(int32_t(item.extruder));
+        writer.str(item.color);
+        writer.str(item.extra);
+    }
+    writer.pod(result.spiral_vase_mode);
+}
+
+static void read_result(GCodeCacheReader &reader, GCodeProcessorResult &result)
+{
+    result.filename       = reader.str();
+    result.is_binary_file = reader.pod<bool>();
+    reader.pods(result.moves);
+    result.lines_ends.resize(reader.count(sizeof(uint64_t)));
+    for (std::vector<size_t> &lines_ends : result.lines_ends)
+        reader.pods(lines_ends);
+    reader.pods(result.bed_shape);
+    result.max_print_height = reader.pod<float>();
+    result.z_offset         = reader.pod<float>();
+    result.settings_ids.print = reader.str();
+    reader.strs(result.settings_ids.filament);
+    result.settings_ids.printer = reader.str();
+    result.extruders_count   = size_t(reader.pod<uint64_t>());
+    result.backtrace_enabled = reader.pod<bool>();
+    reader.strs(result.extruder_colors);
+    reader.pods(result.filament_diameters);
+    reader.pods(result.filament_densities);
+    reader.pods(result.filament_cost);
+
+    PrintEstimatedStatistics &stats = result.print_statistics;
+    reader.pods(stats.volumes_per_color_change);
+    for (size_t i = reader.count(sizeof(uint64_t) + sizeof(double)); i > 0; -- i) {
+        const auto extruder_id = size_t(reader.pod<uint64_t>());
+        stats.volumes_per_extruder[extruder_id] = reader.pod<double>();
+    }
+    for (size_t i = reader.count(sizeof(GCodeExtrusionRole) + 2 * sizeof(double)); i > 0; -- i) {
+        const auto role   = reader.pod<GCodeExtrusionRole>();
+        const auto first  = reader.pod<double>();
+        const auto second = reader.pod<double>();
+        stats.used_filaments_per_role[role] = { first, second };
+    }
+    for (size_t i = reader.count(sizeof(uint64_t) + sizeof(double)); i > 0; -- i) {
+        const auto extruder_id = size_t(reader.pod<uint64_t>());
+        stats.cost_per_extruder[extruder_id] = reader.pod<double>();
+    }
+    for (PrintEstimatedStatistics::Mode &mode : stats.modes) {
+        mode.time = reader.pod<float>();
+        mode.custom_gcode_times.resize(reader.count(sizeof(int32_t) + 2 * sizeof(float)));
+        for (auto &[type, times] : mode.custom_gcode_times) {
+            type         = CustomGCode::Type(reader.pod<int32_t>());
+            times.first  = reader.pod<float>();
+            times.second = reader.pod<float>();
+        }
+    }
+
+    result.custom_gcode_per_print_z.resize(reader.count(sizeof(double) + 2 * sizeof(int32_t)));
+    for (CustomGCode::Item &item : result.custom_gcode_per_print_z) {
+        item.print_z  = reader.pod<double>();
+        item.type     = CustomGCode::Type(reader.pod<int32_t>());
+        item.extruder = int(reader.pod<int32_t>());
+        item.color    = reader.str();
+        item.extra    = reader.str();
+    }
+    result.spiral_vase_mode = reader.pod<bool>();
+}
+
+bool GCodeProcessor::load_result_from_cache(const std::string& filename, GCodeProcessorResult& result)
+{
+    try {
+        const GCodeCacheKey key = gcode_cache_key(filename);
+        if (key.file_size < CacheMinFileSize)
+            return false;
+        const boost::filesystem::path cache_path = gcode_cache_path(key);
+        if (! boost::filesystem::exists(cache_path))
+            return false;
+        boost::nowide::ifstream in(cache_path.string(), std::ios::in | std::ios::binary);
+        if (! in)
+            return false;
+        GCodeCacheReader reader(in, uint64_t(boost::filesystem::file_size(cache_path)));
+        if (! read_header(reader, key))
+            return false;
+        GCodeProcessorResult loaded;
+        loaded.reset();
+        read_result(reader, loaded);
+        loaded.id = ++s_result_id;
+        result = std::move(loaded);
+        BOOST_LOG_TRIVIAL(info) << "G-code " << filename << " loaded from the cache " << cache_path.string();
+        return true;
+    } catch (const std::exception &ex) {
+        BOOST_LOG_TRIVIAL(error) << "Failed loading the cache of G-code " << filename << ": " << ex.what();
+        return false;
+    }
+}
+
+void GCodeProcessor::store_result_to_cache(const std::string& filename, const GCodeProcessorResult& result)
+{
+    boost::filesystem::path cache_path;
+    try {
+        const GCodeCacheKey key = gcode_cache_key(filename);
+        if (key.file_size < CacheMinFileSize)
+            return;
+        boost::filesystem::create_directories(gcode_cache_dir());
+        cache_path = gcode_cache_path(key);
+        {
+            boost::nowide::ofstream out(cache_path.string(), std::ios::out | std::ios::binary | std::ios::trunc);
+            GCodeCacheWriter writer(out);
+            write_header(writer, key);
+            write_result(writer, result);
+            out.close();
+            if (out.fail())
+                throw Slic3r::FileIOError("Failed writing " + cache_path.string());
+        }
+
+        // Remove the least recently stored caches.
+        std::vector<std::pair<std::time_t, boost::filesystem::path>> caches;
+        for (const boost::filesystem::directory_entry &entry : boost::filesystem::directory_iterator(gcode_cache_dir()))
+            if (boost::filesystem::is_regular_file(entry.status()) && entry.path().extension() == ".cache")
+                caches.emplace_back(boost::filesystem::last_write_time(entry.path()), entry.path());
+        if (caches.size() > CacheMaxFiles) {
+            std::sort(caches.begin(), caches.end(), [](const auto &l, const auto &r) { return l.first > r.first; });
+            for (size_t i = CacheMaxFiles; i < caches.size(); ++ i)
+                if (caches[i].second != cache_path)
+                    boost::filesystem::remove(caches[i].second);
+        }
+    } catch (const std::exception &ex) {
+        BOOST_LOG_TRIVIAL(error) << "Failed storing the cache of G-code " << filename << ": " << ex.what();
+        if (! cache_path.empty()) {
+            boost::system::error_code ec;
+            boost::filesystem::remove(cache_path, ec);
+        }
+    }
+}
+
+} // namespace Slic3r
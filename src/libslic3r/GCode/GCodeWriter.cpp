@@ -15,16 +15,13 @@
 
 #include <algorithm>
 #include <iostream>
+#include <limits>
 #include <string_view>
 #include <cassert>
 #include <cinttypes>
 
 #include "libslic3r/libslic3r.h"
 
-#ifdef __APPLE__
-    #include <boost/spirit/include/karma.hpp>
-#endif
-
 #define FLAVOR_IS(val) this->config.gcode_flavor == val
 #define FLAVOR_IS_NOT(val) this->config.gcode_flavor != val
 
@@ -590,53 +587,105 @@ std::string GCodeWriter::set_fan(unsigned int speed) const
     return GCodeWriter::set_fan(this->config.gcode_flavor, this->config.gcode_comments, speed);
 }
 
-void GCodeFormatter::emit_axis(const char axis, const double v, size_t digits) {
-    assert(digits <= 9);
-    static constexpr const std::array<int, 10> pow_10{1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
-    *ptr_err.ptr++ = ' '; *ptr_err.ptr++ = axis;
-
-    char *base_ptr = this->ptr_err.ptr;
-    auto  v_int    = int64_t(std::round(v * pow_10[digits]));
-    // Older stdlib on macOS doesn't support std::from_chars at all, so it is used boost::spirit::karma::generate instead of it.
-    // That is a little bit slower than std::to_chars but not much.
-#ifdef __APPLE__
-    boost::spirit::karma::generate(this->ptr_err.ptr, boost::spirit::karma::int_generator<int64_t>(), v_int);
-#else
-    // this->buf_end minus 1 because we need space for adding the extra decimal point.
-    this->ptr_err = std::to_chars(this->ptr_err.ptr, this->buf_end - 1, v_int);
-#endif
-    size_t writen_digits = (this->ptr_err.ptr - base_ptr) - (v_int < 0 ? 1 : 0);
-    if (writen_digits < digits) {
-        // Number is smaller than 10^digits, so that we will pad it with zeros.
-        size_t remaining_digits = digits - writen_digits;
-        // Move all newly inserted chars by remaining_digits to allocate space for padding with zeros.
-        for (char *from_ptr = this->ptr_err.ptr - 1, *to_ptr = from_ptr + remaining_digits; from_ptr >= this->ptr_err.ptr - writen_digits; --to_ptr, --from_ptr)
-            *to_ptr = *from_ptr;
-
-        memset(this->ptr_err.ptr - writen_digits, '0', remaining_digits);
-        this->ptr_err.ptr += remaining_digits;
+// Two decimal digits per entry, so that the integers are emitted two digits per division.
+static constexpr const char digit_pairs[201] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+// Write exactly num_digits decimal digits of value ending at end, padded by leading zeros.
+template<typename UInt>
+static inline void emit_digits(char *end, UInt value, size_t num_digits)
+{
+    for (; num_digits >= 2; num_digits -= 2) {
+        const char *pair = digit_pairs + 2 * (value % 100);
+        value /= 100;
+        *-- end = pair[1];
+        *-- end = pair[0];
+    }
+    if (num_digits)
+        *-- end = char('0' + value % 10);
+}
+
+template<typename UInt>
+static inline size_t count_digits(UInt value)
+{
+    size_t num_digits = 1;
+    for (; value >= 10000; value /= 10000)
+        num_digits += 4;
+    return num_digits + (value >= 10) + (value >= 100) + (value >= 1000);
+}
+
+// Emit a non-negative fixed point number value / 10^Digits. The fractional part is emitted without the trailing zeros
+// and the integer part is omitted if zero, thus 0.5 is emitted as ".5".
+// Digits is a template parameter, so that the compiler replaces the divisions by multiplications.
+template<size_t Digits, typename UInt>
+static inline char* emit_unsigned_fixed_point(char *ptr, const UInt value)
+{
+    static constexpr const UInt divisor = [](){ UInt d = 1; for (size_t i = 0; i < Digits; ++ i) d *= 10; return d; }();
+    if (const UInt int_part = value / divisor; int_part != 0) {
+        const size_t num_digits = count_digits(int_part);
+        ptr += num_digits;
+        emit_digits(ptr, int_part, num_digits);
+    }
+    if constexpr (Digits > 0) {
+        if (const UInt fraction = value % divisor; fraction != 0) {
+            *ptr ++ = '.';
+            ptr += Digits;
+            emit_digits(ptr, fraction, Digits);
+            // Remove the trailing zeros, there is at least one non-zero digit.
+            while (ptr[-1] == '0')
+                -- ptr;
+        }
     }
+    return ptr;
+}
 
-    // Move all newly inserted chars by one to allocate space for a decimal point.
-    for (char *to_ptr = this->ptr_err.ptr, *from_ptr = to_ptr - 1; from_ptr >= this->ptr_err.ptr - digits; --to_ptr, --from_ptr)
-        *to_ptr = *from_ptr;
+template<size_t Digits>
+static inline char* emit_fixed_point(char *ptr, const int64_t v_int)
+{
+    if (v_int == 0) {
+        *ptr ++ = '0';
+        return ptr;
+    }
+    if (v_int < 0)
+        *ptr ++ = '-';
+    const uint64_t v_abs = v_int < 0 ? uint64_t(0) - uint64_t(v_int) : uint64_t(v_int);
+    // 32bit divisions are cheaper, and nearly all the G-code values fit.
+    return v_abs <= std::numeric_limits<uint32_t>::max() ?
+        emit_unsigned_fixed_point<Digits>(ptr, uint32_t(v_abs)) : emit_unsigned_fixed_point<Digits>(ptr, v_abs);
+}
 
-    *(this->ptr_err.ptr - digits) = '.';
-    for (size_t i = 0; i < digits; ++i) {
-        if (*this->ptr_err.ptr != '0')
-            break;
-        this->ptr_err.ptr--;
+void GCodeFormatter::emit_axis(const char axis, const double v, size_t digits) {
+    assert(digits <= 9);
+    static constexpr const std::array<double, 10> pow_10{1., 10., 100., 1000., 10000., 100000., 1000000., 10000000., 100000000., 1000000000.};
+    char *ptr = this->ptr_err.ptr;
+    *ptr ++ = ' '; *ptr ++ = axis;
+#if 0 // #ifndef NDEBUG
+    char *base_ptr = ptr;
+#endif
+    // At most 19 digits, the sign and the decimal point. this->buf_end minus 1 because we need space for the new line.
+    assert(ptr + 21 < this->buf_end - 1);
+
+    const int64_t v_int = int64_t(std::round(v * pow_10[digits]));
+    switch (digits) {
+    case 0: ptr = emit_fixed_point<0>(ptr, v_int); break;
+    case 1: ptr = emit_fixed_point<1>(ptr, v_int); break;
+    case 2: ptr = emit_fixed_point<2>(ptr, v_int); break;
+    case 3: ptr = emit_fixed_point<3>(ptr, v_int); break;
+    case 4: ptr = emit_fixed_point<4>(ptr, v_int); break;
+    case 5: ptr = emit_fixed_point<5>(ptr, v_int); break;
+    case 6: ptr = emit_fixed_point<6>(ptr, v_int); break;
+    case 7: ptr = emit_fixed_point<7>(ptr, v_int); break;
+    case 8: ptr = emit_fixed_point<8>(ptr, v_int); break;
+    default: ptr = emit_fixed_point<9>(ptr, v_int); break;
     }
-    if (*this->ptr_err.ptr == '.')
-        this->ptr_err.ptr--;
-    if ((this->ptr_err.ptr + 1) == base_ptr || *this->ptr_err.ptr == '-')
-        *(++this->ptr_err.ptr) = '0';
-    this->ptr_err.ptr++;
+    this->ptr_err.ptr = ptr;
 
 #if 0 // #ifndef NDEBUG
     {
         // Verify that the optimized formatter produces the same result as the standard sprintf().
-        double v1 = atof(std::string(base_ptr, this->ptr_err.ptr).c_str());
+        double v1 = atof(std::string(base_ptr, ptr).c_str());
         char buf[2048];
         sprintf(buf, "%.*lf", int(digits), v);
         double v2 = atof(buf);
@@ -2,8 +2,11 @@
 #include <igl/Hit.h>
 #include <oneapi/tbb/blocked_range.h>
 #include <oneapi/tbb/parallel_for.h>
+#include <algorithm>
+#include <array>
 #include <cmath>
 #include <cstdlib>
+#include <mutex>
 
 #include "libslic3r/ShortEdgeCollapse.hpp"
 #include "libslic3r/GCode/ModelVisibility.hpp"
@@ -126,6 +129,12 @@ std::vector<float> raycast_visibility(
                     &raycasting_tree, &result, &samples, &params](tbb::blocked_range<size_t> r) {
                 // Maintaining hits memory outside of the loop, so it does not have to be reallocated for each query.
                 std::vector<igl::Hit> hits;
+                // The rays cast from a single sample start at the same point, thus they are coherent enough
+                // to be traced through the AABB tree together.
+                constexpr size_t packet_size = 32;
+                std::array<Vec3d, packet_size> packet_origins;
+                std::array<Vec3d, packet_size> packet_dirs;
+                std::array<igl::Hit, packet_size> packet_hits;
                 for (size_t s_idx = r.begin(); s_idx < r.end(); ++s_idx) {
                     result[s_idx] = 1.0f;
                     const float decrease_step = 1.0f
@@ -137,50 +146,60 @@ std::vector<float> raycast_visibility(
                     Frame f;
                     f.set_from_z(normal);
 
-                    for (const auto &dir : precomputed_sample_directions) {
-                        Vec3f final_ray_dir = (f.to_world(dir));
-                        if (!model_contains_negative_parts) {
-                            igl::Hit hitpoint;
-                            // FIXME: This AABBTTreeIndirect query will not compile for float ray origin and
-                            // direction.
-                            Vec3d final_ray_dir_d = final_ray_dir.cast<double>();
-                            Vec3d ray_origin_d = (center + normal * 0.01f).cast<double>(); // start above surface.
-                            bool hit = AABBTreeIndirect::intersect_ray_first_hit(triangles.vertices,
-                                    triangles.indices, raycasting_tree, ray_origin_d, final_ray_dir_d, hitpoint);
-                            if (hit && its_face_normal(triangles, hitpoint.id).dot(final_ray_dir) <= 0) {
-                                result[s_idx] -= decrease_step;
+                    if (!model_contains_negative_parts) {
+                        // FIXME: This AABBTTreeIndirect query will not compile for float ray origin and
+                        // direction.
+                        packet_origins.fill((center + normal * 0.01f).cast<double>()); // start above surface.
+                        for (size_t begin = 0; begin < precomputed_sample_directions.size(); begin += packet_size) {
+                            const size_t num_rays = std::min(packet_size, precomputed_sample_directions.size() - begin);
+                            for (size_t i = 0; i < num_rays; ++i) {
+                                packet_dirs[i] = f.to_world(precomputed_sample_directions[begin + i]).cast<double>();
                             }
-                        } else { //TODO improve logic for order based boolean operations - consider order of volumes
-                            bool casting_from_negative_volume = samples.triangle_indices[s_idx]
-                                    >= negative_volumes_start_index;
-
-                            Vec3d ray_origin_d = (center + normal * 0.01f).cast<double>(); // start above surface.
-                            if (casting_from_negative_volume) { // if casting from negative volume face, invert direction, change start pos
-                                final_ray_dir = -1.0 * final_ray_dir;
-                                ray_origin_d = (center - normal * 0.01f).cast<double>();
-                            }
-                            Vec3d final_ray_dir_d = final_ray_dir.cast<double>();
-                            bool some_hit = AABBTreeIndirect::intersect_ray_all_hits(triangles.vertices,
-                                    triangles.indices, raycasting_tree,
-                                    ray_origin_d, final_ray_dir_d, hits);
-                            if (some_hit) {
-                                int counter = 0;
-                                // NOTE: iterating in reverse, from the last hit for one simple reason: We know the state of the ray at that point;
-                                //  It cannot be inside model, and it cannot be inside negative volume
-                                for (int hit_index = int(hits.size()) - 1; hit_index >= 0; --hit_index) {
-                                    Vec3f face_normal = its_face_normal(triangles, hits[hit_index].id);
-                                    if (hits[hit_index].id >= int(negative_volumes_start_index)) { //negative volume hit
-                                        counter -= sgn(face_normal.dot(final_ray_dir)); // if volume face aligns with ray dir, we are leaving negative space
-                                        // which in reverse hit analysis means, that we are entering negative space :) and vice versa
-                                    } else {
-                                        counter += sgn(face_normal.dot(final_ray_dir));
-                                    }
-                                }
-                                if (counter == 0) {
+                            AABBTreeIndirect::intersect_rays_first_hit(triangles.vertices, triangles.indices,
+                                    raycasting_tree, packet_origins, packet_dirs, num_rays, packet_hits);
+                            for (size_t i = 0; i < num_rays; ++i) {
+                                const Vec3f final_ray_dir = f.to_world(precomputed_sample_directions[begin + i]);
+                                if (packet_hits[i].id >= 0 &&
+                                        its_face_normal(triangles, packet_hits[i].id).dot(final_ray_dir) <= 0) {
                                     result[s_idx] -= decrease_step;
                                 }
                             }
                         }
+                        continue;
+                    }
+
+                    //TODO improve logic for order based boolean operations - consider order of volumes
+                    for (const auto &dir : precomputed_sample_directions) {
+                        Vec3f final_ray_dir = (f.to_world(dir));
+                        bool casting_from_negative_volume = samples.triangle_indices[s_idx]
+                                >= negative_volumes_start_index;
+
+                        Vec3d ray_origin_d = (center + normal * 0.01f).cast<double>(); // start above surface.
+                        if (casting_from_negative_volume) { // if casting from negative volume face, invert direction, change start pos
+                            final_ray_dir = -1.0 * final_ray_dir;
+                            ray_origin_d = (center - normal * 0.01f).cast<double>();
+                        }
+                        Vec3d final_ray_dir_d = final_ray_dir.cast<double>();
+                        bool some_hit = AABBTreeIndirect::intersect_ray_all_hits(triangles.vertices,
+                                triangles.indices, raycasting_tree,
+                                ray_origin_d, final_ray_dir_d, hits);
+                        if (some_hit) {
+                            int counter = 0;
+                            // NOTE: iterating in reverse, from the last hit for one simple reason: We know the state of the ray at that point;
+                            //  It cannot be inside model, and it cannot be inside negative volume
+                            for (int hit_index = int(hits.size()) - 1; hit_index >= 0; --hit_index) {
+                                Vec3f face_normal = its_face_normal(triangles, hits[hit_index].id);
+                                if (hits[hit_index].id >= int(negative_volumes_start_index)) { //negative volume hit
+                                    counter -= sgn(face_normal.dot(final_ray_dir)); // if volume face aligns with ray dir, we are leaving negative space
+                                    // which in reverse hit analysis means, that we are entering negative space :) and vice versa
+                                } else {
+                                    counter += sgn(face_normal.dot(final_ray_dir));
+                                }
+                            }
+                            if (counter == 0) {
+                                result[s_idx] -= decrease_step;
+                            }
+                        }
                     }
                 }
             });
@@ -276,6 +295,93 @@ Visibility::Visibility(
     throw_if_canceled();
 }
 
+namespace {
+
+struct CachedVisibility
+{
+    // Meshes, transformations and types of the model parts and negative volumes the visibility was calculated for.
+    std::vector<std::weak_ptr<const TriangleMesh>> meshes;
+    std::vector<Transform3d> matrices;
+    std::vector<ModelVolumeType> types;
+    Transform3d obj_transform;
+    Visibility::Params params;
+    std::shared_ptr<const Visibility> visibility;
+};
+
+// Visibility is calculated again when the G-code is exported after the perimeters changed, while the object did not.
+// Just a few objects with different geometries are kept, the least recently used ones are dropped first.
+constexpr size_t visibility_cache_max_entries = 8;
+std::mutex visibility_cache_mutex;
+std::vector<CachedVisibility> visibility_cache;
+
+CachedVisibility visibility_cache_key(const Transform3d &obj_transform, const ModelVolumePtrs &volumes, const Visibility::Params &params)
+{
+    CachedVisibility out;
+    for (const ModelVolume *model_volume : volumes) {
+        if (model_volume->type() == ModelVolumeType::MODEL_PART
+                || model_volume->type() == ModelVolumeType::NEGATIVE_VOLUME) {
+            out.meshes.emplace_back(model_volume->get_mesh_shared_ptr());
+            out.matrices.emplace_back(model_volume->get_matrix());
+            out.types.emplace_back(model_volume->type());
+        }
+    }
+    out.obj_transform = obj_transform;
+    out.params = params;
+    return out;
+}
+
+bool visibility_cache_key_matches(const CachedVisibility &lhs, const CachedVisibility &rhs)
+{
+    if (lhs.meshes.size() != rhs.meshes.size() || lhs.types != rhs.types || !(lhs.params == rhs.params) ||
+            !lhs.obj_transform.isApprox(rhs.obj_transform, 0.)) {
+        return false;
+    }
+    for (size_t i = 0; i < lhs.meshes.size(); ++i) {
+        // Compare the owners, not the addresses, an expired mesh does not match a new mesh allocated at its address.
+        if (lhs.meshes[i].owner_before(rhs.meshes[i]) || rhs.meshes[i].owner_before(lhs.meshes[i]) ||
+                lhs.meshes[i].expired() || !lhs.matrices[i].isApprox(rhs.matrices[i], 0.)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+std::shared_ptr<const Visibility> Visibility::cached(
+    const Transform3d &obj_transform,
+    const ModelVolumePtrs &volumes,
+    const Params &params,
+    const std::function<void(void)> &throw_if_canceled
+) {
+    CachedVisibility key{visibility_cache_key(obj_transform, volumes, params)};
+    {
+        std::scoped_lock<std::mutex> lock(visibility_cache_mutex);
+        visibility_cache.erase(std::remove_if(visibility_cache.begin(), visibility_cache.end(), [](const CachedVisibility &entry) {
+            return std::any_of(entry.meshes.begin(), entry.meshes.end(), [](const std::weak_ptr<const TriangleMesh> &mesh) { return mesh.expired(); });
+        }), visibility_cache.end());
+        auto it = std::find_if(visibility_cache.begin(), visibility_cache.end(), [&key](const CachedVisibility &entry) {
+            return visibility_cache_key_matches(entry, key);
+        });
+        if (it != visibility_cache.end()) {
+            // Move the entry to the back, which holds the most recently used entries.
+            std::rotate(it, it + 1, visibility_cache.end());
+            BOOST_LOG_TRIVIAL(debug) << "SeamPlacer: reusing cached visibility";
+            return visibility_cache.back().visibility;
+        }
+    }
+
+    // Calculated outside of the lock, so that the visibilities of different objects are calculated in parallel.
+    key.visibility = std::make_shared<const Visibility>(obj_transform, volumes, params, throw_if_canceled);
+    std::shared_ptr<const Visibility> out = key.visibility;
+    std::scoped_lock<std::mutex> lock(visibility_cache_mutex);
+    if (visibility_cache.size() >= visibility_cache_max_entries) {
+        visibility_cache.erase(visibility_cache.begin());
+    }
+    visibility_cache.emplace_back(std::move(key));
+    return out;
+}
+
 float Visibility::calculate_point_visibility(const Vec3f &position) const {
     std::vector<size_t> points = find_nearby_points(mesh_samples_tree, position, mesh_samples_radius);
     if (points.empty()) {
@@ -3,6 +3,7 @@
 
 #include <stddef.h>
 #include <functional>
+#include <memory>
 #include <vector>
 #include <cstddef>
 
@@ -34,6 +35,12 @@ struct Visibility
         size_t fast_decimation_triangle_count_target{};
         // square of number of rays per sample point
         size_t sqr_rays_per_sample_point{};
+
+        bool operator==(const Params &rhs) const {
+            return raycasting_visibility_samples_count == rhs.raycasting_visibility_samples_count &&
+                fast_decimation_triangle_count_target == rhs.fast_decimation_triangle_count_target &&
+                sqr_rays_per_sample_point == rhs.sqr_rays_per_sample_point;
+        }
     };
 
     Visibility(
@@ -43,6 +50,15 @@ struct Visibility
         const std::function<void(void)> &throw_if_canceled
     );
 
+    // Returns the visibility calculated before for the same volume meshes, transformations and params if it is still cached,
+    // otherwise calculates it and caches it. The visibility is kept while the volume meshes are alive and it was used recently.
+    static std::shared_ptr<const Visibility> cached(
+        const Transform3d &obj_transform,
+        const ModelVolumePtrs &volumes,
+        const Params &params,
+        const std::function<void(void)> &throw_if_canceled
+    );
+
     TriangleSetSamples mesh_samples;
     std::vector<float> mesh_samples_visibility;
     Impl::CoordinateFunctor mesh_samples_coordinate_functor;
@@ -623,10 +623,13 @@ void PressureEqualizer::adjust_volumetric_rate(const size_t first_line_idx, cons
         // Nothing to do, the last move is not extruding.
         return;
 
-    std::array<float, size_t(GCodeExtrusionRole::Count)> feedrate_per_extrusion_role{};
-    feedrate_per_extrusion_role.fill(std::numeric_limits<float>::max());
-    feedrate_per_extrusion_role[int(m_gcode_lines[line_idx].extrusion_role)] = m_gcode_lines[line_idx].volumetric_extrusion_rate_start;
+    // The limiter propagates the volumetric extrusion rate of a single extrusion role only, the role of the segment
+    // the pass starts with, thus there is a single rate to propagate instead of a rate per extrusion role.
+    // GCodeExtrusionRole::None is never propagated.
+    auto propagated_role = [](const GCodeLine &line) -> int { return line.extrusion_role == GCodeExtrusionRole::None ? -1 : int(line.extrusion_role); };
 
+    int   role      = propagated_role(m_gcode_lines[line_idx]);
+    float role_rate = m_gcode_lines[line_idx].volumetric_extrusion_rate_start;
     while (line_idx != first_line_idx) {
         size_t idx_prev = line_idx - 1;
         for (; !m_gcode_lines[idx_prev].extruding() && idx_prev != first_line_idx; --idx_prev);
@@ -643,48 +646,46 @@ void PressureEqualizer::adjust_volumetric_rate(const size_t first_line_idx, cons
         line_idx        = idx_prev;
         GCodeLine &line = m_gcode_lines[line_idx];
 
-        for (size_t iRole = 1; iRole < size_t(GCodeExtrusionRole::Count); ++ iRole) {
-            const float &rate_slope = m_max_volumetric_extrusion_rate_slopes[iRole].negative;
-            if (rate_slope == 0 || feedrate_per_extrusion_role[iRole] == std::numeric_limits<float>::max())
-                continue; // The negative rate is unlimited or the rate for GCodeExtrusionRole iRole is unlimited.
-
-            float rate_end = feedrate_per_extrusion_role[iRole];
-            if (iRole == size_t(line.extrusion_role) && rate_succ < rate_end)
-                // Limit by the succeeding volumetric flow rate.
-                rate_end = rate_succ;
-
-            // Don't alter the flow rate for these extrusion types.
-            if (!line.adjustable_flow || line.extrusion_role == GCodeExtrusionRole::BridgeInfill || line.extrusion_role == GCodeExtrusionRole::Ironing) {
-                rate_end = line.volumetric_extrusion_rate_end;
-            } else if (line.volumetric_extrusion_rate_end > rate_end) {
-                line.volumetric_extrusion_rate_end = rate_end;
+        const float rate_slope = role == -1 ? 0.f : m_max_volumetric_extrusion_rate_slopes[role].negative;
+        if (rate_slope == 0)
+            continue; // The negative rate is unlimited.
+
+        float rate_end = role_rate;
+        if (role == int(line.extrusion_role) && rate_succ < rate_end)
+            // Limit by the succeeding volumetric flow rate.
+            rate_end = rate_succ;
+
+        // Don't alter the flow rate for these extrusion types.
+        if (!line.adjustable_flow || line.extrusion_role == GCodeExtrusionRole::BridgeInfill || line.extrusion_role == GCodeExtrusionRole::Ironing) {
+            rate_end = line.volumetric_extrusion_rate_end;
+        } else if (line.volumetric_extrusion_rate_end > rate_end) {
+            line.volumetric_extrusion_rate_end = rate_end;
+            line.max_volumetric_extrusion_rate_slope_negative = rate_slope;
+            line.modified = true;
+        } else if (role == int(line.extrusion_role)) {
+            rate_end = line.volumetric_extrusion_rate_end;
+        } else {
+            // Use the original, 'floating' extrusion rate as a starting point for the limiter.
+        }
+
+        if (line.adjustable_flow) {
+            float rate_start = sqrt(rate_end * rate_end + 2 * line.volumetric_extrusion_rate * line.dist_xyz() * rate_slope / line.feedrate());
+            if (rate_start < line.volumetric_extrusion_rate_start) {
+                // Limit the volumetric extrusion rate at the start of this segment due to a segment
+                // of the propagated extrusion role, which will be extruded in the future.
+                line.volumetric_extrusion_rate_start = rate_start;
                 line.max_volumetric_extrusion_rate_slope_negative = rate_slope;
                 line.modified = true;
-            } else if (iRole == size_t(line.extrusion_role)) {
-                rate_end = line.volumetric_extrusion_rate_end;
-            } else {
-                // Use the original, 'floating' extrusion rate as a starting point for the limiter.
             }
-
-            if (line.adjustable_flow) {
-                float rate_start = sqrt(rate_end * rate_end + 2 * line.volumetric_extrusion_rate * line.dist_xyz() * rate_slope / line.feedrate());
-                if (rate_start < line.volumetric_extrusion_rate_start) {
-                    // Limit the volumetric extrusion rate at the start of this segment due to a segment
-                    // of ExtrusionType iRole, which will be extruded in the future.
-                    line.volumetric_extrusion_rate_start = rate_start;
-                    line.max_volumetric_extrusion_rate_slope_negative = rate_slope;
-                    line.modified = true;
-                }
-            }
-
-            // Don't store feed rate for ironing.
-            if (line.extrusion_role != GCodeExtrusionRole::Ironing)
-                feedrate_per_extrusion_role[iRole] = line.volumetric_extrusion_rate_start;
         }
+
+        // Don't store feed rate for ironing.
+        if (line.extrusion_role != GCodeExtrusionRole::Ironing)
+            role_rate = line.volumetric_extrusion_rate_start;
     }
 
-    feedrate_per_extrusion_role.fill(std::numeric_limits<float>::max());
-    feedrate_per_extrusion_role[size_t(m_gcode_lines[line_idx].extrusion_role)] = m_gcode_lines[line_idx].volumetric_extrusion_rate_end;
+    role      = propagated_role(m_gcode_lines[line_idx]);
+    role_rate = m_gcode_lines[line_idx].volumetric_extrusion_rate_end;
 
     assert(m_gcode_lines[line_idx].extruding());
     while (line_idx != last_line_idx) {
@@ -702,42 +703,40 @@ void PressureEqualizer::adjust_volumetric_rate(const size_t first_line_idx, cons
         line_idx = idx_next;
         GCodeLine &line = m_gcode_lines[line_idx];
 
-        for (size_t iRole = 1; iRole < size_t(GCodeExtrusionRole::Count); ++ iRole) {
-            const float &rate_slope = m_max_volumetric_extrusion_rate_slopes[iRole].positive;
-            if (rate_slope == 0 || feedrate_per_extrusion_role[iRole] == std::numeric_limits<float>::max())
-                continue; // The positive rate is unlimited or the rate for GCodeExtrusionRole iRole is unlimited.
-
-            float rate_start = feedrate_per_extrusion_role[iRole];
-            // Don't alter the flow rate for these extrusion types.
-            if (!line.adjustable_flow || line.extrusion_role == GCodeExtrusionRole::BridgeInfill || line.extrusion_role == GCodeExtrusionRole::Ironing) {
-                rate_start = line.volumetric_extrusion_rate_start;
-            } else if (iRole == size_t(line.extrusion_role) && rate_prec < rate_start)
-                rate_start = rate_prec;
-            if (line.volumetric_extrusion_rate_start > rate_start) {
-                line.volumetric_extrusion_rate_start = rate_start;
-                line.max_volumetric_extrusion_rate_slope_positive = rate_slope;
-                line.modified = true;
-            } else if (iRole == size_t(line.extrusion_role)) {
-                rate_start = line.volumetric_extrusion_rate_start;
-            } else {
-                // Use the original, 'floating' extrusion rate as a starting point for the limiter.
-            }
+        const float rate_slope = role == -1 ? 0.f : m_max_volumetric_extrusion_rate_slopes[role].positive;
+        if (rate_slope == 0)
+            continue; // The positive rate is unlimited.
+
+        float rate_start = role_rate;
+        // Don't alter the flow rate for these extrusion types.
+        if (!line.adjustable_flow || line.extrusion_role == GCodeExtrusionRole::BridgeInfill || line.extrusion_role == GCodeExtrusionRole::Ironing) {
+            rate_start = line.volumetric_extrusion_rate_start;
+        } else if (role == int(line.extrusion_role) && rate_prec < rate_start)
+            rate_start = rate_prec;
+        if (line.volumetric_extrusion_rate_start > rate_start) {
+            line.volumetric_extrusion_rate_start = rate_start;
+            line.max_volumetric_extrusion_rate_slope_positive = rate_slope;
+            line.modified = true;
+        } else if (role == int(line.extrusion_role)) {
+            rate_start = line.volumetric_extrusion_rate_start;
+        } else {
+            // Use the original, 'floating' extrusion rate as a starting point for the limiter.
+        }
 
-            if (line.adjustable_flow) {
-                float rate_end = sqrt(rate_start * rate_start + 2 * line.volumetric_extrusion_rate * line.dist_xyz() * rate_slope / line.feedrate());
-                if (rate_end < line.volumetric_extrusion_rate_end) {
-                    // Limit the volumetric extrusion rate at the start of this segment due to a segment
-                    // of ExtrusionType iRole, which was extruded before.
-                    line.volumetric_extrusion_rate_end                = rate_end;
-                    line.max_volumetric_extrusion_rate_slope_positive = rate_slope;
-                    line.modified                                     = true;
-                }
+        if (line.adjustable_flow) {
+            float rate_end = sqrt(rate_start * rate_start + 2 * line.volumetric_extrusion_rate * line.dist_xyz() * rate_slope / line.feedrate());
+            if (rate_end < line.volumetric_extrusion_rate_end) {
+                // Limit the volumetric extrusion rate at the start of this segment due to a segment
+                // of the propagated extrusion role, which was extruded before.
+                line.volumetric_extrusion_rate_end                = rate_end;
+                line.max_volumetric_extrusion_rate_slope_positive = rate_slope;
+                line.modified                                     = true;
             }
-
-            // Don't store feed rate for ironing
-            if (line.extrusion_role != GCodeExtrusionRole::Ironing)
-                feedrate_per_extrusion_role[iRole] = line.volumetric_extrusion_rate_end;
         }
+
+        // Don't store feed rate for ironing
+        if (line.extrusion_role != GCodeExtrusionRole::Ironing)
+            role_rate = line.volumetric_extrusion_rate_end;
     }
 }
 
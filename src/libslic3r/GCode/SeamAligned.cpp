@@ -6,6 +6,7 @@
 #include <limits>
 #include <stdexcept>
 #include <utility>
+#include <oneapi/tbb/parallel_for.h>
 
 #include "libslic3r/GCode/SeamGeometry.hpp"
 #include "libslic3r/GCode/ModelVisibility.hpp"
@@ -371,11 +372,10 @@ using ShellStartingPositions = std::vector<Vec2d>;
 std::vector<ShellStartingPositions> get_shells_starting_positions(
     const Shells::Shells<> &shells
 ) {
-    std::vector<ShellStartingPositions> result;
-    for (const Shells::Shell<> &shell : shells) {
-        std::vector<Vec2d> starting_positions{get_starting_positions(shell)};
-        result.push_back(std::move(starting_positions));
-    }
+    std::vector<ShellStartingPositions> result(shells.size());
+    tbb::parallel_for(size_t(0), shells.size(), [&](const size_t shell_index) {
+        result[shell_index] = get_starting_positions(shells[shell_index]);
+    });
     return result;
 }
 
@@ -112,6 +112,18 @@ std::pair<Mapping, std::size_t> get_mapping(
 
     std::size_t new_bucket_id{result.back().size()};
 
+    // Evaluate the mapping operator for all the items in parallel, only the assignment of buckets is sequential.
+    std::vector<std::vector<MappingOperatorResult>> next_items(list_sizes.size() - 1);
+    using Range = tbb::blocked_range<size_t>;
+    tbb::parallel_for(Range{0, next_items.size()}, [&](Range range) {
+        for (std::size_t layer_index{range.begin()}; layer_index < range.end(); ++layer_index) {
+            next_items[layer_index].reserve(list_sizes[layer_index]);
+            for (std::size_t item_index{0}; item_index < list_sizes[layer_index]; ++item_index) {
+                next_items[layer_index].push_back(mapping_operator(layer_index, item_index));
+            }
+        }
+    });
+
     for (std::size_t layer_index{0}; layer_index < list_sizes.size() - 1; ++layer_index) {
         // Current layer is already assigned mapping.
 
@@ -119,8 +131,7 @@ std::pair<Mapping, std::size_t> get_mapping(
         std::vector<std::optional<Link>> links(list_sizes[layer_index + 1]);
 
         for (std::size_t item_index{0}; item_index < list_sizes[layer_index]; ++item_index) {
-            const MappingOperatorResult next_item{
-                mapping_operator(layer_index, item_index)};
+            const MappingOperatorResult &next_item{next_items[layer_index][item_index]};
             if (next_item) {
                 const auto [index, weight] = *next_item;
                 const Link link{result.back()[item_index], weight};
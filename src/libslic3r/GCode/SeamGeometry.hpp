@@ -109,7 +109,8 @@ using MappingOperator = std::function<MappingOperatorResult(std::size_t, std::si
  * @param list_sizes Vector of sizes of the original lists in a list.
  * @param mapping_operator Operator that takes layer index and item index on that layer as input
  * and returns the best fitting item index from the next layer, along with weight, representing how
- * good the fit is. It may return nullopt if there is no good fit.
+ * good the fit is. It may return nullopt if there is no good fit. It is called from multiple
+ * threads in parallel.
  *
  * @return Mapping [outter_list_index][inner_list_index] -> bucket id and the number of buckets.
  */
@@ -7,6 +7,8 @@
 
 #include <boost/filesystem/operations.hpp>
 #include <boost/property_tree/json_parser.hpp>
+#include <oneapi/tbb/parallel_for.h>
+#include <memory>
 
 #include "SeamPlacer.hpp"
 
@@ -28,9 +30,10 @@ ObjectLayerPerimeters get_perimeters(
     const ObjectPainting& object_painting,
     const std::function<void(void)> &throw_if_canceled
 ) {
-    ObjectLayerPerimeters result;
-
-    for (const PrintObject *print_object : objects) {
+    // The objects are processed in parallel.
+    std::vector<Perimeters::LayerPerimeters> object_perimeters(objects.size());
+    tbb::parallel_for(size_t(0), objects.size(), [&](const size_t object_index) {
+        const PrintObject *print_object{objects[object_index]};
         const ModelInfo::Painting &painting{object_painting.at(print_object)};
         throw_if_canceled();
 
@@ -42,10 +45,13 @@ ObjectLayerPerimeters get_perimeters(
         const std::vector<Geometry::BoundedPolygons> projected{
             Geometry::project_to_geometry(extrusions, params.max_distance)
         };
-        Perimeters::LayerPerimeters perimeters{Perimeters::create_perimeters(projected, layer_infos, painting, params.perimeter)};
-
+        object_perimeters[object_index] = Perimeters::create_perimeters(projected, layer_infos, painting, params.perimeter);
         throw_if_canceled();
-        result.emplace(print_object, std::move(perimeters));
+    });
+
+    ObjectLayerPerimeters result;
+    for (std::size_t object_index{0}; object_index < objects.size(); ++object_index) {
+        result.emplace(objects[object_index], std::move(object_perimeters[object_index]));
     }
     return result;
 }
@@ -65,46 +71,103 @@ Perimeters::LayerPerimeters sort_to_layers(Shells::Shells<> &&shells) {
     return result;
 }
 
+/**
+ * @brief Return true if the model visibility of both objects is the same.
+ *
+ * The copies of a ModelObject share the meshes of their volumes.
+ */
+bool same_visibility_geometry(const PrintObject &lhs, const PrintObject &rhs) {
+    const ModelVolumePtrs &lhs_volumes{lhs.model_object()->volumes};
+    const ModelVolumePtrs &rhs_volumes{rhs.model_object()->volumes};
+    if (lhs_volumes.size() != rhs_volumes.size() ||
+        lhs.trafo_centered().matrix() != rhs.trafo_centered().matrix()) {
+        return false;
+    }
+    for (std::size_t volume_index{0}; volume_index < lhs_volumes.size(); ++volume_index) {
+        const ModelVolume &lhs_volume{*lhs_volumes[volume_index]};
+        const ModelVolume &rhs_volume{*rhs_volumes[volume_index]};
+        if (&lhs_volume.mesh() != &rhs_volume.mesh() || lhs_volume.type() != rhs_volume.type() ||
+            lhs_volume.get_matrix().matrix() != rhs_volume.get_matrix().matrix()) {
+            return false;
+        }
+    }
+    return true;
+}
+
 ObjectSeams precalculate_seams(
     const Params &params,
     ObjectLayerPerimeters &&seam_data,
     const std::function<void(void)> &throw_if_canceled
 ) {
-    ObjectSeams result;
-
+    std::vector<std::pair<const PrintObject *, Perimeters::LayerPerimeters *>> objects;
     for (auto &[print_object, layer_perimeters] : seam_data) {
+        objects.emplace_back(print_object, &layer_perimeters);
+    }
+
+    // Raycasting the model visibility is the most expensive part, calculate it once for the objects with the same geometry.
+    std::vector<std::shared_ptr<const Slic3r::ModelInfo::Visibility>> visibilities(objects.size());
+    std::vector<std::size_t> visibility_source(objects.size());
+    std::vector<std::size_t> unique_visibilities;
+    for (std::size_t object_index{0}; object_index < objects.size(); ++object_index) {
+        const PrintObject *print_object{objects[object_index].first};
+        if (print_object->config().seam_position.value != spAligned) {
+            continue;
+        }
+        auto it{std::find_if(unique_visibilities.begin(), unique_visibilities.end(), [&](const std::size_t other_index) {
+            return same_visibility_geometry(*objects[other_index].first, *print_object);
+        })};
+        if (it == unique_visibilities.end()) {
+            unique_visibilities.push_back(object_index);
+            visibility_source[object_index] = object_index;
+        } else {
+            visibility_source[object_index] = *it;
+        }
+    }
+    tbb::parallel_for(size_t(0), unique_visibilities.size(), [&](const size_t i) {
+        const PrintObject *print_object{objects[unique_visibilities[i]].first};
+        visibilities[unique_visibilities[i]] = Slic3r::ModelInfo::Visibility::cached(
+            print_object->trafo_centered(), print_object->model_object()->volumes, params.visibility, throw_if_canceled
+        );
+    });
+    throw_if_canceled();
+
+    // The objects are processed in parallel.
+    std::vector<std::vector<std::vector<SeamPerimeterChoice>>> object_seams(objects.size());
+    tbb::parallel_for(size_t(0), objects.size(), [&](const size_t object_index) {
+        const auto &[print_object, layer_perimeters] = objects[object_index];
         switch (print_object->config().seam_position.value) {
         case spAligned: {
-            const Transform3d transformation{print_object->trafo_centered()};
-            const ModelVolumePtrs &volumes{print_object->model_object()->volumes};
-
-            Slic3r::ModelInfo::Visibility
-                points_visibility{transformation, volumes, params.visibility, throw_if_canceled};
-            throw_if_canceled();
             const Aligned::VisibilityCalculator visibility_calculator{
-                points_visibility, params.convex_visibility_modifier,
+                *visibilities[visibility_source[object_index]], params.convex_visibility_modifier,
                 params.concave_visibility_modifier};
 
-            Shells::Shells<> shells{Shells::create_shells(std::move(layer_perimeters), params.max_distance)};
-            result[print_object] = Aligned::get_object_seams(
+            Shells::Shells<> shells{Shells::create_shells(std::move(*layer_perimeters), params.max_distance)};
+            object_seams[object_index] = Aligned::get_object_seams(
                 std::move(shells), visibility_calculator, params.aligned
             );
             break;
         }
         case spRear: {
-            result[print_object] = Rear::get_object_seams(std::move(layer_perimeters), params.rear_tolerance, params.rear_y_offset);
+            object_seams[object_index] = Rear::get_object_seams(std::move(*layer_perimeters), params.rear_tolerance, params.rear_y_offset);
             break;
         }
         case spRandom: {
-            result[print_object] = Random::get_object_seams(std::move(layer_perimeters), params.random_seed);
+            object_seams[object_index] = Random::get_object_seams(std::move(*layer_perimeters), params.random_seed);
             break;
         }
         case spNearest: {
             // Do not precalculate anything.
-            break;
+            return;
         }
         }
         throw_if_canceled();
+    });
+
+    ObjectSeams result;
+    for (std::size_t object_index{0}; object_index < objects.size(); ++object_index) {
+        if (objects[object_index].first->config().seam_position.value != spNearest) {
+            result[objects[object_index].first] = std::move(object_seams[object_index]);
+        }
     }
     return result;
 }
@@ -150,30 +213,67 @@ Params Placer::get_params(const DynamicPrintConfig &config) {
 void Placer::init(
     SpanOfConstPtrs<PrintObject> objects,
     const Params &params,
-    const std::function<void(void)> &throw_if_canceled
+    const std::function<void(void)> &throw_if_canceled,
+    const bool reuse_cached
 ) {
     BOOST_LOG_TRIVIAL(debug) << "SeamPlacer: init: start";
 
-    ObjectPainting object_painting;
+    this->params = params;
+    this->placements.clear();
+
+    // The seam placement of an object depends on its perimeters, its seam painting and the seam placement parameters.
+    // The other parameters returned by get_params() are constant or they invalidate posPerimeters.
+    std::vector<std::shared_ptr<ObjectSeamPlacement>> fresh_placements;
+    std::vector<const PrintObject *> objects_to_place;
     for (const PrintObject *print_object : objects) {
+        auto placement{std::make_shared<ObjectSeamPlacement>()};
+        placement->perimeters_timestamp = print_object->step_state_with_timestamp(posPerimeters).timestamp;
+        placement->seam_position = print_object->config().seam_position.value;
+        placement->elephant_foot_compensation = params.perimeter.elephant_foot_compensation;
+        for (const ModelVolume *volume : print_object->model_object()->volumes) {
+            placement->seam_painting_timestamps.push_back(volume->seam_facets.timestamp());
+        }
+        if (reuse_cached && print_object->seam_placement_cache &&
+            print_object->seam_placement_cache->inputs_match(*placement)) {
+            this->placements[print_object] = print_object->seam_placement_cache;
+        } else {
+            fresh_placements.push_back(std::move(placement));
+            objects_to_place.push_back(print_object);
+        }
+    }
+    BOOST_LOG_TRIVIAL(debug) << "SeamPlacer: init: reusing seams of " << this->placements.size() << " objects";
+
+    ObjectPainting object_painting;
+    for (const PrintObject *print_object : objects_to_place) {
         const Transform3d transformation{print_object->trafo_centered()};
         const ModelVolumePtrs &volumes{print_object->model_object()->volumes};
         object_painting.emplace(print_object, ModelInfo::Painting{transformation, volumes});
     }
 
-    ObjectLayerPerimeters perimeters{get_perimeters(objects, params, object_painting, throw_if_canceled)};
+    ObjectLayerPerimeters perimeters{get_perimeters(objects_to_place, params, object_painting, throw_if_canceled)};
     ObjectLayerPerimeters perimeters_for_precalculation;
 
     for (auto &[print_object, layer_perimeters] : perimeters) {
-        if (print_object->config().seam_position.value == spNearest) {
-            this->perimeters_per_layer[print_object] = std::move(layer_perimeters);
-        } else {
+        if (print_object->config().seam_position.value != spNearest) {
             perimeters_for_precalculation[print_object] = std::move(layer_perimeters);
         }
     }
 
-    this->params = params;
-    this->seams_per_object = precalculate_seams(params, std::move(perimeters_for_precalculation), throw_if_canceled);
+    ObjectSeams seams_per_object{precalculate_seams(params, std::move(perimeters_for_precalculation), throw_if_canceled)};
+
+    for (std::size_t object_index{0}; object_index < objects_to_place.size(); ++object_index) {
+        const PrintObject *print_object{objects_to_place[object_index]};
+        ObjectSeamPlacement &placement{*fresh_placements[object_index]};
+        if (print_object->config().seam_position.value == spNearest) {
+            placement.perimeters = std::move(perimeters[print_object]);
+        } else {
+            placement.seams = std::move(seams_per_object[print_object]);
+        }
+        this->placements[print_object] = fresh_placements[object_index];
+        if (reuse_cached) {
+            print_object->seam_placement_cache = std::move(fresh_placements[object_index]);
+        }
+    }
 
     BOOST_LOG_TRIVIAL(debug) << "SeamPlacer: init: end";
 }
@@ -546,7 +646,7 @@ boost::variant<Point, Scarf::Scarf> Placer::place_seam(
 
     if (po->config().seam_position.value == spNearest) {
         const std::vector<Perimeters::BoundedPerimeter> &perimeters{
-            this->perimeters_per_layer.at(po)[layer_index]};
+            this->placements.at(po)->perimeters[layer_index]};
         const auto [seam_choice, perimeter_index] =
             place_seam_near(perimeters, loop, last_pos, this->params.max_nearest_detour);
         return finalize_seam_position(
@@ -554,7 +654,7 @@ boost::variant<Point, Scarf::Scarf> Placer::place_seam(
             this->params.staggered_inner_seams, flipped, thick_bridges
         );
     } else {
-        const std::vector<SeamPerimeterChoice> &seams_on_perimeters{this->seams_per_object.at(po)[layer_index]};
+        const std::vector<SeamPerimeterChoice> &seams_on_perimeters{this->placements.at(po)->seams[layer_index]};
 
         // Special case.
         // If there are only two perimeters and the current perimeter is hole (clockwise).
@@ -43,15 +43,38 @@ struct Params
 
 std::ostream& operator<<(std::ostream& os, const Params& params);
 
+// Seam placement of a single object calculated by Placer::init().
+struct ObjectSeamPlacement
+{
+    // Inputs, which are not covered by the timestamp of posPerimeters.
+    PrintStateBase::TimeStamp perimeters_timestamp{};
+    SeamPosition seam_position{};
+    double elephant_foot_compensation{};
+    std::vector<ObjectBase::Timestamp> seam_painting_timestamps;
+
+    // Perimeters of the layers for the nearest seam, otherwise the precalculated seams.
+    Perimeters::LayerPerimeters perimeters;
+    std::vector<std::vector<SeamPerimeterChoice>> seams;
+
+    bool inputs_match(const ObjectSeamPlacement &rhs) const {
+        return perimeters_timestamp == rhs.perimeters_timestamp && seam_position == rhs.seam_position &&
+            elephant_foot_compensation == rhs.elephant_foot_compensation &&
+            seam_painting_timestamps == rhs.seam_painting_timestamps;
+    }
+};
+
 class Placer
 {
 public:
     static Params get_params(const DynamicPrintConfig &config);
 
+    // If reuse_cached, the seam placement of the objects is reused from the previous calls if its inputs did not change.
+    // The calculated seam placement is cached with the PrintObject, see PrintObject::seam_placement_cache.
     void init(
         SpanOfConstPtrs<PrintObject> objects,
         const Params &params,
-        const std::function<void(void)> &throw_if_canceled
+        const std::function<void(void)> &throw_if_canceled,
+        const bool reuse_cached = false
     );
 
     boost::variant<Point, Scarf::Scarf> place_seam(
@@ -60,8 +83,7 @@ public:
 
 private:
     Params params;
-    ObjectSeams seams_per_object;
-    ObjectLayerPerimeters perimeters_per_layer;
+    std::unordered_map<const PrintObject *, std::shared_ptr<const ObjectSeamPlacement>> placements;
 };
 
 } // namespace Slic3r::Seams
@@ -36,8 +36,16 @@ Shells<> create_shells(
 
     std::vector<std::size_t> layer_sizes;
     layer_sizes.reserve(perimeters.size());
+    // Bounding boxes of the perimeters, collected once per layer, not for each perimeter of the layer below.
+    std::vector<BoundingBoxes> layer_bounding_boxes;
+    layer_bounding_boxes.reserve(perimeters.size());
     for (const BoundedPerimeters &layer : perimeters) {
         layer_sizes.push_back(layer.size());
+        BoundingBoxes &bounding_boxes{layer_bounding_boxes.emplace_back()};
+        bounding_boxes.reserve(layer.size());
+        for (const BoundedPerimeter &bounded_perimeter : layer) {
+            bounding_boxes.emplace_back(bounded_perimeter.bounding_box);
+        }
     }
 
     const auto &[shell_mapping, shell_count]{Geometry::get_mapping(
@@ -45,16 +53,11 @@ Shells<> create_shells(
         [&](const std::size_t layer_index,
             const std::size_t item_index) -> Geometry::MappingOperatorResult {
             const BoundedPerimeters &layer{perimeters[layer_index]};
-            const BoundedPerimeters &next_layer{perimeters[layer_index + 1]};
-            if (next_layer.empty()) {
+            const BoundingBoxes &next_layer_bounding_boxes{layer_bounding_boxes[layer_index + 1]};
+            if (next_layer_bounding_boxes.empty()) {
                 return std::nullopt;
             }
 
-            BoundingBoxes next_layer_bounding_boxes;
-            for (const BoundedPerimeter &bounded_perimeter : next_layer) {
-                next_layer_bounding_boxes.emplace_back(bounded_perimeter.bounding_box);
-            }
-
             const auto [perimeter_index, distance] = Geometry::pick_closest_bounding_box(
                 layer[item_index].bounding_box, next_layer_bounding_boxes
             );
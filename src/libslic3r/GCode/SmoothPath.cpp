@@ -6,6 +6,9 @@
 #include <utility>
 #include <cassert>
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
 #include "../ExtrusionEntity.hpp"
 #include "../ExtrusionEntityCollection.hpp"
 #include "libslic3r/Geometry/ArcWelder.hpp"
@@ -120,7 +123,7 @@ void reverse(SmoothPath &path) {
         Geometry::ArcWelder::reverse(path_element.path);
 }
 
-void SmoothPathCache::interpolate_add(const ExtrusionPath &path, const InterpolationParameters &params)
+static Geometry::ArcWelder::Path interpolate(const ExtrusionPath &path, const SmoothPathCache::InterpolationParameters &params)
 {
     double tolerance = params.tolerance;
     if (path.role().is_sparse_infill())
@@ -133,7 +136,12 @@ void SmoothPathCache::interpolate_add(const ExtrusionPath &path, const Interpola
         // Brim is currently marked as skirt.
         // Use 4x lower resolution than the object fine detail for skirt & brim.
         tolerance *= 4.;
-    m_cache[&path.polyline] = Slic3r::Geometry::ArcWelder::fit_path(path.polyline.points, tolerance, params.fit_circle_tolerance);
+    return Slic3r::Geometry::ArcWelder::fit_path(path.polyline.points, tolerance, params.fit_circle_tolerance);
+}
+
+void SmoothPathCache::interpolate_add(const ExtrusionPath &path, const InterpolationParameters &params)
+{
+    m_cache[&path.polyline] = interpolate(path, params);
 }
 
 void SmoothPathCache::interpolate_add(const ExtrusionMultiPath &multi_path, const InterpolationParameters &params)
@@ -148,22 +156,40 @@ void SmoothPathCache::interpolate_add(const ExtrusionLoop &loop, const Interpola
         this->interpolate_add(path, params);
 }
 
-void SmoothPathCache::interpolate_add(const ExtrusionEntityCollection &eec, const InterpolationParameters &params)
+static void collect_paths(const ExtrusionEntityCollection &eec, std::vector<const ExtrusionPath*> &out)
 {
     for (const ExtrusionEntity *ee : eec) {
         if (ee->is_collection())
-            this->interpolate_add(*static_cast<const ExtrusionEntityCollection*>(ee), params);
+            collect_paths(*static_cast<const ExtrusionEntityCollection*>(ee), out);
         else if (const ExtrusionPath *path = dynamic_cast<const ExtrusionPath*>(ee); path)
-            this->interpolate_add(*path, params);
+            out.emplace_back(path);
         else if (const ExtrusionMultiPath *multi_path = dynamic_cast<const ExtrusionMultiPath*>(ee); multi_path)
-            this->interpolate_add(*multi_path, params);
+            for (const ExtrusionPath &path : multi_path->paths)
+                out.emplace_back(&path);
         else if (const ExtrusionLoop *loop = dynamic_cast<const ExtrusionLoop*>(ee); loop)
-            this->interpolate_add(*loop, params);
+            for (const ExtrusionPath &path : loop->paths)
+                out.emplace_back(&path);
         else
             assert(false);
     }
 }
 
+void SmoothPathCache::interpolate_add(const ExtrusionEntityCollection &eec, const InterpolationParameters &params)
+{
+    // Flatten the collection first to fit the paths of a whole layer in parallel.
+    std::vector<const ExtrusionPath*> paths;
+    collect_paths(eec, paths);
+    std::vector<Geometry::ArcWelder::Path> fitted(paths.size());
+    // Most of the paths are short, thus fit them in chunks.
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, paths.size(), 64), [&paths, &fitted, &params](const tbb::blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i < range.end(); ++ i)
+            fitted[i] = interpolate(*paths[i], params);
+    });
+    m_cache.reserve(m_cache.size() + paths.size());
+    for (size_t i = 0; i < paths.size(); ++ i)
+        m_cache[&paths[i]->polyline] = std::move(fitted[i]);
+}
+
 const Geometry::ArcWelder::Path* SmoothPathCache::resolve(const Polyline *pl) const
 {
     auto it = m_cache.find(pl);
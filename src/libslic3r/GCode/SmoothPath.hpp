@@ -52,6 +52,8 @@ public:
     void interpolate_add(const ExtrusionMultiPath        &ee,  const InterpolationParameters &params);
     void interpolate_add(const ExtrusionLoop             &ee,  const InterpolationParameters &params);
     void interpolate_add(const ExtrusionEntityCollection &eec, const InterpolationParameters &params);
+    // Add the smooth paths of another cache.
+    void add(const SmoothPathCache &other) { m_cache.insert(other.m_cache.begin(), other.m_cache.end()); }
 
     const Geometry::ArcWelder::Path* resolve(const Polyline      *pl) const;
     const Geometry::ArcWelder::Path* resolve(const ExtrusionPath &path) const;
@@ -72,6 +74,15 @@ private:
     ankerl::unordered_dense::map<const Polyline*, Geometry::ArcWelder::Path>    m_cache;
 };
 
+// Smooth paths of the extrusions of a single object or support layer, kept with the layer to be reused by the following G-code exports.
+struct LayerSmoothPathCache
+{
+    SmoothPathCache::InterpolationParameters    params;
+    // Timestamps of the PrintObject steps, which produced the extrusions of the layer.
+    std::vector<size_t>                         timestamps;
+    SmoothPathCache                             cache;
+};
+
 // Encapsulates references to global and layer local caches of smooth extrusion paths.
 class SmoothPathCaches final
 {
@@ -8,6 +8,7 @@
 ///|/
 #include "SpiralVase.hpp"
 
+#include <array>
 #include <utility>
 #include <cstddef>
 
@@ -27,6 +28,12 @@ static AABBTreeLines::LinesDistancer<Linef> get_layer_distancer(const std::vecto
     return AABBTreeLines::LinesDistancer{std::move(lines)};
 }
 
+static inline void append_line(std::string &gcode, const GCodeReader::GCodeLine &line)
+{
+    gcode += line.raw();
+    gcode += '\n';
+}
+
 std::string SpiralVase::process_layer(const std::string &gcode, bool last_layer)
 {
     /*  This post-processor relies on several assumptions:
@@ -49,12 +56,19 @@ std::string SpiralVase::process_layer(const std::string &gcode, bool last_layer)
     float layer_height       = 0.f;
     float z                  = 0.f;
 
+    // The layer is parsed just once into a list of lines together with the position of the reader before each line.
+    // Both the measuring and the rewriting pass run over this list, thus the reader does not need to be cloned.
+    struct ParsedLine
+    {
+        GCodeReader::GCodeLine line;
+        std::array<float, 5>   position;
+    };
+    std::vector<ParsedLine> lines;
     {
-        //FIXME Performance warning: This copies the GCodeConfig of the reader.
-        GCodeReader r = m_reader;  // clone
         bool set_z = false;
-        r.parse_buffer(gcode, [&total_layer_length, &layer_height, &z, &set_z]
+        m_reader.parse_buffer(gcode, [&lines, &total_layer_length, &layer_height, &z, &set_z]
             (GCodeReader &reader, const GCodeReader::GCodeLine &line) {
+            lines.push_back({ line, { reader.x(), reader.y(), reader.z(), reader.e(), reader.f() } });
             if (line.cmd_is("G1")) {
                 if (line.extruding(reader)) {
                     total_layer_length += line.dist_XY(reader);
@@ -85,16 +99,17 @@ std::string SpiralVase::process_layer(const std::string &gcode, bool last_layer)
     float                               len                      = 0.f;
 
     std::string        new_gcode, transition_gcode;
+    new_gcode.reserve(gcode.size() + gcode.size() / 8);
     std::vector<Vec2f> current_layer;
-    m_reader.parse_buffer(gcode, [z, total_layer_length, layer_height, transition_in, transition_out, smooth_spiral, max_xy_smoothing = m_max_xy_smoothing,
-                                  &len, &last_point, &new_gcode, &transition_gcode, &current_layer, &previous_layer_distancer]
-        (GCodeReader &reader, GCodeReader::GCodeLine line) {
+    auto process_line = [z, total_layer_length, layer_height, transition_in, transition_out, smooth_spiral, max_xy_smoothing = m_max_xy_smoothing,
+                         &len, &last_point, &new_gcode, &transition_gcode, &current_layer, &previous_layer_distancer]
+        (GCodeReader &reader, GCodeReader::GCodeLine &line) {
         if (line.cmd_is("G1")) {
             if (line.has_z()) {
                 // If this is the initial Z move of the layer, replace it with a
                 // (redundant) move to the last Z of previous layer.
                 line.set(reader, Z, z);
-                new_gcode += line.raw() + '\n';
+                append_line(new_gcode, line);
                 return;
             } else if (line.has_x() || line.has_y()) { // Sometimes lines have X/Y but the move is to the last position.
                 if (const float dist_XY = line.dist_XY(reader); dist_XY > 0 && line.extruding(reader)) { // Exclude wipe and retract
@@ -109,7 +124,7 @@ std::string SpiralVase::process_layer(const std::string &gcode, bool last_layer)
                         // We add this new layer at the very end
                         GCodeReader::GCodeLine transition_line(line);
                         transition_line.set(reader, E, line.e() * (1.f - factor), 5);
-                        transition_gcode += transition_line.raw() + '\n';
+                        append_line(transition_gcode, transition_line);
                     }
 
                     // This line is the core of Spiral Vase mode, ramp up the Z smoothly
@@ -142,7 +157,7 @@ std::string SpiralVase::process_layer(const std::string &gcode, bool last_layer)
                     }
 
                     if (emit_gcode_line)
-                        new_gcode += line.raw() + '\n';
+                        append_line(new_gcode, line);
                 }
                 return;
                 /*  Skip travel moves: the move to first perimeter point will
@@ -155,10 +170,25 @@ std::string SpiralVase::process_layer(const std::string &gcode, bool last_layer)
             }
         }
 
-        new_gcode += line.raw() + '\n';
+        append_line(new_gcode, line);
         if (transition_out)
-            transition_gcode += line.raw() + '\n';
-    });
+            append_line(transition_gcode, line);
+    };
+
+    // Replay the parsed lines with the reader positioned before each of them, then restore the position at the end of the layer.
+    const std::array<float, 5> end_position { m_reader.x(), m_reader.y(), m_reader.z(), m_reader.e(), m_reader.f() };
+    auto set_reader_position = [this](const std::array<float, 5> &position) {
+        m_reader.x() = position[0];
+        m_reader.y() = position[1];
+        m_reader.z() = position[2];
+        m_reader.e() = position[3];
+        m_reader.f() = position[4];
+    };
+    for (ParsedLine &parsed_line : lines) {
+        set_reader_position(parsed_line.position);
+        process_line(m_reader, parsed_line.line);
+    }
+    set_reader_position(end_position);
 
     m_previous_layer = std::move(current_layer);
     return new_gcode + transition_gcode;
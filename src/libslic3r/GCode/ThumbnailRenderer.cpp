@@ -0,0 +1,259 @@
+///|/ Copyright (c) Prusa Research 2024
+///|/
+///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
+///|/
+#include "ThumbnailRenderer.hpp"
+
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
+#include <oneapi/tbb/parallel_sort.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+#include <agg/agg_basics.h>
+#include <agg/agg_gamma_functions.h>
+#include <agg/agg_rendering_buffer.h>
+#include <agg/agg_pixfmt_gray.h>
+#include <agg/agg_pixfmt_rgb.h>
+#include <agg/agg_renderer_base.h>
+#include <agg/agg_renderer_scanline.h>
+#include <agg/agg_scanline_p.h>
+#include <agg/agg_rasterizer_scanline_aa.h>
+
+#include "libslic3r/BoundingBox.hpp"
+#include "libslic3r/Geometry.hpp"
+#include "libslic3r/Model.hpp"
+#include "libslic3r/Point.hpp"
+
+namespace Slic3r::GCodeThumbnails {
+
+namespace {
+
+// Lights of the gouraud_light shader, in the eye space.
+const Vec3f  LIGHT_TOP_DIR { -0.4574957f, 0.4574957f, 0.7624929f };
+const Vec3f  LIGHT_FRONT_DIR { 0.6985074f, 0.1397015f, 0.6985074f };
+const float  INTENSITY_CORRECTION = 0.6f;
+const float  LIGHT_TOP_DIFFUSE    = 0.8f * INTENSITY_CORRECTION;
+const float  LIGHT_TOP_SPECULAR   = 0.125f * INTENSITY_CORRECTION;
+const float  LIGHT_TOP_SHININESS  = 20.f;
+const float  LIGHT_FRONT_DIFFUSE  = 0.3f * INTENSITY_CORRECTION;
+const float  INTENSITY_AMBIENT    = 0.3f;
+
+// Same as Camera::DefaultZoomToBoxMarginFactor.
+const double ZOOM_TO_BOX_MARGIN_FACTOR = 1.025;
+// Each thumbnail pixel is rendered as SUPERSAMPLING x SUPERSAMPLING pixels.
+const int    SUPERSAMPLING = 2;
+
+// Projected facet, flat shaded.
+struct Facet
+{
+    std::array<Vec2f, 3>        vertices;
+    // Eye space depth of the facet centroid, larger is closer to the camera.
+    float                       depth;
+    std::array<uint8_t, 3>      color;
+    bool                        visible { false };
+};
+
+// Same as Camera::set_default_orientation(): zenith 45 degrees, rotated by 45 degrees around Z.
+Transform3d default_view_rotation()
+{
+    return Transform3d(Eigen::AngleAxisd(Geometry::deg2rad(-45.), Vec3d::UnitX()) * Eigen::AngleAxisd(Geometry::deg2rad(45.), Vec3d::UnitZ()));
+}
+
+std::array<uint8_t, 3> shade(const Vec3f &normal, const ColorRGBA &color)
+{
+    // Orthographic projection, the direction to the camera is constant.
+    const float  NdotL     = std::max(normal.dot(LIGHT_TOP_DIR), 0.f);
+    const Vec3f  reflected = 2.f * normal.dot(LIGHT_TOP_DIR) * normal - LIGHT_TOP_DIR;
+    const float  specular  = NdotL > 0.f ? LIGHT_TOP_SPECULAR * std::pow(std::max(reflected.z(), 0.f), LIGHT_TOP_SHININESS) : 0.f;
+    const float  diffuse   = INTENSITY_AMBIENT + NdotL * LIGHT_TOP_DIFFUSE + std::max(normal.dot(LIGHT_FRONT_DIR), 0.f) * LIGHT_FRONT_DIFFUSE;
+    auto channel = [specular, diffuse](float c) { return uint8_t(std::clamp(specular + c * diffuse, 0.f, 1.f) * 255.f + 0.5f); };
+    return { channel(color.r()), channel(color.g()), channel(color.b()) };
+}
+
+// Project and shade the facets of all the model parts to be shown, sorted back to front. Back facing facets are dropped.
+std::vector<Facet> project_facets(const Model &model, const ThumbnailsParams &params, const std::vector<ColorRGBA> &extruder_colors)
+{
+    struct VolumeToRender {
+        const ModelVolume *volume;
+        Transform3f        trafo;
+        ColorRGBA          color;
+        size_t             first_facet;
+    };
+
+    const Transform3d view_rotation = default_view_rotation();
+    std::vector<VolumeToRender> volumes;
+    size_t num_facets = 0;
+    for (const ModelObject *object : model.objects)
+        for (const ModelInstance *instance : object->instances) {
+            if (params.printable_only && ! instance->is_printable())
+                continue;
+            for (const ModelVolume *volume : object->volumes)
+                if (volume->is_model_part()) {
+                    // The same coloring as in GLCanvas3D::_render_thumbnail_internal(), the multi-material painting is not shown.
+                    ColorRGBA color = extruder_colors.empty() ? ColorRGBA::ORANGE() :
+                        extruder_colors[ModelVolume::get_extruder_color_idx(*volume, int(extruder_colors.size()))];
+                    if (! instance->is_printable())
+                        color = ColorRGBA::GRAY();
+                    volumes.push_back({ volume, (view_rotation * instance->get_matrix() * volume->get_matrix()).cast<float>(), color, num_facets });
+                    num_facets += volume->mesh().its.indices.size();
+                }
+        }
+
+    std::vector<Facet> facets(num_facets);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, volumes.size(), 1), [&volumes, &facets](const tbb::blocked_range<size_t> &range) {
+        for (size_t volume_idx = range.begin(); volume_idx < range.end(); ++ volume_idx) {
+            const VolumeToRender      &v   = volumes[volume_idx];
+            const indexed_triangle_set &its = v.volume->mesh().its;
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, its.indices.size()), [&v, &its, &facets](const tbb::blocked_range<size_t> &range) {
+                for (size_t facet_idx = range.begin(); facet_idx < range.end(); ++ facet_idx) {
+                    const stl_triangle_vertex_indices &indices = its.indices[facet_idx];
+                    const Vec3f p0 = v.trafo * its.vertices[indices(0)];
+                    const Vec3f p1 = v.trafo * its.vertices[indices(1)];
+                    const Vec3f p2 = v.trafo * its.vertices[indices(2)];
+                    // The normal is calculated from the transformed vertices, thus mirroring is accounted for.
+                    Vec3f normal = (p1 - p0).cross(p2 - p0);
+                    Facet &facet = facets[v.first_facet + facet_idx];
+                    if (normal.z() <= 0.f)
+                        // Back facing or degenerate.
+                        continue;
+                    normal.normalize();
+                    facet.vertices = { p0.head<2>(), p1.head<2>(), p2.head<2>() };
+                    facet.depth    = (p0.z() + p1.z() + p2.z()) / 3.f;
+                    facet.color    = shade(normal, v.color);
+                    facet.visible  = true;
+                }
+            });
+        }
+    });
+
+    facets.erase(std::remove_if(facets.begin(), facets.end(), [](const Facet &f) { return ! f.visible; }), facets.end());
+    tbb::parallel_sort(facets.begin(), facets.end(), [](const Facet &l, const Facet &r) { return l.depth < r.depth; });
+    return facets;
+}
+
+ThumbnailData rasterize(const std::vector<Facet> &facets, const BoundingBoxf &bbox, unsigned int width, unsigned int height, bool transparent_background)
+{
+    const unsigned int w = width * SUPERSAMPLING;
+    const unsigned int h = height * SUPERSAMPLING;
+
+    // Color and coverage of the supersampled image.
+    std::vector<uint8_t>                 rgb(size_t(w) * size_t(h) * 3);
+    std::vector<uint8_t>                 mask(size_t(w) * size_t(h));
+    agg::rendering_buffer                rgb_buffer(rgb.data(), w, h, int(w * 3));
+    agg::rendering_buffer                mask_buffer(mask.data(), w, h, int(w));
+    agg::pixfmt_rgb24                    rgb_pixfmt(rgb_buffer);
+    agg::pixfmt_gray8                    mask_pixfmt(mask_buffer);
+    agg::renderer_base<agg::pixfmt_rgb24> rgb_raw_renderer(rgb_pixfmt);
+    agg::renderer_base<agg::pixfmt_gray8> mask_raw_renderer(mask_pixfmt);
+    agg::renderer_scanline_aa_solid<agg::renderer_base<agg::pixfmt_rgb24>> rgb_renderer(rgb_raw_renderer);
+    agg::renderer_scanline_aa_solid<agg::renderer_base<agg::pixfmt_gray8>> mask_renderer(mask_raw_renderer);
+    agg::scanline_p8                     scanline;
+    agg::rasterizer_scanline_aa<>        rasterizer;
+    // Anti-aliasing is done by supersampling. The anti-aliased edges of the neighbor facets would let the background shine through.
+    rasterizer.gamma(agg::gamma_threshold(.5));
+
+    // Same as the clear color of GLCanvas3D::_render_thumbnail_internal().
+    rgb_raw_renderer.clear(transparent_background ? agg::rgba8(102, 102, 102) : agg::rgba8(255, 255, 255));
+    mask_raw_renderer.clear(agg::gray8(0));
+
+    if (! facets.empty()) {
+        const Vec2d  size   = bbox.size();
+        const double scale  = std::min(double(w) / std::max(size.x(), EPSILON), double(h) / std::max(size.y(), EPSILON)) / ZOOM_TO_BOX_MARGIN_FACTOR;
+        const Vec2d  center = bbox.center();
+        // The image rows are stored bottom-up, the same as the rows read back from OpenGL.
+        auto to_pixels = [scale, &center, w, h](const Vec2f &pt) {
+            return Vec2d(0.5 * w + (pt.x() - center.x()) * scale, 0.5 * h + (pt.y() - center.y()) * scale);
+        };
+        auto add_facet = [&rasterizer, &to_pixels](const Facet &facet) {
+            Vec2d pt = to_pixels(facet.vertices[0]);
+            rasterizer.move_to_d(pt.x(), pt.y());
+            pt = to_pixels(facet.vertices[1]);
+            rasterizer.line_to_d(pt.x(), pt.y());
+            pt = to_pixels(facet.vertices[2]);
+            rasterizer.line_to_d(pt.x(), pt.y());
+            rasterizer.close_polygon();
+        };
+
+        // Painter's algorithm, back to front.
+        for (const Facet &facet : facets) {
+            rasterizer.reset();
+            add_facet(facet);
+            rgb_renderer.color(agg::rgba8(facet.color[0], facet.color[1], facet.color[2]));
+            agg::render_scanlines(rasterizer, scanline, rgb_renderer);
+        }
+
+        // Coverage by a single pass, all the facets are front facing, thus they have the same orientation.
+        rasterizer.reset();
+        for (const Facet &facet : facets)
+            add_facet(facet);
+        mask_renderer.color(agg::gray8(255));
+        agg::render_scanlines(rasterizer, scanline, mask_renderer);
+    }
+
+    ThumbnailData thumbnail;
+    thumbnail.set(width, height);
+    const unsigned int num_samples = SUPERSAMPLING * SUPERSAMPLING;
+    for (unsigned int y = 0; y < height; ++ y)
+        for (unsigned int x = 0; x < width; ++ x) {
+            unsigned int r = 0, g = 0, b = 0, a = 0;
+            for (unsigned int sy = y * SUPERSAMPLING; sy < (y + 1) * SUPERSAMPLING; ++ sy)
+                for (unsigned int sx = x * SUPERSAMPLING; sx < (x + 1) * SUPERSAMPLING; ++ sx) {
+                    const uint8_t *px = &rgb[(size_t(sy) * w + sx) * 3];
+                    r += px[0];
+                    g += px[1];
+                    b += px[2];
+                    a += mask[size_t(sy) * w + sx];
+                }
+            unsigned char *out = &thumbnail.pixels[(size_t(y) * width + x) * 4];
+            out[0] = (unsigned char)(r / num_samples);
+            out[1] = (unsigned char)(g / num_samples);
+            out[2] = (unsigned char)(b / num_samples);
+            out[3] = transparent_background ? (unsigned char)(a / num_samples) : 255;
+        }
+    return thumbnail;
+}
+
+} // namespace
+
+ThumbnailsList render_thumbnails_software(const Model &model, const ThumbnailsParams &params, const std::vector<ColorRGBA> &extruder_colors)
+{
+    // The facets are projected, shaded and sorted once for all the thumbnail sizes.
+    const std::vector<Facet> facets = project_facets(model, params, extruder_colors);
+    BoundingBoxf bbox;
+    for (const Facet &facet : facets)
+        for (const Vec2f &pt : facet.vertices)
+            bbox.merge(pt.cast<double>());
+
+    ThumbnailsList thumbnails(params.sizes.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, params.sizes.size(), 1), [&](const tbb::blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i < range.end(); ++ i) {
+            const Vec2d &size = params.sizes[i];
+            if (size.x() >= 1. && size.y() >= 1.)
+                thumbnails[i] = rasterize(facets, bbox, (unsigned int)size.x(), (unsigned int)size.y(), params.transparent_background);
+        }
+    });
+    // Keep the contract of ThumbnailsGeneratorCallback, which leaves out the thumbnails failed to render.
+    thumbnails.erase(std::remove_if(thumbnails.begin(), thumbnails.end(), [](const ThumbnailData &t) { return ! t.is_valid(); }), thumbnails.end());
+    return thumbnails;
+}
+
+ThumbnailsGeneratorCallback make_software_thumbnail_generator(const Model &model, std::vector<ColorRGBA> extruder_colors)
+{
+    return [&model, extruder_colors = std::move(extruder_colors)](const ThumbnailsParams &params) {
+        return render_thumbnails_software(model, params, extruder_colors);
+    };
+}
+
+std::vector<ColorRGBA> extruder_colors_from_config(const std::vector<std::string> &extruder_colour, const std::vector<std::string> &filament_colour)
+{
+    std::vector<ColorRGBA> colors(std::max(extruder_colour.size(), filament_colour.size()), ColorRGBA::ORANGE());
+    for (size_t i = 0; i < colors.size(); ++ i)
+        if ((i >= extruder_colour.size() || ! decode_color(extruder_colour[i], colors[i])) && i < filament_colour.size())
+            decode_color(filament_colour[i], colors[i]);
+    return colors;
+}
+
+} // namespace Slic3r::GCodeThumbnails
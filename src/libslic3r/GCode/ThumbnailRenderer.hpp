@@ -0,0 +1,37 @@
+///|/ Copyright (c) Prusa Research 2024
+///|/
+///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
+///|/
+#ifndef slic3r_GCodeThumbnailRenderer_hpp_
+#define slic3r_GCodeThumbnailRenderer_hpp_
+
+#include <string>
+#include <vector>
+
+#include "libslic3r/Color.hpp"
+#include "ThumbnailData.hpp"
+
+namespace Slic3r {
+
+class Model;
+
+namespace GCodeThumbnails {
+
+// Software thumbnail renderer, it does not need an OpenGL context, thus it is used by the command line slicer.
+// The model parts are viewed from the default isometric direction of the 3D scene, fitted into the thumbnail by an orthographic
+// projection and flat shaded with the lights of the "gouraud_light" shader. The facets are sorted back to front once and then
+// drawn by the AGG rasterizer (painter's algorithm) into a 2x2 supersampled buffer, which is downsampled to the thumbnail size.
+// The bed is never rendered (ThumbnailsParams::show_bed is ignored) and the multi-material painting is not shown.
+// The pixels are stored bottom-up, the same as the thumbnails read back from OpenGL.
+ThumbnailsList render_thumbnails_software(const Model &model, const ThumbnailsParams &params, const std::vector<ColorRGBA> &extruder_colors);
+
+// Callback rendering the thumbnails by render_thumbnails_software(). The model has to outlive the callback.
+ThumbnailsGeneratorCallback make_software_thumbnail_generator(const Model &model, std::vector<ColorRGBA> extruder_colors);
+
+// Colors of the extruders as shown by the Plater: extruder_colour, falling back to filament_colour.
+std::vector<ColorRGBA> extruder_colors_from_config(const std::vector<std::string> &extruder_colour, const std::vector<std::string> &filament_colour);
+
+} // namespace GCodeThumbnails
+} // namespace Slic3r
+
+#endif // slic3r_GCodeThumbnailRenderer_hpp_
@@ -10,6 +10,8 @@
 #include <stdlib.h>
 #include <boost/algorithm/string/case_conv.hpp>
 #include <boost/log/trivial.hpp>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
 #include <string>
 #include <cstdint>
 
@@ -107,7 +109,7 @@ std::unique_ptr<CompressedImageBuffer> compress_thumbnail_qoi(const ThumbnailDat
     desc.colorspace = QOI_SRGB;
 
     // Take vector of RGBA pixels and flip the image vertically
-    std::vector<uint8_t> rgba_pixels(data.pixels.size() * 4);
+    std::vector<uint8_t> rgba_pixels(data.pixels.size());
     size_t row_size = data.width * 4;
     for (size_t y = 0; y < data.height; ++ y)
         memcpy(rgba_pixels.data() + (data.height - y - 1) * row_size, data.pixels.data() + y * row_size, row_size);
@@ -132,6 +134,49 @@ std::unique_ptr<CompressedImageBuffer> compress_thumbnail(const ThumbnailData &d
     }
 }
 
+std::vector<CompressedThumbnail> render_and_compress_thumbnails(const ThumbnailsGeneratorCallback &thumbnail_cb, const GCodeThumbnailDefinitionsList &thumbnails_list)
+{
+    std::vector<CompressedThumbnail> out;
+    if (thumbnail_cb == nullptr || thumbnails_list.empty())
+        return out;
+
+    // Collect the unique sizes, the same size may be requested in more formats.
+    Vec2ds              sizes;
+    std::vector<size_t> size_ids;
+    size_ids.reserve(thumbnails_list.size());
+    for (const auto &[format, size] : thumbnails_list) {
+        auto it = std::find(sizes.begin(), sizes.end(), size);
+        size_ids.emplace_back(it - sizes.begin());
+        if (it == sizes.end())
+            sizes.emplace_back(size);
+    }
+
+    ThumbnailsList thumbnails = thumbnail_cb(ThumbnailsParams{ sizes, true, true, true, true });
+    if (thumbnails.size() != sizes.size()) {
+        // The callback leaves out the thumbnails it failed to render, thus the returned thumbnails cannot be matched with the sizes.
+        // Render them one by one.
+        thumbnails.assign(sizes.size(), ThumbnailData());
+        for (size_t i = 0; i < sizes.size(); ++ i)
+            if (ThumbnailsList list = thumbnail_cb(ThumbnailsParams{ { sizes[i] }, true, true, true, true }); ! list.empty())
+                thumbnails[i] = std::move(list.front());
+    }
+
+    out.resize(thumbnails_list.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, thumbnails_list.size(), 1), [&thumbnails_list, &size_ids, &thumbnails, &out](const tbb::blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i < range.end(); ++ i)
+            if (const ThumbnailData &data = thumbnails[size_ids[i]]; data.is_valid()) {
+                CompressedThumbnail &thumbnail = out[i];
+                thumbnail.format = thumbnails_list[i].first;
+                thumbnail.width  = data.width;
+                thumbnail.height = data.height;
+                thumbnail.buffer = compress_thumbnail(data, thumbnail.format);
+            }
+    });
+    out.erase(std::remove_if(out.begin(), out.end(), [](const CompressedThumbnail &thumbnail) {
+        return thumbnail.buffer == nullptr || thumbnail.buffer->data == nullptr || thumbnail.buffer->size == 0; }), out.end());
+    return out;
+}
+
 std::pair<GCodeThumbnailDefinitionsList, ThumbnailErrors> make_and_check_thumbnail_list(const std::string& thumbnails_string, const std::string_view def_ext /*= "PNG"sv*/)
 {
     if (thumbnails_string.empty())
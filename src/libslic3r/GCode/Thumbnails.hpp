@@ -47,6 +47,19 @@ std::unique_ptr<CompressedImageBuffer> compress_thumbnail(const ThumbnailData &d
 
 typedef std::vector<std::pair<GCodeThumbnailsFormat, Vec2d>> GCodeThumbnailDefinitionsList;
 
+struct CompressedThumbnail
+{
+    GCodeThumbnailsFormat                  format { GCodeThumbnailsFormat::PNG };
+    unsigned int                           width { 0 };
+    unsigned int                           height { 0 };
+    std::unique_ptr<CompressedImageBuffer> buffer;
+};
+
+// Render and compress the thumbnails of thumbnails_list. All the sizes are requested by a single call of thumbnail_cb
+// (a single round trip to the UI thread when slicing in the background), a size shared by more formats is rendered just once
+// and the images are compressed in parallel. The result keeps the order of thumbnails_list, thumbnails failed to render are left out.
+std::vector<CompressedThumbnail> render_and_compress_thumbnails(const ThumbnailsGeneratorCallback &thumbnail_cb, const GCodeThumbnailDefinitionsList &thumbnails_list);
+
 using namespace std::literals;
 std::pair<GCodeThumbnailDefinitionsList, ThumbnailErrors> make_and_check_thumbnail_list(const std::string& thumbnails_string, const std::string_view def_ext = "PNG"sv);
 std::pair<GCodeThumbnailDefinitionsList, ThumbnailErrors> make_and_check_thumbnail_list(const ConfigBase &config);
@@ -58,31 +71,25 @@ inline void export_thumbnails_to_file(ThumbnailsGeneratorCallback &thumbnail_cb,
 {
     // Write thumbnails using base64 encoding
     if (thumbnail_cb != nullptr) {
-        for (const auto& [format, size] : thumbnails_list) {
-            static constexpr const size_t max_row_length = 78;
-            ThumbnailsList thumbnails = thumbnail_cb(ThumbnailsParams{ {size}, true, true, true, true });
-            for (const ThumbnailData& data : thumbnails)
-                if (data.is_valid()) {
-                    auto compressed = compress_thumbnail(data, format);
-                    if (compressed->data && compressed->size) {
-                        std::string encoded;
-                        encoded.resize(boost::beast::detail::base64::encoded_size(compressed->size));
-                        encoded.resize(boost::beast::detail::base64::encode((void*)encoded.data(), (const void*)compressed->data, compressed->size));
-
-                        output((boost::format("\n;\n; %s begin %dx%d %d\n") % compressed->tag() % data.width % data.height % encoded.size()).str().c_str());
-
-                        while (encoded.size() > max_row_length) {
-                            output((boost::format("; %s\n") % encoded.substr(0, max_row_length)).str().c_str());
-                            encoded = encoded.substr(max_row_length);
-                        }
-
-                        if (encoded.size() > 0)
-                            output((boost::format("; %s\n") % encoded).str().c_str());
-
-                        output((boost::format("; %s end\n;\n") % compressed->tag()).str().c_str());
-                    }
-                    throw_if_canceled();
-                }
+        static constexpr const size_t max_row_length = 78;
+        for (const CompressedThumbnail &thumbnail : render_and_compress_thumbnails(thumbnail_cb, thumbnails_list)) {
+            const CompressedImageBuffer &compressed = *thumbnail.buffer;
+            std::string encoded;
+            encoded.resize(boost::beast::detail::base64::encoded_size(compressed.size));
+            encoded.resize(boost::beast::detail::base64::encode((void*)encoded.data(), (const void*)compressed.data, compressed.size));
+
+            output((boost::format("\n;\n; %s begin %dx%d %d\n") % compressed.tag() % thumbnail.width % thumbnail.height % encoded.size()).str().c_str());
+
+            while (encoded.size() > max_row_length) {
+                output((boost::format("; %s\n") % encoded.substr(0, max_row_length)).str().c_str());
+                encoded = encoded.substr(max_row_length);
+            }
+
+            if (encoded.size() > 0)
+                output((boost::format("; %s\n") % encoded).str().c_str());
+
+            output((boost::format("; %s end\n;\n") % compressed.tag()).str().c_str());
+            throw_if_canceled();
         }
     }
 }
@@ -96,24 +103,17 @@ inline void generate_binary_thumbnails(ThumbnailsGeneratorCallback& thumbnail_cb
     out_thumbnails.clear();
     assert(thumbnail_cb != nullptr);
     if (thumbnail_cb != nullptr) {
-        for (const auto& [format, size] : thumbnails_list) {
-            ThumbnailsList thumbnails = thumbnail_cb(ThumbnailsParams{ {size}, true, true, true, true });
-            for (const ThumbnailData &data : thumbnails)
-                if (data.is_valid()) {
-                    auto compressed = compress_thumbnail(data, format);
-                    if (compressed->data != nullptr && compressed->size > 0) {
-                        ThumbnailBlock& block = out_thumbnails.emplace_back(ThumbnailBlock());
-                        block.params.width = (uint16_t)data.width;
-                        block.params.height = (uint16_t)data.height;
-                        switch (format) {
-                        case GCodeThumbnailsFormat::PNG: { block.params.format = (uint16_t)EThumbnailFormat::PNG; break; }
-                        case GCodeThumbnailsFormat::JPG: { block.params.format = (uint16_t)EThumbnailFormat::JPG; break; }
-                        case GCodeThumbnailsFormat::QOI: { block.params.format = (uint16_t)EThumbnailFormat::QOI; break; }
-                        }
-                        block.data.resize(compressed->size);
-                        memcpy(block.data.data(), compressed->data, compressed->size);
-                    }
-                }
+        for (const CompressedThumbnail &thumbnail : render_and_compress_thumbnails(thumbnail_cb, thumbnails_list)) {
+            ThumbnailBlock& block = out_thumbnails.emplace_back(ThumbnailBlock());
+            block.params.width = (uint16_t)thumbnail.width;
+            block.params.height = (uint16_t)thumbnail.height;
+            switch (thumbnail.format) {
+            case GCodeThumbnailsFormat::PNG: { block.params.format = (uint16_t)EThumbnailFormat::PNG; break; }
+            case GCodeThumbnailsFormat::JPG: { block.params.format = (uint16_t)EThumbnailFormat::JPG; break; }
+            case GCodeThumbnailsFormat::QOI: { block.params.format = (uint16_t)EThumbnailFormat::QOI; break; }
+            }
+            block.data.resize(thumbnail.buffer->size);
+            memcpy(block.data.data(), thumbnail.buffer->data, thumbnail.buffer->size);
         }
     }
 }
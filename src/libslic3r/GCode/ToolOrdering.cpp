@@ -6,6 +6,7 @@
 #include "libslic3r/Print.hpp"
 #include "libslic3r/Layer.hpp"
 #include "libslic3r/GCode/ToolOrdering.hpp"
+#include "libslic3r/GCode/WipeTower.hpp"
 #include "libslic3r/CustomGCode.hpp"
 #include "libslic3r/ExtrusionEntity.hpp"
 #include "libslic3r/ExtrusionEntityCollection.hpp"
@@ -29,6 +30,7 @@
 #include <limits>
 #include <cmath>
 #include <cstring>
+#include <map>
 
 namespace Slic3r {
 
@@ -371,40 +373,44 @@ void ToolOrdering::reorder_extruders(unsigned int last_extruder_id)
         // 1 based index
         ++ last_extruder_id;
 
-    for (LayerTools &lt : m_layer_tools) {
-        if (lt.extruders.empty())
-            continue;
-        if (lt.extruders.size() == 1 && lt.extruders.front() == 0)
-            lt.extruders.front() = last_extruder_id;
-        else {
-            if (lt.extruders.front() == 0)
-                // Pop the "don't care" extruder, the "don't care" region will be merged with the next one.
-                lt.extruders.erase(lt.extruders.begin());
-            // Reorder the extruders to start with the last one.
-            for (size_t i = 1; i < lt.extruders.size(); ++ i)
-                if (lt.extruders[i] == last_extruder_id) {
-                    // Move the last extruder to the front.
-                    memmove(lt.extruders.data() + 1, lt.extruders.data(), i * sizeof(unsigned int));
-                    lt.extruders.front() = last_extruder_id;
-                    break;
-                }
-
-            // On first layer with wipe tower, prefer a soluble extruder
-            // at the beginning, so it is not wiped on the first layer.
-            if (lt == m_layer_tools[0] && m_print_config_ptr && m_print_config_ptr->wipe_tower) {
-                for (size_t i = 0; i<lt.extruders.size(); ++i)
-                    if (m_print_config_ptr->filament_soluble.get_at(lt.extruders[i]-1)) { // 1-based...
-                        std::swap(lt.extruders[i], lt.extruders.front());
+    if (m_print_config_ptr && m_print_config_ptr->optimize_toolchange_order)
+        this->reorder_extruders_optimized(last_extruder_id);
+    else {
+        for (LayerTools &lt : m_layer_tools) {
+            if (lt.extruders.empty())
+                continue;
+            if (lt.extruders.size() == 1 && lt.extruders.front() == 0)
+                lt.extruders.front() = last_extruder_id;
+            else {
+                if (lt.extruders.front() == 0)
+                    // Pop the "don't care" extruder, the "don't care" region will be merged with the next one.
+                    lt.extruders.erase(lt.extruders.begin());
+                // Reorder the extruders to start with the last one.
+                for (size_t i = 1; i < lt.extruders.size(); ++ i)
+                    if (lt.extruders[i] == last_extruder_id) {
+                        // Move the last extruder to the front.
+                        memmove(lt.extruders.data() + 1, lt.extruders.data(), i * sizeof(unsigned int));
+                        lt.extruders.front() = last_extruder_id;
                         break;
                     }
-            } else if (lt.extruder_needed_for_color_changer != 0) {
-                // Put the extruder needed for performing the color change at the beginning.
-                auto it = std::find(lt.extruders.begin(), lt.extruders.end(), lt.extruder_needed_for_color_changer);
-                assert(it != lt.extruders.end());
-                std::rotate(lt.extruders.begin(), it, it + 1);
+
+                // On first layer with wipe tower, prefer a soluble extruder
+                // at the beginning, so it is not wiped on the first layer.
+                if (lt == m_layer_tools[0] && m_print_config_ptr && m_print_config_ptr->wipe_tower) {
+                    for (size_t i = 0; i<lt.extruders.size(); ++i)
+                        if (m_print_config_ptr->filament_soluble.get_at(lt.extruders[i]-1)) { // 1-based...
+                            std::swap(lt.extruders[i], lt.extruders.front());
+                            break;
+                        }
+                } else if (lt.extruder_needed_for_color_changer != 0) {
+                    // Put the extruder needed for performing the color change at the beginning.
+                    auto it = std::find(lt.extruders.begin(), lt.extruders.end(), lt.extruder_needed_for_color_changer);
+                    assert(it != lt.extruders.end());
+                    std::rotate(lt.extruders.begin(), it, it + 1);
+                }
             }
+            last_extruder_id = lt.extruders.back();
         }
-        last_extruder_id = lt.extruders.back();
     }
 
     // Reindex the extruders, so they are zero based, not 1 based.
@@ -415,6 +421,169 @@ void ToolOrdering::reorder_extruders(unsigned int last_extruder_id)
         }    
 }
 
+// Plan the order of the 1 based extruders over all layers at once, starting with last_extruder_id.
+// Contrary to the greedy ordering of reorder_extruders(), the extruder to finish a layer with is chosen considering the following layers.
+// The number of tool changes is minimized first, then the volume purged by the tool changes.
+// Dynamic programming over the layers, the state being the extruder the layer finishes with.
+void ToolOrdering::reorder_extruders_optimized(unsigned int last_extruder_id)
+{
+    assert(m_print_config_ptr != nullptr);
+    const PrintConfig &config = *m_print_config_ptr;
+    const std::vector<std::vector<float>> wipe_volumes = WipeTower::extract_wipe_volumes(config);
+    auto purge_volume = [&wipe_volumes](unsigned int from, unsigned int to) {
+        return from != to && from - 1 < wipe_volumes.size() && to - 1 < wipe_volumes[from - 1].size() ? wipe_volumes[from - 1][to - 1] : 0.f;
+    };
+
+    struct Cost {
+        size_t toolchanges { std::numeric_limits<size_t>::max() };
+        float  purge       { 0.f };
+        bool valid() const { return toolchanges != std::numeric_limits<size_t>::max(); }
+        bool operator<(const Cost &rhs) const { return toolchanges < rhs.toolchanges || (toolchanges == rhs.toolchanges && purge < rhs.purge); }
+    };
+
+    // The cheapest sequence of a set of extruders for each pair of the first and the last extruder.
+    // The sets of extruders are mostly repeating over the layers, thus the sequences are cached.
+    struct Sequences {
+        // Sequence starting with set[i] and ending with set[j] is stored at i * set.size() + j.
+        std::vector<std::vector<unsigned int>> sequences;
+        std::vector<Cost>                      costs;
+    };
+    std::map<std::vector<unsigned int>, Sequences> sequences_cache;
+    auto sequences_for_set = [&sequences_cache, &purge_volume](const std::vector<unsigned int> &set) -> const Sequences& {
+        auto [it, inserted] = sequences_cache.try_emplace(set);
+        Sequences &out = it->second;
+        if (! inserted)
+            return out;
+        const size_t n = set.size();
+        out.sequences.assign(n * n, {});
+        out.costs.assign(n * n, Cost());
+        auto consider = [&set, &out, &purge_volume, n](const std::vector<unsigned int> &sequence) {
+            Cost cost { sequence.size() - 1, 0.f };
+            for (size_t i = 1; i < sequence.size(); ++ i)
+                cost.purge += purge_volume(sequence[i - 1], sequence[i]);
+            const size_t idx = (std::find(set.begin(), set.end(), sequence.front()) - set.begin()) * n + (std::find(set.begin(), set.end(), sequence.back()) - set.begin());
+            if (cost < out.costs[idx]) {
+                out.costs[idx]     = cost;
+                out.sequences[idx] = sequence;
+            }
+        };
+        if (n <= 7) {
+            // Try all the permutations, at most 5040 of them.
+            std::vector<unsigned int> sequence = set;
+            do {
+                consider(sequence);
+            } while (std::next_permutation(sequence.begin(), sequence.end()));
+        } else {
+            // Too many permutations, keep the extruders between the first and the last one sorted.
+            for (size_t i = 0; i < n; ++ i)
+                for (size_t j = 0; j < n; ++ j)
+                    if (i != j) {
+                        std::vector<unsigned int> sequence { set[i] };
+                        for (size_t k = 0; k < n; ++ k)
+                            if (k != i && k != j)
+                                sequence.emplace_back(set[k]);
+                        sequence.emplace_back(set[j]);
+                        consider(sequence);
+                    }
+        }
+        return out;
+    };
+
+    unsigned int max_extruder_id = last_extruder_id;
+    for (const LayerTools &lt : m_layer_tools)
+        for (unsigned int extruder_id : lt.extruders)
+            max_extruder_id = std::max(max_extruder_id, extruder_id);
+
+    // Sorted set of extruders of each layer, without the "don't care" extruder. Empty for the layers with no extruders or with the "don't care" extruder only.
+    std::vector<std::vector<unsigned int>> layer_sets(m_layer_tools.size());
+    // For each layer and each extruder to finish the layer with: the extruder the previous layer finished with and the index of the sequence used.
+    struct Choice {
+        unsigned int prev_extruder_id { 0 };
+        size_t       sequence_idx     { 0 };
+    };
+    std::vector<std::vector<Choice>> choices(m_layer_tools.size());
+
+    std::vector<Cost> costs(max_extruder_id + 1, Cost());
+    costs[last_extruder_id] = { 0, 0.f };
+    for (size_t layer_idx = 0; layer_idx < m_layer_tools.size(); ++ layer_idx) {
+        const LayerTools &lt = m_layer_tools[layer_idx];
+        std::vector<unsigned int> &set = layer_sets[layer_idx];
+        set = lt.extruders;
+        set.erase(std::remove(set.begin(), set.end(), 0), set.end());
+        if (set.empty())
+            // Nothing to print or "don't care", the layer will continue with the previous extruder.
+            continue;
+        sort_remove_duplicates(set);
+
+        // Extruders allowed to start the layer with, the same constraints as used by reorder_extruders().
+        std::vector<unsigned int> allowed_first;
+        if (layer_idx == 0 && config.wipe_tower) {
+            // On first layer with wipe tower, prefer a soluble extruder at the beginning, so it is not wiped on the first layer.
+            for (unsigned int extruder_id : set)
+                if (config.filament_soluble.get_at(extruder_id - 1))
+                    allowed_first.emplace_back(extruder_id);
+        } else if (lt.extruder_needed_for_color_changer != 0) {
+            // Put the extruder needed for performing the color change at the beginning.
+            assert(std::find(set.begin(), set.end(), lt.extruder_needed_for_color_changer) != set.end());
+            allowed_first.emplace_back(lt.extruder_needed_for_color_changer);
+        }
+        if (allowed_first.empty())
+            allowed_first = set;
+
+        const Sequences   &sequences = sequences_for_set(set);
+        std::vector<Cost>  new_costs(max_extruder_id + 1, Cost());
+        std::vector<Choice> &layer_choices = choices[layer_idx];
+        layer_choices.assign(max_extruder_id + 1, Choice());
+        for (unsigned int prev_extruder_id = 1; prev_extruder_id <= max_extruder_id; ++ prev_extruder_id) {
+            const Cost &prev_cost = costs[prev_extruder_id];
+            if (! prev_cost.valid())
+                continue;
+            for (size_t i = 0; i < set.size(); ++ i) {
+                if (std::find(allowed_first.begin(), allowed_first.end(), set[i]) == allowed_first.end())
+                    continue;
+                for (size_t j = 0; j < set.size(); ++ j) {
+                    const size_t sequence_idx = i * set.size() + j;
+                    const Cost  &sequence_cost = sequences.costs[sequence_idx];
+                    if (! sequence_cost.valid())
+                        continue;
+                    Cost cost { prev_cost.toolchanges + sequence_cost.toolchanges, prev_cost.purge + sequence_cost.purge };
+                    if (set[i] != prev_extruder_id) {
+                        ++ cost.toolchanges;
+                        cost.purge += purge_volume(prev_extruder_id, set[i]);
+                    }
+                    if (cost < new_costs[set[j]]) {
+                        new_costs[set[j]]     = cost;
+                        layer_choices[set[j]] = { prev_extruder_id, sequence_idx };
+                    }
+                }
+            }
+        }
+        costs = std::move(new_costs);
+    }
+
+    // Backtrack from the cheapest final state.
+    unsigned int extruder_id = 1;
+    for (unsigned int i = 2; i <= max_extruder_id; ++ i)
+        if (costs[i] < costs[extruder_id])
+            extruder_id = i;
+    assert(costs[extruder_id].valid());
+    for (size_t layer_idx = m_layer_tools.size(); layer_idx > 0; -- layer_idx) {
+        LayerTools &lt = m_layer_tools[layer_idx - 1];
+        const std::vector<unsigned int> &set = layer_sets[layer_idx - 1];
+        if (set.empty()) {
+            if (! lt.extruders.empty())
+                // "Don't care" layer, continue with the extruder the previous layer finished with.
+                lt.extruders = { extruder_id };
+            continue;
+        }
+        const Choice &choice = choices[layer_idx - 1][extruder_id];
+        lt.extruders = sequences_for_set(set).sequences[choice.sequence_idx];
+        assert(lt.extruders.back() == extruder_id);
+        extruder_id = choice.prev_extruder_id;
+    }
+    assert(extruder_id == last_extruder_id);
+}
+
 void ToolOrdering::fill_wipe_tower_partitions(const PrintConfig &config, coordf_t object_bottom_z, coordf_t max_layer_height)
 {
     if (m_layer_tools.empty())
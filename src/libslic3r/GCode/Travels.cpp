@@ -41,56 +41,90 @@ static Lines extrusion_entity_to_lines(const ExtrusionEntity &e_entity)
     return {};
 }
 
-AABBTreeLines::LinesDistancer<ObjectOrExtrusionLinef> get_previous_layer_distancer(
-    const GCodeGenerator::ObjectsLayerToPrint &objects_to_print, const ExPolygons &slices
-) {
+static std::vector<Vec2d> get_instance_shifts(const PrintObject &object)
+{
+    std::vector<Vec2d> shifts;
+    shifts.reserve(object.instances().size());
+    for (const PrintInstance &instance : object.instances())
+        shifts.emplace_back(unscaled(instance.shift));
+
+    return shifts;
+}
+
+static BoundingBoxf get_lines_bbox(const std::vector<ObjectOrExtrusionLinef> &lines)
+{
+    BoundingBoxf bbox;
+    for (const ObjectOrExtrusionLinef &line : lines) {
+        bbox.merge(line.a);
+        bbox.merge(line.b);
+    }
+
+    return bbox;
+}
+
+ObjectsLayerObstacles get_previous_layer_obstacles(const ObjectsLayerToPrint &objects_to_print, const ExPolygons &slices)
+{
+    ObjectsLayerObstacles obstacles(objects_to_print.size());
+
     std::vector<ObjectOrExtrusionLinef> lines;
-    for (const GCodeGenerator::ObjectLayerToPrint &object_to_print : objects_to_print) {
+    for (const ExPolygon &polygon : slices)
+        for (const Line &line : polygon.lines())
+            lines.emplace_back(unscaled(line.a), unscaled(line.b));
+
+    if (lines.empty())
+        return obstacles;
+
+    // The same slices are used for all objects, so all instances of all objects share a single tree.
+    const BoundingBoxf bbox      = get_lines_bbox(lines);
+    const auto         distancer = std::make_shared<const AABBTreeLines::LinesDistancer<ObjectOrExtrusionLinef>>(std::move(lines));
+    for (const ObjectLayerToPrint &object_to_print : objects_to_print) {
         if (const PrintObject *object = object_to_print.object(); object) {
             const size_t object_layer_idx = &object_to_print - &objects_to_print.front();
-            for (const PrintInstance &instance : object->instances()) {
-                const size_t instance_idx = &instance - &object->instances().front();
-                for (const ExPolygon &polygon : slices)
-                    for (const Line &line : polygon.lines())
-                        lines.emplace_back(unscaled(Point{line.a + instance.shift}), unscaled(Point{line.b + instance.shift}), object_layer_idx, instance_idx);
-            }
+            obstacles[object_layer_idx]   = {distancer, bbox, get_instance_shifts(*object)};
         }
     }
 
-    return AABBTreeLines::LinesDistancer{std::move(lines)};
+    return obstacles;
 }
 
-std::pair<AABBTreeLines::LinesDistancer<ObjectOrExtrusionLinef>, size_t> get_current_layer_distancer(const ObjectsLayerToPrint &objects_to_print)
+std::pair<ObjectsLayerObstacles, size_t> get_current_layer_obstacles(const ObjectsLayerToPrint &objects_to_print)
 {
-    std::vector<ObjectOrExtrusionLinef> lines;
-    size_t                              extrusion_entity_cnt = 0;
+    ObjectsLayerObstacles obstacles(objects_to_print.size());
+    size_t                extrusion_entity_cnt = 0;
     for (const ObjectLayerToPrint &object_to_print : objects_to_print) {
         const size_t object_layer_idx = &object_to_print - &objects_to_print.front();
         if (const Layer *layer = object_to_print.object_layer; layer) {
-            for (const PrintInstance &instance : layer->object()->instances()) {
-                const size_t instance_idx = &instance - &layer->object()->instances().front();
-                for (const LayerSlice &lslice : layer->lslices_ex) {
-                    for (const LayerIsland &island : lslice.islands) {
-                        const LayerRegion &layerm = *layer->get_region(island.perimeters.region());
-                        for (uint32_t perimeter_id : island.perimeters) {
-                            assert(dynamic_cast<const ExtrusionEntityCollection *>(layerm.perimeters().entities[perimeter_id]));
-                            const auto *eec = static_cast<const ExtrusionEntityCollection *>(layerm.perimeters().entities[perimeter_id]);
-                            for (const ExtrusionEntity *ee : *eec) {
-                                if (ee->role().is_external_perimeter()) {
-                                    for (const Line &line : extrusion_entity_to_lines(*ee))
-                                        lines.emplace_back(unscaled(Point{line.a + instance.shift}), unscaled(Point{line.b + instance.shift}), object_layer_idx, instance_idx, ee);
-                                }
-
-                                ++extrusion_entity_cnt;
+            std::vector<ObjectOrExtrusionLinef> lines;
+            size_t                              object_extrusion_entity_cnt = 0;
+            for (const LayerSlice &lslice : layer->lslices_ex) {
+                for (const LayerIsland &island : lslice.islands) {
+                    const LayerRegion &layerm = *layer->get_region(island.perimeters.region());
+                    for (uint32_t perimeter_id : island.perimeters) {
+                        assert(dynamic_cast<const ExtrusionEntityCollection *>(layerm.perimeters().entities[perimeter_id]));
+                        const auto *eec = static_cast<const ExtrusionEntityCollection *>(layerm.perimeters().entities[perimeter_id]);
+                        for (const ExtrusionEntity *ee : *eec) {
+                            if (ee->role().is_external_perimeter()) {
+                                for (const Line &line : extrusion_entity_to_lines(*ee))
+                                    lines.emplace_back(unscaled(line.a), unscaled(line.b), ee);
                             }
+
+                            ++object_extrusion_entity_cnt;
                         }
                     }
                 }
             }
+
+            // Each instance extrudes its own copy of the extrusion entities.
+            extrusion_entity_cnt += object_extrusion_entity_cnt * layer->object()->instances().size();
+            if (!lines.empty()) {
+                const BoundingBoxf bbox     = get_lines_bbox(lines);
+                obstacles[object_layer_idx] = {std::make_shared<const AABBTreeLines::LinesDistancer<ObjectOrExtrusionLinef>>(std::move(lines)),
+                                               bbox, get_instance_shifts(*layer->object())};
+            }
         }
     }
 
-    return {AABBTreeLines::LinesDistancer{std::move(lines)}, extrusion_entity_cnt};
+    return {std::move(obstacles), extrusion_entity_cnt};
 }
 
 void TravelObstacleTracker::init_layer(const Layer &layer, const ObjectsLayerToPrint &objects_to_print)
@@ -99,9 +133,9 @@ void TravelObstacleTracker::init_layer(const Layer &layer, const ObjectsLayerToP
     m_extruded_extrusion.clear();
 
     m_objects_to_print         = objects_to_print;
-    m_previous_layer_distancer = get_previous_layer_distancer(m_objects_to_print, layer.lower_layer->lslices);
+    m_previous_layer_obstacles = get_previous_layer_obstacles(m_objects_to_print, layer.lower_layer->lslices);
 
-    std::tie(m_current_layer_distancer, extrusion_entity_cnt) = get_current_layer_distancer(m_objects_to_print);
+    std::tie(m_current_layer_obstacles, extrusion_entity_cnt) = get_current_layer_obstacles(m_objects_to_print);
     m_extruded_extrusion.reserve(extrusion_entity_cnt);
 }
 
@@ -235,18 +269,32 @@ struct Intersection
     int  object_layer_idx = -1;
     int  instance_idx     = -1;
     bool is_inside        = false;
+};
 
-    bool is_print_instance_equal(const ObjectOrExtrusionLinef &print_istance) {
-        return this->object_layer_idx == print_istance.object_layer_idx && this->instance_idx == print_istance.instance_idx;
+// Intersection of a travel segment with an obstacle line, in the print coordinates.
+struct LineIntersection
+{
+    Vec2d                         point;
+    const ObjectOrExtrusionLinef *line;
+    // Shift of the instance the line is shared with, nullptr when the line is already in the print coordinates.
+    const Vec2d                  *shift;
+    int                           object_layer_idx;
+    int                           instance_idx;
+
+    bool is_print_instance_equal(const Intersection &intersection) const {
+        return this->object_layer_idx == intersection.object_layer_idx && this->instance_idx == intersection.instance_idx;
     }
 };
 
-double get_first_crossed_line_distance(
+// Walks along xy_path and processes the intersections of each of its segments ordered from the segment start,
+// intersections_with_line(line) returns these intersections for a single unscaled segment.
+template<typename IntersectionsWithLine>
+static double find_first_crossed_line_distance(
     tcb::span<const Line> xy_path,
-    const AABBTreeLines::LinesDistancer<ObjectOrExtrusionLinef> &distancer,
     const ObjectsLayerToPrint &objects_to_print,
     const std::function<bool(const ObjectOrExtrusionLinef &)> &predicate,
-    const bool ignore_starting_object_intersection
+    const bool ignore_starting_object_intersection,
+    const IntersectionsWithLine &intersections_with_line
 ) {
     assert(!xy_path.empty());
     if (xy_path.empty())
@@ -258,36 +306,42 @@ double get_first_crossed_line_distance(
     Intersection first_intersection;
 
     for (const Line &line : xy_path) {
-        const ObjectOrExtrusionLinef                    unscaled_line = {unscaled(line.a), unscaled(line.b)};
-        const std::vector<std::pair<Vec2d, size_t>>     intersections = distancer.intersections_with_line<true>(unscaled_line);
+        const ObjectOrExtrusionLinef        unscaled_line = {unscaled(line.a), unscaled(line.b)};
+        const std::vector<LineIntersection> intersections = intersections_with_line(unscaled_line);
 
         if (intersections.empty())
             continue;
 
         if (!objects_to_print.empty() && ignore_starting_object_intersection && first_intersection.object_layer_idx == -1) {
-            const ObjectOrExtrusionLinef &intersection_line = distancer.get_line(intersections.front().second);
-            const Point shift = objects_to_print[intersection_line.object_layer_idx].layer()->object()->instances()[intersection_line.instance_idx].shift;
+            const LineIntersection &intersection = intersections.front();
+            const Point shift = objects_to_print[intersection.object_layer_idx].layer()->object()->instances()[intersection.instance_idx].shift;
             const Point shifted_first_point = path_first_point - shift;
-            const bool contain_first_point = expolygons_contain(objects_to_print[intersection_line.object_layer_idx].layer()->lslices, shifted_first_point);
+            const bool contain_first_point = expolygons_contain(objects_to_print[intersection.object_layer_idx].layer()->lslices, shifted_first_point);
 
-            first_intersection = {intersection_line.object_layer_idx, intersection_line.instance_idx, contain_first_point};
+            first_intersection = {intersection.object_layer_idx, intersection.instance_idx, contain_first_point};
         }
 
-        for (const auto &intersection : intersections) {
-            const ObjectOrExtrusionLinef &intersection_line = distancer.get_line(intersection.second);
-            const double distance = traversed_distance + (unscaled_line.a - intersection.first).norm();
+        for (const LineIntersection &intersection : intersections) {
+            const double distance = traversed_distance + (unscaled_line.a - intersection.point).norm();
             if (distance <= EPSILON)
                 continue;
 
             // There is only one external border for each object, so when we cross this border,
             // we definitely know that we are outside the object.
-            if (skip_intersection && first_intersection.is_print_instance_equal(intersection_line) && first_intersection.is_inside) {
+            if (skip_intersection && intersection.is_print_instance_equal(first_intersection) && first_intersection.is_inside) {
                 skip_intersection = false;
                 continue;
             }
 
-            if (!predicate(intersection_line))
-                continue;
+            if (intersection.shift == nullptr) {
+                if (!predicate(*intersection.line))
+                    continue;
+            } else {
+                const ObjectOrExtrusionLinef &line = *intersection.line;
+                if (!predicate(ObjectOrExtrusionLinef{line.a + *intersection.shift, line.b + *intersection.shift, size_t(intersection.object_layer_idx),
+                                                      size_t(intersection.instance_idx), line.extrusion_entity}))
+                    continue;
+            }
 
             return distance;
         }
@@ -298,12 +352,67 @@ double get_first_crossed_line_distance(
     return std::numeric_limits<double>::max();
 }
 
+double get_first_crossed_line_distance(
+    tcb::span<const Line> xy_path,
+    const AABBTreeLines::LinesDistancer<ObjectOrExtrusionLinef> &distancer,
+    const ObjectsLayerToPrint &objects_to_print,
+    const std::function<bool(const ObjectOrExtrusionLinef &)> &predicate,
+    const bool ignore_starting_object_intersection
+) {
+    return find_first_crossed_line_distance(xy_path, objects_to_print, predicate, ignore_starting_object_intersection,
+        [&distancer](const ObjectOrExtrusionLinef &unscaled_line) {
+            std::vector<LineIntersection> intersections;
+            for (const auto &[point, line_idx] : distancer.intersections_with_line<true>(unscaled_line)) {
+                const ObjectOrExtrusionLinef &line = distancer.get_line(line_idx);
+                intersections.push_back({point, &line, nullptr, line.object_layer_idx, line.instance_idx});
+            }
+            return intersections;
+        });
+}
+
+double get_first_crossed_line_distance(
+    tcb::span<const Line> xy_path,
+    const ObjectsLayerObstacles &obstacles,
+    const ObjectsLayerToPrint &objects_to_print,
+    const std::function<bool(const ObjectOrExtrusionLinef &)> &predicate,
+    const bool ignore_starting_object_intersection
+) {
+    return find_first_crossed_line_distance(xy_path, objects_to_print, predicate, ignore_starting_object_intersection,
+        [&obstacles](const ObjectOrExtrusionLinef &unscaled_line) {
+            const Vec2d line_min = unscaled_line.a.cwiseMin(unscaled_line.b);
+            const Vec2d line_max = unscaled_line.a.cwiseMax(unscaled_line.b);
+
+            std::vector<LineIntersection> intersections;
+            for (const ObjectLayerObstacles &object_obstacles : obstacles) {
+                if (!object_obstacles.distancer)
+                    continue;
+
+                const int object_layer_idx = int(&object_obstacles - &obstacles.front());
+                for (const Vec2d &shift : object_obstacles.instance_shifts) {
+                    // Query the tree shared by the instances only with the travel segments touching this instance.
+                    if (!object_obstacles.bbox.overlap(BoundingBoxf{line_min - shift, line_max - shift}))
+                        continue;
+
+                    const int                    instance_idx = int(&shift - &object_obstacles.instance_shifts.front());
+                    const ObjectOrExtrusionLinef shifted_line = {unscaled_line.a - shift, unscaled_line.b - shift};
+                    for (const auto &[point, line_idx] : object_obstacles.distancer->intersections_with_line<false>(shifted_line))
+                        intersections.push_back({point + shift, &object_obstacles.distancer->get_line(line_idx), &shift, object_layer_idx, instance_idx});
+                }
+            }
+
+            std::sort(intersections.begin(), intersections.end(), [&unscaled_line](const LineIntersection &lhs, const LineIntersection &rhs) {
+                return (lhs.point - unscaled_line.a).squaredNorm() < (rhs.point - unscaled_line.a).squaredNorm();
+            });
+            return intersections;
+        });
+}
+
 double get_obstacle_adjusted_slope_end(const Lines &xy_path, const GCode::TravelObstacleTracker &obstacle_tracker) {
     const double previous_layer_crossed_line = get_first_crossed_line_distance(
-        xy_path, obstacle_tracker.previous_layer_distancer(), obstacle_tracker.objects_to_print()
+        xy_path, obstacle_tracker.previous_layer_obstacles(), obstacle_tracker.objects_to_print()
     );
     const double current_layer_crossed_line = get_first_crossed_line_distance(
-        xy_path, obstacle_tracker.current_layer_distancer(), obstacle_tracker.objects_to_print(),
+        xy_path, obstacle_tracker.current_layer_obstacles(), obstacle_tracker.objects_to_print(),
         [&obstacle_tracker](const ObjectOrExtrusionLinef &line) { return obstacle_tracker.is_extruded(line); }
     );
 
@@ -14,9 +14,11 @@
 #include <functional>
 #include <optional>
 #include <cstddef>
+#include <memory>
 #include <unordered_set>
 
 #include "libslic3r/AABBTreeLines.hpp"
+#include "libslic3r/BoundingBox.hpp"
 #include "libslic3r/Line.hpp"
 #include "libslic3r/Point.hpp"
 #include "libslic3r/GCode/ExtrusionOrder.hpp"
@@ -44,6 +46,8 @@ public:
     ObjectOrExtrusionLinef(const Vec2d &a, const Vec2d &b) : Linef(a, b) {}
     explicit ObjectOrExtrusionLinef(const Vec2d &a, const Vec2d &b, size_t object_layer_idx, size_t instance_idx)
         : Linef(a, b), object_layer_idx(int(object_layer_idx)), instance_idx(int(instance_idx)) {}
+    ObjectOrExtrusionLinef(const Vec2d &a, const Vec2d &b, const ExtrusionEntity *extrusion_entity)
+        : Linef(a, b), extrusion_entity(extrusion_entity) {}
     ObjectOrExtrusionLinef(const Vec2d &a, const Vec2d &b, size_t object_layer_idx, size_t instance_idx, const ExtrusionEntity *extrusion_entity)
         : Linef(a, b), object_layer_idx(int(object_layer_idx)), instance_idx(int(instance_idx)), extrusion_entity(extrusion_entity) {}
 
@@ -78,6 +82,21 @@ struct ExtrudedExtrusionEntityHash
     }
 };
 
+// Obstacles of one object layer. All instances of the object share a single AABB tree over the lines
+// in the object coordinates, an instance is tested by translating the queried travel by the instance shift.
+// The lines stored in the tree do not carry object_layer_idx nor instance_idx, these are known from the query.
+struct ObjectLayerObstacles
+{
+    std::shared_ptr<const AABBTreeLines::LinesDistancer<ObjectOrExtrusionLinef>> distancer;
+    // Bounding box of the lines in the object coordinates.
+    BoundingBoxf                                                                  bbox;
+    // Unscaled shifts of the instances, indexed by instance_idx.
+    std::vector<Vec2d>                                                            instance_shifts;
+};
+
+// Indexed by object_layer_idx, empty for objects without obstacles.
+using ObjectsLayerObstacles = std::vector<ObjectLayerObstacles>;
+
 class TravelObstacleTracker
 {
 public:
@@ -87,17 +106,17 @@ public:
 
     bool is_extruded(const ObjectOrExtrusionLinef &line) const;
 
-    const AABBTreeLines::LinesDistancer<ObjectOrExtrusionLinef> &previous_layer_distancer() const { return m_previous_layer_distancer; }
+    const ObjectsLayerObstacles &previous_layer_obstacles() const { return m_previous_layer_obstacles; }
 
-    const AABBTreeLines::LinesDistancer<ObjectOrExtrusionLinef> &current_layer_distancer() const { return m_current_layer_distancer; }
+    const ObjectsLayerObstacles &current_layer_obstacles() const { return m_current_layer_obstacles; }
 
     const ObjectsLayerToPrint &objects_to_print() const { return m_objects_to_print; }
 
 private:
     ObjectsLayerToPrint                                                      m_objects_to_print;
-    AABBTreeLines::LinesDistancer<ObjectOrExtrusionLinef>                    m_previous_layer_distancer;
+    ObjectsLayerObstacles                                                    m_previous_layer_obstacles;
 
-    AABBTreeLines::LinesDistancer<ObjectOrExtrusionLinef>                    m_current_layer_distancer;
+    ObjectsLayerObstacles                                                    m_current_layer_obstacles;
     std::unordered_set<ExtrudedExtrusionEntity, ExtrudedExtrusionEntityHash> m_extruded_extrusion;
 };
 } // namespace Slic3r::GCode
@@ -229,6 +248,20 @@ double get_first_crossed_line_distance(
     const std::function<bool(const ObjectOrExtrusionLinef &)> &predicate = [](const ObjectOrExtrusionLinef &) { return true; },
     bool ignore_starting_object_intersection = true);
 
+/**
+ * @brief Same as above, but the lines are shared by all instances of each object.
+ *
+ * The xy_path is translated into the coordinates of each instance whose bounding box
+ * it touches, the intersections of all instances are then processed ordered along the path.
+ * The predicate receives the intersected line translated to the instance.
+ */
+double get_first_crossed_line_distance(
+    tcb::span<const Line> xy_path,
+    const ObjectsLayerObstacles &obstacles,
+    const ObjectsLayerToPrint &objects_to_print,
+    const std::function<bool(const ObjectOrExtrusionLinef &)> &predicate = [](const ObjectOrExtrusionLinef &) { return true; },
+    bool ignore_starting_object_intersection = true);
+
 /**
  * @brief Extract parameters and decide wheather the travel can be elevated.
  * Then generate the whole travel 3D path - elevated if possible.
@@ -9,6 +9,7 @@
 
 #include <LocalesUtils.hpp>
 #include <boost/algorithm/string/predicate.hpp>
+#include <boost/log/trivial.hpp>
 #include <cassert>
 #include <vector>
 #include <numeric>
@@ -17,6 +18,9 @@
 #include <cstdio>
 #include <cstdlib>
 
+#include <oneapi/tbb/parallel_for.h>
+#include <oneapi/tbb/task_arena.h>
+
 #include "libslic3r/ClipperUtils.hpp"
 #include "libslic3r/GCode/GCodeProcessor.hpp"
 #include "libslic3r/BoundingBox.hpp"
@@ -865,8 +869,7 @@ WipeTower::ToolChangeResult WipeTower::tool_change(size_t tool)
                   "\n\n");
 
     // Ask our writer about how much material was consumed:
-    if (m_current_tool < m_used_filament_length.size())
-        m_used_filament_length[m_current_tool] += writer.get_and_reset_used_filament_length();
+    add_used_filament_length(writer);
 
    return construct_tcr(writer, false, old_tool);
 }
@@ -1080,8 +1083,7 @@ void WipeTower::toolchange_Change(
     const std::string&  new_material)
 {
     // Ask the writer about how much of the old filament we consumed:
-    if (m_current_tool < m_used_filament_length.size())
-    	m_used_filament_length[m_current_tool] += writer.get_and_reset_used_filament_length();
+    add_used_filament_length(writer);
 
     // This is where we want to place the custom gcodes. We will use placeholders for this.
     // These will be substituted by the actual gcodes when the gcode is generated.
@@ -1462,8 +1464,7 @@ WipeTower::ToolChangeResult WipeTower::finish_layer()
     // Ask our writer about how much material was consumed.
     // Skip this in case the layer is sparse and config option to not print sparse layers is enabled.
     if (! m_no_sparse_layers || toolchanges_on_layer || first_layer) {
-        if (m_current_tool < m_used_filament_length.size())
-            m_used_filament_length[m_current_tool] += writer.get_and_reset_used_filament_length();
+        add_used_filament_length(writer);
         m_current_height += m_layer_info->height;
     }
 
@@ -1655,6 +1656,74 @@ static WipeTower::ToolChangeResult merge_tcr(WipeTower::ToolChangeResult& first,
 }
 
 
+void WipeTower::add_used_filament_length(WipeTowerWriter &writer)
+{
+    if (m_current_tool < m_used_filament_length.size()) {
+        const float length = writer.get_and_reset_used_filament_length();
+        m_used_filament_length[m_current_tool] += length;
+        if (m_used_filament_log)
+            m_used_filament_log->emplace_back(m_current_tool, length);
+    }
+}
+
+WipeTower::LayerState WipeTower::get_layer_state() const
+{
+    return { m_current_tool, m_old_temperature, m_current_shape, m_y_shift, m_internal_rotation, m_num_layer_changes, m_num_tool_changes, m_current_height };
+}
+
+void WipeTower::set_layer_state(const LayerState &state)
+{
+    m_current_tool      = state.current_tool;
+    m_old_temperature   = state.old_temperature;
+    m_current_shape     = state.current_shape;
+    m_y_shift           = state.y_shift;
+    m_internal_rotation = state.internal_rotation;
+    m_num_layer_changes = state.num_layer_changes;
+    m_num_tool_changes  = state.num_tool_changes;
+    m_current_height    = state.current_height;
+}
+
+std::vector<WipeTower::ToolChangeResult> WipeTower::generate_layer(const WipeTowerInfo &layer)
+{
+    std::vector<WipeTower::ToolChangeResult> layer_result;
+    set_layer(layer.z, layer.height, 0, false/*layer.z == m_plan.front().z*/, layer.z == m_plan.back().z);
+    m_internal_rotation += 180.f;
+
+    if (m_layer_info->depth < m_wipe_tower_depth - m_perimeter_width)
+        m_y_shift = (m_wipe_tower_depth-m_layer_info->depth-m_perimeter_width)/2.f;
+
+    int idx = first_toolchange_to_nonsoluble(layer.tool_changes);
+    ToolChangeResult finish_layer_tcr;
+
+    if (idx == -1) {
+        // if there is no toolchange switching to non-soluble, finish layer
+        // will be called at the very beginning. That's the last possibility
+        // where a nonsoluble tool can be.
+        finish_layer_tcr = finish_layer();
+    }
+
+    for (int i=0; i<int(layer.tool_changes.size()); ++i) {
+        layer_result.emplace_back(tool_change(layer.tool_changes[i].new_tool));
+        if (i == idx) // finish_layer will be called after this toolchange
+            finish_layer_tcr = finish_layer();
+    }
+
+    if (layer_result.empty()) {
+        // there is nothing to merge finish_layer with
+        layer_result.emplace_back(std::move(finish_layer_tcr));
+    }
+    else {
+        if (idx == -1) {
+            layer_result[0] = merge_tcr(finish_layer_tcr, layer_result[0]);
+            layer_result[0].force_travel = true;
+        }
+        else
+            layer_result[idx] = merge_tcr(layer_result[idx], finish_layer_tcr);
+    }
+
+    return layer_result;
+}
+
 // Processes vector m_plan and calls respective functions to generate G-code for the wipe tower
 // Resulting ToolChangeResults are appended into vector "result"
 void WipeTower::generate(std::vector<std::vector<WipeTower::ToolChangeResult>> &result)
@@ -1685,50 +1754,116 @@ void WipeTower::generate(std::vector<std::vector<WipeTower::ToolChangeResult>> &
 
     m_old_temperature = -1; // reset last temperature written in the gcode
 
-	for (const WipeTower::WipeTowerInfo& layer : m_plan)
-	{
-        std::vector<WipeTower::ToolChangeResult> layer_result;
-        set_layer(layer.z, layer.height, 0, false/*layer.z == m_plan.front().z*/, layer.z == m_plan.back().z);
-        m_internal_rotation += 180.f;
-
-        if (m_layer_info->depth < m_wipe_tower_depth - m_perimeter_width)
-			m_y_shift = (m_wipe_tower_depth-m_layer_info->depth-m_perimeter_width)/2.f;
-
-        int idx = first_toolchange_to_nonsoluble(layer.tool_changes);
-        ToolChangeResult finish_layer_tcr;
+    auto update_used_filament_until_layer = [this](const WipeTowerInfo &layer) {
+        if (m_used_filament_length_until_layer.empty() || m_used_filament_length_until_layer.back().first != layer.z)
+            m_used_filament_length_until_layer.emplace_back();
+        m_used_filament_length_until_layer.back() = std::make_pair(layer.z, m_used_filament_length);
+    };
 
-        if (idx == -1) {
-            // if there is no toolchange switching to non-soluble, finish layer
-            // will be called at the very beginning. That's the last possibility
-            // where a nonsoluble tool can be.
-            finish_layer_tcr = finish_layer();
+    // The layers are generated in parallel in chunks. A chunk may only start with a layer, which starts with a tool change:
+    // the tool change resets the only state of the generator not determined by m_plan, which is m_left_to_right.
+    // The state at the start of each chunk is predicted from m_plan, the used filament is accumulated afterwards.
+    static constexpr const size_t min_layers_per_chunk = 16;
+    const size_t max_chunks = std::min(m_plan.size() / min_layers_per_chunk, 4 * size_t(tbb::this_task_arena::max_concurrency()));
+    struct Chunk {
+        size_t     begin;
+        size_t     end;
+        LayerState state_begin;
+        LayerState state_end;
+    };
+    std::vector<Chunk> chunks;
+    {
+        // Simulate the changes of the state of the generator by generate_layer() layer by layer.
+        LayerState state = get_layer_state();
+        const size_t layers_per_chunk = max_chunks > 1 ? (m_plan.size() + max_chunks - 1) / max_chunks : m_plan.size();
+        for (size_t layer_idx = 0; layer_idx < m_plan.size(); ++ layer_idx) {
+            const WipeTowerInfo &layer = m_plan[layer_idx];
+            if (layer_idx == 0 || (layer_idx >= chunks.back().begin + layers_per_chunk && first_toolchange_to_nonsoluble(layer.tool_changes) != -1)) {
+                if (! chunks.empty())
+                    chunks.back().end = layer_idx;
+                chunks.push_back({ layer_idx, m_plan.size(), state, state });
+            }
+            if (chunks.size() == 1)
+                // No need to simulate the first chunk.
+                continue;
+            // set_layer()
+            const bool first_layer = layer_idx == m_first_layer_idx;
+            state.current_shape = (! first_layer && state.current_shape == SHAPE_NORMAL) ? SHAPE_REVERSED : SHAPE_NORMAL;
+            if (first_layer) {
+                state.num_layer_changes = 0;
+                state.num_tool_changes  = 0;
+            } else
+                ++ state.num_layer_changes;
+            state.internal_rotation += 180.f;
+            if (layer.depth < m_wipe_tower_depth - m_perimeter_width)
+                state.y_shift = (m_wipe_tower_depth-layer.depth-m_perimeter_width)/2.f;
+            // tool_change()
+            for (const WipeTowerInfo::ToolChange &tool_change : layer.tool_changes) {
+                const int new_temperature = first_layer ? m_filpar[tool_change.new_tool].first_layer_temperature : m_filpar[tool_change.new_tool].temperature;
+                if (m_semm && new_temperature != 0)
+                    state.old_temperature = new_temperature;
+                state.current_tool = tool_change.new_tool;
+                ++ state.num_tool_changes;
+            }
+            // finish_layer()
+            if (! m_no_sparse_layers || layer.toolchanges_depth() > WT_EPSILON || first_layer)
+                state.current_height += layer.height;
         }
+    }
 
-        for (int i=0; i<int(layer.tool_changes.size()); ++i) {
-            layer_result.emplace_back(tool_change(layer.tool_changes[i].new_tool));
-            if (i == idx) // finish_layer will be called after this toolchange
-                finish_layer_tcr = finish_layer();
+    if (chunks.size() == 1) {
+        for (const WipeTower::WipeTowerInfo& layer : m_plan) {
+            result.emplace_back(generate_layer(layer));
+            update_used_filament_until_layer(layer);
         }
+        return;
+    }
 
-        if (layer_result.empty()) {
-            // there is nothing to merge finish_layer with
-            layer_result.emplace_back(std::move(finish_layer_tcr));
+    // Each chunk is generated by its own copy of the generator, the last chunk by this generator to leave it in its final state.
+    std::vector<std::unique_ptr<WipeTower>> generators;
+    for (size_t i = 0; i + 1 < chunks.size(); ++ i)
+        generators.emplace_back(std::make_unique<WipeTower>(*this));
+    std::vector<std::vector<ToolChangeResult>>       layer_results(m_plan.size());
+    std::vector<std::vector<std::pair<size_t, float>>> layer_used_filament(m_plan.size());
+    auto generate_chunk = [this, &chunks, &generators, &layer_results, &layer_used_filament](size_t chunk_idx) {
+        Chunk     &chunk     = chunks[chunk_idx];
+        WipeTower &generator = chunk_idx < generators.size() ? *generators[chunk_idx] : *this;
+        generator.set_layer_state(chunk.state_begin);
+        generator.m_layer_info = generator.m_plan.begin() + chunk.begin;
+        for (size_t layer_idx = chunk.begin; layer_idx < chunk.end; ++ layer_idx) {
+            layer_used_filament[layer_idx].clear();
+            generator.m_used_filament_log = &layer_used_filament[layer_idx];
+            layer_results[layer_idx] = generator.generate_layer(generator.m_plan[layer_idx]);
         }
-        else {
-            if (idx == -1) {
-                layer_result[0] = merge_tcr(finish_layer_tcr, layer_result[0]);
-                layer_result[0].force_travel = true;
-            }
-            else
-                layer_result[idx] = merge_tcr(layer_result[idx], finish_layer_tcr);
+        generator.m_used_filament_log = nullptr;
+        chunk.state_end = generator.get_layer_state();
+    };
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, chunks.size(), 1), [&generate_chunk](const tbb::blocked_range<size_t> &range) {
+        for (size_t chunk_idx = range.begin(); chunk_idx < range.end(); ++ chunk_idx)
+            generate_chunk(chunk_idx);
+    });
+
+    // Verify the predicted states, regenerate the chunks started with a wrong state sequentially.
+    for (size_t chunk_idx = 1; chunk_idx < chunks.size(); ++ chunk_idx)
+        if (! (chunks[chunk_idx].state_begin == chunks[chunk_idx - 1].state_end)) {
+            BOOST_LOG_TRIVIAL(debug) << "WipeTower::generate: state of the generator mispredicted at layer " << chunks[chunk_idx].begin;
+            chunks[chunk_idx].state_begin = chunks[chunk_idx - 1].state_end;
+            generate_chunk(chunk_idx);
         }
 
-		result.emplace_back(std::move(layer_result));
-
-        if (m_used_filament_length_until_layer.empty() || m_used_filament_length_until_layer.back().first != layer.z)
-            m_used_filament_length_until_layer.emplace_back();
-        m_used_filament_length_until_layer.back() = std::make_pair(layer.z, m_used_filament_length);
-	}
+    // The brim is only generated with the first layer.
+    for (const std::unique_ptr<WipeTower> &generator : generators)
+        if (generator->m_wipe_tower_brim_width_real != m_wipe_tower_brim_width_real)
+            m_wipe_tower_brim_width_real = generator->m_wipe_tower_brim_width_real;
+
+    // Accumulate the used filament in the same order as if the layers were generated sequentially.
+    m_used_filament_length.assign(m_used_filament_length.size(), 0.f);
+    for (size_t layer_idx = 0; layer_idx < m_plan.size(); ++ layer_idx) {
+        for (const auto &[tool, length] : layer_used_filament[layer_idx])
+            m_used_filament_length[tool] += length;
+        update_used_filament_until_layer(m_plan[layer_idx]);
+        result.emplace_back(std::move(layer_results[layer_idx]));
+    }
 }
 
 
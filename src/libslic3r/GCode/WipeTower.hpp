@@ -391,6 +391,34 @@ private:
     // Stores information about used filament length per extruder:
     std::vector<float> m_used_filament_length;
 	std::vector<std::pair<float, std::vector<float>>> m_used_filament_length_until_layer;
+    // If set, the additions to m_used_filament_length are recorded here in the order they were made, see generate().
+    std::vector<std::pair<size_t, float>>* m_used_filament_log = nullptr;
+
+    void add_used_filament_length(WipeTowerWriter &writer);
+
+    // State of the generator carried over from one layer to the next one, except for the used filament.
+    // It is fully determined by m_plan at the layers starting with a tool change, see generate().
+    struct LayerState {
+        size_t       current_tool      = 0;
+        int          old_temperature   = -1;
+        wipe_shape   current_shape     = SHAPE_NORMAL;
+        float        y_shift           = 0.f;
+        float        internal_rotation = 0.f;
+        unsigned int num_layer_changes = 0;
+        unsigned int num_tool_changes  = 0;
+        float        current_height    = 0.f;
+
+        bool operator==(const LayerState &rhs) const {
+            return current_tool == rhs.current_tool && old_temperature == rhs.old_temperature && current_shape == rhs.current_shape &&
+                   y_shift == rhs.y_shift && internal_rotation == rhs.internal_rotation && num_layer_changes == rhs.num_layer_changes &&
+                   num_tool_changes == rhs.num_tool_changes && current_height == rhs.current_height;
+        }
+    };
+    LayerState get_layer_state() const;
+    void       set_layer_state(const LayerState &state);
+
+    // Generates the tool changes and the sparse infill of a single layer of m_plan.
+    std::vector<ToolChangeResult> generate_layer(const WipeTowerInfo &layer);
 
     // Return index of first toolchange that switches to non-soluble extruder
     // ot -1 if there is no such toolchange.
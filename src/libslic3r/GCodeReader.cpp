@@ -4,14 +4,22 @@
 ///|/
 #include "GCodeReader.hpp"
 
+#include <boost/filesystem/operations.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <boost/log/trivial.hpp>
 #include <boost/nowide/cstdio.hpp>
 #include <fast_float.h>
+#include <oneapi/tbb/parallel_pipeline.h>
+#include <oneapi/tbb/task_arena.h>
+#include <atomic>
+#include <memory>
 #include <iostream>
 #include <iomanip>
 #include <cassert>
 #include <cstdio>
 #include <cstdlib>
 
+#include "Thread.hpp"
 #include "Utils.hpp"
 #include "libslic3r/PrintConfig.hpp"
 #include "libslic3r/libslic3r.h"
@@ -39,6 +47,22 @@ void GCodeReader::apply_config(const DynamicPrintConfig &config)
 }
 
 const char* GCodeReader::parse_line_internal(const char *ptr, const char *end, GCodeLine &gline, std::pair<const char*, const char*> &command)
+{
+    const char *c = this->tokenize_line(ptr, end, gline, command);
+    this->apply_line_side_effects(gline);
+    return c;
+}
+
+void GCodeReader::apply_line_side_effects(const GCodeLine &gline)
+{
+    if (gline.has(E) && m_config.use_relative_e_distances)
+        m_position[E] = 0;
+
+    if (m_verbose)
+        std::cout << gline.m_raw << std::endl;
+}
+
+const char* GCodeReader::tokenize_line(const char *ptr, const char *end, GCodeLine &gline, std::pair<const char*, const char*> &command) const
 {
     assert(is_decimal_separator_point());
     
@@ -91,9 +115,6 @@ const char* GCodeReader::parse_line_internal(const char *ptr, const char *end, G
         }
     }
     
-    if (gline.has(E) && m_config.use_relative_e_distances)
-        m_position[E] = 0;
-
     // Skip the rest of the line.
     for (; ! is_end_of_line(*c); ++ c);
 
@@ -107,9 +128,6 @@ const char* GCodeReader::parse_line_internal(const char *ptr, const char *end, G
 	if (*c == '\n')
 		++ c;
 
-    if (m_verbose)
-        std::cout << gline.m_raw << std::endl;
-
     return c;
 }
 
@@ -126,9 +144,64 @@ void GCodeReader::update_coordinates(GCodeLine &gline, std::pair<const char*, co
     }
 }
 
+template<typename ParseLineCallback, typename LineEndCallback>
+bool GCodeReader::parse_mapped_file_internal(const char *begin, const char *end, ParseLineCallback parse_line_callback, LineEndCallback line_end_callback)
+{
+    // The lines are passed to the callback pointing straight into the memory mapped file, they are terminated by '\r' or '\n'
+    // which the line parser recognizes as end of line. Only the last line, if not terminated by a new line, needs to be copied
+    // to be zero terminated.
+    const char *last_eol = end;
+    while (last_eol != begin && *(last_eol - 1) != '\n' && *(last_eol - 1) != '\r')
+        -- last_eol;
+    const size_t  file_size           = end - begin;
+    static constexpr const size_t progress_step = 65536 * 10;
+    size_t        next_progress       = progress_step;
+    m_parsing = true;
+    for (const char *it = begin; it != last_eol;) {
+        const char *it_end = it;
+        for (; *it_end != '\r' && *it_end != '\n'; ++ it_end) ;
+        parse_line_callback(it, it_end);
+        if (! m_parsing)
+            // The callback wishes to exit.
+            return true;
+        // Skip EOL.
+        it = it_end;
+        if (it != last_eol && *it == '\r')
+            ++ it;
+        if (it != last_eol && *it == '\n') {
+            line_end_callback(size_t(it - begin) + 1);
+            ++ it;
+        }
+        if (m_progress_callback != nullptr && size_t(it - begin) >= next_progress) {
+            m_progress_callback(static_cast<float>(it - begin) / static_cast<float>(file_size));
+            next_progress += progress_step;
+        }
+    }
+    if (last_eol != end) {
+        const std::string gcode_line(last_eol, end);
+        parse_line_callback(gcode_line.c_str(), gcode_line.c_str() + gcode_line.size());
+    }
+    return true;
+}
+
 template<typename ParseLineCallback, typename LineEndCallback>
 bool GCodeReader::parse_file_raw_internal(const std::string &filename, ParseLineCallback parse_line_callback, LineEndCallback line_end_callback)
 {
+    {
+        // Memory map the file to avoid copying of the file content and lines into intermediate buffers.
+        boost::iostreams::mapped_file_source mapping;
+        try {
+            // boost::filesystem::path is UTF-8 aware, see boost::nowide::nowide_filesystem().
+            const boost::filesystem::path path(filename);
+            if (boost::filesystem::file_size(path) > 0)
+                mapping.open(path);
+        } catch (const std::exception &ex) {
+            BOOST_LOG_TRIVIAL(debug) << "GCodeReader: failed to memory map " << filename << ", falling back to buffered reading: " << ex.what();
+        }
+        if (mapping.is_open())
+            return this->parse_mapped_file_internal(mapping.data(), mapping.data() + mapping.size(), parse_line_callback, line_end_callback);
+    }
+
     FilePtr in{ boost::nowide::fopen(filename.c_str(), "rb") };
 
     fseek(in.f, 0, SEEK_END);
@@ -189,9 +262,118 @@ bool GCodeReader::parse_file_raw_internal(const std::string &filename, ParseLine
     return true;
 }
 
+// Parsing of G-code lines into GCodeLine is split into a parallel pipeline stage: Lines are tokenized and their axes
+// are parsed concurrently in chunks, while the reader state (the current position) is updated and the callback is called
+// sequentially, in the order of the lines. The callback thus sees exactly the same sequence of calls as when parsing serially.
+template<typename Callback, typename LineEndCallback>
+bool GCodeReader::parse_mapped_file_parallel(const char *begin, const char *end, Callback callback, LineEndCallback line_end_callback)
+{
+    struct ParsedLine {
+        GCodeLine                           gline;
+        std::pair<const char*, const char*> command;
+        // Position of the end of line in the file, 0 if the line is not terminated by a new line.
+        size_t                              line_end;
+    };
+    struct Chunk {
+        std::vector<std::pair<const char*, const char*>> spans;
+        std::vector<ParsedLine>                          lines;
+    };
+    static constexpr const size_t lines_per_chunk = 4096;
+
+    // Only the last line, if not terminated by a new line, needs to be copied to be zero terminated.
+    const char *last_eol = end;
+    while (last_eol != begin && *(last_eol - 1) != '\n' && *(last_eol - 1) != '\r')
+        -- last_eol;
+    const std::string last_line(last_eol, end);
+    const size_t      file_size = end - begin;
+
+    const char       *it = begin;
+    bool              last_line_emitted = last_line.empty();
+    std::atomic<bool> stop { false };
+    m_parsing = true;
+
+    auto splitter = tbb::make_filter<void, std::shared_ptr<Chunk>>(tbb::filter_mode::serial_in_order,
+        [&](tbb::flow_control &fc) -> std::shared_ptr<Chunk> {
+            if (stop || (it == last_eol && last_line_emitted)) {
+                fc.stop();
+                return {};
+            }
+            auto chunk = std::make_shared<Chunk>();
+            chunk->spans.reserve(lines_per_chunk);
+            for (; it != last_eol && chunk->spans.size() < lines_per_chunk;) {
+                const char *it_end = it;
+                for (; *it_end != '\r' && *it_end != '\n'; ++ it_end) ;
+                chunk->spans.emplace_back(it, it_end);
+                it = it_end;
+                if (*it == '\r')
+                    ++ it;
+                if (it != last_eol && *it == '\n')
+                    ++ it;
+            }
+            if (it == last_eol && ! last_line_emitted && chunk->spans.size() < lines_per_chunk) {
+                chunk->spans.emplace_back(last_line.c_str(), last_line.c_str() + last_line.size());
+                last_line_emitted = true;
+            }
+            return chunk;
+        });
+
+    auto tokenizer = tbb::make_filter<std::shared_ptr<Chunk>, std::shared_ptr<Chunk>>(tbb::filter_mode::parallel,
+        [this, begin, end](std::shared_ptr<Chunk> chunk) -> std::shared_ptr<Chunk> {
+            chunk->lines.resize(chunk->spans.size());
+            for (size_t i = 0; i < chunk->spans.size(); ++ i) {
+                ParsedLine &line = chunk->lines[i];
+                const char *line_end = this->tokenize_line(chunk->spans[i].first, chunk->spans[i].second, line.gline, line.command);
+                const bool  in_file  = line_end > begin && line_end <= end;
+                line.line_end = in_file && *(line_end - 1) == '\n' ? size_t(line_end - begin) : 0;
+            }
+            chunk->spans.clear();
+            chunk->spans.shrink_to_fit();
+            return chunk;
+        });
+
+    auto consumer = tbb::make_filter<std::shared_ptr<Chunk>, void>(tbb::filter_mode::serial_in_order,
+        [&](std::shared_ptr<Chunk> chunk) {
+            if (stop)
+                return;
+            for (ParsedLine &line : chunk->lines) {
+                this->apply_line_side_effects(line.gline);
+                callback(*this, line.gline);
+                this->update_coordinates(line.gline, line.command);
+                if (line.line_end != 0)
+                    line_end_callback(line.line_end);
+                if (! m_parsing) {
+                    // The callback wishes to exit.
+                    stop = true;
+                    return;
+                }
+            }
+            if (m_progress_callback != nullptr && ! chunk->lines.empty() && chunk->lines.back().line_end != 0)
+                m_progress_callback(static_cast<float>(chunk->lines.back().line_end) / static_cast<float>(file_size));
+        });
+
+    // Set "C" locales to the TBB worker threads, the asserts in the line tokenizer check for them.
+    TBBLocalesSetter locales_setter;
+    tbb::parallel_pipeline(std::max<size_t>(4, 2 * tbb::this_task_arena::max_concurrency()), splitter & tokenizer & consumer);
+    return true;
+}
+
 template<typename ParseLineCallback, typename LineEndCallback>
 bool GCodeReader::parse_file_internal(const std::string &filename, ParseLineCallback parse_line_callback, LineEndCallback line_end_callback)
 {
+    {
+        boost::iostreams::mapped_file_source mapping;
+        try {
+            // boost::filesystem::path is UTF-8 aware, see boost::nowide::nowide_filesystem().
+            const boost::filesystem::path path(filename);
+            if (boost::filesystem::file_size(path) > 0)
+                mapping.open(path);
+        } catch (const std::exception &ex) {
+            BOOST_LOG_TRIVIAL(debug) << "GCodeReader: failed to memory map " << filename << ", falling back to buffered reading: " << ex.what();
+        }
+        if (mapping.is_open())
+            return this->parse_mapped_file_parallel(mapping.data(), mapping.data() + mapping.size(), parse_line_callback, line_end_callback);
+    }
+
     GCodeLine gline;    
     return this->parse_file_raw_internal(filename, 
         [this, &gline, parse_line_callback](const char *begin, const char *end) {
@@ -298,8 +480,11 @@ bool GCodeReader::GCodeLine::has_value(char axis, int &value) const
 
 void GCodeReader::GCodeLine::set(const GCodeReader &reader, const Axis axis, const float new_value, const int decimal_digits)
 {
-    std::ostringstream ss;
-    ss << std::fixed << std::setprecision(decimal_digits) << new_value;
+    // Same output as std::fixed with std::setprecision(decimal_digits), without constructing a stream for each value.
+    char value[64];
+    const int value_len = snprintf(value, sizeof(value), "%.*f", decimal_digits, double(new_value));
+    assert(value_len > 0 && value_len < int(sizeof(value)));
+    const std::string_view value_str(value, size_t(value_len));
 
     char match[3] = " X";
     if (int(axis) < 3)
@@ -316,13 +501,16 @@ void GCodeReader::GCodeLine::set(const GCodeReader &reader, const Axis axis, con
     if (this->has(axis)) {
         size_t pos = m_raw.find(match)+2;
         size_t end = m_raw.find(' ', pos+1);
-        m_raw = m_raw.replace(pos, end-pos, ss.str());
+        m_raw.replace(pos, end == std::string::npos ? std::string::npos : end-pos, value_str);
     } else {
         size_t pos = m_raw.find(' ');
-        if (pos == std::string::npos)
-            m_raw += std::string(match) + ss.str();
-        else
-            m_raw = m_raw.replace(pos, 0, std::string(match) + ss.str());
+        if (pos == std::string::npos) {
+            m_raw += match;
+            m_raw += value_str;
+        } else {
+            m_raw.insert(pos, value_str);
+            m_raw.insert(pos, match);
+        }
     }
     m_axis[axis] = new_value;
     m_mask |= 1 << int(axis);
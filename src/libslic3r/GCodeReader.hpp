@@ -177,12 +177,21 @@ public:
     void set_progress_callback(ProgressCallback cb) { m_progress_callback = cb; }
 
 private:
+    template<typename ParseLineCallback, typename LineEndCallback>
+    bool        parse_mapped_file_internal(const char *begin, const char *end, ParseLineCallback parse_line_callback, LineEndCallback line_end_callback);
     template<typename ParseLineCallback, typename LineEndCallback>
     bool        parse_file_raw_internal(const std::string &filename, ParseLineCallback parse_line_callback, LineEndCallback line_end_callback);
     template<typename ParseLineCallback, typename LineEndCallback>
     bool        parse_file_internal(const std::string &filename, ParseLineCallback parse_line_callback, LineEndCallback line_end_callback);
 
+    template<typename Callback, typename LineEndCallback>
+    bool        parse_mapped_file_parallel(const char *begin, const char *end, Callback callback, LineEndCallback line_end_callback);
+
     const char* parse_line_internal(const char *ptr, const char *end, GCodeLine &gline, std::pair<const char*, const char*> &command);
+    // Parse a single line into gline without modifying the state of the reader, thus it may be called concurrently.
+    const char* tokenize_line(const char *ptr, const char *end, GCodeLine &gline, std::pair<const char*, const char*> &command) const;
+    // Update the state of the reader after a line has been tokenized by tokenize_line().
+    void        apply_line_side_effects(const GCodeLine &gline);
     void        update_coordinates(GCodeLine &gline, std::pair<const char*, const char*> &command);
 
     static bool         is_whitespace(char c)           { return c == ' ' || c == '\t'; }
@@ -100,21 +100,25 @@ static inline bool circle_approximation_sufficient(const Circle &circle, const P
     // The circle was calculated from the 1st and last point of the point sequence, thus the fitting of those points does not need to be evaluated.
     assert(end - begin >= 3);
 
+    // |distance_from_center - radius| <= tolerance is tested on squared distances against an annulus, saving a square root per point.
+    const double r_min  = std::max(0., circle.radius - tolerance);
+    const double r_min2 = r_min * r_min;
+    const double r_max2 = sqr(circle.radius + tolerance);
+    auto inside_annulus = [&circle, r_min2, r_max2](const Point &pt) {
+        const double distance_from_center2 = (pt - circle.center).cast<double>().squaredNorm();
+        return distance_from_center2 >= r_min2 && distance_from_center2 <= r_max2;
+    };
+
     // Test the 1st point.
-    if (double distance_from_center = (*begin - circle.center).cast<double>().norm();
-        std::abs(distance_from_center - circle.radius) > tolerance)
+    if (! inside_annulus(*begin))
         return false;
 
     for (auto it = std::next(begin); it != end; ++ it) {
-        if (double distance_from_center = (*it - circle.center).cast<double>().norm();
-            std::abs(distance_from_center - circle.radius) > tolerance)
+        if (! inside_annulus(*it))
             return false;
         Point closest_point;
-        if (foot_pt_on_segment(*std::prev(it), *it, circle.center, closest_point)) {
-            if (double distance_from_center = (closest_point - circle.center).cast<double>().norm();
-                std::abs(distance_from_center - circle.radius) > tolerance)
-                return false;
-        }
+        if (foot_pt_on_segment(*std::prev(it), *it, circle.center, closest_point) && ! inside_annulus(closest_point))
+            return false;
     }
     return true;
 }
@@ -15,7 +15,7 @@
 
 namespace Slic3r {
 
-using ExPolygons = std::vector<ExPolygon>;
+using ExPolygons = std::vector<ExPolygon, PointsAllocator<ExPolygon>>;
 
 namespace Geometry {
 
@@ -6,6 +6,7 @@
 
 #include <boost/log/trivial.hpp>
 #include <boost/polygon/polygon.hpp>
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 
@@ -13,6 +14,7 @@
 #include "libslic3r/ClipperUtils.hpp"
 #include "libslic3r/ExPolygon.hpp"
 #include "libslic3r/Point.hpp"
+#include "libslic3r/Polygon.hpp"
 #include "libslic3r/libslic3r.h"
 
 #ifdef SLIC3R_DEBUG
@@ -454,8 +456,26 @@ private:
     const Lines &lines;
 };
 
-MedialAxis::MedialAxis(double min_width, double max_width, const ExPolygon &expolygon) :
-    m_expolygon(expolygon), m_lines(expolygon.lines()), m_min_width(min_width), m_max_width(max_width)
+// Remove the duplicate vertices and the vertices closer than SCALED_EPSILON to the segment connecting their neighbors.
+// Such near degenerate input segments are the most common cause of an invalid Voronoi diagram,
+// which is then expensive to repair by rotating the input back and forth.
+static Lines voronoi_input_lines(const ExPolygon &expolygon)
+{
+    ExPolygon snapped = expolygon;
+    remove_collinear(snapped.contour);
+    if (snapped.contour.size() < 3)
+        // The whole contour is degenerate, let the Voronoi diagram deal with it.
+        return expolygon.lines();
+    for (Polygon &hole : snapped.holes)
+        remove_collinear(hole);
+    snapped.holes.erase(std::remove_if(snapped.holes.begin(), snapped.holes.end(), [](const Polygon &hole) { return hole.size() < 3; }),
+        snapped.holes.end());
+    return snapped.lines();
+}
+
+MedialAxis::MedialAxis(double min_width, double max_width, const ExPolygon &expolygon, VoronoiDiagram *vd) :
+    m_expolygon(expolygon), m_lines(voronoi_input_lines(expolygon)), m_min_width(min_width), m_max_width(max_width),
+    m_vd(vd ? *vd : m_vd_own)
 {
     (void)m_expolygon; // supress unused variable warning
 }
@@ -475,6 +495,8 @@ void MedialAxis::build(ThickPolylines* polylines)
         test(l.b.y());
     }
 #endif // NDEBUG
+    // The diagram may be shared, boost::polygon appends to a diagram that was not cleared.
+    m_vd.clear();
     m_vd.construct_voronoi(m_lines.begin(), m_lines.end());
 
     // For several ExPolygons in SPE-1729, an invalid Voronoi diagram was produced that wasn't fixable by rotating input data.
@@ -483,6 +505,7 @@ void MedialAxis::build(ThickPolylines* polylines)
     // So we filter out such thin lines and holes and try to compute the Voronoi diagram again.
     if (!m_vd.is_valid()) {
         m_lines = to_lines(closing_ex({m_expolygon}, float(2. * SCALED_EPSILON)));
+        m_vd.clear();
         m_vd.construct_voronoi(m_lines.begin(), m_lines.end());
 
         if (!m_vd.is_valid())
@@ -19,7 +19,9 @@ namespace Slic3r::Geometry {
 
 class MedialAxis {
 public:
-    MedialAxis(double min_width, double max_width, const ExPolygon &expolygon);
+    // The Voronoi diagram is built into vd if provided, so that its storage
+    // may be reused by consecutive medial axis extractions.
+    MedialAxis(double min_width, double max_width, const ExPolygon &expolygon, VoronoiDiagram *vd = nullptr);
     void build(ThickPolylines* polylines);
     void build(Polylines* polylines);
     
@@ -33,7 +35,8 @@ private:
 
     // Voronoi Diagram.
     using VD = VoronoiDiagram;
-    VD                   m_vd;
+    VD                   m_vd_own;
+    VD                  &m_vd;
 
     // Annotations of the VD skeleton edges.
     struct EdgeData {
@@ -19,6 +19,8 @@ enum class VisitorReturnMask : unsigned int {
     CONTINUE_LEFT  = 1,
     CONTINUE_RIGHT = 2,
     STOP           = 4,
+    // Visit the right subtree before the left subtree if both are to be visited.
+    RIGHT_FIRST    = 8,
 };
 
 // KD tree for N-dimensional closest point search.
@@ -70,8 +72,11 @@ public:
     {
         CoordType dist = point_coord - this->coordinate(idx, dimension);
         return (double(dist) * dist < search_radius + EPSILON) ?
-                                                                    // The plane intersects a hypersphere centered at point_coord of search_radius.
-                   ((unsigned int)(VisitorReturnMask::CONTINUE_LEFT) | (unsigned int)(VisitorReturnMask::CONTINUE_RIGHT)) :
+                   // The plane intersects a hypersphere centered at point_coord of search_radius.
+                   // Descend into the half space containing point_coord first, so that the closest point searches
+                   // shrink their search radius early and skip most of the other half space.
+                   ((unsigned int)(VisitorReturnMask::CONTINUE_LEFT) | (unsigned int)(VisitorReturnMask::CONTINUE_RIGHT) |
+                    (dist > CoordType(0) ? (unsigned int)(VisitorReturnMask::RIGHT_FIRST) : 0u)) :
                    // The plane does not intersect the hypersphere.
                    (dist > CoordType(0)) ? (unsigned int)(VisitorReturnMask::CONTINUE_RIGHT) : (unsigned int)(VisitorReturnMask::CONTINUE_LEFT);
     }
@@ -186,10 +191,17 @@ private:
         unsigned int mask = visitor(m_nodes[node], dimension);
         if ((mask & (unsigned int)VisitorReturnMask::STOP) == 0) {
             size_t next_dimension = (++ dimension == NumDimensions) ? 0 : dimension;
-            if (mask & (unsigned int)VisitorReturnMask::CONTINUE_LEFT)
-                visit_recursive(left,  next_dimension, visitor);
-            if (mask & (unsigned int)VisitorReturnMask::CONTINUE_RIGHT)
-                visit_recursive(right, next_dimension, visitor);
+            if (mask & (unsigned int)VisitorReturnMask::RIGHT_FIRST) {
+                if (mask & (unsigned int)VisitorReturnMask::CONTINUE_RIGHT)
+                    visit_recursive(right, next_dimension, visitor);
+                if (mask & (unsigned int)VisitorReturnMask::CONTINUE_LEFT)
+                    visit_recursive(left,  next_dimension, visitor);
+            } else {
+                if (mask & (unsigned int)VisitorReturnMask::CONTINUE_LEFT)
+                    visit_recursive(left,  next_dimension, visitor);
+                if (mask & (unsigned int)VisitorReturnMask::CONTINUE_RIGHT)
+                    visit_recursive(right, next_dimension, visitor);
+            }
         }
     }
 
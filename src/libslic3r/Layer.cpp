@@ -18,6 +18,7 @@
 #include <tuple>
 #include <cassert>
 
+#include "AABBTreeLines.hpp"
 #include "ClipperZUtils.hpp"
 #include "ClipperUtils.hpp"
 #include "Point.hpp"
@@ -46,6 +47,30 @@ Layer::~Layer()
     m_regions.clear();
 }
 
+void Layer::clear_extrusions()
+{
+    for (LayerRegion *layerm : m_regions) {
+        layerm->m_perimeters.clear();
+        layerm->m_thin_fills.clear();
+        layerm->m_fills.clear();
+    }
+    for (LayerSlice &lslice : lslices_ex)
+        for (LayerIsland &island : lslice.islands) {
+            island.perimeters = {};
+            island.thin_fills = {};
+            island.fills.clear();
+        }
+    this->smooth_path_cache.reset();
+}
+
+const AABBTreeLines::LinesDistancer<Linef>& Layer::lslices_distancer() const
+{
+    std::call_once(m_lslices_distancer_once, [this]() {
+        m_lslices_distancer = std::make_shared<AABBTreeLines::LinesDistancer<Linef>>(to_unscaled_linesf(this->lslices));
+    });
+    return *m_lslices_distancer;
+}
+
 // Test whether whether there are any slices assigned to this layer.
 bool Layer::empty() const
 {
@@ -666,7 +691,7 @@ inline bool has_compatible_layer_regions(const PrintRegionConfig &config, const
 // Here the perimeters are created cummulatively for all layer regions sharing the same parameters influencing the perimeters.
 // The perimeter paths and the thin fills (ExtrusionEntityCollection) are assigned to the first compatible layer region.
 // The resulting fill surface is split back among the originating regions.
-void Layer::make_perimeters()
+void Layer::make_perimeters(PerimeterGenerator::ArachneWallsCache *arachne_walls_cache, const std::function<void()> &throw_on_cancel)
 {
     BOOST_LOG_TRIVIAL(trace) << "Generating perimeters for layer " << this->id();
     
@@ -743,7 +768,7 @@ void Layer::make_perimeters()
         }
 
         if (layer_region_ids.size() == 1) { // Optimization.
-            curr_region.make_perimeters(curr_region.slices(), perimeter_regions, perimeter_and_gapfill_ranges, fill_expolygons, fill_expolygons_ranges);
+            curr_region.make_perimeters(curr_region.slices(), perimeter_regions, perimeter_and_gapfill_ranges, fill_expolygons, fill_expolygons_ranges, arachne_walls_cache, throw_on_cancel);
             this->sort_perimeters_into_islands(curr_region.slices(), curr_region_id, perimeter_and_gapfill_ranges, std::move(fill_expolygons), fill_expolygons_ranges, layer_region_ids);
         } else {
             SurfaceCollection new_slices;
@@ -787,7 +812,7 @@ void Layer::make_perimeters()
             }
 
             // Make perimeters.
-            layerm_config->make_perimeters(new_slices, perimeter_regions, perimeter_and_gapfill_ranges, fill_expolygons, fill_expolygons_ranges);
+            layerm_config->make_perimeters(new_slices, perimeter_regions, perimeter_and_gapfill_ranges, fill_expolygons, fill_expolygons_ranges, arachne_walls_cache, throw_on_cancel);
             this->sort_perimeters_into_islands(new_slices, region_id_config, perimeter_and_gapfill_ranges, std::move(fill_expolygons), fill_expolygons_ranges, layer_region_ids);
         }
     }
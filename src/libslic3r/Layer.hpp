@@ -17,6 +17,8 @@
 #include <algorithm>
 #include <functional>
 #include <limits>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
@@ -37,7 +39,7 @@ namespace Slic3r {
 
 class ExPolygon;
 
-using ExPolygons = std::vector<ExPolygon>;
+using ExPolygons = std::vector<ExPolygon, PointsAllocator<ExPolygon>>;
 class Layer;
 
 using LayerPtrs = std::vector<Layer*>;
@@ -51,10 +53,22 @@ namespace FillAdaptive {
     struct Octree;
 }
 
+namespace AABBTreeLines {
+    template<typename LineType> class LinesDistancer;
+}
+
 namespace FillLightning {
     class Generator;
 };
 
+namespace GCode {
+    struct LayerSmoothPathCache;
+}
+
+namespace PerimeterGenerator {
+    class ArachneWallsCache;
+}
+
 // Range of extrusions, referencing the source region by an index.
 class LayerExtrusionRange : public ExtrusionRange
 {
@@ -182,6 +196,10 @@ public:
     //Extrusions estimated to be seriously malformed, estimated during "Estimating curled extrusions" step. These lines should be avoided during fast travels.
     CurledLines         curled_lines;
 
+    // Smooth paths interpolated from the extrusions of this layer by the G-code export. Kept to be reused by the following
+    // G-code exports until the extrusions of this layer are regenerated, see GCodeGenerator::smooth_path_interpolate().
+    mutable std::shared_ptr<GCode::LayerSmoothPathCache> smooth_path_cache;
+
     // Collection of expolygons generated by slicing the possibly multiple meshes of the source geometry 
     // (with possibly differing extruder ID and slicing parameters) and merged.
     // For the first layer, if the Elephant foot compensation is applied, this lslice is uncompensated, therefore
@@ -193,6 +211,10 @@ public:
     ExPolygons 				lslices;
     std::vector<size_t>     lslice_indices_sorted_by_print_order;
     LayerSlices             lslices_ex;
+    // Distancer over the unscaled lines of lslices, to measure the distance of the extrusions of the layer above to the boundary
+    // of this layer. Built on the first call and shared by the support spots search, the estimation of the curled extrusions
+    // and the calculation of the overhanging perimeters. Thread safe, lslices shall not be modified after the first call.
+    const AABBTreeLines::LinesDistancer<Linef>& lslices_distancer() const;
 
     size_t                  region_count() const { return m_regions.size(); }
     const LayerRegion*      get_region(int idx) const { return m_regions[idx]; }
@@ -220,14 +242,26 @@ public:
         for (const LayerRegion *layerm : m_regions) if (layerm->slices().any_bottom_contains(item)) return true;
         return false;
     }
-    void                    make_perimeters();
+    // arachne_walls_cache is optional, shared by the layers of the object.
+    // throw_on_cancel is optional, it is called from inside the perimeter generator.
+    void                    make_perimeters(PerimeterGenerator::ArachneWallsCache *arachne_walls_cache = nullptr, const std::function<void()> &throw_on_cancel = nullptr);
     void                    make_fills(FillAdaptive::Octree     *adaptive_fill_octree,
                                        FillAdaptive::Octree     *support_fill_octree,
                                        FillLightning::Generator *lightning_generator);
     Polylines               generate_sparse_infill_polylines_for_anchoring(FillAdaptive::Octree *adaptive_fill_octree,
                                                                            FillAdaptive::Octree *support_fill_octree,
                                                                            FillLightning::Generator* lightning_generator) const;
-    void 					make_ironing();
+    // Ironing extrusions over the top surfaces of a single region span, to be appended to the fills of region_id.
+    struct IroningFill {
+        uint32_t            region_id;
+        Polylines           polylines;
+        ExtrusionAttributes attributes;
+    };
+    // Only reads the surfaces classified by posPrepareInfill, thus it may run concurrently with make_fills() of the same layer.
+    std::vector<IroningFill> generate_ironing() const;
+    // Appends the ironing extrusions into the fills of the layer regions and their islands, to be called after make_fills().
+    void                    apply_ironing(std::vector<IroningFill> &&ironing_fills);
+    void 					make_ironing() { this->apply_ironing(this->generate_ironing()); }
 
     void                    export_region_slices_to_svg(const char *path) const;
     void                    export_region_fill_surfaces_to_svg(const char *path) const;
@@ -237,6 +271,9 @@ public:
 
     // Is there any valid extrusion assigned to this LayerRegion?
     virtual bool            has_extrusions() const { for (auto layerm : m_regions) if (layerm->has_extrusions()) return true; return false; }
+    // Release the perimeter, gap fill, infill and ironing extrusions and the smooth paths interpolated from them.
+    // Used by the low memory mode once the G-code of the layer was exported, see Print::set_low_memory().
+    virtual void            clear_extrusions();
 //    virtual bool            has_extrusions() const { for (const LayerSlice &lslice : lslices_ex) if (lslice.has_extrusions()) return true; return false; }
 
 protected:
@@ -274,6 +311,9 @@ private:
     size_t              m_id;
     PrintObject        *m_object;
     LayerRegionPtrs     m_regions;
+
+    mutable std::once_flag                                          m_lslices_distancer_once;
+    mutable std::shared_ptr<AABBTreeLines::LinesDistancer<Linef>>   m_lslices_distancer;
 };
 
 class SupportLayer : public Layer 
@@ -290,6 +330,7 @@ public:
 
     // Is there any valid extrusion assigned to this LayerRegion?
     virtual bool                has_extrusions() const { return ! support_fills.empty(); }
+    void                        clear_extrusions() override { Layer::clear_extrusions(); support_fills.clear(); }
 
     // Zero based index of an interface layer, used for alternating direction of interface / contact layers.
     size_t                      interface_id() const { return m_interface_id; }
@@ -4,6 +4,8 @@
 ///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
 ///|/
 #include <boost/log/trivial.hpp>
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
 #include <algorithm>
 #include <string>
 #include <map>
@@ -97,7 +99,11 @@ void LayerRegion::make_perimeters(
     // All fill areas produced for all input slices above.
     ExPolygons                                             &fill_expolygons,
     // Ranges of fill areas above per input slice.
-    std::vector<ExPolygonRange>                            &fill_expolygons_ranges)
+    std::vector<ExPolygonRange>                            &fill_expolygons_ranges,
+    // Optional cache of the Arachne walls shared by the layers of the object.
+    PerimeterGenerator::ArachneWallsCache                  *arachne_walls_cache,
+    // Optional cancellation callback.
+    const std::function<void()>                            &throw_on_cancel)
 {
     m_perimeters.clear();
     m_thin_fills.clear();
@@ -213,6 +219,8 @@ void LayerRegion::make_perimeters(
         perimeter_regions,
         spiral_vase
     );
+    params.arachne_walls_cache = arachne_walls_cache;
+    params.throw_on_cancel     = throw_on_cancel;
 
     // Cummulative sum of polygons over all the regions.
     const ExPolygons *lower_slices = this->layer()->lower_layer ? &this->layer()->lower_layer->lslices : nullptr;
@@ -220,11 +228,57 @@ void LayerRegion::make_perimeters(
     // Cache for offsetted lower_slices
     Polygons          lower_layer_polygons_cache;
 
+    const bool arachne = this->layer()->object()->config().perimeter_generator.value == PerimeterGeneratorType::Arachne && !spiral_vase;
+    if (arachne && slices.size() > 1) {
+        // The islands are independent, generate their walls in parallel, so that large layers with many islands
+        // scale over the cores even if there are just a few layers.
+        struct IslandPerimeters {
+            ExtrusionEntityCollection loops;
+            ExtrusionEntityCollection gap_fill;
+            ExPolygons                fill_expolygons;
+        };
+        std::vector<IslandPerimeters> islands(slices.size());
+        // The cache of the lower slices is shared by the islands, fill it before.
+        PerimeterGenerator::update_lower_slices_polygons_cache(params, lower_slices, lower_layer_polygons_cache);
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, slices.size()),
+            [&params, &slices, lower_slices, upper_slices, &lower_layer_polygons_cache, &islands](const tbb::blocked_range<size_t> &range) {
+            for (size_t island_idx = range.begin(); island_idx < range.end(); ++ island_idx) {
+                // Empty cache is filled by process_arachne(), which must not happen to the shared one.
+                Polygons         lower_layer_polygons_empty;
+                IslandPerimeters &island = islands[island_idx];
+                PerimeterGenerator::process_arachne(
+                    // input:
+                    params,
+                    slices.surfaces[island_idx],
+                    lower_slices,
+                    upper_slices,
+                    lower_layer_polygons_cache.empty() ? lower_layer_polygons_empty : lower_layer_polygons_cache,
+                    // output:
+                    island.loops,
+                    island.gap_fill,
+                    island.fill_expolygons);
+            }
+        });
+        for (IslandPerimeters &island : islands) {
+            auto perimeters_begin      = uint32_t(m_perimeters.size());
+            auto gap_fills_begin       = uint32_t(m_thin_fills.size());
+            auto fill_expolygons_begin = uint32_t(fill_expolygons.size());
+            m_perimeters.append(std::move(island.loops.entities));
+            m_thin_fills.append(std::move(island.gap_fill.entities));
+            append(fill_expolygons, std::move(island.fill_expolygons));
+            perimeter_and_gapfill_ranges.emplace_back(
+                ExtrusionRange{ perimeters_begin, uint32_t(m_perimeters.size()) },
+                ExtrusionRange{ gap_fills_begin,  uint32_t(m_thin_fills.size()) });
+            fill_expolygons_ranges.emplace_back(ExtrusionRange{ fill_expolygons_begin, uint32_t(fill_expolygons.size()) });
+        }
+        return;
+    }
+
     for (const Surface &surface : slices) {
         auto perimeters_begin      = uint32_t(m_perimeters.size());
         auto gap_fills_begin       = uint32_t(m_thin_fills.size());
         auto fill_expolygons_begin = uint32_t(fill_expolygons.size());
-        if (this->layer()->object()->config().perimeter_generator.value == PerimeterGeneratorType::Arachne && !spiral_vase)
+        if (arachne)
             PerimeterGenerator::process_arachne(
                 // input:
                 params,
@@ -525,7 +579,7 @@ Surfaces expand_merge_surfaces(
         append(expansions, std::move(zone_expansions));
     }
 
-    std::vector<ExPolygon> expanded = merge_expansions_into_expolygons(std::move(src), std::move(expansions));
+    ExPolygons expanded = merge_expansions_into_expolygons(std::move(src), std::move(expansions));
     //NOTE: The current regularization of the shells can create small unasigned regions in the object (E.G. benchy)
     // without the following closing operation, those regions will stay unfilled and cause small holes in the expanded surface.
     // look for narrow_ensure_vertical_wall_thickness_region_radius filter.
@@ -544,47 +598,26 @@ Surfaces expand_merge_surfaces(
     return out;
 }
 
-void LayerRegion::process_external_surfaces(const Layer *lower_layer, const Polygons *lower_layer_covered)
+// Expand the top / bottom / bridge surfaces into the solid and sparse infill, detect the bridging directions.
+// Returns the fill surfaces with the external surfaces expanded and the infill trimmed by the expanded surfaces.
+static Surfaces expand_external_surfaces(Surfaces &&surfaces, const ExternalSurfacesParams &params)
 {
     using namespace Slic3r::Algorithm;
 
-#ifdef SLIC3R_DEBUG_SLICE_PROCESSING
-    export_region_fill_surfaces_to_svg_debug("4_process_external_surfaces-initial");
-#endif /* SLIC3R_DEBUG_SLICE_PROCESSING */
-
-    // Width of the perimeters.
-    float shell_width = 0;
-    float expansion_min = 0;
-    if (int num_perimeters = this->region().config().perimeters; num_perimeters > 0) {
-        Flow external_perimeter_flow = this->flow(frExternalPerimeter);
-        Flow perimeter_flow          = this->flow(frPerimeter);
-        shell_width  = 0.5f * external_perimeter_flow.scaled_width() + external_perimeter_flow.scaled_spacing();
-        shell_width += perimeter_flow.scaled_spacing() * (num_perimeters - 1);
-        expansion_min = perimeter_flow.scaled_spacing();
-    } else {
-        // TODO: Maybe there is better solution when printing with zero perimeters, but this works reasonably well, given the situation
-        shell_width   = float(SCALED_EPSILON);
-        expansion_min = float(SCALED_EPSILON);;
-    }
-
-    // Scaled expansions of the respective external surfaces.
-    float                           expansion_top           = shell_width * sqrt(2.);
-    float                           expansion_bottom        = expansion_top;
-    float                           expansion_bottom_bridge = expansion_top;
     // Expand by waves of expansion_step size (expansion_step is scaled), but with no more steps than max_nr_expansion_steps.
     static constexpr const float    expansion_step          = scaled<float>(0.1);
     // Don't take more than max_nr_steps for small expansion_step.
     static constexpr const size_t   max_nr_expansion_steps  = 5;
-    // Radius (with added epsilon) to absorb empty regions emering from regularization of ensuring, viz  const float narrow_ensure_vertical_wall_thickness_region_radius = 0.5f * 0.65f * min_perimeter_infill_spacing;
-    const float closing_radius = 0.55f * 0.65f * 1.05f * this->flow(frSolidInfill).scaled_spacing();
+
+    SurfaceCollection fill_surfaces(std::move(surfaces));
 
     // Expand the top / bottom / bridge surfaces into the shell thickness solid infills.
     double     layer_thickness;
-    ExPolygons shells = union_ex(fill_surfaces_extract_expolygons(m_fill_surfaces.surfaces, { stInternalSolid }, layer_thickness));
-    ExPolygons sparse = union_ex(fill_surfaces_extract_expolygons(m_fill_surfaces.surfaces, { stInternal }, layer_thickness));
-    ExPolygons top_expolygons = union_ex(fill_surfaces_extract_expolygons(m_fill_surfaces.surfaces, { stTop }, layer_thickness));
-    const auto expansion_params_into_sparse_infill = RegionExpansionParameters::build(expansion_min, expansion_step, max_nr_expansion_steps);
-    const auto expansion_params_into_solid_infill  = RegionExpansionParameters::build(expansion_bottom_bridge, expansion_step, max_nr_expansion_steps);
+    ExPolygons shells = union_ex(fill_surfaces_extract_expolygons(fill_surfaces.surfaces, { stInternalSolid }, layer_thickness));
+    ExPolygons sparse = union_ex(fill_surfaces_extract_expolygons(fill_surfaces.surfaces, { stInternal }, layer_thickness));
+    ExPolygons top_expolygons = union_ex(fill_surfaces_extract_expolygons(fill_surfaces.surfaces, { stTop }, layer_thickness));
+    const auto expansion_params_into_sparse_infill = RegionExpansionParameters::build(params.expansion_min, expansion_step, max_nr_expansion_steps);
+    const auto expansion_params_into_solid_infill  = RegionExpansionParameters::build(params.expansion_bottom_bridge, expansion_step, max_nr_expansion_steps);
 
     std::vector<ExpansionZone> expansion_zones{
         ExpansionZone{std::move(shells), expansion_params_into_solid_infill},
@@ -594,11 +627,10 @@ void LayerRegion::process_external_surfaces(const Layer *lower_layer, const Poly
 
     SurfaceCollection bridges;
     {
-        BOOST_LOG_TRIVIAL(trace) << "Processing external surface, detecting bridges. layer" << this->layer()->print_z;
-        const double custom_angle = this->region().config().bridge_angle.value;
-        bridges.surfaces = custom_angle > 0 ?
-            expand_merge_surfaces(m_fill_surfaces.surfaces, stBottomBridge, expansion_zones, closing_radius, Geometry::deg2rad(custom_angle)) :
-            expand_bridges_detect_orientations(m_fill_surfaces.surfaces, expansion_zones, closing_radius);
+        BOOST_LOG_TRIVIAL(trace) << "Processing external surface, detecting bridges.";
+        bridges.surfaces = params.custom_bridge_angle > 0 ?
+            expand_merge_surfaces(fill_surfaces.surfaces, stBottomBridge, expansion_zones, params.closing_radius, Geometry::deg2rad(params.custom_bridge_angle)) :
+            expand_bridges_detect_orientations(fill_surfaces.surfaces, expansion_zones, params.closing_radius);
         BOOST_LOG_TRIVIAL(trace) << "Processing external surface, detecting bridges - done";
 #if 0
         {
@@ -608,40 +640,132 @@ void LayerRegion::process_external_surfaces(const Layer *lower_layer, const Poly
 #endif
     }
 
-    m_fill_surfaces.remove_types({ stTop });
+    fill_surfaces.remove_types({ stTop });
     {
         Surface top_templ(stTop, {});
         top_templ.thickness = layer_thickness;
-        m_fill_surfaces.append(std::move(expansion_zones.back().expolygons), top_templ);
+        fill_surfaces.append(std::move(expansion_zones.back().expolygons), top_templ);
     }
 
     expansion_zones.pop_back();
 
-    expansion_zones.at(0).parameters = RegionExpansionParameters::build(expansion_bottom, expansion_step, max_nr_expansion_steps);
-    Surfaces bottoms = expand_merge_surfaces(m_fill_surfaces.surfaces, stBottom, expansion_zones, closing_radius);
+    expansion_zones.at(0).parameters = RegionExpansionParameters::build(params.expansion_bottom, expansion_step, max_nr_expansion_steps);
+    Surfaces bottoms = expand_merge_surfaces(fill_surfaces.surfaces, stBottom, expansion_zones, params.closing_radius);
 
-    expansion_zones.at(0).parameters = RegionExpansionParameters::build(expansion_top, expansion_step, max_nr_expansion_steps);
-    Surfaces tops = expand_merge_surfaces(m_fill_surfaces.surfaces, stTop, expansion_zones, closing_radius);
+    expansion_zones.at(0).parameters = RegionExpansionParameters::build(params.expansion_top, expansion_step, max_nr_expansion_steps);
+    Surfaces tops = expand_merge_surfaces(fill_surfaces.surfaces, stTop, expansion_zones, params.closing_radius);
 
-//    m_fill_surfaces.remove_types({ stBottomBridge, stBottom, stTop, stInternal, stInternalSolid });
-    m_fill_surfaces.clear();
+//    fill_surfaces.remove_types({ stBottomBridge, stBottom, stTop, stInternal, stInternalSolid });
+    fill_surfaces.clear();
     unsigned zones_expolygons_count = 0;
     for (const ExpansionZone& zone : expansion_zones)
         zones_expolygons_count += zone.expolygons.size();
-    reserve_more(m_fill_surfaces.surfaces, zones_expolygons_count + bridges.size() + bottoms.size() + tops.size());
+    reserve_more(fill_surfaces.surfaces, zones_expolygons_count + bridges.size() + bottoms.size() + tops.size());
     {
         Surface solid_templ(stInternalSolid, {});
         solid_templ.thickness = layer_thickness;
-        m_fill_surfaces.append(std::move(expansion_zones[0].expolygons), solid_templ);
+        fill_surfaces.append(std::move(expansion_zones[0].expolygons), solid_templ);
     }
     {
         Surface sparse_templ(stInternal, {});
         sparse_templ.thickness = layer_thickness;
-        m_fill_surfaces.append(std::move(expansion_zones[1].expolygons), sparse_templ);
+        fill_surfaces.append(std::move(expansion_zones[1].expolygons), sparse_templ);
+    }
+    fill_surfaces.append(std::move(bridges.surfaces));
+    fill_surfaces.append(std::move(bottoms));
+    fill_surfaces.append(std::move(tops));
+    return std::move(fill_surfaces.surfaces);
+}
+
+// Split the fill surfaces by the LayerSlices containing them.
+// Returns an empty vector if any of the surfaces could not be assigned to a LayerSlice.
+static std::vector<Surfaces> split_surfaces_by_lslices(const Layer &layer, const Surfaces &surfaces)
+{
+    std::vector<Surfaces> out;
+    if (layer.lslices.size() < 2 || layer.lslices_ex.size() != layer.lslices.size())
+        return out;
+    std::vector<int> lslice_to_group(layer.lslices.size(), -1);
+    for (const Surface &surface : surfaces) {
+        if (surface.expolygon.contour.empty())
+            return {};
+        const Point &pt = surface.expolygon.contour.points.front();
+        int lslice_idx = -1;
+        for (int i = 0; i < int(layer.lslices.size()); ++ i)
+            if (layer.lslices_ex[i].bbox.contains(pt) && layer.lslices[i].contains(pt)) {
+                lslice_idx = i;
+                break;
+            }
+        if (lslice_idx == -1)
+            return {};
+        if (lslice_to_group[lslice_idx] == -1) {
+            lslice_to_group[lslice_idx] = int(out.size());
+            out.emplace_back();
+        }
+        out[lslice_to_group[lslice_idx]].emplace_back(surface);
+    }
+    return out;
+}
+
+void LayerRegion::process_external_surfaces(const Layer *lower_layer, const Polygons *lower_layer_covered)
+{
+#ifdef SLIC3R_DEBUG_SLICE_PROCESSING
+    export_region_fill_surfaces_to_svg_debug("4_process_external_surfaces-initial");
+#endif /* SLIC3R_DEBUG_SLICE_PROCESSING */
+
+    // Width of the perimeters.
+    float shell_width = 0;
+    float expansion_min = 0;
+    const int num_perimeters = this->region().config().perimeters;
+    if (num_perimeters > 0) {
+        Flow external_perimeter_flow = this->flow(frExternalPerimeter);
+        Flow perimeter_flow          = this->flow(frPerimeter);
+        shell_width  = 0.5f * external_perimeter_flow.scaled_width() + external_perimeter_flow.scaled_spacing();
+        shell_width += perimeter_flow.scaled_spacing() * (num_perimeters - 1);
+        expansion_min = perimeter_flow.scaled_spacing();
+    } else {
+        // TODO: Maybe there is better solution when printing with zero perimeters, but this works reasonably well, given the situation
+        shell_width   = float(SCALED_EPSILON);
+        expansion_min = float(SCALED_EPSILON);;
+    }
+
+    ExternalSurfacesParams params;
+    params.expansion_min           = expansion_min;
+    // Scaled expansions of the respective external surfaces.
+    params.expansion_top           = shell_width * sqrt(2.);
+    params.expansion_bottom        = params.expansion_top;
+    params.expansion_bottom_bridge = params.expansion_top;
+    // Radius (with added epsilon) to absorb empty regions emering from regularization of ensuring, viz  const float narrow_ensure_vertical_wall_thickness_region_radius = 0.5f * 0.65f * min_perimeter_infill_spacing;
+    params.closing_radius          = 0.55f * 0.65f * 1.05f * this->flow(frSolidInfill).scaled_spacing();
+    params.custom_bridge_angle     = this->region().config().bridge_angle.value;
+
+    // Only the fill surfaces and the region parameters are the input of the expansion. If neither of them changed since the last call
+    // (for example if just the infill pattern or density changed), reuse the last result.
+    ExternalSurfacesCache &cache = m_external_surfaces_cache;
+    if (cache.valid && cache.params == params && cache.input == m_fill_surfaces.surfaces) {
+        m_fill_surfaces.surfaces = cache.output;
+    } else {
+        cache.valid  = false;
+        cache.input  = m_fill_surfaces.surfaces;
+        cache.params = params;
+        // With perimeters, the fill surfaces of two LayerSlices are at least two shell widths apart, thus farther than the expansions
+        // and the closing reach. The surfaces of a large region are then expanded per LayerSlice in parallel.
+        static constexpr const size_t parallel_min_points = 10000;
+        std::vector<Surfaces> groups;
+        if (num_perimeters > 0 && count_points(to_expolygons(m_fill_surfaces.surfaces)) >= parallel_min_points)
+            groups = split_surfaces_by_lslices(*this->layer(), m_fill_surfaces.surfaces);
+        if (groups.size() > 1) {
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, groups.size(), 1), [&groups, &params](const tbb::blocked_range<size_t> &range) {
+                for (size_t group_idx = range.begin(); group_idx < range.end(); ++ group_idx)
+                    groups[group_idx] = expand_external_surfaces(std::move(groups[group_idx]), params);
+            });
+            m_fill_surfaces.clear();
+            for (Surfaces &group : groups)
+                m_fill_surfaces.append(std::move(group));
+        } else
+            m_fill_surfaces.surfaces = expand_external_surfaces(std::move(m_fill_surfaces.surfaces), params);
+        cache.output = m_fill_surfaces.surfaces;
+        cache.valid  = true;
     }
-    m_fill_surfaces.append(std::move(bridges.surfaces));
-    m_fill_surfaces.append(std::move(bottoms));
-    m_fill_surfaces.append(std::move(tops));
 
 #ifdef SLIC3R_DEBUG_SLICE_PROCESSING
     export_region_fill_surfaces_to_svg_debug("4_process_external_surfaces-final");
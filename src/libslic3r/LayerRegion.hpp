@@ -32,6 +32,10 @@ class PrintRegion;
 struct PerimeterRegion;
 using PerimeterRegions = std::vector<PerimeterRegion>;
 
+namespace PerimeterGenerator {
+    class ArachneWallsCache;
+}
+
 // Range of indices, providing support for range based loops.
 template<typename T>
 class IndexRange
@@ -70,6 +74,27 @@ template class IndexRange<uint32_t>;
 using ExtrusionRange = IndexRange<uint32_t>;
 using ExPolygonRange = IndexRange<uint32_t>;
 
+// Parameters of the expansion of the top / bottom / bridge surfaces into the solid and sparse infill of a LayerRegion.
+struct ExternalSurfacesParams
+{
+    // Scaled expansion of the external surfaces into the sparse infill.
+    float   expansion_min           { 0 };
+    // Scaled expansions of the respective external surfaces into the solid infill.
+    float   expansion_top           { 0 };
+    float   expansion_bottom        { 0 };
+    float   expansion_bottom_bridge { 0 };
+    // Radius (with added epsilon) to absorb empty regions emerging from the regularization of ensuring.
+    float   closing_radius          { 0 };
+    // Bridge angle configured by the user in degrees, zero for automatic detection of the bridging direction.
+    double  custom_bridge_angle     { 0 };
+
+    bool operator==(const ExternalSurfacesParams &rhs) const {
+        return this->expansion_min == rhs.expansion_min && this->expansion_top == rhs.expansion_top &&
+               this->expansion_bottom == rhs.expansion_bottom && this->expansion_bottom_bridge == rhs.expansion_bottom_bridge &&
+               this->closing_radius == rhs.closing_radius && this->custom_bridge_angle == rhs.custom_bridge_angle;
+    }
+};
+
 class LayerRegion
 {
 public:
@@ -130,7 +155,11 @@ public:
         // All fill areas produced for all input slices above.
         ExPolygons                                             &fill_expolygons,
         // Ranges of fill areas above per input slice.
-        std::vector<ExPolygonRange>                            &fill_expolygons_ranges);
+        std::vector<ExPolygonRange>                            &fill_expolygons_ranges,
+        // Optional cache of the Arachne walls shared by the layers of the object.
+        PerimeterGenerator::ArachneWallsCache                  *arachne_walls_cache = nullptr,
+        // Optional cancellation callback.
+        const std::function<void()>                            &throw_on_cancel = nullptr);
     void    process_external_surfaces(const Layer *lower_layer, const Polygons *lower_layer_covered);
     double  infill_area_threshold() const;
     // Trim surfaces by trimming polygons. Used by the elephant foot compensation at the 1st layer.
@@ -150,7 +179,9 @@ public:
 
 protected:
     friend class Layer;
+    friend class LayerSpill;
     friend class PrintObject;
+    friend size_t memory_used(const LayerRegion &layerm);
 
     LayerRegion(Layer *layer, const PrintRegion *region) : m_layer(layer), m_region(region) {}
     ~LayerRegion() = default;
@@ -191,6 +222,16 @@ private:
     // Collection of surfaces for infill generation, created by splitting m_slices by m_fill_expolygons.
     SurfaceCollection           m_fill_surfaces;
 
+    // Input fill surfaces and parameters of the last process_external_surfaces() call together with its result.
+    // The expansion of the external surfaces is skipped if posPrepareInfill is invalidated without changing its input.
+    struct ExternalSurfacesCache {
+        bool                    valid { false };
+        Surfaces                input;
+        ExternalSurfacesParams  params;
+        Surfaces                output;
+    };
+    ExternalSurfacesCache       m_external_surfaces_cache;
+
     // Collection of extrusion paths/loops filling gaps
     // These fills are generated by the perimeter generator.
     // They are not printed on their own, but they are copied to this->fills during infill generation.
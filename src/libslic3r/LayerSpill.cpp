@@ -0,0 +1,247 @@
+#include "LayerSpill.hpp"
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <boost/log/trivial.hpp>
+#include <cstring>
+#include <type_traits>
+
+#include "libslic3r/Exception.hpp"
+#include "libslic3r/ExtrusionEntity.hpp"
+#include "libslic3r/ExtrusionEntityCollection.hpp"
+#include "libslic3r/Layer.hpp"
+
+namespace Slic3r {
+
+// Type tags of the serialized ExtrusionEntities.
+enum class SpilledEntity : uint8_t {
+    Path,
+    PathOriented,
+    MultiPath,
+    Loop,
+    Collection
+};
+
+// The scratch file is read by the same process that wrote it, thus the plain old data is stored in its in-memory representation.
+static_assert(std::is_trivially_copyable_v<ExtrusionAttributes>);
+static_assert(sizeof(Point) == 2 * sizeof(coord_t));
+
+template<typename T>
+static void write_pod(std::string &out, const T &value)
+{
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+static void write_path(std::string &out, const ExtrusionPath &path)
+{
+    write_pod(out, path.attributes());
+    write_pod(out, uint64_t(path.polyline.size()));
+    out.append(reinterpret_cast<const char*>(path.polyline.points.data()), path.polyline.size() * sizeof(Point));
+}
+
+static void write_paths(std::string &out, const ExtrusionPaths &paths)
+{
+    write_pod(out, uint64_t(paths.size()));
+    for (const ExtrusionPath &path : paths)
+        write_path(out, path);
+}
+
+static void write_collection(std::string &out, const ExtrusionEntityCollection &collection);
+
+static void write_entity(std::string &out, const ExtrusionEntity &entity)
+{
+    if (auto *collection = dynamic_cast<const ExtrusionEntityCollection*>(&entity)) {
+        write_pod(out, SpilledEntity::Collection);
+        write_collection(out, *collection);
+    } else if (auto *loop = dynamic_cast<const ExtrusionLoop*>(&entity)) {
+        write_pod(out, SpilledEntity::Loop);
+        write_pod(out, loop->loop_role());
+        write_paths(out, loop->paths);
+    } else if (auto *multipath = dynamic_cast<const ExtrusionMultiPath*>(&entity)) {
+        write_pod(out, SpilledEntity::MultiPath);
+        write_paths(out, multipath->paths);
+    } else if (auto *path = dynamic_cast<const ExtrusionPathOriented*>(&entity)) {
+        write_pod(out, SpilledEntity::PathOriented);
+        write_path(out, *path);
+    } else if (auto *path = dynamic_cast<const ExtrusionPath*>(&entity)) {
+        write_pod(out, SpilledEntity::Path);
+        write_path(out, *path);
+    } else
+        throw Slic3r::LogicError("LayerSpill: Unknown ExtrusionEntity type");
+}
+
+static void write_collection(std::string &out, const ExtrusionEntityCollection &collection)
+{
+    write_pod(out, collection.no_sort);
+    write_pod(out, uint64_t(collection.entities.size()));
+    for (const ExtrusionEntity *entity : collection.entities)
+        write_entity(out, *entity);
+}
+
+class SpillReader
+{
+public:
+    SpillReader(const char *begin, const char *end) : m_ptr(begin), m_end(end) {}
+
+    template<typename T>
+    T pod() {
+        if (m_ptr + sizeof(T) > m_end)
+            throw Slic3r::RuntimeError("LayerSpill: Truncated scratch file");
+        T value;
+        std::memcpy(&value, m_ptr, sizeof(T));
+        m_ptr += sizeof(T);
+        return value;
+    }
+
+    template<typename PathType>
+    PathType path() {
+        const auto attributes = this->pod<ExtrusionAttributes>();
+        const auto num_points = size_t(this->pod<uint64_t>());
+        if (m_ptr + num_points * sizeof(Point) > m_end)
+            throw Slic3r::RuntimeError("LayerSpill: Truncated scratch file");
+        Polyline polyline;
+        polyline.points.resize(num_points);
+        std::memcpy(reinterpret_cast<char*>(polyline.points.data()), m_ptr, num_points * sizeof(Point));
+        m_ptr += num_points * sizeof(Point);
+        return PathType(std::move(polyline), attributes);
+    }
+
+    ExtrusionPaths paths() {
+        ExtrusionPaths out;
+        const auto num_paths = size_t(this->pod<uint64_t>());
+        out.reserve(num_paths);
+        for (size_t i = 0; i < num_paths; ++ i)
+            out.emplace_back(this->path<ExtrusionPath>());
+        return out;
+    }
+
+    ExtrusionEntity* entity() {
+        switch (this->pod<SpilledEntity>()) {
+        case SpilledEntity::Path:         return new ExtrusionPath(this->path<ExtrusionPath>());
+        case SpilledEntity::PathOriented: return new ExtrusionPathOriented(this->path<ExtrusionPathOriented>());
+        case SpilledEntity::MultiPath:    return new ExtrusionMultiPath(this->paths());
+        case SpilledEntity::Loop: {
+            const auto role = this->pod<ExtrusionLoopRole>();
+            return new ExtrusionLoop(this->paths(), role);
+        }
+        case SpilledEntity::Collection: {
+            auto *collection = new ExtrusionEntityCollection();
+            this->collection(*collection);
+            return collection;
+        }
+        }
+        throw Slic3r::RuntimeError("LayerSpill: Corrupted scratch file");
+    }
+
+    void collection(ExtrusionEntityCollection &out) {
+        out.clear();
+        out.no_sort = this->pod<bool>();
+        const auto num_entities = size_t(this->pod<uint64_t>());
+        out.entities.reserve(num_entities);
+        for (size_t i = 0; i < num_entities; ++ i)
+            out.entities.emplace_back(this->entity());
+    }
+
+    bool at_end() const { return m_ptr == m_end; }
+
+private:
+    const char *m_ptr;
+    const char *m_end;
+};
+
+LayerSpill::LayerSpill()
+{
+    m_path = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("layers-%%%%-%%%%-%%%%.tmp")).string();
+    m_file.open(m_path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (! m_file)
+        throw Slic3r::FileIOError("Failed creating the scratch file " + m_path);
+}
+
+LayerSpill::~LayerSpill()
+{
+    m_mapping.reset();
+    if (m_file.is_open())
+        m_file.close();
+    boost::system::error_code ec;
+    boost::filesystem::remove(m_path, ec);
+    if (ec)
+        BOOST_LOG_TRIVIAL(warning) << "LayerSpill: failed removing " << m_path << ": " << ec.message();
+}
+
+void LayerSpill::spill(const Layer &layer)
+{
+    // Serialize outside of the lock, only the append to the scratch file is serialized.
+    std::string data;
+    write_pod(data, uint64_t(layer.regions().size()));
+    for (const LayerRegion *layerm : layer.regions()) {
+        write_collection(data, layerm->perimeters());
+        write_collection(data, layerm->thin_fills());
+        write_collection(data, layerm->fills());
+    }
+    const auto *support_layer = dynamic_cast<const SupportLayer*>(&layer);
+    write_pod(data, support_layer != nullptr);
+    if (support_layer)
+        write_collection(data, support_layer->support_fills);
+
+    {
+        std::scoped_lock<std::mutex> lock(m_mutex);
+        assert(! m_mapping);
+        assert(m_records.find(&layer) == m_records.end());
+        m_file.write(data.data(), data.size());
+        if (! m_file)
+            throw Slic3r::FileIOError("Failed writing the scratch file " + m_path);
+        m_records.insert({ &layer, Record{ m_size, data.size() } });
+        m_size += data.size();
+    }
+
+    // The layer is owned by its PrintObject, the caller is responsible for not accessing the extrusions until restored.
+    auto &layer_mutable = const_cast<Layer&>(layer);
+    for (LayerRegion *layerm : layer_mutable.regions()) {
+        layerm->m_perimeters.clear();
+        layerm->m_thin_fills.clear();
+        layerm->m_fills.clear();
+    }
+    if (support_layer)
+        const_cast<SupportLayer*>(support_layer)->support_fills.clear();
+    // The smooth paths reference the released extrusions.
+    layer.smooth_path_cache.reset();
+}
+
+void LayerSpill::finalize()
+{
+    m_file.close();
+    if (m_file.fail())
+        throw Slic3r::FileIOError("Failed writing the scratch file " + m_path);
+    if (m_size > 0) {
+        m_mapping = std::make_unique<boost::iostreams::mapped_file_source>();
+        m_mapping->open(m_path);
+        if (! m_mapping->is_open())
+            throw Slic3r::FileIOError("Failed mapping the scratch file " + m_path);
+    }
+    BOOST_LOG_TRIVIAL(debug) << "LayerSpill: spilled " << m_records.size() << " layers, " << m_size << " bytes into " << m_path;
+}
+
+void LayerSpill::restore(const Layer &layer)
+{
+    auto it = m_records.find(&layer);
+    if (it == m_records.end() || it->second.restored)
+        return;
+    assert(m_mapping);
+    const char *begin = m_mapping->data() + it->second.offset;
+    SpillReader reader(begin, begin + it->second.size);
+    auto &layer_mutable = const_cast<Layer&>(layer);
+    if (reader.pod<uint64_t>() != layer.regions().size())
+        throw Slic3r::RuntimeError("LayerSpill: Corrupted scratch file");
+    for (LayerRegion *layerm : layer_mutable.regions()) {
+        reader.collection(layerm->m_perimeters);
+        reader.collection(layerm->m_thin_fills);
+        reader.collection(layerm->m_fills);
+    }
+    if (reader.pod<bool>())
+        reader.collection(static_cast<SupportLayer&>(layer_mutable).support_fills);
+    assert(reader.at_end());
+    it->second.restored = true;
+}
+
+} // namespace Slic3r
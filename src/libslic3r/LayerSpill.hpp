@@ -0,0 +1,57 @@
+#ifndef slic3r_LayerSpill_hpp_
+#define slic3r_LayerSpill_hpp_
+
+#include <boost/nowide/fstream.hpp>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace boost { namespace iostreams { class mapped_file_source; } }
+
+namespace Slic3r {
+
+class Layer;
+
+// Out of core storage of the extrusions of finished layers.
+// The perimeter, gap fill, infill, ironing and support extrusions of a layer are serialized into a scratch file
+// and released from memory by spill(). Once all layers are spilled, the scratch file is memory mapped by finalize()
+// and restore() loads the extrusions of a single layer back. The slices, fill surfaces and the LayerIsland ranges
+// referencing the extrusions are kept in memory, thus a restored layer is indistinguishable from the spilled one.
+// spill() and restore() may be called concurrently for different layers. The scratch file is deleted by the destructor.
+class LayerSpill
+{
+public:
+    LayerSpill();
+    ~LayerSpill();
+    LayerSpill(const LayerSpill &) = delete;
+    LayerSpill& operator=(const LayerSpill &) = delete;
+
+    void spill(const Layer &layer);
+    // Map the scratch file for reading, no layer may be spilled after finalize().
+    void finalize();
+    // Load the extrusions of a layer back into memory. Restoring a layer that was not spilled or that was already restored is a no-op.
+    void restore(const Layer &layer);
+
+    size_t num_layers() const { return m_records.size(); }
+    size_t size_on_disk() const { return m_size; }
+
+private:
+    struct Record {
+        uint64_t offset;
+        uint64_t size;
+        bool     restored { false };
+    };
+
+    std::string                                          m_path;
+    boost::nowide::ofstream                              m_file;
+    std::unique_ptr<boost::iostreams::mapped_file_source> m_mapping;
+    std::mutex                                           m_mutex;
+    std::unordered_map<const Layer*, Record>             m_records;
+    uint64_t                                             m_size { 0 };
+};
+
+} // namespace Slic3r
+
+#endif // slic3r_LayerSpill_hpp_
@@ -74,7 +74,7 @@ template<class T> TRasterValue<T> isoval(const T &rst, const Coord &crd)
 template<class ExecutionPolicy, class It, class Fn>
 void for_each(ExecutionPolicy&& policy, It from, It to, Fn &&fn)
 {
-    _Loop<ExecutionPolicy>::for_each(from, to, fn);
+    _Loop<std::decay_t<ExecutionPolicy>>::for_each(from, to, fn);
 }
 
 // Type of squares (tiles) depending on which vertices are inside an ROI
@@ -159,25 +159,40 @@ template<class Rst> class Grid {
     Coord tr(const Coord &crd) const { return tl(crd) + Coord{0, m_res_1.c}; }
     Coord tl(const Coord &crd) const { return rastercoord(crd); }
     
-    bool is_within(const Coord &crd)
+    // Calculate the tags for a row of cells (or squares). The cell coordinates
+    // mark the top left vertex of a square in the raster. v is the isovalue.
+    // The bounds of the raster rows are checked once per row and a raster
+    // column shared by two neighboring squares is only read once.
+    void tag_row(long r, TRasterValue<Rst> v)
     {
-        long R = rows(*m_rst), C = cols(*m_rst);
-        return crd.r >= 0 && crd.r < R && crd.c >= 0 && crd.c < C;
-    };
+        const long R = rows(*m_rst), C = cols(*m_rst);
+        const long top = tl({r, 0}).r, bottom = bl({r, 0}).r;
+        const bool top_within = top >= 0 && top < R;
+        const bool bottom_within = bottom >= 0 && bottom < R;
 
-    // Calculate the tag for a cell (or square). The cell coordinates mark the
-    // top left vertex of a square in the raster. v is the isovalue
-    uint8_t get_tag_for_cell(const Coord &cell, TRasterValue<Rst> v)
-    {        
-        Coord sqr[] = {bl(cell), br(cell), tr(cell), tl(cell)};
-        
-        uint8_t t = ((is_within(sqr[0]) && isoval(*m_rst, sqr[0]) >= v)) +
-                    ((is_within(sqr[1]) && isoval(*m_rst, sqr[1]) >= v) << 1) +
-                    ((is_within(sqr[2]) && isoval(*m_rst, sqr[2]) >= v) << 2) +
-                    ((is_within(sqr[3]) && isoval(*m_rst, sqr[3]) >= v) << 3);
-        
-        assert(t < 16);
-        return t;
+        auto is_inside = [this, v, C](bool row_within, long row, long col) -> uint8_t {
+            return row_within && col >= 0 && col < C && isoval(*m_rst, {row, col}) >= v;
+        };
+
+        uint8_t *tags = m_tags.data() + seq({r, 0});
+        // Left column of the previous square, shared with the right column of the current one if the windows overlap.
+        long     prev_right = -1;
+        uint8_t  prev_right_bits = 0;
+        for (long c = 0; c < m_gridsize.c; ++c) {
+            const long left = tl({r, c}).c, right = tr({r, c}).c;
+            const uint8_t left_bits = left == prev_right ?
+                prev_right_bits :
+                uint8_t(is_inside(bottom_within, bottom, left) | (is_inside(top_within, top, left) << 1));
+            const uint8_t right_bits = is_inside(bottom_within, bottom, right) | (is_inside(top_within, top, right) << 1);
+
+            // a: bottom left, b: bottom right, c: top right, d: top left
+            uint8_t t = (left_bits & 1) | ((right_bits & 1) << 1) | ((right_bits & 2) << 1) | ((left_bits & 2) << 2);
+            assert(t < 16);
+            tags[c] = t;
+
+            prev_right      = right;
+            prev_right_bits = right_bits;
+        }
     }
     
     // Get a cell coordinate from a sequential index
@@ -345,12 +360,14 @@ public:
     // Go through the cells and mark them with the appropriate tag.
     template<class ExecutionPolicy>
     void tag_grid(ExecutionPolicy &&policy, TRasterValue<Rst> isoval)
-    {        
+    {
         // parallel for r
+        std::vector<long> gridrows(m_gridsize.r);
+        for (long r = 0; r < m_gridsize.r; ++r) gridrows[r] = r;
         for_each (std::forward<ExecutionPolicy>(policy),
-                 m_tags.begin(), m_tags.end(),
-                 [this, isoval](uint8_t& tag, size_t idx) {
-            tag = get_tag_for_cell(coord(idx), isoval);
+                 gridrows.begin(), gridrows.end(),
+                 [this, isoval](long r, size_t) {
+            tag_row(r, isoval);
         });
     }
     
@@ -121,8 +121,12 @@ void MeasuringImpl::update_planes()
     // This part is still performed in mesh coordinate system.
     const size_t             num_of_facets = m_its.indices.size();
     m_face_to_plane.resize(num_of_facets, size_t(-1));
-    const std::vector<Vec3f> face_normals = its_face_normals(m_its);
-    const std::vector<Vec3i> face_neighbors = its_face_neighbors(m_its);
+    std::vector<Vec3f>       face_normals(num_of_facets);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_of_facets), [this, &face_normals](const tbb::blocked_range<size_t>& range) {
+        for (size_t facet_idx = range.begin(); facet_idx != range.end(); ++ facet_idx)
+            face_normals[facet_idx] = its_face_normal(m_its, int(facet_idx));
+    });
+    const std::vector<Vec3i> face_neighbors = its_face_neighbors_par(m_its);
     std::vector<int>         facet_queue(num_of_facets, 0);
     int                      facet_queue_cnt = 0;
     const stl_normal*        normal_ptr      = nullptr;
@@ -0,0 +1,173 @@
+#include "MemoryUsage.hpp"
+
+#include "libslic3r/ExtrusionEntity.hpp"
+#include "libslic3r/ExtrusionEntityCollection.hpp"
+#include "libslic3r/GCode/GCodeProcessor.hpp"
+#include "libslic3r/Layer.hpp"
+#include "libslic3r/Print.hpp"
+#include "libslic3r/SLAPrint.hpp"
+#include "libslic3r/Trace.hpp"
+#include "libslic3r/Utils.hpp"
+
+namespace Slic3r {
+
+template<typename T, typename Alloc>
+static inline size_t vector_memory(const std::vector<T, Alloc> &v)
+{
+    return v.capacity() * sizeof(T);
+}
+
+size_t memory_used(const Points &points)
+{
+    return vector_memory(points);
+}
+
+size_t memory_used(const Polygons &polygons)
+{
+    size_t out = vector_memory(polygons);
+    for (const Polygon &polygon : polygons)
+        out += memory_used(polygon.points);
+    return out;
+}
+
+size_t memory_used(const ExPolygons &expolygons)
+{
+    size_t out = vector_memory(expolygons);
+    for (const ExPolygon &expolygon : expolygons)
+        out += memory_used(expolygon.contour.points) + memory_used(expolygon.holes);
+    return out;
+}
+
+size_t memory_used(const Polylines &polylines)
+{
+    size_t out = vector_memory(polylines);
+    for (const Polyline &polyline : polylines)
+        out += memory_used(polyline.points);
+    return out;
+}
+
+size_t memory_used(const Surfaces &surfaces)
+{
+    size_t out = vector_memory(surfaces);
+    for (const Surface &surface : surfaces)
+        out += memory_used(surface.expolygon.contour.points) + memory_used(surface.expolygon.holes);
+    return out;
+}
+
+static size_t memory_used(const ExtrusionPaths &paths)
+{
+    size_t out = vector_memory(paths);
+    for (const ExtrusionPath &path : paths)
+        out += memory_used(path.polyline.points);
+    return out;
+}
+
+static size_t memory_used(const ExtrusionEntity &entity)
+{
+    if (auto *collection = dynamic_cast<const ExtrusionEntityCollection*>(&entity))
+        return sizeof(ExtrusionEntityCollection) + memory_used(*collection);
+    if (auto *loop = dynamic_cast<const ExtrusionLoop*>(&entity))
+        return sizeof(ExtrusionLoop) + memory_used(loop->paths);
+    if (auto *multipath = dynamic_cast<const ExtrusionMultiPath*>(&entity))
+        return sizeof(ExtrusionMultiPath) + memory_used(multipath->paths);
+    if (auto *path = dynamic_cast<const ExtrusionPath*>(&entity))
+        // Also covers ExtrusionPathOriented, which adds no data.
+        return sizeof(ExtrusionPath) + memory_used(path->polyline.points);
+    return sizeof(ExtrusionEntity);
+}
+
+size_t memory_used(const ExtrusionEntityCollection &collection)
+{
+    size_t out = vector_memory(collection.entities);
+    for (const ExtrusionEntity *entity : collection.entities)
+        out += memory_used(*entity);
+    return out;
+}
+
+size_t memory_used(const LayerRegion &layerm)
+{
+    return sizeof(LayerRegion) +
+        memory_used(layerm.m_raw_slices) +
+        memory_used(layerm.slices().surfaces) +
+        memory_used(layerm.fill_expolygons()) + vector_memory(layerm.fill_expolygons_bboxes()) +
+        memory_used(layerm.fill_expolygons_composite()) + vector_memory(layerm.fill_expolygons_composite_bboxes()) +
+        memory_used(layerm.fill_surfaces().surfaces) +
+        memory_used(layerm.m_external_surfaces_cache.input) + memory_used(layerm.m_external_surfaces_cache.output) +
+        memory_used(layerm.thin_fills()) +
+        memory_used(layerm.unsupported_bridge_edges()) +
+        memory_used(layerm.perimeters()) +
+        memory_used(layerm.fills());
+}
+
+size_t memory_used(const Layer &layer)
+{
+    size_t out = sizeof(Layer) +
+        memory_used(layer.lslices) +
+        vector_memory(layer.lslice_indices_sorted_by_print_order) +
+        vector_memory(layer.lslices_ex);
+    for (const LayerSlice &lslice : layer.lslices_ex)
+        for (const LayerIsland &island : lslice.islands)
+            out += memory_used(island.boundary.contour.points) + memory_used(island.boundary.holes);
+    for (const LayerRegion *layerm : layer.regions())
+        out += memory_used(*layerm);
+    if (auto *support_layer = dynamic_cast<const SupportLayer*>(&layer))
+        out += sizeof(SupportLayer) - sizeof(Layer) +
+            memory_used(support_layer->support_islands) +
+            vector_memory(support_layer->support_islands_bboxes) +
+            memory_used(support_layer->support_fills);
+    return out;
+}
+
+size_t memory_used(const PrintObject &object)
+{
+    size_t out = 0;
+    for (const Layer *layer : object.layers())
+        out += memory_used(*layer);
+    for (const SupportLayer *layer : object.support_layers())
+        out += memory_used(*layer);
+    return out;
+}
+
+size_t memory_used(const GCodeProcessorResult &result)
+{
+    size_t out = vector_memory(result.moves) + vector_memory(result.lines_ends);
+    for (const std::vector<size_t> &lines_ends : result.lines_ends)
+        out += vector_memory(lines_ends);
+    return out;
+}
+
+static void trace_process_memory()
+{
+    Trace::counter("Resident memory", "Memory", -1, int64_t(process_resident_memory()));
+    Trace::counter("Peak memory", "Memory", -1, int64_t(process_peak_memory()));
+}
+
+void trace_memory_usage(const Print &print)
+{
+    if (! Trace::enabled())
+        return;
+    trace_process_memory();
+    for (const PrintObject *object : print.objects())
+        Trace::counter("Object layers", "Memory", object->id().id, int64_t(memory_used(*object)));
+}
+
+void trace_memory_usage(const SLAPrint &print)
+{
+    if (! Trace::enabled())
+        return;
+    trace_process_memory();
+    for (const SLAPrintObject *object : print.objects()) {
+        size_t slices = vector_memory(object->get_model_slices()) + vector_memory(object->get_support_slices());
+        for (const ExPolygons &expolygons : object->get_model_slices())
+            slices += memory_used(expolygons);
+        for (const ExPolygons &expolygons : object->get_support_slices())
+            slices += memory_used(expolygons);
+        Trace::counter("Object slices", "Memory", object->id().id, int64_t(slices));
+    }
+    size_t print_layers = 0;
+    for (const SLAPrint::PrintLayer &layer : print.print_layers())
+        print_layers += memory_used(layer.transformed_slices());
+    Trace::counter("Print layers", "Memory", -1, int64_t(print_layers));
+}
+
+} // namespace Slic3r
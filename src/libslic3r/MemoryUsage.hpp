@@ -0,0 +1,44 @@
+#ifndef slic3r_MemoryUsage_hpp_
+#define slic3r_MemoryUsage_hpp_
+
+#include <cstddef>
+
+#include "libslic3r/ExPolygon.hpp"
+#include "libslic3r/Polyline.hpp"
+#include "libslic3r/Surface.hpp"
+
+namespace Slic3r {
+
+class ExtrusionEntityCollection;
+class Layer;
+class LayerRegion;
+class Print;
+class PrintObject;
+class SLAPrint;
+struct GCodeProcessorResult;
+
+// Estimates of the heap memory held by the slicing data structures. The capacity of the containers is accounted for,
+// the allocator overhead is not, thus the estimates are lower bounds of the real memory consumption.
+// Used to find out which step and which data drive the peak memory usage of the slicing process, see trace_memory_usage().
+size_t memory_used(const Points &points);
+size_t memory_used(const Polygons &polygons);
+size_t memory_used(const ExPolygons &expolygons);
+size_t memory_used(const Polylines &polylines);
+size_t memory_used(const Surfaces &surfaces);
+size_t memory_used(const ExtrusionEntityCollection &collection);
+size_t memory_used(const LayerRegion &layerm);
+// Including the LayerRegions and the support extrusions of a SupportLayer.
+size_t memory_used(const Layer &layer);
+// Layers and support layers of a PrintObject.
+size_t memory_used(const PrintObject &object);
+size_t memory_used(const GCodeProcessorResult &result);
+
+// If tracing is enabled, sample the resident and the peak memory of the process and the estimated memory
+// of the layers of each object as counters into the trace, see Trace::counter(). Called by Print::process()
+// and SLAPrint::process() once a step finished, thus the counters are displayed along the step spans.
+void trace_memory_usage(const Print &print);
+void trace_memory_usage(const SLAPrint &print);
+
+} // namespace Slic3r
+
+#endif // slic3r_MemoryUsage_hpp_
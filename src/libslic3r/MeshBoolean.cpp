@@ -328,11 +328,107 @@ bool empty(const CGALMesh &mesh)
     return mesh.m.is_empty();
 }
 
+size_t num_faces(const CGALMesh &mesh)
+{
+    return mesh.m.number_of_faces();
+}
+
 CGALMeshPtr clone(const CGALMesh &m)
 {
     return CGALMeshPtr{new CGALMesh{m}};
 }
 
+CGALMeshCache &CGALMeshCache::global()
+{
+    static CGALMeshCache cache;
+    return cache;
+}
+
+CGALMeshPtr CGALMeshCache::find(const CGALMeshKey &key)
+{
+    std::lock_guard lk{m_mutex};
+
+    auto it = m_meshes.find(key);
+    if (it == m_meshes.end())
+        return nullptr;
+
+    it->second.last_use = ++m_use_counter;
+
+    return clone(*it->second.mesh);
+}
+
+void CGALMeshCache::insert(const CGALMeshKey &key, const CGALMesh &mesh)
+{
+    size_t faces = num_faces(mesh);
+    if (faces > m_max_faces)
+        return;
+
+    CGALMeshPtr copy = clone(mesh);
+
+    std::lock_guard lk{m_mutex};
+
+    auto [it, inserted] = m_meshes.try_emplace(key);
+    if (!inserted)
+        m_faces -= it->second.faces;
+
+    it->second = Entry{std::move(copy), faces, ++m_use_counter};
+    m_faces += faces;
+
+    evict();
+}
+
+std::optional<bool> CGALMeshCache::find_validity(const CGALMeshKey &key)
+{
+    std::lock_guard lk{m_mutex};
+
+    auto it = m_validity.find(key);
+    if (it == m_validity.end())
+        return {};
+
+    return it->second;
+}
+
+void CGALMeshCache::insert_validity(const CGALMeshKey &key, bool valid)
+{
+    // The verdicts are cheap to store, only keep their count bounded.
+    static constexpr size_t MaxVerdicts = 4096;
+
+    std::lock_guard lk{m_mutex};
+
+    if (m_validity.size() >= MaxVerdicts)
+        m_validity.clear();
+
+    m_validity[key] = valid;
+}
+
+void CGALMeshCache::clear()
+{
+    std::lock_guard lk{m_mutex};
+
+    m_meshes.clear();
+    m_validity.clear();
+    m_faces = 0;
+}
+
+size_t CGALMeshCache::size() const
+{
+    std::lock_guard lk{m_mutex};
+
+    return m_meshes.size();
+}
+
+void CGALMeshCache::evict()
+{
+    while (m_faces > m_max_faces && !m_meshes.empty()) {
+        auto lru = std::min_element(m_meshes.begin(), m_meshes.end(),
+                                    [](const auto &a, const auto &b) {
+                                        return a.second.last_use < b.second.last_use;
+                                    });
+        m_faces -= lru->second.faces;
+        m_meshes.erase(lru);
+    }
+}
+
 } // namespace cgal
 
 } // namespace MeshBoolean
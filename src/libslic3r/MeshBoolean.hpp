@@ -11,6 +11,9 @@
 #include <Eigen/Geometry>
 #include <utility>
 #include <vector>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
 
 #include "admesh/stl.h"
 #include "libslic3r/Point.hpp"
@@ -73,6 +76,59 @@ bool does_self_intersect(const CGALMesh &mesh);
 
 bool does_bound_a_volume(const CGALMesh &mesh);
 bool empty(const CGALMesh &mesh);
+size_t num_faces(const CGALMesh &mesh);
+
+// Identifies a mesh, or the result of a sequence of boolean operations, by a
+// hash of the input data.
+struct CGALMeshKey
+{
+    size_t hash     = 0;
+    size_t vertices = 0;
+    size_t faces    = 0;
+
+    bool operator==(const CGALMeshKey &other) const
+    {
+        return hash == other.hash && vertices == other.vertices && faces == other.faces;
+    }
+};
+
+// Thread safe cache of meshes converted to CGAL and of results of mesh booleans,
+// so that a repeated evaluation of a CSG collection (e.g. the preview of negative
+// volumes while one of them is dragged) does not recalculate what did not change.
+// The least recently used meshes are evicted when the faces of all cached meshes
+// exceed the capacity.
+class CGALMeshCache
+{
+public:
+    explicit CGALMeshCache(size_t max_faces = 2000000) : m_max_faces{max_faces} {}
+
+    // The cache shared by the CSG processing in PerformCSGMeshBooleans.hpp
+    static CGALMeshCache &global();
+
+    // Returns a copy of the cached mesh, nullptr if it is not cached.
+    CGALMeshPtr find(const CGALMeshKey &key);
+    void insert(const CGALMeshKey &key, const CGALMesh &mesh);
+
+    // Whether the mesh is known to be eligible for booleans.
+    std::optional<bool> find_validity(const CGALMeshKey &key);
+    void insert_validity(const CGALMeshKey &key, bool valid);
+
+    void clear();
+    size_t size() const;
+
+private:
+    struct KeyHash { size_t operator()(const CGALMeshKey &key) const { return key.hash; } };
+    struct Entry { CGALMeshPtr mesh; size_t faces = 0; size_t last_use = 0; };
+
+    void evict();
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<CGALMeshKey, Entry, KeyHash> m_meshes;
+    std::unordered_map<CGALMeshKey, bool, KeyHash> m_validity;
+    size_t m_max_faces;
+    size_t m_faces = 0;
+    size_t m_use_counter = 0;
+};
 
 }
 
@@ -0,0 +1,99 @@
+#include "MeshCache.hpp"
+
+#include <cassert>
+#include <map>
+#include <mutex>
+
+#include "libslic3r/TriangleMesh.hpp"
+
+namespace Slic3r {
+
+namespace {
+
+struct MeshCacheEntry
+{
+    std::weak_ptr<const TriangleMesh>               mesh;
+    // Guards building of the structures below, so that each of them is built once.
+    std::mutex                                      mutex;
+    std::shared_ptr<const std::vector<Vec3i>>       face_neighbors;
+    std::shared_ptr<const AABBTreeIndirect::Tree3f> aabb_tree;
+};
+
+class MeshCache
+{
+public:
+    std::shared_ptr<MeshCacheEntry> entry(const std::shared_ptr<const TriangleMesh> &mesh)
+    {
+        std::scoped_lock<std::mutex> lock(m_mutex);
+        this->purge();
+        // The entries of the released meshes were purged, thus an entry found belongs to this very mesh
+        // and not to a released one, which happened to be allocated at the same address.
+        std::shared_ptr<MeshCacheEntry> &entry = m_entries[mesh.get()];
+        if (! entry) {
+            entry = std::make_shared<MeshCacheEntry>();
+            entry->mesh = mesh;
+        }
+        return entry;
+    }
+
+    size_t size()
+    {
+        std::scoped_lock<std::mutex> lock(m_mutex);
+        this->purge();
+        return m_entries.size();
+    }
+
+private:
+    // Release the structures of the released meshes. There are just a few meshes referenced, one per ModelVolume.
+    void purge()
+    {
+        for (auto it = m_entries.begin(); it != m_entries.end();)
+            if (it->second->mesh.expired())
+                it = m_entries.erase(it);
+            else
+                ++ it;
+    }
+
+    std::mutex                                                    m_mutex;
+    std::map<const TriangleMesh*, std::shared_ptr<MeshCacheEntry>> m_entries;
+};
+
+MeshCache& mesh_cache()
+{
+    static MeshCache cache;
+    return cache;
+}
+
+// Build the structure outside of the lock of the whole cache, blocking just the users of the same mesh.
+template<typename T, typename Build>
+std::shared_ptr<const T> cached(const std::shared_ptr<const TriangleMesh> &mesh, std::shared_ptr<const T> MeshCacheEntry::*member, Build build)
+{
+    assert(mesh);
+    std::shared_ptr<MeshCacheEntry> entry = mesh_cache().entry(mesh);
+    std::scoped_lock<std::mutex>    lock(entry->mutex);
+    std::shared_ptr<const T>       &out = (*entry).*member;
+    if (! out)
+        out = std::make_shared<T>(build(mesh->its));
+    return out;
+}
+
+} // namespace
+
+std::shared_ptr<const std::vector<Vec3i>> cached_face_neighbors(const std::shared_ptr<const TriangleMesh> &mesh)
+{
+    return cached(mesh, &MeshCacheEntry::face_neighbors, [](const indexed_triangle_set &its) { return its_face_neighbors(its); });
+}
+
+std::shared_ptr<const AABBTreeIndirect::Tree3f> cached_aabb_tree(const std::shared_ptr<const TriangleMesh> &mesh)
+{
+    return cached(mesh, &MeshCacheEntry::aabb_tree, [](const indexed_triangle_set &its) {
+        return AABBTreeIndirect::build_aabb_tree_over_indexed_triangle_set(its.vertices, its.indices);
+    });
+}
+
+size_t mesh_cache_size()
+{
+    return mesh_cache().size();
+}
+
+} // namespace Slic3r
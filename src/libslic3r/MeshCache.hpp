@@ -0,0 +1,30 @@
+#ifndef slic3r_MeshCache_hpp_
+#define slic3r_MeshCache_hpp_
+
+#include <memory>
+#include <vector>
+
+#include "libslic3r/AABBTreeIndirect.hpp"
+#include "libslic3r/Point.hpp"
+
+namespace Slic3r {
+
+class TriangleMesh;
+
+// Acceleration structures of the immutable meshes shared between their users, for example of the meshes of ModelVolumes,
+// which are referenced by the painting gizmos, by the raycasters of the 3D scene and by the slicing of the painted facets.
+// Each structure is built lazily at most once per mesh and it is kept until the mesh is released. As a ModelVolume
+// replaces its mesh by a new instance on any modification, a replaced mesh never matches the structures of its predecessor.
+// Thread safe, the structures of different meshes are built in parallel.
+
+// Neighbor face of each face edge or -1, see its_face_neighbors().
+std::shared_ptr<const std::vector<Vec3i>>       cached_face_neighbors(const std::shared_ptr<const TriangleMesh> &mesh);
+// AABB tree over the triangles of the mesh, see AABBTreeIndirect::build_aabb_tree_over_indexed_triangle_set().
+std::shared_ptr<const AABBTreeIndirect::Tree3f> cached_aabb_tree(const std::shared_ptr<const TriangleMesh> &mesh);
+
+// Number of meshes with cached structures, for unit tests.
+size_t mesh_cache_size();
+
+} // namespace Slic3r
+
+#endif // slic3r_MeshCache_hpp_
@@ -5,6 +5,8 @@
 #ifndef MESHSPLITIMPL_HPP
 #define MESHSPLITIMPL_HPP
 
+#include <atomic>
+
 #include "TriangleMesh.hpp"
 #include "Execution/ExecutionTBB.hpp"
 
@@ -13,6 +15,9 @@ namespace Slic3r {
 template<class ExPolicy>
 std::vector<Vec3i> create_face_neighbors_index(ExPolicy &&ex, const indexed_triangle_set &its);
 
+template<class ExPolicy>
+std::vector<int> create_face_patches_index(ExPolicy &&ex, const std::vector<Vec3i> &face_neighbors, size_t &num_patches);
+
 namespace meshsplit_detail {
 
 template<class Its, class Enable = void> struct ItsWithNeighborsIndex_ {
@@ -263,6 +268,69 @@ std::vector<Vec3i> create_face_neighbors_index(ExPolicy &&ex, const indexed_tria
     return neighbors;
 }
 
+// Index of the connected patch of each face, calculated by a lock-free union-find over the face neighbors.
+// The patches are numbered by their first face, thus the same way as its_split() discovers them one by one.
+template<class ExPolicy>
+std::vector<int> create_face_patches_index(ExPolicy &&ex, const std::vector<Vec3i> &face_neighbors, size_t &num_patches)
+{
+    num_patches = 0;
+    if (face_neighbors.empty())
+        return {};
+
+    // Each face points to a face of a lower index of the same patch, a root points to itself.
+    // The root of a patch is thus its face of the lowest index.
+    std::vector<std::atomic<int>> parent(face_neighbors.size());
+    execution::for_each(ex, size_t(0), face_neighbors.size(),
+        [&parent](size_t face_idx) { parent[face_idx].store(int(face_idx), std::memory_order_relaxed); },
+        execution::max_concurrency(ex));
+
+    auto find_root = [&parent](int face_idx) {
+        for (;;) {
+            int up = parent[face_idx].load(std::memory_order_relaxed);
+            if (up == face_idx)
+                return face_idx;
+            // Path halving: the grand parent is a valid parent of face_idx even if some other thread modified it meanwhile.
+            int up2 = parent[up].load(std::memory_order_relaxed);
+            if (up2 != up)
+                parent[face_idx].compare_exchange_weak(up, up2, std::memory_order_relaxed);
+            face_idx = up2;
+        }
+    };
+
+    execution::for_each(ex, size_t(0), face_neighbors.size(),
+        [&face_neighbors, &parent, &find_root](size_t face_idx) {
+            for (int neighbor_idx : face_neighbors[face_idx]) {
+                if (neighbor_idx < 0 || neighbor_idx == int(face_idx))
+                    continue;
+                for (int a = int(face_idx), b = neighbor_idx;;) {
+                    a = find_root(a);
+                    b = find_root(b);
+                    if (a == b)
+                        break;
+                    if (a < b)
+                        std::swap(a, b);
+                    // Link the root of the higher index below the root of the lower index. If the root was linked
+                    // by another thread meanwhile, retry from the new roots.
+                    int expected = a;
+                    if (parent[a].compare_exchange_strong(expected, b, std::memory_order_relaxed))
+                        break;
+                }
+            }
+        }, execution::max_concurrency(ex));
+
+    std::vector<int> out(face_neighbors.size());
+    execution::for_each(ex, size_t(0), face_neighbors.size(),
+        [&out, &find_root](size_t face_idx) { out[face_idx] = find_root(int(face_idx)); },
+        execution::max_concurrency(ex));
+
+    // Number the patches in the order of their roots. A root precedes the other faces of its patch,
+    // thus it is already renumbered when they are visited.
+    for (size_t face_idx = 0; face_idx < out.size(); ++ face_idx)
+        out[face_idx] = out[face_idx] == int(face_idx) ? int(num_patches ++) : out[out[face_idx]];
+
+    return out;
+}
+
 } // namespace Slic3r
 
 #endif // MESHSPLITIMPL_HPP
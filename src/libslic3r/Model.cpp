@@ -823,7 +823,7 @@ const BoundingBoxf3& ModelObject::raw_mesh_bounding_box() const
         m_raw_mesh_bounding_box.reset();
         for (const ModelVolume *v : this->volumes)
             if (v->is_model_part())
-                m_raw_mesh_bounding_box.merge(v->mesh().transformed_bounding_box(v->get_matrix()));
+                m_raw_mesh_bounding_box.merge(v->convex_hull_or_mesh().transformed_bounding_box(v->get_matrix()));
     }
     return m_raw_mesh_bounding_box;
 }
@@ -832,7 +832,7 @@ BoundingBoxf3 ModelObject::full_raw_mesh_bounding_box() const
 {
 	BoundingBoxf3 bb;
 	for (const ModelVolume *v : this->volumes)
-		bb.merge(v->mesh().transformed_bounding_box(v->get_matrix()));
+		bb.merge(v->convex_hull_or_mesh().transformed_bounding_box(v->get_matrix()));
 	return bb;
 }
 
@@ -849,7 +849,7 @@ const BoundingBoxf3& ModelObject::raw_bounding_box() const
         const Transform3d inst_matrix = this->instances.front()->get_transformation().get_matrix_no_offset();
         for (const ModelVolume *v : this->volumes)
             if (v->is_model_part())
-                m_raw_bounding_box.merge(v->mesh().transformed_bounding_box(inst_matrix * v->get_matrix()));
+                m_raw_bounding_box.merge(v->convex_hull_or_mesh().transformed_bounding_box(inst_matrix * v->get_matrix()));
     }
 	return m_raw_bounding_box;
 }
@@ -864,7 +864,7 @@ BoundingBoxf3 ModelObject::instance_bounding_box(size_t instance_idx, bool dont_
 
     for (ModelVolume *v : this->volumes) {
         if (v->is_model_part())
-            bb.merge(v->mesh().transformed_bounding_box(inst_matrix * v->get_matrix()));
+            bb.merge(v->convex_hull_or_mesh().transformed_bounding_box(inst_matrix * v->get_matrix()));
     }
     return bb;
 }
@@ -879,8 +879,14 @@ Polygon ModelObject::convex_hull_2d(const Transform3d& trafo_instance) const
     tbb::parallel_for(tbb::blocked_range<size_t>(0, volumes.size()), [&](const tbb::blocked_range<size_t>& range) {
         for (size_t i = range.begin(); i < range.end(); ++i) {
             const ModelVolume* v = volumes[i];
-            if (v->is_model_part())
-                chs.emplace_back(its_convex_hull_2d_above(v->mesh().its, (trafo_instance * v->get_matrix()).cast<float>(), 0.0f));
+            if (v->is_model_part()) {
+                const Transform3d trafo = trafo_instance * v->get_matrix();
+                // Only the part above the print bed is projected. The convex hull of a volume cut by the print bed may be larger
+                // than the convex hull of the cut volume, thus the convex hull replaces the mesh only if the volume is not sinking.
+                const TriangleMesh &hull = v->convex_hull_or_mesh();
+                const bool use_hull = &hull != &v->mesh() && hull.transformed_bounding_box(trafo).min.z() >= 0.;
+                chs.emplace_back(its_convex_hull_2d_above((use_hull ? hull : v->mesh()).its, trafo.cast<float>(), 0.0f));
+            }
         }
     });
 
@@ -1207,7 +1213,12 @@ unsigned int ModelObject::update_instances_print_volume_state(const BuildVolume
             if (vol->is_model_part()) {
                 const Transform3d matrix = model_instance->get_matrix() * vol->get_matrix();
                 int bed = -1;
-                BuildVolume::ObjectState state = build_volume.object_state(vol->mesh().its, matrix.cast<float>(), true /* may be below print bed */, true /*ignore_bottom*/, &bed);
+                // The build volume tests are convex, thus if the convex hull is inside, so is the mesh. Test the usually much smaller hull first.
+                BuildVolume::ObjectState state = BuildVolume::ObjectState::Outside;
+                if (const std::shared_ptr<const TriangleMesh> &hull = vol->get_convex_hull_shared_ptr(); hull && ! hull->empty())
+                    state = build_volume.object_state(hull->its, matrix.cast<float>(), true /* may be below print bed */, true /*ignore_bottom*/, &bed);
+                if (state != BuildVolume::ObjectState::Inside)
+                    state = build_volume.object_state(vol->mesh().its, matrix.cast<float>(), true /* may be below print bed */, true /*ignore_bottom*/, &bed);
                 if (bed_idx == -1) // instance will be assigned to the bed the first volume is assigned to.
                     bed_idx = bed;
                 if (state == BuildVolume::ObjectState::Inside)
@@ -1353,11 +1364,24 @@ bool ModelVolume::is_splittable() const
     return m_is_splittable == 1;
 }
 
+// Make private copies of the mesh and of the convex hull shared with other volumes, before they are modified in place.
+void ModelVolume::detach_shared_mesh()
+{
+    const bool convex_hull_valid = this->is_convex_hull_valid();
+    if (m_mesh && m_mesh.use_count() > 1)
+        m_mesh = std::make_shared<const TriangleMesh>(*m_mesh);
+    if (m_convex_hull && m_convex_hull.use_count() > 1)
+        m_convex_hull = std::make_shared<const TriangleMesh>(*m_convex_hull);
+    if (convex_hull_valid)
+        m_convex_hull_mesh = m_mesh;
+}
+
 void ModelVolume::center_geometry_after_creation(bool update_source_offset)
 {
     Vec3d shift = this->mesh().bounding_box().center();
     if (!shift.isApprox(Vec3d::Zero()))
     {
+        this->detach_shared_mesh();
     	if (m_mesh)
         	const_cast<TriangleMesh*>(m_mesh.get())->translate(-(float)shift(0), -(float)shift(1), -(float)shift(2));
         if (m_convex_hull)
@@ -1372,6 +1396,7 @@ void ModelVolume::center_geometry_after_creation(bool update_source_offset)
 void ModelVolume::calculate_convex_hull()
 {
     m_convex_hull = std::make_shared<TriangleMesh>(this->mesh().convex_hull_3d());
+    m_convex_hull_mesh = m_mesh;
     assert(m_convex_hull.get());
 }
 
@@ -1380,6 +1405,13 @@ const TriangleMesh& ModelVolume::get_convex_hull() const
     return *m_convex_hull.get();
 }
 
+bool ModelVolume::is_convex_hull_valid() const
+{
+    // Compare the owners, not the addresses, see m_convex_hull_mesh.
+    return m_convex_hull && ! m_convex_hull->empty() && m_mesh &&
+        ! m_convex_hull_mesh.owner_before(m_mesh) && ! m_mesh.owner_before(m_convex_hull_mesh);
+}
+
 ModelVolumeType ModelVolume::type_from_string(const std::string &s)
 {
     // Legacy support
@@ -1477,33 +1509,39 @@ void ModelVolume::mirror(Axis axis)
     set_mirror(mirror);
 }
 
-// This method could only be called before the meshes of this ModelVolumes are not shared!
 void ModelVolume::scale_geometry_after_creation(const Vec3f& versor)
 {
+    this->detach_shared_mesh();
 	const_cast<TriangleMesh*>(m_mesh.get())->scale(versor);
 	const_cast<TriangleMesh*>(m_convex_hull.get())->scale(versor);
 }
 
 void ModelVolume::transform_this_mesh(const Transform3d &mesh_trafo, bool fix_left_handed)
 {
+    const bool convex_hull_valid = this->is_convex_hull_valid();
 	TriangleMesh mesh = this->mesh();
 	mesh.transform(mesh_trafo, fix_left_handed);
 	this->set_mesh(std::move(mesh));
     TriangleMesh convex_hull = this->get_convex_hull();
     convex_hull.transform(mesh_trafo, fix_left_handed);
     m_convex_hull = std::make_shared<TriangleMesh>(std::move(convex_hull));
+    if (convex_hull_valid)
+        m_convex_hull_mesh = m_mesh;
     // Let the rest of the application know that the geometry changed, so the meshes have to be reloaded.
     this->set_new_unique_id();
 }
 
 void ModelVolume::transform_this_mesh(const Matrix3d &matrix, bool fix_left_handed)
 {
+    const bool convex_hull_valid = this->is_convex_hull_valid();
 	TriangleMesh mesh = this->mesh();
 	mesh.transform(matrix, fix_left_handed);
 	this->set_mesh(std::move(mesh));
     TriangleMesh convex_hull = this->get_convex_hull();
     convex_hull.transform(matrix, fix_left_handed);
     m_convex_hull = std::make_shared<TriangleMesh>(std::move(convex_hull));
+    if (convex_hull_valid)
+        m_convex_hull_mesh = m_mesh;
     // Let the rest of the application know that the geometry changed, so the meshes have to be reloaded.
     this->set_new_unique_id();
 }
@@ -1548,28 +1586,28 @@ void ModelInstance::transform_polygon(Polygon* polygon) const
 }
 
 indexed_triangle_set FacetsAnnotation::get_facets(const ModelVolume &mv, TriangleStateType type) const {
-    TriangleSelector selector(mv.mesh());
+    TriangleSelector selector(mv.mesh_ptr());
     // Reset of TriangleSelector is done inside TriangleSelector's constructor, so we don't need it to perform it again in deserialize().
     selector.deserialize(m_data, false);
     return selector.get_facets(type);
 }
 
 indexed_triangle_set FacetsAnnotation::get_facets_strict(const ModelVolume &mv, TriangleStateType type) const {
-    TriangleSelector selector(mv.mesh());
+    TriangleSelector selector(mv.mesh_ptr());
     // Reset of TriangleSelector is done inside TriangleSelector's constructor, so we don't need it to perform it again in deserialize().
     selector.deserialize(m_data, false);
     return selector.get_facets_strict(type);
 }
 
 indexed_triangle_set_with_color FacetsAnnotation::get_all_facets_with_colors(const ModelVolume &mv) const {
-    TriangleSelector selector(mv.mesh());
+    TriangleSelector selector(mv.mesh_ptr());
     // Reset of TriangleSelector is done inside TriangleSelector's constructor, so we don't need it to perform it again in deserialize().
     selector.deserialize(m_data, false);
     return selector.get_all_facets_with_colors();
 }
 
 indexed_triangle_set_with_color FacetsAnnotation::get_all_facets_strict_with_colors(const ModelVolume &mv) const {
-    TriangleSelector selector(mv.mesh());
+    TriangleSelector selector(mv.mesh_ptr());
     // Reset of TriangleSelector is done inside TriangleSelector's constructor, so we don't need it to perform it again in deserialize().
     selector.deserialize(m_data, false);
     return selector.get_all_facets_strict_with_colors();
@@ -1608,17 +1646,18 @@ std::string FacetsAnnotation::get_triangle_as_string(int triangle_idx) const
     if (triangle_it != m_data.triangles_to_split.end() && triangle_it->triangle_idx == triangle_idx) {
         int offset = triangle_it->bitstream_start_idx;
         int end    = ++ triangle_it == m_data.triangles_to_split.end() ? int(m_data.bitstream.size()) : triangle_it->bitstream_start_idx;
-        while (offset < end) {
+        assert((end - offset) % 4 == 0);
+        // The first nibble of the bitstream is the last hexadecimal digit, fill the string from its end.
+        out.resize(size_t(end - offset) / 4);
+        for (auto it_digit = out.rbegin(); offset < end; offset += 4, ++ it_digit) {
             int next_code = 0;
             for (int i=3; i>=0; --i) {
                 next_code = next_code << 1;
                 next_code |= int(m_data.bitstream[offset + i]);
             }
-            offset += 4;
 
             assert(next_code >=0 && next_code <= 15);
-            char digit = next_code < 10 ? next_code + '0' : (next_code-10)+'A';
-            out.insert(out.begin(), digit);
+            *it_digit = next_code < 10 ? next_code + '0' : (next_code-10)+'A';
         }
     }
     return out;
@@ -1639,6 +1678,9 @@ void FacetsAnnotation::set_triangle_from_string(int triangle_id, const std::stri
     m_data.triangles_to_split.emplace_back(triangle_id, int(m_data.bitstream.size()));
 
     const size_t bitstream_start_idx = m_data.bitstream.size();
+    // Allocate the bits of all digits at once, then fill them in.
+    m_data.bitstream.resize(bitstream_start_idx + 4 * str.size(), false);
+    size_t bit_idx = bitstream_start_idx;
     for (auto it = str.crbegin(); it != str.crend(); ++it) {
         const char ch = *it;
         int dec = 0;
@@ -1649,9 +1691,9 @@ void FacetsAnnotation::set_triangle_from_string(int triangle_id, const std::stri
         else
             assert(false);
 
-        // Convert to binary and append into code.
+        // Convert to binary and store into code.
         for (int i = 0; i < 4; ++i)
-            m_data.bitstream.insert(m_data.bitstream.end(), bool(dec & (1 << i)));
+            m_data.bitstream[bit_idx ++] = bool(dec & (1 << i));
     }
 
     m_data.update_used_states(bitstream_start_idx);
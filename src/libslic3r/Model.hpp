@@ -811,6 +811,8 @@ public:
     void                set_mesh(indexed_triangle_set &&mesh) { m_mesh = std::make_shared<const TriangleMesh>(std::move(mesh)); }
     void                set_mesh(std::shared_ptr<const TriangleMesh> &mesh) { m_mesh = mesh; }
     void                set_mesh(std::unique_ptr<const TriangleMesh> &&mesh) { m_mesh = std::move(mesh); }
+    // Share the immutable mesh and convex hull of another volume with an identical mesh, see ModelProcessing::deduplicate_meshes().
+    void                share_mesh(const ModelVolume &other) { m_mesh = other.m_mesh; m_convex_hull = other.m_convex_hull; m_convex_hull_mesh = other.m_convex_hull_mesh; }
 	void				reset_mesh() { m_mesh = std::make_shared<const TriangleMesh>(); }
     const std::shared_ptr<const TriangleMesh>& get_mesh_shared_ptr() const { return m_mesh; }
     // Configuration parameters specific to an object model geometry or a modifier volume, 
@@ -871,17 +873,23 @@ public:
     void                rotate(double angle, const Vec3d& axis);
     void                mirror(Axis axis);
 
-    // This method could only be called before the meshes of this ModelVolumes are not shared!
+    // The mesh is modified in place, it is copied first if it is shared with another volume.
     void                scale_geometry_after_creation(const Vec3f &versor);
     void                scale_geometry_after_creation(const float scale) { this->scale_geometry_after_creation(Vec3f(scale, scale, scale)); }
 
     // Translates the mesh and the convex hull so that the origin of their vertices is in the center of this volume's bounding box.
-    // Attention! This method may only be called just after ModelVolume creation! It must not be called once the TriangleMesh of this ModelVolume is shared!
+    // Attention! This method may only be called just after ModelVolume creation! The mesh is modified in place, it is copied first
+    // if it is shared with another volume.
     void                center_geometry_after_creation(bool update_source_offset = true);
 
     void                calculate_convex_hull();
     const TriangleMesh& get_convex_hull() const;
     const std::shared_ptr<const TriangleMesh>& get_convex_hull_shared_ptr() const { return m_convex_hull; }
+    // Was the convex hull calculated from the current mesh? The mesh may be replaced by set_mesh() without updating the convex hull.
+    bool                is_convex_hull_valid() const;
+    // Convex hull if valid, otherwise the mesh. The transformed bounding box or the 2D convex hull of the projection of a transformed
+    // volume is the same for both, however the convex hull has usually just a fraction of the mesh vertices.
+    const TriangleMesh& convex_hull_or_mesh() const { return this->is_convex_hull_valid() ? *m_convex_hull : *m_mesh; }
 
     // Helpers for loading / storing into AMF / 3MF files.
     static ModelVolumeType type_from_string(const std::string &s);
@@ -957,6 +965,8 @@ protected:
     void     transform_this_mesh(const Matrix3d& m, bool fix_left_handed);
 
 private:
+    void     detach_shared_mesh();
+
     // Parent object owning this ModelVolume.
     ModelObject*                    	object;
     // The triangular model.
@@ -966,6 +976,9 @@ private:
     t_model_material_id             	m_material_id;
     // The convex hull of this model's mesh.
     std::shared_ptr<const TriangleMesh> m_convex_hull;
+    // The mesh m_convex_hull was calculated from. Weak pointer does not keep the mesh alive, however it keeps its control block alive,
+    // thus it is not mistaken for another mesh allocated at the same address.
+    std::weak_ptr<const TriangleMesh>   m_convex_hull_mesh;
     Geometry::Transformation        	m_transformation;
 
     // flag to optimize the checking if the volume is splittable
@@ -1002,14 +1015,14 @@ private:
         if (m_mesh->facets_count() > 1) calculate_convex_hull();
     }
     ModelVolume(ModelObject *object, TriangleMesh &&mesh, TriangleMesh &&convex_hull, ModelVolumeType type = ModelVolumeType::MODEL_PART) :
-		m_mesh(new TriangleMesh(std::move(mesh))), m_convex_hull(new TriangleMesh(std::move(convex_hull))), m_type(type), object(object) {
+		m_mesh(new TriangleMesh(std::move(mesh))), m_convex_hull(new TriangleMesh(std::move(convex_hull))), m_convex_hull_mesh(m_mesh), m_type(type), object(object) {
         assert(check());
 	}
 
     // Copying an existing volume, therefore this volume will get a copy of the ID assigned.
     ModelVolume(ModelObject *object, const ModelVolume &other) :
         ObjectBase(other),
-        name(other.name), source(other.source), m_mesh(other.m_mesh), m_convex_hull(other.m_convex_hull),
+        name(other.name), source(other.source), m_mesh(other.m_mesh), m_convex_hull(other.m_convex_hull), m_convex_hull_mesh(other.m_convex_hull_mesh),
         config(other.config), m_type(other.m_type), object(object), m_transformation(other.m_transformation),
         supported_facets(other.supported_facets), seam_facets(other.seam_facets), mm_segmentation_facets(other.mm_segmentation_facets),
         fuzzy_skin_facets(other.fuzzy_skin_facets), cut_info(other.cut_info), text_configuration(other.text_configuration), emboss_shape(other.emboss_shape)
@@ -1082,7 +1095,8 @@ private:
 	}
 	template<class Archive> void load(Archive &ar) {
 		bool has_convex_hull;
-        ar(name, source, m_mesh, m_type, m_material_id, m_transformation, m_is_splittable, has_convex_hull, cut_info);
+		bool convex_hull_valid;
+        ar(name, source, m_mesh, m_type, m_material_id, m_transformation, m_is_splittable, has_convex_hull, convex_hull_valid, cut_info);
         cereal::load_by_value(ar, supported_facets);
         cereal::load_by_value(ar, seam_facets);
         cereal::load_by_value(ar, mm_segmentation_facets);
@@ -1091,17 +1105,21 @@ private:
         cereal::load(ar, text_configuration);
         cereal::load(ar, emboss_shape);
 		assert(m_mesh);
+		m_convex_hull_mesh.reset();
 		if (has_convex_hull) {
 			cereal::load_optional(ar, m_convex_hull);
 			if (! m_convex_hull && ! m_mesh->empty())
 				// The convex hull was released from the Undo / Redo stack to conserve memory. Recalculate it.
 				this->calculate_convex_hull();
+			else if (convex_hull_valid)
+				m_convex_hull_mesh = m_mesh;
 		} else
 			m_convex_hull.reset();
 	}
 	template<class Archive> void save(Archive &ar) const {
 		bool has_convex_hull = m_convex_hull.get() != nullptr;
-        ar(name, source, m_mesh, m_type, m_material_id, m_transformation, m_is_splittable, has_convex_hull, cut_info);
+		bool convex_hull_valid = this->is_convex_hull_valid();
+        ar(name, source, m_mesh, m_type, m_material_id, m_transformation, m_is_splittable, has_convex_hull, convex_hull_valid, cut_info);
         cereal::save_by_value(ar, supported_facets);
         cereal::save_by_value(ar, seam_facets);
         cereal::save_by_value(ar, mm_segmentation_facets);
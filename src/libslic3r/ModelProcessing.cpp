@@ -14,8 +14,13 @@
 #include "Model.hpp"
 #include "ModelProcessing.hpp"
 
+#include <boost/container_hash/hash.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/log/trivial.hpp>
+#include <tbb/parallel_for.h>
+
+#include <string_view>
+#include <unordered_map>
 
 namespace Slic3r::ModelProcessing {
 
@@ -398,4 +403,57 @@ void merge(ModelObject* object)
         return;
 }
 
+// Hash of the vertices and of the indices of a mesh. Meshes with equal vertices differing in the sign of a zero coordinate
+// hash differently, which just prevents them from being shared.
+static size_t mesh_hash(const indexed_triangle_set &its)
+{
+    size_t seed = std::hash<std::string_view>()(std::string_view(reinterpret_cast<const char*>(its.vertices.data()), its.vertices.size() * sizeof(stl_vertex)));
+    boost::hash_combine(seed, std::hash<std::string_view>()(std::string_view(reinterpret_cast<const char*>(its.indices.data()), its.indices.size() * sizeof(stl_triangle_vertex_indices))));
+    return seed;
+}
+
+static bool meshes_equal(const TriangleMesh &lhs, const TriangleMesh &rhs)
+{
+    // The repair statistics are compared as well, so that the errors fixed are reported for each volume.
+    const RepairedMeshErrors &l = lhs.stats().repaired_errors;
+    const RepairedMeshErrors &r = rhs.stats().repaired_errors;
+    return lhs.its.vertices == rhs.its.vertices && lhs.its.indices == rhs.its.indices &&
+        l.edges_fixed == r.edges_fixed && l.degenerate_facets == r.degenerate_facets && l.facets_removed == r.facets_removed &&
+        l.facets_reversed == r.facets_reversed && l.backwards_edges == r.backwards_edges;
+}
+
+size_t deduplicate_meshes(Model& model)
+{
+    std::vector<ModelVolume*> volumes;
+    for (ModelObject *object : model.objects)
+        for (ModelVolume *volume : object->volumes)
+            if (! volume->mesh().empty())
+                volumes.emplace_back(volume);
+    std::vector<size_t> hashes(volumes.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, volumes.size()), [&volumes, &hashes](const tbb::blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i < range.end(); ++ i)
+            hashes[i] = mesh_hash(volumes[i]->mesh().its);
+    });
+
+    // Map of a mesh hash to the volumes with distinct meshes of that hash.
+    std::unordered_map<size_t, std::vector<const ModelVolume*>> unique_meshes;
+    size_t shared = 0;
+    for (size_t i = 0; i < volumes.size(); ++ i) {
+        ModelVolume                      &volume     = *volumes[i];
+        std::vector<const ModelVolume*>  &candidates = unique_meshes[hashes[i]];
+        auto it = std::find_if(candidates.begin(), candidates.end(), [&volume](const ModelVolume *other) {
+            return other->get_mesh_shared_ptr() == volume.get_mesh_shared_ptr() || meshes_equal(other->mesh(), volume.mesh());
+        });
+        if (it == candidates.end())
+            candidates.emplace_back(&volume);
+        else if ((*it)->get_mesh_shared_ptr() != volume.get_mesh_shared_ptr()) {
+            volume.share_mesh(**it);
+            ++ shared;
+        }
+    }
+    if (shared > 0)
+        BOOST_LOG_TRIVIAL(info) << "Shared the meshes of " << shared << " volumes with identical geometry";
+    return shared;
+}
+
 }
@@ -57,6 +57,11 @@ namespace ModelProcessing
 
     void    split(ModelObject* object, std::vector<ModelObject*>* new_objects);
     void    merge(ModelObject* object);
+
+    // Let the volumes with bitwise identical meshes share a single TriangleMesh and convex hull, to save memory
+    // with projects containing the same geometry multiple times as separate objects or volumes instead of instances.
+    // Return the number of volumes, which received a shared mesh.
+    size_t  deduplicate_meshes(Model& model);
 }
 
 } // namespace Slic3r::ModelProcessing
@@ -17,6 +17,8 @@
 #include <vector>
 #include <cassert>
 #include <cstdlib>
+#include <mutex>
+#include <optional>
 
 #include "BoundingBox.hpp"
 #include "ClipperUtils.hpp"
@@ -2072,6 +2074,102 @@ static void project_color_lines_on_color_projection_lines(std::vector<ColorLines
     }
 }
 
+// Marks the source triangles, whose painting differs between the two splitting data.
+static std::vector<bool> repainted_facets(const TriangleSelector::TriangleSplittingData &lhs, const TriangleSelector::TriangleSplittingData &rhs, const size_t num_facets)
+{
+    // Range of the bitstream assigned to each source triangle, empty for triangles that are neither split nor painted.
+    const auto bitstream_ranges = [num_facets](const TriangleSelector::TriangleSplittingData &data) {
+        std::vector<std::pair<int, int>> ranges(num_facets, { 0, 0 });
+        for (size_t mapping_idx = 0; mapping_idx < data.triangles_to_split.size(); ++mapping_idx) {
+            const TriangleSelector::TriangleBitStreamMapping &mapping = data.triangles_to_split[mapping_idx];
+            const int bitstream_end_idx = mapping_idx + 1 < data.triangles_to_split.size() ? data.triangles_to_split[mapping_idx + 1].bitstream_start_idx : int(data.bitstream.size());
+            if (mapping.triangle_idx >= 0 && size_t(mapping.triangle_idx) < num_facets)
+                ranges[mapping.triangle_idx] = { mapping.bitstream_start_idx, bitstream_end_idx };
+        }
+        return ranges;
+    };
+
+    const std::vector<std::pair<int, int>> lhs_ranges = bitstream_ranges(lhs);
+    const std::vector<std::pair<int, int>> rhs_ranges = bitstream_ranges(rhs);
+
+    std::vector<bool> repainted(num_facets, false);
+    for (size_t facet_idx = 0; facet_idx < num_facets; ++facet_idx) {
+        const auto [lhs_begin, lhs_end] = lhs_ranges[facet_idx];
+        const auto [rhs_begin, rhs_end] = rhs_ranges[facet_idx];
+        repainted[facet_idx] = lhs_end - lhs_begin != rhs_end - rhs_begin ||
+                               !std::equal(lhs.bitstream.begin() + lhs_begin, lhs.bitstream.begin() + lhs_end, rhs.bitstream.begin() + rhs_begin);
+    }
+
+    return repainted;
+}
+
+// Marks layers crossed by the repainted triangles of a single volume. Triangles sharing a vertex with a repainted triangle
+// are considered repainted too, because get_all_facets_strict_with_colors() splits the neighbors of split triangles.
+static void mark_repainted_layers(const indexed_triangle_set &its,
+                                  const Transform3d          &trafo,
+                                  const std::vector<bool>    &repainted,
+                                  const std::vector<float>   &layer_zs,
+                                  std::vector<bool>          &dirty_layers)
+{
+    std::vector<bool> repainted_vertices(its.vertices.size(), false);
+    for (size_t facet_idx = 0; facet_idx < its.indices.size(); ++facet_idx)
+        if (repainted[facet_idx])
+            for (int vertex_idx = 0; vertex_idx < 3; ++vertex_idx)
+                repainted_vertices[its.indices[facet_idx][vertex_idx]] = true;
+
+    const Transform3f trafo_f = trafo.cast<float>();
+    for (const stl_triangle_vertex_indices &face : its.indices) {
+        if (!repainted_vertices[face[0]] && !repainted_vertices[face[1]] && !repainted_vertices[face[2]])
+            continue;
+
+        float z_min = std::numeric_limits<float>::max();
+        float z_max = std::numeric_limits<float>::lowest();
+        for (int vertex_idx = 0; vertex_idx < 3; ++vertex_idx) {
+            const float z = (trafo_f * its.vertices[face[vertex_idx]]).z();
+            z_min = std::min(z_min, z);
+            z_max = std::max(z_max, z);
+        }
+
+        for (auto it_z = std::lower_bound(layer_zs.begin(), layer_zs.end(), z_min - float(EPSILON)); it_z != layer_zs.end() && *it_z <= z_max + float(EPSILON); ++it_z)
+            dirty_layers[it_z - layer_zs.begin()] = true;
+    }
+}
+
+// Takes the segmentation of a previous run calculated for the same layers and the same volumes, just possibly differently painted.
+static std::optional<PrintObjectRegions::CachedSegmentation> take_cached_segmentation(PrintObjectRegions::SegmentationCache                  &cache,
+                                                                                     const size_t                                            num_facets_states,
+                                                                                     const std::vector<float>                               &layer_zs,
+                                                                                     const std::vector<PrintObjectRegions::CachedPaintedVolume> &painted_volumes)
+{
+    const auto same_volumes = [&painted_volumes](const std::vector<PrintObjectRegions::CachedPaintedVolume> &cached_volumes) {
+        return std::equal(cached_volumes.begin(), cached_volumes.end(), painted_volumes.begin(), painted_volumes.end(),
+                          [](const PrintObjectRegions::CachedPaintedVolume &lhs, const PrintObjectRegions::CachedPaintedVolume &rhs) {
+                              return lhs.volume_id == rhs.volume_id && lhs.mesh == rhs.mesh && lhs.extruder_id == rhs.extruder_id && lhs.trafo.matrix() == rhs.trafo.matrix();
+                          });
+    };
+
+    std::scoped_lock lock(cache.mutex);
+    auto it = std::find_if(cache.entries.begin(), cache.entries.end(), [&](const PrintObjectRegions::CachedSegmentation &entry) {
+        return entry.num_facets_states == num_facets_states && entry.zs == layer_zs && same_volumes(entry.volumes);
+    });
+    if (it == cache.entries.end())
+        return std::nullopt;
+
+    PrintObjectRegions::CachedSegmentation out = std::move(*it);
+    cache.entries.erase(it);
+    return out;
+}
+
+static void store_cached_segmentation(PrintObjectRegions::SegmentationCache &cache, PrintObjectRegions::CachedSegmentation &&segmentation)
+{
+    std::scoped_lock lock(cache.mutex);
+    while (!cache.entries.empty() && cache.entries.size() >= cache.max_entries)
+        cache.entries.erase(std::min_element(cache.entries.begin(), cache.entries.end(),
+                                             [](const auto &l, const auto &r) { return l.last_used < r.last_used; }));
+    segmentation.last_used = ++cache.timestamp;
+    cache.entries.emplace_back(std::move(segmentation));
+}
+
 std::vector<std::vector<ExPolygons>> segmentation_by_painting(const PrintObject                                               &print_object,
                                                               const std::function<ModelVolumeFacetsInfo(const ModelVolume &)> &extract_facets_info,
                                                               const size_t                                                     num_facets_states,
@@ -2079,6 +2177,7 @@ std::vector<std::vector<ExPolygons>> segmentation_by_painting(const PrintObject
                                                               const float                                                      segmentation_interlocking_depth,
                                                               const bool                                                       segmentation_interlocking_beam,
                                                               const IncludeTopAndBottomLayers                                  include_top_and_bottom_layers,
+                                                              PrintObjectRegions::SegmentationCache                           *cache,
                                                               const std::function<void()>                                     &throw_on_cancel_callback)
 {
     const size_t                                   num_layers    = print_object.layers().size();
@@ -2123,16 +2222,56 @@ std::vector<std::vector<ExPolygons>> segmentation_by_painting(const PrintObject
     }); // end of parallel_for
     BOOST_LOG_TRIVIAL(debug) << "Print object segmentation - Slices preprocessing in parallel - End";
 
-    BOOST_LOG_TRIVIAL(debug) << "Print object segmentation - Slicing painted triangles - Begin";
     const std::vector<float> layer_zs = get_print_object_layers_zs(layers);
+
+    // Only the layers crossed by repainted triangles or with modified slices are segmented again, the segmentation of the other layers
+    // is taken over from the previous run.
+    std::vector<bool>                                     dirty_layers(num_layers, true);
+    std::vector<PrintObjectRegions::CachedPaintedVolume>  painted_volumes;
+    std::optional<PrintObjectRegions::CachedSegmentation> cached_segmentation;
+    if (cache != nullptr) {
+        const Transform3d trafo_centered = print_object.trafo_centered();
+        for (const ModelVolume *mv : print_object.model_object()->volumes)
+            painted_volumes.push_back({ mv->id(), mv->mesh_ptr(), trafo_centered * mv->get_matrix(), mv->extruder_id(), extract_facets_info(*mv).facets_annotation.get_data() });
+
+        cached_segmentation = take_cached_segmentation(*cache, num_facets_states, layer_zs, painted_volumes);
+        if (cached_segmentation.has_value()) {
+            for (size_t layer_idx = 0; layer_idx < num_layers; ++layer_idx)
+                dirty_layers[layer_idx] = input_expolygons[layer_idx] != cached_segmentation->input_expolygons[layer_idx];
+
+            for (size_t volume_idx = 0; volume_idx < painted_volumes.size(); ++volume_idx) {
+                const PrintObjectRegions::CachedPaintedVolume &painted_volume = painted_volumes[volume_idx];
+                if (painted_volume.facets != cached_segmentation->volumes[volume_idx].facets) {
+                    const indexed_triangle_set &its = painted_volume.mesh->its;
+                    mark_repainted_layers(its, painted_volume.trafo, repainted_facets(painted_volume.facets, cached_segmentation->volumes[volume_idx].facets, its.indices.size()), layer_zs, dirty_layers);
+                }
+            }
+            throw_on_cancel_callback();
+        }
+    }
+
+    std::vector<size_t> dirty_layers_indices;
+    std::vector<float>  dirty_layers_zs;
+    for (size_t layer_idx = 0; layer_idx < num_layers; ++layer_idx)
+        if (dirty_layers[layer_idx]) {
+            dirty_layers_indices.emplace_back(layer_idx);
+            dirty_layers_zs.emplace_back(layer_zs[layer_idx]);
+        }
+    BOOST_LOG_TRIVIAL(debug) << "Print object segmentation - " << dirty_layers_indices.size() << " of " << num_layers << " layers to be segmented";
+
+    BOOST_LOG_TRIVIAL(debug) << "Print object segmentation - Slicing painted triangles - Begin";
     for (const ModelVolume *mv : print_object.model_object()->volumes) {
-        std::vector<ColorPolygons> color_polygons_per_layer = slice_model_volume_with_color(*mv, extract_facets_info, layer_zs, print_object, num_facets_states);
+        if (dirty_layers_zs.empty())
+            break;
+
+        std::vector<ColorPolygons> color_polygons_per_layer = slice_model_volume_with_color(*mv, extract_facets_info, dirty_layers_zs, print_object, num_facets_states);
 
-        tbb::parallel_for(tbb::blocked_range<size_t>(0, num_layers), [&color_polygons_per_layer, &color_polygons_lines_layers, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
-            for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++layer_idx) {
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, dirty_layers_indices.size()), [&color_polygons_per_layer, &color_polygons_lines_layers, &dirty_layers_indices, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
+            for (size_t dirty_layer_idx = range.begin(); dirty_layer_idx < range.end(); ++dirty_layer_idx) {
                 throw_on_cancel_callback();
 
-                ColorPolygons &raw_color_polygons = color_polygons_per_layer[layer_idx];
+                const size_t   layer_idx          = dirty_layers_indices[dirty_layer_idx];
+                ColorPolygons &raw_color_polygons = color_polygons_per_layer[dirty_layer_idx];
                 filter_out_small_color_polygons(raw_color_polygons, POLYGON_FILTER_MIN_AREA_SCALED, POLYGON_FILTER_MIN_OFFSET_SCALED);
 
                 if (raw_color_polygons.empty())
@@ -2167,10 +2306,13 @@ std::vector<std::vector<ExPolygons>> segmentation_by_painting(const PrintObject
 
     // Project sliced ColorPolygons on sliced layers (input_expolygons).
     BOOST_LOG_TRIVIAL(debug) << "Print object segmentation - Projection of painted triangles - Begin";
-    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_layers), [&color_polygons_lines_layers, &input_expolygons_projection_lines_layers, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_layers), [&color_polygons_lines_layers, &input_expolygons_projection_lines_layers, &dirty_layers, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
         for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++layer_idx) {
             throw_on_cancel_callback();
 
+            if (!dirty_layers[layer_idx])
+                continue;
+
             // For each ColorLine, find the nearest ColorProjectionLines and project the ColorLine on each ColorProjectionLine.
             const AABBTreeLines::LinesDistancer<ColorProjectionLineWrapper> color_projection_lines_distancer{create_color_projection_lines_mapping(input_expolygons_projection_lines_layers[layer_idx])};
             project_color_lines_on_color_projection_lines(color_polygons_lines_layers[layer_idx], color_projection_lines_distancer);
@@ -2188,10 +2330,15 @@ std::vector<std::vector<ExPolygons>> segmentation_by_painting(const PrintObject
     // Be aware that after the projection of the ColorPolygons and its postprocessing isn't
     // ensured that consistency of the color_prev. So, only color_next can be used.
     BOOST_LOG_TRIVIAL(debug) << "Print object segmentation - Layers segmentation in parallel - Begin";
-    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_layers), [&input_expolygons_projection_lines_layers, &segmented_regions, &input_expolygons, &num_facets_states, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_layers), [&input_expolygons_projection_lines_layers, &segmented_regions, &input_expolygons, &num_facets_states, &dirty_layers, &cached_segmentation, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
         for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++layer_idx) {
             throw_on_cancel_callback();
 
+            if (!dirty_layers[layer_idx]) {
+                segmented_regions[layer_idx] = std::move(cached_segmentation->segmented_regions[layer_idx]);
+                continue;
+            }
+
             ColorProjectionExPolygons &input_expolygons_projection_lines = input_expolygons_projection_lines_layers[layer_idx];
             for (ColorProjectionExPolygon &input_expolygon_projection_lines : input_expolygons_projection_lines) {
                 const size_t expolygon_idx = &input_expolygon_projection_lines - input_expolygons_projection_lines.data();
@@ -2238,6 +2385,9 @@ std::vector<std::vector<ExPolygons>> segmentation_by_painting(const PrintObject
     BOOST_LOG_TRIVIAL(debug) << "Print object segmentation - Layers segmentation in parallel - End";
     throw_on_cancel_callback();
 
+    if (cache != nullptr)
+        store_cached_segmentation(*cache, { num_facets_states, layer_zs, std::move(painted_volumes), input_expolygons, segmented_regions });
+
     // The first index is extruder number (includes default extruder), and the second one is layer number
     std::vector<std::vector<ExPolygons>> top_and_bottom_layers;
     if (include_top_and_bottom_layers == IncludeTopAndBottomLayers::Yes) {
@@ -2273,7 +2423,8 @@ std::vector<std::vector<ExPolygons>> multi_material_segmentation_by_painting(con
         return {mv.mm_segmentation_facets, mv.is_mm_painted(), false};
     };
 
-    return segmentation_by_painting(print_object, extract_facets_info, num_facets_states, max_width, interlocking_depth, interlocking_beam, IncludeTopAndBottomLayers::Yes, throw_on_cancel_callback);
+    return segmentation_by_painting(print_object, extract_facets_info, num_facets_states, max_width, interlocking_depth, interlocking_beam, IncludeTopAndBottomLayers::Yes,
+                                    &print_object.shared_regions()->mm_segmentation_cache, throw_on_cancel_callback);
 }
 
 // Returns fuzzy skin segmentation based on painting in fuzzy skin segmentation gizmo
@@ -2292,7 +2443,8 @@ std::vector<std::vector<ExPolygons>> fuzzy_skin_segmentation_by_painting(const P
         max_external_perimeter_width = std::max<float>(max_external_perimeter_width, region.flow(print_object, frExternalPerimeter, print_object.config().layer_height).width());
     }
 
-    return segmentation_by_painting(print_object, extract_facets_info, num_facets_states, max_external_perimeter_width, 0.f, false, IncludeTopAndBottomLayers::No, throw_on_cancel_callback);
+    return segmentation_by_painting(print_object, extract_facets_info, num_facets_states, max_external_perimeter_width, 0.f, false, IncludeTopAndBottomLayers::No,
+                                    &print_object.shared_regions()->fuzzy_skin_segmentation_cache, throw_on_cancel_callback);
 }
 
 
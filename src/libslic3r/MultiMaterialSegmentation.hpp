@@ -22,7 +22,7 @@ class ModelVolume;
 class PrintObject;
 class FacetsAnnotation;
 
-using ExPolygons = std::vector<ExPolygon>;
+using ExPolygons = std::vector<ExPolygon, PointsAllocator<ExPolygon>>;
 
 struct ColoredLine
 {
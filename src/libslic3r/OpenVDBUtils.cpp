@@ -33,6 +33,7 @@
 #include <cstddef>
 
 #include "libslic3r/TriangleMesh.hpp"
+#include "libslic3r/Execution/ExecutionTBB.hpp"
 #include "libslic3r/libslic3r.h"
 
 namespace Slic3r {
@@ -122,27 +123,38 @@ VoxelGridPtr mesh_to_grid(const indexed_triangle_set &mesh,
 
     Interrupter interrupter{params.statusfn()};
 
-    openvdb::FloatGrid::Ptr grid;
-    for (auto &m : meshparts) {
-        auto subgrid = openvdb::tools::meshToVolume<openvdb::FloatGrid>(
-            interrupter,
-            TriangleMeshDataAdapter{m, trafo},
-            openvdb::math::Transform{},
-            params.exterior_bandwidth(),
-            params.interior_bandwidth());
-
-        if (interrupter.wasInterrupted())
-            break;
-
-        if (grid && subgrid)
-            openvdb::tools::csgUnion(*grid, *subgrid);
-        else if (subgrid)
-            grid = std::move(subgrid);
-    }
+    // meshToVolume() is parallel internally, though a model split into many small parts is converted faster
+    // by converting the parts in parallel, then merging the grids pairwise in parallel.
+    std::vector<openvdb::FloatGrid::Ptr> subgrids(meshparts.size());
+    execution::for_each(ex_tbb, size_t(0), meshparts.size(), [&](size_t i) {
+        Interrupter part_interrupter{params.statusfn()};
+        if (! part_interrupter.wasInterrupted())
+            subgrids[i] = openvdb::tools::meshToVolume<openvdb::FloatGrid>(
+                part_interrupter,
+                TriangleMeshDataAdapter{meshparts[i], trafo},
+                openvdb::math::Transform{},
+                params.exterior_bandwidth(),
+                params.interior_bandwidth());
+    });
 
     if (interrupter.wasInterrupted())
         return {};
 
+    for (size_t step = 1; step < subgrids.size(); step *= 2)
+        execution::for_each(ex_tbb, size_t(0), (subgrids.size() + 2 * step - 1) / (2 * step), [&subgrids, step](size_t i) {
+            openvdb::FloatGrid::Ptr &grid    = subgrids[2 * i * step];
+            openvdb::FloatGrid::Ptr &subgrid = 2 * i * step + step < subgrids.size() ? subgrids[2 * i * step + step] : grid;
+            if (&grid == &subgrid || ! subgrid)
+                return;
+            if (grid)
+                openvdb::tools::csgUnion(*grid, *subgrid);
+            else
+                grid = std::move(subgrid);
+            subgrid.reset();
+        });
+
+    openvdb::FloatGrid::Ptr grid = subgrids.empty() ? openvdb::FloatGrid::Ptr{} : std::move(subgrids.front());
+
     if (meshparts.empty()) {
         // Splitting failed, fall back to hollow the original mesh
         grid = openvdb::tools::meshToVolume<openvdb::FloatGrid>(
@@ -234,9 +246,11 @@ VoxelGridPtr dilate_grid(const VoxelGrid &vgrid,
 VoxelGridPtr redistance_grid(const VoxelGrid &vgrid,
                      float              iso,
                      float              er,
-                     float              ir)
+                     float              ir,
+                     const std::function<bool(int)> &statusfn)
 {
-    auto new_grid = openvdb::tools::levelSetRebuild(vgrid.grid, iso, er, ir);
+    Interrupter interrupter{statusfn};
+    auto new_grid = openvdb::tools::levelSetRebuild(vgrid.grid, iso, er, ir, nullptr, &interrupter);
 
     auto ret = make_voxelgrid(std::move(*new_grid));
 
@@ -76,10 +76,13 @@ VoxelGridPtr dilate_grid(const VoxelGrid &grid,
 
 VoxelGridPtr redistance_grid(const VoxelGrid &grid, float iso);
 
+// statusfn is polled while the level set is rebuilt, returning true interrupts
+// the rebuild. The returned grid is incomplete if interrupted.
 VoxelGridPtr redistance_grid(const VoxelGrid &grid,
                              float            iso,
                              float            ext_range,
-                             float            int_range);
+                             float            int_range,
+                             const std::function<bool(int)> &statusfn = {});
 
 void rescale_grid(VoxelGrid &grid, float scale);
 
@@ -8,6 +8,7 @@
 #include "PerimeterGenerator.hpp"
 
 #include <ankerl/unordered_dense.h>
+#include <boost/container_hash/hash.hpp>
 #include <algorithm>
 #include <cmath>
 #include <cassert>
@@ -980,6 +981,64 @@ std::tuple<std::vector<ExtrusionPaths>, Polygons> generate_extra_perimeters_over
     return {extra_perims, diff(inset_overhang_area, inset_overhang_area_left_unfilled)};
 }
 
+void PerimeterGenerator::update_lower_slices_polygons_cache(const Parameters &params, const ExPolygons *lower_slices, Polygons &lower_slices_polygons_cache)
+{
+    if (params.config.overhangs && lower_slices != nullptr && lower_slices_polygons_cache.empty()) {
+        // We consider overhang any part where the entire nozzle diameter is not supported by the
+        // lower layer, so we take lower slices and offset them by half the nozzle diameter used
+        // in the current layer
+        double nozzle_diameter = params.print_config.nozzle_diameter.get_at(params.config.perimeter_extruder-1);
+        lower_slices_polygons_cache = offset(*lower_slices, float(scale_(+nozzle_diameter/2)));
+    }
+}
+
+static size_t polygons_hash(const Polygons &polygons)
+{
+    size_t seed = polygons.size();
+    for (const Polygon &polygon : polygons) {
+        boost::hash_combine(seed, polygon.size());
+        for (const Point &pt : polygon)
+            boost::hash_combine(seed, (int64_t(pt.x()) << 32) ^ int64_t(pt.y()));
+    }
+    return seed;
+}
+
+PerimeterGenerator::ArachneWallsCache::Walls PerimeterGenerator::ArachneWallsCache::walls(
+    const Polygons &outline, coord_t bead_width_0, coord_t bead_width_x, size_t inset_count, coordf_t layer_height,
+    const PrintObjectConfig &print_object_config, const PrintConfig &print_config, const std::function<void()> &throw_on_cancel)
+{
+    const size_t hash = polygons_hash(outline);
+    {
+        std::scoped_lock lock(m_mutex);
+        for (const Entry &entry : m_entries)
+            if (entry.hash == hash && entry.bead_width_0 == bead_width_0 && entry.bead_width_x == bead_width_x &&
+                entry.inset_count == inset_count && entry.layer_height == layer_height && entry.outline == outline) {
+                ++ m_num_hits;
+                return *entry.walls;
+            }
+    }
+
+    // Calculate outside of the lock, the same outline may be calculated by multiple threads in parallel,
+    // which is cheaper than waiting for each other.
+    Arachne::WallToolPaths wall_tool_paths(outline, bead_width_0, bead_width_x, inset_count, 0, layer_height, print_object_config, print_config, throw_on_cancel);
+    auto walls = std::make_shared<const Walls>(Walls{ wall_tool_paths.getToolPaths(), wall_tool_paths.getInnerContour() });
+
+    std::scoped_lock lock(m_mutex);
+    if (m_entries.size() == MAX_ENTRIES)
+        m_entries.pop_front();
+    m_entries.push_back({ hash, outline, bead_width_0, bead_width_x, inset_count, layer_height, walls });
+    return *walls;
+}
+
+static PerimeterGenerator::ArachneWallsCache::Walls arachne_walls(const PerimeterGenerator::Parameters &params, const Polygons &outline,
+    coord_t bead_width_0, coord_t bead_width_x, size_t inset_count)
+{
+    if (params.arachne_walls_cache)
+        return params.arachne_walls_cache->walls(outline, bead_width_0, bead_width_x, inset_count, params.layer_height, params.object_config, params.print_config, params.throw_on_cancel);
+    Arachne::WallToolPaths wall_tool_paths(outline, bead_width_0, bead_width_x, inset_count, 0, params.layer_height, params.object_config, params.print_config, params.throw_on_cancel);
+    return { wall_tool_paths.getToolPaths(), wall_tool_paths.getInnerContour() };
+}
+
 // Thanks, Cura developers, for implementing an algorithm for generating perimeters with variable width (Arachne) that is based on the paper
 // "A framework for adaptive width control of dense contour-parallel toolpaths in fused deposition modeling"
 void PerimeterGenerator::process_arachne(
@@ -1009,13 +1068,7 @@ void PerimeterGenerator::process_arachne(
     coord_t solid_infill_spacing  = params.solid_infill_flow.scaled_spacing();
 
     // prepare grown lower layer slices for overhang detection
-    if (params.config.overhangs && lower_slices != nullptr && lower_slices_polygons_cache.empty()) {
-        // We consider overhang any part where the entire nozzle diameter is not supported by the
-        // lower layer, so we take lower slices and offset them by half the nozzle diameter used
-        // in the current layer
-        double nozzle_diameter = params.print_config.nozzle_diameter.get_at(params.config.perimeter_extruder-1);
-        lower_slices_polygons_cache = offset(*lower_slices, float(scale_(+nozzle_diameter/2)));
-    }
+    update_lower_slices_polygons_cache(params, lower_slices, lower_slices_polygons_cache);
 
     // we need to process each island separately because we might have different
     // extra perimeters for each one
@@ -1033,9 +1086,9 @@ void PerimeterGenerator::process_arachne(
 
     ExPolygons last   = offset_ex(surface.expolygon.simplify_p(params.scaled_resolution), - float(ext_perimeter_width / 2. - ext_perimeter_spacing / 2.));
     Polygons   last_p = to_polygons(last);
-    Arachne::WallToolPaths wall_tool_paths(last_p, ext_perimeter_spacing, perimeter_spacing, coord_t(loop_number + 1), 0, params.layer_height, params.object_config, params.print_config);
-    Arachne::Perimeters    perimeters     = wall_tool_paths.getToolPaths();
-    ExPolygons             infill_contour = union_ex(wall_tool_paths.getInnerContour());
+    ArachneWallsCache::Walls walls         = arachne_walls(params, last_p, ext_perimeter_spacing, perimeter_spacing, coord_t(loop_number + 1));
+    Arachne::Perimeters      perimeters     = std::move(walls.perimeters);
+    ExPolygons               infill_contour = union_ex(walls.inner_contour);
 
     // Check if there are some remaining perimeters to generate (the number of perimeters
     // is greater than one together with enabled the single perimeter on top surface feature).
@@ -1071,8 +1124,8 @@ void PerimeterGenerator::process_arachne(
             top_expolygons = intersection_ex(top_expolygons, infill_contour);
 
             const Polygons not_top_polygons = to_polygons(not_top_expolygons);
-            Arachne::WallToolPaths inner_wall_tool_paths(not_top_polygons, perimeter_spacing, perimeter_spacing, coord_t(inner_loop_number + 1), 0, params.layer_height, params.object_config, params.print_config);
-            Arachne::Perimeters inner_perimeters = inner_wall_tool_paths.getToolPaths();
+            ArachneWallsCache::Walls inner_walls = arachne_walls(params, not_top_polygons, perimeter_spacing, perimeter_spacing, coord_t(inner_loop_number + 1));
+            Arachne::Perimeters inner_perimeters = std::move(inner_walls.perimeters);
 
             // Recalculate indexes of inner perimeters before merging them.
             if (!perimeters.empty()) {
@@ -1086,13 +1139,13 @@ void PerimeterGenerator::process_arachne(
             }
 
             perimeters.insert(perimeters.end(), inner_perimeters.begin(), inner_perimeters.end());
-            infill_contour = union_ex(top_expolygons, inner_wall_tool_paths.getInnerContour());
+            infill_contour = union_ex(top_expolygons, inner_walls.inner_contour);
         } else {
             // There is no top surface ExPolygon, so we call Arachne again with parameters
             // like when the single perimeter feature is disabled.
-            Arachne::WallToolPaths no_single_perimeter_tool_paths(last_p, ext_perimeter_spacing, perimeter_spacing, coord_t(inner_loop_number + 2), 0, params.layer_height, params.object_config, params.print_config);
-            perimeters     = no_single_perimeter_tool_paths.getToolPaths();
-            infill_contour = union_ex(no_single_perimeter_tool_paths.getInnerContour());
+            ArachneWallsCache::Walls no_single_perimeter_walls = arachne_walls(params, last_p, ext_perimeter_spacing, perimeter_spacing, coord_t(inner_loop_number + 2));
+            perimeters     = std::move(no_single_perimeter_walls.perimeters);
+            infill_contour = union_ex(no_single_perimeter_walls.inner_contour);
         }
     }
 
@@ -1213,13 +1266,7 @@ void PerimeterGenerator::process_classic(
     bool    has_gap_fill 		= params.config.gap_fill_enabled.value && params.config.gap_fill_speed.value > 0;
 
     // prepare grown lower layer slices for overhang detection
-    if (params.config.overhangs && lower_slices != nullptr && lower_slices_polygons_cache.empty()) {
-        // We consider overhang any part where the entire nozzle diameter is not supported by the
-        // lower layer, so we take lower slices and offset them by half the nozzle diameter used 
-        // in the current layer
-        double nozzle_diameter = params.print_config.nozzle_diameter.get_at(params.config.perimeter_extruder-1);
-        lower_slices_polygons_cache = offset(*lower_slices, float(scale_(+nozzle_diameter/2)));
-    }
+    update_lower_slices_polygons_cache(params, lower_slices, lower_slices_polygons_cache);
 
     // we need to process each island separately because we might have different
     // extra perimeters for each one
@@ -1262,8 +1309,7 @@ void PerimeterGenerator::process_classic(
                         diff_ex(last, offset(offsets, float(ext_perimeter_width / 2.) + ClipperSafetyOffset)),
                         float(min_width / 2.));
                     // the maximum thickness of our thin wall area is equal to the minimum thickness of a single loop
-                    for (ExPolygon &ex : expp)
-                        ex.medial_axis(min_width, ext_perimeter_width + ext_perimeter_spacing2, &thin_walls);
+                    medial_axis(expp, min_width, ext_perimeter_width + ext_perimeter_spacing2, &thin_walls);
                 }
                 if (params.spiral_vase && offsets.size() > 1) {
                 	// Remove all but the largest area polygon.
@@ -1465,8 +1511,7 @@ void PerimeterGenerator::process_classic(
             opening_ex(gaps, float(min / 2.)),
             offset2_ex(gaps, - float(max / 2.), float(max / 2. + ClipperSafetyOffset)));
         ThickPolylines polylines;
-        for (const ExPolygon &ex : gaps_ex)
-            ex.medial_axis(min, max, &polylines);
+        medial_axis(gaps_ex, min, max, &polylines);
         if (! polylines.empty()) {
 			ExtrusionEntityCollection gap_fill;
 			variable_width_classic(polylines, ExtrusionRole::GapFill, params.solid_infill_flow, gap_fill.entities);
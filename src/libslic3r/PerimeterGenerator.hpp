@@ -7,6 +7,11 @@
 #ifndef slic3r_PerimeterGenerator_hpp_
 #define slic3r_PerimeterGenerator_hpp_
 
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 #include "libslic3r.h"
@@ -19,6 +24,7 @@
 #include "libslic3r/ExtrusionEntity.hpp"
 #include "libslic3r/ExtrusionRole.hpp"
 #include "libslic3r/Point.hpp"
+#include "libslic3r/Arachne/utils/ExtrusionLine.hpp"
 
 namespace Slic3r {
 class ExtrusionEntityCollection;
@@ -48,6 +54,46 @@ using PerimeterRegions = std::vector<PerimeterRegion>;
 
 namespace Slic3r::PerimeterGenerator {
 
+// Arachne walls shared by the layers of a PrintObject while generating its perimeters.
+// Prismatic objects have many layers with identical slices, thus with identical walls,
+// which are calculated just once. Thread safe, the configs must be the same for all the calls.
+class ArachneWallsCache
+{
+public:
+    struct Walls
+    {
+        Arachne::Perimeters perimeters;
+        Polygons            inner_contour;
+    };
+
+    // Calculate the walls with Arachne::WallToolPaths,
+    // or return the walls of an identical outline calculated before with the same parameters.
+    Walls walls(const Polygons &outline, coord_t bead_width_0, coord_t bead_width_x, size_t inset_count, coordf_t layer_height,
+                const PrintObjectConfig &print_object_config, const PrintConfig &print_config, const std::function<void()> &throw_on_cancel = nullptr);
+
+    size_t num_hits() const { return m_num_hits; }
+
+private:
+    struct Entry
+    {
+        size_t                       hash;
+        Polygons                     outline;
+        coord_t                      bead_width_0;
+        coord_t                      bead_width_x;
+        size_t                       inset_count;
+        coordf_t                     layer_height;
+        std::shared_ptr<const Walls> walls;
+    };
+
+    // Only the most recently calculated walls are kept, so that the cache does not hold the walls of all the layers
+    // of non-prismatic objects. The layers are processed in parallel in blocks of adjacent layers.
+    static constexpr const size_t MAX_ENTRIES = 64;
+
+    std::mutex          m_mutex;
+    std::deque<Entry>   m_entries;
+    std::atomic<size_t> m_num_hits { 0 };
+};
+
 struct Parameters {    
     Parameters(
         double                      layer_height,
@@ -98,10 +144,18 @@ struct Parameters {
     double                       mm3_per_mm;
     double                       mm3_per_mm_overhang;
 
+    // Optional cache of the Arachne walls shared with the other layers of the object.
+    ArachneWallsCache           *arachne_walls_cache { nullptr };
+    // Optional cancellation callback, called from inside Arachne, which may run for seconds on complex slices.
+    std::function<void()>        throw_on_cancel;
+
 private:
     Parameters() = delete;
 };
 
+// Grow the lower layer slices for the overhang detection, if not done yet.
+void update_lower_slices_polygons_cache(const Parameters &params, const ExPolygons *lower_slices, Polygons &lower_slices_polygons_cache);
+
 void process_classic(
     // Inputs:
     const Parameters           &params,
@@ -20,6 +20,10 @@
 #include <cinttypes>
 #include <cstdio>
 #include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
 
 #include "Exception.hpp"
 #include "Flow.hpp"
@@ -810,6 +814,9 @@ namespace client
         // If false, the macro_processor will evaluate a full macro.
         // If true, the macro processor will evaluate just a boolean condition using the full expressive power of the macro processor.
         bool                     just_boolean_expression = false;
+        // If set, a single code block of a compiled template is being parsed. The error messages are reported
+        // relative to the complete template, so that they do not differ from parsing the template as a whole.
+        const std::string       *error_context_template = nullptr;
         std::string              error_message;
 
         // Table to translate symbol tag to a human readable error message.
@@ -1583,8 +1590,12 @@ namespace client
         static void process_error_message(const MyContext *context, const boost::spirit::info &info, const Iterator &it_begin, const Iterator &it_end, const Iterator &it_error)
         {
             std::string &msg = const_cast<MyContext*>(context)->error_message;
-            std::string  first(it_begin, it_error);
-            std::string  last(it_error, it_end);
+            // Report the error relative to the complete template if just a code block of a compiled template is being parsed.
+            const std::string *templ    = context->error_context_template;
+            Iterator     it_first   = templ ? templ->cbegin() : it_begin;
+            Iterator     it_last    = templ ? templ->cend()   : it_end;
+            std::string  first(it_first, it_error);
+            std::string  last(it_error, it_last);
             auto         first_pos  = first.rfind('\n');
             auto         last_pos   = last.find('\n');
             int          line_nr    = 1;
@@ -1599,7 +1610,7 @@ namespace client
             }
             auto error_line = std::string(first, first_pos) + std::string(last, 0, last_pos);
             // Position of the it_error from the start of its line.
-            auto error_pos  = (it_error - it_begin) - first_pos;
+            auto error_pos  = (it_error - it_first) - first_pos;
             msg += "Parsing error at line " + std::to_string(line_nr);
             if (! info.tag.empty() && info.tag.front() == '*') {
                 // The gat contains an explanatory string.
@@ -2348,14 +2359,273 @@ namespace client
 
 static const client::macro_processor g_macro_processor_instance;
 
+static void throw_error_message(client::MyContext &context)
+{
+    if (context.error_message.back() != '\n' && context.error_message.back() != '\r')
+        context.error_message += '\n';
+    throw Slic3r::PlaceholderParserError(context.error_message);
+}
+
 static std::string process_macro(const std::string &templ, client::MyContext &context)
 {
     std::string output;
     phrase_parse(templ.begin(), templ.end(), g_macro_processor_instance(&context), client::skipper{}, output);
-	if (! context.error_message.empty()) {
-        if (context.error_message.back() != '\n' && context.error_message.back() != '\r')
-            context.error_message += '\n';
-        throw Slic3r::PlaceholderParserError(context.error_message);
+	if (! context.error_message.empty())
+        throw_error_message(context);
+    return output;
+}
+
+namespace client
+{
+    // Custom G-codes (layer change, tool change, ...) are processed over and over with the same template.
+    // The template is split into segments once and the segmentation is cached: Free-form text is copied
+    // and the legacy [variable] placeholders are expanded without invoking the Spirit parser, only the code blocks
+    // enclosed in {} are parsed by the macro_processor grammar, each of them just over its own extent.
+    // Sequences of code blocks and text forming an {if}...{endif} spanning text are evaluated as a single code block.
+    struct CompiledTemplate
+    {
+        enum class SegmentType {
+            // Text copied to the output verbatim.
+            Text,
+            // [variable]
+            LegacyVariable,
+            // [variable[index_variable]]
+            LegacyVariableIndexed,
+            // {code} or a sequence of code blocks and text forming an {if}...{endif} spanning text.
+            Macro,
+        };
+        struct Segment {
+            SegmentType type;
+            // Range of the text, of the variable name or of the code block including the braces.
+            size_t      begin;
+            size_t      end;
+            // Range of the name of the index variable of a LegacyVariableIndexed.
+            size_t      index_begin { 0 };
+            size_t      index_end   { 0 };
+        };
+        // If false, the template is not well formed or the segmentation is not sure about it.
+        // Such a template is parsed as a whole, so that the same error is reported as before.
+        bool                    valid { false };
+        std::vector<Segment>    segments;
+    };
+
+    static bool is_skipped_whitespace(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+    static bool is_identifier_start(char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_'; }
+    static bool is_identifier_char(char c) { return is_identifier_start(c) || (c >= '0' && c <= '9'); }
+
+    // Find the closing brace of a code block starting at pos (just after the opening brace).
+    // Accumulates the number of "if" keywords minus the number of "endif" keywords into if_balance.
+    // Returns std::string::npos if the code block is not closed or if its extent is not certain.
+    static size_t find_code_block_end(const std::string &templ, size_t pos, int &if_balance)
+    {
+        // Last non-white space character, to tell a regular expression literal from a division.
+        char last = '{';
+        while (pos < templ.size()) {
+            char c = templ[pos];
+            if (c == '"' || (c == '/' && (last == '~' || last == ',' || last == '('))) {
+                // String or regular expression literal with backslash escapes.
+                for (++ pos; pos < templ.size() && templ[pos] != c; ++ pos)
+                    if (templ[pos] == '\\')
+                        ++ pos;
+                if (pos >= templ.size())
+                    return std::string::npos;
+                last = c;
+                ++ pos;
+            } else if (is_identifier_start(c)) {
+                size_t begin = pos;
+                while (pos < templ.size() && is_identifier_char(templ[pos]))
+                    ++ pos;
+                std::string_view word(templ.data() + begin, pos - begin);
+                if (word == "if")
+                    ++ if_balance;
+                else if (word == "endif")
+                    -- if_balance;
+                last = 'a';
+            } else if (c >= '0' && c <= '9') {
+                // Numeric literal including an exponent.
+                while (pos < templ.size() && (is_identifier_char(templ[pos]) || templ[pos] == '.'))
+                    ++ pos;
+                last = '0';
+            } else if (c == '}') {
+                return pos;
+            } else if (c == '{') {
+                return std::string::npos;
+            } else {
+                if (! is_skipped_whitespace(c))
+                    last = c;
+                ++ pos;
+            }
+        }
+        return std::string::npos;
+    }
+
+    // Parse an identifier of a legacy variable expansion starting at pos, skipping the leading white spaces.
+    static bool parse_legacy_identifier(const std::string &templ, size_t &pos, size_t &begin, size_t &end)
+    {
+        static constexpr const std::string_view keywords[] = {
+            "and", "digits", "zdigits", "empty", "if", "int", "is_nil", "local", "else", "elsif", "endif", "false", "global",
+            "interpolate_table", "min", "max", "random", "repeat", "round", "not", "one_of", "or", "size", "true"
+        };
+        while (pos < templ.size() && is_skipped_whitespace(templ[pos]))
+            ++ pos;
+        if (pos == templ.size() || ! is_identifier_start(templ[pos]))
+            return false;
+        begin = pos;
+        while (pos < templ.size() && is_identifier_char(templ[pos]))
+            ++ pos;
+        end = pos;
+        std::string_view word(templ.data() + begin, end - begin);
+        return std::find(std::begin(keywords), std::end(keywords), word) == std::end(keywords);
+    }
+
+    static bool parse_legacy_char(const std::string &templ, size_t &pos, char c)
+    {
+        while (pos < templ.size() && is_skipped_whitespace(templ[pos]))
+            ++ pos;
+        if (pos == templ.size() || templ[pos] != c)
+            return false;
+        ++ pos;
+        return true;
+    }
+
+    static std::shared_ptr<const CompiledTemplate> compile_template(const std::string &templ)
+    {
+        auto out = std::make_shared<CompiledTemplate>();
+        // The white spaces at the start of the template are consumed by the skipper of the grammar's start rule,
+        // which throws on a non-ASCII7 character.
+        size_t pos = 0;
+        while (pos < templ.size() && is_skipped_whitespace(templ[pos]))
+            ++ pos;
+        if (pos < templ.size() && static_cast<unsigned char>(templ[pos]) >= 0x80)
+            return out;
+        try {
+            utf8_char_parser   utf8char;
+            spirit::unused_type unused;
+            for (Iterator it = templ.begin(); it != templ.end();)
+                utf8char.parse(it, templ.end(), unused, unused, unused);
+        } catch (const qi::expectation_failure<Iterator>&) {
+            return out;
+        }
+
+        size_t text_begin  = pos;
+        size_t group_begin = 0;
+        int    if_balance  = 0;
+        auto   emit_text   = [&out, &text_begin](size_t end) {
+            if (end > text_begin)
+                out->segments.push_back({ CompiledTemplate::SegmentType::Text, text_begin, end });
+        };
+        while (pos < templ.size()) {
+            char c = templ[pos];
+            if (c == '{') {
+                if (if_balance == 0) {
+                    emit_text(pos);
+                    group_begin = pos;
+                }
+                size_t end = find_code_block_end(templ, pos + 1, if_balance);
+                if (end == std::string::npos || if_balance < 0)
+                    return out;
+                pos = end + 1;
+                if (if_balance == 0) {
+                    out->segments.push_back({ CompiledTemplate::SegmentType::Macro, group_begin, pos });
+                    text_begin = pos;
+                }
+            } else if (c == '[' && if_balance == 0) {
+                // Legacy variable expansion: [variable] or [variable[index_variable]]
+                CompiledTemplate::Segment segment { CompiledTemplate::SegmentType::LegacyVariable, 0, 0 };
+                size_t end = pos + 1;
+                if (! parse_legacy_identifier(templ, end, segment.begin, segment.end))
+                    return out;
+                if (parse_legacy_char(templ, end, '[')) {
+                    segment.type = CompiledTemplate::SegmentType::LegacyVariableIndexed;
+                    if (! parse_legacy_identifier(templ, end, segment.index_begin, segment.index_end) || ! parse_legacy_char(templ, end, ']'))
+                        return out;
+                }
+                if (! parse_legacy_char(templ, end, ']'))
+                    return out;
+                emit_text(pos);
+                out->segments.push_back(segment);
+                pos = text_begin = end;
+            } else
+                ++ pos;
+        }
+        if (if_balance != 0)
+            return out;
+        emit_text(pos);
+        out->valid = true;
+        return out;
+    }
+
+    class CompiledTemplateCache
+    {
+    public:
+        std::shared_ptr<const CompiledTemplate> get(const std::string &templ)
+        {
+            {
+                std::scoped_lock<std::mutex> lock(m_mutex);
+                if (auto it = m_cache.find(templ); it != m_cache.end())
+                    return it->second;
+            }
+            std::shared_ptr<const CompiledTemplate> compiled = compile_template(templ);
+            std::scoped_lock<std::mutex> lock(m_mutex);
+            // The templates are few (custom G-codes, output file name format), don't let the cache grow
+            // if someone processes many unique templates.
+            if (m_cache.size() >= max_size)
+                m_cache.clear();
+            m_cache.emplace(templ, compiled);
+            return compiled;
+        }
+
+    private:
+        static constexpr const size_t max_size = 256;
+        std::mutex                                                               m_mutex;
+        std::unordered_map<std::string, std::shared_ptr<const CompiledTemplate>> m_cache;
+    };
+}
+
+static client::CompiledTemplateCache g_compiled_template_cache;
+
+static std::string process_compiled_template(const std::string &templ, const client::CompiledTemplate &compiled, client::MyContext &context)
+{
+    using SegmentType = client::CompiledTemplate::SegmentType;
+    std::string output;
+    context.error_context_template = &templ;
+    try {
+        for (const client::CompiledTemplate::Segment &segment : compiled.segments) {
+            client::Iterator it_begin = templ.begin() + segment.begin;
+            client::Iterator it_end   = templ.begin() + segment.end;
+            switch (segment.type) {
+            case SegmentType::Text:
+                output.append(it_begin, it_end);
+                break;
+            case SegmentType::LegacyVariable:
+            case SegmentType::LegacyVariableIndexed:
+            {
+                client::IteratorRange opt_key(it_begin, it_end);
+                std::string           value;
+                if (segment.type == SegmentType::LegacyVariable)
+                    client::MyContext::legacy_variable_expansion(&context, opt_key, value);
+                else {
+                    client::IteratorRange opt_vector_index(templ.begin() + segment.index_begin, templ.begin() + segment.index_end);
+                    client::MyContext::legacy_variable_expansion2(&context, opt_key, opt_vector_index, value);
+                }
+                output += value;
+                break;
+            }
+            case SegmentType::Macro:
+            {
+                std::string value;
+                phrase_parse(it_begin, it_end, g_macro_processor_instance(&context), client::skipper{}, value);
+                if (! context.error_message.empty())
+                    throw_error_message(context);
+                output += value;
+                break;
+            }
+            }
+        }
+    } catch (const qi::expectation_failure<client::Iterator> &err) {
+        // Thrown by the legacy variable expansion, report it the same way the grammar's error handler does.
+        client::MyContext::process_error_message(&context, err.what_, templ.begin(), templ.end(), err.first);
+        throw_error_message(context);
     }
     return output;
 }
@@ -2369,7 +2639,8 @@ std::string PlaceholderParser::process(const std::string &templ, unsigned int cu
     context.config_outputs      = config_outputs;
     context.current_extruder_id = current_extruder_id;
     context.context_data        = context_data;
-    return process_macro(templ, context);
+    std::shared_ptr<const client::CompiledTemplate> compiled = g_compiled_template_cache.get(templ);
+    return compiled->valid ? process_compiled_template(templ, *compiled, context) : process_macro(templ, context);
 }
 
 // Evaluate a boolean expression using the full expressive power of the PlaceholderParser boolean expression syntax.
@@ -31,8 +31,8 @@ class Polyline;
 struct ThickPolyline;
 class BoundingBox;
 
-typedef std::vector<Polyline> Polylines;
-typedef std::vector<ThickPolyline> ThickPolylines;
+typedef std::vector<Polyline, PointsAllocator<Polyline>> Polylines;
+typedef std::vector<ThickPolyline, PointsAllocator<ThickPolyline>> ThickPolylines;
 
 class Polyline : public MultiPoint {
 public:
@@ -11,11 +11,15 @@
 #include "Utils.hpp"
 #include "Model.hpp"
 #include "format.hpp"
+#include "libslic3r_version.h"
 
 #include <algorithm>
 #include <set>
 #include <fstream>
 #include <unordered_set>
+#include <unordered_map>
+#include <sstream>
+#include <string_view>
 #include <boost/filesystem.hpp>
 #include <boost/algorithm/clamp.hpp>
 #include <boost/algorithm/string/predicate.hpp>
@@ -26,6 +30,9 @@
 #include <boost/property_tree/ptree.hpp>
 #include <boost/locale.hpp>
 #include <boost/log/trivial.hpp>
+#include <cereal/archives/binary.hpp>
+#include <cereal/types/string.hpp>
+#include <cereal/types/vector.hpp>
 
 #include <LibBGCode/core/core.hpp>
 
@@ -181,6 +188,7 @@ void PresetBundle::setup_directories()
 		data_dir / "vendor",
         data_dir / "cache",
         data_dir / "cache" / "vendor",
+        data_dir / "cache" / "vendor_flattened",
         data_dir / "shapes",
 #ifdef SLIC3R_PROFILE_USE_PRESETS_SUBDIR
         // Store the print/filament/printer presets into a "presets" directory.
@@ -369,13 +377,13 @@ std::pair<PresetsConfigSubstitutions, std::string> PresetBundle::load_system_pre
                 // Load the config bundle, flatten it.
                 if (first) {
                     // Reset this PresetBundle and load the first vendor config.
-                    append(substitutions, this->load_configbundle(dir_entry.path().string(), PresetBundle::LoadSystem, compatibility_rule).first);
+                    append(substitutions, this->load_configbundle(dir_entry.path().string(), PresetBundle::LoadSystem | PresetBundle::UseFlattenedCache, compatibility_rule).first);
                     first = false;
                 } else {
                     // Load the other vendor configs, merge them with this PresetBundle.
                     // Report duplicate profiles.
                     PresetBundle other;
-                    append(substitutions, other.load_configbundle(dir_entry.path().string(), PresetBundle::LoadSystem, compatibility_rule).first);
+                    append(substitutions, other.load_configbundle(dir_entry.path().string(), PresetBundle::LoadSystem | PresetBundle::UseFlattenedCache, compatibility_rule).first);
                     std::vector<std::string> duplicates = this->merge_presets(std::move(other));
                     if (! duplicates.empty()) {
                         errors_cummulative += "Vendor configuration file " + name + " contains the following presets with names used by other vendors: ";
@@ -1405,6 +1413,121 @@ static void flatten_configbundle_hierarchy(boost::property_tree::ptree &tree, co
     flatten_configbundle_hierarchy(tree, "printer",         preset_bundle ? preset_bundle->printers.system_preset_names()      : std::vector<std::string>());
 }
 
+namespace {
+// A system config bundle after flatten_configbundle_hierarchy(), cached in a binary form.
+// The vendor bundles are large, parsing them and resolving their inheritance takes a considerable part
+// of the application start, though they only change with a configuration update.
+struct FlattenedConfigBundle
+{
+    // To be bumped whenever the layout of the cache or the flattening changes.
+    static constexpr const uint32_t current_format_version = 1;
+
+    uint32_t                    format_version { current_format_version };
+    std::string                 slicer_version;
+    // Size and hash of the source INI file, the cache is only valid for the very same file content.
+    uint64_t                    source_size { 0 };
+    uint64_t                    source_hash { 0 };
+    // Section names, keys and values. Most of the keys and many values repeat over the presets, they are stored once.
+    std::vector<std::string>    strings;
+    struct Section {
+        uint32_t                name { 0 };
+        uint32_t                data { 0 };
+        // Indices of keys and values into strings, interleaved.
+        std::vector<uint32_t>   key_values;
+        template<class Archive> void serialize(Archive &ar) { ar(name, data, key_values); }
+    };
+    std::vector<Section>        sections;
+
+    template<class Archive> void serialize(Archive &ar) { ar(format_version, slicer_version, source_size, source_hash, strings, sections); }
+};
+
+boost::filesystem::path flattened_configbundle_cache_path(const std::string &path)
+{
+    return (boost::filesystem::path(data_dir()) / "cache" / "vendor_flattened" / (boost::filesystem::path(path).stem().string() + ".cereal")).make_preferred();
+}
+
+// Returns false if the cache does not exist or if it does not match the source config bundle.
+bool load_flattened_configbundle(const std::string &path, const std::string &source, boost::property_tree::ptree &tree)
+{
+    namespace pt = boost::property_tree;
+    boost::filesystem::path cache_path = flattened_configbundle_cache_path(path);
+    boost::system::error_code ec;
+    if (! boost::filesystem::exists(cache_path, ec))
+        return false;
+    FlattenedConfigBundle cache;
+    try {
+        boost::nowide::ifstream file(cache_path.string(), std::ios::binary);
+        cereal::BinaryInputArchive archive(file);
+        archive(cache);
+    } catch (const std::exception &ex) {
+        BOOST_LOG_TRIVIAL(warning) << "Failed to load the flattened config bundle " << cache_path.string() << ": " << ex.what();
+        return false;
+    }
+    if (cache.format_version != FlattenedConfigBundle::current_format_version || cache.slicer_version != SLIC3R_VERSION ||
+        cache.source_size != source.size() || cache.source_hash != std::hash<std::string_view>()(source))
+        return false;
+    auto valid_index = [&cache](uint32_t idx) { return idx < cache.strings.size(); };
+    tree.clear();
+    for (const FlattenedConfigBundle::Section &section : cache.sections) {
+        if (! valid_index(section.name) || ! valid_index(section.data) || (section.key_values.size() & 1) != 0 ||
+            ! std::all_of(section.key_values.begin(), section.key_values.end(), valid_index)) {
+            BOOST_LOG_TRIVIAL(warning) << "The flattened config bundle " << cache_path.string() << " is corrupted";
+            tree.clear();
+            return false;
+        }
+        pt::ptree &node = tree.push_back(std::make_pair(cache.strings[section.name], pt::ptree(cache.strings[section.data])))->second;
+        for (size_t i = 0; i < section.key_values.size(); i += 2)
+            node.push_back(std::make_pair(cache.strings[section.key_values[i]], pt::ptree(cache.strings[section.key_values[i + 1]])));
+    }
+    return true;
+}
+
+void save_flattened_configbundle(const std::string &path, const std::string &source, const boost::property_tree::ptree &tree)
+{
+    FlattenedConfigBundle cache;
+    cache.slicer_version = SLIC3R_VERSION;
+    cache.source_size    = source.size();
+    cache.source_hash    = std::hash<std::string_view>()(source);
+    std::unordered_map<std::string, uint32_t> string_to_idx;
+    auto intern = [&cache, &string_to_idx](const std::string &s) {
+        auto [it, inserted] = string_to_idx.emplace(s, uint32_t(cache.strings.size()));
+        if (inserted)
+            cache.strings.emplace_back(s);
+        return it->second;
+    };
+    cache.sections.reserve(tree.size());
+    for (const auto &section : tree) {
+        FlattenedConfigBundle::Section &out = cache.sections.emplace_back();
+        out.name = intern(section.first);
+        out.data = intern(section.second.data());
+        out.key_values.reserve(section.second.size() * 2);
+        for (const auto &kvp : section.second) {
+            // The INI file is two levels deep.
+            assert(kvp.second.empty());
+            out.key_values.emplace_back(intern(kvp.first));
+            out.key_values.emplace_back(intern(kvp.second.data()));
+        }
+    }
+    // Write into a temporary file first, so that another instance of the application never reads a partially written cache.
+    boost::filesystem::path cache_path = flattened_configbundle_cache_path(path);
+    boost::filesystem::path tmp_path   = cache_path;
+    tmp_path += ".tmp";
+    try {
+        boost::filesystem::create_directories(cache_path.parent_path());
+        {
+            boost::nowide::ofstream file(tmp_path.string(), std::ios::binary);
+            cereal::BinaryOutputArchive archive(file);
+            archive(cache);
+        }
+        boost::filesystem::rename(tmp_path, cache_path);
+    } catch (const std::exception &ex) {
+        BOOST_LOG_TRIVIAL(warning) << "Failed to save the flattened config bundle " << cache_path.string() << ": " << ex.what();
+        boost::system::error_code ec;
+        boost::filesystem::remove(tmp_path, ec);
+    }
+}
+} // namespace
+
 // Load a config bundle file, into presets and store the loaded presets into separate files
 // of the local configuration directory.
 std::pair<PresetsConfigSubstitutions, size_t> PresetBundle::load_configbundle(
@@ -1421,10 +1544,24 @@ std::pair<PresetsConfigSubstitutions, size_t> PresetBundle::load_configbundle(
     // 1) Read the complete config file into a boost::property_tree.
     namespace pt = boost::property_tree;
     pt::ptree tree;
+    std::string source;
     {
-        boost::nowide::ifstream ifs(path);
+        boost::nowide::ifstream ifs(path, std::ios::binary);
+        ifs.seekg(0, std::ios::end);
+        std::streamoff size = ifs.tellg();
+        if (size > 0) {
+            source.resize(size_t(size));
+            ifs.seekg(0, std::ios::beg);
+            ifs.read(source.data(), size);
+        }
+    }
+    // A system config bundle may have already been flattened and cached by a previous run.
+    const bool use_cache = flags.has(LoadConfigBundleAttribute::LoadSystem) && flags.has(LoadConfigBundleAttribute::UseFlattenedCache);
+    bool       flattened = use_cache && load_flattened_configbundle(path, source, tree);
+    if (! flattened) {
+        std::istringstream iss(source);
         try {
-            pt::read_ini(ifs, tree);
+            pt::read_ini(iss, tree);
         } catch (const boost::property_tree::ini_parser::ini_parser_error &err) {
             throw Slic3r::RuntimeError(format("Failed loading config bundle \"%1%\"\nError: \"%2%\" at line %3%", path, err.message(), err.line()).c_str());
         }
@@ -1448,7 +1585,11 @@ std::pair<PresetsConfigSubstitutions, size_t> PresetBundle::load_configbundle(
 
     // 1.5) Flatten the config bundle by applying the inheritance rules. Internal profiles (with names starting with '*') are removed.
     // If loading a user config bundle, do not flatten with the system profiles, but keep the "inherits" flag intact.
-    flatten_configbundle_hierarchy(tree, flags.has(LoadConfigBundleAttribute::LoadSystem) ? nullptr : this);
+    if (! flattened) {
+        flatten_configbundle_hierarchy(tree, flags.has(LoadConfigBundleAttribute::LoadSystem) ? nullptr : this);
+        if (use_cache)
+            save_flattened_configbundle(path, source, tree);
+    }
 
     // 2) Parse the property_tree, extract the active preset names and the profiles, save them into local config files.
     // Parse the obsolete preset names, to be deleted when upgrading from the old configuration structure.
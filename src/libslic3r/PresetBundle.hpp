@@ -146,6 +146,9 @@ public:
         // Load a system config bundle.
         LoadSystem,
         LoadVendorOnly,
+        // Together with LoadSystem: Reuse the flattened config bundle cached by a previous run, cache it if not cached yet.
+        // Only to be used for the installed vendor bundles, the cache is addressed by the bundle file name.
+        UseFlattenedCache,
     };
     using LoadConfigBundleAttributes = enum_bitmask<LoadConfigBundleAttribute>;
     // Load the config bundle based on the flags.
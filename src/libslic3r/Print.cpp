@@ -29,8 +29,10 @@
 #include "Flow.hpp"
 #include "Geometry/ConvexHull.hpp"
 #include "I18N.hpp"
+#include "MemoryUsage.hpp"
 #include "ShortestPath.hpp"
 #include "Thread.hpp"
+#include "Trace.hpp"
 #include "GCode.hpp"
 #include "libslic3r/GCode/WipeTower.hpp"
 #include "libslic3r/GCode/ConflictChecker.hpp"
@@ -88,6 +90,7 @@ bool Print::invalidate_state_by_config_options(const ConfigOptionResolver & /* n
         "before_layer_gcode",
         "between_objects_gcode",
         "binary_gcode",
+        "binary_gcode_compression",
         "bridge_acceleration",
         "bridge_fan_speed",
         "enable_dynamic_fan_speeds",
@@ -222,20 +225,31 @@ bool Print::invalidate_state_by_config_options(const ConfigOptionResolver & /* n
             || opt_key == "prefer_clockwise_movements") {
             osteps.emplace_back(posSlice);
         } else if (
-               opt_key == "complete_objects"
-            || opt_key == "filament_type"
-            || opt_key == "first_layer_temperature"
+               opt_key == "first_layer_temperature"
             || opt_key == "filament_loading_speed"
             || opt_key == "filament_loading_speed_start"
             || opt_key == "filament_unloading_speed"
             || opt_key == "filament_unloading_speed_start"
             || opt_key == "filament_toolchange_delay"
+            || opt_key == "filament_cooling_initial_speed"
+            || opt_key == "filament_cooling_final_speed"
+            || opt_key == "high_current_on_filament_swap"
+            || opt_key == "temperature"
+            || opt_key == "idle_temperature"
+            || opt_key == "travel_speed"
+            || opt_key == "travel_speed_z"
+            || opt_key == "first_layer_speed"
+            || opt_key == "z_offset") {
+            // Speeds and temperatures of the wipe tower moves do not change the footprint of the wipe tower,
+            // which the skirt wraps around, thus the skirt and the brim stay valid.
+            steps.emplace_back(psWipeTower);
+        } else if (
+               opt_key == "complete_objects"
+            || opt_key == "filament_type"
             || opt_key == "filament_cooling_moves"
             || opt_key == "filament_stamping_loading_speed"
             || opt_key == "filament_stamping_distance"
             || opt_key == "filament_minimal_purge_on_wipe_tower"
-            || opt_key == "filament_cooling_initial_speed"
-            || opt_key == "filament_cooling_final_speed"
             || opt_key == "filament_purge_multiplier"
             || opt_key == "filament_ramming_parameters"
             || opt_key == "filament_multitool_ramming"
@@ -245,11 +259,8 @@ bool Print::invalidate_state_by_config_options(const ConfigOptionResolver & /* n
             || opt_key == "filament_infill_max_speed"
             || opt_key == "filament_infill_max_crossing_speed"
             || opt_key == "gcode_flavor"
-            || opt_key == "high_current_on_filament_swap"
             || opt_key == "infill_first"
             || opt_key == "single_extruder_multi_material"
-            || opt_key == "temperature"
-            || opt_key == "idle_temperature"
             || opt_key == "wipe_tower"
             || opt_key == "wipe_tower_width"
             || opt_key == "wipe_tower_brim_width"
@@ -259,17 +270,14 @@ bool Print::invalidate_state_by_config_options(const ConfigOptionResolver & /* n
             || opt_key == "wipe_tower_extra_flow"
             || opt_key == "wipe_tower_no_sparse_layers"
             || opt_key == "wipe_tower_extruder"
+            || opt_key == "optimize_toolchange_order"
             || opt_key == "wiping_volumes_matrix"
             || opt_key == "wiping_volumes_use_custom_matrix"
             || opt_key == "parking_pos_retraction"
             || opt_key == "cooling_tube_retraction"
             || opt_key == "cooling_tube_length"
             || opt_key == "extra_loading_move"
-            || opt_key == "multimaterial_purging"
-            || opt_key == "travel_speed"
-            || opt_key == "travel_speed_z"
-            || opt_key == "first_layer_speed"
-            || opt_key == "z_offset") {
+            || opt_key == "multimaterial_purging") {
             steps.emplace_back(psWipeTower);
             steps.emplace_back(psSkirtBrim);
         } else if (opt_key == "filament_soluble") {
@@ -395,6 +403,20 @@ std::vector<unsigned int> Print::extruders() const
     return extruders;
 }
 
+void Print::set_task(const TaskParams &params)
+{
+    if (params.single_model_object.valid() &&
+        std::none_of(m_objects.begin(), m_objects.end(), [&params](const PrintObject *object) { return object->model_object()->id() == params.single_model_object; }))
+        if (const PrintObject *print_object = this->get_print_object_by_model_object_id(params.single_model_object); print_object != nullptr) {
+            // The ModelObject is printed by a PrintObject of another equal ModelObject, process that one.
+            TaskParams params_shared = params;
+            params_shared.single_model_object = print_object->model_object()->id();
+            PrintBaseWithState<PrintStep, psCount>::set_task_impl(params_shared, m_objects);
+            return;
+        }
+    PrintBaseWithState<PrintStep, psCount>::set_task_impl(params, m_objects);
+}
+
 unsigned int Print::num_object_instances() const
 {
 	unsigned int instances = 0;
@@ -889,6 +911,38 @@ void Print::auto_assign_extruders(ModelObject* model_object) const
 }
 
 // Slicing process, running at a background thread.
+// Two PrintObjects produce the same support if they are sliced from the same volumes with the same transformation (apart from
+// the XY translation, which is not applied to the PrintObject) and with the same configuration. This is the case of objects with
+// equal, but not shared meshes, which are not merged into a single PrintObject by Print::apply().
+static bool print_objects_support_equal(const PrintObject &lhs, const PrintObject &rhs)
+{
+    const ModelObject &mo_lhs = *lhs.model_object();
+    const ModelObject &mo_rhs = *rhs.model_object();
+    if (! lhs.trafo().isApprox(rhs.trafo(), 0.) || lhs.center_offset() != rhs.center_offset() ||
+        lhs.layer_count() != rhs.layer_count() || lhs.config() != rhs.config() ||
+        mo_lhs.volumes.size() != mo_rhs.volumes.size() || mo_lhs.layer_config_ranges.size() != mo_rhs.layer_config_ranges.size())
+        return false;
+    for (size_t i = 0; i < lhs.layer_count(); ++ i)
+        if (lhs.get_layer(int(i))->print_z != rhs.get_layer(int(i))->print_z)
+            return false;
+    for (auto it_lhs = mo_lhs.layer_config_ranges.begin(), it_rhs = mo_rhs.layer_config_ranges.begin(); it_lhs != mo_lhs.layer_config_ranges.end(); ++ it_lhs, ++ it_rhs)
+        if (it_lhs->first != it_rhs->first || it_lhs->second.get() != it_rhs->second.get())
+            return false;
+    for (size_t i = 0; i < mo_lhs.volumes.size(); ++ i) {
+        const ModelVolume &mv_lhs = *mo_lhs.volumes[i];
+        const ModelVolume &mv_rhs = *mo_rhs.volumes[i];
+        if (mv_lhs.type() != mv_rhs.type() || ! mv_lhs.get_matrix().isApprox(mv_rhs.get_matrix(), 0.) || mv_lhs.config.get() != mv_rhs.config.get() ||
+            mv_lhs.supported_facets.get_data() != mv_rhs.supported_facets.get_data() ||
+            mv_lhs.mm_segmentation_facets.get_data() != mv_rhs.mm_segmentation_facets.get_data())
+            return false;
+        // Copied objects share the meshes, compare the contents otherwise.
+        if (const TriangleMesh &m_lhs = mv_lhs.mesh(), &m_rhs = mv_rhs.mesh(); 
+            &m_lhs != &m_rhs && (m_lhs.its.indices != m_rhs.its.indices || m_lhs.its.vertices != m_rhs.its.vertices))
+            return false;
+    }
+    return true;
+}
+
 void Print::process()
 {
     name_tbb_thread_pool_threads_set_locale();
@@ -902,6 +956,14 @@ void Print::process()
             m_objects[idx]->ironing();
         }
     }, tbb::simple_partitioner());
+    trace_memory_usage(*this);
+    if (m_low_memory) {
+        // None of the steps above will be executed again in this slicing pass, release the data needed just to execute them again.
+        m_low_memory_released = true;
+        for (PrintObject *obj : m_objects)
+            obj->release_intermediate_data();
+        trace_memory_usage(*this);
+    }
 
     // The following step writes to m_shared_regions, it should not run in parallel.
     for (PrintObject *obj : m_objects)
@@ -910,16 +972,46 @@ void Print::process()
     // this also has to be done sequentially.
     alert_when_supports_needed();
 
-    tbb::parallel_for(tbb::blocked_range<size_t>(0, m_objects.size(), 1), [this](const tbb::blocked_range<size_t> &range) {
+    // Generate support for just one PrintObject of those producing the same support, copy it to the others.
+    std::vector<const PrintObject*> support_sources(m_objects.size(), nullptr);
+    for (size_t idx = 0; idx < m_objects.size(); ++ idx)
+        if (const PrintObject &obj = *m_objects[idx]; ! obj.is_step_done(posSupportMaterial) && obj.has_support_material())
+            for (size_t idx_src = 0; idx_src < m_objects.size(); ++ idx_src)
+                if (const PrintObject &src = *m_objects[idx_src]; 
+                    idx_src != idx && support_sources[idx_src] == nullptr && (idx_src < idx || src.is_step_done(posSupportMaterial)) && 
+                    print_objects_support_equal(obj, src)) {
+                    // Either the support has already been generated for src, or it will be generated before it is copied to obj.
+                    support_sources[idx] = &src;
+                    if (src.is_step_done(posSupportMaterial))
+                        break;
+                }
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, m_objects.size(), 1), [this, &support_sources](const tbb::blocked_range<size_t> &range) {
+        for (size_t idx = range.begin(); idx < range.end(); ++idx)
+            if (support_sources[idx] == nullptr)
+                m_objects[idx]->generate_support_material();
+    }, tbb::simple_partitioner());
+    trace_memory_usage(*this);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, m_objects.size(), 1), [this, &support_sources](const tbb::blocked_range<size_t> &range) {
         for (size_t idx = range.begin(); idx < range.end(); ++idx) {
             PrintObject &obj = *m_objects[idx];
-            obj.generate_support_material();
+            const bool   toolpaths_ready = obj.is_step_done(posCalculateOverhangingPerimeters);
+            if (support_sources[idx] != nullptr)
+                obj.copy_support_material(*support_sources[idx]);
             obj.estimate_curled_extrusions();
             obj.calculate_overhanging_perimeters();
+            if (! toolpaths_ready) {
+                // The toolpaths replace the coarse preview of a dense object.
+                std::atomic_store(&obj.m_coarse_preview, std::shared_ptr<const PrintObject::CoarsePreview>());
+                // This is the last PrintObject step, the background thread will not touch the layers of this object anymore.
+                // Let the UI show them in the preliminary preview while the other objects, wipe tower and skirt / brim are being generated.
+                this->set_status(-2, "", SlicingStatus::RELOAD_FFF_PREVIEW);
+            }
         }
     }, tbb::simple_partitioner());
+    trace_memory_usage(*this);
 
     if (this->set_started(psWipeTower)) {
+        Trace::Span trace_span("psWipeTower", "Print");
         m_wipe_tower_data.clear();
         m_tool_ordering.clear();
         if (this->has_wipe_tower()) {
@@ -934,6 +1026,7 @@ void Print::process()
         this->set_done(psWipeTower);
     }
     if (this->set_started(psSkirtBrim)) {
+        Trace::Span trace_span("psSkirtBrim", "Print");
         this->set_status(88, _u8L("Generating skirt and brim"));
 
         m_skirt.clear();
@@ -966,6 +1059,7 @@ void Print::process()
 
         this->finalize_first_layer_convex_hull();
         this->set_done(psSkirtBrim);
+        trace_memory_usage(*this);
     }
 
     if (this->has_wipe_tower()) {
@@ -980,7 +1074,14 @@ void Print::process()
     if (conflictRes.has_value())
         BOOST_LOG_TRIVIAL(error) << boost::format("gcode path conflicts found between %1% and %2%") % conflictRes->_objName1 % conflictRes->_objName2;
 
-    m_sequential_collision_detected =  config().complete_objects ? check_seq_conflict(model(), config()) : std::nullopt;
+    if (config().complete_objects) {
+        if (! m_sequential_collision_cache)
+            m_sequential_collision_cache = std::make_shared<SeqConflictCache>();
+        m_sequential_collision_detected = check_seq_conflict(model(), config(), m_sequential_collision_cache.get());
+    } else {
+        m_sequential_collision_detected = std::nullopt;
+        m_sequential_collision_cache.reset();
+    }
 
     BOOST_LOG_TRIVIAL(info) << "Slicing process finished." << log_memory_info();
 }
@@ -1004,6 +1105,7 @@ std::string Print::export_gcode(const std::string& path_template, GCodeProcessor
         message = _u8L("Generating G-code");
     this->set_status(90, message);
 
+    Trace::Span trace_span("psGCodeExport", "Print");
     // Create GCode on heap, it has quite a lot of data.
     std::unique_ptr<GCodeGenerator> gcode(new GCodeGenerator(const_cast<const Print*>(this)));
     gcode->do_export(this, path.c_str(), result, thumbnail_cb);
@@ -1014,9 +1116,32 @@ std::string Print::export_gcode(const std::string& path_template, GCodeProcessor
     if (result)
         result->sequential_collision_detected = m_sequential_collision_detected;
 
+    trace_memory_usage(*this);
+    if (result != nullptr && Trace::enabled())
+        Trace::counter("G-code preview data", "Memory", -1, int64_t(memory_used(*result)));
+
     return path.c_str();
 }
 
+// Statistics only variant of export_gcode(), for quoting the print time and the material usage.
+void Print::estimate_gcode_statistics()
+{
+    this->set_status(90, _u8L("Estimating print time"));
+
+    Trace::Span trace_span("psGCodeExport", "Print");
+    std::unique_ptr<GCodeGenerator> gcode(new GCodeGenerator(const_cast<const Print*>(this)));
+    gcode->do_estimate(this);
+}
+
+void Print::release_layer_extrusions(const Layer &layer)
+{
+    assert(m_low_memory);
+    assert(std::find(m_objects.begin(), m_objects.end(), layer.object()) != m_objects.end());
+    m_low_memory_released = true;
+    // The layer is owned by a PrintObject of this Print, thus it is safe to modify it.
+    const_cast<Layer&>(layer).clear_extrusions();
+}
+
 void Print::_make_skirt()
 {
     // First off we need to decide how tall the skirt must be.
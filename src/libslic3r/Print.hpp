@@ -26,6 +26,7 @@
 #include "PrintBase.hpp"
 
 #include "BoundingBox.hpp"
+#include "ElephantFootCompensation.hpp"
 #include "ExtrusionEntityCollection.hpp"
 #include "Flow.hpp"
 #include "Point.hpp"
@@ -54,6 +55,7 @@ class Layer;
 class ModelObject;
 class Print;
 class PrintObject;
+class SeqConflictCache;
 class SupportLayer;
 
 namespace FillAdaptive {
@@ -68,6 +70,10 @@ namespace FillLightning {
     using GeneratorPtr = std::unique_ptr<Generator, GeneratorDeleter>;
 }; // namespace FillLightning
 
+namespace Seams {
+    struct ObjectSeamPlacement;
+}; // namespace Seams
+
 // Print step IDs for keeping track of the print state.
 // The Print steps are applied in this order.
 enum PrintStep : unsigned int {
@@ -255,6 +261,56 @@ public:
 
     std::optional<GeneratedSupportPoints> generated_support_points;
 
+    // Raw slices of a single ModelVolume as produced by slice_mesh_ex().
+    struct CachedVolumeSlices {
+        std::shared_ptr<const TriangleMesh>     mesh;
+        MeshSlicingParamsEx                     params;
+        std::vector<float>                      zs;
+        std::vector<ExPolygons>                 slices;
+        size_t                                  last_used { 0 };
+    };
+    // Raw slices of ModelVolumes are retained over invalidation of posSlice. Slicing of ModelVolumes, whose mesh, transformation,
+    // slicing parameters and slicing planes did not change, is skipped, for example if just the layer ranges were edited.
+    // The cache is accessed concurrently by the PrintObjects sharing this PrintObjectRegions.
+    struct VolumeSlicesCache {
+        std::mutex                              mutex;
+        std::vector<CachedVolumeSlices>         entries;
+        // Least recently used entries are dropped above this limit.
+        size_t                                  max_entries { 0 };
+        size_t                                  timestamp { 0 };
+    };
+    VolumeSlicesCache                           volume_slices_cache;
+
+    // Painting of a single ModelVolume the segmentation by painting was calculated with.
+    struct CachedPaintedVolume {
+        ObjectID                                volume_id;
+        std::shared_ptr<const TriangleMesh>     mesh;
+        Transform3d                             trafo;
+        int                                     extruder_id { -1 };
+        TriangleSelector::TriangleSplittingData facets;
+    };
+    // Per layer segmentation by painting (before cutting and merging with the painted top and bottom layers) of a single PrintObject.
+    struct CachedSegmentation {
+        size_t                                  num_facets_states { 0 };
+        std::vector<float>                      zs;
+        std::vector<CachedPaintedVolume>        volumes;
+        std::vector<ExPolygons>                 input_expolygons;
+        std::vector<std::vector<ExPolygons>>    segmented_regions;
+        size_t                                  last_used { 0 };
+    };
+    // Segmentation by painting is retained over invalidation of posSlice. If just the painting changed, only the layers crossed
+    // by the repainted triangles and the layers with modified slices are segmented again.
+    // The cache is accessed concurrently by the PrintObjects sharing this PrintObjectRegions from const PrintObject methods.
+    struct SegmentationCache {
+        std::mutex                              mutex;
+        std::vector<CachedSegmentation>         entries;
+        // Least recently used entries are dropped above this limit.
+        size_t                                  max_entries { 1 };
+        size_t                                  timestamp { 0 };
+    };
+    mutable SegmentationCache                   mm_segmentation_cache;
+    mutable SegmentationCache                   fuzzy_skin_segmentation_cache;
+
     void ref_cnt_inc() { ++ m_ref_cnt; }
     void ref_cnt_dec() { if (-- m_ref_cnt == 0) delete this; }
     void clear() {
@@ -286,6 +342,9 @@ public:
     Transform3d                  trafo_centered() const 
         { Transform3d t = this->trafo(); t.pretranslate(Vec3d(- unscale<double>(m_center_offset.x()), - unscale<double>(m_center_offset.y()), 0)); return t; }
     const PrintInstances&        instances() const      { return m_instances; }
+    // Does this PrintObject print instances of the ModelObject? Besides its own model_object(), a PrintObject prints
+    // the instances of the ModelObjects equal to its model_object(), see Print::apply().
+    bool                         prints_model_object(ObjectID model_object_id) const;
 
     // Whoever will get a non-const pointer to PrintObject will be able to modify its layers.
     LayerPtrs&                   layers()               { return m_layers; }
@@ -372,6 +431,23 @@ public:
     // Helpers to project custom facets on slices
     void project_and_append_custom_facets(bool seam, TriangleStateType type, std::vector<Polygons>& expolys) const;
 
+    // Coarse slices of a dense object, shown in the preview until the exact slices and the toolpaths of the object are finished.
+    struct CoarsePreview {
+        // Top and height of each preview layer, a preview layer spans several object layers.
+        std::vector<coordf_t>   print_z;
+        std::vector<coordf_t>   height;
+        // Slices of the model parts at a single object layer of each preview layer, in the coordinate system of the PrintObject.
+        std::vector<ExPolygons> slices;
+        // Volume of the object estimated from the preview slices, in mm^3.
+        double                  volume { 0 };
+    };
+    // Thread safe, called by the UI while the object is being sliced, see Print::set_coarse_preview_triangles().
+    std::shared_ptr<const CoarsePreview> coarse_preview() const { return std::atomic_load(&m_coarse_preview); }
+
+    // Seam placement precalculated by the G-code export. Kept to be reused by the following G-code exports
+    // until the perimeters, the seam painting or the seam placement parameters change, see Seams::Placer::init().
+    mutable std::shared_ptr<const Seams::ObjectSeamPlacement> seam_placement_cache;
+
 private:
     // to be called from Print only.
     friend class Print;
@@ -408,14 +484,21 @@ private:
     void make_perimeters();
     void prepare_infill();
     void clear_fills();
+    // Low memory mode: Release the data needed only to execute the finished steps again (the backed up untyped slices,
+    // the infill octrees and the slicing and segmentation caches shared with the other instances of the object).
+    void release_intermediate_data();
     void infill();
     void ironing();
     void generate_support_spots();
     void generate_support_material();
+    // Copy the support generated for a PrintObject sliced from the same volumes with the same configuration.
+    void copy_support_material(const PrintObject &src);
     void estimate_curled_extrusions();
     void calculate_overhanging_perimeters();
 
     void slice_volumes();
+    // Slice the model parts of a dense object at a coarse layer grid for the preview, see Print::set_coarse_preview_triangles().
+    void slice_coarse_preview();
     // Has any support (not counting the raft).
     void detect_surfaces_type();
     void process_external_surfaces();
@@ -454,6 +537,12 @@ private:
 
     std::pair<FillAdaptive::OctreePtr, FillAdaptive::OctreePtr> m_adaptive_fill_octrees;
     FillLightning::GeneratorPtr m_lightning_generator;
+    // Ironing extrusions generated by posInfill together with the infill of each layer, consumed by posIroning.
+    std::vector<std::vector<Layer::IroningFill>> m_ironing_fills;
+    // Elephant foot compensation of the 1st layer, reused by posSlice if the 1st layer slices did not change.
+    ElephantFootCompensationCache           m_elephant_foot_compensation_cache;
+    // Written by the background thread, read by the UI thread with std::atomic_load().
+    std::shared_ptr<const CoarsePreview>    m_coarse_preview;
 };
 
 
@@ -609,7 +698,7 @@ public:
     std::vector<ObjectID> print_object_ids() const override;
 
     ApplyStatus         apply(const Model &model, DynamicPrintConfig config, std::vector<std::string> *warnings = nullptr) override;
-    void                set_task(const TaskParams &params) override { PrintBaseWithState<PrintStep, psCount>::set_task_impl(params, m_objects); }
+    void                set_task(const TaskParams &params) override;
     void                process() override;
     void                finalize() override { PrintBaseWithState<PrintStep, psCount>::finalize_impl(m_objects); }
     void                cleanup() override;
@@ -617,6 +706,21 @@ public:
     // Exports G-code into a file name based on the path_template, returns the file path of the generated G-code file.
     // If preview_data is not null, the preview_data is filled in for the G-code visualization (not used by the command line Slic3r).
     std::string         export_gcode(const std::string& path_template, GCodeProcessorResult* result, ThumbnailsGeneratorCallback thumbnail_cb = nullptr);
+    // Fill in the print time and material estimates of print_statistics() without exporting the G-code.
+    void                estimate_gcode_statistics();
+
+    // Low memory mode for a single export (command line): The data needed only to execute the finished PrintObject steps again
+    // is released once the infill is generated, and the extrusions of each layer are released once the G-code export generated
+    // the G-code of the layer. Without complete_objects, the extrusions of the layers waiting for the export are spilled into a scratch file
+    // (see LayerSpill). The layers could not be exported or previewed again, the next process() slices the objects again.
+    void                set_low_memory(bool value) { m_low_memory = value; }
+    bool                low_memory() const { return m_low_memory; }
+
+    // Objects with model parts of more than the given number of triangles in total are first sliced at a coarse layer grid.
+    // The coarse slices are shown in the preview while the exact slicing is running, see PrintObject::coarse_preview().
+    // Zero disables the coarse preview. May be changed while the background processing is running.
+    void                set_coarse_preview_triangles(size_t triangles) { m_coarse_preview_triangles = triangles; }
+    size_t              coarse_preview_triangles() const { return m_coarse_preview_triangles; }
 
     // methods for handling state
     bool                is_step_done(PrintStep step) const { return Inherited::is_step_done(step); }
@@ -651,7 +755,7 @@ public:
     const PrintObject*          get_object(size_t idx) const { return m_objects[idx]; }
     const PrintObject* get_print_object_by_model_object_id(ObjectID object_id) const {
         auto it = std::find_if(m_objects.begin(), m_objects.end(),
-                               [object_id](const PrintObject* obj) { return obj->model_object()->id() == object_id; });
+                               [object_id](const PrintObject* obj) { return obj->prints_model_object(object_id); });
         return (it == m_objects.end()) ? nullptr : *it;
     }
     // PrintObject by its ObjectID, to be used to uniquely bind slicing warnings to their source PrintObjects
@@ -750,6 +854,16 @@ private:
 
     ConflictResultOpt m_conflict_result;
     std::optional<std::pair<std::string, std::string>> m_sequential_collision_detected; // names of objects (hit first when printing second)
+    // Convex hulls of the instances and the result of the last sequential collision check, reused by the next check.
+    std::shared_ptr<SeqConflictCache> m_sequential_collision_cache;
+
+    // Called by the G-code export in the low memory mode for the layers, of which the G-code was generated.
+    void                release_layer_extrusions(const Layer &layer);
+
+    bool                                    m_low_memory { false };
+    // Set once the low memory mode released data of the finished steps, thus the steps have to be executed again.
+    bool                                    m_low_memory_released { false };
+    std::atomic<size_t>                     m_coarse_preview_triangles { 0 };
 };
 
 } /* slic3r_Print_hpp_ */
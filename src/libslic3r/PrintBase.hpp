@@ -475,7 +475,9 @@ public:
             RELOAD_SLA_PREVIEW                  = 1 << 3,
             // UPDATE_PRINT_STEP_WARNINGS is mutually exclusive with UPDATE_PRINT_OBJECT_STEP_WARNINGS.
             UPDATE_PRINT_STEP_WARNINGS          = 1 << 4,
-            UPDATE_PRINT_OBJECT_STEP_WARNINGS   = 1 << 5
+            UPDATE_PRINT_OBJECT_STEP_WARNINGS   = 1 << 5,
+            // Toolpaths of a PrintObject are final, the FFF preview may show them before the G-code is exported.
+            RELOAD_FFF_PREVIEW                  = 1 << 6
         };
         // Bitmap of FlagBits
         unsigned int    flags;
@@ -534,6 +536,7 @@ public:
 protected:
 	friend class PrintObjectBase;
     friend class BackgroundSlicingProcess;
+    friend class SpeculativeSlicingProcess;
 
     std::mutex&            state_mutex() const { return m_state_mutex; }
     std::function<void()>  cancel_callback() { return m_cancel_callback; }
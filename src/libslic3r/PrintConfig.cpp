@@ -253,6 +253,12 @@ static const t_config_enum_values s_keys_map_LabelObjectsStyle = {
 };
 CONFIG_OPTION_ENUM_DEFINE_STATIC_MAPS(LabelObjectsStyle)
 
+static const t_config_enum_values s_keys_map_BinaryGCodeCompression = {
+    { "heatshrink", int(BinaryGCodeCompression::Heatshrink) },
+    { "none",       int(BinaryGCodeCompression::None)       }
+};
+CONFIG_OPTION_ENUM_DEFINE_STATIC_MAPS(BinaryGCodeCompression)
+
 static const t_config_enum_values s_keys_map_GCodeThumbnailsFormat = {
     { "PNG", int(GCodeThumbnailsFormat::PNG) },
     { "JPG", int(GCodeThumbnailsFormat::JPG) },
@@ -2126,6 +2132,18 @@ void PrintConfigDef::init_fff_params()
     def->mode = comExpert;
     def->set_default_value(new ConfigOptionBool(false));
 
+    def = this->add("binary_gcode_compression", coEnum);
+    def->label = L("Binary G-code compression");
+    def->tooltip = L("Compression of the G-code blocks of binary G-code. "
+                     "Heatshrink produces small files. Without compression, only the MeatPack encoding is applied, "
+                     "which makes the export faster at the cost of larger files, for example for uploads over a fast local network.");
+    def->set_enum<BinaryGCodeCompression>({
+        { "heatshrink", L("Heatshrink") },
+        { "none",       L("None (MeatPack only)") }
+    });
+    def->mode = comExpert;
+    def->set_default_value(new ConfigOptionEnum<BinaryGCodeCompression>(BinaryGCodeCompression::Heatshrink));
+
     def = this->add("machine_limits_usage", coEnum);
     def->label = L("How to apply limits");
     def->full_label = L("Purpose of Machine Limits");
@@ -2409,6 +2427,15 @@ void PrintConfigDef::init_fff_params()
     def->mode = comExpert;
     def->set_default_value(new ConfigOptionBool(false));
 
+    def = this->add("optimize_toolchange_order", coBool);
+    def->label = L("Optimize tool change order");
+    def->category = L("Extruders");
+    def->tooltip = L("If enabled, the order of the extruders is planned over all layers of the print at once "
+                     "to minimize the number of tool changes and the purged volume. "
+                     "Otherwise each layer starts with the extruder the previous layer ended with, if possible.");
+    def->mode = comExpert;
+    def->set_default_value(new ConfigOptionBool(false));
+
     def = this->add("output_filename_format", coString);
     def->label = L("Output filename format");
     def->tooltip = L("You can use all configuration options as variables inside this template. "
@@ -5845,6 +5872,12 @@ CLIActionsConfigDef::CLIActionsConfigDef()
     def->tooltip = L("Slice the model and export toolpaths as G-code.");
     def->cli = "export-gcode|gcode|g";
     def->set_default_value(new ConfigOptionBool(false));
+
+    def = this->add("estimate", coBool);
+    def->label = L("Estimate");
+    def->tooltip = L("Slice the model and write the estimated print time and material usage as JSON to the console. "
+                     "No G-code is exported, no thumbnails are rendered and no post-processing scripts are run.");
+    def->set_default_value(new ConfigOptionBool(false));
 }
 
 CLITransformConfigDef::CLITransformConfigDef()
@@ -5954,6 +5987,60 @@ CLIMiscConfigDef::CLIMiscConfigDef()
     def->tooltip = L("Sets the maximum number of threads the slicing process will use. If not defined, it will be decided automatically.");
     def->min = 1;
 
+    def = this->add("numa_node", coInt);
+    def->label = L("NUMA node");
+    def->tooltip = L("Pin the threads slicing the job to the given NUMA node. The option is ignored if the NUMA topology "
+        "of the system is not detected.");
+    def->min = 0;
+
+    def = this->add("low_priority", coBool);
+    def->label = L("Low priority");
+    def->tooltip = L("Slice the job with a low priority, so that the jobs of a normal priority running concurrently "
+        "in the slicing server are preferred.");
+
+    def = this->add("parallel_beds", coBool);
+    def->label = L("Slice all beds in parallel");
+    def->tooltip = L("Slice all occupied beds of a multi-bed project concurrently and export the G-code of each bed "
+        "into a separate file with the bed number appended to its name.");
+
+    def = this->add("low_memory", coBool);
+    def->label = L("Low memory mode");
+    def->tooltip = L("Release the intermediate data of the slicing process as soon as the following steps consumed them "
+        "and the toolpaths of each layer as soon as its G-code was exported. The toolpaths waiting for the G-code export "
+        "are moved into a temporary file. Reduces the peak memory consumption "
+        "when slicing large objects.");
+
+    def = this->add("server", coInt);
+    def->label = L("Run as a slicing server");
+    def->tooltip = L("Keep running and accept slicing jobs at the given TCP port on localhost. Each job is a single line "
+        "with the same parameters as the command line, the server responds with a line containing OK or ERROR. "
+        "The loaded models and the slicing state are kept between the jobs, so a job slicing the same model again "
+        "only recalculates what has changed. The job \"quit\" stops the server.");
+    def->min = 1;
+    def->max = 65535;
+
+    def = this->add("batch", coString);
+    def->label = L("Run a batch of slicing jobs");
+    def->tooltip = L("Execute the slicing jobs listed in the given manifest file in a single process and print a timing summary. "
+        "Each line of the manifest is a job with the same parameters as the command line. Lines starting with \"input:\" "
+        "and \"overlay:\" are combined: each input is sliced with each overlay, the parameters of the overlay following "
+        "the parameters of the input. Lines starting with # are ignored. The configuration files are parsed once for all the jobs.");
+
+    def = this->add("batch_jobs", coInt);
+    def->label = L("Concurrent batch jobs");
+    def->tooltip = L("Number of jobs of a batch (see --batch) sliced concurrently. The jobs share the threads given by --threads.");
+    def->min = 1;
+
+    def = this->add("slice_cache", coString);
+    def->label = L("Slice cache directory");
+    def->tooltip = L("Store slices of the object meshes at the given directory and reuse them when the same object "
+        "is sliced again with the same settings. This is useful when slicing the same models repeatedly.");
+
+    def = this->add("trace", coString);
+    def->label = L("Trace file");
+    def->tooltip = L("Record the time spent in the individual slicing steps by all threads and the memory usage "
+        "at the end of the steps and write it into the given file in the Chrome trace format, to be inspected with chrome://tracing or Perfetto.");
+
     def = this->add("loglevel", coInt);
     def->label = L("Logging level");
     def->tooltip = L("Sets logging sensitivity. 0:fatal, 1:error, 2:warning, 3:info, 4:debug, 5:trace\n"
@@ -48,6 +48,7 @@
 #include <algorithm>
 #include <initializer_list>
 #include <map>
+#include <unordered_map>
 #include <string>
 #include <utility>
 #include <vector>
@@ -180,6 +181,14 @@ enum class LabelObjectsStyle {
     Disabled, Octoprint, Firmware
 };
 
+// Compression of the G-code blocks of binary G-code.
+enum class BinaryGCodeCompression {
+    // Heatshrink compression, small files.
+    Heatshrink,
+    // Only the MeatPack encoding is applied, fast export of larger files.
+    None
+};
+
 enum class PerimeterGeneratorType
 {
     // Classic perimeter generator using Clipper offsets with constant extrusion width.
@@ -263,6 +272,7 @@ CONFIG_OPTION_ENUM_DECLARE_STATIC_MAPS(SLASupportTreeType)
 CONFIG_OPTION_ENUM_DECLARE_STATIC_MAPS(BrimType)
 CONFIG_OPTION_ENUM_DECLARE_STATIC_MAPS(DraftShield)
 CONFIG_OPTION_ENUM_DECLARE_STATIC_MAPS(LabelObjectsStyle)
+CONFIG_OPTION_ENUM_DECLARE_STATIC_MAPS(BinaryGCodeCompression)
 CONFIG_OPTION_ENUM_DECLARE_STATIC_MAPS(GCodeThumbnailsFormat)
 CONFIG_OPTION_ENUM_DECLARE_STATIC_MAPS(ForwardCompatibilitySubstitutionRule)
 CONFIG_OPTION_ENUM_DECLARE_STATIC_MAPS(PerimeterGeneratorType)
@@ -388,8 +398,6 @@ public:
 
     // Overrides ConfigBase::def(). Static configuration definition. Any value stored into this ConfigBase shall have its definition here.
     const ConfigDef*    def() const override { return &print_config_def; }
-    // Reference to the cached list of keys.
-    virtual const t_config_option_keys& keys_ref() const = 0;
 
 protected:
     // Verify whether the opt_key has not been obsoleted or renamed.
@@ -413,7 +421,8 @@ protected:
         }
 
     protected:
-        std::map<std::string, ptrdiff_t>    m_map_name_to_offset;
+        // Hashed, the options are looked up by name by Print::apply(), by the config diffs and by the PlaceholderParser.
+        std::unordered_map<std::string, ptrdiff_t> m_map_name_to_offset;
     };
 
     // Parametrized by the type of the topmost class owning the options.
@@ -809,6 +818,7 @@ PRINT_CONFIG_CLASS_DEFINE(
     ((ConfigOptionString,              before_layer_gcode))
     ((ConfigOptionString,              between_objects_gcode))
     ((ConfigOptionBool,                binary_gcode))
+    ((ConfigOptionEnum<BinaryGCodeCompression>, binary_gcode_compression))
     ((ConfigOptionFloats,              deretract_speed))
     ((ConfigOptionString,              end_gcode))
     ((ConfigOptionStrings,             end_filament_gcode))
@@ -963,6 +973,7 @@ PRINT_CONFIG_CLASS_DERIVED_DEFINE(
     ((ConfigOptionFloats,             nozzle_diameter))
     ((ConfigOptionBool,               only_retract_when_crossing_perimeters))
     ((ConfigOptionBool,               ooze_prevention))
+    ((ConfigOptionBool,               optimize_toolchange_order))
     ((ConfigOptionString,             output_filename_format))
     ((ConfigOptionFloat,              perimeter_acceleration))
     ((ConfigOptionStrings,            post_process))
@@ -10,6 +10,8 @@
 #include <oneapi/tbb/blocked_range.h>
 #include <oneapi/tbb/concurrent_vector.h>
 #include <oneapi/tbb/parallel_for.h>
+#include <oneapi/tbb/parallel_invoke.h>
+#include <oneapi/tbb/task_arena.h>
 #include <boost/log/trivial.hpp>
 #include <algorithm>
 #include <cmath>
@@ -24,6 +26,7 @@
 #include <array>
 #include <initializer_list>
 #include <memory>
+#include <optional>
 #include <cassert>
 #include <cfloat>
 #include <chrono>
@@ -61,10 +64,12 @@
 #include "libslic3r/LayerRegion.hpp"
 #include "libslic3r/Model.hpp"
 #include "libslic3r/MultiMaterialSegmentation.hpp"
+#include "libslic3r/PerimeterGenerator.hpp"
 #include "libslic3r/TriangleSelector.hpp"
 #include "tcbspan/span.hpp"
 #include "libslic3r/Point.hpp"
 #include "libslic3r/InfillAboveBridges.hpp"
+#include "libslic3r/Trace.hpp"
 
 using namespace std::literals;
 
@@ -156,6 +161,13 @@ PrintBase::ApplyStatus PrintObject::set_instances(PrintInstances &&instances)
     return status;
 }
 
+bool PrintObject::prints_model_object(ObjectID model_object_id) const
+{
+    return this->model_object()->id() == model_object_id ||
+        std::any_of(m_instances.begin(), m_instances.end(), [model_object_id](const PrintInstance &instance) {
+            return instance.model_instance->get_object()->id() == model_object_id; });
+}
+
 std::vector<std::reference_wrapper<const PrintRegion>> PrintObject::all_regions() const
 {
     std::vector<std::reference_wrapper<const PrintRegion>> out;
@@ -175,6 +187,7 @@ void PrintObject::make_perimeters()
 
     if (! this->set_started(posPerimeters))
         return;
+    Trace::Span trace_span("posPerimeters", "PrintObject", this->id().id);
 
     m_print->set_status(20, _u8L("Generating perimeters"));
     BOOST_LOG_TRIVIAL(info) << "Generating perimeters..." << log_memory_info();
@@ -262,18 +275,22 @@ void PrintObject::make_perimeters()
     }
 
     BOOST_LOG_TRIVIAL(debug) << "Generating perimeters in parallel - start";
+    // Walls of layers with identical slices are calculated by Arachne just once.
+    PerimeterGenerator::ArachneWallsCache arachne_walls_cache;
+    // Arachne may run for seconds on a single complex layer, let it react to cancellation from inside.
+    const std::function<void()> throw_on_cancel = [this]() { m_print->throw_if_canceled(); };
     tbb::parallel_for(
         tbb::blocked_range<size_t>(0, m_layers.size()),
-        [this](const tbb::blocked_range<size_t>& range) {
+        [this, &arachne_walls_cache, &throw_on_cancel](const tbb::blocked_range<size_t>& range) {
             PRINT_OBJECT_TIME_LIMIT_MILLIS(PRINT_OBJECT_TIME_LIMIT_DEFAULT);
             for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++ layer_idx) {
                 m_print->throw_if_canceled();
-                m_layers[layer_idx]->make_perimeters();
+                m_layers[layer_idx]->make_perimeters(&arachne_walls_cache, throw_on_cancel);
             }
         }
     );
     m_print->throw_if_canceled();
-    BOOST_LOG_TRIVIAL(debug) << "Generating perimeters in parallel - end";
+    BOOST_LOG_TRIVIAL(debug) << "Generating perimeters in parallel - end, Arachne walls reused " << arachne_walls_cache.num_hits() << " times";
 
     this->set_done(posPerimeters);
 }
@@ -282,6 +299,7 @@ void PrintObject::prepare_infill()
 {
     if (! this->set_started(posPrepareInfill))
         return;
+    Trace::Span trace_span("posPrepareInfill", "PrintObject", this->id().id);
 
     m_print->set_status(30, _u8L("Preparing infill"));
 
@@ -436,25 +454,57 @@ void PrintObject::clear_fills()
         layer->clear_fills();
 }
 
+void PrintObject::release_intermediate_data()
+{
+    m_adaptive_fill_octrees = {};
+    m_lightning_generator.reset();
+    seam_placement_cache.reset();
+    for (Layer *layer : m_layers)
+        for (LayerRegion *layerm : layer->regions())
+            layerm->m_raw_slices = {};
+    // The caches are shared with the other PrintObjects of the same ModelObject.
+    if (m_shared_regions != nullptr) {
+        {
+            std::scoped_lock<std::mutex> lock(m_shared_regions->volume_slices_cache.mutex);
+            m_shared_regions->volume_slices_cache.entries.clear();
+        }
+        for (PrintObjectRegions::SegmentationCache *cache : { &m_shared_regions->mm_segmentation_cache, &m_shared_regions->fuzzy_skin_segmentation_cache }) {
+            std::scoped_lock<std::mutex> lock(cache->mutex);
+            cache->entries.clear();
+        }
+    }
+}
+
 void PrintObject::infill()
 {
     // prerequisites
     this->prepare_infill();
 
     if (this->set_started(posInfill)) {
+        Trace::Span trace_span("posInfill", "PrintObject", this->id().id);
         // TRN Status for the Print calculation 
         m_print->set_status(45, _u8L("Making infill"));
         const auto& adaptive_fill_octree = this->m_adaptive_fill_octrees.first;
         const auto& support_fill_octree = this->m_adaptive_fill_octrees.second;
 
+        // Ironing only depends on the surfaces classified by posPrepareInfill, generate it together with the infill of each layer
+        // to save a pass over the layers. It is appended to the fills by posIroning, which is always invalidated with posInfill.
+        const bool generate_ironing = std::any_of(m_shared_regions->all_regions.begin(), m_shared_regions->all_regions.end(),
+            [](const std::unique_ptr<PrintRegion> &region) { return region->config().ironing.value; });
+        m_ironing_fills.clear();
+        if (generate_ironing)
+            m_ironing_fills.assign(m_layers.size(), {});
+
         BOOST_LOG_TRIVIAL(debug) << "Filling layers in parallel - start";
         tbb::parallel_for(
             tbb::blocked_range<size_t>(0, m_layers.size()),
-            [this, &adaptive_fill_octree = adaptive_fill_octree, &support_fill_octree = support_fill_octree](const tbb::blocked_range<size_t>& range) {
+            [this, generate_ironing, &adaptive_fill_octree = adaptive_fill_octree, &support_fill_octree = support_fill_octree](const tbb::blocked_range<size_t>& range) {
                 PRINT_OBJECT_TIME_LIMIT_MILLIS(PRINT_OBJECT_TIME_LIMIT_DEFAULT);
                 for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++ layer_idx) {
                     m_print->throw_if_canceled();
                     m_layers[layer_idx]->make_fills(adaptive_fill_octree.get(), support_fill_octree.get(), this->m_lightning_generator.get());
+                    if (generate_ironing)
+                        m_ironing_fills[layer_idx] = m_layers[layer_idx]->generate_ironing();
                 }
             }
         );
@@ -470,18 +520,25 @@ void PrintObject::infill()
 void PrintObject::ironing()
 {
     if (this->set_started(posIroning)) {
+        Trace::Span trace_span("posIroning", "PrintObject", this->id().id);
         BOOST_LOG_TRIVIAL(debug) << "Ironing in parallel - start";
-        tbb::parallel_for(
-            // Ironing starting with layer 0 to support ironing all surfaces.
-            tbb::blocked_range<size_t>(0, m_layers.size()),
-            [this](const tbb::blocked_range<size_t>& range) {
-                PRINT_OBJECT_TIME_LIMIT_MILLIS(PRINT_OBJECT_TIME_LIMIT_DEFAULT);
-                for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++ layer_idx) {
-                    m_print->throw_if_canceled();
-                    m_layers[layer_idx]->make_ironing();
+        // The ironing was generated by posInfill together with the infill, unless no region is ironed.
+        // Otherwise (the processing was canceled in between) generate it now.
+        const bool generated = m_ironing_fills.size() == m_layers.size();
+        if (generated || std::any_of(m_shared_regions->all_regions.begin(), m_shared_regions->all_regions.end(),
+                [](const std::unique_ptr<PrintRegion> &region) { return region->config().ironing.value; }))
+            tbb::parallel_for(
+                // Ironing starting with layer 0 to support ironing all surfaces.
+                tbb::blocked_range<size_t>(0, m_layers.size()),
+                [this, generated](const tbb::blocked_range<size_t>& range) {
+                    PRINT_OBJECT_TIME_LIMIT_MILLIS(PRINT_OBJECT_TIME_LIMIT_DEFAULT);
+                    for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++ layer_idx) {
+                        m_print->throw_if_canceled();
+                        m_layers[layer_idx]->apply_ironing(generated ? std::move(m_ironing_fills[layer_idx]) : m_layers[layer_idx]->generate_ironing());
+                    }
                 }
-            }
-        );
+            );
+        m_ironing_fills.clear();
         m_print->throw_if_canceled();
         BOOST_LOG_TRIVIAL(debug) << "Ironing in parallel - end";
         this->set_done(posIroning);
@@ -491,6 +548,7 @@ void PrintObject::ironing()
 void PrintObject::generate_support_spots()
 {
     if (this->set_started(posSupportSpotsSearch)) {
+        Trace::Span trace_span("posSupportSpotsSearch", "PrintObject", this->id().id);
         BOOST_LOG_TRIVIAL(debug) << "Searching support spots - start";
         m_print->set_status(65, _u8L("Searching support spots"));
         if (!this->shared_regions()->generated_support_points.has_value()) {
@@ -515,6 +573,7 @@ void PrintObject::generate_support_spots()
 void PrintObject::generate_support_material()
 {
     if (this->set_started(posSupportMaterial)) {
+        Trace::Span trace_span("posSupportMaterial", "PrintObject", this->id().id);
         this->clear_support_layers();
         if ((this->has_support() && m_layers.size() > 1) || (this->has_raft() && ! m_layers.empty())) {
             m_print->set_status(70, _u8L("Generating support material"));    
@@ -533,9 +592,29 @@ void PrintObject::generate_support_material()
     }
 }
 
+void PrintObject::copy_support_material(const PrintObject &src)
+{
+    if (this->set_started(posSupportMaterial)) {
+        Trace::Span trace_span("posSupportMaterial", "PrintObject", this->id().id);
+        assert(src.is_step_done(posSupportMaterial));
+        this->clear_support_layers();
+        m_support_layers.reserve(src.support_layer_count());
+        for (const SupportLayer *src_layer : src.support_layers()) {
+            SupportLayer *layer = *this->insert_support_layer(m_support_layers.end(), src_layer->id(), src_layer->interface_id(), 
+                src_layer->height, src_layer->print_z, src_layer->slice_z);
+            layer->support_islands        = src_layer->support_islands;
+            layer->support_islands_bboxes = src_layer->support_islands_bboxes;
+            layer->support_fills          = src_layer->support_fills;
+        }
+        m_print->throw_if_canceled();
+        this->set_done(posSupportMaterial);
+    }
+}
+
 void PrintObject::estimate_curled_extrusions()
 {
     if (this->set_started(posEstimateCurledExtrusions)) {
+        Trace::Span trace_span("posEstimateCurledExtrusions", "PrintObject", this->id().id);
         if (this->print()->config().avoid_crossing_curled_overhangs ||
             std::any_of(this->print()->m_print_regions.begin(), this->print()->m_print_regions.end(),
                         [](const PrintRegion *region) { return region->config().enable_dynamic_overhang_speeds.getBool(); })) {
@@ -560,6 +639,7 @@ void PrintObject::estimate_curled_extrusions()
 void PrintObject::calculate_overhanging_perimeters()
 {
     if (this->set_started(posCalculateOverhangingPerimeters)) {
+        Trace::Span trace_span("posCalculateOverhangingPerimeters", "PrintObject", this->id().id);
         BOOST_LOG_TRIVIAL(debug) << "Calculating overhanging perimeters - start";
         m_print->set_status(89, _u8L("Calculating overhanging perimeters"));
         std::vector<unsigned int>               extruders;
@@ -578,33 +658,29 @@ void PrintObject::calculate_overhanging_perimeters()
         }
 
         if (!regions_with_dynamic_speeds.empty()) {
-            std::unordered_map<size_t, AABBTreeLines::LinesDistancer<CurledLine>> curled_lines;
-            std::unordered_map<size_t, AABBTreeLines::LinesDistancer<Linef>>      unscaled_polygons_lines;
-            for (const Layer *l : this->layers()) {
-                curled_lines[l->id()]            = AABBTreeLines::LinesDistancer<CurledLine>{l->curled_lines};
-                unscaled_polygons_lines[l->id()] = AABBTreeLines::LinesDistancer<Linef>{to_unscaled_linesf(l->lslices)};
-            }
-            curled_lines[size_t(-1)]            = {};
-            unscaled_polygons_lines[size_t(-1)] = {};
-
-            tbb::parallel_for(tbb::blocked_range<size_t>(0, m_layers.size()), [this, &curled_lines, &unscaled_polygons_lines,
-                                                                               &regions_with_dynamic_speeds](
+            // The distancers of the lower layers' boundaries are owned by the layers and shared with the support spots search
+            // and with the estimation of the curled extrusions, see Layer::lslices_distancer().
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, m_layers.size()), [this, &regions_with_dynamic_speeds](
                                                                                   const tbb::blocked_range<size_t> &range) {
                 PRINT_OBJECT_TIME_LIMIT_MILLIS(PRINT_OBJECT_TIME_LIMIT_DEFAULT);
+                const AABBTreeLines::LinesDistancer<Linef> no_lower_layer;
                 for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++layer_idx) {
                     auto l = m_layers[layer_idx];
                     if (l->id() == 0) { // first layer, do not split
                         continue;
                     }
+                    const AABBTreeLines::LinesDistancer<Linef> &unscaled_prev_layer = l->lower_layer ? l->lower_layer->lslices_distancer() : no_lower_layer;
+                    // The curled lines are only queried by the extrusions of this layer.
+                    std::optional<AABBTreeLines::LinesDistancer<CurledLine>> curled_lines;
                     for (LayerRegion *layer_region : l->regions()) {
                         if (regions_with_dynamic_speeds.find(layer_region->m_region) == regions_with_dynamic_speeds.end()) {
                             continue;
                         }
-                        size_t prev_layer_id = l->lower_layer ? l->lower_layer->id() : size_t(-1);
+                        if (! curled_lines)
+                            curled_lines.emplace(l->curled_lines);
                         layer_region->m_perimeters =
                             ExtrusionProcessor::calculate_and_split_overhanging_extrusions(&layer_region->m_perimeters,
-                                                                                           unscaled_polygons_lines[prev_layer_id],
-                                                                                           curled_lines[l->id()]);
+                                                                                           unscaled_prev_layer, *curled_lines);
                     }
                 }
             });
@@ -649,9 +725,12 @@ std::pair<FillAdaptive::OctreePtr, FillAdaptive::OctreePtr> PrintObject::prepare
     for (size_t i = 1; i < overhangs.size(); ++ i)
         append(overhangs.front(), std::move(overhangs[i]));
 
-    return std::make_pair(
-        adaptive_line_spacing ? build_octree(mesh, overhangs.front(), adaptive_line_spacing, false) : OctreePtr(),
-        support_line_spacing  ? build_octree(mesh, overhangs.front(), support_line_spacing, true) : OctreePtr());
+    // The adaptive cubic and the support cubic octrees are independent, build them in parallel.
+    std::pair<OctreePtr, OctreePtr> octrees;
+    tbb::parallel_invoke(
+        [&]() { if (adaptive_line_spacing) octrees.first  = build_octree(mesh, overhangs.front(), adaptive_line_spacing, false); },
+        [&]() { if (support_line_spacing)  octrees.second = build_octree(mesh, overhangs.front(), support_line_spacing, true); });
+    return octrees;
 }
 
 FillLightning::GeneratorPtr PrintObject::prepare_lightning_infill_data()
@@ -974,6 +1053,7 @@ bool PrintObject::invalidate_step(PrintObjectStep step)
                                                posSupportMaterial, posEstimateCurledExtrusions, posCalculateOverhangingPerimeters});
         invalidated |= m_print->invalidate_steps({ psSkirtBrim });
         m_slicing_params.valid = false;
+        std::atomic_store(&m_coarse_preview, std::shared_ptr<const CoarsePreview>());
     } else if (step == posSupportMaterial) {
         invalidated |= m_print->invalidate_steps({ psSkirtBrim,  });
         invalidated |= this->invalidate_steps({ posEstimateCurledExtrusions });
@@ -997,6 +1077,7 @@ bool PrintObject::invalidate_all_steps()
     bool result = Inherited::invalidate_all_steps() | m_print->invalidate_all_steps();
 	// Then reset some of the depending values.
 	m_slicing_params.valid = false;
+    std::atomic_store(&m_coarse_preview, std::shared_ptr<const CoarsePreview>());
 	return result;
 }
 
@@ -1327,6 +1408,52 @@ void PrintObject::process_external_surfaces()
     }
 } // void PrintObject::process_external_surfaces()
 
+// Polygons of layers combined over ranges of layers by an idempotent operation (union or intersection).
+// The polygons of the runs of 2^k consecutive layers are combined up front (a sparse table), then any range
+// is answered by combining two possibly overlapping runs covering it, instead of combining all its layers one by one.
+class LayerRangesCombination
+{
+public:
+    using Combine = std::function<Polygons(const Polygons&, const Polygons&)>;
+
+    // layer_polygons(idx) returns the polygons of a single layer, the reference shall be valid for the life time of this object.
+    // Ranges up to max_range_length layers will be queried.
+    LayerRangesCombination(size_t num_layers, size_t max_range_length, std::function<const Polygons&(size_t)> layer_polygons, Combine combine) :
+        m_layer_polygons(std::move(layer_polygons)), m_combine(std::move(combine))
+    {
+        for (size_t run = 2; run <= std::min(max_range_length, num_layers); run *= 2) {
+            // Runs of this level, composed of two runs of the level below.
+            std::vector<Polygons> &level = m_levels.emplace_back(num_layers - run + 1);
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, level.size()), [this, run](const tbb::blocked_range<size_t> &range) {
+                for (size_t i = range.begin(); i < range.end(); ++ i)
+                    m_levels.back()[i] = m_combine(this->run_polygons(int(m_levels.size()) - 2, i), this->run_polygons(int(m_levels.size()) - 2, i + run / 2));
+            });
+        }
+    }
+
+    // Polygons of the layers first to last, both inclusive, combined.
+    Polygons combined(size_t first, size_t last) const
+    {
+        assert(first <= last);
+        size_t num_layers = last - first + 1;
+        // Level of the longest run not longer than the range.
+        int    level      = -1;
+        for (size_t run = 2; run <= num_layers; run *= 2)
+            ++ level;
+        assert(level < int(m_levels.size()));
+        const size_t run = size_t(1) << (level + 1);
+        return run == num_layers ? this->run_polygons(level, first) : m_combine(this->run_polygons(level, first), this->run_polygons(level, last + 1 - run));
+    }
+
+private:
+    // level -1 are the layers themselves.
+    const Polygons& run_polygons(int level, size_t first) const { return level < 0 ? m_layer_polygons(first) : m_levels[level][first]; }
+
+    std::function<const Polygons&(size_t)> m_layer_polygons;
+    Combine                                m_combine;
+    std::vector<std::vector<Polygons>>     m_levels;
+};
+
 void PrintObject::discover_vertical_shells()
 {
     BOOST_LOG_TRIVIAL(info) << "Discovering vertical shells..." << log_memory_info();
@@ -1474,11 +1601,54 @@ void PrintObject::discover_vertical_shells()
             BOOST_LOG_TRIVIAL(debug) << "Discovering vertical shells for region " << region_id << " in parallel - end : cache top / bottom";
         }
 
+        // Ranges of the layers, whose top resp. bottom surfaces are projected to a layer: top surfaces of layers (idx_layer, top_end),
+        // bottom surfaces of layers (bottom_end, idx_layer). The ranges are overlapping for the neighbor layers, the shells and holes
+        // over the ranges are combined from the unions resp. intersections of runs of layers precalculated by LayerRangesCombination.
+        struct ProjectedLayers {
+            int top_end;
+            int bottom_end;
+        };
+        std::vector<ProjectedLayers> projected_layers(num_layers);
+        size_t                       max_projected_layers = 1;
+        {
+            const PrintRegionConfig &region_config = region.config();
+            for (int idx_layer = 0; idx_layer < int(num_layers); ++ idx_layer) {
+                ProjectedLayers &projected = projected_layers[idx_layer];
+                const Layer     &layer     = *m_layers[idx_layer];
+                int              i         = idx_layer + 1;
+                for (int itop = idx_layer + region_config.top_solid_layers.value; i < int(num_layers) &&
+                     (i < itop || m_layers[i]->print_z - layer.print_z < region_config.top_solid_min_thickness - EPSILON); ++ i) ;
+                projected.top_end = i;
+                i = idx_layer - 1;
+                for (int ibottom = idx_layer - region_config.bottom_solid_layers.value; i >= 0 &&
+                     (i > ibottom || layer.bottom_z() - m_layers[i]->bottom_z() < region_config.bottom_solid_min_thickness - EPSILON); -- i) ;
+                projected.bottom_end = i;
+                max_projected_layers = std::max(max_projected_layers, size_t(std::max(projected.top_end - idx_layer - 1, idx_layer - projected.bottom_end - 1)));
+            }
+        }
+        auto union_combine = [](const Polygons &lhs, const Polygons &rhs) {
+            return lhs.empty() ? rhs : rhs.empty() ? lhs : union_(lhs, rhs);
+        };
+        std::optional<LayerRangesCombination> top_shells;
+        std::optional<LayerRangesCombination> bottom_shells;
+        std::optional<LayerRangesCombination> projected_holes;
+        if (region.config().top_solid_layers.value > 0)
+            top_shells.emplace(num_layers, max_projected_layers,
+                [&cache_top_botom_regions](size_t idx) -> const Polygons& { return cache_top_botom_regions[idx].top_surfaces; }, union_combine);
+        if (region.config().bottom_solid_layers.value > 0)
+            bottom_shells.emplace(num_layers, max_projected_layers,
+                [&cache_top_botom_regions](size_t idx) -> const Polygons& { return cache_top_botom_regions[idx].bottom_surfaces; }, union_combine);
+        if (region.config().ensure_vertical_shell_thickness.value != EnsureVerticalShellThickness::Partial)
+            projected_holes.emplace(num_layers, max_projected_layers,
+                [&cache_top_botom_regions](size_t idx) -> const Polygons& { return cache_top_botom_regions[idx].holes; },
+                [](const Polygons &lhs, const Polygons &rhs) { return lhs.empty() || rhs.empty() ? Polygons() : intersection(lhs, rhs); });
+        m_print->throw_if_canceled();
+
         BOOST_LOG_TRIVIAL(debug) << "Discovering vertical shells for region " << region_id << " in parallel - start : ensure vertical wall thickness";
         grain_size = 1;
         tbb::parallel_for(
             tbb::blocked_range<size_t>(0, num_layers, grain_size),
-            [this, region_id, &cache_top_botom_regions]
+            [this, region_id, &cache_top_botom_regions, &projected_layers, &top_shells, &bottom_shells, &projected_holes]
             (const tbb::blocked_range<size_t>& range) {
                 PRINT_OBJECT_TIME_LIMIT_MILLIS(PRINT_OBJECT_TIME_LIMIT_DEFAULT);
                 // printf("discover_vertical_shells from %d to %d\n", range.begin(), range.end());
@@ -1546,25 +1716,14 @@ void PrintObject::discover_vertical_shells()
                             shell = union_(shell);
                         }
                     };
-                    static constexpr const bool one_more_layer_below_top_bottom_surfaces = false;
+                    const ProjectedLayers &projected = projected_layers[idx_layer];
 			        if (int n_top_layers = region_config.top_solid_layers.value; n_top_layers > 0) {
                         // Gather top regions projected to this layer.
-                        coordf_t print_z = layer->print_z;
-                        int i = int(idx_layer) + 1;
-                        int itop = int(idx_layer) + n_top_layers;
-                        bool at_least_one_top_projected = false;
-	                    for (; i < int(cache_top_botom_regions.size()) &&
-	                         (i < itop || m_layers[i]->print_z - print_z < region_config.top_solid_min_thickness - EPSILON);
-	                        ++ i) {
-                            at_least_one_top_projected = true;
-	                        const DiscoverVerticalShellsCacheEntry &cache = cache_top_botom_regions[i];
-                            if (region_config.ensure_vertical_shell_thickness.value != EnsureVerticalShellThickness::Partial) {
-                                combine_holes(cache.holes);
-                            }
-
-                            combine_shells(cache.top_surfaces);
-	                    }
-                        if (!at_least_one_top_projected && i < int(cache_top_botom_regions.size())) {
+                        if (int i = projected.top_end; i > int(idx_layer) + 1) {
+                            if (projected_holes)
+                                combine_holes(projected_holes->combined(idx_layer + 1, i - 1));
+                            combine_shells(top_shells->combined(idx_layer + 1, i - 1));
+                        } else if (i < int(cache_top_botom_regions.size())) {
                             // Lets consider this a special case - with only 1 top solid and minimal shell thickness settings, the
                             // boundaries of solid layers are not anchored over/under perimeters, so lets fix it by adding at least one
                             // perimeter width of area
@@ -1573,41 +1732,19 @@ void PrintObject::discover_vertical_shells()
                                                                 to_polygons(m_layers[i]->lslices));
                             combine_shells(anchor_area);
                         }
-
-                        if (one_more_layer_below_top_bottom_surfaces)
-                            if (i < int(cache_top_botom_regions.size()) &&
-                                (i <= itop || m_layers[i]->bottom_z() - print_z < region_config.top_solid_min_thickness - EPSILON))
-                                combine_holes(cache_top_botom_regions[i].holes);
 	                }
 	                if (int n_bottom_layers = region_config.bottom_solid_layers.value; n_bottom_layers > 0) {
                         // Gather bottom regions projected to this layer.
-                        coordf_t bottom_z = layer->bottom_z();
-                        int i = int(idx_layer) - 1;
-                        int ibottom = int(idx_layer) - n_bottom_layers;
-                        bool at_least_one_bottom_projected = false;
-	                    for (; i >= 0 &&
-	                         (i > ibottom || bottom_z - m_layers[i]->bottom_z() < region_config.bottom_solid_min_thickness - EPSILON);
-	                        -- i) {
-                                at_least_one_bottom_projected = true;
-	                        const DiscoverVerticalShellsCacheEntry &cache = cache_top_botom_regions[i];
-                            if (region_config.ensure_vertical_shell_thickness.value != EnsureVerticalShellThickness::Partial) {
-                                combine_holes(cache.holes);
-                            }
-
-                            combine_shells(cache.bottom_surfaces);
-	                    }
-
-                        if (!at_least_one_bottom_projected && i >= 0) {
+                        if (int i = projected.bottom_end; i < int(idx_layer) - 1) {
+                            if (projected_holes)
+                                combine_holes(projected_holes->combined(i + 1, idx_layer - 1));
+                            combine_shells(bottom_shells->combined(i + 1, idx_layer - 1));
+                        } else if (i >= 0) {
                             Polygons anchor_area = intersection(expand(cache_top_botom_regions[idx_layer].bottom_surfaces,
                                                                        layerm->flow(frExternalPerimeter).scaled_spacing()),
                                                                 to_polygons(m_layers[i]->lslices));
                             combine_shells(anchor_area);
                         }
-
-                        if (one_more_layer_below_top_bottom_surfaces)
-                            if (i >= 0 &&
-                                (i > ibottom || bottom_z - m_layers[i]->print_z < region_config.bottom_solid_min_thickness - EPSILON))
-                                combine_holes(cache_top_botom_regions[i].holes);
 	                }
 #ifdef SLIC3R_DEBUG_SLICE_PROCESSING
                     {
@@ -3400,21 +3537,47 @@ static void project_triangles_to_slabs(SpanOfConstPtrs<Layer> layers, const inde
     // Make sure that the output vector can be used.
     out.resize(layers.size());
 
-    // Now append the collected polygons to respective layers.
-    for (auto& trg : projections_of_triangles) {
-        int layer_id = int(trg.first_layer_id);
-        for (LightPolygon &poly : trg.polygons) {
-            if (layer_id >= int(out.size()))
-                break; // part of triangle could be projected above top layer
-            assert(! poly.pts.empty());
-            // The resulting triangles are fed to the Clipper library, which seem to handle flipped triangles well.
-//                if (cross2(Vec2d((poly.pts[1] - poly.pts[0]).cast<double>()), Vec2d((poly.pts[2] - poly.pts[1]).cast<double>())) < 0)
-//                    std::swap(poly.pts.front(), poly.pts.back());
-                
-            out[layer_id].emplace_back(std::move(poly.pts));
-            ++layer_id;
+    // Now bin the collected polygons by layers. Each chunk of triangles is binned into its own buckets in parallel,
+    // the buckets are then appended to respective layers in the order of the chunks, thus the result does not depend on scheduling.
+    const size_t num_chunks = std::min(projections_of_triangles.size(), size_t(4 * tbb::this_task_arena::max_concurrency()));
+    const size_t chunk_size = (projections_of_triangles.size() + num_chunks - 1) / num_chunks;
+    std::vector<std::vector<Polygons>> buckets(num_chunks);
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, num_chunks),
+        [&projections_of_triangles, &buckets, chunk_size, num_layers = out.size()](const tbb::blocked_range<size_t>& range) {
+        for (size_t chunk_idx = range.begin(); chunk_idx < range.end(); ++ chunk_idx) {
+            std::vector<Polygons> &bucket = buckets[chunk_idx];
+            bucket.resize(num_layers);
+            for (size_t idx = chunk_idx * chunk_size; idx < std::min((chunk_idx + 1) * chunk_size, projections_of_triangles.size()); ++ idx) {
+                TriangleProjections &trg = projections_of_triangles[idx];
+                size_t layer_id = trg.first_layer_id;
+                for (LightPolygon &poly : trg.polygons) {
+                    if (layer_id >= num_layers)
+                        break; // part of triangle could be projected above top layer
+                    assert(! poly.pts.empty());
+                    // The resulting triangles are fed to the Clipper library, which seem to handle flipped triangles well.
+//                    if (cross2(Vec2d((poly.pts[1] - poly.pts[0]).cast<double>()), Vec2d((poly.pts[2] - poly.pts[1]).cast<double>())) < 0)
+//                        std::swap(poly.pts.front(), poly.pts.back());
+
+                    bucket[layer_id].emplace_back(std::move(poly.pts));
+                    ++ layer_id;
+                }
+            }
         }
-    }
+    }); // end of parallel_for
+
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, out.size()),
+        [&buckets, &out](const tbb::blocked_range<size_t>& range) {
+        for (size_t layer_id = range.begin(); layer_id < range.end(); ++ layer_id) {
+            size_t num_polygons = out[layer_id].size();
+            for (const std::vector<Polygons> &bucket : buckets)
+                num_polygons += bucket[layer_id].size();
+            out[layer_id].reserve(num_polygons);
+            for (std::vector<Polygons> &bucket : buckets)
+                append(out[layer_id], std::move(bucket[layer_id]));
+        }
+    }); // end of parallel_for
 }
 
 void PrintObject::project_and_append_custom_facets(
@@ -3440,8 +3603,10 @@ void PrintObject::project_and_append_custom_facets(
                     if (out.empty())
                         out = std::move(projected);
                     else
-                        for (size_t i = 0; i < out.size(); ++ i)
-                            append(out[i], std::move(projected[i]));
+                        tbb::parallel_for(tbb::blocked_range<size_t>(0, out.size()), [&out, &projected](const tbb::blocked_range<size_t> &range) {
+                            for (size_t i = range.begin(); i < range.end(); ++ i)
+                                append(out[i], std::move(projected[i]));
+                        });
                 }
             }
         }
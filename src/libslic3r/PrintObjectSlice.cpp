@@ -34,9 +34,11 @@
 #include "libslic3r/Polygon.hpp"
 #include "libslic3r/PrintBase.hpp"
 #include "libslic3r/PrintConfig.hpp"
+#include "libslic3r/SliceCache.hpp"
 #include "libslic3r/Slicing.hpp"
 #include "libslic3r/Surface.hpp"
 #include "libslic3r/TriangleMesh.hpp"
+#include "libslic3r/Trace.hpp"
 #include "libslic3r/TriangleMeshSlicer.hpp"
 #include "libslic3r/Utils.hpp"
 #include "libslic3r/libslic3r.h"
@@ -69,24 +71,57 @@ LayerPtrs new_layers(
     return out;
 }
 
+static inline bool mesh_slicing_params_equal(const MeshSlicingParamsEx &l, const MeshSlicingParamsEx &r)
+{
+    return l.mode == r.mode && l.slicing_mode_normal_below_layer == r.slicing_mode_normal_below_layer && l.mode_below == r.mode_below &&
+           l.trafo.matrix() == r.trafo.matrix() && l.closing_radius == r.closing_radius && l.extra_offset == r.extra_offset && l.resolution == r.resolution;
+}
+
 // Slice single triangle mesh.
 static std::vector<ExPolygons> slice_volume(
-    const ModelVolume             &volume,
-    const std::vector<float>      &zs, 
-    const MeshSlicingParamsEx     &params,
-    const std::function<void()>   &throw_on_cancel_callback)
+    const ModelVolume                       &volume,
+    const std::vector<float>                &zs, 
+    const MeshSlicingParamsEx               &params,
+    PrintObjectRegions::VolumeSlicesCache   &cache,
+    const std::function<void()>             &throw_on_cancel_callback)
 {
     std::vector<ExPolygons> layers;
     if (! zs.empty()) {
-        indexed_triangle_set its = volume.mesh().its;
+        MeshSlicingParamsEx params2 { params };
+        params2.trafo = params2.trafo * volume.get_matrix();
+        std::shared_ptr<const TriangleMesh> mesh = volume.mesh_ptr();
+        {
+            // Reuse the slices of the previous slicing run if just the layer ranges or some other parameters
+            // not affecting slicing of this volume have changed.
+            std::scoped_lock lock(cache.mutex);
+            if (auto it = std::find_if(cache.entries.begin(), cache.entries.end(), [&mesh, &zs, &params2](const auto &entry) 
+                    { return entry.mesh == mesh && entry.zs == zs && mesh_slicing_params_equal(entry.params, params2); });
+                it != cache.entries.end()) {
+                it->last_used = ++ cache.timestamp;
+                return it->slices;
+            }
+        }
+        indexed_triangle_set its = mesh->its;
         if (its.indices.size() > 0) {
-            MeshSlicingParamsEx params2 { params };
-            params2.trafo = params2.trafo * volume.get_matrix();
             if (params2.trafo.rotation().determinant() < 0.)
                 its_flip_triangles(its);
-            layers = slice_mesh_ex(its, zs, params2, throw_on_cancel_callback);
+            if (SliceCache::enabled()) {
+                // Opt-in persistent cache, the key is a hash of the mesh, of its transformation and of the slicing parameters.
+                std::string key = SliceCache::make_key(its, zs, params2);
+                if (! SliceCache::load(key, layers) || layers.size() != zs.size()) {
+                    layers = slice_mesh_ex(its, zs, params2, throw_on_cancel_callback);
+                    throw_on_cancel_callback();
+                    SliceCache::store(key, layers);
+                }
+            } else
+                layers = slice_mesh_ex(its, zs, params2, throw_on_cancel_callback);
             throw_on_cancel_callback();
         }
+        std::scoped_lock lock(cache.mutex);
+        if (! cache.entries.empty() && cache.entries.size() >= cache.max_entries)
+            cache.entries.erase(std::min_element(cache.entries.begin(), cache.entries.end(), 
+                [](const auto &l, const auto &r) { return l.last_used < r.last_used; }));
+        cache.entries.push_back({ std::move(mesh), params2, zs, layers, ++ cache.timestamp });
     }
     return layers;
 }
@@ -98,13 +133,14 @@ static std::vector<ExPolygons> slice_volume(
     const std::vector<float>                    &z,
     const std::vector<t_layer_height_range>     &ranges,
     const MeshSlicingParamsEx                   &params,
+    PrintObjectRegions::VolumeSlicesCache       &cache,
     const std::function<void()>                 &throw_on_cancel_callback)
 {
     std::vector<ExPolygons> out;
     if (! z.empty() && ! ranges.empty()) {
         if (ranges.size() == 1 && z.front() >= ranges.front().first && z.back() < ranges.front().second) {
             // All layers fit into a single range.
-            out = slice_volume(volume, z, params, throw_on_cancel_callback);
+            out = slice_volume(volume, z, params, cache, throw_on_cancel_callback);
         } else {
             std::vector<float>                     z_filtered;
             std::vector<std::pair<size_t, size_t>> n_filtered;
@@ -120,7 +156,7 @@ static std::vector<ExPolygons> slice_volume(
                     n_filtered.emplace_back(std::make_pair(first, i));
             }
             if (! n_filtered.empty()) {
-                std::vector<ExPolygons> layers = slice_volume(volume, z_filtered, params, throw_on_cancel_callback);
+                std::vector<ExPolygons> layers = slice_volume(volume, z_filtered, params, cache, throw_on_cancel_callback);
                 out.assign(z.size(), ExPolygons());
                 i = 0;
                 for (const std::pair<size_t, size_t> &span : n_filtered)
@@ -155,16 +191,12 @@ static std::vector<VolumeSlices> slice_volumes_inner(
     ModelVolumePtrs                                           model_volumes,
     const std::vector<PrintObjectRegions::LayerRangeRegions> &layer_ranges,
     const std::vector<float>                                 &zs,
+    PrintObjectRegions::VolumeSlicesCache                    &cache,
     const std::function<void()>                              &throw_on_cancel_callback)
 {
     model_volumes_sort_by_id(model_volumes);
 
     std::vector<VolumeSlices> out;
-    out.reserve(model_volumes.size());
-
-    std::vector<t_layer_height_range> slicing_ranges;
-    if (layer_ranges.size() > 1)
-        slicing_ranges.reserve(layer_ranges.size());
 
     MeshSlicingParamsEx params_base;
     params_base.closing_radius = print_object_config.slice_closing_radius.value;
@@ -184,6 +216,16 @@ static std::vector<VolumeSlices> slice_volumes_inner(
     const bool   is_mm_painted = num_extruders > 1 && std::any_of(model_volumes.cbegin(), model_volumes.cend(), [](const ModelVolume *mv) { return mv->is_mm_painted(); });
     const auto   extra_offset  = is_mm_painted ? 0.f : std::max(0.f, float(print_object_config.xy_size_compensation.value));
 
+    // Collect the slicing tasks first, then slice the volumes in parallel. Each volume is sliced just once,
+    // the region and modifier assignment is derived from the volume slices by slices_to_regions().
+    struct SlicingTask {
+        const ModelVolume                 *model_volume;
+        MeshSlicingParamsEx                params;
+        // Empty if all layers are sliced.
+        std::vector<t_layer_height_range>  ranges;
+    };
+    std::vector<SlicingTask> tasks;
+    tasks.reserve(model_volumes.size());
     for (const ModelVolume *model_volume : model_volumes)
         if (model_volume_needs_slicing(*model_volume)) {
             MeshSlicingParamsEx params { params_base };
@@ -202,27 +244,36 @@ static std::vector<VolumeSlices> slice_volumes_inner(
                         for (; params.slicing_mode_normal_below_layer < zs.size() && zs[params.slicing_mode_normal_below_layer] < region_config.bottom_solid_min_thickness - EPSILON;
                             ++ params.slicing_mode_normal_below_layer);
                     }
-                    out.push_back({
-                        model_volume->id(), 
-                        slice_volume(*model_volume, zs, params, throw_on_cancel_callback)
-                    });
+                    tasks.push_back({ model_volume, params, {} });
                 }
             } else {
                 assert(! print_config.spiral_vase);
-                slicing_ranges.clear();
+                std::vector<t_layer_height_range> slicing_ranges;
                 for (const PrintObjectRegions::LayerRangeRegions &layer_range : layer_ranges)
                     if (layer_range.has_volume(model_volume->id()))
                         slicing_ranges.emplace_back(layer_range.layer_height_range);
                 if (! slicing_ranges.empty())
-                    out.push_back({ 
-                        model_volume->id(), 
-                        slice_volume(*model_volume, zs, slicing_ranges, params, throw_on_cancel_callback)
-                    });
+                    tasks.push_back({ model_volume, params, std::move(slicing_ranges) });
             }
-            if (! out.empty() && out.back().slices.empty())
-                out.pop_back();
         }
 
+    // slice_mesh_ex() is parallel over the layers, but the triangles of each volume are transformed and preprocessed serially,
+    // thus objects with many small modifiers benefit from slicing the volumes in parallel. The cache is guarded by its mutex.
+    out.assign(tasks.size(), VolumeSlices());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, tasks.size()),
+        [&tasks, &out, &zs, &cache, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
+            for (size_t task_id = range.begin(); task_id < range.end(); ++ task_id) {
+                const SlicingTask &task = tasks[task_id];
+                out[task_id] = {
+                    task.model_volume->id(),
+                    task.ranges.empty() ?
+                        slice_volume(*task.model_volume, zs, task.params, cache, throw_on_cancel_callback) :
+                        slice_volume(*task.model_volume, zs, task.ranges, task.params, cache, throw_on_cancel_callback)
+                };
+            }
+        });
+    // Keep the volume slices sorted by ModelVolume::id().
+    out.erase(std::remove_if(out.begin(), out.end(), [](const VolumeSlices &vs) { return vs.slices.empty(); }), out.end());
     return out;
 }
 
@@ -528,6 +579,7 @@ void PrintObject::slice()
 {
     if (! this->set_started(posSlice))
         return;
+    Trace::Span trace_span("posSlice", "PrintObject", this->id().id);
     m_print->set_status(10, _u8L("Processing triangulated mesh"));
     std::vector<coordf_t> layer_height_profile;
     this->update_layer_height_profile(*this->model_object(), m_slicing_params, layer_height_profile);
@@ -535,6 +587,7 @@ void PrintObject::slice()
     m_typed_slices = false;
     this->clear_layers();
     m_layers = new_layers(this, generate_object_layers(m_slicing_params, layer_height_profile));
+    this->slice_coarse_preview();
     this->slice_volumes();
     m_print->throw_if_canceled();
 #if 0
@@ -577,6 +630,69 @@ void PrintObject::slice()
     this->set_done(posSlice);
 }
 
+// For very dense meshes, the user would wait for the exact slicing before seeing anything. Slice the model parts
+// at a coarse layer grid first, which is a fraction of the work, and let the UI show the coarse slices in the preview.
+// Negative volumes, modifiers and the XY size compensation are not applied to the coarse slices.
+void PrintObject::slice_coarse_preview()
+{
+    std::atomic_store(&m_coarse_preview, std::shared_ptr<const CoarsePreview>());
+    const size_t max_triangles = m_print->coarse_preview_triangles();
+    if (max_triangles == 0 || m_layers.empty())
+        return;
+    size_t num_triangles = 0;
+    for (const ModelVolume *model_volume : this->model_object()->volumes)
+        if (model_volume->is_model_part())
+            num_triangles += model_volume->mesh().facets_count();
+    if (num_triangles <= max_triangles)
+        return;
+
+    BOOST_LOG_TRIVIAL(debug) << "Slicing coarse preview of " << num_triangles << " triangles";
+    static constexpr const size_t max_preview_layers = 100;
+    const size_t layer_step = (m_layers.size() + max_preview_layers - 1) / max_preview_layers;
+    auto preview = std::make_shared<CoarsePreview>();
+    std::vector<float> zs;
+    for (size_t first = 0; first < m_layers.size(); first += layer_step) {
+        const size_t last = std::min(first + layer_step, m_layers.size()) - 1;
+        preview->print_z.emplace_back(m_layers[last]->print_z);
+        preview->height.emplace_back(m_layers[last]->print_z - m_layers[first]->bottom_z());
+        // Slice in the middle of the preview layer.
+        zs.emplace_back(float(m_layers[(first + last) / 2]->slice_z));
+    }
+    preview->slices.assign(zs.size(), ExPolygons());
+
+    const auto throw_on_cancel_callback = std::function<void()>([this](){ m_print->throw_if_canceled(); });
+    size_t     num_parts                = 0;
+    for (const ModelVolume *model_volume : this->model_object()->volumes)
+        if (model_volume->is_model_part()) {
+            MeshSlicingParamsEx params;
+            params.trafo      = this->trafo_centered() * model_volume->get_matrix();
+            params.resolution = m_print->config().resolution.value;
+            indexed_triangle_set its = model_volume->mesh().its;
+            if (params.trafo.rotation().determinant() < 0.)
+                its_flip_triangles(its);
+            std::vector<ExPolygons> slices = slice_mesh_ex(its, zs, params, throw_on_cancel_callback);
+            for (size_t i = 0; i < slices.size(); ++ i)
+                append(preview->slices[i], std::move(slices[i]));
+            ++ num_parts;
+        }
+    m_print->throw_if_canceled();
+
+    std::vector<double> areas(zs.size(), 0.);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, zs.size()), [&preview, &areas, num_parts](const tbb::blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i < range.end(); ++ i) {
+            if (num_parts > 1)
+                preview->slices[i] = union_ex(preview->slices[i]);
+            for (const ExPolygon &expoly : preview->slices[i])
+                areas[i] += expoly.area();
+        }
+    });
+    for (size_t i = 0; i < zs.size(); ++ i)
+        preview->volume += areas[i] * SCALING_FACTOR * SCALING_FACTOR * preview->height[i];
+
+    std::atomic_store(&m_coarse_preview, std::shared_ptr<const CoarsePreview>(std::move(preview)));
+    m_print->set_status(10, _u8L("Processing triangulated mesh"), PrintBase::SlicingStatus::RELOAD_FFF_PREVIEW);
+}
+
 template<typename ThrowOnCancel>
 void apply_mm_segmentation(PrintObject &print_object, ThrowOnCancel throw_on_cancel)
 {
@@ -866,11 +982,22 @@ void PrintObject::slice_volumes()
             layer->m_regions.emplace_back(new LayerRegion(layer, pr.get()));
     }
 
+    {
+        // Keep the slices of all volumes of all PrintObjects sharing m_shared_regions.
+        PrintObjectRegions::VolumeSlicesCache &cache = m_shared_regions->volume_slices_cache;
+        std::scoped_lock lock(cache.mutex);
+        cache.max_entries = std::max<size_t>(1, m_shared_regions->m_ref_cnt) * this->model_object()->volumes.size();
+    }
+    for (PrintObjectRegions::SegmentationCache *cache : { &m_shared_regions->mm_segmentation_cache, &m_shared_regions->fuzzy_skin_segmentation_cache }) {
+        std::scoped_lock lock(cache->mutex);
+        cache->max_entries = std::max<size_t>(1, m_shared_regions->m_ref_cnt);
+    }
+
     std::vector<float>                   slice_zs      = zs_from_layers(m_layers);
     std::vector<std::vector<ExPolygons>> region_slices = slices_to_regions(this->model_object()->volumes, *m_shared_regions, slice_zs,
         slice_volumes_inner(
             print->config(), this->config(), this->trafo_centered(),
-            this->model_object()->volumes, m_shared_regions->layer_ranges, slice_zs, throw_on_cancel_callback),
+            this->model_object()->volumes, m_shared_regions->layer_ranges, slice_zs, m_shared_regions->volume_slices_cache, throw_on_cancel_callback),
         throw_on_cancel_callback);
 
     for (size_t region_id = 0; region_id < region_slices.size(); ++ region_id) {
@@ -944,6 +1071,7 @@ void PrintObject::slice_volumes()
 	    tbb::parallel_for(
 	        tbb::blocked_range<size_t>(0, m_layers.size()),
 			[this, xy_compensation_scaled, elephant_foot_compensation_scaled, &lslices_1st_layer](const tbb::blocked_range<size_t>& range) {
+				// Only the 1st layer accesses m_elephant_foot_compensation_cache.
 	            for (size_t layer_id = range.begin(); layer_id < range.end(); ++ layer_id) {
 	                m_print->throw_if_canceled();
 	                Layer *layer = m_layers[layer_id];
@@ -964,7 +1092,7 @@ void PrintObject::slice_volumes()
 	                            elfoot -= delta;
 							layerm->m_slices.set(
 								union_ex(
-									Slic3r::elephant_foot_compensation(
+									m_elephant_foot_compensation_cache.compensate(
 										(delta == 0.f) ? lslices_1st_layer : offset_ex(lslices_1st_layer, delta), 
 	                            		layerm->flow(frExternalPerimeter), unscale<double>(elfoot))),
 								stInternal);
@@ -983,7 +1111,7 @@ void PrintObject::slice_volumes()
 	                        static const float eps = float(scale_(m_config.slice_closing_radius.value) * 1.5);
 	                        if (elfoot > 0.f) {
 	                        	lslices_1st_layer = offset_ex(layer->merged(eps), std::min(xy_compensation_scaled, 0.f) - eps);
-								trimming = to_polygons(Slic3r::elephant_foot_compensation(lslices_1st_layer,
+								trimming = to_polygons(m_elephant_foot_compensation_cache.compensate(lslices_1st_layer,
 									layer->m_regions.front()->flow(frExternalPerimeter), unscale<double>(elfoot)));
 	                        } else
 		                        trimming = offset(layer->merged(float(SCALED_EPSILON)), xy_compensation_scaled - float(SCALED_EPSILON));
@@ -1028,7 +1156,7 @@ std::vector<Polygons> PrintObject::slice_support_volumes(const ModelVolumeType m
         params.trafo = this->trafo_centered();
         for (; it_volume != it_volume_end; ++ it_volume)
             if ((*it_volume)->type() == model_volume_type) {
-                std::vector<ExPolygons> slices2 = slice_volume(*(*it_volume), zs, params, throw_on_cancel_callback);
+                std::vector<ExPolygons> slices2 = slice_volume(*(*it_volume), zs, params, m_shared_regions->volume_slices_cache, throw_on_cancel_callback);
                 if (slices.empty()) {
                     slices.reserve(slices2.size());
                     for (ExPolygons &src : slices2)
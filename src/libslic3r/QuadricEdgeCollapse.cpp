@@ -10,9 +10,13 @@
 #include <optional>
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cmath>
 #include <iterator>
 #include <limits>
+#include <mutex>
+#include <numeric>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 #include <cassert>
@@ -149,7 +153,17 @@ namespace QuadricEdgeCollapse {
     void change_neighbors(EdgeInfos &e_infos, VertexInfos &v_infos, uint32_t ti0, uint32_t ti1,
                           uint32_t vi0, uint32_t vi1, uint32_t vi_top0,
                           const Triangle &t1, CopyEdgeInfos& infos, EdgeInfos &e_infos1);
-    void compact(const VertexInfos &v_infos, const TriangleInfos &t_infos, const EdgeInfos &e_infos, indexed_triangle_set &its);
+    // Optionally returns the new indices of the vertices, -1 for the removed ones.
+    void compact(const VertexInfos &v_infos, const TriangleInfos &t_infos, const EdgeInfos &e_infos, indexed_triangle_set &its,
+                 std::vector<uint32_t> *new_vertex_indices = nullptr);
+    // Collapse the edges with the smallest error until the triangle count or the maximal error is reached.
+    // The frozen vertices are neither moved nor removed. Returns the error of the last collapsed edge.
+    float collapse_edges(indexed_triangle_set &its, uint32_t triangle_count, float maximal_error,
+                         const std::vector<bool> *frozen_vertices, std::vector<uint32_t> *new_vertex_indices,
+                         ThrowOnCancel &throw_on_cancel, StatusFn &status_fn);
+    // Decimate spatial blocks of the mesh in parallel, then stitch the blocks by a final serial pass over the whole mesh.
+    float collapse_edges_partitioned(indexed_triangle_set &its, uint32_t triangle_count, float maximal_error,
+                                     ThrowOnCancel &throw_on_cancel, StatusFn &status_fn);
 
 #ifdef EXPENSIVE_DEBUG_CHECKS
     void store_surround(const char *obj_filename, size_t triangle_index, int depth, const indexed_triangle_set &its,
@@ -169,6 +183,12 @@ namespace QuadricEdgeCollapse {
     const int status_set_offsets = 10;
     const int status_calc_errors = 30;
     const int status_create_refs = 10;
+    // maximal count of triangles of a block decimated by a single thread
+    const size_t max_block_triangle_count = 1 << 18;
+    // part of the triangles to be reduced, which is left for the stitching pass
+    const uint32_t stitch_reduction_divider = 10;
+    // part of the progress of the decimation of the blocks
+    const int status_blocks_size = 90; // in percents
     } // namespace QuadricEdgeCollapse
 
 using namespace QuadricEdgeCollapse;
@@ -187,6 +207,42 @@ void Slic3r::its_quadric_edge_collapse(
     if (throw_on_cancel == nullptr) throw_on_cancel = []() {};
     if (status_fn == nullptr) status_fn = [](int) {};
 
+    float last_collapsed_error = collapse_edges(its, triangle_count, maximal_error, nullptr, nullptr, throw_on_cancel, status_fn);
+    if (max_error != nullptr) *max_error = last_collapsed_error;
+}
+
+void Slic3r::its_quadric_edge_collapse_parallel(
+    indexed_triangle_set &    its,
+    uint32_t                  triangle_count,
+    float *                   max_error,
+    std::function<void(void)> throw_on_cancel,
+    std::function<void(int)>  status_fn)
+{
+    // check input
+    if (triangle_count >= its.indices.size()) return;
+    float maximal_error = (max_error == nullptr)? std::numeric_limits<float>::max() : *max_error;
+    if (maximal_error <= 0.f) return;
+    if (throw_on_cancel == nullptr) throw_on_cancel = []() {};
+    if (status_fn == nullptr) status_fn = [](int) {};
+
+    float last_collapsed_error = its.indices.size() > 2 * max_block_triangle_count ?
+        collapse_edges_partitioned(its, triangle_count, maximal_error, throw_on_cancel, status_fn) :
+        collapse_edges(its, triangle_count, maximal_error, nullptr, nullptr, throw_on_cancel, status_fn);
+    if (max_error != nullptr) *max_error = last_collapsed_error;
+}
+
+float QuadricEdgeCollapse::collapse_edges(indexed_triangle_set &its, uint32_t triangle_count, float maximal_error,
+                                          const std::vector<bool> *frozen_vertices, std::vector<uint32_t> *new_vertex_indices,
+                                          ThrowOnCancel &throw_on_cancel, StatusFn &status_fn)
+{
+    if (triangle_count >= its.indices.size()) {
+        if (new_vertex_indices != nullptr) {
+            new_vertex_indices->resize(its.vertices.size());
+            std::iota(new_vertex_indices->begin(), new_vertex_indices->end(), 0);
+        }
+        return 0.f;
+    }
+
     StatusFn init_status_fn = [&](int percent) {
         float n_percent = percent * status_init_size / 100.f;
         status_fn(static_cast<int>(std::round(n_percent)));
@@ -272,6 +328,7 @@ void Slic3r::its_quadric_edge_collapse(
             reorder_edges(e_infos, v_info1, ti0, ti1);
         }
         if (!ti1_opt.has_value() || // edge has only one triangle
+            (frozen_vertices != nullptr && ((*frozen_vertices)[vi0] || (*frozen_vertices)[vi1])) ||
             degenerate(vi0, ti0, ti1, v_info1, e_infos, its.indices) ||
             degenerate(vi1, ti0, ti1, v_info0, e_infos, its.indices) ||
             create_no_volume(vi0, vi1, ti0, ti1, v_info0, v_info1, e_infos, its.indices) ||
@@ -358,8 +415,169 @@ void Slic3r::its_quadric_edge_collapse(
     }
 
     // compact triangle
-    compact(v_infos, t_infos, e_infos, its);
-    if (max_error != nullptr) *max_error = last_collapsed_error;
+    compact(v_infos, t_infos, e_infos, its, new_vertex_indices);
+    return last_collapsed_error;
+}
+
+float QuadricEdgeCollapse::collapse_edges_partitioned(indexed_triangle_set &its, uint32_t triangle_count, float maximal_error,
+                                                      ThrowOnCancel &throw_on_cancel, StatusFn &status_fn)
+{
+    // Split the triangles recursively by their centroids along the longest axis into blocks of at most max_block_triangle_count.
+    // The blocks do not depend on the number of threads, thus neither does the result.
+    std::vector<Vec3f> centroids(its.indices.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, its.indices.size()), [&](const tbb::blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i < range.end(); ++i) {
+            const Triangle &t = its.indices[i];
+            centroids[i] = (its.vertices[t[0]] + its.vertices[t[1]] + its.vertices[t[2]]) / 3.f;
+        }
+    });
+    std::vector<uint32_t> triangles(its.indices.size());
+    std::iota(triangles.begin(), triangles.end(), 0);
+    // Sorted ranges of the triangles of the blocks.
+    std::vector<std::pair<size_t, size_t>> blocks;
+    std::vector<std::pair<size_t, size_t>> to_split{{0, triangles.size()}};
+    while (!to_split.empty()) {
+        auto [begin, end] = to_split.back();
+        to_split.pop_back();
+        if (end - begin <= max_block_triangle_count) {
+            blocks.emplace_back(begin, end);
+            continue;
+        }
+        Vec3f bmin = centroids[triangles[begin]], bmax = bmin;
+        for (size_t i = begin + 1; i < end; ++i) {
+            bmin = bmin.cwiseMin(centroids[triangles[i]]);
+            bmax = bmax.cwiseMax(centroids[triangles[i]]);
+        }
+        int axis;
+        (bmax - bmin).maxCoeff(&axis);
+        size_t mid = (begin + end) / 2;
+        std::nth_element(triangles.begin() + begin, triangles.begin() + mid, triangles.begin() + end,
+            [&centroids, axis](uint32_t l, uint32_t r) { return centroids[l][axis] < centroids[r][axis] || (centroids[l][axis] == centroids[r][axis] && l < r); });
+        to_split.emplace_back(mid, end);
+        to_split.emplace_back(begin, mid);
+    }
+    centroids = {};
+    throw_on_cancel();
+
+    // The vertices shared by the triangles of more blocks are frozen, the other vertices belong to a single block.
+    const uint32_t shared_vertex = uint32_t(-2);
+    std::vector<uint32_t> vertex_block(its.vertices.size(), uint32_t(-1));
+    for (uint32_t block = 0; block < blocks.size(); ++block)
+        for (size_t i = blocks[block].first; i < blocks[block].second; ++i)
+            for (int j = 0; j < 3; ++j) {
+                uint32_t &vb = vertex_block[its.indices[triangles[i]][j]];
+                vb = (vb == uint32_t(-1) || vb == block) ? block : shared_vertex;
+            }
+    // Index of the shared vertices in the stitched mesh, they are stored first, the other vertices block by block.
+    std::vector<uint32_t> stitched_vertex(its.vertices.size(), uint32_t(-1));
+    uint32_t num_shared = 0;
+    for (uint32_t vi = 0; vi < its.vertices.size(); ++vi)
+        if (vertex_block[vi] == shared_vertex)
+            stitched_vertex[vi] = num_shared++;
+
+    // Decimate the blocks in parallel, each to its share of the triangle count, leaving a part of the reduction to the stitching pass.
+    struct Block {
+        indexed_triangle_set its;
+        // Index of the vertices of the decimated block in the stitched mesh, without the offset of the block.
+        std::vector<uint32_t> stitched_vertex;
+        uint32_t              num_own_vertices = 0;
+        float                 last_collapsed_error = 0.f;
+    };
+    std::vector<Block> decimated(blocks.size());
+    // The progress of the blocks is weighted by their triangle count.
+    std::mutex  status_mutex;
+    std::atomic<size_t> processed{0};
+    int         last_status = 0;
+    const size_t total = its.indices.size();
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, blocks.size(), 1), [&](const tbb::blocked_range<size_t> &range) {
+        for (size_t block = range.begin(); block < range.end(); ++block) {
+            auto [begin, end] = blocks[block];
+            Block &out = decimated[block];
+            // Vertices of the block, the global vertex indices of the block vertices and the frozen vertices.
+            std::vector<uint32_t> global_vertex;
+            std::vector<bool>     frozen;
+            std::unordered_map<uint32_t, uint32_t> shared_to_local;
+            std::unordered_map<uint32_t, uint32_t> own_to_local;
+            out.its.indices.reserve(end - begin);
+            for (size_t i = begin; i < end; ++i) {
+                Triangle t = its.indices[triangles[i]];
+                for (int j = 0; j < 3; ++j) {
+                    bool shared = vertex_block[t[j]] == shared_vertex;
+                    auto [it, inserted] = (shared ? shared_to_local : own_to_local).emplace(t[j], uint32_t(global_vertex.size()));
+                    if (inserted) {
+                        global_vertex.emplace_back(t[j]);
+                        frozen.emplace_back(shared);
+                        out.its.vertices.emplace_back(its.vertices[t[j]]);
+                    }
+                    t[j] = it->second;
+                }
+                out.its.indices.emplace_back(t);
+            }
+            const uint32_t block_size = uint32_t(end - begin);
+            const uint32_t share = uint32_t(uint64_t(triangle_count) * block_size / total);
+            const uint32_t block_triangle_count = share + (block_size - share) / stitch_reduction_divider;
+            size_t   block_status = 0;
+            StatusFn block_status_fn = [&](int percent) {
+                size_t status = size_t(percent) * block_size;
+                if (status <= block_status)
+                    return;
+                size_t all    = processed.fetch_add(status - block_status) + status - block_status;
+                block_status  = status;
+                std::lock_guard<std::mutex> lk(status_mutex);
+                int s = int(all * status_blocks_size / (100 * total));
+                if (s > last_status)
+                    status_fn(last_status = s);
+            };
+            std::vector<uint32_t> new_vertex_indices;
+            out.last_collapsed_error = collapse_edges(out.its, block_triangle_count, maximal_error, &frozen, &new_vertex_indices, throw_on_cancel, block_status_fn);
+            out.stitched_vertex.assign(out.its.vertices.size(), 0);
+            for (size_t vi = 0; vi < new_vertex_indices.size(); ++vi)
+                if (uint32_t vi_new = new_vertex_indices[vi]; vi_new != uint32_t(-1))
+                    out.stitched_vertex[vi_new] = frozen[vi] ? stitched_vertex[global_vertex[vi]] : num_shared + out.num_own_vertices++;
+        }
+    });
+    triangles = {};
+    vertex_block = {};
+
+    // Stitch the decimated blocks into a single mesh.
+    float last_collapsed_error = 0.f;
+    {
+        indexed_triangle_set stitched;
+        stitched.vertices.resize(num_shared);
+        for (uint32_t vi = 0; vi < its.vertices.size(); ++vi)
+            if (stitched_vertex[vi] != uint32_t(-1))
+                stitched.vertices[stitched_vertex[vi]] = its.vertices[vi];
+        size_t num_triangles = 0;
+        for (const Block &block : decimated)
+            num_triangles += block.its.indices.size();
+        stitched.indices.reserve(num_triangles);
+        for (Block &block : decimated) {
+            const uint32_t offset = uint32_t(stitched.vertices.size()) - num_shared;
+            for (uint32_t vi = 0; vi < block.its.vertices.size(); ++vi)
+                if (block.stitched_vertex[vi] >= num_shared)
+                    stitched.vertices.emplace_back(block.its.vertices[vi]);
+            for (const Triangle &t : block.its.indices) {
+                Triangle &st = stitched.indices.emplace_back();
+                for (int j = 0; j < 3; ++j) {
+                    uint32_t vi = block.stitched_vertex[t[j]];
+                    st[j] = vi < num_shared ? vi : vi + offset;
+                }
+            }
+            last_collapsed_error = std::max(last_collapsed_error, block.last_collapsed_error);
+            block = {};
+        }
+        its = std::move(stitched);
+    }
+    // The shared vertices of all the decimated triangles may have been removed.
+    its_compactify_vertices(its);
+    throw_on_cancel();
+
+    // The stitching pass collapses also the edges of the block boundaries.
+    StatusFn stitch_status_fn = [&status_fn](int percent) {
+        status_fn(status_blocks_size + percent * (100 - status_blocks_size) / 100);
+    };
+    float stitch_error = collapse_edges(its, triangle_count, maximal_error, nullptr, nullptr, throw_on_cancel, stitch_status_fn);
+    return std::max(last_collapsed_error, stitch_error);
 }
 
 Vec3d QuadricEdgeCollapse::create_normal(const Triangle &triangle,
@@ -852,12 +1070,17 @@ void QuadricEdgeCollapse::change_neighbors(EdgeInfos &     e_infos,
 void QuadricEdgeCollapse::compact(const VertexInfos &   v_infos,
                                   const TriangleInfos & t_infos,
                                   const EdgeInfos &     e_infos,
-                                  indexed_triangle_set &its)
+                                  indexed_triangle_set &its,
+                                  std::vector<uint32_t> *new_vertex_indices)
 {
+    if (new_vertex_indices != nullptr)
+        new_vertex_indices->assign(v_infos.size(), uint32_t(-1));
     uint32_t vi_new = 0;
     for (uint32_t vi = 0; vi < v_infos.size(); ++vi) {
         const VertexInfo &v_info = v_infos[vi];
         if (v_info.is_deleted()) continue; // deleted
+        if (new_vertex_indices != nullptr)
+            (*new_vertex_indices)[vi] = vi_new;
         uint32_t e_info_end = v_info.start + v_info.count;
         for (uint32_t ei = v_info.start; ei < e_info_end; ++ei) { 
             const EdgeInfo &e_info = e_infos[ei];
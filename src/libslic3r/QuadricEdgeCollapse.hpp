@@ -36,6 +36,27 @@ void its_quadric_edge_collapse(
     std::function<void(void)> throw_on_cancel = nullptr,
     std::function<void(int)>  statusfn        = nullptr);
 
+/// <summary>
+/// Simplify mesh by Quadric metric using multiple threads.
+/// Large meshes are split into spatial blocks decimated in parallel with their boundary vertices frozen,
+/// then the blocks are stitched and the whole mesh is decimated by a final serial pass,
+/// which also collapses the edges of the block boundaries. Small meshes are decimated serially.
+/// The blocks do not depend on the number of threads, thus the result is deterministic.
+/// </summary>
+/// <param name="its">IN/OUT triangle mesh to be simplified.</param>
+/// <param name="triangle_count">Wanted triangle count.</param>
+/// <param name="max_error">Maximal Quadric for reduce.
+/// When nullptr then max float is used
+/// Output: Largest last used ErrorValue of the blocks and the final pass</param>
+/// <param name="throw_on_cancel">Could stop process of calculation, called from multiple threads.</param>
+/// <param name="statusfn">Give a feed back to user about progress. Values 1 - 100, called from multiple threads.</param>
+void its_quadric_edge_collapse_parallel(
+    indexed_triangle_set &    its,
+    uint32_t                  triangle_count  = 0,
+    float *                   max_error       = nullptr,
+    std::function<void(void)> throw_on_cancel = nullptr,
+    std::function<void(int)>  statusfn        = nullptr);
+
 } // namespace Slic3r
 #endif // slic3r_quadric_edge_collapse_hpp_
 
@@ -128,7 +128,8 @@ ConcaveHull::ConcaveHull(const Polygons &polys, double mergedist, ThrowOnCancel
 
 ExPolygons ConcaveHull::to_expolygons() const
 {
-    auto ret = reserve_vector<ExPolygon>(m_polys.size());
+    ExPolygons ret;
+    ret.reserve(m_polys.size());
     for (const Polygon &p : m_polys) ret.emplace_back(ExPolygon(p));
     return ret;
 }
@@ -0,0 +1,217 @@
+#include "CoverageRaster.hpp"
+
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace Slic3r { namespace sla {
+
+RasterGrayscaleCoverage::RasterGrayscaleCoverage(const Resolution &res, const PixelDim &pd, const Trafo &trafo, double gamma)
+    : m_resolution(res), m_scale(SCALING_FACTOR, SCALING_FACTOR), m_trafo(trafo)
+{
+    assert(pd.w_mm != 0 && pd.h_mm != 0);
+    if (pd.w_mm != 0 && pd.h_mm != 0) {
+        m_scale.x() /= pd.w_mm;
+        m_scale.y() /= pd.h_mm;
+    }
+    // Same as the gamma tables of agg::rasterizer_scanline_aa, see agg::gamma_power and agg::gamma_threshold.
+    for (size_t i = 0; i < m_gamma.size(); ++ i) {
+        double v = double(i) / 255.;
+        m_gamma[i] = uint8_t(std::lround(255. * (gamma > 0 ? std::pow(v, gamma) : v < 0.5 ? 0. : 1.)));
+    }
+}
+
+Vec2f RasterGrayscaleCoverage::to_pixels(const Point &p) const
+{
+    // The same transformation as AGGRaster::to_path() applies.
+    double x = m_trafo.flipXY ? p.y() * m_scale.y() : p.x() * m_scale.x();
+    double y = m_trafo.flipXY ? p.x() * m_scale.x() : p.y() * m_scale.y();
+    x += m_trafo.center_x * m_scale.x();
+    y += m_trafo.center_y * m_scale.y();
+    if (m_trafo.mirror_x)
+        x = double(m_resolution.width_px) - x;
+    if (m_trafo.mirror_y)
+        y = double(m_resolution.height_px) - y;
+    return { float(x), float(y) };
+}
+
+void RasterGrayscaleCoverage::add_edge(Vec2f a, Vec2f b)
+{
+    if (a.y() == b.y())
+        return;
+    // Split the edge at the left and right borders of the raster. The parts outside the raster are projected onto the border,
+    // where they only contribute their winding to the pixels right of them.
+    const float width = float(m_resolution.width_px);
+    for (float border : { 0.f, width })
+        if ((a.x() < border && b.x() > border) || (a.x() > border && b.x() < border)) {
+            Vec2f split { border, a.y() + (border - a.x()) * (b.y() - a.y()) / (b.x() - a.x()) };
+            add_edge(a, split);
+            add_edge(split, b);
+            return;
+        }
+    a.x() = std::clamp(a.x(), 0.f, width);
+    b.x() = std::clamp(b.x(), 0.f, width);
+    m_edges.push_back({ a, b });
+}
+
+void RasterGrayscaleCoverage::add_polygon(const Polygon &poly)
+{
+    if (poly.size() < 3)
+        return;
+    Vec2f prev = to_pixels(poly.points.back());
+    for (const Point &pt : poly.points) {
+        Vec2f next = to_pixels(pt);
+        add_edge(prev, next);
+        prev = next;
+    }
+}
+
+void RasterGrayscaleCoverage::draw(const ExPolygon &poly)
+{
+    add_polygon(poly.contour);
+    for (const Polygon &hole : poly.holes)
+        add_polygon(hole);
+    m_dirty = true;
+}
+
+// Accumulate the signed area covered by an edge into the pixels of rows <row_begin, row_end), the buffer starting with row_begin.
+// The area of a pixel is accumulated into the pixel itself, the rest of the row height covered by the edge into the next pixel,
+// thus integrating the row from left to right yields the coverage of each pixel with the nonzero winding rule.
+static void accumulate_edge(float *acc, size_t stride, int row_begin, int row_end, float width, Vec2f p0, Vec2f p1)
+{
+    float dir = 1.f;
+    if (p0.y() > p1.y()) {
+        std::swap(p0, p1);
+        dir = -1.f;
+    }
+    const float dxdy      = (p1.x() - p0.x()) / (p1.y() - p0.y());
+    const int   row_first = std::max(row_begin, int(std::floor(p0.y())));
+    const int   row_last  = std::min(row_end, int(std::ceil(p1.y())));
+    for (int row = row_first; row < row_last; ++ row) {
+        const float ya = std::max(float(row), p0.y());
+        const float yb = std::min(float(row + 1), p1.y());
+        const float d  = (yb - ya) * dir;
+        const float xa = p0.x() + (ya - p0.y()) * dxdy;
+        const float xb = p0.x() + (yb - p0.y()) * dxdy;
+        // The edges were clipped to the raster by add_edge(), clamp just the rounding errors.
+        const float x0 = std::clamp(std::min(xa, xb), 0.f, width);
+        const float x1 = std::clamp(std::max(xa, xb), 0.f, width);
+        float      *line    = acc + size_t(row - row_begin) * stride;
+        const float x0floor = std::floor(x0);
+        const int   x0i     = int(x0floor);
+        const float x1ceil  = std::ceil(x1);
+        const int   x1i     = int(x1ceil);
+        if (x1i <= x0i + 1) {
+            // The edge crosses a single pixel of this row.
+            const float xmf = 0.5f * (x0 + x1) - x0floor;
+            line[x0i]     += d - d * xmf;
+            line[x0i + 1] += d * xmf;
+        } else {
+            // The edge crosses multiple pixels of this row, the first and the last only partially.
+            const float s   = 1.f / (x1 - x0);
+            const float x0f = x0 - x0floor;
+            const float a0  = 0.5f * s * (1.f - x0f) * (1.f - x0f);
+            const float x1f = x1 - x1ceil + 1.f;
+            const float am  = 0.5f * s * x1f * x1f;
+            line[x0i] += d * a0;
+            if (x1i == x0i + 2) {
+                line[x0i + 1] += d * (1.f - a0 - am);
+            } else {
+                const float a1 = s * (1.5f - x0f);
+                line[x0i + 1] += d * (a1 - a0);
+                for (int xi = x0i + 2; xi < x1i - 1; ++ xi)
+                    line[xi] += d * s;
+                const float a2 = a1 + float(x1i - x0i - 3) * s;
+                line[x1i - 1] += d * (1.f - a2 - am);
+            }
+            line[x1i] += d * am;
+        }
+    }
+}
+
+void RasterGrayscaleCoverage::render() const
+{
+    if (! m_dirty)
+        return;
+
+    const size_t width     = m_resolution.width_px;
+    const size_t height    = m_resolution.height_px;
+    const size_t num_bands = (height + BandRows - 1) / BandRows;
+    m_buf.assign(m_resolution.pixels(), 0);
+
+    // Sort the edges into the bands of rows they cross.
+    std::vector<size_t> band_idx(num_bands + 1, 0);
+    auto band_range = [num_bands](const Edge &edge) {
+        auto [ymin, ymax] = std::minmax(edge.a.y(), edge.b.y());
+        float first = std::max(0.f, std::floor(ymin / float(BandRows)));
+        float last  = std::min(float(num_bands), std::ceil(ymax / float(BandRows)));
+        return first < last ? std::make_pair(size_t(first), size_t(last)) : std::make_pair(size_t(0), size_t(0));
+    };
+    for (const Edge &edge : m_edges) {
+        auto [first, last] = band_range(edge);
+        for (size_t i = first; i < last; ++ i)
+            ++ band_idx[i + 1];
+    }
+    for (size_t i = 1; i <= num_bands; ++ i)
+        band_idx[i] += band_idx[i - 1];
+    std::vector<const Edge*> band_edges(band_idx.back());
+    {
+        std::vector<size_t> cursor(band_idx.begin(), band_idx.end() - 1);
+        for (const Edge &edge : m_edges) {
+            auto [first, last] = band_range(edge);
+            for (size_t i = first; i < last; ++ i)
+                band_edges[cursor[i] ++] = &edge;
+        }
+    }
+
+    // Accumulate and integrate the bands in parallel, each into its own buffer.
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_bands), [this, width, height, &band_idx, &band_edges](const tbb::blocked_range<size_t> &range) {
+        // One spare pixel for the coverage right of the last pixel, one for the rounding of the edges at the right border.
+        const size_t       stride = width + 2;
+        std::vector<float> acc;
+        for (size_t band = range.begin(); band < range.end(); ++ band) {
+            if (band_idx[band] == band_idx[band + 1])
+                // m_buf is zeroed already.
+                continue;
+            const size_t row_begin = band * BandRows;
+            const size_t row_end   = std::min(height, row_begin + BandRows);
+            // Only the columns spanned by the edges of the band are covered, the polygons being closed.
+            float xmin = float(width);
+            float xmax = 0.f;
+            for (size_t i = band_idx[band]; i < band_idx[band + 1]; ++ i) {
+                const Edge &edge = *band_edges[i];
+                xmin = std::min(xmin, std::min(edge.a.x(), edge.b.x()));
+                xmax = std::max(xmax, std::max(edge.a.x(), edge.b.x()));
+            }
+            const size_t col_begin = size_t(std::floor(xmin));
+            const size_t col_end   = std::min(width, size_t(std::ceil(xmax)) + 1);
+            // The buffer is zeroed after each band for the next band, which likely touches the same columns.
+            acc.resize(BandRows * stride, 0.f);
+            for (size_t i = band_idx[band]; i < band_idx[band + 1]; ++ i)
+                accumulate_edge(acc.data(), stride, int(row_begin), int(row_end), float(width), band_edges[i]->a, band_edges[i]->b);
+            for (size_t row = row_begin; row < row_end; ++ row) {
+                float   *line = acc.data() + (row - row_begin) * stride;
+                uint8_t *dst  = m_buf.data() + row * width;
+                // Integrate the row, then map the coverages to pixels in a separate loop, which vectorizes.
+                for (size_t x = col_begin + 1; x < col_end; ++ x)
+                    line[x] += line[x - 1];
+                for (size_t x = col_begin; x < col_end; ++ x)
+                    dst[x] = m_gamma[uint8_t(std::min(255.f, std::abs(line[x]) * 256.f))];
+                std::fill(line + col_begin, line + std::min(stride, col_end + 2), 0.f);
+            }
+        }
+    });
+
+    m_dirty = false;
+}
+
+EncodedRaster RasterGrayscaleCoverage::encode(RasterEncoder encoder) const
+{
+    this->render();
+    return encoder(m_buf.data(), m_resolution.width_px, m_resolution.height_px, 1);
+}
+
+}} // namespace Slic3r::sla
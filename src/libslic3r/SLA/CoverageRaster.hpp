@@ -0,0 +1,62 @@
+#ifndef SLA_COVERAGERASTER_HPP
+#define SLA_COVERAGERASTER_HPP
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <libslic3r/SLA/RasterBase.hpp>
+#include "libslic3r/ExPolygon.hpp"
+
+namespace Slic3r { namespace sla {
+
+// Anti-aliased grayscale raster computing the exact area coverage of the pixels by the nonzero fill of the drawn polygons.
+// The signed areas covered by the polygon edges are accumulated per pixel, then the rows are integrated from left to right.
+// draw() only collects the edges in pixel coordinates. The raster is calculated by encode() in parallel over bands
+// of rows, each band accumulating into its own buffer, thus even a single huge raster is rasterized by all the threads.
+// The pixels match RasterGrayscaleAA up to the rounding of the anti-aliased edges, except for the anti-aliased edges
+// of overlapping polygons, which are blended by RasterGrayscaleAA, while their coverages are saturated here.
+class RasterGrayscaleCoverage : public RasterBase {
+public:
+    // If gamma is zero, thresholding will be performed which disables AA.
+    RasterGrayscaleCoverage(const Resolution &res, const PixelDim &pd, const Trafo &trafo, double gamma = 1.);
+
+    void          draw(const ExPolygon &poly) override;
+    Trafo         trafo() const override { return m_trafo; }
+    EncodedRaster encode(RasterEncoder encoder) const override;
+
+    Resolution    resolution() const { return m_resolution; }
+    uint8_t       read_pixel(size_t col, size_t row) const { this->render(); return m_buf[row * m_resolution.width_px + col]; }
+    void          clear() { m_edges.clear(); m_dirty = true; }
+
+    // Number of rows of a band rendered by a single task.
+    static constexpr const size_t BandRows = 32;
+
+private:
+    struct Edge {
+        Vec2f a;
+        Vec2f b;
+    };
+
+    Vec2f to_pixels(const Point &p) const;
+    // Add an edge in pixel coordinates, clipped to the columns of the raster.
+    void  add_edge(Vec2f a, Vec2f b);
+    void  add_polygon(const Polygon &poly);
+    // Rasterize the edges collected so far into m_buf, if not done yet.
+    void  render() const;
+
+    Resolution              m_resolution;
+    // Pixels per scaled coordinate unit.
+    Vec2d                   m_scale;
+    Trafo                   m_trafo;
+    // Maps the coverage quantized to 8 bits to the pixel value.
+    std::array<uint8_t, 256> m_gamma;
+    std::vector<Edge>       m_edges;
+
+    mutable std::vector<uint8_t> m_buf;
+    mutable bool                 m_dirty { true };
+};
+
+}} // namespace Slic3r::sla
+
+#endif // SLA_COVERAGERASTER_HPP
@@ -99,7 +99,10 @@ InteriorPtr generate_interior(const VoxelGrid       &vgrid,
 
     double iso_surface = D;
     if (D > EPSILON) {
-        gridptr = redistance_grid(*gridptr, -(offset + D), narrowb, narrowb);
+        gridptr = redistance_grid(*gridptr, -(offset + D), narrowb, narrowb,
+                                  [&ctl](int) { return ctl.stopcondition(); });
+
+        if (ctl.stopcondition()) return {};
 
         gridptr = dilate_grid(*gridptr, 1.1 * std::ceil(iso_surface), 0.f);
 
@@ -825,11 +828,14 @@ int hollow_mesh_and_drill(indexed_triangle_set &hollowed_mesh,
         );
 
     std::uniform_real_distribution<float> dist(0., float(EPSILON));
-    auto holes_mesh_cgal = MeshBoolean::cgal::triangle_mesh_to_cgal({}, {});
     indexed_triangle_set part_to_drill = hollowed_mesh;
 
     std::mt19937 m_rng{std::random_device{}()};
 
+    // Meshes and bounding boxes of the holes, which can be drilled.
+    std::vector<indexed_triangle_set> hole_meshes;
+    std::vector<BoundingBoxf3>        hole_bboxes;
+
     for (size_t i = 0; i < drainholes.size(); ++i) {
         sla::DrainHole holept = drainholes[i];
 
@@ -861,7 +867,29 @@ int hollow_mesh_and_drill(indexed_triangle_set &hollowed_mesh,
             continue;
         }
 
-        auto cgal_hole = MeshBoolean::cgal::triangle_mesh_to_cgal(m);
+        hole_meshes.emplace_back(std::move(m));
+        // Holes with touching bounding boxes are treated as overlapping.
+        bb.offset(EPSILON);
+        hole_bboxes.emplace_back(bb);
+    }
+
+    // Union of the holes. Holes not touching any other hole are merged without
+    // a boolean operation, only the overlapping holes are added one by one.
+    indexed_triangle_set disjoint_holes;
+    std::vector<size_t>  overlapping_holes;
+    for (size_t i = 0; i < hole_meshes.size(); ++i) {
+        bool overlaps = false;
+        for (size_t j = 0; j < hole_meshes.size() && !overlaps; ++j)
+            overlaps = i != j && hole_bboxes[i].intersects(hole_bboxes[j]);
+        if (overlaps)
+            overlapping_holes.emplace_back(i);
+        else
+            its_merge(disjoint_holes, hole_meshes[i]);
+    }
+
+    auto holes_mesh_cgal = MeshBoolean::cgal::triangle_mesh_to_cgal(disjoint_holes);
+    for (size_t i : overlapping_holes) {
+        auto cgal_hole = MeshBoolean::cgal::triangle_mesh_to_cgal(hole_meshes[i]);
         MeshBoolean::cgal::plus(*holes_mesh_cgal, *cgal_hole);
     }
 
@@ -128,10 +128,13 @@ template<class Cont> double csgmesh_positive_maxvolume(const Cont &csg)
     return mesh_vol;
 }
 
+// Distance field of a csg mesh, from which generate_interior(const VoxelGrid&, ...) derives the interior.
+// Only depends on the csg mesh and on HollowingConfig::quality, thus it may be reused for any wall thickness
+// and closing distance.
 template<class It>
-InteriorPtr generate_interior(const Range<It>       &csgparts,
-                              const HollowingConfig &hc  = {},
-                              const JobController   &ctl = {})
+VoxelGridPtr generate_interior_grid(const Range<It>       &csgparts,
+                                    const HollowingConfig &hc  = {},
+                                    const JobController   &ctl = {})
 {
     double mesh_vol = csgmesh_positive_maxvolume(csgparts);
     double voxsc    = get_voxel_scale(mesh_vol, hc);
@@ -149,9 +152,17 @@ InteriorPtr generate_interior(const Range<It>       &csgparts,
     if (!ptr || (ctl.stopcondition && ctl.stopcondition()))
         return {};
 
-    ptr = redistance_grid(*ptr, IsoAtZero,
-                          params.exterior_bandwidth(),
-                          params.interior_bandwidth());
+    return redistance_grid(*ptr, IsoAtZero,
+                           params.exterior_bandwidth(),
+                           params.interior_bandwidth());
+}
+
+template<class It>
+InteriorPtr generate_interior(const Range<It>       &csgparts,
+                              const HollowingConfig &hc  = {},
+                              const JobController   &ctl = {})
+{
+    auto ptr = generate_interior_grid(csgparts, hc, ctl);
 
     return ptr ? generate_interior(*ptr, hc, ctl) :
                  InteriorPtr{};
@@ -296,7 +296,8 @@ private:
                                        const PadConfig  &cfg,
                                        ThrowOnCancel     thr)
     {
-        auto allin = reserve_vector<ExPolygon>(supp_bp.size() + model_bp.size());
+        ExPolygons allin;
+        allin.reserve(supp_bp.size() + model_bp.size());
 
         for (auto &ep : supp_bp) allin.emplace_back(ep.contour);
         for (auto &ep : model_bp) allin.emplace_back(ep.contour);
@@ -488,7 +489,8 @@ void pad_blueprint(const indexed_triangle_set &mesh,
     for(auto& o : out) count += o.size();
 
     // Unification is expensive, a simplify also speeds up the pad generation
-    auto tmp = reserve_vector<ExPolygon>(count);
+    ExPolygons tmp;
+    tmp.reserve(count);
     for(ExPolygons& o : out)
         for(ExPolygon& e : o) {
             auto&& exss = e.simplify(scaled<double>(0.1));
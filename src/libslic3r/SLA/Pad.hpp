@@ -21,7 +21,7 @@ namespace Slic3r {
 class ExPolygon;
 class Polygon;
 
-using ExPolygons = std::vector<ExPolygon>;
+using ExPolygons = std::vector<ExPolygon, PointsAllocator<ExPolygon>>;
 using Polygons = std::vector<Polygon, PointsAllocator<Polygon>>;
 
 namespace sla {
@@ -8,12 +8,17 @@
 
 #include <libslic3r/SLA/RasterBase.hpp>
 #include <libslic3r/SLA/AGGRaster.hpp>
+#include <libslic3r/SLA/CoverageRaster.hpp>
 // minz image write:
 #include <miniz.h>
 #include <algorithm>
 #include <cmath>
 #include <iterator>
 #include <cstdlib>
+#include <cstring>
+
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
 
 #include "agg/agg_gamma_functions.h"
 
@@ -41,6 +46,131 @@ EncodedRaster PNGRasterEncoder::operator()(const void *ptr, size_t w, size_t h,
     return EncodedRaster(std::move(buf), "png");
 }
 
+namespace {
+
+// PNG filter types, see the PNG specification, chapter 9.
+enum PNGFilter : uint8_t { pngfNone = 0, pngfSub = 1, pngfUp = 2 };
+
+// Combine the Adler-32 checksums of two consecutive blocks of data, the second one being len2 bytes long. Same as adler32_combine() of zlib.
+mz_ulong adler32_combine(mz_ulong adler1, mz_ulong adler2, size_t len2)
+{
+    constexpr mz_ulong Base = 65521;
+    const mz_ulong rem  = mz_ulong(len2 % Base);
+    mz_ulong       sum1 = adler1 & 0xffff;
+    mz_ulong       sum2 = (rem * sum1) % Base;
+    sum1 += (adler2 & 0xffff) + Base - 1;
+    sum2 += ((adler1 >> 16) & 0xffff) + ((adler2 >> 16) & 0xffff) + Base - rem;
+    if (sum1 >= Base) sum1 -= Base;
+    if (sum1 >= Base) sum1 -= Base;
+    if (sum2 >= (Base << 1)) sum2 -= (Base << 1);
+    if (sum2 >= Base) sum2 -= Base;
+    return sum1 | (sum2 << 16);
+}
+
+void append_be32(std::vector<uint8_t> &out, mz_ulong v)
+{
+    out.insert(out.end(), { uint8_t(v >> 24), uint8_t(v >> 16), uint8_t(v >> 8), uint8_t(v) });
+}
+
+void append_png_chunk(std::vector<uint8_t> &out, const char *type, const uint8_t *data, size_t size)
+{
+    append_be32(out, mz_ulong(size));
+    const size_t type_begin = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data, data + size);
+    append_be32(out, mz_crc32(MZ_CRC32_INIT, out.data() + type_begin, out.size() - type_begin));
+}
+
+// Filter a row of an 8 bit grayscale image. The neighbour rows of a layer are mostly the same, thus the Up filter leaves
+// the bytes non-zero just around the edges of the polygons. Choosing the filter per row by the number of non-zero bytes
+// produced by each of the filters made the encoding considerably slower, while the output only got a few percent smaller.
+void filter_png_row(const uint8_t *row, const uint8_t *prev_row, size_t w, uint8_t *out)
+{
+    if (prev_row) {
+        out[0] = pngfUp;
+        for (size_t x = 0; x < w; ++ x)
+            out[x + 1] = uint8_t(row[x] - prev_row[x]);
+    } else {
+        out[0] = pngfSub;
+        out[1] = row[0];
+        for (size_t x = 1; x < w; ++ x)
+            out[x + 1] = uint8_t(row[x] - row[x - 1]);
+    }
+}
+
+} // namespace
+
+EncodedRaster PNGRasterEncoderFast::operator()(const void *ptr, size_t w, size_t h, size_t num_components)
+{
+    if (num_components != 1 || w == 0 || h == 0)
+        return PNGRasterEncoder{}(ptr, w, h, num_components);
+
+    const auto   *pixels = static_cast<const uint8_t *>(ptr);
+    const size_t  stride = w + 1;
+    // About 1MB of filtered rows per block: large enough for the compression ratio not to suffer from restarting deflate,
+    // small enough for a single layer to be compressed by multiple threads.
+    const size_t  block_rows = std::max<size_t>(1, (size_t(1) << 20) / stride);
+    const size_t  num_blocks = (h + block_rows - 1) / block_rows;
+
+    struct Block {
+        std::vector<uint8_t> deflated;
+        mz_ulong             adler = MZ_ADLER32_INIT;
+        size_t               size  = 0;
+        bool                 ok    = false;
+    };
+    std::vector<Block> blocks(num_blocks);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_blocks, 1), [&](const tbb::blocked_range<size_t> &range) {
+        std::vector<uint8_t> filtered;
+        tdefl_compressor    *compressor = tdefl_compressor_alloc();
+        for (size_t iblock = range.begin(); compressor && iblock < range.end(); ++ iblock) {
+            Block       &block     = blocks[iblock];
+            const size_t row_begin = iblock * block_rows;
+            const size_t row_end   = std::min(h, row_begin + block_rows);
+            filtered.resize((row_end - row_begin) * stride);
+            for (size_t row = row_begin; row < row_end; ++ row)
+                filter_png_row(pixels + row * w, row == 0 ? nullptr : pixels + (row - 1) * w, w, filtered.data() + (row - row_begin) * stride);
+            block.size  = filtered.size();
+            block.adler = mz_adler32(MZ_ADLER32_INIT, filtered.data(), filtered.size());
+            // Raw deflate stream, the fastest level of miniz. All but the last block are terminated by a sync flush, thus they are byte aligned
+            // and not final, so that the blocks may be concatenated into a single deflate stream.
+            auto put_buf = [](const void *buf, int len, void *user) -> mz_bool {
+                auto data = static_cast<const uint8_t *>(buf);
+                static_cast<std::vector<uint8_t> *>(user)->insert(static_cast<std::vector<uint8_t> *>(user)->end(), data, data + len);
+                return MZ_TRUE;
+            };
+            block.ok = tdefl_init(compressor, put_buf, &block.deflated, int(tdefl_create_comp_flags_from_zip_params(1, -15, MZ_DEFAULT_STRATEGY))) == TDEFL_STATUS_OKAY &&
+                       tdefl_compress_buffer(compressor, filtered.data(), filtered.size(), iblock + 1 == num_blocks ? TDEFL_FINISH : TDEFL_SYNC_FLUSH) ==
+                           (iblock + 1 == num_blocks ? TDEFL_STATUS_DONE : TDEFL_STATUS_OKAY);
+        }
+        tdefl_compressor_free(compressor);
+    });
+
+    // zlib stream: header of a deflate stream with 32K window and the fastest compression, the blocks, Adler-32 of the filtered data.
+    std::vector<uint8_t> idat { 0x78, 0x01 };
+    mz_ulong             adler = MZ_ADLER32_INIT;
+    for (const Block &block : blocks) {
+        if (! block.ok)
+            return EncodedRaster({}, "png");
+        idat.insert(idat.end(), block.deflated.begin(), block.deflated.end());
+        adler = adler32_combine(adler, block.adler, block.size);
+    }
+    append_be32(idat, adler);
+
+    static constexpr const uint8_t Signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+    std::vector<uint8_t> buf(std::begin(Signature), std::end(Signature));
+    buf.reserve(buf.size() + idat.size() + 64);
+    // Width, height, 8 bits per sample, grayscale, deflate, adaptive filtering, no interlace.
+    std::vector<uint8_t> ihdr;
+    append_be32(ihdr, mz_ulong(w));
+    append_be32(ihdr, mz_ulong(h));
+    ihdr.insert(ihdr.end(), { 8, 0, 0, 0, 0 });
+    append_png_chunk(buf, "IHDR", ihdr.data(), ihdr.size());
+    append_png_chunk(buf, "IDAT", idat.data(), idat.size());
+    append_png_chunk(buf, "IEND", nullptr, 0);
+
+    return EncodedRaster(std::move(buf), "png");
+}
+
 std::ostream &operator<<(std::ostream &stream, const EncodedRaster &bytes)
 {
     stream.write(reinterpret_cast<const char *>(bytes.data()),
@@ -74,11 +204,14 @@ std::unique_ptr<RasterBase> create_raster_grayscale_aa(
     const Resolution        &res,
     const PixelDim          &pxdim,
     double                   gamma,
-    const RasterBase::Trafo &tr)
+    const RasterBase::Trafo &tr,
+    RasterBackend            backend)
 {
     std::unique_ptr<RasterBase> rst;
     
-    if (gamma > 0)
+    if (backend == RasterBackend::Coverage)
+        rst = std::make_unique<RasterGrayscaleCoverage>(res, pxdim, tr, gamma);
+    else if (gamma > 0)
         rst = std::make_unique<RasterGrayscaleAAGammaPower>(res, pxdim, tr, gamma);
     else if (std::abs(gamma - 1.) < 1e-6)
         rst = std::make_unique<RasterGrayscaleAA>(res, pxdim, tr, agg::gamma_none());
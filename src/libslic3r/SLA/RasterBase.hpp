@@ -111,18 +111,34 @@ struct PNGRasterEncoder {
     EncodedRaster operator()(const void *ptr, size_t w, size_t h, size_t num_components);
 };
 
+// PNG encoder of 8 bit grayscale rasters, trading a larger output for speed. The rows are filtered by the Up PNG filter,
+// which turns the SLA layer masks into long runs of zeros, then compressed by the fastest deflate level.
+// Blocks of rows are compressed in parallel.
+// Rasters with more than one component are encoded by PNGRasterEncoder.
+struct PNGRasterEncoderFast {
+    EncodedRaster operator()(const void *ptr, size_t w, size_t h, size_t num_components);
+};
+
 struct PPMRasterEncoder {
     EncodedRaster operator()(const void *ptr, size_t w, size_t h, size_t num_components);
 };
 
 std::ostream& operator<<(std::ostream &stream, const EncodedRaster &bytes);
 
+enum class RasterBackend {
+    // Scanline rasterizer of the AGG library.
+    AGG,
+    // Area coverage accumulation, see RasterGrayscaleCoverage. Rasterizes a single layer by multiple threads.
+    Coverage
+};
+
 // If gamma is zero, thresholding will be performed which disables AA.
 std::unique_ptr<RasterBase> create_raster_grayscale_aa(
     const Resolution        &res,
     const PixelDim          &pxdim,
-    double                   gamma = 1.0,
-    const RasterBase::Trafo &tr    = {});
+    double                   gamma   = 1.0,
+    const RasterBase::Trafo &tr      = {},
+    RasterBackend            backend = RasterBackend::AGG);
 
 }} // namespace Slic3r::sla
 
@@ -13,6 +13,7 @@
 #include "AGGRaster.hpp"
 #include "libslic3r/MarchingSquares.hpp"
 #include "libslic3r/ClipperUtils.hpp"
+#include "libslic3r/Execution/ExecutionTBB.hpp"
 #include "libslic3r/Polygon.hpp"
 #include "libslic3r/libslic3r.h"
 
@@ -33,6 +34,15 @@ template<> struct _RasterTraits<Slic3r::sla::RasterGrayscaleAA> {
     static size_t cols(const Rst &rst) { return rst.resolution().width_px; }
 };
 
+// Tag the grid rows and interpolate the rings in parallel
+template<> struct _Loop<Slic3r::ExecutionTBB> {
+    template<class It, class Fn> static void for_each(It from, It to, Fn &&fn)
+    {
+        Slic3r::execution::for_each(Slic3r::ex_tbb, size_t(0), size_t(to - from),
+                                    [from, &fn](size_t i) { fn(from[i], i); });
+    }
+};
+
 } // namespace Slic3r::marchsq
 
 namespace Slic3r { namespace sla {
@@ -55,7 +65,7 @@ ExPolygons raster_to_polygons(const RasterGrayscaleAA &rst, Vec2i windowsize)
     long w_cols = std::max(2l, long(windowsize.x()));
     
     std::vector<marchsq::Ring> rings =
-        marchsq::execute(rst, 128, {w_rows, w_cols});
+        marchsq::execute_with_policy(ex_tbb, rst, 128, {w_rows, w_cols});
     
     polys.reserve(rings.size());
     
@@ -4,14 +4,15 @@
 ///|/
 #include <libslic3r/SLA/Rotfinder.hpp>
 #include <libslic3r/Execution/ExecutionTBB.hpp>
-#include <libslic3r/Optimize/BruteforceOptimizer.hpp>
 #include <libslic3r/Geometry.hpp>
 #include <limits>
 #include <thread>
 #include <algorithm>
+#include <atomic>
 #include <array>
 #include <cmath>
 #include <iterator>
+#include <numeric>
 #include <vector>
 #include <cinttypes>
 #include <cstdlib>
@@ -21,7 +22,6 @@
 #include "libslic3r/BoundingBox.hpp"
 #include "libslic3r/Execution/Execution.hpp"
 #include "libslic3r/Model.hpp"
-#include "libslic3r/Optimize/Optimizer.hpp"
 #include "libslic3r/Point.hpp"
 #include "libslic3r/TriangleMesh.hpp"
 #include "libslic3r/libslic3r.h"
@@ -43,14 +43,6 @@ std::array<Vec3f, 3> get_triangle_vertices(const TriangleMesh &mesh,
             mesh.its.vertices[face(2)]};
 }
 
-std::array<Vec3f, 3> get_transformed_triangle(const TriangleMesh &mesh,
-                                              const Transform3f & tr,
-                                              size_t              faceidx)
-{
-    const auto &tri = get_triangle_vertices(mesh, faceidx);
-    return {tr * tri[0], tr * tri[1], tr * tri[2]};
-}
-
 template<class T> Vec<3, T> normal(const std::array<Vec<3, T>, 3> &tri)
 {
     Vec<3, T> U = tri[1] - tri[0];
@@ -58,17 +50,6 @@ template<class T> Vec<3, T> normal(const std::array<Vec<3, T>, 3> &tri)
     return U.cross(V).normalized();
 }
 
-template<class T, class AccessFn>
-T sum_score(AccessFn &&accessfn, size_t facecount, size_t Nthreads)
-{
-    T  initv         = 0.;
-    auto   mergefn   = [](T a, T b) { return a + b; };
-    size_t grainsize = facecount / Nthreads;
-    size_t from = 0, to = facecount;
-
-    return execution::reduce(ex_tbb, from, to, initv, mergefn, accessfn, grainsize);
-}
-
 // Get area and normal of a triangle
 struct Facestats {
     Vec3f  normal;
@@ -84,37 +65,136 @@ struct Facestats {
     }
 };
 
+// Normals and areas of the facets of a mesh stored by components. The scores
+// of a rotation depend on the rotated normals only, so the facets are not
+// transformed for each evaluated rotation, only the few rotated axes are
+// dotted with the normals in loops the compiler can vectorize.
+struct FacetNormals {
+    std::vector<float> nx, ny, nz;
+    std::vector<float> area, sqrt_area;
+
+    // Number of facets of the source mesh, which the scores are averaged over.
+    size_t facecount = 0;
+
+    size_t size() const { return area.size(); }
+
+    void resize(size_t n)
+    {
+        nx.resize(n); ny.resize(n); nz.resize(n);
+        area.resize(n); sqrt_area.resize(n);
+    }
+
+    void set(size_t i, const Vec3f &n, float a)
+    {
+        nx[i] = n.x(); ny[i] = n.y(); nz[i] = n.z();
+        area[i] = a;
+        sqrt_area[i] = std::sqrt(a);
+    }
+};
+
+FacetNormals get_facet_normals(const TriangleMesh &mesh)
+{
+    FacetNormals ret;
+    ret.facecount = mesh.its.indices.size();
+    ret.resize(ret.facecount);
+    execution::for_each(ex_tbb, size_t(0), ret.facecount, [&mesh, &ret](size_t fi) {
+        Facestats fc{get_triangle_vertices(mesh, fi)};
+        ret.set(fi, fc.normal, float(fc.area));
+    }, 1024);
+
+    return ret;
+}
+
+// Decimate the facets for a coarse search: facets of similar normals are
+// merged as the scores only depend on the normals and the areas. The normals
+// are binned by an octahedral map of the unit sphere with bins of about one
+// degree, the merged normal is the area weighted average of its bin.
+FacetNormals decimate_facet_normals(const FacetNormals &normals)
+{
+    constexpr size_t Bins = 128;
+
+    struct Bin { Vec3d n = Vec3d::Zero(); double area = 0., sqrt_area = 0.; };
+    std::vector<Bin> bins(Bins * Bins);
+    for (size_t i = 0; i < normals.size(); ++i) {
+        Vec3f n{normals.nx[i], normals.ny[i], normals.nz[i]};
+        float l1 = std::abs(n.x()) + std::abs(n.y()) + std::abs(n.z());
+        if (!(l1 > 0.f))
+            continue; // degenerate facet
+        float u = n.x() / l1, v = n.y() / l1;
+        if (n.z() < 0.f) {
+            float fu = (1.f - std::abs(v)) * (u < 0.f ? -1.f : 1.f);
+            float fv = (1.f - std::abs(u)) * (v < 0.f ? -1.f : 1.f);
+            u = fu; v = fv;
+        }
+        auto to_bin = [](float c) { return std::min(Bins - 1, size_t((c + 1.f) * 0.5f * Bins)); };
+        Bin &bin = bins[to_bin(v) * Bins + to_bin(u)];
+        bin.n += normals.area[i] * n.cast<double>();
+        bin.area += normals.area[i];
+        bin.sqrt_area += normals.sqrt_area[i];
+    }
+
+    FacetNormals ret;
+    ret.facecount = normals.facecount;
+    for (const Bin &bin : bins)
+        if (bin.area > 0.) {
+            size_t i = ret.size();
+            ret.resize(i + 1);
+            ret.set(i, bin.n.normalized().cast<float>(), float(bin.area));
+            ret.sqrt_area[i] = float(bin.sqrt_area);
+        }
+
+    return ret;
+}
+
+// Sum a score over the facets. The facets are summed in blocks of a fixed
+// size, so the sum does not depend on the number of threads.
+template<class AccessFn>
+double sum_score(AccessFn &&accessfn, size_t facecount)
+{
+    constexpr size_t BlockSize = 4096;
+
+    size_t blocks = (facecount + BlockSize - 1) / BlockSize;
+    std::vector<double> sums(blocks, 0.);
+    execution::for_each(ex_tbb, size_t(0), blocks, [&accessfn, &sums, facecount](size_t b) {
+        double sum = 0.;
+        for (size_t fi = b * BlockSize; fi < std::min(facecount, (b + 1) * BlockSize); ++fi)
+            sum += accessfn(fi);
+
+        sums[b] = sum;
+    });
+
+    return std::accumulate(sums.begin(), sums.end(), 0.);
+}
+
 // Try to guess the number of support points needed to support a mesh
-double get_misalginment_score(const TriangleMesh &mesh, const Transform3f &tr)
+double get_misalginment_score(const FacetNormals &normals, const Transform3f &tr)
 {
-    if (mesh.its.vertices.empty()) return NaNd;
+    if (normals.facecount == 0) return NaNd;
 
-    auto accessfn = [&mesh, &tr](size_t fi) {
-        Facestats fc{get_transformed_triangle(mesh, tr, fi)};
+    // Components of the rotated normals are the dot products with the rows
+    // of the rotation.
+    const Matrix3f rot = tr.linear();
+    const Vec3f    r0  = rot.row(0), r1 = rot.row(1), r2 = rot.row(2);
 
-        float score = fc.area
-                      * (std::abs(fc.normal.dot(Vec3f::UnitX()))
-                         + std::abs(fc.normal.dot(Vec3f::UnitY()))
-                         + std::abs(fc.normal.dot(Vec3f::UnitZ())));
+    auto accessfn = [&normals, &r0, &r1, &r2](size_t fi) {
+        float nx = normals.nx[fi], ny = normals.ny[fi], nz = normals.nz[fi];
 
         // We should score against the alignment with the reference planes
-        return scaled<int_fast64_t>(score);
+        return normals.area[fi] * (std::abs(r0.x() * nx + r0.y() * ny + r0.z() * nz)
+                                   + std::abs(r1.x() * nx + r1.y() * ny + r1.z() * nz)
+                                   + std::abs(r2.x() * nx + r2.y() * ny + r2.z() * nz));
     };
 
-    size_t facecount = mesh.its.indices.size();
-    size_t Nthreads  = std::thread::hardware_concurrency();
-    double S = unscaled(sum_score<int_fast64_t>(accessfn, facecount, Nthreads));
-
-    return S / facecount;
+    return sum_score(accessfn, normals.size()) / normals.facecount;
 }
 
-// The score function for a particular face
-inline double get_supportedness_score(const Facestats &fc)
+// The score function for a particular face given the cosine of the angle
+// between its normal and the DOWN vector
+inline float get_supportedness_score(float cosphi, float sqrt_area)
 {
     // Simply get the angle (acos of dot product) between the face normal and
     // the DOWN vector.
-    float cosphi = fc.normal.dot(DOWN);
-    float phi = 1.f - std::acos(cosphi) / float(PI);
+    float phi = 1.f - std::acos(std::clamp(cosphi, -1.f, 1.f)) / float(PI);
 
     // Make the huge slopes more significant than the smaller slopes
     phi = phi * phi * phi;
@@ -122,24 +202,29 @@ inline double get_supportedness_score(const Facestats &fc)
     // Multiply with the square root of face area of the current face,
     // the area is less important as it grows.
     // This makes many smaller overhangs a bigger impact.
-    return std::sqrt(fc.area) * POINTS_PER_UNIT_AREA * phi;
+    return sqrt_area * float(POINTS_PER_UNIT_AREA) * phi;
+}
+
+// The rotated normal dotted with DOWN is the normal dotted with the rotated
+// DOWN vector.
+inline Vec3f rotated_down(const Transform3f &tr)
+{
+    return tr.linear().transpose() * DOWN;
 }
 
 // Try to guess the number of support points needed to support a mesh
-double get_supportedness_score(const TriangleMesh &mesh, const Transform3f &tr)
+double get_supportedness_score(const FacetNormals &normals, const Transform3f &tr)
 {
-    if (mesh.its.vertices.empty()) return NaNd;
+    if (normals.facecount == 0) return NaNd;
 
-    auto accessfn = [&mesh, &tr](size_t fi) {
-        Facestats fc{get_transformed_triangle(mesh, tr, fi)};
-        return scaled<int_fast64_t>(get_supportedness_score(fc));
-    };
+    const Vec3f d = rotated_down(tr);
 
-    size_t facecount = mesh.its.indices.size();
-    size_t Nthreads  = std::thread::hardware_concurrency();
-    double S = unscaled(sum_score<int_fast64_t>(accessfn, facecount, Nthreads));
+    auto accessfn = [&normals, &d](size_t fi) {
+        float cosphi = d.x() * normals.nx[fi] + d.y() * normals.ny[fi] + d.z() * normals.nz[fi];
+        return get_supportedness_score(cosphi, normals.sqrt_area[fi]);
+    };
 
-    return S / facecount;
+    return sum_score(accessfn, normals.size()) / normals.facecount;
 }
 
 // Find transformed mesh ground level without copy and with parallel reduce.
@@ -161,6 +246,7 @@ float find_ground_level(const TriangleMesh &mesh,
 }
 
 double get_supportedness_onfloor_score(const TriangleMesh &mesh,
+                                       const FacetNormals &normals,
                                        const Transform3f  &tr)
 {
     if (mesh.its.vertices.empty()) return NaNd;
@@ -170,20 +256,21 @@ double get_supportedness_onfloor_score(const TriangleMesh &mesh,
     float zmin = find_ground_level(mesh, tr, Nthreads);
     float zlvl = zmin + 0.1f; // Set up a slight tolerance from z level
 
-    auto accessfn = [&mesh, &tr, zlvl](size_t fi) {
-        std::array<Vec3f, 3> tri = get_transformed_triangle(mesh, tr, fi);
-        Facestats fc{tri};
+    const Vec3f r2 = tr.linear().row(2);
+    const Vec3f d  = rotated_down(tr);
 
-        if (tri[0].z() <= zlvl && tri[1].z() <= zlvl && tri[2].z() <= zlvl)
-            return -2 * fc.area * POINTS_PER_UNIT_AREA;
+    auto accessfn = [&mesh, &normals, &r2, &d, zlvl](size_t fi) {
+        const auto &face = mesh.its.indices[fi];
+        if (r2.dot(mesh.its.vertices[face(0)]) <= zlvl &&
+            r2.dot(mesh.its.vertices[face(1)]) <= zlvl &&
+            r2.dot(mesh.its.vertices[face(2)]) <= zlvl)
+            return -2.f * normals.area[fi] * float(POINTS_PER_UNIT_AREA);
 
-        return get_supportedness_score(fc);
+        float cosphi = d.x() * normals.nx[fi] + d.y() * normals.ny[fi] + d.z() * normals.nz[fi];
+        return get_supportedness_score(cosphi, normals.sqrt_area[fi]);
     };
 
-    size_t facecount = mesh.its.indices.size();
-    double S = unscaled(sum_score<int_fast64_t>(accessfn, facecount, Nthreads));
-
-    return S / facecount;
+    return sum_score(accessfn, normals.size()) / normals.facecount;
 }
 
 using XYRotation = std::array<double, 2>;
@@ -263,17 +350,14 @@ std::vector<XYRotation> get_chull_rotations(const TriangleMesh &mesh, size_t max
     return ret;
 }
 
-// Find the best score from a set of function inputs. Evaluate for every point.
-template<size_t N, class Fn, class It, class StopCond>
-std::array<double, N> find_min_score(Fn &&fn, It from, It to, StopCond &&stopfn)
+// Evaluate the function for every input in parallel. The inputs not evaluated
+// due to the stop condition get the maximal score.
+template<class Fn, class It, class StopCond>
+std::vector<double> get_scores(Fn &&fn, It from, It to, StopCond &&stopfn)
 {
-    std::array<double, N> ret = {};
-
-    double score = std::numeric_limits<double>::max();
-
     size_t Nthreads = std::thread::hardware_concurrency();
     size_t dist = std::distance(from, to);
-    std::vector<double> scores(dist, score);
+    std::vector<double> scores(dist, std::numeric_limits<double>::max());
 
     execution::for_each(
         ex_tbb, size_t(0), dist, [&stopfn, &scores, &fn, &from](size_t i) {
@@ -281,7 +365,18 @@ std::array<double, N> find_min_score(Fn &&fn, It from, It to, StopCond &&stopfn)
 
             scores[i] = fn(*(from + i));
         },
-        dist / Nthreads);
+        std::max(dist / Nthreads, size_t(1)));
+
+    return scores;
+}
+
+// Find the best score from a set of function inputs. Evaluate for every point.
+template<size_t N, class Fn, class It, class StopCond>
+std::array<double, N> find_min_score(Fn &&fn, It from, It to, StopCond &&stopfn)
+{
+    std::array<double, N> ret = {};
+
+    std::vector<double> scores = get_scores(fn, from, to, stopfn);
 
     auto it = std::min_element(scores.begin(), scores.end());
 
@@ -291,6 +386,64 @@ std::array<double, N> find_min_score(Fn &&fn, It from, It to, StopCond &&stopfn)
     return ret;
 }
 
+// The rotations sampled by opt::AlgBruteForce on a grid of gridsize^2 points
+// over the rotations around the X and Y axes.
+std::vector<XYRotation> get_grid_rotations(size_t gridsize)
+{
+    gridsize = std::max(gridsize, size_t(2));
+    double step = 2. * PI / (gridsize - 1);
+
+    auto ret = reserve_vector<XYRotation>(gridsize * gridsize);
+    for (size_t y = 0; y < gridsize; ++y)
+        for (size_t x = 0; x < gridsize; ++x)
+            ret.push_back({-PI + x * step, -PI + y * step});
+
+    return ret;
+}
+
+// Number of the best rotations found on the decimated facets, which are
+// evaluated again on all the facets.
+constexpr size_t FINE_CANDIDATES = 16;
+
+// Find the rotation with the minimal score of fn(normals, rotation). For large
+// meshes the rotations are evaluated on the decimated facets first, then only
+// the best candidates are evaluated on all the facets.
+template<class Fn, class StopCond>
+XYRotation find_min_score_coarse_to_fine(Fn &&fn,
+                                         const FacetNormals &normals,
+                                         const FacetNormals &decimated,
+                                         const std::vector<XYRotation> &inputs,
+                                         StopCond &&stopfn)
+{
+    auto finefn = [&fn, &normals](const XYRotation &rot) { return fn(normals, rot); };
+    if (decimated.size() == normals.size())
+        return find_min_score<2>(finefn, inputs.begin(), inputs.end(), stopfn);
+
+    std::vector<double> scores = get_scores(
+        [&fn, &decimated](const XYRotation &rot) { return fn(decimated, rot); },
+        inputs.begin(), inputs.end(), stopfn);
+
+    std::vector<size_t> order(scores.size());
+    std::iota(order.begin(), order.end(), size_t(0));
+    size_t ncandidates = std::min(FINE_CANDIDATES, order.size());
+    std::partial_sort(order.begin(), order.begin() + ncandidates, order.end(),
+                      [&scores](size_t a, size_t b) { return scores[a] < scores[b]; });
+
+    auto candidates = reserve_vector<XYRotation>(ncandidates);
+    for (size_t i = 0; i < ncandidates; ++i)
+        candidates.emplace_back(inputs[order[i]]);
+
+    return find_min_score<2>(finefn, candidates.begin(), candidates.end(), stopfn);
+}
+
+// Decimate the facets only if it saves enough of the evaluation.
+FacetNormals get_coarse_facet_normals(const FacetNormals &normals)
+{
+    FacetNormals decimated = decimate_facet_normals(normals);
+
+    return decimated.size() * 4 < normals.size() ? decimated : normals;
+}
+
 } // namespace
 
 
@@ -299,7 +452,8 @@ template<unsigned MAX_ITER>
 struct RotfinderBoilerplate {
     static constexpr unsigned MAX_TRIES = MAX_ITER;
 
-    int status = 0, prev_status = 0;
+    // The objective functions are evaluated in parallel.
+    std::atomic<int> status = 0, prev_status = 0;
     TriangleMesh mesh;
     unsigned max_tries;
     const RotOptimizeParams &params;
@@ -325,13 +479,9 @@ struct RotfinderBoilerplate {
     {}
 
     void statusfn() {
-        int s = status * 100 / max_tries;
-        if (s != prev_status) {
+        int s = status++ * 100 / int(std::max(max_tries, 1u));
+        if (prev_status.exchange(s) != s)
             params.statuscb()(s);
-            prev_status = s;
-        }
-
-        ++status;
     }
 
     bool stopcond() { return ! params.statuscb()(-1); }
@@ -342,27 +492,27 @@ Vec2d find_best_misalignment_rotation(const ModelObject &      mo,
 {
     RotfinderBoilerplate<1000> bp{mo, params};
 
-    // Preparing the optimizer.
-    size_t gridsize = std::sqrt(bp.max_tries);
-    opt::Optimizer<opt::AlgBruteForce> solver(
-        opt::StopCriteria{}.max_iterations(bp.max_tries)
-                           .stop_condition([&bp] { return bp.stopcond(); }),
-        gridsize
-    );
-
     // We are searching rotations around only two axes x, y. Thus the
-    // problem becomes a 2 dimensional optimization task.
-    // We can specify the bounds for a dimension in the following way:
-    auto bounds = opt::bounds({ {-PI, PI}, {-PI, PI} });
+    // problem becomes a 2 dimensional optimization task. The rotations are
+    // sampled on a grid, as done by the brute force optimizer, but evaluated
+    // in parallel.
+    std::vector<XYRotation> inputs = get_grid_rotations(std::sqrt(bp.max_tries));
 
-    auto result = solver.to_max().optimize(
-        [&bp] (const XYRotation &rot)
-        {
-            bp.statusfn();
-            return get_misalginment_score(bp.mesh, to_transform3f(rot));
-        }, opt::initvals({0., 0.}), bounds);
+    FacetNormals normals   = get_facet_normals(bp.mesh);
+    FacetNormals decimated = get_coarse_facet_normals(normals);
+    bp.max_tries = inputs.size() + (decimated.size() < normals.size() ? FINE_CANDIDATES : 0);
+
+    // The alignment is maximized.
+    auto objfn = [&bp](const FacetNormals &n, const XYRotation &rot) {
+        bp.statusfn();
+        return -get_misalginment_score(n, to_transform3f(rot));
+    };
+
+    XYRotation rot = find_min_score_coarse_to_fine(objfn, normals, decimated, inputs, [&bp] {
+        return bp.stopcond();
+    });
 
-    return {result.optimum[0], result.optimum[1]};
+    return {rot[0], rot[1]};
 }
 
 Vec2d find_least_supports_rotation(const ModelObject &      mo,
@@ -378,6 +528,8 @@ Vec2d find_least_supports_rotation(const ModelObject &      mo,
 
     XYRotation rot;
 
+    FacetNormals normals = get_facet_normals(bp.mesh);
+
     // Different search methods have to be used depending on the model elevation
     if (is_on_floor(pocfg)) {
 
@@ -387,10 +539,10 @@ Vec2d find_least_supports_rotation(const ModelObject &      mo,
         // If the model can be placed on the bed directly, we only need to
         // check the 3D convex hull face rotations.
 
-        auto objfn = [&bp](const XYRotation &rot) {
+        auto objfn = [&bp, &normals](const XYRotation &rot) {
             bp.statusfn();
             Transform3f tr = to_transform3f(rot);
-            return get_supportedness_onfloor_score(bp.mesh, tr);
+            return get_supportedness_onfloor_score(bp.mesh, normals, tr);
         };
 
         rot = find_min_score<2>(objfn, inputs.begin(), inputs.end(), [&bp] {
@@ -398,28 +550,22 @@ Vec2d find_least_supports_rotation(const ModelObject &      mo,
         });
 
     } else {
-        // Preparing the optimizer.
-        size_t gridsize = std::sqrt(bp.max_tries); // 2D grid has gridsize^2 calls
-        opt::Optimizer<opt::AlgBruteForce> solver(
-            opt::StopCriteria{}.max_iterations(bp.max_tries)
-                               .stop_condition([&bp] { return bp.stopcond(); }),
-            gridsize
-        );
-
         // We are searching rotations around only two axes x, y. Thus the
         // problem becomes a 2 dimensional optimization task.
-        // We can specify the bounds for a dimension in the following way:
-        auto bounds = opt::bounds({ {-PI, PI}, {-PI, PI} });
-
-        auto result = solver.to_min().optimize(
-            [&bp] (const XYRotation &rot)
-            {
-                bp.statusfn();
-                return get_supportedness_score(bp.mesh, to_transform3f(rot));
-            }, opt::initvals({0., 0.}), bounds);
-
-        // Save the result
-        rot = result.optimum;
+        // 2D grid has gridsize^2 calls
+        std::vector<XYRotation> inputs = get_grid_rotations(std::sqrt(bp.max_tries));
+
+        FacetNormals decimated = get_coarse_facet_normals(normals);
+        bp.max_tries = inputs.size() + (decimated.size() < normals.size() ? FINE_CANDIDATES : 0);
+
+        auto objfn = [&bp](const FacetNormals &n, const XYRotation &rot) {
+            bp.statusfn();
+            return get_supportedness_score(n, to_transform3f(rot));
+        };
+
+        rot = find_min_score_coarse_to_fine(objfn, normals, decimated, inputs, [&bp] {
+            return bp.stopcond();
+        });
     }
 
     return {rot[0], rot[1]};
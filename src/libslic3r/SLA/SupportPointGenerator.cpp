@@ -5,6 +5,10 @@
 
 #include "SupportPointGenerator.hpp"
 
+#include <unordered_map>
+
+#include <boost/container_hash/hash.hpp>
+
 #include "libslic3r/Execution/ExecutionTBB.hpp" // parallel preparation of data for sampling
 #include "libslic3r/Execution/Execution.hpp"
 #include "libslic3r/KDTreeIndirect.hpp"
@@ -286,56 +290,58 @@ void support_part_overhangs(
 
 /// <summary>
 /// Sample part as Island
+/// </summary>
+/// <param name="island">Shape of island to support</param>
+/// <param name="permanent">Positions of permanent supports on the island</param>
+/// <param name="cfg">Configuration of sampling</param>
+/// <returns>Positions of supports on layer</returns>
+Points sample_island(const ExPolygon &island, const Points &permanent, const SupportPointGeneratorConfig &cfg) {
+    SupportIslandPoints samples = uniform_support_island(island, permanent, cfg.island_configuration);
+    Points result;
+    result.reserve(samples.size());
+    for (const SupportIslandPointPtr &sample : samples)
+        result.push_back(sample->point);
+    return result;
+}
+
+Points sample_peninsulas(const Peninsulas& peninsulas, const Points &permanent, const SupportPointGeneratorConfig &cfg) {
+    Points result;
+    for (const Peninsula& peninsula: peninsulas) {
+        SupportIslandPoints peninsula_supports =
+            uniform_support_peninsula(peninsula, permanent, cfg.island_configuration);
+        for (const SupportIslandPointPtr &support : peninsula_supports)
+            result.push_back(support->point);
+    }
+    return result;
+}
+
+/// <summary>
+/// Add supports sampled by island or peninsulas
 /// Result store to grid
 /// </summary>
-/// <param name="part">Island to support</param>
+/// <param name="samples">Positions of supports on layer</param>
 /// <param name="near_points">OUT place to store new supports</param>
 /// <param name="part_z">z coordinate of part</param>
-/// <param name="permanent">z coordinate of part</param>
 /// <param name="cfg"></param>
-void support_island(const LayerPart &part, NearPoints& near_points, float part_z,
-    const Points &permanent, const SupportPointGeneratorConfig &cfg) {
-    SupportIslandPoints samples = uniform_support_island(*part.shape, permanent, cfg.island_configuration);
-    for (const SupportIslandPointPtr &sample : samples)
+void support_island_samples(const Points &samples, NearPoints& near_points, float part_z,
+    const SupportPointGeneratorConfig &cfg) {
+    for (const Point &sample : samples)
         near_points.add(LayerSupportPoint{
             SupportPoint{
                 Vec3f{
-                    unscale<float>(sample->point.x()), 
-                    unscale<float>(sample->point.y()), 
+                    unscale<float>(sample.x()), 
+                    unscale<float>(sample.y()), 
                     part_z
                 },
                 /* head_front_radius */ cfg.head_diameter / 2,
                 SupportPointType::island
             },
-            /* position_on_layer */ sample->point,
+            /* position_on_layer */ sample,
             /* radius_curve_index */ 0,
             /* current_radius */ static_cast<coord_t>(scale_(cfg.support_curve.front().x()))
         });
 }
 
-void support_peninsulas(const Peninsulas& peninsulas, NearPoints& near_points, float part_z,
-    const Points &permanent, const SupportPointGeneratorConfig &cfg) {
-    for (const Peninsula& peninsula: peninsulas) {
-        SupportIslandPoints peninsula_supports =
-            uniform_support_peninsula(peninsula, permanent, cfg.island_configuration);
-        for (const SupportIslandPointPtr &support : peninsula_supports)
-            near_points.add(LayerSupportPoint{
-                SupportPoint{
-                    Vec3f{
-                        unscale<float>(support->point.x()), 
-                        unscale<float>(support->point.y()), 
-                        part_z
-                    },
-                    /* head_front_radius */ cfg.head_diameter / 2, 
-                    SupportPointType::island
-                },
-                /* position_on_layer */ support->point,
-                /* radius_curve_index */ 0,
-                /* current_radius */ static_cast<coord_t>(scale_(cfg.support_curve.front().x()))
-            });
-    }   
-}
-
 /// <summary>
 /// Copy parts shapes from link to output
 /// </summary>
@@ -1436,6 +1442,142 @@ Points get_permanents(const PermanentSupports &supports, size_t support_index,
     return result;
 }
 
+/// <summary>
+/// Index of the first permanent support with influence into layer part
+/// Supports are sorted by influence
+/// </summary>
+size_t get_index_of_first_permanent(const PermanentSupports &supports, size_t layer_index, size_t part_index) {
+    auto it = std::lower_bound(supports.begin(), supports.end(), PartId{layer_index, part_index},
+        [](const PermanentSupport &s, const PartId &id) {
+            return s.influence.layer_id != id.layer_id ?
+                s.influence.layer_id < id.layer_id :
+                s.influence.part_id < id.part_id; });
+    return it - supports.begin();
+}
+
+/// <summary>
+/// Move island to the origin, start each of its polygons at the lowest point and sort the holes.
+/// Thus islands of the same shape at different positions of the layers are equal.
+/// </summary>
+/// <param name="island">Shape of island</param>
+/// <param name="offset">OUT translation of the normalized island back to the island</param>
+/// <returns>Normalized island</returns>
+ExPolygon normalize_island(const ExPolygon &island, Point &offset) {
+    auto is_lower = [](const Point &a, const Point &b) {
+        return a.x() != b.x() ? a.x() < b.x() : a.y() < b.y(); };
+    auto start_at_lowest = [&is_lower](Polygon &polygon) {
+        std::rotate(polygon.points.begin(),
+            std::min_element(polygon.points.begin(), polygon.points.end(), is_lower),
+            polygon.points.end());
+    };
+    offset = BoundingBox(island.contour.points).min;
+    ExPolygon result = island;
+    result.translate(-offset);
+    start_at_lowest(result.contour);
+    for (Polygon &hole : result.holes)
+        start_at_lowest(hole);
+    std::sort(result.holes.begin(), result.holes.end(), [&is_lower](const Polygon &a, const Polygon &b) {
+        return !b.empty() && (a.empty() || is_lower(a.points.front(), b.points.front())); });
+    return result;
+}
+
+size_t hash_island(const ExPolygon &island) {
+    size_t seed = 0;
+    auto hash_polygon = [&seed](const Polygon &polygon) {
+        boost::hash_combine(seed, polygon.size());
+        for (const Point &pt : polygon.points)
+            boost::hash_combine(seed, (int64_t(pt.x()) << 32) ^ int64_t(pt.y()));
+    };
+    hash_polygon(island.contour);
+    for (const Polygon &hole : island.holes)
+        hash_polygon(hole);
+    return seed;
+}
+
+// Supports sampled on islands and peninsulas of layer parts, indexed by layer and part
+using SampledParts = std::vector<std::vector<Points>>;
+
+/// <summary>
+/// Sample all islands and peninsulas in parallel.
+/// Sampling depends only on the shape of the part and the permanent supports,
+/// not on the supports propagated from the previous layers.
+/// Islands of the same shape, e.g. repeated features of the object, are sampled only once.
+/// </summary>
+/// <param name="layers">Layers with parts to sample</param>
+/// <param name="permanent_supports">Permanent supports sorted by influence</param>
+/// <param name="config">Configuration of sampling</param>
+/// <param name="throw_on_cancel">Call in meantime</param>
+/// <returns>Positions of supports for islands and peninsulas, empty for other parts</returns>
+SampledParts sample_islands_and_peninsulas(const Layers &layers, const PermanentSupports &permanent_supports,
+    const SupportPointGeneratorConfig &config, ThrowOnCancel throw_on_cancel) {
+    // Islands of the same shape with translation of each of them
+    struct SameIslands {
+        ExPolygon shape; // normalized
+        std::vector<std::pair<PartId, Point>> parts;
+    };
+    std::vector<SameIslands> islands;
+    // hash of normalized shape -> indices into islands
+    std::unordered_map<size_t, std::vector<size_t>> islands_by_hash;
+    // Peninsulas and islands with permanent supports, which depend on them
+    std::vector<PartId> parts_to_sample;
+
+    SampledParts result(layers.size());
+    for (size_t layer_id = 0; layer_id < layers.size(); ++layer_id) {
+        const LayerParts &parts = layers[layer_id].parts;
+        result[layer_id].resize(parts.size());
+        for (size_t part_id = 0; part_id < parts.size(); ++part_id) {
+            const LayerPart &part = parts[part_id];
+            PartId id{layer_id, part_id};
+            if (!part.prev_parts.empty()) {
+                if (!part.peninsulas.empty())
+                    parts_to_sample.push_back(id);
+                continue;
+            }
+            size_t permanent_index = get_index_of_first_permanent(permanent_supports, layer_id, part_id);
+            if (exist_permanent_support(permanent_supports, permanent_index, layer_id, part_id)) {
+                parts_to_sample.push_back(id);
+                continue;
+            }
+            Point offset;
+            ExPolygon shape = normalize_island(*part.shape, offset);
+            std::vector<size_t> &same_hash = islands_by_hash[hash_island(shape)];
+            auto it = std::find_if(same_hash.begin(), same_hash.end(),
+                [&islands, &shape](size_t index) { return islands[index].shape == shape; });
+            if (it == same_hash.end()) {
+                same_hash.push_back(islands.size());
+                islands.push_back(SameIslands{std::move(shape), {}});
+                it = same_hash.end() - 1;
+            }
+            islands[*it].parts.emplace_back(id, offset);
+        }
+    }
+
+    // Time of sampling differs a lot between parts, so sample each part as its own task.
+    execution::for_each(ex_tbb, size_t(0), islands.size() + parts_to_sample.size(),
+    [&layers, &permanent_supports, &config, &islands, &parts_to_sample, &result, throw_on_cancel](size_t index) {
+        throw_on_cancel();
+        if (index < islands.size()) {
+            const SameIslands &same = islands[index];
+            Points samples = sample_island(same.shape, {}, config);
+            for (const auto &[id, offset] : same.parts) {
+                Points &part_samples = result[id.layer_id][id.part_id];
+                part_samples.reserve(samples.size());
+                for (const Point &sample : samples)
+                    part_samples.push_back(sample + offset);
+            }
+            return;
+        }
+        const PartId &id = parts_to_sample[index - islands.size()];
+        const LayerPart &part = layers[id.layer_id].parts[id.part_id];
+        size_t permanent_index = get_index_of_first_permanent(permanent_supports, id.layer_id, id.part_id);
+        Points permanent = get_permanents(permanent_supports, permanent_index, id.layer_id, id.part_id);
+        result[id.layer_id][id.part_id] = part.prev_parts.empty() ?
+            sample_island(*part.shape, permanent, config) :
+            sample_peninsulas(part.peninsulas, permanent, config);
+    }, 1 /* gransize */);
+    return result;
+}
+
 } // namespace
 
 namespace Slic3r::sla {
@@ -1487,6 +1629,15 @@ LayerSupportPoints generate_support_points(
     PermanentSupports permanent_supports =
         prepare_permanent_supports(data.permanent_supports, layers, config);
 
+    // The most expensive part, sampling of islands and peninsulas, does not depend on the previous layers.
+    SampledParts sampled_parts =
+        sample_islands_and_peninsulas(layers, permanent_supports, config, throw_on_cancel);
+    // Sampling is accounted as the first half of the progress
+    status = 50.;
+    status_int = 50;
+    statusfn(status_int);
+    increment = 50.0 / static_cast<double>(layers.size());
+
     // grid index == part in layer index
     NearPointss prev_grids; // same count as previous layer item size
     for (size_t layer_id = 0; layer_id < layers.size(); ++layer_id) {
@@ -1501,9 +1652,7 @@ LayerSupportPoints generate_support_points(
             size_t part_id = &part - &layer.parts.front();
             if (part.prev_parts.empty()) {   // Island ?
                 grids.emplace_back(&result); // only island add new grid
-                Points permanent =
-                    get_permanents(permanent_supports, permanent_index, layer_id, part_id);
-                support_island(part, grids.back(), layer.print_z, permanent, config);
+                support_island_samples(sampled_parts[layer_id][part_id], grids.back(), layer.print_z, config);
                 copy_permanent_supports(
                     grids.back(), permanent_supports, permanent_index, layer.print_z, layer_id,
                     part_id, config
@@ -1517,12 +1666,8 @@ LayerSupportPoints generate_support_points(
             NearPoints near_points = create_near_points(prev_layer_parts, part, prev_grids);
             remove_supports_out_of_part(near_points, part, layer.print_z);
             assert(!near_points.get_indices().empty());
-            if (!part.peninsulas.empty()) {
-                // only get copy of points do not modify permanent_index
-                Points permanent =
-                    get_permanents(permanent_supports, permanent_index, layer_id, part_id);
-                support_peninsulas(part.peninsulas, near_points, layer.print_z, permanent, config);
-            }
+            if (!part.peninsulas.empty())
+                support_island_samples(sampled_parts[layer_id][part_id], near_points, layer.print_z, config);
             copy_permanent_supports(
                 near_points, permanent_supports, permanent_index, layer.print_z, layer_id, part_id,
                 config
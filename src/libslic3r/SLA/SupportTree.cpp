@@ -70,7 +70,8 @@ indexed_triangle_set create_support_tree(const SupportableMesh &sm,
 
 indexed_triangle_set create_pad(const SupportableMesh      &sm,
                                 const indexed_triangle_set &support_mesh,
-                                const JobController        &ctl)
+                                const JobController        &ctl,
+                                PadModelBlueprint          *model_blueprint)
 {
     constexpr float PadSamplingLH = 0.1f;
 
@@ -86,8 +87,14 @@ indexed_triangle_set create_pad(const SupportableMesh      &sm,
         // we sometimes call it "builtin pad" is enabled so we will
         // get a sample from the bottom of the mesh and use it for pad
         // creation.
-        sla::pad_blueprint(*sm.emesh.get_triangle_mesh(), model_contours,
-                           heights, ctl.cancelfn);
+        if (model_blueprint && model_blueprint->heights == heights) {
+            model_contours = model_blueprint->contours;
+        } else {
+            sla::pad_blueprint(*sm.emesh.get_triangle_mesh(), model_contours,
+                               heights, ctl.cancelfn);
+            if (model_blueprint)
+                *model_blueprint = PadModelBlueprint{heights, model_contours};
+        }
     }
 
     ExPolygons sup_contours;
@@ -110,46 +117,74 @@ std::vector<ExPolygons> slice(const indexed_triangle_set &sup_mesh,
                               float                       cr,
                               const JobController        &ctl)
 {
-    using Slices = std::vector<ExPolygons>;
+    std::vector<std::vector<ExPolygons>> out =
+        slice({SupportSlicingInput{&sup_mesh, &pad_mesh, &grid, cr}}, ctl);
 
-    auto slices = reserve_vector<Slices>(2);
+    return std::move(out.front());
+}
 
-    if (!sup_mesh.empty()) {
-        slices.emplace_back();
-        slices.back() = slice_mesh_ex(sup_mesh, grid, cr, ctl.cancelfn);
-    }
+std::vector<std::vector<ExPolygons>> slice(const std::vector<SupportSlicingInput> &inputs,
+                                           const JobController                    &ctl)
+{
+    using Slices = std::vector<ExPolygons>;
 
-    if (!pad_mesh.empty()) {
-        slices.emplace_back();
+    // The pads are sliced only up to their top.
+    std::vector<std::vector<float>> padgrids(inputs.size());
+    std::vector<MeshSlicingJob> jobs;
+    // Index of the support and of the pad job of each input, if any.
+    std::vector<std::pair<int, int>> job_idx(inputs.size(), {-1, -1});
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        const SupportSlicingInput &input = inputs[i];
+        MeshSlicingParamsEx params;
+        params.closing_radius = input.closing_radius;
+
+        if (!input.support_mesh->empty()) {
+            job_idx[i].first = int(jobs.size());
+            jobs.push_back({input.support_mesh, input.grid, params});
+        }
 
-        auto bb     = bounding_box(pad_mesh);
-        auto maxzit = std::upper_bound(grid.begin(), grid.end(), bb.max.z());
+        if (!input.pad_mesh->empty()) {
+            const std::vector<float> &grid = *input.grid;
 
-        auto cap     = grid.end() - maxzit;
-        auto padgrid = reserve_vector<float>(size_t(cap > 0 ? cap : 0));
-        std::copy(grid.begin(), maxzit, std::back_inserter(padgrid));
+            auto bb     = bounding_box(*input.pad_mesh);
+            auto maxzit = std::upper_bound(grid.begin(), grid.end(), bb.max.z());
 
-        slices.back() = slice_mesh_ex(pad_mesh, padgrid, cr, ctl.cancelfn);
+            auto cap     = grid.end() - maxzit;
+            auto padgrid = reserve_vector<float>(size_t(cap > 0 ? cap : 0));
+            std::copy(grid.begin(), maxzit, std::back_inserter(padgrid));
+            padgrids[i] = std::move(padgrid);
+
+            job_idx[i].second = int(jobs.size());
+            jobs.push_back({input.pad_mesh, &padgrids[i], params});
+        }
     }
 
-    size_t len = grid.size();
-    for (const Slices &slv : slices)
-        len = std::min(len, slv.size());
+    std::vector<Slices> sliced = slice_meshes_ex(jobs, ctl.cancelfn);
+
+    std::vector<Slices> out(inputs.size());
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        auto [sup_idx, pad_idx] = job_idx[i];
 
-    // Either the support or the pad or both has to be non empty
-    if (slices.empty()) return {};
+        // Either the support or the pad or both has to be non empty
+        if (sup_idx < 0 && pad_idx < 0) continue;
 
-    Slices &mrg = slices.front();
+        if (sup_idx < 0) {
+            out[i] = std::move(sliced[pad_idx]);
+            continue;
+        }
+
+        Slices &mrg = out[i] = std::move(sliced[sup_idx]);
+        if (pad_idx < 0) continue;
 
-    for (auto it = std::next(slices.begin()); it != slices.end(); ++it) {
-        for (size_t i = 0; i < len; ++i) {
-            Slices &slv = *it;
-            std::copy(slv[i].begin(), slv[i].end(), std::back_inserter(mrg[i]));
-            slv[i] = {}; // clear and delete
+        Slices &slv = sliced[pad_idx];
+        size_t len = std::min({inputs[i].grid->size(), mrg.size(), slv.size()});
+        for (size_t l = 0; l < len; ++l) {
+            std::copy(slv[l].begin(), slv[l].end(), std::back_inserter(mrg[l]));
+            slv[l] = {}; // clear and delete
         }
     }
 
-    return mrg;
+    return out;
 }
 
 }} // namespace Slic3r::sla
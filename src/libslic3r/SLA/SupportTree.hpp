@@ -151,9 +151,22 @@ inline double ground_level(const SupportableMesh &sm)
 indexed_triangle_set create_support_tree(const SupportableMesh &mesh,
                                          const JobController   &ctl);
 
+// The silhouette of the model sampled at the given heights for the pad. The
+// model mesh does not change for the lifetime of a SupportableMesh, so the
+// silhouette can be reused while only the supports or the pad parameters not
+// affecting the sampled heights change.
+struct PadModelBlueprint
+{
+    std::vector<float> heights;
+    ExPolygons         contours;
+};
+
+// If model_blueprint is given, the model silhouette is taken from it if
+// sampled at the same heights, otherwise it is sampled and stored into it.
 indexed_triangle_set create_pad(const SupportableMesh      &model_mesh,
                                 const indexed_triangle_set &support_mesh,
-                                const JobController        &ctl);
+                                const JobController        &ctl,
+                                PadModelBlueprint          *model_blueprint = nullptr);
 
 std::vector<ExPolygons> slice(const indexed_triangle_set &support_mesh,
                               const indexed_triangle_set &pad_mesh,
@@ -161,6 +174,20 @@ std::vector<ExPolygons> slice(const indexed_triangle_set &support_mesh,
                               float                       closing_radius,
                               const JobController        &ctl);
 
+// The support and pad meshes of an object to be sliced at its grid.
+struct SupportSlicingInput
+{
+    const indexed_triangle_set *support_mesh;
+    const indexed_triangle_set *pad_mesh;
+    const std::vector<float>   *grid;
+    float                       closing_radius;
+};
+
+// Slice the supports and pads of multiple objects at once, each the same way
+// as the slice() above.
+std::vector<std::vector<ExPolygons>> slice(const std::vector<SupportSlicingInput> &inputs,
+                                           const JobController                    &ctl);
+
 } // namespace sla
 } // namespace Slic3r
 
@@ -91,46 +91,62 @@ const indexed_triangle_set &SupportTreeBuilder::merged_mesh(size_t steps) const
 {
     if (m_meshcache_valid) return m_meshcache;
     
-    indexed_triangle_set merged;
-    
-    for (auto &head : m_heads) {
-        if (ctl().stopcondition()) break;
-        if (head.is_valid()) its_merge(merged, get_mesh(head, steps));
-    }
-    
-    for (auto &pill : m_pillars) {
-        if (ctl().stopcondition()) break;
-        its_merge(merged, get_mesh(pill, steps));
-    }
-
-    for (auto &pedest : m_pedestals) {
-        if (ctl().stopcondition()) break;
-        its_merge(merged, get_mesh(pedest, steps));
-    }
-    
-    for (auto &j : m_junctions) {
-        if (ctl().stopcondition()) break;
-        its_merge(merged, get_mesh(j, steps));
-    }
-
-    for (auto &bs : m_bridges) {
-        if (ctl().stopcondition()) break;
-        its_merge(merged, get_mesh(bs, steps));
-    }
-    
-    for (auto &bs : m_crossbridges) {
-        if (ctl().stopcondition()) break;
-        its_merge(merged, get_mesh(bs, steps));
-    }
-
-    for (auto &bs : m_diffbridges) {
-        if (ctl().stopcondition()) break;
-        its_merge(merged, get_mesh(bs, steps));
-    }
+    // Meshes of the individual support elements are generated in parallel,
+    // then copied into the merged mesh allocated at once.
+    std::vector<indexed_triangle_set> parts(
+        m_heads.size() + m_pillars.size() + m_pedestals.size() + m_junctions.size() +
+        m_bridges.size() + m_crossbridges.size() + m_diffbridges.size() + m_anchors.size());
+    size_t parts_offset = 0;
+    auto mesh_elements = [this, &parts, &parts_offset](const auto &elements, auto &&fn) {
+        execution::for_each(ex_tbb, size_t(0), elements.size(),
+            [this, &parts, &elements, &fn, parts_offset](size_t i) {
+                if (! ctl().stopcondition())
+                    parts[parts_offset + i] = fn(elements[i]);
+            });
+        parts_offset += elements.size();
+    };
+    auto mesh_element = [steps](const auto &el) { return get_mesh(el, steps); };
+
+    mesh_elements(m_heads, [steps](const Head &head) {
+        return head.is_valid() ? get_mesh(head, steps) : indexed_triangle_set{};
+    });
+    mesh_elements(m_pillars, mesh_element);
+    mesh_elements(m_pedestals, mesh_element);
+    // Junctions only differ by their radius and position, thus a single sphere is instanced.
+    const indexed_triangle_set unit_sphere = sphere(1., make_portion(0, PI), 2 * PI / steps);
+    mesh_elements(m_junctions, [&unit_sphere](const Junction &j) {
+        indexed_triangle_set mesh = unit_sphere;
+        const auto  r   = float(j.r);
+        const Vec3f pos = j.pos.cast<float>();
+        for (stl_vertex &v : mesh.vertices)
+            v = v * r + pos;
+        return mesh;
+    });
+    mesh_elements(m_bridges, mesh_element);
+    mesh_elements(m_crossbridges, mesh_element);
+    mesh_elements(m_diffbridges, mesh_element);
+    mesh_elements(m_anchors, mesh_element);
 
-    for (auto &anch : m_anchors) {
-        if (ctl().stopcondition()) break;
-        its_merge(merged, get_mesh(anch, steps));
+    indexed_triangle_set merged;
+    if (! ctl().stopcondition()) {
+        std::vector<size_t> vertices_offsets(parts.size() + 1, 0);
+        std::vector<size_t> indices_offsets(parts.size() + 1, 0);
+        for (size_t i = 0; i < parts.size(); ++ i) {
+            vertices_offsets[i + 1] = vertices_offsets[i] + parts[i].vertices.size();
+            indices_offsets[i + 1]  = indices_offsets[i] + parts[i].indices.size();
+        }
+        merged.vertices.resize(vertices_offsets.back());
+        merged.indices.resize(indices_offsets.back());
+        execution::for_each(ex_tbb, size_t(0), parts.size(),
+            [&parts, &merged, &vertices_offsets, &indices_offsets](size_t i) {
+                indexed_triangle_set &part = parts[i];
+                std::copy(part.vertices.begin(), part.vertices.end(), merged.vertices.begin() + vertices_offsets[i]);
+                const auto offset = int(vertices_offsets[i]);
+                std::transform(part.indices.begin(), part.indices.end(), merged.indices.begin() + indices_offsets[i],
+                    [offset](const stl_triangle_vertex_indices &face) { return face + stl_triangle_vertex_indices(offset, offset, offset); });
+                // Release the part early, the merged mesh of dense supports may be huge.
+                part = {};
+            });
     }
 
     if (ctl().stopcondition()) {
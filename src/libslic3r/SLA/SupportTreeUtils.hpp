@@ -166,29 +166,38 @@ Hit beam_mesh_hit(Ex policy,
     // Hit results
     std::array<Hit, RayCount> hits;
 
+    // The rays sampling the beam are coherent, thus they are traced by packets.
+    std::array<Vec3d, RayCount> p_srcs, sources, raydirs;
+    for (size_t i = 0; i < RayCount; ++i) {
+        // Point on the circle on the pin sphere
+        p_srcs[i] = ring.get(i, src, r_src + sd);
+        Vec3d p_dst = ring.get(i, dst, r_dst + sd);
+        raydirs[i] = (p_dst - p_srcs[i]).normalized();
+        sources[i] = p_srcs[i] + r_src * raydirs[i];
+    }
+
+    static constexpr size_t PacketSize = 8;
+    const size_t num_packets = (RayCount + PacketSize - 1) / PacketSize;
     execution::for_each(
-        policy, size_t(0), hits.size(),
-        [&mesh, r_src, r_dst, src, dst, &ring, dir, sd, &hits](size_t i) {
-            Hit &hit = hits[i];
-
-            // Point on the circle on the pin sphere
-            Vec3d p_src = ring.get(i, src, r_src + sd);
-            Vec3d p_dst = ring.get(i, dst, r_dst + sd);
-            Vec3d raydir = (p_dst - p_src).normalized();
-
-            auto hr = mesh.query_ray_hit(p_src + r_src * raydir, raydir);
-
-            if (hr.is_inside()) {
-                if (hr.distance() > 2 * r_src + sd)
-                    hit = Hit(0.0);
-                else {
-                    // re-cast the ray from the outside of the object
-                    auto q = p_src + (hr.distance() + EPSILON) * raydir;
-                    hit = mesh.query_ray_hit(q, raydir);
+        policy, size_t(0), num_packets,
+        [&mesh, r_src, sd, &p_srcs, &sources, &raydirs, &hits](size_t ipacket) {
+            size_t begin = ipacket * PacketSize;
+            size_t end   = std::min(RayCount, begin + PacketSize);
+            mesh.query_ray_hit(sources.data() + begin, raydirs.data() + begin, end - begin, hits.data() + begin);
+
+            for (size_t i = begin; i < end; ++i) {
+                Hit &hit = hits[i];
+                if (hit.is_inside()) {
+                    if (hit.distance() > 2 * r_src + sd)
+                        hit = Hit(0.0);
+                    else {
+                        // re-cast the ray from the outside of the object
+                        auto q = p_srcs[i] + (hit.distance() + EPSILON) * raydirs[i];
+                        hit = mesh.query_ray_hit(q, raydirs[i]);
+                    }
                 }
-            } else
-                hit = hr;
-        }, std::min(execution::max_concurrency(policy), RayCount));
+            }
+        }, std::min(execution::max_concurrency(policy), num_packets));
 
     return min_hit(hits.begin(), hits.end());
 }
@@ -233,48 +242,55 @@ Hit pinhead_mesh_hit(Ex              ex,
     // of the pinhead robe (side) surface. The result will be the smallest
     // hit distance.
 
+    // The rays are coherent, thus they are traced by packets.
+    std::array<Vec3d, SAMPLES> pss, sources, dirs;
+    for (size_t i = 0; i < SAMPLES; ++i) {
+        // Point on the circle on the pin sphere
+        pss[i] = rings.pinring(i);
+        // This is the point on the circle on the back sphere
+        Vec3d p = rings.backring(i);
+        dirs[i] = (p - pss[i]).normalized();
+        sources[i] = pss[i] + sd * dirs[i];
+    }
+
+    static constexpr size_t PacketSize = 8;
+    static_assert(SAMPLES % PacketSize == 0);
     execution::for_each(
-        ex, size_t(0), hits.size(), [&m, &rings, sd, &hits](size_t i) {
-            // Point on the circle on the pin sphere
-            Vec3d ps = rings.pinring(i);
-            // This is the point on the circle on the back sphere
-            Vec3d p = rings.backring(i);
-
-            auto &hit = hits[i];
-
-               // Point ps is not on mesh but can be inside or
-               // outside as well. This would cause many problems
-               // with ray-casting. To detect the position we will
-               // use the ray-casting result (which has an is_inside
-               // predicate).
-
-            Vec3d n = (p - ps).normalized();
-            auto  q = m.query_ray_hit(ps + sd * n, n);
-
-            if (q.is_inside()) { // the hit is inside the model
-                if (q.distance() > rings.rpin) {
-                    // If we are inside the model and the hit
-                    // distance is bigger than our pin circle
-                    // diameter, it probably indicates that the
-                    // support point was already inside the
-                    // model, or there is really no space
-                    // around the point. We will assign a zero
-                    // hit distance to these cases which will
-                    // enforce the function return value to be
-                    // an invalid ray with zero hit distance.
-                    // (see min_element at the end)
-                    hit = HitResult(0.0);
-                } else {
-                    // re-cast the ray from the outside of the
-                    // object. The starting point has an offset
-                    // of 2*safety_distance because the
-                    // original ray has also had an offset
-                    auto q2 = m.query_ray_hit(ps + (q.distance() + 2 * sd) * n, n);
-                    hit     = q2;
+        ex, size_t(0), SAMPLES / PacketSize, [&m, &rings, &pss, &sources, &dirs, sd, &hits](size_t ipacket) {
+            size_t begin = ipacket * PacketSize;
+
+            // Point ps is not on mesh but can be inside or
+            // outside as well. This would cause many problems
+            // with ray-casting. To detect the position we will
+            // use the ray-casting result (which has an is_inside
+            // predicate).
+            m.query_ray_hit(sources.data() + begin, dirs.data() + begin, PacketSize, hits.data() + begin);
+
+            for (size_t i = begin; i < begin + PacketSize; ++i) {
+                auto &hit = hits[i];
+                if (hit.is_inside()) { // the hit is inside the model
+                    if (hit.distance() > rings.rpin) {
+                        // If we are inside the model and the hit
+                        // distance is bigger than our pin circle
+                        // diameter, it probably indicates that the
+                        // support point was already inside the
+                        // model, or there is really no space
+                        // around the point. We will assign a zero
+                        // hit distance to these cases which will
+                        // enforce the function return value to be
+                        // an invalid ray with zero hit distance.
+                        // (see min_element at the end)
+                        hit = HitResult(0.0);
+                    } else {
+                        // re-cast the ray from the outside of the
+                        // object. The starting point has an offset
+                        // of 2*safety_distance because the
+                        // original ray has also had an offset
+                        hit = m.query_ray_hit(pss[i] + (hit.distance() + 2 * sd) * dirs[i], dirs[i]);
+                    }
                 }
-            } else
-                hit = q;
-        }, std::min(execution::max_concurrency(ex), SAMPLES));
+            }
+        }, std::min(execution::max_concurrency(ex), SAMPLES / PacketSize));
 
     return min_hit(hits.begin(), hits.end());
 }
@@ -120,8 +120,10 @@ ExPolygons intersect_layers(const std::vector<ExPolygons> &slices,
     size_t drill_to = std::min(layer_from, layers_down);
     auto drill_to_layer = static_cast<int>(layer_from - drill_to);
 
+    // The layer itself does not need to be intersected with itself, and once
+    // the intersection is empty, the layers further down do not change it.
     ExPolygons merged_lyr = slices[layer_from];
-    for (int i = layer_from; i >= drill_to_layer; --i)
+    for (int i = int(layer_from) - 1; i >= drill_to_layer && !merged_lyr.empty(); --i)
         merged_lyr = intersection_ex(merged_lyr, slices[i]);
 
     return merged_lyr;
@@ -13,6 +13,7 @@
 #include "Format/SLAArchiveFormatRegistry.hpp"
 
 #include "Geometry.hpp"
+#include "MemoryUsage.hpp"
 #include "Thread.hpp"
 
 #include <unordered_set>
@@ -704,9 +705,36 @@ std::string SLAPrint::validate(std::vector<std::string>*) const
     return "";
 }
 
+void SLAPrint::set_rasterize_on_export(bool value)
+{
+    if (m_rasterize_on_export != value) {
+        m_rasterize_on_export = value;
+        // The layers are either rasterized by slapsRasterize or by the export.
+        this->invalidate_step(slapsRasterize);
+    }
+}
+
+void SLAPrint::set_slice_based_preview(bool value)
+{
+    if (m_slice_based_preview != value) {
+        m_slice_based_preview = value;
+        // The previews are generated by the object steps which combine the parts.
+        for (SLAPrintObject *po : m_objects)
+            po->invalidate_step(slaposAssembly);
+    }
+}
+
 void SLAPrint::export_print(const std::string &fname, const ThumbnailsList &thumbnails, const std::string &projectname)
 {
-    if (m_archiver)
+    if (m_archiver && m_rasterize_on_export)
+        m_archiver->draw_and_export_print(fname, *this, m_printer_input.size(),
+            [this](sla::RasterBase &raster, size_t idx) {
+                for (const ExPolygon &poly : m_printer_input[idx].transformed_slices())
+                    raster.draw(poly);
+            },
+            [this]() { return this->canceled(); },
+            thumbnails, projectname);
+    else if (m_archiver)
         m_archiver->export_print(fname, *this, thumbnails, projectname);
     else {
         throw ExportError(format(_u8L("Unknown archive format: %s"), m_printer_config.sla_archive_format.value));
@@ -794,6 +822,7 @@ void SLAPrint::process()
                     bench.start();
                     printsteps.execute(step, *po);
                     bench.stop();
+                    trace_memory_usage(*this);
                     step_times[step] += bench.getElapsedSec();
                     throw_if_canceled();
                     po->set_done(step);
@@ -804,8 +833,37 @@ void SLAPrint::process()
         }
     };
 
+    // The steps of the second level are executed on all the objects at once.
+    auto apply_steps_on_all_objects =
+        [this, &st, &printsteps, &step_times, &bench]
+        (const std::vector<SLAPrintObjectStep> &steps)
+    {
+        for (SLAPrintObjectStep step : steps) {
+            throw_if_canceled();
+
+            std::vector<SLAPrintObject*> started;
+            for (SLAPrintObject *po : m_objects)
+                if (po->set_started(step))
+                    started.emplace_back(po);
+
+            if (!started.empty()) {
+                m_report_status(*this, st, printsteps.label(step));
+                bench.start();
+                printsteps.execute(step, started);
+                bench.stop();
+                trace_memory_usage(*this);
+                step_times[step] += bench.getElapsedSec();
+                throw_if_canceled();
+                for (SLAPrintObject *po : started)
+                    po->set_done(step);
+            }
+
+            st += printsteps.progressrange(step) * started.size();
+        }
+    };
+
     apply_steps_on_objects(level1_obj_steps);
-    apply_steps_on_objects(level2_obj_steps);
+    apply_steps_on_all_objects(level2_obj_steps);
 
     st = Steps::max_objstatus;
     for(SLAPrintStep currentstep : print_steps) {
@@ -816,6 +874,7 @@ void SLAPrint::process()
             bench.start();
             printsteps.execute(currentstep);
             bench.stop();
+            trace_memory_usage(*this);
             step_times[slaposCount + currentstep] += bench.getElapsedSec();
             throw_if_canceled();
             set_done(currentstep);
@@ -1079,6 +1138,14 @@ bool SLAPrintObject::invalidate_state_by_config_options(const std::vector<t_conf
 bool SLAPrintObject::invalidate_step(SLAPrintObjectStep step)
 {
     bool invalidated = Inherited::invalidate_step(step);
+
+    if (invalidated) {
+        // The lazy previews refer to the parts of the invalidated steps, which may go away.
+        std::lock_guard lk{m_preview_mutex};
+        for (size_t i = size_t(step); i < m_preview_mesh_generators.size(); ++i)
+            m_preview_mesh_generators[i] = {};
+    }
+
     // propagate to dependent steps
     if (step == slaposAssembly) {
         invalidated |= this->invalidate_all_steps();
@@ -1221,9 +1288,16 @@ SLAPrintObject::get_mesh_to_print() const
 {
     int s = last_completed_step();
 
-    while (s > 0 && ! m_preview_meshes[s])
+    std::lock_guard lk{m_preview_mutex};
+
+    while (s > 0 && ! m_preview_meshes[s] && ! m_preview_mesh_generators[s])
         --s;
 
+    if (m_preview_mesh_generators[s]) {
+        m_preview_meshes[s] = std::make_shared<const indexed_triangle_set>(m_preview_mesh_generators[s]());
+        m_preview_mesh_generators[s] = {};
+    }
+
     return m_preview_meshes[s];
 }
 
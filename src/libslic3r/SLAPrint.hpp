@@ -327,6 +327,7 @@ protected:
     // to be called from SLAPrint only.
     friend class SLAPrint;
     friend class PrintBaseWithState<SLAPrintStep, slapsCount>;
+    friend void trace_memory_usage(const SLAPrint &print);
 
 	SLAPrintObject(SLAPrint* print, ModelObject* model_object);
     ~SLAPrintObject();
@@ -376,6 +377,8 @@ private:
         sla::SupportableMesh    input; // the input
         std::vector<ExPolygons> support_slices;   // sliced supports
         TriangleMesh tree_mesh, pad_mesh, full_mesh; // cached artifacts
+        // Model silhouette of the pad, unchanged while only the supports change
+        sla::PadModelBlueprint pad_model_blueprint;
         
         inline SupportData(const TriangleMesh &t)
             : input{t.its, {}, {}}
@@ -392,7 +395,7 @@ private:
 
         void create_pad(const sla::JobController &ctl)
         {
-            pad_mesh = TriangleMesh{sla::create_pad(input, tree_mesh.its, ctl)};
+            pad_mesh = TriangleMesh{sla::create_pad(input, tree_mesh.its, ctl, &pad_model_blueprint)};
         }
     };
 
@@ -414,7 +417,12 @@ private:
     // all its holes and cavities, negatives and positive volumes unified.
     // Essentially this should be a m_mesh_to_slice after the CSG operations
     // or an approximation of that.
-    std::array<std::shared_ptr<const indexed_triangle_set>, SLAPrintObjectStep::slaposCount + 1> m_preview_meshes;
+    mutable std::array<std::shared_ptr<const indexed_triangle_set>, SLAPrintObjectStep::slaposCount + 1> m_preview_meshes;
+
+    // With SLAPrint::slice_based_preview(), the preview of a step is only generated
+    // from the slices of m_mesh_to_slice when get_mesh_to_print() asks for it.
+    mutable std::array<std::function<indexed_triangle_set()>, SLAPrintObjectStep::slaposCount + 1> m_preview_mesh_generators;
+    mutable std::mutex m_preview_mutex;
 
     class HollowingData
     {
@@ -424,6 +432,16 @@ private:
     };
     
     std::unique_ptr<HollowingData> m_hollowing_data;
+
+    // Distance field of the assembled mesh, see sla::generate_interior_grid(). Kept until the mesh is assembled again,
+    // thus changing just the wall thickness or the closing distance does not voxelize the mesh again.
+    struct HollowingGrid
+    {
+        VoxelGridPtr grid;
+        double       quality = 0.;
+    };
+
+    HollowingGrid m_hollowing_grid;
 };
 
 using PrintObjects = std::vector<SLAPrintObject*>;
@@ -587,6 +605,18 @@ public:
                       const ThumbnailsList &thumbnails,
                       const std::string    &projectname = "");
 
+    // Rasterize the layers by export_print() instead of by slapsRasterize, so that the encoded layers are written
+    // into the archive as they are done instead of being all held in memory. Suitable for a single export
+    // (command line), as each export rasterizes the layers again.
+    void set_rasterize_on_export(bool value);
+    bool rasterize_on_export() const { return m_rasterize_on_export; }
+
+    // Combine negative volumes, hollowing and drill holes of the previews only by slicing
+    // the parts with 2D booleans, the same way as the print is sliced, instead of doing
+    // 3D mesh booleans. The preview meshes are generated from the slices on demand.
+    void set_slice_based_preview(bool value);
+    bool slice_based_preview() const { return m_slice_based_preview; }
+
     static bool is_prusa_print(const std::string& printer_model);
     
 private:
@@ -612,6 +642,9 @@ private:
     
     // Estimated print time, material consumed.
     SLAPrintStatistics              m_print_statistics;
+
+    bool                            m_rasterize_on_export = false;
+    bool                            m_slice_based_preview = false;
     
     class StatusReporter
     {
@@ -15,6 +15,8 @@
 #include <libslic3r/CSGMesh/SliceCSGMesh.hpp>
 #include <libslic3r/CSGMesh/VoxelizeCSGMesh.hpp>
 #include <libslic3r/CSGMesh/PerformCSGMeshBooleans.hpp>
+#include <libslic3r/CSGMesh/CSGMeshCopy.hpp>
+#include <libslic3r/SlicesToTriangleMesh.hpp>
 #include <libslic3r/OpenVDBUtils.hpp>
 #include <libslic3r/QuadricEdgeCollapse.hpp>
 #include <libslic3r/ClipperUtils.hpp>
@@ -56,6 +58,7 @@
 #include "libslic3r/SLA/SupportTreeStrategies.hpp"
 #include "libslic3r/SLA/SupportIslands/SampleConfigFactory.hpp"
 #include "libslic3r/SLAPrint.hpp"
+#include "libslic3r/Trace.hpp"
 #include "libslic3r/TriangleMesh.hpp"
 
 namespace Slic3r {
@@ -226,6 +229,42 @@ void SLAPrint::Steps::apply_printer_corrections(SLAPrintObject &po, SliceOrigin
     }
 }
 
+template<class Cont> BoundingBoxf3 csgmesh_positive_bb(const Cont &csg)
+{
+    // Calculate the biggest possible bounding box of the mesh to be sliced
+    // from all the positive parts that it contains.
+    BoundingBoxf3 bb3d;
+
+    bool skip = false;
+    for (const auto &m : csg) {
+        auto op = csg::get_operation(m);
+        auto stackop = csg::get_stack_operation(m);
+        if (stackop == csg::CSGStackOp::Push && op != csg::CSGType::Union)
+            skip = true;
+
+        if (!skip && csg::get_mesh(m) && op == csg::CSGType::Union)
+            bb3d.merge(bounding_box(*csg::get_mesh(m), csg::get_transform(m)));
+
+        if (stackop == csg::CSGStackOp::Pop)
+            skip = false;
+    }
+
+    return bb3d;
+}
+
+static MeshSlicingParamsEx get_slicing_params(const SLAPrintObjectConfig &cfg)
+{
+    MeshSlicingParamsEx params;
+    params.closing_radius = float(cfg.slice_closing_radius.value);
+    switch (cfg.slicing_mode.value) {
+    case SlicingMode::Regular:    params.mode = MeshSlicingParams::SlicingMode::Regular; break;
+    case SlicingMode::EvenOdd:    params.mode = MeshSlicingParams::SlicingMode::EvenOdd; break;
+    case SlicingMode::CloseHoles: params.mode = MeshSlicingParams::SlicingMode::Positive; break;
+    }
+
+    return params;
+}
+
 indexed_triangle_set SLAPrint::Steps::generate_preview_vdb(
     SLAPrintObject &po, SLAPrintObjectStep step)
 {
@@ -249,11 +288,37 @@ indexed_triangle_set SLAPrint::Steps::generate_preview_vdb(
     auto grid = csg::voxelize_csgmesh(r, voxparams);
     auto m = grid ? grid_to_mesh(*grid, 0., 0.01) : indexed_triangle_set{};
     float loss_less_max_error = float(1e-6);
-    its_quadric_edge_collapse(m, 0U, &loss_less_max_error);
+    its_quadric_edge_collapse_parallel(m, 0U, &loss_less_max_error);
 
     return m;
 }
 
+std::function<indexed_triangle_set()> SLAPrint::Steps::generate_preview_slices(SLAPrintObject &po)
+{
+    // The parts are captured by the generator, the meshes are shared with the
+    // print object. Invalidating the step drops the generator, see
+    // SLAPrintObject::invalidate_step().
+    // CSGPart is move only, while std::function requires a copyable generator.
+    auto parts = std::make_shared<std::vector<csg::CSGPart>>();
+    csg::copy_csgrange_shallow(range(po.m_mesh_to_slice), std::back_inserter(*parts));
+
+    return [parts = std::shared_ptr<const std::vector<csg::CSGPart>>(std::move(parts)),
+            lh = po.m_config.layer_height.getFloat(),
+            params = get_slicing_params(po.config())]() {
+        BoundingBoxf3 bb = csgmesh_positive_bb(*parts);
+        if (!bb.defined || bb.max.z() - bb.min.z() < lh)
+            return indexed_triangle_set{};
+
+        std::vector<float> slicegrid;
+        for (double z = bb.min.z() + lh / 2.; z < bb.max.z(); z += lh)
+            slicegrid.emplace_back(float(z));
+
+        std::vector<ExPolygons> slices = slice_csgmesh_ex(range(*parts), slicegrid, params);
+
+        return slices_to_mesh(slices, bb.min.z(), lh, lh);
+    };
+}
+
 void SLAPrint::Steps::generate_preview(SLAPrintObject &po, SLAPrintObjectStep step)
 {
     using std::chrono::high_resolution_clock;
@@ -263,6 +328,25 @@ void SLAPrint::Steps::generate_preview(SLAPrintObject &po, SLAPrintObjectStep st
     auto r = range(po.m_mesh_to_slice);
     auto m = indexed_triangle_set{};
 
+    using namespace std::string_literals;
+
+    if (m_print->m_slice_based_preview && !is_all_positive(r)) {
+        // No 3D booleans, the preview is generated from the slices when it is requested.
+        {
+            std::lock_guard lk{po.m_preview_mutex};
+            po.m_preview_meshes[step] = {};
+            po.m_preview_mesh_generators[step] = generate_preview_slices(po);
+
+            for (size_t i = size_t(step) + 1; i < slaposCount; ++i) {
+                po.m_preview_meshes[i] = {};
+                po.m_preview_mesh_generators[i] = {};
+            }
+        }
+
+        report_status(-2, "Reload preview from step "s + std::to_string(int(step)), SlicingStatus::RELOAD_SLA_PREVIEW);
+        return;
+    }
+
     bool handled   = false;
 
     if (is_all_positive(r)) {
@@ -365,12 +449,17 @@ void SLAPrint::Steps::generate_preview(SLAPrintObject &po, SLAPrintObjectStep st
         m = generate_preview_vdb(po, step);
     }
 
-    po.m_preview_meshes[step] =
-            std::make_shared<const indexed_triangle_set>(std::move(m));
-
-    for (size_t i = size_t(step) + 1; i < slaposCount; ++i)
     {
-        po.m_preview_meshes[i] = {};
+        std::lock_guard lk{po.m_preview_mutex};
+        po.m_preview_meshes[step] =
+                std::make_shared<const indexed_triangle_set>(std::move(m));
+        po.m_preview_mesh_generators[step] = {};
+
+        for (size_t i = size_t(step) + 1; i < slaposCount; ++i)
+        {
+            po.m_preview_meshes[i] = {};
+            po.m_preview_mesh_generators[i] = {};
+        }
     }
 
     auto stop{high_resolution_clock::now()};
@@ -383,8 +472,6 @@ void SLAPrint::Steps::generate_preview(SLAPrintObject &po, SLAPrintObjectStep st
     } else
         BOOST_LOG_TRIVIAL(error) << "Preview failed!";
 
-    using namespace std::string_literals;
-
     report_status(-2, "Reload preview from step "s + std::to_string(int(step)), SlicingStatus::RELOAD_SLA_PREVIEW);
 }
 
@@ -413,6 +500,7 @@ void SLAPrint::Steps::mesh_assembly(SLAPrintObject &po)
     po.m_mesh_to_slice.clear();
     po.m_supportdata.reset();
     po.m_hollowing_data.reset();
+    po.m_hollowing_grid = {};
 
     csg::model_to_csgmesh(*po.model_object(), po.trafo(),
                           csg_inserter{po.m_mesh_to_slice, slaposAssembly},
@@ -430,6 +518,7 @@ void SLAPrint::Steps::hollow_model(SLAPrintObject &po)
 
     if (! po.m_config.hollowing_enable.getBool()) {
         BOOST_LOG_TRIVIAL(info) << "Skipping hollowing step!";
+        po.m_hollowing_grid = {};
         return;
     }
 
@@ -443,8 +532,18 @@ void SLAPrint::Steps::hollow_model(SLAPrintObject &po)
     ctl.stopcondition = [this]() { return canceled(); };
     ctl.cancelfn = [this]() { throw_if_canceled(); };
 
-    sla::InteriorPtr interior =
-        generate_interior(po.mesh_to_slice(), hlwcfg, ctl);
+    if (! po.m_hollowing_grid.grid || po.m_hollowing_grid.quality != quality) {
+        po.m_hollowing_grid = {};
+        if (VoxelGridPtr grid = sla::generate_interior_grid(po.mesh_to_slice(), hlwcfg, ctl); grid && ! canceled())
+            po.m_hollowing_grid = { std::move(grid), quality };
+    } else
+        BOOST_LOG_TRIVIAL(info) << "Reusing the distance field of the previous hollowing step";
+
+    throw_if_canceled();
+
+    sla::InteriorPtr interior;
+    if (po.m_hollowing_grid.grid)
+        interior = sla::generate_interior(*po.m_hollowing_grid.grid, hlwcfg, ctl);
 
     if (!interior || sla::get_mesh(*interior).empty())
         BOOST_LOG_TRIVIAL(warning) << "Hollowed interior is empty!";
@@ -457,7 +556,7 @@ void SLAPrint::Steps::hollow_model(SLAPrintObject &po)
         if (!m.empty()) {
             // simplify mesh lossless
             float loss_less_max_error = 2*std::numeric_limits<float>::epsilon();
-            its_quadric_edge_collapse(m, 0U, &loss_less_max_error);
+            its_quadric_edge_collapse_parallel(m, 0U, &loss_less_max_error);
 
             its_compactify_vertices(m);
             its_merge_vertices(m);
@@ -516,29 +615,6 @@ static std::vector<ExPolygons> slice_volumes(
     return out;
 }
 
-template<class Cont> BoundingBoxf3 csgmesh_positive_bb(const Cont &csg)
-{
-    // Calculate the biggest possible bounding box of the mesh to be sliced
-    // from all the positive parts that it contains.
-    BoundingBoxf3 bb3d;
-
-    bool skip = false;
-    for (const auto &m : csg) {
-        auto op = csg::get_operation(m);
-        auto stackop = csg::get_stack_operation(m);
-        if (stackop == csg::CSGStackOp::Push && op != csg::CSGType::Union)
-            skip = true;
-
-        if (!skip && csg::get_mesh(m) && op == csg::CSGType::Union)
-            bb3d.merge(bounding_box(*csg::get_mesh(m), csg::get_transform(m)));
-
-        if (stackop == csg::CSGStackOp::Pop)
-            skip = false;
-    }
-
-    return bb3d;
-}
-
 void SLAPrint::Steps::prepare_for_generate_supports(SLAPrintObject &po) {
     using namespace sla;
     std::vector<ExPolygons> slices = po.get_model_slices(); // copy
@@ -614,13 +690,7 @@ void SLAPrint::Steps::slice_model(SLAPrintObject &po)
         po.m_model_height_levels.emplace_back(it->slice_level());
 
     po.m_model_slices.clear();
-    MeshSlicingParamsEx params;
-    params.closing_radius = float(po.config().slice_closing_radius.value);
-    switch (po.config().slicing_mode.value) {
-    case SlicingMode::Regular:    params.mode = MeshSlicingParams::SlicingMode::Regular; break;
-    case SlicingMode::EvenOdd:    params.mode = MeshSlicingParams::SlicingMode::EvenOdd; break;
-    case SlicingMode::CloseHoles: params.mode = MeshSlicingParams::SlicingMode::Positive; break;
-    }
+    MeshSlicingParamsEx params = get_slicing_params(po.config());
     auto  thr        = [this]() { m_print->throw_if_canceled(); };
     auto &slice_grid = po.m_model_height_levels;
 
@@ -938,32 +1008,59 @@ void SLAPrint::Steps::generate_pad(SLAPrintObject &po) {
 // If the pad had been added previously (see step "base_pool" than it will
 // be part of the slices)
 void SLAPrint::Steps::slice_supports(SLAPrintObject &po) {
-    auto& sd = po.m_supportdata;
+    slice_supports(std::vector<SLAPrintObject*>{ &po });
+}
 
-    if(sd) sd->support_slices.clear();
+void SLAPrint::Steps::slice_supports(const std::vector<SLAPrintObject*> &objects) {
+    // Objects with supports or pad to be sliced. Slicing the small support
+    // meshes of many objects one by one is dominated by the fixed overhead of
+    // each parallel slicing, so all of them are sliced together.
+    std::vector<SLAPrintObject*> to_slice;
+    auto heights = reserve_vector<std::vector<float>>(objects.size());
+    auto inputs  = reserve_vector<sla::SupportSlicingInput>(objects.size());
 
-    // Don't bother if no supports and no pad is present.
-    if (!po.m_config.supports_enable.getBool() && !po.m_config.pad_enable.getBool())
-        return;
+    for (SLAPrintObject *po : objects) {
+        auto& sd = po->m_supportdata;
+
+        if(sd) sd->support_slices.clear();
 
-    if(sd) {
-        auto heights = reserve_vector<float>(po.m_slice_index.size());
+        // Don't bother if no supports and no pad is present.
+        if (!po->m_config.supports_enable.getBool() && !po->m_config.pad_enable.getBool())
+            continue;
 
-        for(auto& rec : po.m_slice_index) heights.emplace_back(rec.slice_level());
+        to_slice.emplace_back(po);
 
-        sla::JobController ctl;
-        ctl.stopcondition = [this]() { return canceled(); };
-        ctl.cancelfn = [this]() { throw_if_canceled(); };
+        if(sd) {
+            std::vector<float> &h = heights.emplace_back(reserve_vector<float>(po->m_slice_index.size()));
 
-        sd->support_slices =
-            sla::slice(sd->tree_mesh.its, sd->pad_mesh.its, heights,
-                       float(po.config().slice_closing_radius.value), ctl);
+            for(auto& rec : po->m_slice_index) h.emplace_back(rec.slice_level());
+
+            inputs.push_back({&sd->tree_mesh.its, &sd->pad_mesh.its, &h,
+                              float(po->config().slice_closing_radius.value)});
+        }
     }
 
-    for (size_t i = 0; i < sd->support_slices.size() && i < po.m_slice_index.size(); ++i)
-        po.m_slice_index[i].set_support_slice_idx(po, i);
+    if (to_slice.empty())
+        return;
 
-    apply_printer_corrections(po, soSupport);
+    sla::JobController ctl;
+    ctl.stopcondition = [this]() { return canceled(); };
+    ctl.cancelfn = [this]() { throw_if_canceled(); };
+
+    std::vector<std::vector<ExPolygons>> slices = sla::slice(inputs, ctl);
+
+    size_t idx = 0;
+    for (SLAPrintObject *po : to_slice) {
+        auto& sd = po->m_supportdata;
+        if (sd) {
+            sd->support_slices = std::move(slices[idx++]);
+
+            for (size_t i = 0; i < sd->support_slices.size() && i < po->m_slice_index.size(); ++i)
+                po->m_slice_index[i].set_support_slice_idx(*po, i);
+        }
+
+        apply_printer_corrections(*po, soSupport);
+    }
 
     // Using RELOAD_SLA_PREVIEW to tell the Plater to pass the update
     // status to the 3D preview to load the SLA slices.
@@ -1297,7 +1394,7 @@ void SLAPrint::Steps::merge_slices_and_eval_stats() {
     // Going to parallel:
     auto printlayerfn = [this,
             // functions and read only vars
-            area_fill, display_area, exp_time, init_exp_time, fast_tilt, slow_tilt, hv_tilt, material_config, delta_fade_time, is_prusa_print, first_slow_layers, below, above,
+            area_fill, display_area, exp_time, init_exp_time, fast_tilt, slow_tilt, hv_tilt, &material_config, delta_fade_time, is_prusa_print, first_slow_layers, &below, &above,
 
             // write vars
             &layers_info](size_t sliced_layer_cnt)
@@ -1456,7 +1553,7 @@ void SLAPrint::Steps::merge_slices_and_eval_stats() {
 // Rasterizing the model objects, and their supports
 void SLAPrint::Steps::rasterize()
 {
-    if(canceled() || !m_print->m_archiver) return;
+    if(canceled() || !m_print->m_archiver || m_print->m_rasterize_on_export) return;
 
     // coefficient to map the rasterization state (0-99) to the allocated
     // portion (slot) of the process state
@@ -1502,6 +1599,7 @@ void SLAPrint::Steps::rasterize()
     // Print all the layers in parallel
     m_print->m_archiver->draw_layers(m_print->m_printer_input.size(), lvlfn,
                                     [this]() { return canceled(); }, ex_tbb);
+    Trace::counter("SLA rasters", "Memory", -1, int64_t(m_print->m_archiver->memory_used()));
 }
 
 std::string SLAPrint::Steps::label(SLAPrintObjectStep step)
@@ -1526,6 +1624,10 @@ double SLAPrint::Steps::progressrange(SLAPrintStep step) const
 
 void SLAPrint::Steps::execute(SLAPrintObjectStep step, SLAPrintObject &obj)
 {
+    static const char *step_names[] = { "slaposAssembly", "slaposHollowing", "slaposDrillHoles", "slaposObjectSlice",
+        "slaposSupportPoints", "slaposSupportTree", "slaposPad", "slaposSliceSupports" };
+    static_assert(std::size(step_names) == slaposCount);
+    Trace::Span trace_span(step < slaposCount ? step_names[step] : "slaposCount", "SLAPrintObject", obj.id().id);
     switch(step) {
     case slaposAssembly: mesh_assembly(obj); break;
     case slaposHollowing: hollow_model(obj); break;
@@ -1539,8 +1641,21 @@ void SLAPrint::Steps::execute(SLAPrintObjectStep step, SLAPrintObject &obj)
     }
 }
 
+void SLAPrint::Steps::execute(SLAPrintObjectStep step, const std::vector<SLAPrintObject*> &objects)
+{
+    if (step == slaposSliceSupports) {
+        Trace::Span trace_span("slaposSliceSupports", "SLAPrint");
+        slice_supports(objects);
+    } else
+        for (SLAPrintObject *po : objects)
+            execute(step, *po);
+}
+
 void SLAPrint::Steps::execute(SLAPrintStep step)
 {
+    static const char *step_names[] = { "slapsMergeSlicesAndEval", "slapsRasterize" };
+    static_assert(std::size(step_names) == slapsCount);
+    Trace::Span trace_span(step < slapsCount ? step_names[step] : "slapsCount", "SLAPrint");
     switch (step) {
     case slapsMergeSlicesAndEval: merge_slices_and_eval_stats(); break;
     case slapsRasterize: rasterize(); break;
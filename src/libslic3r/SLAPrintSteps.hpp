@@ -55,6 +55,7 @@ private:
 
     void generate_preview(SLAPrintObject &po, SLAPrintObjectStep step);
     indexed_triangle_set generate_preview_vdb(SLAPrintObject &po, SLAPrintObjectStep step);
+    std::function<indexed_triangle_set()> generate_preview_slices(SLAPrintObject &po);
 
     void prepare_for_generate_supports(SLAPrintObject &po);
 
@@ -69,11 +70,15 @@ public:
     void support_tree(SLAPrintObject& po);
     void generate_pad(SLAPrintObject& po);
     void slice_supports(SLAPrintObject& po);
+    // Slice the supports of all the objects in a single parallel pass.
+    void slice_supports(const std::vector<SLAPrintObject*> &objects);
 
     void merge_slices_and_eval_stats();
     void rasterize();
 
     void execute(SLAPrintObjectStep step, SLAPrintObject &obj);
+    // Execute the step on multiple objects at once, if the step supports it.
+    void execute(SLAPrintObjectStep step, const std::vector<SLAPrintObject*> &objects);
     void execute(SLAPrintStep step);
 
     static std::string label(SLAPrintObjectStep step);
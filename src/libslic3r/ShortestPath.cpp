@@ -29,6 +29,52 @@
 
 namespace Slic3r {
 
+// The closest point searches filter out the end points, which may not be connected to anymore, however such end points
+// stay in the KD tree and they slow down the searches. The KD tree is rebuilt from the end points still available once
+// at least half of the end points stored in the KD tree became unavailable, thus the end points are removed lazily.
+template<typename KDTreeType>
+class KDTreeLazyRemoval
+{
+public:
+	KDTreeLazyRemoval(KDTreeType &kdtree, size_t num_indices) : m_kdtree(kdtree), m_num_all(num_indices), m_num_indices(num_indices) {}
+
+	// Mark num_removed end points as unavailable. If too many end points stored in the KD tree are unavailable,
+	// rebuild the KD tree from the indices satisfying the "available" predicate.
+	template<typename AvailableFunc>
+	void remove(size_t num_removed, AvailableFunc available)
+	{
+		m_num_removed += num_removed;
+		if (m_num_indices > 64 && 2 * m_num_removed > m_num_indices) {
+			std::vector<size_t> indices;
+			indices.reserve(m_num_indices - std::min(m_num_removed, m_num_indices));
+			for (size_t idx = 0; idx < m_num_all; ++ idx)
+				if (available(idx))
+					indices.emplace_back(idx);
+			m_num_removed = 0;
+			if (! indices.empty()) {
+				m_num_indices = indices.size();
+				m_kdtree.build(indices);
+			}
+		}
+	}
+
+	// Store all the end points into the KD tree again.
+	void restore()
+	{
+		if (m_num_indices != m_num_all) {
+			m_kdtree.build(m_num_all);
+			m_num_indices = m_num_all;
+		}
+		m_num_removed = 0;
+	}
+
+private:
+	KDTreeType &m_kdtree;
+	size_t      m_num_all;
+	size_t      m_num_indices;
+	size_t      m_num_removed { 0 };
+};
+
 // Naive implementation of the Traveling Salesman Problem, it works by always taking the next closest neighbor.
 // This implementation will always produce valid result even if some segments cannot reverse.
 template<typename EndPointType, typename KDTreeType, typename CouldReverseFunc>
@@ -45,9 +91,11 @@ std::vector<std::pair<size_t, bool>> chain_segments_closest_point(std::vector<En
 	out.emplace_back(first_point_idx / 2, (first_point_idx & 1) != 0);
 	first_point.chain_id = 1;
 	size_t this_idx = first_point_idx ^ 1;
+	KDTreeLazyRemoval<KDTreeType> kdtree_removal(kdtree, end_points.size());
 	for (int iter = (int)num_segments - 2; iter >= 0; -- iter) {
 		EndPointType &this_point = end_points[this_idx];
     	this_point.chain_id = 1;
+		kdtree_removal.remove(2, [&end_points](size_t idx) { return end_points[idx].chain_id == 0; });
     	// Find the closest point to this end_point, which lies on a different extrusion path (filtered by the lambda).
     	// Ignore the starting point as the starting point is considered to be occupied, no end point coud connect to it.
 		size_t next_idx = find_closest_point(kdtree, this_point.pos,
@@ -61,6 +109,7 @@ std::vector<std::pair<size_t, bool>> chain_segments_closest_point(std::vector<En
 		out.emplace_back(next_idx / 2, (next_idx & 1) != 0);
 		this_idx = next_idx ^ 1;
 	}
+	kdtree_removal.restore();
 #ifndef NDEBUG
 	assert(end_points[this_idx].chain_id == 0);
 	for (EndPointType &ep : end_points)
@@ -117,6 +166,7 @@ std::vector<std::pair<size_t, bool>> chain_segments_greedy_constrained_reversals
 	    // Construct the closest point KD tree over end points of segments.
 		auto coordinate_fn = [&end_points](size_t idx, size_t dimension) -> double { return end_points[idx].pos[dimension]; };
 		KDTreeIndirect<2, double, decltype(coordinate_fn)> kdtree(coordinate_fn, end_points.size());
+		KDTreeLazyRemoval<decltype(kdtree)>                kdtree_removal(kdtree, end_points.size());
 
 		// Helper to detect loops in already connected paths.
 		// Unique chain IDs are assigned to paths. If paths are connected, end points will not have their chain IDs updated, but the chain IDs
@@ -312,6 +362,7 @@ std::vector<std::pair<size_t, bool>> chain_segments_greedy_constrained_reversals
 				end_point1.chain_id = chain_id;
 				end_point2.chain_id = chain_id;
 				assert(validate_graph_and_queue());
+				kdtree_removal.remove(2, [&end_points](size_t idx) { return end_points[idx].chain_id == 0; });
 				if (iter == 0) {
 					// Last iteration. There shall be exactly one or two end points waiting to be connected.
 					assert(queue.size() == ((first_point == nullptr) ? 2 : 1));
@@ -353,8 +404,6 @@ std::vector<std::pair<size_t, bool>> chain_segments_greedy_constrained_reversals
 #endif /* NDEBUG */
 				// Update position of this end point in the queue based on the distance calculated at the line above.
 				queue.update(end_point1.heap_idx);
-		    	//FIXME Remove the other end point from the KD tree.
-		    	// As the KD tree update is expensive, do it only after some larger number of points is removed from the queue.
 				assert(validate_graph_and_queue());
 	    	}
 		}
@@ -403,9 +452,11 @@ std::vector<std::pair<size_t, bool>> chain_segments_greedy_constrained_reversals
 					} while (first_point != nullptr);
 				}
 			}
-			if (failed)
+			if (failed) {
 				// As a last resort, try a dumb algorithm, which is not sensitive to edge reversal constraints.
+				kdtree_removal.restore();
 				out = chain_segments_closest_point<EndPoint, decltype(kdtree), CouldReverseFunc>(end_points, kdtree, could_reverse_func, (initial_point != nullptr) ? *initial_point : end_points.front());
+			}
 		} else {
 			assert(! failed);
 		}
@@ -536,6 +587,7 @@ std::vector<std::pair<size_t, bool>> chain_segments_greedy_constrained_reversals
 	    // Construct the closest point KD tree over end points of segments.
 		auto coordinate_fn = [&end_points](size_t idx, size_t dimension) -> double { return end_points[idx].pos[dimension]; };
 		KDTreeIndirect<2, double, decltype(coordinate_fn)> kdtree(coordinate_fn, end_points.size());
+		KDTreeLazyRemoval<decltype(kdtree)>                kdtree_removal(kdtree, end_points.size());
 
 	    // Chained segments with their sum of connection lengths.
 	    // The chain supports flipping all the segments, connecting the segments at the opposite ends.
@@ -879,6 +931,9 @@ std::vector<std::pair<size_t, bool>> chain_segments_greedy_constrained_reversals
 					chain.begin->chain_id = 0;
 				if (chain.end != first_point)
 					chain.end->chain_id = 0;
+				// Segments connected at both of their ends may not be connected to anymore.
+				kdtree_removal.remove((chain1 == nullptr ? 0 : 2) + (chain2 == nullptr ? 0 : 2),
+					[&end_points](size_t idx) { return end_points[idx].chain_id == 0 || end_points[idx ^ 1].chain_id == 0; });
 				if (-- num_connections_to_end == 0) {
 					assert(validate_graph_and_queue());
 					// Last iteration. There shall be exactly one or two end points waiting to be connected.
@@ -932,8 +987,6 @@ std::vector<std::pair<size_t, bool>> chain_segments_greedy_constrained_reversals
 //					printf("Warning: taking shorter length than previously is suspicious\n");
 				}
 #endif /* NDEBUG */
-		    	//FIXME Remove the other end point from the KD tree.
-		    	// As the KD tree update is expensive, do it only after some larger number of points is removed from the queue.
 		    }
 			assert(validate_graph_and_queue());
 		}
@@ -982,9 +1035,11 @@ std::vector<std::pair<size_t, bool>> chain_segments_greedy_constrained_reversals
 					} while (first_point != nullptr);
 				}
 			}
-			if (failed)
+			if (failed) {
 				// As a last resort, try a dumb algorithm, which is not sensitive to edge reversal constraints.
+				kdtree_removal.restore();
 				out = chain_segments_closest_point<EndPoint, decltype(kdtree), CouldReverseFunc>(end_points, kdtree, could_reverse_func, (initial_point != nullptr) ? *initial_point : end_points.front());
+			}
 		} else {
 			assert(! failed);
 		}
@@ -1602,7 +1657,10 @@ static inline void do_crossover(const std::vector<FlipEdge> &edges_in, std::vect
 // where n is the number of edges and k is the number of connection_lengths candidates after the first one
 // is found that improves the total cost.
 //FIXME there are likley better heuristics to lower the time complexity.
-static inline void reorder_by_two_exchanges_with_segment_flipping(std::vector<FlipEdge> &edges)
+// The quadratic search for the second crossover is bounded by max_evaluations crossover cost evaluations,
+// so that layers with tens of thousands of lines are ordered in a reasonable time. A work budget is used
+// instead of a time budget to produce the same path independently of the machine load.
+static inline void reorder_by_two_exchanges_with_segment_flipping(std::vector<FlipEdge> &edges, size_t max_evaluations = 1000000)
 {
 	if (edges.size() < 2)
 		return;
@@ -1636,8 +1694,9 @@ static inline void reorder_by_two_exchanges_with_segment_flipping(std::vector<Fl
 			size_t crossover_pos_min  = std::numeric_limits<size_t>::max();
 			double crossover_cost_min = connections.back().cost;
 			size_t crossover_flip_min = 0;
-			for (size_t j = 1; j < connections.size(); ++ j)
+			for (size_t j = 1; j < connections.size() && max_evaluations > 0; ++ j)
 				if (! connection_tried[j]) {
+					-- max_evaluations;
 					size_t a = j;
 					size_t b = longest_connection_idx;
 					if (a > b)
@@ -1658,6 +1717,9 @@ static inline void reorder_by_two_exchanges_with_segment_flipping(std::vector<Fl
 				crossover2_pos_final = crossover_pos_min;
 				crossover_flip_final = crossover_flip_min;
 				break;
+			} else if (max_evaluations == 0) {
+				// Out of the work budget.
+				break;
 			} else {
 				// Continue with another long candidate edge.
 			}
@@ -1673,6 +1735,8 @@ static inline void reorder_by_two_exchanges_with_segment_flipping(std::vector<Fl
 			// No valid pair of cross over positions was found improving the total cost. Giving up.
 			break;
 		}
+		if (max_evaluations == 0)
+			break;
 	}
 }
 
@@ -29,7 +29,7 @@ class Line;
 class ExPolygon;
 struct LayerIsland;
 
-using ExPolygons = std::vector<ExPolygon>;
+using ExPolygons = std::vector<ExPolygon, PointsAllocator<ExPolygon>>;
 
 // Used by chain_expolygons()
 std::vector<size_t> 				 chain_points(const Points &points, const Point *start_near = nullptr);
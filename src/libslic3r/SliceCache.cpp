@@ -0,0 +1,160 @@
+#include "SliceCache.hpp"
+
+#include <boost/algorithm/hex.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/log/trivial.hpp>
+#include <boost/nowide/fstream.hpp>
+//FIXME replace with <boost/md5.hpp> after it becomes mainstream, see AppConfig.cpp
+#include <boost/uuid/detail/md5.hpp>
+#include <cstdint>
+#include <iterator>
+#include <mutex>
+
+#include "libslic3r/Exception.hpp"
+#include "libslic3r/TriangleMeshSlicer.hpp"
+#include "libslic3r/libslic3r.h"
+#include "admesh/stl.h"
+
+namespace Slic3r::SliceCache {
+
+// Bump if the format of the cache file or the output of slice_mesh_ex() changes.
+static constexpr const uint32_t CACHE_VERSION = 1;
+static constexpr const char     CACHE_MAGIC[4] = { 'P', 'S', 'S', 'C' };
+
+static std::string g_cache_dir;
+static std::mutex  g_cache_dir_mutex;
+
+void set_cache_dir(const std::string &dir)
+{
+    g_cache_dir = dir;
+}
+
+const std::string& cache_dir()
+{
+    return g_cache_dir;
+}
+
+std::string make_key(const indexed_triangle_set &its, const std::vector<float> &zs, const MeshSlicingParamsEx &params)
+{
+    using boost::uuids::detail::md5;
+    md5 hash;
+    auto add = [&hash](const auto &value) { hash.process_bytes(&value, sizeof(value)); };
+    add(CACHE_VERSION);
+    add(SCALING_FACTOR);
+    add(its.vertices.size());
+    hash.process_bytes(its.vertices.data(), its.vertices.size() * sizeof(stl_vertex));
+    add(its.indices.size());
+    hash.process_bytes(its.indices.data(), its.indices.size() * sizeof(stl_triangle_vertex_indices));
+    add(zs.size());
+    hash.process_bytes(zs.data(), zs.size() * sizeof(float));
+    hash.process_bytes(params.trafo.matrix().data(), 16 * sizeof(double));
+    add(params.mode);
+    add(params.mode_below);
+    add(uint64_t(params.slicing_mode_normal_below_layer));
+    add(params.closing_radius);
+    add(params.extra_offset);
+    add(params.resolution);
+
+    md5::digest_type digest{};
+    hash.get_digest(digest);
+    std::string key;
+    boost::algorithm::hex(digest, digest + std::size(digest), std::back_inserter(key));
+    return key;
+}
+
+static boost::filesystem::path cache_file_path(const std::string &key)
+{
+    return boost::filesystem::path(g_cache_dir) / (key + ".slices");
+}
+
+template<typename T> static inline void write_pod(std::ostream &os, const T &value) { os.write(reinterpret_cast<const char*>(&value), sizeof(T)); }
+template<typename T> static inline bool read_pod(std::istream &is, T &value) { return bool(is.read(reinterpret_cast<char*>(&value), sizeof(T))); }
+
+static void write_polygon(std::ostream &os, const Polygon &poly)
+{
+    write_pod(os, uint64_t(poly.points.size()));
+    os.write(reinterpret_cast<const char*>(poly.points.data()), poly.points.size() * sizeof(Point));
+}
+
+static bool read_polygon(std::istream &is, Polygon &poly)
+{
+    uint64_t n;
+    if (! read_pod(is, n))
+        return false;
+    poly.points.assign(n, Point());
+    return bool(is.read(reinterpret_cast<char*>(poly.points.data()), n * sizeof(Point)));
+}
+
+bool load(const std::string &key, std::vector<ExPolygons> &out)
+{
+    if (! enabled())
+        return false;
+    boost::nowide::ifstream is(cache_file_path(key).string(), std::ios::in | std::ios::binary);
+    if (! is.good())
+        return false;
+    char     magic[4];
+    uint32_t version;
+    uint64_t num_layers;
+    if (! is.read(magic, 4) || ! std::equal(magic, magic + 4, CACHE_MAGIC) || ! read_pod(is, version) || version != CACHE_VERSION ||
+        ! read_pod(is, num_layers))
+        return false;
+    std::vector<ExPolygons> slices(num_layers);
+    for (ExPolygons &layer : slices) {
+        uint64_t num_expolygons;
+        if (! read_pod(is, num_expolygons))
+            return false;
+        layer.assign(num_expolygons, ExPolygon());
+        for (ExPolygon &expoly : layer) {
+            uint64_t num_holes;
+            if (! read_polygon(is, expoly.contour) || ! read_pod(is, num_holes))
+                return false;
+            expoly.holes.assign(num_holes, Polygon());
+            for (Polygon &hole : expoly.holes)
+                if (! read_polygon(is, hole))
+                    return false;
+        }
+    }
+    out = std::move(slices);
+    BOOST_LOG_TRIVIAL(debug) << "SliceCache: loaded " << key;
+    return true;
+}
+
+void store(const std::string &key, const std::vector<ExPolygons> &slices)
+{
+    if (! enabled())
+        return;
+    try {
+        const boost::filesystem::path path     = cache_file_path(key);
+        // Write into a unique temporary file first and rename it into place, so that a concurrent reader
+        // (another PrintObject sharing the same mesh or another PrusaSlicer instance) never sees a partial file.
+        const boost::filesystem::path path_tmp = path.parent_path() / boost::filesystem::unique_path(key + "-%%%%-%%%%.tmp");
+        {
+            std::lock_guard<std::mutex> lock(g_cache_dir_mutex);
+            boost::filesystem::create_directories(path.parent_path());
+        }
+        {
+            boost::nowide::ofstream os(path_tmp.string(), std::ios::out | std::ios::binary | std::ios::trunc);
+            os.write(CACHE_MAGIC, 4);
+            write_pod(os, CACHE_VERSION);
+            write_pod(os, uint64_t(slices.size()));
+            for (const ExPolygons &layer : slices) {
+                write_pod(os, uint64_t(layer.size()));
+                for (const ExPolygon &expoly : layer) {
+                    write_polygon(os, expoly.contour);
+                    write_pod(os, uint64_t(expoly.holes.size()));
+                    for (const Polygon &hole : expoly.holes)
+                        write_polygon(os, hole);
+                }
+            }
+            os.close();
+            if (os.fail())
+                throw Slic3r::RuntimeError("Failed writing " + path_tmp.string());
+        }
+        boost::filesystem::rename(path_tmp, path);
+    } catch (const std::exception &ex) {
+        BOOST_LOG_TRIVIAL(warning) << "SliceCache: failed storing " << key << ": " << ex.what();
+    }
+}
+
+} // namespace Slic3r::SliceCache
@@ -0,0 +1,39 @@
+#ifndef slic3r_SliceCache_hpp_
+#define slic3r_SliceCache_hpp_
+
+#include <string>
+#include <vector>
+
+#include "libslic3r/ExPolygon.hpp"
+
+struct indexed_triangle_set;
+
+namespace Slic3r {
+
+struct MeshSlicingParamsEx;
+
+// Persistent on-disk cache of mesh slices.
+// Slicing of a single triangle mesh is a pure function of the mesh, its transformation, the slicing planes
+// and the slicing parameters. The cache stores the output of slice_mesh_ex() into a file named by a hash
+// of all these inputs, thus re-slicing of the same part with the same settings is reduced to reading a file.
+// The cache is opt-in: it is disabled until SliceCache::set_cache_dir() is called with a non-empty path.
+namespace SliceCache {
+
+// Set a directory to store the cached slices to. Empty path disables the cache.
+void                set_cache_dir(const std::string &dir);
+const std::string&  cache_dir();
+inline bool         enabled() { return ! cache_dir().empty(); }
+
+// Content hash of all inputs of slice_mesh_ex(), 32 hex digits.
+std::string         make_key(const indexed_triangle_set &its, const std::vector<float> &zs, const MeshSlicingParamsEx &params);
+
+// Returns false if the entry is not in the cache or if it cannot be read.
+bool                load(const std::string &key, std::vector<ExPolygons> &out);
+// Failing to store into the cache is not an error, it is only logged.
+void                store(const std::string &key, const std::vector<ExPolygons> &slices);
+
+} // namespace SliceCache
+
+} // namespace Slic3r
+
+#endif // slic3r_SliceCache_hpp_
@@ -67,22 +67,38 @@ indexed_triangle_set slices_to_mesh(
         // by its_remove_degenerate_faces.
         ExPolygons free_top = diff_ex(lower, upper);
         ExPolygons overhang = diff_ex(upper, lower);
-        its_merge(layers[i], triangulate_expolygons_3d(free_top, grid[i], NORMALS_UP));
-        its_merge(layers[i], triangulate_expolygons_3d(overhang, grid[i], NORMALS_DOWN));
+        its_merge(layers[i], triangulate_expolygons_3d(free_top, grid[i], NORMALS_UP, TesselationMethod::MonotoneSweep));
+        its_merge(layers[i], triangulate_expolygons_3d(overhang, grid[i], NORMALS_DOWN, TesselationMethod::MonotoneSweep));
         its_merge(layers[i], straight_walls(upper, grid[i], grid[i + 1]));
         }, threads_cnt);
 
-    auto merge_fn = []( const indexed_triangle_set &a, const indexed_triangle_set &b ) {
-        indexed_triangle_set res{a}; its_merge(res, b); return res;
-    };
+    // The bottom and top caps are stored in the last layer.
+    indexed_triangle_set &caps = layers.emplace_back();
+    its_merge(caps, triangulate_expolygons_3d(slices.front(), zmin, NORMALS_DOWN, TesselationMethod::MonotoneSweep));
+    its_merge(caps, straight_walls(slices.front(), zmin, grid.front()));
+    its_merge(caps, triangulate_expolygons_3d(slices.back(), grid.back(), NORMALS_UP, TesselationMethod::MonotoneSweep));
+
+    // Merge the layers into a mesh allocated at once. Merging the layers pairwise
+    // used to copy the growing mesh over and over, doubling the peak memory.
+    std::vector<size_t> vertices_offsets(layers.size() + 1, 0);
+    std::vector<size_t> indices_offsets(layers.size() + 1, 0);
+    for (size_t i = 0; i < layers.size(); ++i) {
+        vertices_offsets[i + 1] = vertices_offsets[i] + layers[i].vertices.size();
+        indices_offsets[i + 1]  = indices_offsets[i] + layers[i].indices.size();
+    }
 
-    auto ret = execution::reduce(ex_tbb, layers.begin(), layers.end(),
-                                 indexed_triangle_set{}, merge_fn,
-                                 threads_cnt);
-
-    its_merge(ret, triangulate_expolygons_3d(slices.front(), zmin, NORMALS_DOWN));
-    its_merge(ret, straight_walls(slices.front(), zmin, grid.front()));
-    its_merge(ret, triangulate_expolygons_3d(slices.back(), grid.back(), NORMALS_UP));
+    indexed_triangle_set ret;
+    ret.vertices.resize(vertices_offsets.back());
+    ret.indices.resize(indices_offsets.back());
+    execution::for_each(ex_tbb, size_t(0), layers.size(),
+        [&layers, &ret, &vertices_offsets, &indices_offsets](size_t i) {
+            indexed_triangle_set &layer = layers[i];
+            std::copy(layer.vertices.begin(), layer.vertices.end(), ret.vertices.begin() + vertices_offsets[i]);
+            const auto offset = int(vertices_offsets[i]);
+            std::transform(layer.indices.begin(), layer.indices.end(), ret.indices.begin() + indices_offsets[i],
+                [offset](const stl_triangle_vertex_indices &face) { return face + stl_triangle_vertex_indices(offset, offset, offset); });
+            layer = {};
+        }, threads_cnt);
 
     // FIXME: these repairs do not fix the mesh entirely. There will be cracks
     // in the output. It is very hard to do the meshing in a way that does not
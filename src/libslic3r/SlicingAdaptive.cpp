@@ -7,6 +7,10 @@
 #include <cmath>
 #include <cassert>
 
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
+#include <oneapi/tbb/parallel_sort.h>
+
 #include "libslic3r.h"
 #include "Model.hpp"
 #include "TriangleMesh.hpp"
@@ -72,7 +76,8 @@ static inline float layer_height_from_slope(const SlicingAdaptive::FaceZ &face,
 //    return (face.n_cos > 1e-5) ? float(1.44 * max_surface_deviation * sqrt(face.n_sin / face.n_cos)) : FLT_MAX;
 
 // Constant error measured as an area of the surface error triangle, Vojtech's formula with clamping to roughness at 90 degrees.
-    return std::min(max_surface_deviation / 0.184f, (face.n_cos > 1e-5) ? float(1.44 * max_surface_deviation * sqrt(face.n_sin / face.n_cos)) : FLT_MAX);
+// Monotonic in face.slope, which next_layer_height() relies on.
+    return std::min(max_surface_deviation / 0.184f, (face.n_cos > 1e-5) ? float(1.44 * max_surface_deviation * sqrt(face.slope)) : FLT_MAX);
 
 // Constant stepping along the surface, equivalent to the "surface roughness" metric by Perez and later Pandey et all, see @platch's paper for references.
 //    return float(max_surface_deviation * face.n_sin);
@@ -81,6 +86,9 @@ static inline float layer_height_from_slope(const SlicingAdaptive::FaceZ &face,
 void SlicingAdaptive::clear()
 {
 	m_faces.clear();
+	m_next_face    = 0;
+	m_last_print_z = 0.f;
+	m_active_faces.clear();
 }
 
 void SlicingAdaptive::prepare(const ModelObject &object)
@@ -92,26 +100,29 @@ void SlicingAdaptive::prepare(const ModelObject &object)
     mesh.transform(first_instance.get_matrix(), first_instance.is_left_handed());
 
     // 1) Collect faces from mesh.
-    m_faces.reserve(mesh.facets_count());
-	for (stl_triangle_vertex_indices face : mesh.its.indices) {
-		stl_vertex vertex[3] = { mesh.its.vertices[face[0]], mesh.its.vertices[face[1]], mesh.its.vertices[face[2]] };
-		stl_vertex n         = face_normal_normalized(vertex);
-		std::pair<float, float> face_z_span {
-			std::min(std::min(vertex[0].z(), vertex[1].z()), vertex[2].z()),
-			std::max(std::max(vertex[0].z(), vertex[1].z()), vertex[2].z())
-		};
-		m_faces.emplace_back(FaceZ({ face_z_span, std::abs(n.z()), std::sqrt(n.x() * n.x() + n.y() * n.y()) }));
-    }
+    m_faces.assign(mesh.facets_count(), FaceZ());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, m_faces.size()), [this, &mesh](const tbb::blocked_range<size_t> &range) {
+        for (size_t face_idx = range.begin(); face_idx < range.end(); ++ face_idx) {
+            const stl_triangle_vertex_indices &face = mesh.its.indices[face_idx];
+            stl_vertex vertex[3] = { mesh.its.vertices[face[0]], mesh.its.vertices[face[1]], mesh.its.vertices[face[2]] };
+            stl_vertex n         = face_normal_normalized(vertex);
+            std::pair<float, float> face_z_span {
+                std::min(std::min(vertex[0].z(), vertex[1].z()), vertex[2].z()),
+                std::max(std::max(vertex[0].z(), vertex[1].z()), vertex[2].z())
+            };
+            const float n_cos = std::abs(n.z());
+            const float n_sin = std::sqrt(n.x() * n.x() + n.y() * n.y());
+            m_faces[face_idx] = FaceZ({ face_z_span, n_cos, n_sin, n_cos > 1e-5 ? n_sin / n_cos : FLT_MAX });
+        }
+    });
 
 	// 2) Sort faces lexicographically by their Z span.
-	std::sort(m_faces.begin(), m_faces.end(), [](const FaceZ &f1, const FaceZ &f2) { return f1.z_span < f2.z_span; });
+	tbb::parallel_sort(m_faces.begin(), m_faces.end(), [](const FaceZ &f1, const FaceZ &f2) { return f1.z_span < f2.z_span; });
 }
 
-// current_facet is in/out parameter, rememebers the index of the last face of m_faces visited, 
-// where this function will start from.
 // print_z - the top print surface of the previous layer.
 // returns height of the next layer.
-float SlicingAdaptive::next_layer_height(const float print_z, float quality_factor, size_t &current_facet)
+float SlicingAdaptive::next_layer_height(const float print_z, float quality_factor)
 {
 	float  height = (float)m_slicing_params.max_layer_height;
 
@@ -134,30 +145,35 @@ float SlicingAdaptive::next_layer_height(const float print_z, float quality_fact
 	    	lerp(delta_max, delta_mid, 2. * (1. - quality_factor));
 	}
 	
-	// find all facets intersecting the slice-layer
-	size_t ordered_id = current_facet;
-	{
-		bool first_hit = false;
-		for (; ordered_id < m_faces.size(); ++ ordered_id) {
-	        const std::pair<float, float> &zspan = m_faces[ordered_id].z_span;
-	        // facet's minimum is higher than slice_z -> end loop
-			if (zspan.first >= print_z)
-				break;
-			// facet's maximum is higher than slice_z -> store the first event for next cusp_height call to begin at this point
-			if (zspan.second > print_z) {
-				// first event?
-				if (! first_hit) {
-					first_hit = true;
-					current_facet = ordered_id;
-	            }
-				// skip touching facets which could otherwise cause small cusp values
-				if (zspan.second < print_z + EPSILON)
-					continue;
-				// compute cusp-height for this facet and store minimum of all heights
-				height = std::min(height, layer_height_from_slope(m_faces[ordered_id], max_surface_deviation));
-	        }
+	// Restart the sweep if print_z went down.
+	if (print_z < m_last_print_z) {
+		m_next_face = 0;
+		m_active_faces.clear();
+	}
+	m_last_print_z = print_z;
+
+	// Collect the facets starting below the slice-layer. Facets ending below print_z + EPSILON are skipped as
+	// touching facets, which could otherwise cause small cusp values, and they will never cross any layer above.
+	size_t ordered_id = m_next_face;
+	for (; ordered_id < m_faces.size(); ++ ordered_id) {
+		const FaceZ &face = m_faces[ordered_id];
+		// facet's minimum is higher than slice_z -> end loop
+		if (face.z_span.first >= print_z)
+			break;
+		if (face.z_span.second >= print_z + EPSILON) {
+			m_active_faces.push_back({ face.slope, face.z_span.second, ordered_id });
+			std::push_heap(m_active_faces.begin(), m_active_faces.end());
 		}
 	}
+	m_next_face = ordered_id;
+	// Drop the facets, which ended below the slice-layer.
+	while (! m_active_faces.empty() && m_active_faces.front().z_max < print_z + EPSILON) {
+		std::pop_heap(m_active_faces.begin(), m_active_faces.end());
+		m_active_faces.pop_back();
+	}
+	// The least steep facet intersecting the slice-layer limits the layer height the most.
+	if (! m_active_faces.empty())
+		height = std::min(height, layer_height_from_slope(m_faces[m_active_faces.front().idx], max_surface_deviation));
 
 	// lower height limit due to printer capabilities
 	height = std::max(height, float(m_slicing_params.min_layer_height));
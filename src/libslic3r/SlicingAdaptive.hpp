@@ -30,7 +30,9 @@ public:
     // Return next layer height starting from the last print_z, using a quality measure
     // (quality in range from 0 to 1, 0 - highest quality at low layer heights, 1 - lowest print quality at high layer heights).
     // The layer height curve shall be centered roughly around the default profile's layer height for quality 0.5.
-	float next_layer_height(const float print_z, float quality, size_t &current_facet);
+    // The facets crossing print_z are swept incrementally, thus consecutive calls shall be made with increasing print_z,
+    // otherwise the sweep is restarted from the bottom of the object.
+	float next_layer_height(const float print_z, float quality);
     float horizontal_facet_distance(float z);
 
 	struct FaceZ {
@@ -39,12 +41,29 @@ public:
 		float					n_cos;
 		// Sine of the normal vector towards the Z axis.
 		float					n_sin;
+		// n_sin / n_cos, FLT_MAX for horizontal faces. The layer height limit of a face grows monotonically with its slope.
+		float					slope;
 	};
 
 protected:
+	// Face crossing the last print_z, ordered by its slope, thus by its layer height limit.
+	struct ActiveFace {
+		float 					slope;
+		float 					z_max;
+		size_t 					idx;
+		bool operator<(const ActiveFace &rhs) const { return slope > rhs.slope; }
+	};
+
 	SlicingParameters 		m_slicing_params;
 
 	std::vector<FaceZ>		m_faces;
+
+	// State of the sweep over m_faces sorted by their Z span.
+	// Index of the first face of m_faces not yet visited by next_layer_height().
+	size_t 					m_next_face { 0 };
+	float 					m_last_print_z { 0.f };
+	// Min-heap of the visited faces, which may still cross the next layer.
+	std::vector<ActiveFace>	m_active_faces;
 };
 
 }; // namespace Slic3r
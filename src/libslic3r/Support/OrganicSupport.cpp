@@ -21,6 +21,7 @@
 
 #include "../AABBTreeLines.hpp"
 #include "../ClipperUtils.hpp"
+#include "../Geometry/ConvexHull.hpp"
 #include "../Polygon.hpp"
 #include "../MutablePolygon.hpp"
 #include "../TriangleMeshSlicer.hpp"
@@ -33,10 +34,13 @@
 #include "libslic3r/Support/TreeModelVolumes.hpp"
 #include "libslic3r/Support/TreeSupport.hpp"
 #include "libslic3r/Support/TreeSupportCommon.hpp"
+#include "libslic3r/Trace.hpp"
 #include "libslic3r/Utils.hpp"
 #include "libslic3r/libslic3r.h"
 
 #define TREE_SUPPORT_ORGANIC_NUDGE_NEW 1
+// Slice the branches analytically instead of triangulating them and slicing the triangle mesh.
+#define TREE_SUPPORT_ORGANIC_SLICE_ANALYTIC 1
 
 #ifndef TREE_SUPPORT_ORGANIC_NUDGE_NEW
     #include <openvdb/tools/VolumeToSpheres.h>
@@ -500,6 +504,8 @@ static bool circles_intersect(
 }
 #endif
 
+#ifndef TREE_SUPPORT_ORGANIC_SLICE_ANALYTIC
+
 template<bool flip_normals>
 void triangulate_fan(indexed_triangle_set &its, int ifan, int ibegin, int iend)
 {
@@ -709,6 +715,107 @@ static std::pair<float, float> extrude_branch(
     return std::make_pair(zmin, zmax);
 }
 
+#else // TREE_SUPPORT_ORGANIC_SLICE_ANALYTIC
+
+struct BranchSphere
+{
+    Vec3d  center;
+    double radius;
+};
+
+static std::vector<BranchSphere> branch_spheres(
+    const std::vector<const SupportElement*>    &path,
+    const TreeSupportSettings                   &config,
+    const SlicingParameters                     &slicing_params)
+{
+    std::vector<BranchSphere> out;
+    out.reserve(path.size());
+    for (const SupportElement *el : path)
+        out.push_back({ to_3d(unscaled<double>(el->state.result_on_layer), layer_z(slicing_params, config, el->state.layer_idx)), 
+                        unscaled<double>(support_element_radius(config, *el)) });
+    return out;
+}
+
+// Returns Z span of the branch.
+static std::pair<float, float> branch_zspan(const std::vector<BranchSphere> &spheres)
+{
+    auto zmin = std::numeric_limits<double>::max();
+    auto zmax = std::numeric_limits<double>::lowest();
+    for (const BranchSphere &sphere : spheres) {
+        zmin = std::min(zmin, sphere.center.z() - sphere.radius);
+        zmax = std::max(zmax, sphere.center.z() + sphere.radius);
+    }
+    return { float(zmin), float(zmax) };
+}
+
+// Slice a branch at slice_z sorted in ascending order without triangulating it.
+// A segment of the branch is modeled as a convex hull of the two spheres at its end points, which is a union of spheres
+// with centers and radii interpolated linearly along the segment. Horizontal cross section of such segment is convex,
+// it is calculated as a convex hull of cross sections of the interpolated spheres.
+static std::vector<Polygons> slice_branch(const std::vector<BranchSphere> &spheres, const std::vector<float> &slice_z)
+{
+    assert(spheres.size() >= 2);
+    assert(std::is_sorted(slice_z.begin(), slice_z.end()));
+    static constexpr const double eps = 0.015;
+
+    std::vector<Polygons> out(slice_z.size());
+    Points                pts;
+    for (size_t isphere = 1; isphere < spheres.size(); ++ isphere) {
+        const BranchSphere &s1   = spheres[isphere - 1];
+        const BranchSphere &s2   = spheres[isphere];
+        const Vec3d         dc   = s2.center - s1.center;
+        const double        dr   = s2.radius - s1.radius;
+        const double        zmin = std::min(s1.center.z() - s1.radius, s2.center.z() - s2.radius);
+        const double        zmax = std::max(s1.center.z() + s1.radius, s2.center.z() + s2.radius);
+        // Sample the segment densely enough for the convex hull of the samples to follow the conical surface.
+        const int           nsamples = std::clamp(int(std::ceil(dc.norm() / (0.25 * std::min(s1.radius, s2.radius)))), 1, 16);
+        for (auto it = std::lower_bound(slice_z.begin(), slice_z.end(), float(zmin)); it != slice_z.end() && *it <= zmax; ++ it) {
+            // Squared radius of the cross section of the interpolated sphere at parameter t is a * t^2 + b * t + c.
+            const double dz = double(*it) - s1.center.z();
+            const double a  = sqr(dr) - sqr(dc.z());
+            const double b  = 2. * (s1.radius * dr + dz * dc.z());
+            const double c  = sqr(s1.radius) - sqr(dz);
+            auto add_cross_section = [&pts, &s1, &dc, a, b, c](double t) {
+                const double r2     = (a * t + b) * t + c;
+                const Vec2d  center = (s1.center + t * dc).head<2>();
+                if (r2 < 0)
+                    return;
+                if (const double r = std::sqrt(r2); r < eps)
+                    pts.emplace_back(scaled<coord_t>(center.x()), scaled<coord_t>(center.y()));
+                else {
+                    const int    nsteps     = int(std::ceil(M_PI / acos(1. - eps / r)));
+                    const double angle_step = 2. * M_PI / nsteps;
+                    for (int i = 0; i < nsteps; ++ i)
+                        pts.emplace_back(scaled<coord_t>(center.x() + r * cos(i * angle_step)), scaled<coord_t>(center.y() + r * sin(i * angle_step)));
+                }
+            };
+            pts.clear();
+            for (int i = 0; i <= nsamples; ++ i)
+                add_cross_section(double(i) / nsamples);
+            // Add the cross sections touching the plane, where the cross section starts or ends between the samples.
+            if (std::abs(a) > EPSILON) {
+                if (const double d = sqr(b) - 4. * a * c; d > 0)
+                    for (double t : { (- b - std::sqrt(d)) / (2. * a), (- b + std::sqrt(d)) / (2. * a) })
+                        if (t > 0 && t < 1)
+                            add_cross_section(t);
+            } else if (std::abs(b) > EPSILON) {
+                if (const double t = - c / b; t > 0 && t < 1)
+                    add_cross_section(t);
+            }
+            if (pts.size() >= 3)
+                if (Polygon hull = Geometry::convex_hull(std::move(pts)); hull.size() >= 3)
+                    out[it - slice_z.begin()].emplace_back(std::move(hull));
+            pts.clear();
+        }
+    }
+    for (Polygons &slice : out)
+        if (slice.size() > 1)
+            slice = union_(slice);
+    return out;
+}
+
+#endif // TREE_SUPPORT_ORGANIC_SLICE_ANALYTIC
+
 #ifdef TREE_SUPPORT_ORGANIC_NUDGE_NEW
 
 // New version using per layer AABB trees of lines for nudging spheres away from an object.
@@ -951,6 +1058,7 @@ static void organic_smooth_branches_avoid_collisions(
 
     static constexpr const size_t num_iter = 100; // 1000;
     for (size_t iter = 0; iter < num_iter; ++ iter) {
+        throw_on_cancel();
         prev = pts;
         projections = pts;
         distances.assign(pts.size(), std::numeric_limits<float>::max());
@@ -1045,6 +1153,7 @@ void organic_draw_branches(
 
     std::function<void()>            throw_on_cancel)
 {
+    Trace::Span trace_span("Organic support draw branches", "Support");
     // All SupportElements are put into a layer independent storage to improve parallelization.
     std::vector<std::pair<SupportElement*, int>> elements_with_link_down;
     std::vector<size_t>                          linear_data_layers;
@@ -1208,20 +1317,30 @@ void organic_draw_branches(
     }
 
     const SlicingParameters &slicing_params = print_object.slicing_parameters();
+#ifdef TREE_SUPPORT_ORGANIC_SLICE_ANALYTIC
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, trees.size(), 1),
+        [&trees, &volumes, &config, &slicing_params, &throw_on_cancel](const tbb::blocked_range<size_t> &range) {
+#else // TREE_SUPPORT_ORGANIC_SLICE_ANALYTIC
     MeshSlicingParams mesh_slicing_params;
     mesh_slicing_params.mode = MeshSlicingParams::SlicingMode::Positive;
 
     tbb::parallel_for(tbb::blocked_range<size_t>(0, trees.size(), 1),
         [&trees, &volumes, &config, &slicing_params, &move_bounds, &mesh_slicing_params, &throw_on_cancel](const tbb::blocked_range<size_t> &range) {
             indexed_triangle_set    partial_mesh;
+#endif // TREE_SUPPORT_ORGANIC_SLICE_ANALYTIC
             std::vector<float>      slice_z;
             std::vector<Polygons>   bottom_contacts;
             for (size_t tree_id = range.begin(); tree_id < range.end(); ++ tree_id) {
                 Tree &tree = trees[tree_id];
                 for (const Branch &branch : tree.branches) {
+#ifdef TREE_SUPPORT_ORGANIC_SLICE_ANALYTIC
+                    std::vector<BranchSphere> spheres = branch_spheres(branch.path, config, slicing_params);
+                    std::pair<float, float> zspan = branch_zspan(spheres);
+#else // TREE_SUPPORT_ORGANIC_SLICE_ANALYTIC
                     // Triangulate the tube.
                     partial_mesh.clear();
                     std::pair<float, float> zspan = extrude_branch(branch.path, config, slicing_params, move_bounds, partial_mesh);
+#endif // TREE_SUPPORT_ORGANIC_SLICE_ANALYTIC
                     LayerIndex layer_begin = branch.has_root ?
                         branch.path.front()->state.layer_idx : 
                         std::min(branch.path.front()->state.layer_idx, layer_idx_ceil(slicing_params, config, zspan.first));
@@ -1234,11 +1353,20 @@ void organic_draw_branches(
                         const double bottom_z = layer_idx > 0 ? layer_z(slicing_params, config, layer_idx - 1) : 0.;
                         slice_z.emplace_back(float(0.5 * (bottom_z + print_z)));
                     }
+#ifdef TREE_SUPPORT_ORGANIC_SLICE_ANALYTIC
+                    std::vector<Polygons> slices = slice_branch(spheres, slice_z);
+                    throw_on_cancel();
+#else // TREE_SUPPORT_ORGANIC_SLICE_ANALYTIC
                     std::vector<Polygons> slices = slice_mesh(partial_mesh, slice_z, mesh_slicing_params, throw_on_cancel);
+#endif // TREE_SUPPORT_ORGANIC_SLICE_ANALYTIC
                     bottom_contacts.clear();
                     //FIXME parallelize?
-                    for (LayerIndex i = 0; i < LayerIndex(slices.size()); ++ i)
+                    for (LayerIndex i = 0; i < LayerIndex(slices.size()); ++ i) {
+                        // A tall branch is clipped against hundreds of layers, don't wait for all of them when canceled.
+                        if ((i & 0x0F) == 0x0F)
+                            throw_on_cancel();
                         slices[i] = diff_clipped(slices[i], volumes.getCollision(0, layer_begin + i, true)); //FIXME parent_uses_min || draw_area.element->state.use_min_xy_dist);
+                    }
 
                     size_t num_empty = 0;
                     if (slices.front().empty()) {
@@ -1272,6 +1400,7 @@ void organic_draw_branches(
                                  // Only propagate until the rest area is smaller than this threshold.
                                 //double                          support_area_min = 0.1 * support_area_min_radius;
                                 for (LayerIndex layer_idx = layer_begin - 1; layer_idx >= layer_bottommost; -- layer_idx) {
+                                    throw_on_cancel();
                                     rest_support = diff_clipped(rest_support.empty() ? slices.front() : rest_support, volumes.getCollision(0, layer_idx, false));
                                     double rest_support_area = area(rest_support);
                                     if (rest_support_area < support_area_stop)
@@ -4,6 +4,7 @@
 ///|/
 #include <boost/container/static_vector.hpp>
 #include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/enumerable_thread_specific.h>
 #include <oneapi/tbb/parallel_for.h>
 #include <boost/log/trivial.hpp>
 #include <cmath>
@@ -36,6 +37,7 @@
 #include "libslic3r/Polyline.hpp"
 #include "libslic3r/Slicing.hpp"
 #include "libslic3r/Surface.hpp"
+#include "libslic3r/Trace.hpp"
 #include "libslic3r/Utils.hpp"
 #include "libslic3r/libslic3r.h"
 
@@ -155,6 +157,7 @@ std::pair<SupportGeneratorLayersPtr, SupportGeneratorLayersPtr> generate_interfa
     SupportGeneratorLayersPtr         &intermediate_layers,
     SupportGeneratorLayerStorage      &layer_storage)
 {
+    Trace::Span trace_span("Support interface layers", "Support");
     std::pair<SupportGeneratorLayersPtr, SupportGeneratorLayersPtr> base_and_interface_layers;
 
     if (! intermediate_layers.empty() && support_params.has_interfaces()) {
@@ -341,6 +344,7 @@ SupportGeneratorLayersPtr generate_raft_base(
     const SupportGeneratorLayersPtr   &base_layers,
     SupportGeneratorLayerStorage      &layer_storage)
 {
+    Trace::Span trace_span("Support raft", "Support", object.id().id);
     // If there is brim to be generated, calculate the trimming regions.
     Polygons brim;
     if (object.has_brim()) {
@@ -1478,6 +1482,27 @@ SupportGeneratorLayersPtr generate_support_layers(
     return layers_sorted;
 }
 
+// Fillers owned by a single worker thread, so that they are allocated once per thread
+// and reused for all the support layers processed by that thread.
+struct SupportFillers
+{
+    std::unique_ptr<Fill> raft_interface;
+    std::unique_ptr<Fill> raft_support;
+    std::unique_ptr<Fill> interface;
+    std::unique_ptr<Fill> first_layer;
+    std::unique_ptr<Fill> raft_contact;
+    std::unique_ptr<Fill> base_interface;
+    std::unique_ptr<Fill> support;
+
+    static Fill* get(std::unique_ptr<Fill> &filler, InfillPattern pattern, const BoundingBox &bbox) {
+        if (! filler) {
+            filler = std::unique_ptr<Fill>(Fill::new_from_type(pattern));
+            filler->set_bounding_box(bbox);
+        }
+        return filler.get();
+    }
+};
+
 void generate_support_toolpaths(
     SupportLayerPtrs                    &support_layers,
     const PrintObjectConfig             &config,
@@ -1490,6 +1515,7 @@ void generate_support_toolpaths(
     const SupportGeneratorLayersPtr     &interface_layers,
     const SupportGeneratorLayersPtr     &base_interface_layers)
 {
+    Trace::Span trace_span("Support toolpaths", "Support");
     // loop_interface_processor with a given circle radius.
     LoopInterfaceProcessor loop_interface_processor(1.5 * support_params.support_material_interface_flow.scaled_width());
     loop_interface_processor.n_contact_loops = config.support_material_interface_contact_loops ? 1 : 0;
@@ -1503,13 +1529,17 @@ void generate_support_toolpaths(
 //    const coordf_t link_max_length_factor = 3.;
     const coordf_t link_max_length_factor = 0.;
 
+    // Fillers are created lazily per worker thread and shared by the raft and support passes below.
+    tbb::enumerable_thread_specific<SupportFillers> thread_fillers;
+
     // Insert the raft base layers.
     auto n_raft_layers = std::min<size_t>(support_layers.size(), std::max(0, int(slicing_params.raft_layers()) - 1));
 
     tbb::parallel_for(tbb::blocked_range<size_t>(0, n_raft_layers),
         [&support_layers, &raft_layers, &intermediate_layers, &config, &support_params, &slicing_params,
-            &bbox_object, link_max_length_factor]
+            &bbox_object, &thread_fillers, link_max_length_factor]
             (const tbb::blocked_range<size_t>& range) {
+        SupportFillers &fillers = thread_fillers.local();
         for (size_t support_layer_id = range.begin(); support_layer_id < range.end(); ++ support_layer_id)
         {
             assert(support_layer_id < raft_layers.size());
@@ -1517,11 +1547,6 @@ void generate_support_toolpaths(
             assert(support_layer.support_fills.entities.empty());
             SupportGeneratorLayer      &raft_layer    = *raft_layers[support_layer_id];
 
-            std::unique_ptr<Fill> filler_interface = std::unique_ptr<Fill>(Fill::new_from_type(support_params.raft_interface_fill_pattern));
-            std::unique_ptr<Fill> filler_support   = std::unique_ptr<Fill>(Fill::new_from_type(support_params.base_fill_pattern));
-            filler_interface->set_bounding_box(bbox_object);
-            filler_support->set_bounding_box(bbox_object);
-
             // Print the tree supports cutting through the raft with the exception of the 1st layer, where a full support layer will be printed below
             // both the raft and the trees.
             // Trim the raft layers with the tree polygons.
@@ -1539,7 +1564,7 @@ void generate_support_toolpaths(
                 Flow flow(float(support_params.support_material_flow.width()), float(raft_layer.height), support_params.support_material_flow.nozzle_diameter());
                 assert(!raft_layer.bridging);
                 if (! to_infill_polygons.empty()) {
-                    Fill *filler = filler_support.get();
+                    Fill *filler = SupportFillers::get(fillers.raft_support, support_params.base_fill_pattern, bbox_object);
                     filler->angle = support_params.raft_angle_base;
                     filler->spacing = support_params.support_material_flow.spacing();
                     filler->link_max_length = coord_t(scale_(filler->spacing * link_max_length_factor / support_params.support_density));
@@ -1558,7 +1583,7 @@ void generate_support_toolpaths(
                     tree_supports_generate_paths(support_layer.support_fills.entities, tree_polygons, flow, support_params);
             }
 
-            Fill *filler = filler_interface.get();
+            Fill *filler = SupportFillers::get(fillers.raft_interface, support_params.raft_interface_fill_pattern, bbox_object);
             Flow  flow = support_params.first_layer_flow;
             float density = 0.f;
             if (support_layer_id == 0) {
@@ -1616,7 +1641,7 @@ void generate_support_toolpaths(
 
     tbb::parallel_for(tbb::blocked_range<size_t>(n_raft_layers, support_layers.size()),
         [&config, &slicing_params, &support_params, &support_layers, &bottom_contacts, &top_contacts, &intermediate_layers, &interface_layers, &base_interface_layers, &layer_caches, &loop_interface_processor,
-            &bbox_object, &angles, n_raft_layers, link_max_length_factor]
+            &bbox_object, &angles, &thread_fillers, link_max_length_factor]
             (const tbb::blocked_range<size_t>& range) {
         // Indices of the 1st layer in their respective container at the support layer height.
         size_t idx_layer_bottom_contact   = size_t(-1);
@@ -1625,28 +1650,18 @@ void generate_support_toolpaths(
         size_t idx_layer_interface        = size_t(-1);
         size_t idx_layer_base_interface   = size_t(-1);
         const auto fill_type_first_layer  = ipRectilinear;
-        auto filler_interface       = std::unique_ptr<Fill>(Fill::new_from_type(support_params.contact_fill_pattern));
-        // Filler for the 1st layer interface, if different from filler_interface.
-        auto filler_first_layer_ptr = std::unique_ptr<Fill>(range.begin() == 0 && support_params.contact_fill_pattern != fill_type_first_layer ? Fill::new_from_type(fill_type_first_layer) : nullptr);
-        // Pointer to the 1st layer interface filler.
-        auto filler_first_layer     = filler_first_layer_ptr ? filler_first_layer_ptr.get() : filler_interface.get();
+        SupportFillers &fillers           = thread_fillers.local();
+        Fill *filler_interface            = SupportFillers::get(fillers.interface, support_params.contact_fill_pattern, bbox_object);
         // Filler for the 1st layer interface, if different from filler_interface.
-        auto filler_raft_contact_ptr = std::unique_ptr<Fill>(range.begin() == n_raft_layers && config.support_material_interface_layers.value == 0 ? 
-            Fill::new_from_type(support_params.raft_interface_fill_pattern) : nullptr);
-        // Pointer to the 1st layer interface filler.
-        auto filler_raft_contact     = filler_raft_contact_ptr ? filler_raft_contact_ptr.get() : filler_interface.get();
+        Fill *filler_first_layer          = support_params.contact_fill_pattern == fill_type_first_layer ? filler_interface :
+            SupportFillers::get(fillers.first_layer, fill_type_first_layer, bbox_object);
+        // Filler for the raft contact layer, if different from filler_interface.
+        Fill *filler_raft_contact         = config.support_material_interface_layers.value != 0 ? filler_interface :
+            SupportFillers::get(fillers.raft_contact, support_params.raft_interface_fill_pattern, bbox_object);
         // Filler for the base interface (to be used for soluble interface / non soluble base, to produce non soluble interface layer below soluble interface layer).
-        auto filler_base_interface  = std::unique_ptr<Fill>(base_interface_layers.empty() ? nullptr : 
-            Fill::new_from_type(support_params.interface_density > 0.95 || support_params.with_sheath ? ipRectilinear : ipSupportBase));
-        auto filler_support         = std::unique_ptr<Fill>(Fill::new_from_type(support_params.base_fill_pattern));
-        filler_interface->set_bounding_box(bbox_object);
-        if (filler_first_layer_ptr)
-            filler_first_layer_ptr->set_bounding_box(bbox_object);
-        if (filler_raft_contact_ptr)
-            filler_raft_contact_ptr->set_bounding_box(bbox_object);
-        if (filler_base_interface)
-            filler_base_interface->set_bounding_box(bbox_object);
-        filler_support->set_bounding_box(bbox_object);
+        Fill *filler_base_interface       = base_interface_layers.empty() ? nullptr :
+            SupportFillers::get(fillers.base_interface, support_params.interface_density > 0.95 || support_params.with_sheath ? ipRectilinear : ipSupportBase, bbox_object);
+        Fill *filler_support              = SupportFillers::get(fillers.support, support_params.base_fill_pattern, bbox_object);
         for (size_t support_layer_id = range.begin(); support_layer_id < range.end(); ++ support_layer_id)
         {
             SupportLayer &support_layer = *support_layers[support_layer_id];
@@ -1730,7 +1745,7 @@ void generate_support_toolpaths(
                     bool raft_contact      = interface_layer_type == InterfaceLayerType::RaftContact;
                     //FIXME Bottom interfaces are extruded with the briding flow. Some bridging layers have its height slightly reduced, therefore
                     // the bridging flow does not quite apply. Reduce the flow to area of an ellipse? (A = pi * a * b)
-                    auto *filler = raft_contact ? filler_raft_contact : filler_interface.get();
+                    auto *filler = raft_contact ? filler_raft_contact : filler_interface;
                     auto interface_flow = layer_ex.layer->bridging ?
                         Flow::bridging_flow(layer_ex.layer->height, support_params.support_material_bottom_interface_flow.nozzle_diameter()) :
                         (raft_contact ? &support_params.raft_interface_flow : 
@@ -1767,7 +1782,7 @@ void generate_support_toolpaths(
 
             // Base interface layers under soluble interfaces
             if ( ! base_interface_layer.empty() && ! base_interface_layer.polygons_to_extrude().empty()) {
-                Fill *filler = filler_base_interface.get();
+                Fill *filler = filler_base_interface;
                 //FIXME Bottom interfaces are extruded with the briding flow. Some bridging layers have its height slightly reduced, therefore
                 // the bridging flow does not quite apply. Reduce the flow to area of an ellipse? (A = pi * a * b)
                 assert(! base_interface_layer.layer->bridging);
@@ -1789,7 +1804,7 @@ void generate_support_toolpaths(
 
             // Base support or flange.
             if (! base_layer.empty() && ! base_layer.polygons_to_extrude().empty()) {
-                Fill *filler = filler_support.get();
+                Fill *filler = filler_support;
                 filler->angle = angles[support_layer_id % angles.size()];
                 // We don't use $base_flow->spacing because we need a constant spacing
                 // value that guarantees that all layers are correctly aligned.
@@ -1809,7 +1824,6 @@ void generate_support_toolpaths(
                     flow = support_params.first_layer_flow;
                     // use the proper spacing for first layer as we don't need to align
                     // its pattern to the other layers
-                    //FIXME When paralellizing, each thread shall have its own copy of the fillers.
                     filler->spacing = flow.spacing();
                     filler->link_max_length = coord_t(scale_(filler->spacing * link_max_length_factor / density));
                     sheath  = true;
@@ -13,6 +13,7 @@
 #include <boost/log/trivial.hpp>
 #include <oneapi/tbb/blocked_range.h>
 #include <oneapi/tbb/parallel_for.h>
+#include <oneapi/tbb/task_arena.h>
 #include <oneapi/tbb/task_group.h>
 #include <cmath>
 #include <memory>
@@ -49,6 +50,7 @@
 #include "libslic3r/Support/SupportLayer.hpp"
 #include "libslic3r/Support/SupportParameters.hpp"
 #include "libslic3r/Surface.hpp"
+#include "libslic3r/Trace.hpp"
 #include "libslic3r/TriangleSelector.hpp"
 #include "tcbspan/span.hpp"
 
@@ -314,6 +316,8 @@ void PrintObjectSupportMaterial::generate(PrintObject &object)
     SupportGeneratorLayersPtr bottom_contacts = this->bottom_contact_layers_and_layer_support_areas(
         object, top_contacts, buildplate_covered,
         layer_storage, layer_support_areas);
+    // buildplate_covered was consumed by bottom_contact_layers_and_layer_support_areas().
+    buildplate_covered = std::vector<Polygons>();
 
 #ifdef SLIC3R_DEBUG
     for (size_t layer_id = 0; layer_id < object.layers().size(); ++ layer_id)
@@ -345,6 +349,8 @@ void PrintObjectSupportMaterial::generate(PrintObject &object)
 
     // Fill in intermediate layers between the top / bottom support contact layers, trim them by the object.
     this->generate_base_layers(object, bottom_contacts, top_contacts, intermediate_layers, layer_support_areas);
+    // The per object layer support areas were copied into the intermediate layers, release them before generating the interfaces.
+    layer_support_areas = std::vector<Polygons>();
 
 #ifdef SLIC3R_DEBUG
     for (SupportGeneratorLayersPtr::const_iterator it = intermediate_layers.begin(); it != intermediate_layers.end(); ++ it)
@@ -1093,26 +1099,51 @@ namespace SupportMaterialInternal {
 std::vector<Polygons> PrintObjectSupportMaterial::buildplate_covered(const PrintObject &object) const
 {
     // Build support on a build plate only? If so, then collect and union all the surfaces below the current layer.
-    // Unfortunately this is an inherently serial process.
+    // This is a prefix union, it is calculated in parallel over blocks of layers first, then the blocks are merged.
     const bool            buildplate_only = this->build_plate_only();
     std::vector<Polygons> buildplate_covered;
     if (buildplate_only) {
-        BOOST_LOG_TRIVIAL(debug) << "PrintObjectSupportMaterial::buildplate_covered() - start";
-        buildplate_covered.assign(object.layers().size(), Polygons());
-        //FIXME prefix sum algorithm, parallelize it! Parallelization will also likely be more numerically stable.
-        for (size_t layer_id = 1; layer_id < object.layers().size(); ++ layer_id) {
-            const Layer &lower_layer = *object.layers()[layer_id-1];
-            // Merge the new slices with the preceding slices.
-            // Apply the safety offset to the newly added polygons, so they will connect
-            // with the polygons collected before,
-            // but don't apply the safety offset during the union operation as it would
-            // inflate the polygons over and over.
-            Polygons &covered = buildplate_covered[layer_id];
-            covered = buildplate_covered[layer_id - 1];
-            polygons_append(covered, offset(lower_layer.lslices, scale_(0.01)));
-            covered = union_(covered);
+        BOOST_LOG_TRIVIAL(debug) << "PrintObjectSupportMaterial::buildplate_covered() in parallel - start";
+        const size_t num_layers = object.layers().size();
+        const size_t block_size = std::max<size_t>(8, num_layers / (4 * tbb::this_task_arena::max_concurrency()) + 1);
+        const size_t num_blocks = (num_layers + block_size - 1) / block_size;
+        buildplate_covered.assign(num_layers, Polygons());
+        // 1) Union the slices below each layer of a block up to the layer just below the block.
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, num_blocks), 
+            [&object, &buildplate_covered, num_layers, block_size](const tbb::blocked_range<size_t> &range) {
+            for (size_t block_id = range.begin(); block_id < range.end(); ++ block_id) {
+                const size_t layer_begin = block_id * block_size;
+                const size_t layer_end   = std::min(num_layers, layer_begin + block_size);
+                for (size_t layer_id = std::max<size_t>(layer_begin, 1); layer_id < layer_end; ++ layer_id) {
+                    const Layer &lower_layer = *object.layers()[layer_id-1];
+                    // Merge the new slices with the preceding slices.
+                    // Apply the safety offset to the newly added polygons, so they will connect
+                    // with the polygons collected before,
+                    // but don't apply the safety offset during the union operation as it would
+                    // inflate the polygons over and over.
+                    Polygons &covered = buildplate_covered[layer_id];
+                    if (layer_id > layer_begin)
+                        covered = buildplate_covered[layer_id - 1];
+                    polygons_append(covered, offset(lower_layer.lslices, scale_(0.01)));
+                    covered = union_(covered);
+                }
+            }
+        });
+        // 2) Merge the last layer of each block with the last layer of the block below, bottom up.
+        for (size_t block_id = 1; block_id < num_blocks; ++ block_id) {
+            Polygons &covered = buildplate_covered[std::min(num_layers, (block_id + 1) * block_size) - 1];
+            covered = union_(covered, buildplate_covered[block_id * block_size - 1]);
         }
-        BOOST_LOG_TRIVIAL(debug) << "PrintObjectSupportMaterial::buildplate_covered() - end";
+        // 3) Merge the other layers of each block with the last layer of the block below.
+        tbb::parallel_for(tbb::blocked_range<size_t>(std::min(num_layers, block_size), num_layers), 
+            [&buildplate_covered, num_layers, block_size](const tbb::blocked_range<size_t> &range) {
+            for (size_t layer_id = range.begin(); layer_id < range.end(); ++ layer_id)
+                if (layer_id + 1 < num_layers && (layer_id + 1) % block_size != 0) {
+                    Polygons &covered = buildplate_covered[layer_id];
+                    covered = union_(covered, buildplate_covered[layer_id / block_size * block_size - 1]);
+                }
+        });
+        BOOST_LOG_TRIVIAL(debug) << "PrintObjectSupportMaterial::buildplate_covered() in parallel - end";
     }
     return buildplate_covered;
 }
@@ -1674,6 +1705,7 @@ static void merge_contact_layers(const SlicingParameters &slicing_params, double
 SupportGeneratorLayersPtr PrintObjectSupportMaterial::top_contact_layers(
     const PrintObject &object, const std::vector<Polygons> &buildplate_covered, SupportGeneratorLayerStorage &layer_storage) const
 {
+    Trace::Span trace_span("Support top contacts", "Support", object.id().id);
 #ifdef SLIC3R_DEBUG
     static int iRun = 0;
     ++ iRun; 
@@ -1966,6 +1998,7 @@ SupportGeneratorLayersPtr PrintObjectSupportMaterial::bottom_contact_layers_and_
     const PrintObject &object, const SupportGeneratorLayersPtr &top_contacts, std::vector<Polygons> &buildplate_covered, 
     SupportGeneratorLayerStorage &layer_storage, std::vector<Polygons> &layer_support_areas) const
 {
+    Trace::Span trace_span("Support bottom contacts", "Support", object.id().id);
     if (top_contacts.empty())
         return SupportGeneratorLayersPtr();
 
@@ -2136,6 +2169,7 @@ SupportGeneratorLayersPtr PrintObjectSupportMaterial::raft_and_intermediate_supp
     const SupportGeneratorLayersPtr   &top_contacts,
     SupportGeneratorLayerStorage      &layer_storage) const
 {
+    Trace::Span trace_span("Support intermediate layers", "Support", object.id().id);
     SupportGeneratorLayersPtr intermediate_layers;
 
     // Collect and sort the extremes (bottoms of the top contacts and tops of the bottom contacts).
@@ -2338,6 +2372,7 @@ void PrintObjectSupportMaterial::generate_base_layers(
     SupportGeneratorLayersPtr         &intermediate_layers,
     const std::vector<Polygons> &layer_support_areas) const
 {
+    Trace::Span trace_span("Support base layers", "Support", object.id().id);
 #ifdef SLIC3R_DEBUG
     static int iRun = 0;
 #endif /* SLIC3R_DEBUG */
@@ -75,7 +75,9 @@ TreeModelVolumes::TreeModelVolumes(
 #ifdef SLIC3R_TREESUPPORTS_PROGRESS
     m_progress_multiplier{ progress_multiplier }, m_progress_offset{ progress_offset },
 #endif // SLIC3R_TREESUPPORTS_PROGRESS
-    m_machine_border{ calculateMachineBorderCollision(build_volume.polygon()) }
+    m_machine_border{ calculateMachineBorderCollision(build_volume.polygon()) },
+    // Let the avoidances occupy at most a quarter of the physical memory.
+    m_avoidance_memory_budget{ total_physical_memory() / 4 }
 {
 #if 0
     std::unordered_map<size_t, size_t> mesh_to_layeroutline_idx;
@@ -227,31 +229,38 @@ void TreeModelVolumes::precalculate(const PrintObject& print_object, const coord
     if (m_current_min_xy_dist_delta != 0)
         radius_until_layer[m_current_min_xy_dist_delta] = max_layer;
 
-    // Now that required_avoidance_limit contains the maximum of ild and regular required radius just copy.
-    std::vector<RadiusLayerPair> relevant_collision_radiis{ radius_until_layer.begin(), radius_until_layer.end() };
-
-    // Calculate the relevant collisions
-    calculateCollision(relevant_collision_radiis, throw_on_cancel);
-
-    // calculate a separate Collisions with all holes removed. These are relevant for some avoidances that try to avoid holes (called safe)
-    std::vector<RadiusLayerPair> relevant_hole_collision_radiis;
-    for (RadiusLayerPair key : relevant_avoidance_radiis)
-        if (key.first < m_increase_until_radius + m_current_min_xy_dist_delta)
-            relevant_hole_collision_radiis.emplace_back(key);
-
-    // Calculate collisions without holes, built from regular collision
-    calculateCollisionHolefree(relevant_hole_collision_radiis, throw_on_cancel);
-    // Let placables be calculated from calculateAvoidance() for better parallelization.
-    if (m_support_rests_on_model)
-        calculatePlaceables(relevant_avoidance_radiis, throw_on_cancel);
+    // Collisions shared by the calculations of all the other radii: Collision of radius 0 is the source of the placeable areas
+    // and of the wall restrictions, collision of m_increase_until_radius is the source of the hole free collisions.
+    std::vector<RadiusLayerPair> shared_collision_radiis;
+    for (const RadiusLayerPair &key : radius_until_layer)
+        if (key.first == 0 || key.first == m_current_min_xy_dist_delta || key.first == ceilRadius(m_increase_until_radius + m_current_min_xy_dist_delta))
+            shared_collision_radiis.emplace_back(key);
+    calculateCollision(shared_collision_radiis, throw_on_cancel);
 
     auto t_coll = std::chrono::high_resolution_clock::now();
 
-    // Calculate the relevant avoidances in parallel as far as possible
+    // The avoidance of a radius is propagated bottom up and it depends on the collisions of the same radius only (besides the shared collisions
+    // calculated above), thus the collisions, hole free collisions, placeable areas, avoidances and wall restrictions of a single radius
+    // are calculated by a single task, while the tasks of the individual radii run concurrently. This way the avoidance of one radius
+    // is being propagated while the collisions of the other radii are still being calculated, instead of waiting for the slowest collision.
+    // Start with the radii requiring most layers, they form the longest chains.
+    std::sort(relevant_avoidance_radiis.begin(), relevant_avoidance_radiis.end(), [](const RadiusLayerPair &l, const RadiusLayerPair &r) { return l.second > r.second; });
     {
         tbb::task_group task_group;
-        task_group.run([this, relevant_avoidance_radiis, throw_on_cancel]{ calculateAvoidance(relevant_avoidance_radiis, true, m_support_rests_on_model, throw_on_cancel); });
-        task_group.run([this, relevant_avoidance_radiis, throw_on_cancel]{ calculateWallRestrictions(relevant_avoidance_radiis, throw_on_cancel); });
+        for (const RadiusLayerPair &key : relevant_avoidance_radiis)
+            task_group.run([this, key, &throw_on_cancel]{
+                const std::vector<RadiusLayerPair> keys{ key };
+                calculateCollision(keys, throw_on_cancel);
+                // calculate a separate Collisions with all holes removed. These are relevant for some avoidances that try to avoid holes (called safe)
+                if (key.first < m_increase_until_radius + m_current_min_xy_dist_delta)
+                    calculateCollisionHolefree(keys, throw_on_cancel);
+                if (m_support_rests_on_model)
+                    calculatePlaceables(keys, throw_on_cancel);
+                tbb::task_group task_group_inner;
+                task_group_inner.run([this, &keys, &throw_on_cancel]{ calculateAvoidance(keys, true, m_support_rests_on_model, throw_on_cancel); });
+                task_group_inner.run([this, &keys, &throw_on_cancel]{ calculateWallRestrictions(keys, throw_on_cancel); });
+                task_group_inner.wait();
+            });
         task_group.wait();
     }
     auto t_end = std::chrono::high_resolution_clock::now();
@@ -259,7 +268,7 @@ void TreeModelVolumes::precalculate(const PrintObject& print_object, const coord
     auto dur_avo = 0.001 * std::chrono::duration_cast<std::chrono::microseconds>(t_end - t_coll).count();
 
 //    m_precalculated = true;
-    BOOST_LOG_TRIVIAL(info) << "Precalculating collision took" << dur_col << " ms. Precalculating avoidance took " << dur_avo << " ms.";
+    BOOST_LOG_TRIVIAL(info) << "Precalculating shared collisions took " << dur_col << " ms. Precalculating collisions and avoidances per radius took " << dur_avo << " ms.";
 
 #if 0
     // Paint caches into SVGs:
@@ -350,7 +359,7 @@ const Polygons& TreeModelVolumes::getAvoidance(const coord_t orig_radius, LayerI
         result)
         return (*result).get();
 
-    if (m_precalculated) {
+    if (m_precalculated && ! m_avoidance_memory->sparse) {
         if (to_model) {
             BOOST_LOG_TRIVIAL(error_level_not_in_cache) << "Had to calculate Avoidance to model at radius " << radius << " and layer " << layer_idx << ", but precalculate was called. Performance may suffer!";
             tree_supports_show_error("Not precalculated Avoidance(to model) requested."sv, false);
@@ -641,7 +650,8 @@ void TreeModelVolumes::calculateAvoidance(const std::vector<RadiusLayerPair> &ke
             ((iter_idx / 3) & 1) != 0  // to_model
         };
         // Ensure start_layer is at least 1 as if no avoidance was calculated yet getMaxCalculatedLayer() returns -1.
-        task.start_layer = std::max<LayerIndex>(1, 1 + avoidance_cache(task.type, task.to_model).getMaxCalculatedLayer(task.radius));
+        // Avoidance layers may be missing below the highest calculated layer if the avoidance caches are sparse, thus search below max_required_layer only.
+        task.start_layer = std::max<LayerIndex>(1, 1 + avoidance_cache(task.type, task.to_model).getMaxCalculatedLayer(task.radius, task.max_required_layer));
         if (task.start_layer > task.max_required_layer) {
             BOOST_LOG_TRIVIAL(debug) << "Calculation requested for value already calculated?";
             continue;
@@ -683,6 +693,8 @@ void TreeModelVolumes::calculateAvoidance(const std::vector<RadiusLayerPair> &ke
             Polygons    latest_avoidance   = getAvoidance(task.radius, task.start_layer - 1, task.type, task.to_model, true);
             std::vector<std::pair<RadiusLayerPair, Polygons>> data;
             data.reserve(task.max_required_layer + 1 - task.start_layer);
+            // Short runs are recalculations of layers missing in sparse caches, they are stored completely as the neighbor layers will likely be requested next.
+            const bool store_all_layers = task.max_required_layer - task.start_layer < SUPPORT_TREE_AVOIDANCE_CHECKPOINT_STEP;
             for (LayerIndex layer_idx = task.start_layer; layer_idx <= task.max_required_layer; ++ layer_idx) {
                 // Merge current layer collisions with shrunk last_avoidance.
                 const Polygons &current_layer_collisions = collision_holefree ? getCollisionHolefree(task.radius, layer_idx) : getCollision(task.radius, layer_idx, true);
@@ -695,7 +707,14 @@ void TreeModelVolumes::calculateAvoidance(const std::vector<RadiusLayerPair> &ke
                 if (task.to_model)
                     latest_avoidance = diff(latest_avoidance, getPlaceableAreas(task.radius, layer_idx, throw_on_cancel));
                 latest_avoidance = polygons_simplify(latest_avoidance, m_min_resolution, polygons_strictly_simple);
-                data.emplace_back(RadiusLayerPair{task.radius, layer_idx}, latest_avoidance);
+                // Over the memory budget, store just the checkpoint layers and the requested layer. The other layers will be recalculated
+                // from the closest checkpoint below if requested.
+                if (store_all_layers || layer_idx % SUPPORT_TREE_AVOIDANCE_CHECKPOINT_STEP == 0 || layer_idx == task.max_required_layer ||
+                    m_avoidance_memory_budget == 0 || m_avoidance_memory->used < m_avoidance_memory_budget) {
+                    m_avoidance_memory->used += RadiusLayerPolygonCache::polygons_memory(latest_avoidance);
+                    data.emplace_back(RadiusLayerPair{task.radius, layer_idx}, latest_avoidance);
+                } else
+                    m_avoidance_memory->sparse = true;
                 throw_on_cancel();
             }
 #ifdef SLIC3R_TREESUPPORTS_PROGRESS
@@ -714,6 +733,30 @@ void TreeModelVolumes::calculateAvoidance(const std::vector<RadiusLayerPair> &ke
     });
 }
 
+void TreeModelVolumes::release_avoidances_above(LayerIndex layer_idx)
+{
+    size_t released = 0;
+    for (RadiusLayerPolygonCache *cache : { &m_avoidance_cache, &m_avoidance_cache_slow, &m_avoidance_cache_to_model, &m_avoidance_cache_to_model_slow,
+                                            &m_avoidance_cache_holefree, &m_avoidance_cache_holefree_to_model })
+        released += cache->clear_layers_above(layer_idx);
+    if (released > 0) {
+        // The memory accounting is approximate, avoid underflow.
+        size_t used = m_avoidance_memory->used;
+        m_avoidance_memory->used = used > released ? used - released : 0;
+        m_avoidance_memory->sparse = true;
+    }
+}
+
+size_t TreeModelVolumes::cache_memory_used() const
+{
+    size_t out = 0;
+    for (const RadiusLayerPolygonCache *cache : { &m_collision_cache, &m_collision_cache_holefree, &m_avoidance_cache, &m_avoidance_cache_slow,
+                                                  &m_avoidance_cache_to_model, &m_avoidance_cache_to_model_slow, &m_placeable_areas_cache,
+                                                  &m_avoidance_cache_holefree, &m_avoidance_cache_holefree_to_model,
+                                                  &m_wall_restrictions_cache, &m_wall_restrictions_cache_min })
+        out += cache->memory_used();
+    return out;
+}
 
 void TreeModelVolumes::calculatePlaceables(const std::vector<RadiusLayerPair> &keys, std::function<void()> throw_on_cancel)
 {
@@ -17,6 +17,9 @@
 #include <assert.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <atomic>
+#include <limits>
+#include <memory>
 #include <mutex>
 #include <unordered_map>
 #include <functional>
@@ -47,6 +50,7 @@ static constexpr const double  SUPPORT_TREE_EXPONENTIAL_FACTOR = 1.5;
 static constexpr const coord_t SUPPORT_TREE_EXPONENTIAL_THRESHOLD = scaled<coord_t>(1. * SUPPORT_TREE_EXPONENTIAL_FACTOR);
 static constexpr const coord_t SUPPORT_TREE_COLLISION_RESOLUTION = scaled<coord_t>(0.5);
 static constexpr const bool    SUPPORT_TREE_AVOID_SUPPORT_BLOCKER = true;
+static constexpr const int     SUPPORT_TREE_AVOIDANCE_CHECKPOINT_STEP = 16;
 
 class TreeModelVolumes
 {
@@ -80,9 +84,17 @@ public:
         m_placeable_areas_cache.clear_all_but_radius0();
         m_avoidance_cache_holefree.clear();
         m_avoidance_cache_holefree_to_model.clear();
+        m_avoidance_memory->used = 0;
+        m_avoidance_memory->sparse = false;
         m_wall_restrictions_cache.clear();
         m_wall_restrictions_cache_min.clear();
     }
+    // Release the avoidances above layer_idx to reduce memory footprint.
+    // Called while the branches are propagated top down, the avoidances above the layer being processed are not needed anymore,
+    // if they are requested again, they are recalculated lazily.
+    void release_avoidances_above(LayerIndex layer_idx);
+    // Approximate memory held by the polygons of all the caches, for memory usage reporting.
+    size_t cache_memory_used() const;
 
     enum class AvoidanceType : int8_t
     {
@@ -288,9 +300,9 @@ private:
          *
          * \return A wrapped optional reference of the requested area (if it was found, an empty optional if nothing was found)
          */
-        LayerIndex getMaxCalculatedLayer(coord_t radius) const {
+        LayerIndex getMaxCalculatedLayer(coord_t radius, LayerIndex max_layer_idx = std::numeric_limits<LayerIndex>::max()) const {
             std::lock_guard<std::mutex> guard(m_mutex);
-            auto layer_idx = LayerIndex(m_data.size()) - 1;
+            auto layer_idx = std::min(LayerIndex(m_data.size()) - 1, max_layer_idx);
             for (; layer_idx > 0; -- layer_idx)
                 if (const auto &layer = m_data[layer_idx]; layer.find(radius) != layer.end())
                     break;
@@ -302,6 +314,32 @@ private:
         [[nodiscard]] std::vector<std::pair<RadiusLayerPair, std::reference_wrapper<const Polygons>>> sorted() const;
 
         void clear() { m_data.clear(); }
+        // Clear the layers above layer_idx, return the number of bytes of the polygons released.
+        size_t clear_layers_above(LayerIndex layer_idx) {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            size_t released = 0;
+            for (LayerIndex i = std::max(layer_idx + 1, 0); i < LayerIndex(m_data.size()); ++ i) {
+                for (const auto &radius_polygons : m_data[i])
+                    released += polygons_memory(radius_polygons.second);
+                m_data[i].clear();
+            }
+            return released;
+        }
+        size_t memory_used() const {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            size_t out = m_data.capacity() * sizeof(LayerData);
+            for (const LayerData &layer : m_data)
+                for (const auto &radius_polygons : layer)
+                    out += polygons_memory(radius_polygons.second);
+            return out;
+        }
+        // Approximate memory occupied by the points of the polygons.
+        static size_t polygons_memory(const Polygons &polygons) {
+            size_t out = polygons.capacity() * sizeof(Polygon);
+            for (const Polygon &polygon : polygons)
+                out += polygon.points.capacity() * sizeof(Point);
+            return out;
+        }
         void clear_all_but_radius0() { 
             for (LayerData &l : m_data) {
                 auto begin = l.begin();
@@ -528,6 +566,18 @@ private:
     RadiusLayerPolygonCache     m_avoidance_cache_holefree;
     RadiusLayerPolygonCache     m_avoidance_cache_holefree_to_model;
 
+    // Approximate memory held by the polygons of the above avoidance caches, updated by the threads calculating the avoidances.
+    struct AvoidanceMemory {
+        std::atomic<size_t>     used { 0 };
+        // Set if some avoidance layers were not stored or were released, they are recalculated when requested.
+        std::atomic<bool>       sparse { false };
+    };
+    std::unique_ptr<AvoidanceMemory> m_avoidance_memory { std::make_unique<AvoidanceMemory>() };
+    // Once the avoidance caches hold more memory than this budget, only every SUPPORT_TREE_AVOIDANCE_CHECKPOINT_STEP-th layer
+    // of newly calculated avoidances is stored, the other layers are recalculated from the closest layer below when requested.
+    // Zero means no limit.
+    size_t                      m_avoidance_memory_budget { 0 };
+
     RadiusLayerPolygonCache& avoidance_cache(const AvoidanceType type, const bool to_model) {
         if (to_model) {
             switch (type) {
@@ -58,6 +58,7 @@
 #include "libslic3r/Support/TreeModelVolumes.hpp"
 #include "libslic3r/Surface.hpp"
 #include "libslic3r/TriangleSelector.hpp"
+#include "libslic3r/Trace.hpp"
 #include "libslic3r/Utils.hpp"
 
 // #define TREESUPPORT_DEBUG_SVG
@@ -1242,6 +1243,7 @@ static void generate_initial_areas(
     InterfacePlacer                 &interface_placer,
     std::function<void()>            throw_on_cancel)
 {
+    Trace::Span trace_span("Tree support initial areas", "Support");
     using                           AvoidanceType = TreeModelVolumes::AvoidanceType;
     TreeSupportMeshGroupSettings    mesh_group_settings(print_object);
 
@@ -2429,8 +2431,9 @@ static void merge_influence_areas(
  *
  * \param move_bounds[in,out] All currently existing influence areas
  */
-static void create_layer_pathing(const TreeModelVolumes &volumes, const TreeSupportSettings &config, std::vector<SupportElements> &move_bounds, std::function<void()> throw_on_cancel)
+static void create_layer_pathing(TreeModelVolumes &volumes, const TreeSupportSettings &config, std::vector<SupportElements> &move_bounds, std::function<void()> throw_on_cancel)
 {
+    Trace::Span trace_span("Tree support layer pathing", "Support");
 #ifdef SLIC3R_TREESUPPORTS_PROGRESS
     const double data_size_inverse = 1 / double(move_bounds.size());
     double progress_total = TREE_PROGRESS_PRECALC_AVO + TREE_PROGRESS_PRECALC_COLL + TREE_PROGRESS_GENERATE_NODES;
@@ -2520,6 +2523,8 @@ static void create_layer_pathing(const TreeModelVolumes &volumes, const TreeSupp
             progress_total += data_size_inverse * TREE_PROGRESS_AREA_CALC;
             Progress::messageProgress(Progress::Stage::SUPPORT, progress_total * m_progress_multiplier + m_progress_offset, TREE_PROGRESS_TOTAL);
     #endif
+            // The layers below will only query avoidances at layer_idx - 2 and lower.
+            volumes.release_avoidances_above(layer_idx - 1);
             throw_on_cancel();
         }
 
@@ -2677,6 +2682,7 @@ static void create_nodes_from_area(
     std::vector<SupportElements> &move_bounds,
     std::function<void()>         throw_on_cancel)
 {
+    Trace::Span trace_span("Tree support nodes from area", "Support");
     // Initialize points on layer 0, with a "random" point in the influence area. 
     // Point is chosen based on an inaccurate estimate where the branches will split into two, but every point inside the influence area would produce a valid result.
     {
@@ -2813,6 +2819,7 @@ static void generate_branch_areas(
     std::vector<DrawArea>               &linear_data,
     std::function<void()>                throw_on_cancel)
 {
+    Trace::Span trace_span("Tree support branch areas", "Support");
 #ifdef SLIC3R_TREESUPPORTS_PROGRESS
     double progress_total = TREE_PROGRESS_PRECALC_AVO + TREE_PROGRESS_PRECALC_COLL + TREE_PROGRESS_GENERATE_NODES + TREE_PROGRESS_AREA_CALC;
     constexpr int progress_report_steps = 10;
@@ -2944,6 +2951,7 @@ static void smooth_branch_areas(
     const std::vector<size_t>      &linear_data_layers,
     std::function<void()>           throw_on_cancel)
 {
+    Trace::Span trace_span("Tree support smooth branch areas", "Support");
 #ifdef SLIC3R_TREESUPPORTS_PROGRESS
     double progress_total = TREE_PROGRESS_PRECALC_AVO + TREE_PROGRESS_PRECALC_COLL + TREE_PROGRESS_GENERATE_NODES + TREE_PROGRESS_AREA_CALC + TREE_PROGRESS_GENERATE_BRANCH_AREAS;
 #endif // SLIC3R_TREESUPPORTS_PROGRESS
@@ -3074,6 +3082,7 @@ static void drop_non_gracious_areas(
     std::vector<Polygons>                                       &support_layer_storage,
     std::function<void()>                                        throw_on_cancel)
 {
+    Trace::Span trace_span("Tree support drop non gracious areas", "Support");
     std::vector<std::vector<std::pair<LayerIndex, Polygons>>> dropped_down_areas(linear_data.size());
     tbb::parallel_for(tbb::blocked_range<size_t>(0, linear_data.size()),
         [&](const tbb::blocked_range<size_t> &range) {
@@ -3118,6 +3127,7 @@ static void finalize_interface_and_support_areas(
     
     std::function<void()>            throw_on_cancel)
 {
+    Trace::Span trace_span("Tree support finalize areas", "Support");
     assert(std::all_of(bottom_contacts.begin(), bottom_contacts.end(), [](auto *p) { return p == nullptr; }));
 //    assert(std::all_of(top_contacts.begin(), top_contacts.end(), [](auto* p) { return p == nullptr; }));
     assert(std::all_of(intermediate_layers.begin(), intermediate_layers.end(), [](auto* p) { return p == nullptr; }));
@@ -3275,6 +3285,7 @@ static void draw_areas(
     SupportGeneratorLayerStorage    &layer_storage,
     std::function<void()>            throw_on_cancel)
 {
+    Trace::Span trace_span("Tree support draw areas", "Support");
     std::vector<Polygons> support_layer_storage(move_bounds.size());
     std::vector<Polygons> support_roof_storage(move_bounds.size());
     // All SupportElements are put into a layer independent storage to improve parallelization.
@@ -3478,6 +3489,8 @@ static void generate_support_areas(Print &print, const BuildVolume &build_volume
 
         // ### Precalculate avoidances, collision etc.
         size_t num_support_layers = precalculate(print, overhangs, processing.first, processing.second, volumes, throw_on_cancel);
+        if (Trace::enabled())
+            Trace::counter("Tree support caches", "Memory", print_object.id().id, int64_t(volumes.cache_memory_used()));
         bool   has_support = num_support_layers > 0;
         bool   has_raft    = config.raft_layers.size() > 0;
         num_support_layers = std::max(num_support_layers, config.raft_layers.size());
@@ -3546,6 +3559,8 @@ static void generate_support_areas(Print &print, const BuildVolume &build_volume
 
             // ### Propagate the influence areas downwards. This is an inherently serial operation.
             create_layer_pathing(volumes, config, move_bounds, throw_on_cancel);
+            if (Trace::enabled())
+                Trace::counter("Tree support caches", "Memory", print_object.id().id, int64_t(volumes.cache_memory_used()));
             auto t_path = std::chrono::high_resolution_clock::now();
 
             // ### Set a point in each influence area
@@ -75,6 +75,23 @@ bool ExtrusionLine::is_external_perimeter() const
 }
 
 using LD = AABBTreeLines::LinesDistancer<ExtrusionLine>;
+using BoundaryLD = AABBTreeLines::LinesDistancer<Linef>;
+
+// Distancers of the boundaries of the layers below each of the layers. The layers are then processed serially,
+// as the stability and curling of a layer depends on the layers below, thus the distancers are built in parallel beforehand
+// and removed from the serial path. The distancers are owned by the layers and shared with posCalculateOverhangingPerimeters.
+template<typename LayerContainer>
+static std::vector<const BoundaryLD*> lower_layer_boundaries(const LayerContainer &layers)
+{
+    static const BoundaryLD no_lower_layer;
+    std::vector<const BoundaryLD*> out(layers.size(), &no_lower_layer);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, layers.size()), [&layers, &out](const tbb::blocked_range<size_t> &range) {
+        for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++ layer_idx)
+            if (const Layer *lower_layer = layers[layer_idx]->lower_layer; lower_layer != nullptr)
+                out[layer_idx] = &lower_layer->lslices_distancer();
+    });
+    return out;
+}
 
 struct SupportGridFilter
 {
@@ -525,7 +542,7 @@ ObjectPart::ObjectPart(
             continue;
         }
 
-        for (const ExtrusionEntity* entity: collection->flatten()) {
+        for (const ExtrusionEntity* entity: collection->flatten_view()) {
             Polylines polylines;
             std::vector<float> widths;
 
@@ -939,7 +956,7 @@ std::vector<EnitityToCheck> gather_entities_to_check(const Layer* layer) {
 
 LocalSupports compute_local_supports(
     const std::vector<EnitityToCheck>& entities_to_check,
-    const std::optional<Linesf>& previous_layer_boundary,
+    const BoundaryLD& prev_layer_boundary_distancer,
     const LD& prev_layer_ext_perim_lines,
     size_t slices_count,
     const Params& params
@@ -947,9 +964,6 @@ LocalSupports compute_local_supports(
     std::vector<tbb::concurrent_vector<ExtrusionLine>> unstable_lines_per_slice(slices_count);
     std::vector<tbb::concurrent_vector<ExtrusionLine>> ext_perim_lines_per_slice(slices_count);
 
-    AABBTreeLines::LinesDistancer<Linef> prev_layer_boundary_distancer =
-        (previous_layer_boundary ? AABBTreeLines::LinesDistancer<Linef>{*previous_layer_boundary} : AABBTreeLines::LinesDistancer<Linef>{});
-
     if constexpr (debug_files) {
         for (const auto &e_to_check : entities_to_check) {
             for (const auto &line : check_extrusion_entity_stability(e_to_check.e, e_to_check.region, prev_layer_ext_perim_lines,
@@ -998,9 +1012,41 @@ std::optional<PartialObject> to_partial_object(const ObjectPart& part) {
     return {};
 }
 
+// Object parts formed by the individual slices of the individual layers. These do not depend on each other,
+// thus they are calculated in parallel, while the parts are merged across layers serially.
+using PrecomputedSliceParts = std::vector<std::vector<ObjectPart>>;
+PrecomputedSliceParts precompute_slices_parts(const PrintObject *po, const Params &params)
+{
+    PrecomputedSliceParts result(po->layer_count());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, po->layers().size()), [po, &params, &result](tbb::blocked_range<size_t> r) {
+        for (size_t lidx = r.begin(); lidx < r.end(); lidx++) {
+            const Layer *layer = po->get_layer(lidx);
+            result[lidx].assign(layer->lslices_ex.size(), ObjectPart{});
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, layer->lslices_ex.size()), [lidx, layer, &params, &result](tbb::blocked_range<size_t> r2) {
+                for (size_t slice_idx = r2.begin(); slice_idx < r2.end(); slice_idx++) {
+                    const LayerSlice &slice = layer->lslices_ex.at(slice_idx);
+                    const std::optional<Polygons> brim{
+                         has_brim(layer, params) ?
+                         std::optional{get_brim(layer->lslices[slice_idx], params.brim_type, params.brim_width)} :
+                         std::nullopt
+                    };
+                    result[lidx][slice_idx] = ObjectPart{
+                        gather_extrusions(slice, layer),
+                        int(layer->id()) == params.raft_layers_count, // connected to bed
+                        layer->print_z,
+                        layer->height,
+                        brim
+                    };
+                }
+            });
+        }
+    });
+    return result;
+}
+
 SliceMappings update_active_object_parts(const Layer                        *layer,
-                                         const Params                       &params,
                                          const std::vector<SliceConnection> &precomputed_slice_connections,
+                                         const std::vector<ObjectPart>      &precomputed_slice_parts,
                                          const SliceMappings                &previous_slice_mappings,
                                          ActiveObjectParts                  &active_object_parts,
                                          PartialObjects                     &partial_objects)
@@ -1009,21 +1055,7 @@ SliceMappings update_active_object_parts(const Layer                        *lay
 
     for (size_t slice_idx = 0; slice_idx < layer->lslices_ex.size(); ++slice_idx) {
         const LayerSlice &slice             = layer->lslices_ex.at(slice_idx);
-        const std::vector<const ExtrusionEntityCollection*> extrusion_collections{gather_extrusions(slice, layer)};
-        const bool connected_to_bed = int(layer->id()) == params.raft_layers_count;
-
-        const std::optional<Polygons> brim{
-             has_brim(layer, params) ?
-             std::optional{get_brim(layer->lslices[slice_idx], params.brim_type, params.brim_width)} :
-             std::nullopt
-        };
-        ObjectPart new_part{
-            extrusion_collections,
-            connected_to_bed,
-            layer->print_z,
-            layer->height,
-            brim
-        };
+        const ObjectPart &new_part          = precomputed_slice_parts[slice_idx];
 
         const SliceConnection &connection_to_below = precomputed_slice_connections[slice_idx];
 
@@ -1125,6 +1157,7 @@ void reckon_global_supports(const tbb::concurrent_vector<ExtrusionLine> &externa
 
 std::tuple<SupportPoints, PartialObjects> check_stability(const PrintObject                 *po,
                                                           const PrecomputedSliceConnections &precomputed_slices_connections,
+                                                          const PrecomputedSliceParts       &precomputed_slices_parts,
                                                           const PrintTryCancel              &cancel_func,
                                                           const Params                      &params)
 {
@@ -1135,21 +1168,17 @@ std::tuple<SupportPoints, PartialObjects> check_stability(const PrintObject
     LD                prev_layer_ext_perim_lines;
 
     SliceMappings slice_mappings;
-
+    const std::vector<const BoundaryLD*> prev_layer_boundaries = lower_layer_boundaries(po->layers());
 
     for (size_t layer_idx = 0; layer_idx < po->layer_count(); ++layer_idx) {
         cancel_func();
         const Layer *layer                 = po->get_layer(layer_idx);
         float        bottom_z              = layer->bottom_z();
 
-        slice_mappings = update_active_object_parts(layer, params, precomputed_slices_connections[layer_idx], slice_mappings, active_object_parts, partial_objects);
-
-        std::optional<Linesf> prev_layer_boundary = layer->lower_layer != nullptr ?
-                                                        std::optional{to_unscaled_linesf(layer->lower_layer->lslices)} :
-                                                        std::nullopt;
+        slice_mappings = update_active_object_parts(layer, precomputed_slices_connections[layer_idx], precomputed_slices_parts[layer_idx], slice_mappings, active_object_parts, partial_objects);
 
         LocalSupports local_supports{
-            compute_local_supports(gather_entities_to_check(layer), prev_layer_boundary, prev_layer_ext_perim_lines, layer->lslices_ex.size(), params)};
+            compute_local_supports(gather_entities_to_check(layer), *prev_layer_boundaries[layer_idx], prev_layer_ext_perim_lines, layer->lslices_ex.size(), params)};
 
         std::vector<ExtrusionLine> current_layer_ext_perims_lines{};
         current_layer_ext_perims_lines.reserve(prev_layer_ext_perim_lines.get_lines().size());
@@ -1231,7 +1260,8 @@ void debug_export(const SupportPoints& support_points,const PartialObjects& obje
 std::tuple<SupportPoints, PartialObjects> full_search(const PrintObject *po, const PrintTryCancel& cancel_func, const Params &params)
 {
     auto precomputed_slices_connections = precompute_slices_connections(po);
-    auto results = check_stability(po, precomputed_slices_connections, cancel_func, params);
+    auto precomputed_slices_parts = precompute_slices_parts(po, params);
+    auto results = check_stability(po, precomputed_slices_connections, precomputed_slices_parts, cancel_func, params);
 #ifdef DEBUG_FILES
     auto [supp_points, objects] = results;
     debug_export(supp_points, objects, "issues");
@@ -1253,7 +1283,7 @@ void estimate_supports_malformations(SupportLayerPtrs &layers, float flow_width,
         l->curled_lines.clear();
         std::vector<ExtrusionLine> current_layer_lines;
 
-        for (const ExtrusionEntity *extrusion : l->support_fills.flatten().entities) {
+        for (const ExtrusionEntity *extrusion : l->support_fills.flatten_view()) {
             Polyline pl = extrusion->as_polyline();
             Polygon  pol(pl.points);
             pol.make_counter_clockwise();
@@ -1322,14 +1352,15 @@ void estimate_malformations(LayerPtrs &layers, const Params &params)
 #endif
 
     LD prev_layer_lines{};
+    const std::vector<const BoundaryLD*> prev_layer_boundaries = lower_layer_boundaries(layers);
 
-    for (Layer *l : layers) {
+    for (size_t layer_idx = 0; layer_idx < layers.size(); ++ layer_idx) {
+        Layer *l = layers[layer_idx];
         l->curled_lines.clear();
-        std::vector<Linef> boundary_lines = l->lower_layer != nullptr ? to_unscaled_linesf(l->lower_layer->lslices) : std::vector<Linef>();
-        AABBTreeLines::LinesDistancer<Linef> prev_layer_boundary{std::move(boundary_lines)};
-        std::vector<ExtrusionLine>           current_layer_lines;
+        const BoundaryLD           &prev_layer_boundary = *prev_layer_boundaries[layer_idx];
+        std::vector<ExtrusionLine>  current_layer_lines;
         for (const LayerRegion *layer_region : l->regions()) {
-            for (const ExtrusionEntity *extrusion : layer_region->perimeters().flatten().entities) {
+            for (const ExtrusionEntity *extrusion : layer_region->perimeters().flatten_view()) {
                 if (!extrusion->role().is_external_perimeter())
                     continue;
 
@@ -241,6 +241,7 @@ public:
     float sticking_second_moment_of_area_covariance_accumulator{};
     bool  connected_to_bed = false;
 
+    ObjectPart() = default;
     ObjectPart(
         const std::vector<const ExtrusionEntityCollection*>& extrusion_collections,
         const bool connected_to_bed,
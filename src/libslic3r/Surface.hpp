@@ -103,6 +103,12 @@ public:
         return *this;
     }
 
+    bool operator==(const Surface &rhs) const {
+        return surface_type == rhs.surface_type && thickness == rhs.thickness && thickness_layers == rhs.thickness_layers &&
+               bridge_angle == rhs.bridge_angle && extra_perimeters == rhs.extra_perimeters && expolygon == rhs.expolygon;
+    }
+    bool operator!=(const Surface &rhs) const { return ! (*this == rhs); }
+
 	double area() 		 const { return this->expolygon.area(); }
     bool   empty() 		 const { return expolygon.empty(); }
     void   clear() 			   { expolygon.clear(); }
@@ -11,6 +11,10 @@
 #include <cassert>
 #include <cstring>
 
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
+#include <limits>
+
 #include "ExPolygon.hpp"
 #include "admesh/stl.h"
 
@@ -201,16 +205,422 @@ private:
     bool            m_flipped;
 };
 
-std::vector<Vec3d> triangulate_expolygon_3d(const ExPolygon &poly, coordf_t z, bool flip)
+// Triangulation of valid ExPolygons (contours not intersecting, contour CCW, holes CW, as produced by Clipper)
+// by decomposing them into y-monotone polygons with a sweep line and triangulating the monotone polygons in linear time,
+// see de Berg et al.: Computational Geometry, Algorithms and Applications, Chapter 3.
+// The shape of the triangles is not optimized and no new vertices are created, thus the output is valid
+// only for valid input. The buffers are reused over the triangulated ExPolygons.
+class MonotoneTesselator {
+public:
+    // Append the triangles of expoly to out. Returns false if the ExPolygon could not be triangulated due to
+    // a degenerate input, leaving out unchanged.
+    bool tesselate3d(const ExPolygon &expoly, double z, bool flipped, std::vector<Vec3d> &out)
+    {
+        m_vertices.clear();
+        m_triangles.clear();
+        m_diagonals.clear();
+        size_t num_holes = 0;
+        if (! this->add_ring(expoly.contour.points, true))
+            return false;
+        for (const Polygon &hole : expoly.holes) {
+            const size_t num_vertices = m_vertices.size();
+            if (! this->add_ring(hole.points, false))
+                return false;
+            if (m_vertices.size() > num_vertices)
+                ++ num_holes;
+        }
+        if (m_vertices.size() < 3 || ! this->decompose() || ! this->triangulate_faces())
+            return false;
+
+        // Validate the triangulation: Each triangulation of a polygon with n vertices and h holes consists of n + 2h - 2 triangles
+        // and the triangles cover the polygon area exactly.
+        if (m_triangles.size() + 2 != m_vertices.size() + 2 * num_holes)
+            return false;
+        double area = 0.;
+        for (const Vec3i &t : m_triangles)
+            area += double(cross(m_vertices[t.x()].pt, m_vertices[t.y()].pt, m_vertices[t.z()].pt));
+        if (std::abs(area - m_area) > 1e-6 * m_area)
+            return false;
+
+        auto emplace = [&out, z, this](int idx) {
+            const Point &pt = m_vertices[idx].pt;
+            out.emplace_back(unscale<double>(pt.x()), unscale<double>(pt.y()), z);
+        };
+        for (const Vec3i &t : m_triangles) {
+            emplace(t.x());
+            emplace(flipped ? t.z() : t.y());
+            emplace(flipped ? t.y() : t.z());
+        }
+        return true;
+    }
+
+private:
+    enum class VertexType : uint8_t {
+        Start,
+        End,
+        Split,
+        Merge,
+        Regular
+    };
+
+    struct Vertex {
+        Point       pt;
+        uint32_t    prev;
+        uint32_t    next;
+        // Helper of the edge starting at this vertex.
+        uint32_t    helper;
+        VertexType  type;
+    };
+
+    // Twice the signed area of the triangle, positive if CCW.
+    static int64_t cross(const Point &a, const Point &b, const Point &c)
+    {
+        return (int64_t(b.x()) - int64_t(a.x())) * (int64_t(c.y()) - int64_t(a.y())) -
+               (int64_t(b.y()) - int64_t(a.y())) * (int64_t(c.x()) - int64_t(a.x()));
+    }
+
+    // Sweep line order: Higher y first, then lower x first, then lower index first to order duplicate points.
+    bool above(uint32_t i, uint32_t j) const
+    {
+        const Point &pi = m_vertices[i].pt;
+        const Point &pj = m_vertices[j].pt;
+        return pi.y() > pj.y() || (pi.y() == pj.y() && (pi.x() < pj.x() || (pi.x() == pj.x() && i < j)));
+    }
+
+    bool add_ring(const Points &points, bool ccw)
+    {
+        const auto first = uint32_t(m_vertices.size());
+        double     area  = 0.;
+        for (size_t i = 0; i < points.size(); ++ i) {
+            const Point &pt = points[i];
+            // Skip zero length edges.
+            if (m_vertices.size() > first && (m_vertices.back().pt == pt || (i + 1 == points.size() && m_vertices[first].pt == pt)))
+                continue;
+            if (m_vertices.size() > first)
+                area += double(int64_t(m_vertices.back().pt.x()) * int64_t(pt.y()) - int64_t(pt.x()) * int64_t(m_vertices.back().pt.y()));
+            m_vertices.push_back({ pt, uint32_t(m_vertices.size() - 1), uint32_t(m_vertices.size() + 1), 0, VertexType::Regular });
+        }
+        if (m_vertices.size() < first + 3) {
+            // Degenerate ring.
+            m_vertices.resize(first);
+            return ! ccw;
+        }
+        const auto last = uint32_t(m_vertices.size() - 1);
+        area += double(int64_t(m_vertices[last].pt.x()) * int64_t(m_vertices[first].pt.y()) - int64_t(m_vertices[first].pt.x()) * int64_t(m_vertices[last].pt.y()));
+        m_vertices[first].prev = last;
+        m_vertices[last].next  = first;
+        if (ccw) {
+            m_area = area;
+            return area > 0.;
+        }
+        m_area += area;
+        return area < 0.;
+    }
+
+    // Split the polygon into y-monotone polygons by adding diagonals to the split and merge vertices.
+    bool decompose()
+    {
+        const auto num_vertices = uint32_t(m_vertices.size());
+        m_order.resize(num_vertices);
+        for (uint32_t i = 0; i < num_vertices; ++ i) {
+            m_order[i] = i;
+            Vertex      &v       = m_vertices[i];
+            const bool   p_below = this->above(i, v.prev);
+            const bool   n_below = this->above(i, v.next);
+            const bool   convex  = cross(m_vertices[v.prev].pt, v.pt, m_vertices[v.next].pt) > 0;
+            v.type = p_below && n_below ? (convex ? VertexType::Start : VertexType::Split) :
+                    ! p_below && ! n_below ? (convex ? VertexType::End : VertexType::Merge) : VertexType::Regular;
+        }
+        std::sort(m_order.begin(), m_order.end(), [this](uint32_t i, uint32_t j) { return this->above(i, j); });
+
+        // Edges crossing the sweep line with the polygon interior to their right, sorted from left to right.
+        // An edge is identified by its first vertex, it is always oriented downwards.
+        m_status.clear();
+        // Index of the first edge in m_status, which does not have vertex v to its right.
+        auto lower_bound = [this](uint32_t v) {
+            const Point &pt = m_vertices[v].pt;
+            return std::partition_point(m_status.begin(), m_status.end(), [this, &pt](uint32_t e) {
+                return cross(m_vertices[e].pt, m_vertices[m_vertices[e].next].pt, pt) > 0; });
+        };
+        auto add_diagonal_to_merge_helper = [this](uint32_t v, uint32_t e) {
+            if (uint32_t h = m_vertices[e].helper; m_vertices[h].type == VertexType::Merge)
+                m_diagonals.emplace_back(v, h);
+        };
+
+        for (uint32_t v : m_order) {
+            Vertex &vertex = m_vertices[v];
+            switch (vertex.type) {
+            case VertexType::Start:
+                m_status.insert(lower_bound(v), v);
+                vertex.helper = v;
+                break;
+            case VertexType::End:
+            case VertexType::Merge:
+            {
+                auto it = std::find(m_status.begin(), m_status.end(), vertex.prev);
+                if (it == m_status.end())
+                    return false;
+                add_diagonal_to_merge_helper(v, vertex.prev);
+                m_status.erase(it);
+                if (vertex.type == VertexType::Merge) {
+                    it = lower_bound(v);
+                    if (it == m_status.begin())
+                        return false;
+                    add_diagonal_to_merge_helper(v, *(-- it));
+                    m_vertices[*it].helper = v;
+                }
+                break;
+            }
+            case VertexType::Split:
+            {
+                auto it = lower_bound(v);
+                if (it == m_status.begin())
+                    return false;
+                uint32_t &helper = m_vertices[*std::prev(it)].helper;
+                m_diagonals.emplace_back(v, helper);
+                helper = v;
+                m_status.insert(it, v);
+                vertex.helper = v;
+                break;
+            }
+            case VertexType::Regular:
+                if (this->above(vertex.prev, v)) {
+                    // The boundary goes downwards, the interior is to the right of v.
+                    auto it = std::find(m_status.begin(), m_status.end(), vertex.prev);
+                    if (it == m_status.end())
+                        return false;
+                    add_diagonal_to_merge_helper(v, vertex.prev);
+                    *it = v;
+                    vertex.helper = v;
+                } else {
+                    auto it = lower_bound(v);
+                    if (it == m_status.begin())
+                        return false;
+                    -- it;
+                    add_diagonal_to_merge_helper(v, *it);
+                    m_vertices[*it].helper = v;
+                }
+                break;
+            }
+        }
+        return true;
+    }
+
+    // Walk the faces of the polygon split by the diagonals and triangulate them.
+    bool triangulate_faces()
+    {
+        const auto num_vertices = uint32_t(m_vertices.size());
+        if (m_diagonals.empty()) {
+            m_face.resize(num_vertices);
+            for (uint32_t i = 0, v = 0; i < num_vertices; ++ i, v = m_vertices[v].next)
+                m_face[i] = v;
+            // Without holes, the vertices of the only face are reachable by walking the contour.
+            return this->triangulate_monotone();
+        }
+
+        // Half edges sorted by their first vertex: The polygon edges followed by both directions of the diagonals.
+        m_half_edges.clear();
+        m_half_edges.reserve(num_vertices + 2 * m_diagonals.size());
+        for (uint32_t i = 0; i < num_vertices; ++ i)
+            m_half_edges.emplace_back(i, m_vertices[i].next);
+        for (const auto &[a, b] : m_diagonals) {
+            m_half_edges.emplace_back(a, b);
+            m_half_edges.emplace_back(b, a);
+        }
+        std::sort(m_half_edges.begin(), m_half_edges.end());
+        m_half_edges.erase(std::unique(m_half_edges.begin(), m_half_edges.end()), m_half_edges.end());
+        m_first_half_edge.assign(num_vertices + 1, 0);
+        for (const auto &he : m_half_edges)
+            ++ m_first_half_edge[he.first + 1];
+        for (uint32_t i = 0; i < num_vertices; ++ i)
+            m_first_half_edge[i + 1] += m_first_half_edge[i];
+
+        // Continue the face boundary from half edge (a, b) at b by the first half edge clockwise from (b, a),
+        // thus the face stays to the left.
+        auto next_half_edge = [this](size_t he) {
+            const auto [a, b] = m_half_edges[he];
+            uint32_t   begin  = m_first_half_edge[b];
+            uint32_t   end    = m_first_half_edge[b + 1];
+            if (end == begin + 1)
+                return size_t(begin);
+            const Vec2d dir_in = (m_vertices[a].pt - m_vertices[b].pt).cast<double>();
+            size_t      best   = begin;
+            double      best_angle = std::numeric_limits<double>::max();
+            for (uint32_t i = begin; i < end; ++ i) {
+                const Vec2d dir_out = (m_vertices[m_half_edges[i].second].pt - m_vertices[b].pt).cast<double>();
+                double angle = atan2(cross2(dir_out, dir_in), dir_in.dot(dir_out));
+                if (angle <= 0.)
+                    angle += 2. * PI;
+                if (angle < best_angle) {
+                    best_angle = angle;
+                    best       = i;
+                }
+            }
+            return best;
+        };
+
+        m_half_edge_visited.assign(m_half_edges.size(), false);
+        for (size_t he_first = 0; he_first < m_half_edges.size(); ++ he_first)
+            if (! m_half_edge_visited[he_first]) {
+                m_face.clear();
+                for (size_t he = he_first; ! m_half_edge_visited[he]; he = next_half_edge(he)) {
+                    m_half_edge_visited[he] = true;
+                    m_face.emplace_back(m_half_edges[he].first);
+                }
+                if (! this->triangulate_monotone())
+                    return false;
+            }
+        return true;
+    }
+
+    // Triangulate a y-monotone polygon stored in m_face in CCW order.
+    bool triangulate_monotone()
+    {
+        const size_t num_vertices = m_face.size();
+        if (num_vertices < 3)
+            return false;
+        size_t top    = 0;
+        size_t bottom = 0;
+        for (size_t i = 1; i < num_vertices; ++ i) {
+            if (this->above(m_face[i], m_face[top]))
+                top = i;
+            if (this->above(m_face[bottom], m_face[i]))
+                bottom = i;
+        }
+
+        // Merge the left chain (from top to bottom in CCW order) and the right chain (from top to bottom in CW order)
+        // into a sequence sorted in the sweep line order. If the chains are not sorted, the polygon is not y-monotone.
+        auto next = [num_vertices](size_t i) { return i + 1 == num_vertices ? 0 : i + 1; };
+        auto prev = [num_vertices](size_t i) { return i == 0 ? num_vertices - 1 : i - 1; };
+        m_sorted.clear();
+        m_sorted.push_back({ m_face[top], true });
+        for (size_t left = next(top), right = prev(top); left != bottom || right != bottom;) {
+            const bool     from_left = right == bottom || (left != bottom && this->above(m_face[left], m_face[right]));
+            const uint32_t v         = m_face[from_left ? left : right];
+            if (! this->above(m_sorted.back().first, v))
+                return false;
+            m_sorted.push_back({ v, from_left });
+            if (from_left)
+                left = next(left);
+            else
+                right = prev(right);
+        }
+        m_sorted.push_back({ m_face[bottom], false });
+
+        auto emit = [this](uint32_t a, uint32_t b, uint32_t c) {
+            if (cross(m_vertices[a].pt, m_vertices[b].pt, m_vertices[c].pt) < 0)
+                std::swap(b, c);
+            m_triangles.emplace_back(int(a), int(b), int(c));
+        };
+
+        m_stack.clear();
+        m_stack.push_back(m_sorted[0]);
+        m_stack.push_back(m_sorted[1]);
+        for (size_t j = 2; j + 1 < num_vertices; ++ j) {
+            const auto [v, v_left] = m_sorted[j];
+            if (v_left != m_stack.back().second) {
+                // Opposite chains: Connect v to all the vertices on the stack.
+                for (size_t k = 0; k + 1 < m_stack.size(); ++ k)
+                    emit(v, m_stack[k].first, m_stack[k + 1].first);
+                m_stack.clear();
+                m_stack.push_back(m_sorted[j - 1]);
+                m_stack.push_back(m_sorted[j]);
+            } else {
+                // Same chain: Cut off the triangles, while the diagonals are inside the polygon.
+                auto last = m_stack.back();
+                m_stack.pop_back();
+                while (! m_stack.empty()) {
+                    const uint32_t s = m_stack.back().first;
+                    const int64_t  c = v_left ? cross(m_vertices[s].pt, m_vertices[last.first].pt, m_vertices[v].pt) :
+                                                cross(m_vertices[v].pt, m_vertices[last.first].pt, m_vertices[s].pt);
+                    if (c <= 0)
+                        break;
+                    emit(v, last.first, s);
+                    last = m_stack.back();
+                    m_stack.pop_back();
+                }
+                m_stack.push_back(last);
+                m_stack.push_back(m_sorted[j]);
+            }
+        }
+        const uint32_t v = m_sorted.back().first;
+        for (size_t k = 0; k + 1 < m_stack.size(); ++ k)
+            emit(v, m_stack[k].first, m_stack[k + 1].first);
+        return true;
+    }
+
+    std::vector<Vertex>                         m_vertices;
+    // Twice the area of the polygon.
+    double                                      m_area { 0. };
+    std::vector<uint32_t>                       m_order;
+    std::vector<uint32_t>                       m_status;
+    std::vector<std::pair<uint32_t, uint32_t>>  m_diagonals;
+    std::vector<std::pair<uint32_t, uint32_t>>  m_half_edges;
+    std::vector<uint32_t>                       m_first_half_edge;
+    std::vector<bool>                           m_half_edge_visited;
+    std::vector<uint32_t>                       m_face;
+    // Vertices of a monotone polygon sorted in the sweep line order, paired with a flag of the vertex being on the left chain.
+    std::vector<std::pair<uint32_t, bool>>      m_sorted;
+    std::vector<std::pair<uint32_t, bool>>      m_stack;
+    std::vector<Vec3i>                          m_triangles;
+};
+
+// Triangulate with the monotone tesselator, fall back to the GLU tesselator on a degenerate input.
+static void tesselate3d_monotone(const ExPolygon &expoly, double z, bool flip, MonotoneTesselator &monotone, std::vector<Vec3d> &out)
+{
+    if (! monotone.tesselate3d(expoly, z, flip, out))
+        append(out, GluTessWrapper().tesselate3d(expoly, z, flip));
+}
+
+std::vector<Vec3d> triangulate_expolygon_3d(const ExPolygon &poly, coordf_t z, bool flip, TesselationMethod method)
 {
+    if (method == TesselationMethod::MonotoneSweep) {
+        MonotoneTesselator monotone;
+        std::vector<Vec3d> out;
+        tesselate3d_monotone(poly, z, flip, monotone, out);
+        return out;
+    }
     GluTessWrapper tess;
     return tess.tesselate3d(poly, z, flip);
 }
 
-std::vector<Vec3d> triangulate_expolygons_3d(const ExPolygons &polys, coordf_t z, bool flip)
+std::vector<Vec3d> triangulate_expolygons_3d(const ExPolygons &polys, coordf_t z, bool flip, TesselationMethod method)
 {
-	GluTessWrapper tess;
-    return tess.tesselate3d(polys, z, flip);
+    // Below this number of points, triangulating in parallel does not pay off.
+    static constexpr const size_t parallel_threshold = 4096;
+    if (polys.size() < 2 || count_points(polys) < parallel_threshold) {
+        if (method == TesselationMethod::MonotoneSweep) {
+            MonotoneTesselator monotone;
+            std::vector<Vec3d> out;
+            for (const ExPolygon &expoly : polys)
+                tesselate3d_monotone(expoly, z, flip, monotone, out);
+            return out;
+        }
+    	GluTessWrapper tess;
+        return tess.tesselate3d(polys, z, flip);
+    }
+
+    // The ExPolygons are independent, triangulate them in parallel and concatenate the results in their original order.
+    std::vector<std::vector<Vec3d>> triangles(polys.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, polys.size()), [&polys, &triangles, z, flip, method](const tbb::blocked_range<size_t> &range) {
+        if (method == TesselationMethod::MonotoneSweep) {
+            MonotoneTesselator monotone;
+            for (size_t i = range.begin(); i < range.end(); ++ i)
+                tesselate3d_monotone(polys[i], z, flip, monotone, triangles[i]);
+        } else {
+            GluTessWrapper tess;
+            for (size_t i = range.begin(); i < range.end(); ++ i)
+                triangles[i] = tess.tesselate3d(polys[i], z, flip);
+        }
+    });
+    size_t num_triangle_points = 0;
+    for (const std::vector<Vec3d> &t : triangles)
+        num_triangle_points += t.size();
+    std::vector<Vec3d> out;
+    out.reserve(num_triangle_points);
+    for (const std::vector<Vec3d> &t : triangles)
+        append(out, t);
+    return out;
 }
 
 std::vector<Vec2d> triangulate_expolygon_2d(const ExPolygon &poly, bool flip)
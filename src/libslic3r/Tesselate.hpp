@@ -18,8 +18,18 @@ namespace Slic3r {
 const bool constexpr NORMALS_UP = false;
 const bool constexpr NORMALS_DOWN = true;
 
-extern std::vector<Vec3d> triangulate_expolygon_3d (const ExPolygon  &poly,  coordf_t z = 0, bool flip = NORMALS_UP);
-extern std::vector<Vec3d> triangulate_expolygons_3d(const ExPolygons &polys, coordf_t z = 0, bool flip = NORMALS_UP);
+// The GLU tesselator accepts any input including self intersecting contours, adding the intersection points.
+// The monotone sweep tesselation is faster, but it expects valid ExPolygons as produced by Clipper and it does not care
+// about the shape of the triangles, which is sufficient for example for the caps of preview meshes.
+// Degenerate ExPolygons are passed to the GLU tesselator.
+enum class TesselationMethod {
+    GLU,
+    MonotoneSweep
+};
+
+// ExPolygons with many points are triangulated in parallel.
+extern std::vector<Vec3d> triangulate_expolygon_3d (const ExPolygon  &poly,  coordf_t z = 0, bool flip = NORMALS_UP, TesselationMethod method = TesselationMethod::GLU);
+extern std::vector<Vec3d> triangulate_expolygons_3d(const ExPolygons &polys, coordf_t z = 0, bool flip = NORMALS_UP, TesselationMethod method = TesselationMethod::GLU);
 extern std::vector<Vec2d> triangulate_expolygon_2d (const ExPolygon  &poly,  bool flip = NORMALS_UP);
 extern std::vector<Vec2d> triangulate_expolygons_2d(const ExPolygons &polys, bool flip = NORMALS_UP);
 extern std::vector<Vec2f> triangulate_expolygon_2f (const ExPolygon  &poly,  bool flip = NORMALS_UP);
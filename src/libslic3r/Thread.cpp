@@ -14,6 +14,8 @@
 #endif
 
 #include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/global_control.h>
+#include <oneapi/tbb/info.h>
 #include <oneapi/tbb/parallel_for.h>
 #include <oneapi/tbb/task_arena.h>
 #include <condition_variable>
@@ -24,6 +26,8 @@
 #include <cassert>
 #include <cstddef>
 
+#include <boost/log/trivial.hpp>
+
 #include "Thread.hpp"
 #include "Utils.hpp"
 #include "LocalesUtils.hpp"
@@ -277,6 +281,75 @@ void name_tbb_thread_pool_threads_set_locale()
         });
 }
 
+namespace {
+class JobArenaLocalesSetter : public tbb::task_scheduler_observer
+{
+public:
+    JobArenaLocalesSetter(tbb::task_arena &arena) : tbb::task_scheduler_observer(arena) { this->observe(true); }
+    ~JobArenaLocalesSetter() override { this->observe(false); }
+    void on_scheduler_entry(bool /* is_worker */) override { thread_data().tbb_worker_thread_set_c_locales(); }
+};
+} // namespace
+
+static tbb::task_arena::constraints job_arena_constraints(const JobArenaConfig &config)
+{
+	tbb::task_arena::constraints constraints;
+	int concurrency = tbb::info::default_concurrency();
+	if (config.numa_node >= 0) {
+		const std::vector<tbb::numa_node_id> numa_nodes = tbb::info::numa_nodes();
+		if (std::find(numa_nodes.begin(), numa_nodes.end(), tbb::numa_node_id(config.numa_node)) != numa_nodes.end()) {
+			constraints.set_numa_id(config.numa_node);
+			concurrency = tbb::info::default_concurrency(config.numa_node);
+		} else
+			BOOST_LOG_TRIVIAL(warning) << "NUMA node " << config.numa_node << " is not available, the worker threads will not be pinned.";
+	}
+	// The arena must not request more threads than the global limit allows, the master thread is counted in.
+	concurrency = std::min(concurrency, int(tbb::global_control::active_value(tbb::global_control::max_allowed_parallelism)));
+	if (config.max_concurrency > 0)
+		concurrency = std::min(concurrency, int(config.max_concurrency));
+	constraints.set_max_concurrency(std::max(concurrency, 1));
+	return constraints;
+}
+
+void execute_in_job_arena(const JobArenaConfig &config, const std::function<void()> &fn)
+{
+	// Spawn the worker threads and apply the global thread limit from the default arena, otherwise the limit
+	// would be derived from the concurrency of the first job arena.
+	name_tbb_thread_pool_threads_set_locale();
+
+	if (config.is_default()) {
+		fn();
+		return;
+	}
+
+	tbb::task_arena arena(job_arena_constraints(config), 1, config.low_priority ? tbb::task_arena::priority::low : tbb::task_arena::priority::normal);
+	// The worker threads of a NUMA constrained arena may not have been named and their locales set yet.
+	JobArenaLocalesSetter locales_setter(arena);
+	arena.execute(fn);
+}
+
+void execute_in_shared_job_arena(const JobArenaConfig &config, size_t num_threads, const std::function<void(size_t)> &fn)
+{
+	name_tbb_thread_pool_threads_set_locale();
+
+	const tbb::task_arena::constraints constraints = job_arena_constraints(config);
+	num_threads = std::clamp<size_t>(num_threads, 1, size_t(constraints.max_concurrency));
+	// A slot is reserved for each of the threads, so that none of them waits for a free slot with its function
+	// enqueued as a task, which could then be executed by a thread blocked in another function.
+	tbb::task_arena arena(constraints, unsigned(num_threads), config.low_priority ? tbb::task_arena::priority::low : tbb::task_arena::priority::normal);
+	// Sets the locales of the worker threads and of the threads started below once they enter the arena.
+	JobArenaLocalesSetter locales_setter(arena);
+	std::vector<boost::thread> threads;
+	threads.reserve(num_threads - 1);
+	for (size_t thread_idx = 1; thread_idx < num_threads; ++ thread_idx) {
+		boost::thread::attributes attrs;
+		threads.emplace_back(create_thread(attrs, [&arena, &fn, thread_idx]() { arena.execute([&fn, thread_idx]() { fn(thread_idx); }); }));
+	}
+	arena.execute([&fn]() { fn(0); });
+	for (boost::thread &thread : threads)
+		thread.join();
+}
+
 void set_current_thread_qos()
 {
 #ifdef __APPLE__
@@ -15,6 +15,8 @@
 #include <thread>
 #include <random>
 #include <optional>
+#include <functional>
+#include <cstddef>
 
 namespace Slic3r {
 
@@ -57,6 +59,30 @@ std::optional<std::string> get_current_thread_name();
 // Also it sets locale of the worker threads to "C" for the G-code generator to produce "." as a decimal separator.
 void name_tbb_thread_pool_threads_set_locale();
 
+// Limits of the task arena a single slicing job is executed in.
+struct JobArenaConfig
+{
+    // Maximum number of threads working on the job, zero for the default concurrency.
+    size_t  max_concurrency { 0 };
+    // Index of the NUMA node the worker threads are pinned to, -1 for no pinning.
+    // Only effective if TBB detects the NUMA topology at runtime (the TBBbind library and hwloc are available).
+    int     numa_node       { -1 };
+    // Jobs of a low priority yield the worker threads to jobs of a normal priority running concurrently.
+    bool    low_priority    { false };
+
+    bool    is_default() const { return max_concurrency == 0 && numa_node < 0 && ! low_priority; }
+};
+
+// Execute fn inside a TBB task arena created by the config, all the TBB parallel regions started by fn
+// (including the libslic3r execution policies) are then limited by the arena. The concurrency of the arena
+// never exceeds the global thread limit. Exceptions thrown by fn are propagated to the caller.
+void execute_in_job_arena(const JobArenaConfig &config, const std::function<void()> &fn);
+
+// Execute fn(thread_idx) by num_threads threads concurrently (the calling thread being the first of them), all of them inside
+// a single TBB task arena created by the config, thus the jobs run by the threads share the worker threads of the arena.
+// The number of threads is capped by the concurrency of the arena. Returns once all the threads finished; fn shall not throw.
+void execute_in_shared_job_arena(const JobArenaConfig &config, size_t num_threads, const std::function<void(size_t)> &fn);
+
 template<class Fn>
 inline boost::thread create_thread(boost::thread::attributes &attrs, Fn &&fn)
 {
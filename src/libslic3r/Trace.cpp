@@ -0,0 +1,209 @@
+#include "Trace.hpp"
+
+#include <boost/log/trivial.hpp>
+#include <boost/nowide/fstream.hpp>
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+#include "Thread.hpp"
+
+namespace Slic3r::Trace {
+
+namespace detail {
+    std::atomic<bool> g_enabled { false };
+}
+
+struct Event
+{
+    const char *name;
+    const char *category;
+    int64_t     id;
+    int64_t     start_ns;
+    int64_t     end_ns;
+    // Valid for a counter sample, for which end_ns is -1.
+    int64_t     value;
+};
+
+// Events of a single thread. Only the owning thread appends, the mutex is held for a short time only
+// to let stats() read the events while the traced work is running.
+struct ThreadBuffer
+{
+    size_t                      tid;
+    std::string                 thread_name;
+    std::mutex                  mutex;
+    std::vector<Event>          events;
+};
+
+static std::mutex                                 g_buffers_mutex;
+// The buffers are kept for the life time of the process, as the threads keep referencing them.
+static std::vector<std::unique_ptr<ThreadBuffer>> g_buffers;
+static std::atomic<int64_t>                       g_start_ns { 0 };
+
+static ThreadBuffer& thread_buffer()
+{
+    thread_local ThreadBuffer *buffer = nullptr;
+    if (buffer == nullptr) {
+        std::scoped_lock lock(g_buffers_mutex);
+        g_buffers.emplace_back(std::make_unique<ThreadBuffer>());
+        buffer = g_buffers.back().get();
+        buffer->tid = g_buffers.size();
+        std::optional<std::string> name = get_current_thread_name();
+        buffer->thread_name = name ? *name : "thread " + std::to_string(buffer->tid);
+    }
+    return *buffer;
+}
+
+static void append_event(const Event &event)
+{
+    ThreadBuffer &buffer = thread_buffer();
+    std::scoped_lock lock(buffer.mutex);
+    // Drop a span started before the last start().
+    if (event.start_ns >= g_start_ns.load(std::memory_order_relaxed))
+        buffer.events.push_back(event);
+}
+
+void detail::record(const char *name, const char *category, int64_t id, int64_t start_ns, int64_t end_ns)
+{
+    if (enabled())
+        append_event({ name, category, id, start_ns, end_ns, 0 });
+}
+
+void detail::record_counter(const char *name, const char *category, int64_t id, int64_t value)
+{
+    if (enabled())
+        append_event({ name, category, id, now_ns(), -1, value });
+}
+
+void start()
+{
+    std::scoped_lock lock(g_buffers_mutex);
+    g_start_ns = detail::now_ns();
+    // start() may be called while other threads record, thus the buffers are cleared, not released.
+    for (std::unique_ptr<ThreadBuffer> &buffer : g_buffers) {
+        std::scoped_lock buffer_lock(buffer->mutex);
+        buffer->events.clear();
+    }
+    detail::g_enabled = true;
+}
+
+void stop()
+{
+    detail::g_enabled = false;
+}
+
+static void write_json_string(std::ostream &os, const char *str)
+{
+    os << '"';
+    for (; *str != 0; ++ str)
+        if (*str == '"' || *str == '\\')
+            os << '\\' << *str;
+        else if (static_cast<unsigned char>(*str) >= 0x20)
+            os << *str;
+    os << '"';
+}
+
+bool write_chrome_trace(const std::string &path)
+{
+    boost::nowide::ofstream os(path);
+    if (! os.good()) {
+        BOOST_LOG_TRIVIAL(error) << "Failed to open " << path << " to write the trace into";
+        return false;
+    }
+    std::scoped_lock lock(g_buffers_mutex);
+    const int64_t    start_ns = g_start_ns;
+    os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    for (const std::unique_ptr<ThreadBuffer> &buffer : g_buffers) {
+        std::scoped_lock buffer_lock(buffer->mutex);
+        if (buffer->events.empty())
+            continue;
+        os << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->tid << ",\"args\":{\"name\":";
+        write_json_string(os, buffer->thread_name.c_str());
+        os << "}}";
+        first = false;
+        for (const Event &event : buffer->events) {
+            os << ",\n{\"name\":";
+            write_json_string(os, event.name);
+            os << ",\"cat\":";
+            write_json_string(os, event.category);
+            if (event.end_ns < 0) {
+                // Counter sample, the series of the same name are told apart by their id.
+                os << ",\"ph\":\"C\",\"pid\":1,\"tid\":" << buffer->tid << ",\"ts\":" << double(event.start_ns - start_ns) * 0.001;
+                if (event.id >= 0)
+                    os << ",\"id\":" << event.id;
+                os << ",\"args\":{\"value\":" << event.value << "}}";
+                continue;
+            }
+            // Complete events with microsecond timestamps.
+            os << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->tid << ",\"ts\":" << double(event.start_ns - start_ns) * 0.001 <<
+                ",\"dur\":" << double(event.end_ns - event.start_ns) * 0.001;
+            if (event.id >= 0)
+                os << ",\"args\":{\"id\":" << event.id << "}";
+            os << "}";
+        }
+    }
+    os << "\n]}\n";
+    os.close();
+    if (os.fail()) {
+        BOOST_LOG_TRIVIAL(error) << "Failed to write the trace into " << path;
+        return false;
+    }
+    return true;
+}
+
+Stats stats()
+{
+    Stats out;
+    // Spans aggregated by their name, category and id.
+    std::map<std::tuple<std::string_view, std::string_view, int64_t>, SpanStats> spans;
+    std::vector<std::pair<int64_t, int64_t>> intervals;
+    std::scoped_lock lock(g_buffers_mutex);
+    for (const std::unique_ptr<ThreadBuffer> &buffer : g_buffers) {
+        intervals.clear();
+        {
+            std::scoped_lock buffer_lock(buffer->mutex);
+            for (const Event &event : buffer->events)
+                if (event.end_ns >= 0) {
+                    auto [it, inserted] = spans.try_emplace({ event.name, event.category, event.id },
+                        SpanStats{ event.name, event.category, event.id, 0, 0, event.start_ns, event.end_ns });
+                    SpanStats &span = it->second;
+                    ++ span.count;
+                    span.total_ns += event.end_ns - event.start_ns;
+                    span.first_start_ns = std::min(span.first_start_ns, event.start_ns);
+                    span.last_end_ns    = std::max(span.last_end_ns, event.end_ns);
+                    intervals.emplace_back(event.start_ns, event.end_ns);
+                }
+        }
+        if (intervals.empty())
+            continue;
+        // The spans of a single thread are nested, the thread is busy for the union of the spans.
+        std::sort(intervals.begin(), intervals.end());
+        int64_t busy_ns = 0;
+        int64_t begin   = intervals.front().first;
+        int64_t end     = intervals.front().second;
+        for (const std::pair<int64_t, int64_t> &interval : intervals)
+            if (interval.first > end) {
+                busy_ns += end - begin;
+                begin = interval.first;
+                end   = interval.second;
+            } else
+                end = std::max(end, interval.second);
+        busy_ns += end - begin;
+        out.threads.push_back({ buffer->thread_name, busy_ns });
+        out.begin_ns = out.threads.size() == 1 ? intervals.front().first : std::min(out.begin_ns, intervals.front().first);
+        out.end_ns   = std::max(out.end_ns, end);
+    }
+    out.spans.reserve(spans.size());
+    for (auto &kvp : spans)
+        out.spans.push_back(kvp.second);
+    std::sort(out.spans.begin(), out.spans.end(), [](const SpanStats &l, const SpanStats &r){ return l.first_start_ns < r.first_start_ns; });
+    return out;
+}
+
+} // namespace Slic3r::Trace
@@ -0,0 +1,100 @@
+#ifndef slic3r_Trace_hpp_
+#define slic3r_Trace_hpp_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Slic3r {
+
+// Lightweight structured tracing of the slicing process.
+// Scoped spans are recorded into per thread buffers with the thread, the span name, its category and
+// an optional identifier of the object or of the layer being processed. Counters (e.g. the memory usage)
+// may be sampled along the spans. The trace may be exported as a Chrome trace JSON to be inspected
+// with chrome://tracing or Perfetto.
+// The spans recorded so far may be aggregated by stats() while the traced work is running, to be displayed live.
+// Tracing is disabled by default, a disabled span costs a single relaxed atomic load.
+namespace Trace {
+
+namespace detail {
+    extern std::atomic<bool> g_enabled;
+    void record(const char *name, const char *category, int64_t id, int64_t start_ns, int64_t end_ns);
+    void record_counter(const char *name, const char *category, int64_t id, int64_t value);
+    inline int64_t now_ns() { return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count(); }
+} // namespace detail
+
+inline bool enabled() { return detail::g_enabled.load(std::memory_order_relaxed); }
+// Start recording. The spans recorded so far are discarded. May be called while other threads record spans,
+// the spans started before start() are dropped.
+void        start();
+// Stop recording, the recorded spans are kept until the next start().
+void        stop();
+// Write the recorded spans as a Chrome trace JSON. Call after the traced work has finished,
+// spans being recorded concurrently may be missing from the output.
+// Returns false if the file could not be written.
+bool        write_chrome_trace(const std::string &path);
+
+// Records a sample of a counter, the samples of the same name and id are displayed as a single graph.
+// name and category must be string literals or strings outliving the trace.
+inline void counter(const char *name, const char *category, int64_t id, int64_t value)
+    { if (enabled()) detail::record_counter(name, category, id, value); }
+
+// Spans of the same name, category and id aggregated by stats().
+struct SpanStats
+{
+    const char *name;
+    const char *category;
+    int64_t     id;
+    size_t      count;
+    // Sum of the durations of the spans, which may have run in parallel.
+    int64_t     total_ns;
+    int64_t     first_start_ns;
+    int64_t     last_end_ns;
+};
+
+struct ThreadStats
+{
+    std::string name;
+    // Time spent inside the recorded spans.
+    int64_t     busy_ns;
+};
+
+struct Stats
+{
+    // Time range covered by the recorded spans.
+    int64_t                  begin_ns { 0 };
+    int64_t                  end_ns   { 0 };
+    // Sorted by the start of their first span.
+    std::vector<SpanStats>   spans;
+    // Threads which recorded a span.
+    std::vector<ThreadStats> threads;
+};
+
+// Aggregate the spans recorded since the last start(). Unlike write_chrome_trace(), it may be called while the traced work is running.
+Stats       stats();
+
+// Records the life time of this object as a single span.
+// name and category must be string literals or strings outliving the trace.
+class Span
+{
+public:
+    Span(const char *name, const char *category, int64_t id = -1) :
+        m_name(name), m_category(category), m_id(id), m_start_ns(enabled() ? detail::now_ns() : 0) {}
+    ~Span() { if (m_start_ns != 0) detail::record(m_name, m_category, m_id, m_start_ns, detail::now_ns()); }
+
+    Span(const Span&) = delete;
+    Span& operator=(const Span&) = delete;
+
+private:
+    const char *m_name;
+    const char *m_category;
+    int64_t     m_id;
+    int64_t     m_start_ns;
+};
+
+} // namespace Trace
+} // namespace Slic3r
+
+#endif // slic3r_Trace_hpp_
@@ -26,12 +26,16 @@
 #include <oneapi/tbb/blocked_range.h>
 #include <oneapi/tbb/concurrent_vector.h>
 #include <oneapi/tbb/parallel_for.h>
+#include <array>
+#include <atomic>
 #include <cmath>
+#include <limits>
 #include <vector>
 #include <utility>
 #include <algorithm>
 #include <iterator>
 #include <map>
+#include <numeric>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
@@ -63,13 +67,13 @@ static void update_bounding_box(const indexed_triangle_set &its, TriangleMeshSta
 
 static void fill_initial_stats(const indexed_triangle_set &its, TriangleMeshStats &out)
 {
+    // Face neighbors, patches, open edges and volume in a single parallel pass.
+    const MeshTopology topology = its_topology(its);
     out.number_of_facets    = its.indices.size();
-    out.volume              = its_volume(its);
+    out.volume              = topology.volume;
     update_bounding_box(its, out);
-
-    const std::vector<Vec3i> face_neighbors = its_face_neighbors(its);
-    out.number_of_parts = its_number_of_patches(its, face_neighbors);
-    out.open_edges      = its_num_open_edges(face_neighbors);
+    out.number_of_parts     = int(topology.number_of_patches);
+    out.open_edges          = int(topology.open_edges);
 }
 
 TriangleMesh::TriangleMesh(const std::vector<Vec3f> &vertices, const std::vector<Vec3i> &faces) : its { faces, vertices }
@@ -426,7 +430,7 @@ bool TriangleMesh::has_zero_volume() const
 
 std::vector<TriangleMesh> TriangleMesh::split() const
 {
-    std::vector<indexed_triangle_set> itss = its_split(this->its);
+    std::vector<indexed_triangle_set> itss = its_split(this->its, its_topology(this->its));
     std::vector<TriangleMesh> out;
     out.reserve(itss.size());
     for (indexed_triangle_set &m : itss) {
@@ -718,64 +722,152 @@ std::vector<Vec3i> its_face_edge_ids(const indexed_triangle_set &its, std::vecto
     return out;
 }
 
+// Key of a vertex for its_merge_vertices(): the coordinates mapped to unsigned integers preserving their order.
+struct VertexSortKey {
+    std::array<uint32_t, 3> coords;
+    int                     idx;
+};
+
+// Parallel stable LSD radix sort of the vertex keys by their coordinates, one byte per pass.
+// The passes, in which all the keys share the same byte, are skipped.
+static void radix_sort_vertex_keys(std::vector<VertexSortKey> &keys)
+{
+    constexpr size_t num_passes = 12;
+    constexpr size_t block_size = 1 << 16;
+    const size_t     num_blocks = (keys.size() + block_size - 1) / block_size;
+    // The z coordinate is the least significant one, the lowest byte first.
+    auto digit = [](const VertexSortKey &key, size_t pass) { return (key.coords[2 - pass / 4] >> (8 * (pass % 4))) & 0x0ff; };
+
+    std::vector<VertexSortKey> tmp(keys.size());
+    // Histograms of the digits of each block.
+    std::vector<std::array<size_t, 256>> histograms(num_blocks);
+    for (size_t pass = 0; pass < num_passes; ++ pass) {
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, num_blocks, 1), [&](const tbb::blocked_range<size_t> &range) {
+            for (size_t block = range.begin(); block < range.end(); ++ block) {
+                std::array<size_t, 256> &histogram = histograms[block];
+                histogram.fill(0);
+                for (size_t i = block * block_size; i < std::min(keys.size(), (block + 1) * block_size); ++ i)
+                    ++ histogram[digit(keys[i], pass)];
+            }
+        });
+        // Start of each digit of each block in the sorted output, the blocks of the same digit following each other.
+        size_t offset  = 0;
+        bool   trivial = false;
+        for (size_t d = 0; d < 256; ++ d) {
+            const size_t digit_start = offset;
+            for (size_t block = 0; block < num_blocks; ++ block) {
+                size_t count = histograms[block][d];
+                histograms[block][d] = offset;
+                offset += count;
+            }
+            if (offset - digit_start == keys.size())
+                trivial = true;
+        }
+        if (trivial)
+            continue;
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, num_blocks, 1), [&](const tbb::blocked_range<size_t> &range) {
+            for (size_t block = range.begin(); block < range.end(); ++ block) {
+                std::array<size_t, 256> &start = histograms[block];
+                for (size_t i = block * block_size; i < std::min(keys.size(), (block + 1) * block_size); ++ i)
+                    tmp[start[digit(keys[i], pass)] ++] = keys[i];
+            }
+        });
+        keys.swap(tmp);
+    }
+}
+
 // Merge duplicate vertices, return number of vertices removed.
-int its_merge_vertices(indexed_triangle_set &its, bool shrink_to_fit)
+int its_merge_vertices(indexed_triangle_set &its, bool shrink_to_fit, float epsilon)
 {
+    const size_t num_vertices = its.vertices.size();
+    if (num_vertices < 2)
+        return 0;
+
     // 1) Sort indices to vertices lexicographically by coordinates AND vertex index.
-    auto sorted = reserve_vector<int>(its.vertices.size());
-    for (int i = 0; i < int(its.vertices.size()); ++ i)
-        sorted.emplace_back(i);
-    std::sort(sorted.begin(), sorted.end(), [&its](int il, int ir) {
-        const Vec3f &l = its.vertices[il];
-        const Vec3f &r = its.vertices[ir];
-        // Sort lexicographically by coordinates AND vertex index.
-        return l.x() < r.x() || (l.x() == r.x() && (l.y() < r.y() || (l.y() == r.y() && (l.z() < r.z() || (l.z() == r.z() && il < ir)))));
+    // The vertices are snapped to a grid of epsilon size, or the floats are mapped to unsigned integers preserving their order.
+    auto coord_key = [epsilon](float f) -> uint32_t {
+        if (epsilon > 0.f)
+            return uint32_t(int32_t(std::clamp(std::floor(double(f) / double(epsilon)), double(std::numeric_limits<int32_t>::min()), double(std::numeric_limits<int32_t>::max())))) ^ 0x80000000u;
+        // Treat -0 as 0.
+        if (f == 0.f)
+            f = 0.f;
+        uint32_t bits;
+        memcpy(&bits, &f, sizeof(bits));
+        return (bits & 0x80000000u) ? ~ bits : bits | 0x80000000u;
+    };
+    std::vector<VertexSortKey> sorted(num_vertices);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_vertices, 4096), [&](const tbb::blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i < range.end(); ++ i) {
+            const Vec3f &p = its.vertices[i];
+            sorted[i] = { { coord_key(p.x()), coord_key(p.y()), coord_key(p.z()) }, int(i) };
+        }
     });
+    // The radix sort is stable, thus the duplicate vertices remain sorted by their index.
+    radix_sort_vertex_keys(sorted);
 
     // 2) Map duplicate vertices to the one with the lowest vertex index.
     // The vertex to stay will have a map_vertices[...] == -1 index assigned, the other vertices will point to it.
-    std::vector<int> map_vertices(its.vertices.size(), -1);
-    for (int i = 0; i < int(sorted.size());) {
-        const int    u = sorted[i];
-        const Vec3f &p = its.vertices[u];
-        int j = i;
-        for (++ j; j < int(sorted.size()); ++ j) {
-            const int    v = sorted[j];
-            const Vec3f &q = its.vertices[v];
-            if (p != q)
-                break;
-            assert(v > u);
-            map_vertices[v] = u;
+    std::vector<int> map_vertices(num_vertices, -1);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_vertices, 4096), [&](const tbb::blocked_range<size_t> &range) {
+        // Find the first vertex of the run of duplicates, which this range starts with.
+        size_t first = range.begin();
+        while (first > 0 && sorted[first - 1].coords == sorted[range.begin()].coords)
+            -- first;
+        for (size_t i = range.begin(); i < range.end(); ++ i) {
+            if (sorted[i].coords != sorted[first].coords)
+                first = i;
+            else if (i != first) {
+                assert(sorted[i].idx > sorted[first].idx);
+                map_vertices[sorted[i].idx] = sorted[first].idx;
+            }
         }
-        i = j;
-    }
+    });
+    sorted = {};
 
     // 3) Shrink its.vertices, update map_vertices with the new vertex indices.
-    int k = 0;
-    for (int i = 0; i < int(its.vertices.size()); ++ i) {
-        if (map_vertices[i] == -1) {
-            map_vertices[i] = k;
-            if (k < i)
-                its.vertices[k] = its.vertices[i];
-            ++ k;
-        } else {
-            assert(map_vertices[i] < i);
-            map_vertices[i] = map_vertices[map_vertices[i]];
-        }
-    }
-
-    int num_erased = int(its.vertices.size()) - k;
+    // The new indices of the vertices to stay are assigned first, as the duplicates of a block may point to a vertex of another block.
+    constexpr size_t block_size = 1 << 16;
+    const size_t     num_blocks = (num_vertices + block_size - 1) / block_size;
+    std::vector<int> block_start(num_blocks + 1, 0);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_blocks, 1), [&](const tbb::blocked_range<size_t> &range) {
+        for (size_t block = range.begin(); block < range.end(); ++ block)
+            block_start[block + 1] = int(std::count(map_vertices.begin() + block * block_size, map_vertices.begin() + std::min(num_vertices, (block + 1) * block_size), -1));
+    });
+    for (size_t block = 0; block < num_blocks; ++ block)
+        block_start[block + 1] += block_start[block];
 
+    const int num_erased = int(num_vertices) - block_start.back();
     if (num_erased) {
+        std::vector<Vec3f> vertices(block_start.back());
+        std::vector<int>   new_index(num_vertices);
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, num_blocks, 1), [&](const tbb::blocked_range<size_t> &range) {
+            for (size_t block = range.begin(); block < range.end(); ++ block) {
+                int k = block_start[block];
+                for (size_t i = block * block_size; i < std::min(num_vertices, (block + 1) * block_size); ++ i)
+                    if (map_vertices[i] == -1) {
+                        vertices[k] = its.vertices[i];
+                        new_index[i] = k ++;
+                    }
+            }
+        });
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, num_vertices, 4096), [&](const tbb::blocked_range<size_t> &range) {
+            for (size_t i = range.begin(); i < range.end(); ++ i)
+                if (map_vertices[i] != -1) {
+                    assert(map_vertices[i] < int(i) && map_vertices[map_vertices[i]] == -1);
+                    new_index[i] = new_index[map_vertices[i]];
+                }
+        });
         // Shrink the vertices.
-        its.vertices.erase(its.vertices.begin() + k, its.vertices.end());
-        // Remap face indices.
-        for (stl_triangle_vertex_indices &face : its.indices)
-            for (int i = 0; i < 3; ++ i)
-                face(i) = map_vertices[face(i)];
-        // Optionally shrink to fit (reallocate) vertices.
         if (shrink_to_fit)
-            its.vertices.shrink_to_fit();
+            its.vertices = std::move(vertices);
+        else
+            its.vertices.assign(vertices.begin(), vertices.end());
+        // Remap face indices.
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, its.indices.size(), 4096), [&](const tbb::blocked_range<size_t> &range) {
+            for (size_t i = range.begin(); i < range.end(); ++ i)
+                for (int j = 0; j < 3; ++ j)
+                    its.indices[i](j) = new_index[its.indices[i](j)];
+        });
     }
 
     return num_erased;
@@ -811,30 +903,53 @@ int its_remove_degenerate_faces(indexed_triangle_set &its, bool shrink_to_fit)
 
 int its_compactify_vertices(indexed_triangle_set &its, bool shrink_to_fit)
 {
-    // First used to mark referenced vertices, later used for mapping old vertex index to a new one.
-    std::vector<int> vertex_map(its.vertices.size(), 0);
-    // Mark referenced vertices.
-    for (const stl_triangle_vertex_indices &face : its.indices)
-        for (int i = 0; i < 3; ++ i)
-            vertex_map[face(i)] = 1;
-    // Compactify vertices, update map from old vertex index to a new one.
-    int last = 0;
-    for (int i = 0; i < int(vertex_map.size()); ++ i)
-        if (vertex_map[i]) {
-            if (last < i)
-                its.vertices[last] = its.vertices[i];
-            vertex_map[i] = last ++;
-        }
-    int removed = int(its.vertices.size()) - last;
+    const size_t num_vertices = its.vertices.size();
+    // Mark referenced vertices. The same vertex may be marked by multiple threads, thus the marks are atomic.
+    std::vector<std::atomic<uint8_t>> referenced(num_vertices);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, its.indices.size(), 4096), [&](const tbb::blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i < range.end(); ++ i)
+            for (int j = 0; j < 3; ++ j)
+                referenced[its.indices[i](j)].store(1, std::memory_order_relaxed);
+    });
+    // Count the referenced vertices of each block to compactify the blocks in parallel.
+    constexpr size_t block_size = 1 << 16;
+    const size_t     num_blocks = (num_vertices + block_size - 1) / block_size;
+    std::vector<int> block_start(num_blocks + 1, 0);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_blocks, 1), [&](const tbb::blocked_range<size_t> &range) {
+        for (size_t block = range.begin(); block < range.end(); ++ block)
+            for (size_t i = block * block_size; i < std::min(num_vertices, (block + 1) * block_size); ++ i)
+                block_start[block + 1] += referenced[i].load(std::memory_order_relaxed);
+    });
+    for (size_t block = 0; block < num_blocks; ++ block)
+        block_start[block + 1] += block_start[block];
+
+    const int last    = block_start.back();
+    const int removed = int(num_vertices) - last;
     if (removed) {
-        its.vertices.erase(its.vertices.begin() + last, its.vertices.end());
-        // Update faces with the new vertex indices.
-        for (stl_triangle_vertex_indices &face : its.indices)
-            for (int i = 0; i < 3; ++ i)
-                face(i) = vertex_map[face(i)];
+        // Compactify vertices, map old vertex index to a new one.
+        std::vector<Vec3f> vertices(last);
+        std::vector<int>   vertex_map(num_vertices, -1);
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, num_blocks, 1), [&](const tbb::blocked_range<size_t> &range) {
+            for (size_t block = range.begin(); block < range.end(); ++ block) {
+                int k = block_start[block];
+                for (size_t i = block * block_size; i < std::min(num_vertices, (block + 1) * block_size); ++ i)
+                    if (referenced[i].load(std::memory_order_relaxed)) {
+                        vertices[k] = its.vertices[i];
+                        vertex_map[i] = k ++;
+                    }
+            }
+        });
         // Optionally shrink the vertices.
         if (shrink_to_fit)
-            its.vertices.shrink_to_fit();
+            its.vertices = std::move(vertices);
+        else
+            its.vertices.assign(vertices.begin(), vertices.end());
+        // Update faces with the new vertex indices.
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, its.indices.size(), 4096), [&](const tbb::blocked_range<size_t> &range) {
+            for (size_t i = range.begin(); i < range.end(); ++ i)
+                for (int j = 0; j < 3; ++ j)
+                    its.indices[i](j) = vertex_map[its.indices[i](j)];
+        });
     }
     return removed;
 }
@@ -1605,19 +1720,80 @@ float its_average_edge_length(const indexed_triangle_set &its)
     return float(edge_length / (3 * its.indices.size()));
 }
 
+// Split the mesh into the patches of its faces in parallel, the faces of each patch in the order of the source mesh.
+static std::vector<indexed_triangle_set> its_split_by_patches(const indexed_triangle_set &its, const std::vector<int> &face_patches, size_t num_patches)
+{
+    std::vector<indexed_triangle_set> out(num_patches);
+    if (out.size() == 1) {
+        out.front() = its;
+        return out;
+    }
+    // Faces of the patches sorted by the patch index.
+    std::vector<size_t> patch_start(out.size() + 1, 0);
+    for (int patch : face_patches)
+        ++ patch_start[patch + 1];
+    for (size_t i = 1; i < patch_start.size(); ++ i)
+        patch_start[i] += patch_start[i - 1];
+    std::vector<size_t> patch_faces(its.indices.size());
+    {
+        std::vector<size_t> cursor(patch_start.begin(), patch_start.end() - 1);
+        for (size_t face_idx = 0; face_idx < its.indices.size(); ++ face_idx)
+            patch_faces[cursor[face_patches[face_idx]] ++] = face_idx;
+    }
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, out.size(), 1), [&](const tbb::blocked_range<size_t> &range) {
+        std::vector<int> vertex_map(its.vertices.size(), -1);
+        for (size_t patch = range.begin(); patch < range.end(); ++ patch) {
+            indexed_triangle_set &mesh = out[patch];
+            mesh.indices.reserve(patch_start[patch + 1] - patch_start[patch]);
+            for (size_t i = patch_start[patch]; i < patch_start[patch + 1]; ++ i) {
+                const stl_triangle_vertex_indices &face = its.indices[patch_faces[i]];
+                stl_triangle_vertex_indices       &new_face = mesh.indices.emplace_back();
+                for (int j = 0; j < 3; ++ j) {
+                    int &vi = vertex_map[face(j)];
+                    if (vi == -1) {
+                        vi = int(mesh.vertices.size());
+                        mesh.vertices.emplace_back(its.vertices[face(j)]);
+                    }
+                    new_face(j) = vi;
+                }
+            }
+            // Reset the map for the next patch of this task.
+            for (size_t i = patch_start[patch]; i < patch_start[patch + 1]; ++ i)
+                for (int j = 0; j < 3; ++ j)
+                    vertex_map[its.indices[patch_faces[i]](j)] = -1;
+        }
+    });
+    return out;
+}
+
 std::vector<indexed_triangle_set> its_split(const indexed_triangle_set &its)
 {
-    return its_split<>(its);
+    std::vector<Vec3i> face_neighbors = create_face_neighbors_index(ex_tbb, its);
+    return its_split(its, face_neighbors);
+}
+
+std::vector<indexed_triangle_set> its_split(const indexed_triangle_set &its, std::vector<Vec3i> &face_neighbors)
+{
+    size_t                 num_patches;
+    const std::vector<int> face_patches = create_face_patches_index(ex_tbb, face_neighbors, num_patches);
+    return its_split_by_patches(its, face_patches, num_patches);
+}
+
+std::vector<indexed_triangle_set> its_split(const indexed_triangle_set &its, const MeshTopology &topology)
+{
+    return its_split_by_patches(its, topology.face_patches, topology.number_of_patches);
 }
 
 // Number of disconnected patches (faces are connected if they share an edge, shared edge defined with 2 shared vertex indices).
 size_t its_number_of_patches(const indexed_triangle_set &its)
 {
-    return its_number_of_patches<>(its);
+    return its_number_of_patches(its, create_face_neighbors_index(ex_tbb, its));
 }
 size_t its_number_of_patches(const indexed_triangle_set &its, const std::vector<Vec3i> &face_neighbors)
 {
-    return its_number_of_patches<>(ItsNeighborsWrapper{ its, face_neighbors });
+    size_t num_patches;
+    create_face_patches_index(ex_tbb, face_neighbors, num_patches);
+    return num_patches;
 }
 
 // Same as its_number_of_patches(its) > 1, but faster.
@@ -1704,6 +1880,107 @@ std::vector<Vec3f> its_face_normals(const indexed_triangle_set &its)
     return normals;
 }
 
+MeshTopology its_topology(const indexed_triangle_set &its)
+{
+    MeshTopology out;
+    if (its.indices.empty() || its.vertices.empty())
+        return out;
+
+    // 1) Face neighbors and volume. Each face edge finds its neighbor independently by replaying the greedy matching
+    // of create_face_neighbors_index() over the few faces sharing the edge, thus the neighbors are the same as calculated serially.
+    const VertexFaceIndex vertex_faces{ its };
+    out.face_neighbors.assign(its.indices.size(), Vec3i(-1, -1, -1));
+    constexpr size_t block_size = 1 << 14;
+    const size_t     num_blocks = (its.indices.size() + block_size - 1) / block_size;
+    // Volumes of the blocks in double precision, summed in the order of the blocks, thus deterministic.
+    std::vector<double> block_volumes(num_blocks, 0.);
+    const Vec3d p0 = its.vertices.front().cast<double>();
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_blocks, 1), [&](const tbb::blocked_range<size_t> &range) {
+        struct EdgeFace {
+            size_t face_idx;
+            // Orientation of the edge in the face.
+            bool   reversed;
+            int    matched;
+        };
+        // Faces sharing an edge in any orientation, sorted by their index.
+        using EdgeFaces = std::vector<EdgeFace>;
+        // Collect a face incident to vertex, which is the first vertex of the edge to vertex_next and the second vertex of the edge from vertex_prev.
+        auto collect = [&its](size_t other, int vertex, int vertex_next, int vertex_prev, EdgeFaces *edge_faces_next, EdgeFaces *edge_faces_prev) {
+            const stl_triangle_vertex_indices &face = its.indices[other];
+            const int idx  = face(0) == vertex ? 0 : face(1) == vertex ? 1 : 2;
+            const int next = face(idx == 2 ? 0 : idx + 1);
+            const int prev = face(idx == 0 ? 2 : idx - 1);
+            if (next == vertex_next)
+                edge_faces_next->push_back({ other, false, -1 });
+            else if (prev == vertex_next)
+                edge_faces_next->push_back({ other, true, -1 });
+            if (edge_faces_prev != nullptr) {
+                if (prev == vertex_prev)
+                    edge_faces_prev->push_back({ other, false, -1 });
+                else if (next == vertex_prev)
+                    edge_faces_prev->push_back({ other, true, -1 });
+            }
+        };
+        auto match = [](size_t face_idx, EdgeFaces &edge_faces) -> int {
+            if (edge_faces.size() == 2)
+                // Manifold edge, if the faces are oriented consistently.
+                return edge_faces.front().reversed == edge_faces.back().reversed ? -1 :
+                    int(edge_faces.front().face_idx == face_idx ? edge_faces.back().face_idx : edge_faces.front().face_idx);
+            // Each face not matched yet is matched with the next face of the opposite orientation, overriding its former match.
+            int self = -1;
+            for (int i = 0; i < int(edge_faces.size()); ++ i) {
+                if (edge_faces[i].face_idx == face_idx)
+                    self = i;
+                if (edge_faces[i].matched == -1)
+                    for (int j = i + 1; j < int(edge_faces.size()); ++ j)
+                        if (edge_faces[j].reversed != edge_faces[i].reversed) {
+                            edge_faces[i].matched = j;
+                            edge_faces[j].matched = i;
+                            break;
+                        }
+            }
+            assert(self != -1);
+            return edge_faces[self].matched == -1 ? -1 : int(edge_faces[edge_faces[self].matched].face_idx);
+        };
+        std::array<EdgeFaces, 3> edge_faces;
+        for (size_t block = range.begin(); block < range.end(); ++ block) {
+            double volume = 0.;
+            for (size_t face_idx = block * block_size; face_idx < std::min(its.indices.size(), (block + 1) * block_size); ++ face_idx) {
+                const stl_triangle_vertex_indices &face = its.indices[face_idx];
+                for (EdgeFaces &ef : edge_faces)
+                    ef.clear();
+                // The faces of the first and the last edge are collected from the faces of the first vertex, the faces of the second edge
+                // from the faces of the second vertex. A degenerate face is referenced multiple times by the same vertex.
+                size_t last = size_t(-1);
+                for (size_t other : vertex_faces[face(0)])
+                    if (other != last) {
+                        collect(other, face(0), face(1), face(2), &edge_faces[0], &edge_faces[2]);
+                        last = other;
+                    }
+                last = size_t(-1);
+                for (size_t other : vertex_faces[face(1)])
+                    if (other != last) {
+                        collect(other, face(1), face(2), -1, &edge_faces[1], nullptr);
+                        last = other;
+                    }
+                for (int edge_idx = 0; edge_idx < 3; ++ edge_idx)
+                    if (face(edge_idx) != face(edge_idx == 2 ? 0 : edge_idx + 1))
+                        // Degenerate edges stay open.
+                        out.face_neighbors[face_idx](edge_idx) = match(face_idx, edge_faces[edge_idx]);
+                const Vec3d v0 = its.vertices[face(0)].cast<double>();
+                volume += (its.vertices[face(1)].cast<double>() - v0).cross(its.vertices[face(2)].cast<double>() - v0).dot(v0 - p0) / 6.;
+            }
+            block_volumes[block] = volume;
+        }
+    });
+    out.volume     = float(std::accumulate(block_volumes.begin(), block_volumes.end(), 0.));
+    out.open_edges = its_num_open_edges(out.face_neighbors);
+
+    // 2) Connected patches, numbered the same way as its_split() splits the mesh.
+    out.face_patches = create_face_patches_index(ex_tbb, out.face_neighbors, out.number_of_patches);
+    return out;
+}
+
 #if BOOST_ENDIAN_LITTLE_BYTE
 static inline void big_endian_reverse_quads(char*, size_t) {}
 #else // BOOST_ENDIAN_LITTLE_BYTE
@@ -249,13 +249,31 @@ std::vector<Vec3i> its_face_edge_ids(const indexed_triangle_set &its, std::vecto
 std::vector<Vec3i> its_face_neighbors(const indexed_triangle_set &its);
 std::vector<Vec3i> its_face_neighbors_par(const indexed_triangle_set &its);
 
+// Topology of an indexed triangle set calculated in a single parallel pass by its_topology().
+struct MeshTopology {
+    // Neighbor face of each face edge or -1, see its_face_neighbors().
+    std::vector<Vec3i>  face_neighbors;
+    // Index of the connected patch of each face, the patches are numbered by their first face.
+    std::vector<int>    face_patches;
+    size_t              number_of_patches   = 0;
+    size_t              open_edges          = 0;
+    float               volume              = 0.f;
+};
+
+// Calculate the face neighbors, the number of open edges, the connected patches and the volume of a mesh using multiple threads.
+// The face neighbors match its_face_neighbors() for manifold edges. The faces sharing a non-manifold edge are paired
+// in the order of their indices, the first face of one orientation with the first face of the other orientation and so on.
+MeshTopology its_topology(const indexed_triangle_set &its);
+
 // After applying a transformation with negative determinant, flip the faces to keep the transformed mesh volume positive.
 void its_flip_triangles(indexed_triangle_set &its);
 
 // Merge duplicate vertices, return number of vertices removed.
 // This function will happily create non-manifolds if more than two faces share the same vertex position
 // or more than two faces share the same edge position!
-int its_merge_vertices(indexed_triangle_set &its, bool shrink_to_fit = true);
+// With a positive epsilon, the vertices falling into the same cell of a grid of epsilon size are merged
+// into the one with the lowest index, otherwise only the vertices of exactly the same coordinates are merged.
+int its_merge_vertices(indexed_triangle_set &its, bool shrink_to_fit = true, float epsilon = 0.f);
 
 // Calculate number of degenerate faces. There should be no degenerate faces in a nice mesh.
 int its_num_degenerate_faces(const indexed_triangle_set &its);
@@ -269,8 +287,11 @@ int its_compactify_vertices(indexed_triangle_set &its, bool shrink_to_fit = true
 bool its_store_triangle_to_obj(const indexed_triangle_set &its, const char *obj_filename, size_t triangle_index);
 bool its_store_triangles_to_obj(const indexed_triangle_set &its, const char *obj_filename, const std::vector<size_t>& triangles);
 
+// Split the mesh into its patches, which are found by a parallel union-find over the face neighbors.
 std::vector<indexed_triangle_set> its_split(const indexed_triangle_set &its);
 std::vector<indexed_triangle_set> its_split(const indexed_triangle_set &its, std::vector<Vec3i> &face_neighbors);
+// Split the mesh into its patches in parallel, the faces of each patch in the order of the source mesh.
+std::vector<indexed_triangle_set> its_split(const indexed_triangle_set &its, const MeshTopology &topology);
 
 // Number of disconnected patches (faces are connected if they share an edge, shared edge defined with 2 shared vertex indices).
 size_t its_number_of_patches(const indexed_triangle_set &its);
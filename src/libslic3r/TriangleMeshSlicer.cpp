@@ -419,6 +419,9 @@ private:
     std::array<CacheLineAlignedMutex, 64> m_mutexes;
 };
 
+// Intersection line together with the index of the slicing plane it belongs to.
+using SliceIntersectionLine = std::pair<size_t, IntersectionLine>;
+
 template<typename TransformVertex>
 void slice_facet_at_zs(
     // Scaled or unscaled vertices. transform_vertex_fn may scale zs.
@@ -429,14 +432,17 @@ void slice_facet_at_zs(
     const ColorPolygon::Color                         facet_color,
     // Scaled or unscaled zs. If vertices have their zs scaled or transform_vertex_fn scales them, then zs have to be scaled as well.
     const std::vector<float>                         &zs,
-    std::vector<IntersectionLines>                   &lines,
-    LinesMutexes                                     &lines_mutex)
+    // Thread local output, to be distributed into the slices by the caller.
+    std::vector<SliceIntersectionLine>               &lines)
 {
     stl_vertex vertices[3] { transform_vertex_fn(mesh_vertices[indices(0)]), transform_vertex_fn(mesh_vertices[indices(1)]), transform_vertex_fn(mesh_vertices[indices(2)]) };
 
     // find facet extents
     const float min_z = fminf(vertices[0].z(), fminf(vertices[1].z(), vertices[2].z()));
     const float max_z = fmaxf(vertices[0].z(), fmaxf(vertices[1].z(), vertices[2].z()));
+    // Ignore horizontal triangles. Any valid horizontal triangle must have a vertical triangle connected, otherwise the part has zero volume.
+    if (min_z == max_z)
+        return;
     
     // find layer extents
     auto min_layer = std::lower_bound(zs.begin(), zs.end(), min_z); // first layer whose slice_z is >= min_z
@@ -445,12 +451,9 @@ void slice_facet_at_zs(
     
     for (auto it = min_layer; it != max_layer; ++ it) {
         IntersectionLine il;
-        // Ignore horizontal triangles. Any valid horizontal triangle must have a vertical triangle connected, otherwise the part has zero volume.
-        if (min_z != max_z && slice_facet(*it, vertices, indices, edge_ids, idx_vertex_lowest, false, facet_color, il) == FacetSliceType::Slicing) {
+        if (slice_facet(*it, vertices, indices, edge_ids, idx_vertex_lowest, false, facet_color, il) == FacetSliceType::Slicing) {
             assert(il.edge_type != IntersectionLine::FacetEdgeType::Horizontal);
-            size_t slice_id = it - zs.begin();
-            boost::lock_guard<std::mutex> l(lines_mutex(slice_id));
-            lines[slice_id].emplace_back(il);
+            lines.emplace_back(size_t(it - zs.begin()), il);
         }
     }
 }
@@ -468,12 +471,25 @@ static inline std::vector<IntersectionLines> slice_make_lines(
     std::vector<IntersectionLines> lines(zs.size(), IntersectionLines{});
     LinesMutexes                   lines_mutex;
     tbb::parallel_for(
-        tbb::blocked_range<int>(0, int(indices.size())),
+        tbb::blocked_range<int>(0, int(indices.size()), 4096),
         [&vertices, &transform_vertex_fn, &indices, &face_edge_ids, &facet_color_fn, &zs, &lines, &lines_mutex, throw_on_cancel_fn](const tbb::blocked_range<int> &range) {
+            // Collect the intersection lines of the whole range first, then lock each slice just once
+            // instead of locking a slice for each intersection line.
+            std::vector<SliceIntersectionLine> lines_local;
             for (int face_idx = range.begin(); face_idx < range.end(); ++ face_idx) {
                 if ((face_idx & 0x0ffff) == 0)
                     throw_on_cancel_fn();
-                slice_facet_at_zs(vertices, transform_vertex_fn, indices[face_idx], face_edge_ids[face_idx], facet_color_fn(face_idx), zs, lines, lines_mutex);
+                slice_facet_at_zs(vertices, transform_vertex_fn, indices[face_idx], face_edge_ids[face_idx], facet_color_fn(face_idx), zs, lines_local);
+            }
+            // Stable sort keeps the lines of a single slice ordered by face index.
+            std::stable_sort(lines_local.begin(), lines_local.end(), [](const SliceIntersectionLine &l, const SliceIntersectionLine &r) { return l.first < r.first; });
+            for (auto it = lines_local.begin(); it != lines_local.end();) {
+                const size_t slice_id = it->first;
+                auto it_end = std::find_if(it, lines_local.end(), [slice_id](const SliceIntersectionLine &l) { return l.first != slice_id; });
+                boost::lock_guard<std::mutex> l(lines_mutex(slice_id));
+                IntersectionLines &dst = lines[slice_id];
+                for (; it != it_end; ++ it)
+                    dst.emplace_back(it->second);
             }
         }
     );
@@ -2206,6 +2222,28 @@ std::vector<ExPolygons> slice_mesh_ex(
     return layers;
 }
 
+std::vector<std::vector<ExPolygons>> slice_meshes_ex(
+    const std::vector<MeshSlicingJob> &jobs,
+    std::function<void()>              throw_on_cancel)
+{
+    std::vector<std::vector<ExPolygons>> out(jobs.size());
+    // Each job slices its layers in parallel as well, the jobs are run concurrently to hide the synchronization
+    // at the end of each parallel stage of slice_mesh_ex().
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, jobs.size(), 1),
+        [&jobs, &out, throw_on_cancel](const tbb::blocked_range<size_t> &range) {
+            for (size_t i = range.begin(); i < range.end(); ++ i) {
+                const MeshSlicingJob &job = jobs[i];
+                assert(job.mesh != nullptr && job.zs != nullptr);
+                if (! job.mesh->empty() && ! job.zs->empty())
+                    out[i] = slice_mesh_ex(*job.mesh, *job.zs, job.params, throw_on_cancel);
+                else
+                    out[i].assign(job.zs->size(), ExPolygons{});
+            }
+        });
+    return out;
+}
+
 // Slice a triangle set with a set of Z slabs (thick layers).
 // The effect is similar to producing the usual top / bottom layers from a sliced mesh by 
 // subtracting layer[i] from layer[i - 1] for the top surfaces resp.
@@ -2376,7 +2414,7 @@ static void triangulate_slice(
 
     if (triangulate) {
         size_t idx_vertex_new_first = its.vertices.size();
-        Pointf3s triangles = triangulate_expolygons_3d(make_expolygons_simple(lines), z, normals_down);
+        Pointf3s triangles = triangulate_expolygons_3d(make_expolygons_simple(lines), z, normals_down, TesselationMethod::MonotoneSweep);
         for (size_t i = 0; i < triangles.size(); ) {
             stl_triangle_vertex_indices facet;
             for (size_t j = 0; j < 3; ++ j) {
@@ -122,6 +122,21 @@ inline std::vector<ExPolygons>  slice_mesh_ex(
     return slice_mesh_ex(mesh, zs, params, throw_on_cancel);
 }
 
+// A mesh to be sliced by slice_meshes_ex(), together with its own Z levels and slicing parameters.
+struct MeshSlicingJob
+{
+    const indexed_triangle_set *mesh { nullptr };
+    const std::vector<float>   *zs   { nullptr };
+    MeshSlicingParamsEx         params;
+};
+
+// Slice multiple meshes in a single parallel pass over the meshes and their layers, the same as slice_mesh_ex() does
+// for each of them. Slicing many small meshes one by one is dominated by the fixed overhead of each parallel
+// slice_mesh_ex() call, here the meshes are sliced concurrently.
+std::vector<std::vector<ExPolygons>> slice_meshes_ex(
+    const std::vector<MeshSlicingJob> &jobs,
+    std::function<void()>              throw_on_cancel = []{});
+
 // Slice a triangle set with a set of Z slabs (thick layers).
 // The effect is similar to producing the usual top / bottom layers from a sliced mesh by 
 // subtracting layer[i] from layer[i - 1] for the top surfaces resp.
@@ -11,6 +11,7 @@
 #include <cstring>
 
 #include "libslic3r/Geometry.hpp"
+#include "libslic3r/MeshCache.hpp"
 #include "libslic3r/Point.hpp"
 #include "libslic3r/TriangleMesh.hpp"
 #include "libslic3r/Utils.hpp"
@@ -214,14 +215,14 @@ int TriangleSelector::select_unsplit_triangle(const Vec3f &hit, int facet_idx, c
     int num_of_children = tr->number_of_split_sides() + 1;
     if (num_of_children != 1) {
         for (int i = 0; i < num_of_children; ++i) {
-            assert(i < int(tr->children.size()));
-            assert(tr->children[i] < int(m_triangles.size()));
+            assert(i <= tr->number_of_split_sides());
+            assert(tr->child(i) < int(m_triangles.size()));
             // Recursion, deep first search over the children of this triangle.
             // All children of this triangle were created by splitting a single source triangle of the original mesh.
 
-            const std::array<int, 3> &t_vert = m_triangles[tr->children[i]].verts_idxs;
+            const std::array<int, 3> &t_vert = m_triangles[tr->child(i)].verts_idxs;
             if (is_point_inside_triangle(hit, m_vertices[t_vert[0]].v, m_vertices[t_vert[1]].v, m_vertices[t_vert[2]].v))
-                return this->select_unsplit_triangle(hit, tr->children[i], this->child_neighbors(*tr, neighbors, i));
+                return this->select_unsplit_triangle(hit, tr->child(i), this->child_neighbors(*tr, neighbors, i));
         }
     }
 
@@ -258,25 +259,53 @@ void TriangleSelector::select_patch(int facet_start, std::unique_ptr<Cursor> &&c
     facets_to_check.reserve(16);
     // Keep track of facets of the original mesh we already processed.
     std::vector<bool> visited(m_orig_size_indices, false);
-    // Breadth-first search around the hit point. facets_to_check may grow significantly large.
-    // Head of the bread-first facets_to_check FIFO.
-    int facet_idx = 0;
-    while (facet_idx < int(facets_to_check.size())) {
-        int          facet        = facets_to_check[facet_idx];
-        const Vec3f &facet_normal = m_face_normals[m_triangles[facet].source_triangle];
-        if (!visited[facet] && (highlight_by_angle_deg == 0.f || vec_down.dot(facet_normal) >= highlight_angle_limit)) {
-            if (select_triangle(facet, new_state, triangle_splitting)) {
+    // Breadth-first search around the hit point, processed by wavefronts of facets of the original mesh.
+    // The cursor is tested against all facets of a wavefront in parallel, as the test only reads the original facet.
+    // Then the touched facets are selected (and split) serially in the order of the wavefront, thus the result
+    // is the same as if the facets were processed one by one.
+    std::vector<int> wavefront;
+    std::vector<int> wavefront_inside_vertices;
+    while (! facets_to_check.empty()) {
+        wavefront.clear();
+        for (int facet : facets_to_check) {
+            const Vec3f &facet_normal = m_face_normals[m_triangles[facet].source_triangle];
+            if (!visited[facet] && (highlight_by_angle_deg == 0.f || vec_down.dot(facet_normal) >= highlight_angle_limit))
+                wavefront.emplace_back(facet);
+            visited[facet] = true;
+        }
+        facets_to_check.clear();
+
+        wavefront_inside_vertices.assign(wavefront.size(), -1);
+        auto test_cursor = [this, &wavefront, &wavefront_inside_vertices](const tbb::blocked_range<size_t> &range) {
+            for (size_t i = range.begin(); i < range.end(); ++ i)
+                wavefront_inside_vertices[i] = this->cursor_vertices_inside(m_triangles[wavefront[i]]);
+        };
+        // Parallelization does not pay off for the small wavefronts of small brushes.
+        if (wavefront.size() < 256)
+            test_cursor(tbb::blocked_range<size_t>(0, wavefront.size()));
+        else
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, wavefront.size(), 64), test_cursor);
+
+        for (size_t i = 0; i < wavefront.size(); ++ i)
+            if (int facet = wavefront[i]; wavefront_inside_vertices[i] >= 0 && select_triangle(facet, new_state, triangle_splitting, wavefront_inside_vertices[i])) {
                 // add neighboring facets to list to be processed later
                 for (int neighbor_idx : m_neighbors[facet])
                     if (neighbor_idx >= 0 && m_cursor->is_facet_visible(neighbor_idx, m_face_normals))
                         facets_to_check.push_back(neighbor_idx);
             }
-        }
-        visited[facet] = true;
-        ++facet_idx;
     }
 }
 
+int TriangleSelector::cursor_vertices_inside(const Triangle &tr) const
+{
+    int num_of_inside_vertices = m_cursor->vertices_inside(tr, m_vertices);
+    if (num_of_inside_vertices == 0
+     && ! m_cursor->is_pointer_in_triangle(tr, m_vertices)
+     && ! m_cursor->is_any_edge_inside_cursor(tr, m_vertices))
+        return -1;
+    return num_of_inside_vertices;
+}
+
 bool TriangleSelector::is_facet_clipped(int facet_idx, const ClippingPlane &clp) const
 {
     for (int vert_idx : m_triangles[facet_idx].verts_idxs)
@@ -332,9 +361,9 @@ void TriangleSelector::seed_fill_select_triangles(const Vec3f &hit, int facet_st
         if (!visited[current_facet] && (highlight_by_angle_deg == 0.f || vec_down.dot(facet_normal) >= highlight_angle_limit)) {
             if (m_triangles[current_facet].is_split()) {
                 for (int split_triangle_idx = 0; split_triangle_idx <= m_triangles[current_facet].number_of_split_sides(); ++split_triangle_idx) {
-                    assert(split_triangle_idx < int(m_triangles[current_facet].children.size()));
-                    assert(m_triangles[current_facet].children[split_triangle_idx] < int(m_triangles.size()));
-                    if (int child = m_triangles[current_facet].children[split_triangle_idx]; !visited[child]) {
+                    assert(split_triangle_idx <= m_triangles[current_facet].number_of_split_sides());
+                    assert(m_triangles[current_facet].child(split_triangle_idx) < int(m_triangles.size()));
+                    if (int child = m_triangles[current_facet].child(split_triangle_idx); !visited[child]) {
                         // Child triangle shares normal with its parent. Select it.
                         facet_queue.push(child);
                     }
@@ -420,9 +449,9 @@ void TriangleSelector::seed_fill_fill_gaps(const std::vector<int> &gap_fill_cand
 
             if (current_facet.is_split()) {
                 for (int split_triangle_idx = 0; split_triangle_idx <= current_facet.number_of_split_sides(); ++split_triangle_idx) {
-                    assert(split_triangle_idx < int(current_facet.children.size()));
-                    assert(current_facet.children[split_triangle_idx] < int(m_triangles.size()));
-                    if (int child = current_facet.children[split_triangle_idx]; !visited[child])
+                    assert(split_triangle_idx <= current_facet.number_of_split_sides());
+                    assert(current_facet.child(split_triangle_idx) < int(m_triangles.size()));
+                    if (int child = current_facet.child(split_triangle_idx); !visited[child])
                         facet_queue.push(child);
                 }
             } else if (total_gap_area < seed_fill_gap_area) {
@@ -464,12 +493,12 @@ void TriangleSelector::precompute_all_neighbors_recursive(const int facet_idx, c
         int num_of_children = tr->number_of_split_sides() + 1;
         if (num_of_children != 1) {
             for (int i = 0; i < num_of_children; ++i) {
-                assert(i < int(tr->children.size()));
-                assert(tr->children[i] < int(m_triangles.size()));
+                assert(i <= tr->number_of_split_sides());
+                assert(tr->child(i) < int(m_triangles.size()));
                 // Recursion, deep first search over the children of this triangle.
                 // All children of this triangle were created by splitting a single source triangle of the original mesh.
                 const Vec3i child_neighbors = this->child_neighbors(*tr, neighbors, i);
-                this->precompute_all_neighbors_recursive(tr->children[i], child_neighbors,
+                this->precompute_all_neighbors_recursive(tr->child(i), child_neighbors,
                                                          this->child_neighbors_propagated(*tr, neighbors_propagated, i, child_neighbors), neighbors_out,
                                                          neighbors_propagated_out);
             }
@@ -713,7 +742,7 @@ void TriangleSelector::bucket_fill_fill_gaps(const std::vector<int> &gap_fill_ca
 // This is done by an actual recursive call. Returns false if the triangle is
 // outside the cursor.
 // Called by select_patch() and by itself.
-bool TriangleSelector::select_triangle(int facet_idx, TriangleStateType type, bool triangle_splitting) {
+bool TriangleSelector::select_triangle(int facet_idx, TriangleStateType type, bool triangle_splitting, int num_of_inside_vertices) {
     assert(facet_idx < int(m_triangles.size()));
 
     if (! m_triangles[facet_idx].valid())
@@ -722,7 +751,10 @@ bool TriangleSelector::select_triangle(int facet_idx, TriangleStateType type, bo
     Vec3i neighbors = m_neighbors[facet_idx];
     assert(this->verify_triangle_neighbors(m_triangles[facet_idx], neighbors));
 
-    if (! select_triangle_recursive(facet_idx, neighbors, type, triangle_splitting))
+    if (num_of_inside_vertices >= 0) {
+        assert(num_of_inside_vertices == this->cursor_vertices_inside(m_triangles[facet_idx]));
+        select_touched_triangle_recursive(facet_idx, neighbors, type, triangle_splitting, num_of_inside_vertices);
+    } else if (! select_triangle_recursive(facet_idx, neighbors, type, triangle_splitting))
         return false;
 
     // In case that all children are leafs and have the same state now,
@@ -759,12 +791,12 @@ int TriangleSelector::neighbor_child(const Triangle &tr, int vertexi, int vertex
     if (tr.number_of_split_sides() == 1) {
         if (edge != next_idx_modulo(tr.special_side(), 3))
             // A child may or may not be split at this side.
-            return this->neighbor_child(m_triangles[tr.children[edge == tr.special_side() ? 0 : 1]], vertexi, vertexj, partition);
+            return this->neighbor_child(m_triangles[tr.child(edge == tr.special_side() ? 0 : 1)], vertexi, vertexj, partition);
         child_idx = partition == Partition::First ? 0 : 1;
     } else if (tr.number_of_split_sides() == 2) {
         if (edge == next_idx_modulo(tr.special_side(), 3))
             // A child may or may not be split at this side.
-            return this->neighbor_child(m_triangles[tr.children[2]], vertexi, vertexj, partition);
+            return this->neighbor_child(m_triangles[tr.child(2)], vertexi, vertexj, partition);
         child_idx = edge == tr.special_side() ?
             (partition == Partition::First ? 0 : 1) :
             (partition == Partition::First ? 2 : 0);
@@ -778,7 +810,7 @@ int TriangleSelector::neighbor_child(const Triangle &tr, int vertexi, int vertex
                  child_idx = partition == Partition::First ? 2 : 0; break;
         }
     }
-    return tr.children[child_idx];
+    return tr.child(child_idx);
 }
 
 // Return child of itriangle at a CCW oriented side (vertexi, vertexj), either first or 2nd part.
@@ -805,18 +837,18 @@ std::pair<int, int> TriangleSelector::triangle_subtriangles(const Triangle &tr,
     assert(tr.verts_idxs[next_idx_modulo(edge, 3)] == vertexj);
 
     if (tr.number_of_split_sides() == 1) {
-        return edge == next_idx_modulo(tr.special_side(), 3) ? std::make_pair(tr.children[0], tr.children[1]) :
-                                                                     std::make_pair(tr.children[edge == tr.special_side() ? 0 : 1], -1);
+        return edge == next_idx_modulo(tr.special_side(), 3) ? std::make_pair(tr.child(0), tr.child(1)) :
+                                                                     std::make_pair(tr.child(edge == tr.special_side() ? 0 : 1), -1);
     } else if (tr.number_of_split_sides() == 2) {
-        return edge == next_idx_modulo(tr.special_side(), 3) ? std::make_pair(tr.children[2], -1) :
-               edge == tr.special_side()                           ? std::make_pair(tr.children[0], tr.children[1]) :
-                                                                     std::make_pair(tr.children[2], tr.children[0]);
+        return edge == next_idx_modulo(tr.special_side(), 3) ? std::make_pair(tr.child(2), -1) :
+               edge == tr.special_side()                           ? std::make_pair(tr.child(0), tr.child(1)) :
+                                                                     std::make_pair(tr.child(2), tr.child(0));
     } else {
         assert(tr.number_of_split_sides() == 3);
         assert(tr.special_side() == 0);
-        return edge == 0 ? std::make_pair(tr.children[0], tr.children[1]) :
-               edge == 1 ? std::make_pair(tr.children[1], tr.children[2]) :
-                           std::make_pair(tr.children[2], tr.children[0]);
+        return edge == 0 ? std::make_pair(tr.child(0), tr.child(1)) :
+               edge == 1 ? std::make_pair(tr.child(1), tr.child(2)) :
+                           std::make_pair(tr.child(2), tr.child(0));
     }
 
     return std::make_pair(-1, -1);
@@ -837,21 +869,21 @@ int TriangleSelector::triangle_midpoint(const Triangle &tr, int vertexi, int ver
 
     if (tr.number_of_split_sides() == 1) {
         return edge == next_idx_modulo(tr.special_side(), 3) ?
-            m_triangles[tr.children[0]].verts_idxs[2] :
-            this->triangle_midpoint(m_triangles[tr.children[edge == tr.special_side() ? 0 : 1]], vertexi, vertexj);
+            m_triangles[tr.child(0)].verts_idxs[2] :
+            this->triangle_midpoint(m_triangles[tr.child(edge == tr.special_side() ? 0 : 1)], vertexi, vertexj);
     } else if (tr.number_of_split_sides() == 2) {
         return edge == next_idx_modulo(tr.special_side(), 3) ?
-                    this->triangle_midpoint(m_triangles[tr.children[2]], vertexi, vertexj) :
+                    this->triangle_midpoint(m_triangles[tr.child(2)], vertexi, vertexj) :
                edge == tr.special_side() ?
-                    m_triangles[tr.children[0]].verts_idxs[1] :
-                    m_triangles[tr.children[1]].verts_idxs[2];
+                    m_triangles[tr.child(0)].verts_idxs[1] :
+                    m_triangles[tr.child(1)].verts_idxs[2];
     } else {
         assert(tr.number_of_split_sides() == 3);
         assert(tr.special_side() == 0);
         return
-            (edge == 0) ? m_triangles[tr.children[0]].verts_idxs[1] :
-            (edge == 1) ? m_triangles[tr.children[1]].verts_idxs[2] :
-                          m_triangles[tr.children[2]].verts_idxs[2];
+            (edge == 0) ? m_triangles[tr.child(0)].verts_idxs[1] :
+            (edge == 1) ? m_triangles[tr.child(1)].verts_idxs[2] :
+                          m_triangles[tr.child(2)].verts_idxs[2];
     }
 }
 
@@ -919,13 +951,13 @@ Vec3i TriangleSelector::child_neighbors(const Triangle &tr, const Vec3i &neighbo
         case 0:
             out(0) = neighbors(i);
             out(1) = this->neighbor_child(neighbors(j), tr.verts_idxs[k], tr.verts_idxs[j], Partition::Second);
-            out(2) = tr.children[1];
+            out(2) = tr.child(1);
             break;
         default:
             assert(child_idx == 1);
             out(0) = this->neighbor_child(neighbors(j), tr.verts_idxs[k], tr.verts_idxs[j], Partition::First);
             out(1) = neighbors(k);
-            out(2) = tr.children[0];
+            out(2) = tr.child(0);
             break;
         }
         break;
@@ -934,20 +966,20 @@ Vec3i TriangleSelector::child_neighbors(const Triangle &tr, const Vec3i &neighbo
         switch (child_idx) {
         case 0:
             out(0) = this->neighbor_child(neighbors(i), tr.verts_idxs[j], tr.verts_idxs[i], Partition::Second);
-            out(1) = tr.children[1];
+            out(1) = tr.child(1);
             out(2) = this->neighbor_child(neighbors(k), tr.verts_idxs[i], tr.verts_idxs[k], Partition::First);
             break;
         case 1:
             assert(child_idx == 1);
             out(0) = this->neighbor_child(neighbors(i), tr.verts_idxs[j], tr.verts_idxs[i], Partition::First);
-            out(1) = tr.children[2];
-            out(2) = tr.children[0];
+            out(1) = tr.child(2);
+            out(2) = tr.child(0);
             break;
         default:
             assert(child_idx == 2);
             out(0) = neighbors(j);
             out(1) = this->neighbor_child(neighbors(k), tr.verts_idxs[i], tr.verts_idxs[k], Partition::Second);
-            out(2) = tr.children[1];
+            out(2) = tr.child(1);
             break;
         }
         break;
@@ -957,24 +989,24 @@ Vec3i TriangleSelector::child_neighbors(const Triangle &tr, const Vec3i &neighbo
         switch (child_idx) {
         case 0:
             out(0) = this->neighbor_child(neighbors(0), tr.verts_idxs[1], tr.verts_idxs[0], Partition::Second);
-            out(1) = tr.children[3];
+            out(1) = tr.child(3);
             out(2) = this->neighbor_child(neighbors(2), tr.verts_idxs[0], tr.verts_idxs[2], Partition::First);
             break;
         case 1:
             out(0) = this->neighbor_child(neighbors(0), tr.verts_idxs[1], tr.verts_idxs[0], Partition::First);
             out(1) = this->neighbor_child(neighbors(1), tr.verts_idxs[2], tr.verts_idxs[1], Partition::Second);
-            out(2) = tr.children[3];
+            out(2) = tr.child(3);
             break;
         case 2:
             out(0) = this->neighbor_child(neighbors(1), tr.verts_idxs[2], tr.verts_idxs[1], Partition::First);
             out(1) = this->neighbor_child(neighbors(2), tr.verts_idxs[0], tr.verts_idxs[2], Partition::Second);
-            out(2) = tr.children[3];
+            out(2) = tr.child(3);
             break;
         default:
             assert(child_idx == 3);
-            out(0) = tr.children[1];
-            out(1) = tr.children[2];
-            out(2) = tr.children[0];
+            out(0) = tr.child(1);
+            out(1) = tr.child(2);
+            out(2) = tr.child(0);
             break;
         }
         break;
@@ -984,7 +1016,7 @@ Vec3i TriangleSelector::child_neighbors(const Triangle &tr, const Vec3i &neighbo
     }
 
     assert(this->verify_triangle_neighbors(tr, neighbors));
-    assert(this->verify_triangle_neighbors(m_triangles[tr.children[child_idx]], out));
+    assert(this->verify_triangle_neighbors(m_triangles[tr.child(child_idx)], out));
     return out;
 }
 
@@ -1071,13 +1103,18 @@ bool TriangleSelector::select_triangle_recursive(int facet_idx, const Vec3i &nei
 
     assert(this->verify_triangle_neighbors(*tr, neighbors));
 
-    int num_of_inside_vertices = m_cursor->vertices_inside(*tr, m_vertices);
-
-    if (num_of_inside_vertices == 0
-     && ! m_cursor->is_pointer_in_triangle(*tr, m_vertices)
-     && ! m_cursor->is_any_edge_inside_cursor(*tr, m_vertices))
+    int num_of_inside_vertices = this->cursor_vertices_inside(*tr);
+    if (num_of_inside_vertices < 0)
         return false;
 
+    select_touched_triangle_recursive(facet_idx, neighbors, type, triangle_splitting, num_of_inside_vertices);
+    return true;
+}
+
+void TriangleSelector::select_touched_triangle_recursive(int facet_idx, const Vec3i &neighbors, TriangleStateType type, bool triangle_splitting, int num_of_inside_vertices) {
+    Triangle* tr = &m_triangles[facet_idx];
+    assert(tr->valid());
+
     if (num_of_inside_vertices == 3) {
         // dump any subdivision and select whole triangle
         undivide_triangle(facet_idx);
@@ -1089,7 +1126,7 @@ bool TriangleSelector::select_triangle_recursive(int facet_idx, const Vec3i &nei
         if (! tr->is_split() && tr->get_state() == type) {
             // This is leaf triangle that is already of correct type as a whole.
             // No need to split, all children would end up selected anyway.
-            return true;
+            return;
         }
 
         if (triangle_splitting)
@@ -1101,17 +1138,15 @@ bool TriangleSelector::select_triangle_recursive(int facet_idx, const Vec3i &nei
         int num_of_children = tr->number_of_split_sides() + 1;
         if (num_of_children != 1) {
             for (int i=0; i<num_of_children; ++i) {
-                assert(i < int(tr->children.size()));
-                assert(tr->children[i] < int(m_triangles.size()));
+                assert(i <= tr->number_of_split_sides());
+                assert(tr->child(i) < int(m_triangles.size()));
                 // Recursion, deep first search over the children of this triangle.
                 // All children of this triangle were created by splitting a single source triangle of the original mesh.
-                select_triangle_recursive(tr->children[i], this->child_neighbors(*tr, neighbors, i), type, triangle_splitting);
+                select_triangle_recursive(tr->child(i), this->child_neighbors(*tr, neighbors, i), type, triangle_splitting);
                 tr = &m_triangles[facet_idx]; // might have been invalidated
             }
         }
     }
-
-    return true;
 }
 
 void TriangleSelector::set_facet(int facet_idx, TriangleStateType state) {
@@ -1263,8 +1298,9 @@ void TriangleSelector::undivide_triangle(int facet_idx)
     Triangle& tr = m_triangles[facet_idx];
 
     if (tr.is_split()) {
-        for (int i = 0; i <= tr.number_of_split_sides(); ++i) {
-            int       child    = tr.children[i];
+        const int num_children = tr.number_of_split_sides() + 1;
+        for (int i = 0; i < num_children; ++i) {
+            int       child    = tr.child(i);
             Triangle &child_tr = m_triangles[child];
             assert(child_tr.valid());
             undivide_triangle(child);
@@ -1281,16 +1317,16 @@ void TriangleSelector::undivide_triangle(int facet_idx)
                     assert(m_free_vertices_head >= -1 && m_free_vertices_head < int(m_vertices.size()));
                 }
             }
-            // Chain released triangles into a linked list through children[0].
             assert(child_tr.valid());
             child_tr.m_valid = false;
-            assert(m_free_triangles_head >= -1 && m_free_triangles_head < int(m_triangles.size()));
-            assert(m_free_triangles_head == -1 || ! m_triangles[m_free_triangles_head].valid());
-            child_tr.children[0] = m_free_triangles_head;
-            m_free_triangles_head = child;
-            assert(m_free_triangles_head >= -1 && m_free_triangles_head < int(m_triangles.size()));
             ++m_invalid_triangles;
         }
+        // Chain the released block of children into a linked list of blocks of the same size through first_child of its first triangle.
+        int &free_head = m_free_children_heads[num_children - 2];
+        assert(free_head >= -1 && free_head < int(m_triangles.size()));
+        assert(free_head == -1 || ! m_triangles[free_head].valid());
+        m_triangles[tr.first_child].first_child = free_head;
+        free_head = tr.first_child;
         tr.set_division(0, 0); // not split
     }
 }
@@ -1313,18 +1349,18 @@ bool TriangleSelector::remove_useless_children(int facet_idx) {
     bool children_removed = false;
     for (int child_idx = 0; child_idx <= tr.number_of_split_sides(); ++child_idx) {
         assert(child_idx < int(m_triangles.size()) && m_triangles[child_idx].valid());
-        if (m_triangles[tr.children[child_idx]].is_split())
-            children_removed |= remove_useless_children(tr.children[child_idx]);
+        if (m_triangles[tr.child(child_idx)].is_split())
+            children_removed |= remove_useless_children(tr.child(child_idx));
     }
 
     // Return if a child is not leaf or two children differ in type.
     TriangleStateType first_child_type = TriangleStateType::NONE;
     for (int child_idx = 0; child_idx <= tr.number_of_split_sides(); ++child_idx) {
-        if (m_triangles[tr.children[child_idx]].is_split())
+        if (m_triangles[tr.child(child_idx)].is_split())
             return children_removed;
         if (child_idx == 0)
-            first_child_type = m_triangles[tr.children[0]].get_state();
-        else if (m_triangles[tr.children[child_idx]].get_state() != first_child_type)
+            first_child_type = m_triangles[tr.child(0)].get_state();
+        else if (m_triangles[tr.child(child_idx)].get_state() != first_child_type)
             return children_removed;
     }
 
@@ -1367,10 +1403,10 @@ void TriangleSelector::garbage_collect()
 
         if (tr.is_split()) {
             // There are children. Update their indices.
-            for (int j=0; j<=tr.number_of_split_sides(); ++j) {
-                assert(new_triangle_indices[tr.children[j]] != -1);
-                tr.children[j] = new_triangle_indices[tr.children[j]];
-            }
+            // The children are released together, thus they stay contiguous after compaction.
+            assert(new_triangle_indices[tr.first_child] != -1);
+            assert(new_triangle_indices[tr.child(tr.number_of_split_sides())] == new_triangle_indices[tr.first_child] + tr.number_of_split_sides());
+            tr.first_child = new_triangle_indices[tr.first_child];
         }
 
         // Update indices into m_vertices. The original vertices are never
@@ -1384,12 +1420,18 @@ void TriangleSelector::garbage_collect()
     }
 
     m_invalid_triangles = 0;
-    m_free_triangles_head = -1;
+    m_free_children_heads.fill(-1);
     m_free_vertices_head = -1;
 }
 
 TriangleSelector::TriangleSelector(const TriangleMesh& mesh)
-    : m_mesh{mesh}, m_neighbors(its_face_neighbors(mesh.its)), m_face_normals(its_face_normals(mesh.its))
+    : m_mesh{mesh}, m_neighbors_ptr(std::make_shared<std::vector<Vec3i>>(its_face_neighbors(mesh.its))), m_neighbors(*m_neighbors_ptr), m_face_normals(its_face_normals(mesh.its))
+{
+    reset();
+}
+
+TriangleSelector::TriangleSelector(const std::shared_ptr<const TriangleMesh> &mesh)
+    : m_mesh{*mesh}, m_neighbors_ptr(cached_face_neighbors(mesh)), m_neighbors(*m_neighbors_ptr), m_face_normals(its_face_normals(mesh->its))
 {
     reset();
 }
@@ -1399,7 +1441,7 @@ void TriangleSelector::reset()
     m_vertices.clear();
     m_triangles.clear();
     m_invalid_triangles = 0;
-    m_free_triangles_head = -1;
+    m_free_children_heads.fill(-1);
     m_free_vertices_head = -1;
     m_vertices.reserve(m_mesh.its.vertices.size());
     for (const stl_vertex& vert : m_mesh.its.vertices)
@@ -1424,28 +1466,40 @@ int TriangleSelector::push_triangle(int a, int b, int c, int source_triangle, co
         assert(i >= 0 && i < int(m_vertices.size()));
         ++m_vertices[i].ref_cnt;
     }
-    int idx;
-    if (m_free_triangles_head == -1) {
-        // Allocate a new triangle.
-        assert(m_invalid_triangles == 0);
-        idx = int(m_triangles.size());
-        m_triangles.emplace_back(a, b, c, source_triangle, state);
-    } else {
-        // Reuse triangle from the free list.
-        assert(m_free_triangles_head >= -1 && m_free_triangles_head < int(m_triangles.size()));
-        assert(! m_triangles[m_free_triangles_head].valid());
-        assert(m_invalid_triangles > 0);
-        idx = m_free_triangles_head;
-        m_free_triangles_head = m_triangles[idx].children[0];
-        -- m_invalid_triangles;
-        assert(m_free_triangles_head >= -1 && m_free_triangles_head < int(m_triangles.size()));
-        assert(m_free_triangles_head == -1 || ! m_triangles[m_free_triangles_head].valid());
-        assert(m_invalid_triangles >= 0);
-        assert((m_invalid_triangles == 0) == (m_free_triangles_head == -1));
-        m_triangles[idx] = {a, b, c, source_triangle, state};
+    int idx = int(m_triangles.size());
+    m_triangles.emplace_back(a, b, c, source_triangle, state);
+    return idx;
+}
+
+int TriangleSelector::allocate_children(int num_children) {
+    assert(num_children >= 2 && num_children <= 4);
+    int &free_head = m_free_children_heads[num_children - 2];
+    if (free_head == -1) {
+        // Allocate new triangles, they will be initialized by set_child().
+        int idx = int(m_triangles.size());
+        for (int i = 0; i < num_children; ++ i)
+            m_triangles.emplace_back(-1, -1, -1, -1, TriangleStateType::NONE);
+        return idx;
+    }
+    // Reuse a block of triangles from the free list.
+    assert(free_head >= 0 && free_head + num_children <= int(m_triangles.size()));
+    assert(! m_triangles[free_head].valid());
+    int idx = free_head;
+    free_head = m_triangles[idx].first_child;
+    m_invalid_triangles -= num_children;
+    assert(free_head >= -1 && free_head < int(m_triangles.size()));
+    assert(free_head == -1 || ! m_triangles[free_head].valid());
+    assert(m_invalid_triangles >= 0);
+    return idx;
+}
+
+void TriangleSelector::set_child(int idx, int a, int b, int c, int source_triangle, const TriangleStateType state) {
+    for (int i : {a, b, c}) {
+        assert(i >= 0 && i < int(m_vertices.size()));
+        ++m_vertices[i].ref_cnt;
     }
+    m_triangles[idx] = {a, b, c, source_triangle, state};
     assert(m_triangles[idx].valid());
-    return idx;
 }
 
 // called by deserialize() and select_patch()->select_triangle()->...select_triangle()->split_triangle()
@@ -1478,20 +1532,21 @@ void TriangleSelector::perform_split(int facet_idx, const Vec3i &neighbors, Tria
         return this->triangle_midpoint_or_allocate(neighbors(edge), verts_idxs[i1], verts_idxs[i2]);
     };
 
-    int ichild = 0;
     switch (tr.number_of_split_sides()) {
     case 1:
         verts_idxs.insert(verts_idxs.begin()+2, get_alloc_vertex(next_idx_modulo(tr.special_side(), 3), 2, 1));
-        tr.children[ichild ++] = push_triangle(verts_idxs[0], verts_idxs[1], verts_idxs[2], tr.source_triangle, old_state);
-        tr.children[ichild   ] = push_triangle(verts_idxs[2], verts_idxs[3], verts_idxs[0], tr.source_triangle, old_state);
+        tr.first_child = allocate_children(2);
+        set_child(tr.child(0), verts_idxs[0], verts_idxs[1], verts_idxs[2], tr.source_triangle, old_state);
+        set_child(tr.child(1), verts_idxs[2], verts_idxs[3], verts_idxs[0], tr.source_triangle, old_state);
         break;
 
     case 2:
         verts_idxs.insert(verts_idxs.begin()+1, get_alloc_vertex(tr.special_side(), 1, 0));
         verts_idxs.insert(verts_idxs.begin()+4, get_alloc_vertex(prev_idx_modulo(tr.special_side(), 3), 0, 3));
-        tr.children[ichild ++] = push_triangle(verts_idxs[0], verts_idxs[1], verts_idxs[4], tr.source_triangle, old_state);
-        tr.children[ichild ++] = push_triangle(verts_idxs[1], verts_idxs[2], verts_idxs[4], tr.source_triangle, old_state);
-        tr.children[ichild   ] = push_triangle(verts_idxs[2], verts_idxs[3], verts_idxs[4], tr.source_triangle, old_state);
+        tr.first_child = allocate_children(3);
+        set_child(tr.child(0), verts_idxs[0], verts_idxs[1], verts_idxs[4], tr.source_triangle, old_state);
+        set_child(tr.child(1), verts_idxs[1], verts_idxs[2], verts_idxs[4], tr.source_triangle, old_state);
+        set_child(tr.child(2), verts_idxs[2], verts_idxs[3], verts_idxs[4], tr.source_triangle, old_state);
         break;
 
     case 3:
@@ -1499,10 +1554,11 @@ void TriangleSelector::perform_split(int facet_idx, const Vec3i &neighbors, Tria
         verts_idxs.insert(verts_idxs.begin()+1, get_alloc_vertex(0, 1, 0));
         verts_idxs.insert(verts_idxs.begin()+3, get_alloc_vertex(1, 3, 2));
         verts_idxs.insert(verts_idxs.begin()+5, get_alloc_vertex(2, 0, 4));
-        tr.children[ichild ++] = push_triangle(verts_idxs[0], verts_idxs[1], verts_idxs[5], tr.source_triangle, old_state);
-        tr.children[ichild ++] = push_triangle(verts_idxs[1], verts_idxs[2], verts_idxs[3], tr.source_triangle, old_state);
-        tr.children[ichild ++] = push_triangle(verts_idxs[3], verts_idxs[4], verts_idxs[5], tr.source_triangle, old_state);
-        tr.children[ichild   ] = push_triangle(verts_idxs[1], verts_idxs[3], verts_idxs[5], tr.source_triangle, old_state);
+        tr.first_child = allocate_children(4);
+        set_child(tr.child(0), verts_idxs[0], verts_idxs[1], verts_idxs[5], tr.source_triangle, old_state);
+        set_child(tr.child(1), verts_idxs[1], verts_idxs[2], verts_idxs[3], tr.source_triangle, old_state);
+        set_child(tr.child(2), verts_idxs[3], verts_idxs[4], verts_idxs[5], tr.source_triangle, old_state);
+        set_child(tr.child(3), verts_idxs[1], verts_idxs[3], verts_idxs[5], tr.source_triangle, old_state);
         break;
 
     default:
@@ -1513,7 +1569,7 @@ void TriangleSelector::perform_split(int facet_idx, const Vec3i &neighbors, Tria
     assert(this->verify_triangle_neighbors(tr, neighbors));
     for (int i = 0; i <= tr.number_of_split_sides(); ++i) {
         Vec3i n = this->child_neighbors(tr, neighbors, i);
-        assert(this->verify_triangle_neighbors(m_triangles[tr.children[i]], n));
+        assert(this->verify_triangle_neighbors(m_triangles[tr.child(i)], n));
     }
 #endif // NDEBUG
 }
@@ -1638,7 +1694,7 @@ void TriangleSelector::get_facets_strict_recursive(
     if (tr.is_split()) {
         for (int i = 0; i <= tr.number_of_split_sides(); ++ i)
             this->get_facets_strict_recursive<facet_info>(
-                m_triangles[tr.children[i]],
+                m_triangles[tr.child(i)],
                 this->child_neighbors(tr, neighbors, i),
                 facet_filter, out_triangles, out_colors);
     } else if (facet_filter(tr)) {
@@ -1764,12 +1820,12 @@ void TriangleSelector::get_seed_fill_contour_recursive(const int facet_idx, cons
         int num_of_children = tr->number_of_split_sides() + 1;
         if (num_of_children != 1) {
             for (int i = 0; i < num_of_children; ++i) {
-                assert(i < int(tr->children.size()));
-                assert(tr->children[i] < int(m_triangles.size()));
+                assert(i <= tr->number_of_split_sides());
+                assert(tr->child(i) < int(m_triangles.size()));
                 // Recursion, deep first search over the children of this triangle.
                 // All children of this triangle were created by splitting a single source triangle of the original mesh.
                 const Vec3i child_neighbors = this->child_neighbors(*tr, neighbors, i);
-                this->get_seed_fill_contour_recursive(tr->children[i], child_neighbors,
+                this->get_seed_fill_contour_recursive(tr->child(i), child_neighbors,
                                                       this->child_neighbors_propagated(*tr, neighbors_propagated, i, child_neighbors), edges_out);
             }
         }
@@ -1825,7 +1881,7 @@ TriangleSelector::TriangleSplittingData TriangleSelector::serialize() const {
                 // Now save all children.
                 // Serialized in reverse order for compatibility with PrusaSlicer 2.3.1.
                 for (int child_idx = split_sides; child_idx >= 0; -- child_idx)
-                    this->serialize(tr.children[child_idx]);
+                    this->serialize(tr.child(child_idx));
             } else {
                 // In case this is leaf, we better save information about its state.
                 int n = int(tr.get_state());
@@ -1939,14 +1995,14 @@ void TriangleSelector::deserialize(const TriangleSplittingData &data, bool needs
                 const Triangle &tr = m_triangles[last.facet_id];
                 int   child_idx = last.total_children - last.processed_children - 1;
                 Vec3i neighbors = this->child_neighbors(tr, last.neighbors, child_idx);
-                int this_idx = tr.children[child_idx];
+                int this_idx = tr.child(child_idx);
                 m_triangles[this_idx].set_division(num_of_split_sides, special_side);
                 perform_split(this_idx, neighbors, TriangleStateType::NONE);
                 parents.push_back({this_idx, neighbors, 0, num_of_children});
             } else {
                 // this triangle belongs to last split one
                 int child_idx = last.total_children - last.processed_children - 1;
-                m_triangles[m_triangles[last.facet_id].children[child_idx]].set_state(state);
+                m_triangles[m_triangles[last.facet_id].child(child_idx)].set_state(state);
                 ++last.processed_children;
             }
 
@@ -323,6 +323,8 @@ public:
     // Create new object on a TriangleMesh. The referenced mesh must
     // stay valid, a ptr to it is saved and used.
     explicit TriangleSelector(const TriangleMesh& mesh);
+    // The face neighbors are shared with the other users of the mesh, see MeshCache.hpp.
+    explicit TriangleSelector(const std::shared_ptr<const TriangleMesh> &mesh);
 
     // Returns the facet_idx of the unsplit triangle containing the "hit". Returns -1 if the triangle isn't found.
     [[nodiscard]] int select_unsplit_triangle(const Vec3f &hit, int facet_idx) const;
@@ -424,6 +426,7 @@ protected:
         Triangle(int a, int b, int c, int source_triangle, const TriangleStateType init_state)
             : verts_idxs{a, b, c},
               source_triangle{source_triangle},
+              first_child{-1},
               state{init_state}
         {
             // Initialize bit fields. Default member initializers are not supported by C++17.
@@ -436,8 +439,10 @@ protected:
         // Index of the source triangle at the initial (unsplit) mesh.
         int source_triangle;
 
-        // Children triangles.
-        std::array<int, 4> children;
+        // Children triangles are allocated in a contiguous block of number_of_split_sides() + 1 triangles,
+        // thus only the index of the first child is stored.
+        int first_child;
+        int child(int child_idx) const noexcept { assert(is_split() && child_idx >= 0 && child_idx <= number_of_split_sides()); return first_child + child_idx; }
 
         // Set the division type.
         void set_division(int sides_to_split, int special_side_idx);
@@ -487,7 +492,8 @@ protected:
     std::vector<Vertex> m_vertices;
     std::vector<Triangle> m_triangles;
     const TriangleMesh &m_mesh;
-    const std::vector<Vec3i> m_neighbors;
+    const std::shared_ptr<const std::vector<Vec3i>> m_neighbors_ptr;
+    const std::vector<Vec3i> &m_neighbors;
     const std::vector<Vec3f> m_face_normals;
 
     // Number of invalid triangles (to trigger garbage collection).
@@ -507,13 +513,20 @@ protected:
 
     // Private functions:
 private:
-    bool select_triangle(int facet_idx, TriangleStateType type, bool triangle_splitting);
+    // num_of_inside_vertices may be passed if the triangle is known to be touched by the cursor, otherwise it is calculated.
+    bool select_triangle(int facet_idx, TriangleStateType type, bool triangle_splitting, int num_of_inside_vertices = -1);
     bool select_triangle_recursive(int facet_idx, const Vec3i &neighbors, TriangleStateType type, bool triangle_splitting);
+    void select_touched_triangle_recursive(int facet_idx, const Vec3i &neighbors, TriangleStateType type, bool triangle_splitting, int num_of_inside_vertices);
+    // Returns number of vertices inside the cursor, or -1 if the triangle is not touched by the cursor at all.
+    int  cursor_vertices_inside(const Triangle &tr) const;
     void undivide_triangle(int facet_idx);
     void split_triangle(int facet_idx, const Vec3i &neighbors);
     bool remove_useless_children(int facet_idx); // No hidden meaning. Triangles are meant.
     bool is_facet_clipped(int facet_idx, const ClippingPlane &clp) const;
     int  push_triangle(int a, int b, int c, int source_triangle, TriangleStateType state = TriangleStateType::NONE);
+    // Allocate a contiguous block of triangles for the children of a split triangle, return index of the first one.
+    int  allocate_children(int num_children);
+    void set_child(int idx, int a, int b, int c, int source_triangle, TriangleStateType state);
     void perform_split(int facet_idx, const Vec3i &neighbors, TriangleStateType old_state);
     Vec3i child_neighbors(const Triangle &tr, const Vec3i &neighbors, int child_idx) const;
     Vec3i child_neighbors_propagated(const Triangle &tr, const Vec3i &neighbors_propagated, int child_idx, const Vec3i &child_neighbors) const;
@@ -570,7 +583,8 @@ private:
                                const std::vector<Vec3i> &neighbors,
                                const std::vector<Vec3i> &neighbors_propagate);
 
-    int m_free_triangles_head { -1 };
+    // Heads of linked lists of released blocks of 2, 3 and 4 children, chained through Triangle::first_child of the first triangle in a block.
+    std::array<int, 3> m_free_children_heads { -1, -1, -1 };
     int m_free_vertices_head { -1 };
 };
 
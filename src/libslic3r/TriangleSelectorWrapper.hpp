@@ -24,9 +24,11 @@ public:
     const TriangleMesh &mesh;
     const Transform3d& mesh_transform;
     TriangleSelector selector;
-    AABBTreeIndirect::Tree<3, float> triangles_tree;
+    std::shared_ptr<const AABBTreeIndirect::Tree<3, float>> triangles_tree;
 
     TriangleSelectorWrapper(const TriangleMesh &mesh, const Transform3d& mesh_transform);
+    // The AABB tree and the face neighbors are shared with the other users of the mesh, see MeshCache.hpp.
+    TriangleSelectorWrapper(const std::shared_ptr<const TriangleMesh> &mesh, const Transform3d& mesh_transform);
 
     void enforce_spot(const Vec3f &point, const Vec3f& origin, float radius);
 
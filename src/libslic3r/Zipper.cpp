@@ -22,6 +22,13 @@ namespace Slic3r {
 class Zipper::Impl: public MZ_Archive {
 public:
     std::string m_zipname;
+    bool        m_zip64 = false;
+
+    // State of an entry being deflated into the archive piece by piece by Zipper::stream_data().
+    // The staged context references the entry name until the entry is finished.
+    mz_zip_writer_staged_context m_staged;
+    std::string                  m_staged_name;
+    bool                         m_staged_open = false;
 
     std::string formatted_errorstr() const
     {
@@ -40,12 +47,23 @@ public:
     }
 };
 
-Zipper::Zipper(const std::string &zipfname, e_compression compression)
+static mz_uint compression_level(Zipper::e_compression compression)
+{
+    switch (compression) {
+    case Zipper::NO_COMPRESSION: return MZ_NO_COMPRESSION;
+    case Zipper::FAST_COMPRESSION: return MZ_BEST_SPEED;
+    case Zipper::TIGHT_COMPRESSION: return MZ_BEST_COMPRESSION;
+    }
+    return MZ_NO_COMPRESSION;
+}
+
+Zipper::Zipper(const std::string &zipfname, e_compression compression, bool zip64)
 {
     m_impl.reset(new Impl());
 
     m_compression = compression;
     m_impl->m_zipname = zipfname;
+    m_impl->m_zip64 = zip64;
 
     memset(&m_impl->arch, 0, sizeof(m_impl->arch));
 
@@ -98,37 +116,90 @@ void Zipper::add_entry(const std::string &name, const void *data, size_t l)
     if(!m_impl->is_alive()) return;
 
     finish_entry();
-    mz_uint cmpr = MZ_NO_COMPRESSION;
-    switch (m_compression) {
-    case NO_COMPRESSION: cmpr = MZ_NO_COMPRESSION; break;
-    case FAST_COMPRESSION: cmpr = MZ_BEST_SPEED; break;
-    case TIGHT_COMPRESSION: cmpr = MZ_BEST_COMPRESSION; break;
-    }
 
-    if(!mz_zip_writer_add_mem(&m_impl->arch, name.c_str(), data, l, cmpr))
+    if(!mz_zip_writer_add_mem(&m_impl->arch, name.c_str(), data, l, compression_level(m_compression)))
         m_impl->blow_up();
 
     m_entry.clear();
     m_data.clear();
 }
 
-void Zipper::finish_entry()
+Zipper::CompressedEntry Zipper::compress_entry(const void *data, size_t l) const
+{
+    CompressedEntry out;
+    out.uncompressed_size = l;
+    out.checksum = uint32_t(mz_crc32(MZ_CRC32_INIT, static_cast<const unsigned char*>(data), l));
+
+    // miniz stores entries of up to 3 bytes uncompressed.
+    if (m_compression != NO_COMPRESSION && l > 3) {
+        size_t compressed_size = 0;
+        void  *compressed = tdefl_compress_mem_to_heap(data, l, &compressed_size,
+            tdefl_create_comp_flags_from_zip_params(int(compression_level(m_compression)), -MZ_DEFAULT_WINDOW_BITS, MZ_DEFAULT_STRATEGY));
+        if (compressed == nullptr)
+            throw Slic3r::ExportError(_u8L("Error with ZIP archive") + " " + m_impl->m_zipname + ": " + _u8L("compression failed"));
+        out.data.assign(static_cast<const char*>(compressed), compressed_size);
+        mz_free(compressed);
+        out.deflated = true;
+    } else
+        out.data.assign(static_cast<const char*>(data), l);
+
+    return out;
+}
+
+void Zipper::add_entry(const std::string &name, const CompressedEntry &entry)
 {
     if(!m_impl->is_alive()) return;
 
-    if(!m_data.empty() && !m_entry.empty()) {
-        mz_uint compression = MZ_NO_COMPRESSION;
+    finish_entry();
 
-        switch (m_compression) {
-        case NO_COMPRESSION: compression = MZ_NO_COMPRESSION; break;
-        case FAST_COMPRESSION: compression = MZ_BEST_SPEED; break;
-        case TIGHT_COMPRESSION: compression = MZ_BEST_COMPRESSION; break;
-        }
+    bool ok = entry.deflated ?
+        mz_zip_writer_add_mem_ex(&m_impl->arch, name.c_str(), entry.data.data(), entry.data.size(), nullptr, 0,
+                                 compression_level(m_compression) | MZ_ZIP_FLAG_COMPRESSED_DATA, entry.uncompressed_size, entry.checksum) :
+        mz_zip_writer_add_mem(&m_impl->arch, name.c_str(), entry.data.data(), entry.data.size(), MZ_NO_COMPRESSION);
+    if(!ok)
+        m_impl->blow_up();
+}
+
+void Zipper::stream_data()
+{
+    // miniz does not stream entries stored without compression, these are buffered until finished.
+    if(!m_impl->is_alive() || m_entry.empty() || m_compression == NO_COMPRESSION) return;
+
+    if(!m_impl->m_staged_open) {
+        m_impl->m_staged_name = m_entry;
+        if(!mz_zip_writer_add_staged_open(&m_impl->arch, &m_impl->m_staged, m_impl->m_staged_name.c_str(),
+            m_impl->m_zip64 ?
+                // Same limits as with the 3MF export.
+                (uint64_t(1) << 30) * 16 :
+                (uint64_t(1) << 32) - 1,
+            nullptr, nullptr, 0, compression_level(m_compression), nullptr, 0, nullptr, 0))
+            m_impl->blow_up();
+        m_impl->m_staged_open = true;
+    }
+
+    if(!mz_zip_writer_add_staged_data(&m_impl->m_staged, m_data.data(), m_data.size())) {
+        // The staged entry shall not be finished after a failure.
+        m_impl->m_staged_open = false;
+        m_impl->blow_up();
+    }
+    m_data.clear();
+}
+
+void Zipper::finish_entry()
+{
+    if(!m_impl->is_alive()) return;
 
+    if(m_impl->m_staged_open) {
+        m_impl->m_staged_open = false;
+        if(!m_data.empty() && !mz_zip_writer_add_staged_data(&m_impl->m_staged, m_data.data(), m_data.size()))
+            m_impl->blow_up();
+        if(!mz_zip_writer_add_staged_finish(&m_impl->m_staged))
+            m_impl->blow_up();
+    } else if(!m_data.empty() && !m_entry.empty()) {
         if(!mz_zip_writer_add_mem(&m_impl->arch, m_entry.c_str(),
                                   m_data.c_str(),
                                   m_data.size(),
-                                  compression)) m_impl->blow_up();
+                                  compression_level(m_compression))) m_impl->blow_up();
     }
 
     m_data.clear();
@@ -33,11 +33,26 @@ private:
     std::string m_entry;
     e_compression m_compression;
 
+    // Once the data written to the current entry reaches this size, it is deflated into the archive
+    // piece by piece instead of being buffered until the entry is finished.
+    static constexpr size_t StreamChunkSize = 1024 * 1024;
+    void stream_data();
+
 public:
+    // Entry data deflated by compress_entry(), to be added to the archive by add_entry(name, CompressedEntry).
+    struct CompressedEntry {
+        std::string data;
+        uint64_t    uncompressed_size { 0 };
+        uint32_t    checksum { 0 };
+        // False if data is stored uncompressed.
+        bool        deflated { false };
+    };
 
     // Will blow up in a runtime exception if the file cannot be created.
+    // With zip64, the entries may grow over 4GB, at the expense of a tiny overhead of the file records.
     explicit Zipper(const std::string& zipfname,
-                    e_compression level = FAST_COMPRESSION);
+                    e_compression level = FAST_COMPRESSION,
+                    bool zip64 = false);
     ~Zipper();
 
     // No copies allwed, this is a file resource...
@@ -60,8 +75,19 @@ public:
     /// This method throws exactly like finish_entry() does.
     void add_entry(const std::string& name, const void* data, size_t bytes);
 
+    /// Deflate data with the compression level of this archive. The archive is not accessed,
+    /// thus the entries may be compressed on multiple threads in parallel and added in order
+    /// by add_entry(name, CompressedEntry) afterwards.
+    CompressedEntry compress_entry(const void* data, size_t bytes) const;
+
+    /// Add a new binary file entry compressed by compress_entry() before.
+    /// This method throws exactly like finish_entry() does.
+    void add_entry(const std::string& name, const CompressedEntry& entry);
+
     // Writing data to the archive works like with standard streams. The target
     // within the zip file is the entry created with the add_entry method.
+    // Large entries are compressed into the archive while being written
+    // (see StreamChunkSize), so they are never held in memory as a whole.
 
     // Template taking only arithmetic values, that std::to_string can handle.
     template<class T> inline
@@ -77,6 +103,7 @@ public:
     operator<<(T &&val) {
         if(m_data.empty()) m_data = std::forward<T>(val);
         else m_data.append(val);
+        if(m_data.size() >= StreamChunkSize) stream_data();
         return *this;
     }
 
@@ -56,6 +56,15 @@ public:
     //
     void load(GCodeInputData&& gcode_data);
     //
+    // Append the given data to the content of the viewer, as if it was loaded together with it.
+    // Allows to show the first layers of a gcode while the rest is still being processed.
+    // The vertices must continue the ones already loaded, the first appended vertex
+    // belongs either to the last loaded layer or to the next one.
+    // Empty palettes keep the current ones.
+    // The gpu buffers are recreated on each call, so append the data in chunks of whole layers.
+    //
+    void append(GCodeInputData&& gcode_data);
+    //
     // Render the toolpaths according to the current settings and
     // using the given camera matrices.
     //
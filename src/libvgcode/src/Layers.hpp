@@ -7,6 +7,8 @@
 
 #include "Range.hpp"
 
+#include <cassert>
+
 namespace libvgcode {
 
 struct PathVertex;
@@ -31,6 +33,11 @@ public:
         return (layer_id < m_items.size()) ? m_items[layer_id].z : 0.0f;
     }
     std::size_t get_layer_id_at(float z) const;
+    // Indices of the first and of the last vertex of the given layer.
+    const Interval& get_vertices_range(std::size_t layer_id) const {
+        assert(layer_id < m_items.size());
+        return m_items[layer_id].range.get();
+    }
     
     const Interval& get_view_range() const { return m_view_range.get(); }
     void set_view_range(const Interval& range) { set_view_range(range[0], range[1]); }
@@ -757,6 +757,9 @@ void ViewerImpl::init(const std::string& opengl_context_version)
     m_uni_segments_height_width_angle_tex_id = glGetUniformLocation(m_segments_shader_id, "height_width_angle_tex");
     m_uni_segments_colors_tex_id             = glGetUniformLocation(m_segments_shader_id, "color_tex");
     m_uni_segments_segment_index_tex_id      = glGetUniformLocation(m_segments_shader_id, "segment_index_tex");
+#ifndef ENABLE_OPENGL_ES
+    m_uni_segments_segment_index_offset_id   = glGetUniformLocation(m_segments_shader_id, "segment_index_offset");
+#endif // ENABLE_OPENGL_ES
     glcheck();
     assert(m_uni_segments_view_matrix_id != -1 &&
            m_uni_segments_projection_matrix_id != -1 &&
@@ -765,6 +768,9 @@ void ViewerImpl::init(const std::string& opengl_context_version)
            m_uni_segments_height_width_angle_tex_id != -1 &&
            m_uni_segments_colors_tex_id != -1 &&
            m_uni_segments_segment_index_tex_id != -1);
+#ifndef ENABLE_OPENGL_ES
+    assert(m_uni_segments_segment_index_offset_id != -1);
+#endif // ENABLE_OPENGL_ES
 
     m_segment_template.init();
 
@@ -781,6 +787,9 @@ void ViewerImpl::init(const std::string& opengl_context_version)
     m_uni_options_height_width_angle_tex_id = glGetUniformLocation(m_options_shader_id, "height_width_angle_tex");
     m_uni_options_colors_tex_id             = glGetUniformLocation(m_options_shader_id, "color_tex");
     m_uni_options_segment_index_tex_id      = glGetUniformLocation(m_options_shader_id, "segment_index_tex");
+#ifndef ENABLE_OPENGL_ES
+    m_uni_options_segment_index_offset_id   = glGetUniformLocation(m_options_shader_id, "segment_index_offset");
+#endif // ENABLE_OPENGL_ES
     glcheck();
     assert(m_uni_options_view_matrix_id != -1 &&
            m_uni_options_projection_matrix_id != -1 &&
@@ -788,6 +797,9 @@ void ViewerImpl::init(const std::string& opengl_context_version)
            m_uni_options_height_width_angle_tex_id != -1 &&
            m_uni_options_colors_tex_id != -1 &&
            m_uni_options_segment_index_tex_id != -1);
+#ifndef ENABLE_OPENGL_ES
+    assert(m_uni_options_segment_index_offset_id != -1);
+#endif // ENABLE_OPENGL_ES
 
     m_option_template.init(16);
 
@@ -873,11 +885,21 @@ void ViewerImpl::reset()
 #if VGCODE_ENABLE_COG_AND_TOOL_MARKERS
     m_cog_marker.reset();
 #endif // VGCODE_ENABLE_COG_AND_TOOL_MARKERS
+    reset_gpu_data();
+}
+
+void ViewerImpl::reset_gpu_data()
+{
+    m_settings_used_for_visible_entities = std::nullopt;
+    m_visible_segments.clear();
+    m_visible_options.clear();
 
 #ifdef ENABLE_OPENGL_ES
     m_texture_data.reset();
 #else
+    m_enabled_segments_offset = 0;
     m_enabled_segments_count = 0;
+    m_enabled_options_offset = 0;
     m_enabled_options_count = 0;
 
     m_settings_used_for_ranges = std::nullopt;
@@ -980,11 +1002,75 @@ void ViewerImpl::load(GCodeInputData&& gcode_data)
     m_vertices = std::move(gcode_data.vertices);
     m_tool_colors = std::move(gcode_data.tools_colors);
     m_color_print_colors = std::move(gcode_data.color_print_colors);
-    m_vertices_colors.resize(m_vertices.size());
 
     m_settings.spiral_vase_mode = gcode_data.spiral_vase_mode;
 
-    for (size_t i = 0; i < m_vertices.size(); ++i) {
+    process_vertices(0);
+
+    if (!m_layers.empty())
+        m_layers.set_view_range(0, static_cast<uint32_t>(m_layers.count()) - 1);
+
+    if (m_settings.time_mode != ETimeMode::Normal && m_total_time[static_cast<size_t>(m_settings.time_mode)] == 0.0f)
+        m_settings.time_mode = ETimeMode::Normal;
+
+    init_gpu_data();
+
+    update_view_full_range();
+    m_view_range.set_visible(m_view_range.get_enabled());
+    update_enabled_entities();
+    update_colors();
+}
+
+void ViewerImpl::append(GCodeInputData&& gcode_data)
+{
+    if (!m_initialized)
+        return;
+
+    if (m_vertices.empty()) {
+        load(std::move(gcode_data));
+        return;
+    }
+
+    if (gcode_data.vertices.empty())
+        return;
+
+    // if the top layer was visible, keep it visible
+    const Interval layers_range = m_layers.get_view_range();
+    const bool top_layer_visible = layers_range[1] + 1 == static_cast<Interval::value_type>(m_layers.count());
+
+    const size_t first = m_vertices.size();
+    m_vertices.insert(m_vertices.end(), std::make_move_iterator(gcode_data.vertices.begin()), std::make_move_iterator(gcode_data.vertices.end()));
+    if (!gcode_data.tools_colors.empty())
+        m_tool_colors = std::move(gcode_data.tools_colors);
+    if (!gcode_data.color_print_colors.empty())
+        m_color_print_colors = std::move(gcode_data.color_print_colors);
+
+    process_vertices(first);
+
+    if (top_layer_visible)
+        m_layers.set_view_range(layers_range[0], static_cast<Interval::value_type>(m_layers.count()) - 1);
+
+    if (m_settings.time_mode != ETimeMode::Normal && m_total_time[static_cast<size_t>(m_settings.time_mode)] == 0.0f)
+        m_settings.time_mode = ETimeMode::Normal;
+
+    // the color ranges have to take into account the new vertices
+    m_settings_used_for_ranges = std::nullopt;
+
+    // the gpu buffers cannot grow, recreate them
+    reset_gpu_data();
+    init_gpu_data();
+
+    update_view_full_range();
+    m_view_range.set_visible(m_view_range.get_enabled());
+    update_enabled_entities();
+    update_colors();
+}
+
+void ViewerImpl::process_vertices(size_t first)
+{
+    m_vertices_colors.resize(m_vertices.size());
+
+    for (size_t i = first; i < m_vertices.size(); ++i) {
         const PathVertex& v = m_vertices[i];
 
         m_layers.update(v, static_cast<uint32_t>(i));
@@ -1026,20 +1112,17 @@ void ViewerImpl::load(GCodeInputData&& gcode_data)
         }
     }
 
-    if (!m_layers.empty())
-        m_layers.set_view_range(0, static_cast<uint32_t>(m_layers.count()) - 1);
-
     std::sort(m_options.begin(), m_options.end());
     m_options.erase(std::unique(m_options.begin(), m_options.end()), m_options.end());
     m_options.shrink_to_fit();
+}
 
+void ViewerImpl::init_gpu_data()
+{
     // reset segments visibility bitset
     m_valid_lines_bitset = BitSet<>(m_vertices.size());
     m_valid_lines_bitset.setAll();
 
-    if (m_settings.time_mode != ETimeMode::Normal && m_total_time[static_cast<size_t>(m_settings.time_mode)] == 0.0f)
-        m_settings.time_mode = ETimeMode::Normal;
-
     // buffers to send to gpu
     // the last component is a dummy float to comply with GL_RGBA32F format
     std::vector<Vec4> positions;
@@ -1098,11 +1181,6 @@ void ViewerImpl::load(GCodeInputData&& gcode_data)
         glsafe(glBindTexture(GL_TEXTURE_BUFFER, old_bound_texture));
 #endif // ENABLE_OPENGL_ES
     }
-
-    update_view_full_range();
-    m_view_range.set_visible(m_view_range.get_enabled());
-    update_enabled_entities();
-    update_colors();
 }
 
 void ViewerImpl::update_enabled_entities()
@@ -1110,8 +1188,46 @@ void ViewerImpl::update_enabled_entities()
     if (m_vertices.empty())
         return;
 
-    std::vector<uint32_t> enabled_segments;
-    std::vector<uint32_t> enabled_options;
+    // The visibility of the entities does not depend on the view range, collect the visible ones
+    // over the whole gcode only when the visibility settings change
+    const bool update_visible_entities = !m_settings_used_for_visible_entities.has_value() ||
+        m_settings.extrusion_roles_visibility != m_settings_used_for_visible_entities->extrusion_roles_visibility ||
+        m_settings.options_visibility != m_settings_used_for_visible_entities->options_visibility;
+    if (update_visible_entities) {
+        m_visible_segments.clear();
+        m_visible_options.clear();
+        for (size_t i = 0; i < m_vertices.size(); ++i) {
+            const PathVertex& v = m_vertices[i];
+
+            if (!m_valid_lines_bitset[i] && !v.is_option())
+                continue;
+            if (v.is_travel()) {
+                if (!m_settings.options_visibility[size_t(EOptionType::Travels)])
+                    continue;
+            }
+            else if (v.is_wipe()) {
+                if (!m_settings.options_visibility[size_t(EOptionType::Wipes)])
+                    continue;
+            }
+            else if (v.is_option()) {
+                if (!m_settings.options_visibility[size_t(move_type_to_option(v.type))])
+                    continue;
+            }
+            else if (v.is_extrusion()) {
+                if (!m_settings.extrusion_roles_visibility[size_t(v.role)])
+                    continue;
+            }
+            else
+                continue;
+
+            if (v.is_option())
+                m_visible_options.push_back(static_cast<uint32_t>(i));
+            else
+                m_visible_segments.push_back(static_cast<uint32_t>(i));
+        }
+        m_settings_used_for_visible_entities = m_settings;
+    }
+
     Interval range = m_view_range.get_visible();
 
     // when top layer only visualization is enabled, we need to render
@@ -1131,63 +1247,45 @@ void ViewerImpl::update_enabled_entities()
             --range[0];
     }
 
-    for (size_t i = range[0]; i < range[1]; ++i) {
-        const PathVertex& v = m_vertices[i];
+    // the enabled entities are the visible ones with ids in [range[0], range[1])
+    const auto segments_begin = std::lower_bound(m_visible_segments.begin(), m_visible_segments.end(), range[0]);
+    const auto segments_end   = std::lower_bound(segments_begin, m_visible_segments.end(), range[1]);
+    const auto options_begin  = std::lower_bound(m_visible_options.begin(), m_visible_options.end(), range[0]);
+    const auto options_end    = std::lower_bound(options_begin, m_visible_options.end(), range[1]);
 
-        if (!m_valid_lines_bitset[i] && !v.is_option())
-            continue;
-        if (v.is_travel()) {
-            if (!m_settings.options_visibility[size_t(EOptionType::Travels)])
-                continue;
-        }
-        else if (v.is_wipe()) {
-            if (!m_settings.options_visibility[size_t(EOptionType::Wipes)])
-                continue;
-        }
-        else if (v.is_option()) {
-            if (!m_settings.options_visibility[size_t(move_type_to_option(v.type))])
-                continue;
-        }
-        else if (v.is_extrusion()) {
-            if (!m_settings.extrusion_roles_visibility[size_t(v.role)])
-                continue;
-        }
+#ifdef ENABLE_OPENGL_ES
+    m_texture_data.set_enabled_segments(std::vector<uint32_t>(segments_begin, segments_end));
+    m_texture_data.set_enabled_options(std::vector<uint32_t>(options_begin, options_end));
+#else
+    m_enabled_segments_offset = std::distance(m_visible_segments.begin(), segments_begin);
+    m_enabled_segments_count = std::distance(segments_begin, segments_end);
+    m_enabled_options_offset = std::distance(m_visible_options.begin(), options_begin);
+    m_enabled_options_count = std::distance(options_begin, options_end);
+
+    // the gpu buffers contain all the visible entities, the view range is applied by the shaders
+    // through the offset, so they need to be updated only when the visibility changes
+    if (update_visible_entities) {
+        m_enabled_segments_tex_size = m_visible_segments.size() * sizeof(uint32_t);
+        m_enabled_options_tex_size = m_visible_options.size() * sizeof(uint32_t);
+
+        // update gpu buffer for enabled segments
+        assert(m_enabled_segments_buf_id > 0);
+        glsafe(glBindBuffer(GL_TEXTURE_BUFFER, m_enabled_segments_buf_id));
+        if (!m_visible_segments.empty())
+            glsafe(glBufferData(GL_TEXTURE_BUFFER, m_visible_segments.size() * sizeof(uint32_t), m_visible_segments.data(), GL_STATIC_DRAW));
         else
-            continue;
+            glsafe(glBufferData(GL_TEXTURE_BUFFER, 0, nullptr, GL_STATIC_DRAW));
 
-        if (v.is_option())
-            enabled_options.push_back(static_cast<uint32_t>(i));
+        // update gpu buffer for enabled options
+        assert(m_enabled_options_buf_id > 0);
+        glsafe(glBindBuffer(GL_TEXTURE_BUFFER, m_enabled_options_buf_id));
+        if (!m_visible_options.empty())
+            glsafe(glBufferData(GL_TEXTURE_BUFFER, m_visible_options.size() * sizeof(uint32_t), m_visible_options.data(), GL_STATIC_DRAW));
         else
-            enabled_segments.push_back(static_cast<uint32_t>(i));
-    }
-
-#ifdef ENABLE_OPENGL_ES
-    m_texture_data.set_enabled_segments(enabled_segments);
-    m_texture_data.set_enabled_options(enabled_options);
-#else
-    m_enabled_segments_count = enabled_segments.size();
-    m_enabled_options_count = enabled_options.size();
-
-    m_enabled_segments_tex_size = enabled_segments.size() * sizeof(uint32_t);
-    m_enabled_options_tex_size = enabled_options.size() * sizeof(uint32_t);
-
-    // update gpu buffer for enabled segments
-    assert(m_enabled_segments_buf_id > 0);
-    glsafe(glBindBuffer(GL_TEXTURE_BUFFER, m_enabled_segments_buf_id));
-    if (!enabled_segments.empty())
-        glsafe(glBufferData(GL_TEXTURE_BUFFER, enabled_segments.size() * sizeof(uint32_t), enabled_segments.data(), GL_STATIC_DRAW));
-    else
-        glsafe(glBufferData(GL_TEXTURE_BUFFER, 0, nullptr, GL_STATIC_DRAW));
-
-    // update gpu buffer for enabled options
-    assert(m_enabled_options_buf_id > 0);
-    glsafe(glBindBuffer(GL_TEXTURE_BUFFER, m_enabled_options_buf_id));
-    if (!enabled_options.empty())
-        glsafe(glBufferData(GL_TEXTURE_BUFFER, enabled_options.size() * sizeof(uint32_t), enabled_options.data(), GL_STATIC_DRAW));
-    else
-        glsafe(glBufferData(GL_TEXTURE_BUFFER, 0, nullptr, GL_STATIC_DRAW));
+            glsafe(glBufferData(GL_TEXTURE_BUFFER, 0, nullptr, GL_STATIC_DRAW));
 
-    glsafe(glBindBuffer(GL_TEXTURE_BUFFER, 0));
+        glsafe(glBindBuffer(GL_TEXTURE_BUFFER, 0));
+    }
 #endif // ENABLE_OPENGL_ES
 
     m_settings.update_enabled_entities = false;
@@ -1613,6 +1711,8 @@ size_t ViewerImpl::get_used_cpu_memory() const
     ret += sizeof(m_options_colors);
     ret += STDVEC_MEMSIZE(m_vertices, PathVertex);
     ret += m_valid_lines_bitset.size_in_bytes_cpu();
+    ret += STDVEC_MEMSIZE(m_visible_segments, uint32_t);
+    ret += STDVEC_MEMSIZE(m_visible_options, uint32_t);
     ret += m_height_range.size_in_bytes_cpu();
     ret += m_width_range.size_in_bytes_cpu();
     ret += m_speed_range.size_in_bytes_cpu();
@@ -1671,7 +1771,9 @@ void ViewerImpl::update_view_full_range()
     const bool travels_visible = m_settings.options_visibility[size_t(EOptionType::Travels)];
     const bool wipes_visible   = m_settings.options_visibility[size_t(EOptionType::Wipes)];
 
-    auto first_it = m_vertices.begin();
+    // The vertices are sorted by layers, the layers below the view range are skipped at once
+    auto first_it = (layers_range[0] < m_layers.count()) ?
+        m_vertices.begin() + m_layers.get_vertices_range(layers_range[0])[0] : m_vertices.end();
     while (first_it != m_vertices.end() &&
            (first_it->layer_id < layers_range[0] || !is_visible(*first_it, m_settings))) {
         ++first_it;
@@ -1694,6 +1796,8 @@ void ViewerImpl::update_view_full_range()
         }
 
         auto last_it = first_it;
+        if (layers_range[1] < m_layers.count())
+            last_it = std::max(last_it, m_vertices.begin() + m_layers.get_vertices_range(layers_range[1])[1]);
         while (last_it != m_vertices.end() && last_it->layer_id <= layers_range[1]) {
             ++last_it;
         }
@@ -1735,6 +1839,13 @@ void ViewerImpl::update_view_full_range()
             const Interval& full_range = m_view_range.get_full();
             auto top_first_it = m_vertices.begin() + full_range[0];
             bool shortened = false;
+            if (layers_range[1] < m_layers.count()) {
+                const auto top_layer_first_it = m_vertices.begin() + m_layers.get_vertices_range(layers_range[1])[0];
+                if (top_first_it < top_layer_first_it) {
+                    top_first_it = top_layer_first_it;
+                    shortened = true;
+                }
+            }
             while (top_first_it != m_vertices.end() && (top_first_it->layer_id < layers_range[1] || !is_visible(*top_first_it, m_settings))) {
                 ++top_first_it;
                 shortened = true;
@@ -1906,6 +2017,7 @@ void ViewerImpl::render_segments(const Mat4x4& view_matrix, const Mat4x4& projec
     glsafe(glActiveTexture(GL_TEXTURE3));
     glsafe(glBindTexture(GL_TEXTURE_BUFFER, m_enabled_segments_tex_id));
     glsafe(glTexBuffer(GL_TEXTURE_BUFFER, GL_R32UI, m_enabled_segments_buf_id));
+    glsafe(glUniform1i(m_uni_segments_segment_index_offset_id, static_cast<int>(m_enabled_segments_offset)));
 
     m_segment_template.render(m_enabled_segments_count);
 #endif // ENABLE_OPENGL_ES
@@ -1993,6 +2105,7 @@ void ViewerImpl::render_options(const Mat4x4& view_matrix, const Mat4x4& project
     glsafe(glActiveTexture(GL_TEXTURE3));
     glsafe(glBindTexture(GL_TEXTURE_BUFFER, m_enabled_options_tex_id));
     glsafe(glTexBuffer(GL_TEXTURE_BUFFER, GL_R32UI, m_enabled_options_buf_id));
+    glsafe(glUniform1i(m_uni_options_segment_index_offset_id, static_cast<int>(m_enabled_options_offset)));
 
     m_option_template.render(m_enabled_options_count);
 #endif // ENABLE_OPENGL_ES
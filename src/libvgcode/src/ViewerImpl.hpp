@@ -54,6 +54,11 @@ public:
     // from the given gcode data.
     //
     void load(GCodeInputData&& gcode_data);
+    //
+    // Append the given gcode data to the current one.
+    // See: Viewer::append()
+    //
+    void append(GCodeInputData&& gcode_data);
 
     //
     // Update the visibility property of toolpaths in dependence
@@ -276,6 +281,14 @@ private:
     //
     BitSet<> m_valid_lines_bitset;
     //
+    // Ids of the segments and of the options visible with the current settings, over the whole gcode.
+    // The entities enabled by the view range are a contiguous subrange of them, so that moving
+    // the view range does not require to filter the vertices again.
+    //
+    std::optional<Settings> m_settings_used_for_visible_entities;
+    std::vector<uint32_t> m_visible_segments;
+    std::vector<uint32_t> m_visible_options;
+    //
     // Variables used for toolpaths coloring
     //
     std::optional<Settings> m_settings_used_for_ranges;
@@ -311,6 +324,9 @@ private:
     int m_uni_segments_height_width_angle_tex_id{ -1 };
     int m_uni_segments_colors_tex_id{ -1 };
     int m_uni_segments_segment_index_tex_id{ -1 };
+#ifndef ENABLE_OPENGL_ES
+    int m_uni_segments_segment_index_offset_id{ -1 };
+#endif // ENABLE_OPENGL_ES
     //
     // Caches for OpenGL uniforms id for options shader 
     //
@@ -320,6 +336,9 @@ private:
     int m_uni_options_height_width_angle_tex_id{ -1 };
     int m_uni_options_colors_tex_id{ -1 };
     int m_uni_options_segment_index_tex_id{ -1 };
+#ifndef ENABLE_OPENGL_ES
+    int m_uni_options_segment_index_offset_id{ -1 };
+#endif // ENABLE_OPENGL_ES
 #if VGCODE_ENABLE_COG_AND_TOOL_MARKERS
     //
     // Caches for OpenGL uniforms id for cog marker shader 
@@ -433,12 +452,20 @@ private:
     //
     unsigned int m_enabled_segments_buf_id{ 0 };
     unsigned int m_enabled_segments_tex_id{ 0 };
+    //
+    // The buffer contains all the visible segments, the enabled ones start at this offset
+    //
+    size_t m_enabled_segments_offset{ 0 };
     size_t m_enabled_segments_count{ 0 };
     //
     // OpenGL buffers to store enabled options
     //
     unsigned int m_enabled_options_buf_id{ 0 };
     unsigned int m_enabled_options_tex_id{ 0 };
+    //
+    // The buffer contains all the visible options, the enabled ones start at this offset
+    //
+    size_t m_enabled_options_offset{ 0 };
     size_t m_enabled_options_count{ 0 };
     //
     // Caches for size of data sent to gpu, in bytes
@@ -450,6 +477,11 @@ private:
     size_t m_enabled_options_tex_size{ 0 };
 #endif // ENABLE_OPENGL_ES
 
+    // Update layers, times, options and used extruders from the vertices starting at first.
+    void process_vertices(size_t first);
+    // Fill the gpu buffers from all the vertices.
+    void init_gpu_data();
+    void reset_gpu_data();
     void update_view_full_range();
     void update_color_ranges();
     void update_heights_widths();
@@ -21,7 +21,9 @@ struct OCCTResult {
     std::vector<OCCTVolume> volumes;
 };
 
-using LoadStepFn = bool (*)(const char *path, OCCTResult* occt_result);
+// Maximum distance of the tessellation from the surface in millimeters and the maximum angle between the normals
+// of the neighbor triangles in radians.
+using LoadStepFn = bool (*)(const char *path, OCCTResult* occt_result, double linear_deflection, double angular_deflection);
 
 }; // namespace Slic3r
 
@@ -12,8 +12,11 @@
 #include <optional>
 #include <algorithm>
 #include <initializer_list>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -82,6 +85,10 @@ class DecomposedShape
     mutable BoundingBox m_bounding_box;
     mutable double  m_area = 0;
 
+    size_t m_contours_hash = 0;
+
+    void update_contours_hash();
+
 public:
     DecomposedShape() = default;
 
@@ -89,6 +96,7 @@ public:
     {
         m_shape.emplace_back(std::move(sh));
         assert(check_polygons_are_convex(m_shape));
+        update_contours_hash();
     }
 
     explicit DecomposedShape(std::initializer_list<Point> pts)
@@ -98,6 +106,7 @@ public:
     explicit DecomposedShape(Polygons sh) : m_shape{std::move(sh)}
     {
         assert(check_polygons_are_convex(m_shape));
+        update_contours_hash();
     }
 
     const Polygons &contours() const { return m_shape; }
@@ -142,11 +151,43 @@ public:
     }
 
     Vec2crd centroid() const;
+
+    // Hash of the untransformed contours, identifying the same shapes of
+    // different items, e.g. of the copies of the same object.
+    size_t contours_hash() const { return m_contours_hash; }
 };
 
 DecomposedShape decompose(const ExPolygons &polys);
 DecomposedShape decompose(const Polygon &p);
 
+// Cache of the no-fit polygons of an item against the shapes of the fixed
+// items, keyed by the rotations of both. The NFPs are stored relative to the
+// translation of the fixed shape, thus the fixed items of the same shape,
+// e.g. the copies of the same object, share one NFP translated to their
+// positions. The copies of an item share its cache, which is thread safe, as
+// the rotations of an item are evaluated on its copies in parallel.
+class NFPCache
+{
+    struct Entry
+    {
+        Polygons fixed_contours; // Verifies the hash of the fixed shape
+        Polygons nfp;
+    };
+
+    // Hash of the fixed shape, rotation of the fixed shape, rotation of the item
+    using Key = std::tuple<size_t, double, double>;
+    std::map<Key, Entry> m_entries;
+    mutable std::mutex   m_mutex;
+
+public:
+    // Returns nullptr if the NFP is not cached. If the NFP of another shape of
+    // the same hash is cached, sets can_insert to false.
+    const Polygons *find(const DecomposedShape &fixed, double rotation, bool &can_insert) const;
+
+    // If the NFP was inserted by another thread meanwhile, returns that one.
+    const Polygons &insert(const DecomposedShape &fixed, double rotation, Polygons nfp);
+};
+
 class ArrangeItem
 {
 private:
@@ -159,6 +200,9 @@ private:
     int m_priority{0};         // For sorting
     std::optional<int> m_bed_constraint;
 
+    // NFPs of the envelope against fixed items, shared by the copies
+    std::shared_ptr<NFPCache> m_nfp_cache = std::make_shared<NFPCache>();
+
 public:
     ArrangeItem() = default;
 
@@ -199,6 +243,8 @@ public:
     const DecomposedShape & envelope() const { return *m_envelope; }
     void set_envelope(DecomposedShape envelope);
 
+    NFPCache & nfp_cache() const { return *m_nfp_cache; }
+
     const Vec2crd &translation() const { return m_shape.translation(); }
     double         rotation() const { return m_shape.rotation(); }
 
@@ -327,42 +373,62 @@ static Polygons calculate_nfp_unnormalized(const ArrangeItem    &item,
     auto nfps = reserve_polygons(cap * item_outlines.size());
 
     Vec2crd ref_whole = item.envelope().reference_vertex();
+    double  rotation  = item.envelope().rotation();
     Polygon subnfp;
 
     for (const ArrangeItem &fixed : fixed_items) {
-        // fixed_polys should already be a set of strictly convex polygons,
-        // as ArrangeItem stores convex-decomposed polygons
-        const Polygons & fixed_polys = fixed.shape().transformed_outline();
-
-        for (const Polygon &fixed_poly : fixed_polys) {
-            Point max_fixed = Slic3r::reference_vertex(fixed_poly);
-            for (size_t mi = 0; mi < item_outlines.size(); ++mi) {
-                const Polygon &movable = item_outlines[mi];
-                const Vec2crd &mref = item.envelope().reference_vertex(mi);
-                subnfp = nfp_convex_convex_legacy(fixed_poly, movable);
-
-                Vec2crd min_movable = item.envelope().min_vertex(mi);
-
-                Vec2crd dtouch = max_fixed - min_movable;
-                Vec2crd top_other = mref + dtouch;
-                Vec2crd max_nfp = Slic3r::reference_vertex(subnfp);
-                auto dnfp = top_other - max_nfp;
-
-                auto d = ref_whole - mref + dnfp;
-                subnfp.translate(d);
-                nfps.emplace_back(subnfp);
+        const Vec2crd &fixed_tr = fixed.shape().translation();
+
+        bool can_insert = true;
+        const Polygons *fixed_nfps = item.nfp_cache().find(fixed.shape(), rotation, can_insert);
+        Polygons calculated_nfps;
+
+        if (!fixed_nfps) {
+            // fixed_polys should already be a set of strictly convex polygons,
+            // as ArrangeItem stores convex-decomposed polygons
+            const Polygons & fixed_polys = fixed.shape().transformed_outline();
+
+            calculated_nfps = reserve_polygons(fixed_polys.size() * item_outlines.size());
+            for (const Polygon &fixed_poly : fixed_polys) {
+                Point max_fixed = Slic3r::reference_vertex(fixed_poly);
+                for (size_t mi = 0; mi < item_outlines.size(); ++mi) {
+                    const Polygon &movable = item_outlines[mi];
+                    const Vec2crd &mref = item.envelope().reference_vertex(mi);
+                    subnfp = nfp_convex_convex_legacy(fixed_poly, movable);
+
+                    Vec2crd min_movable = item.envelope().min_vertex(mi);
+
+                    Vec2crd dtouch = max_fixed - min_movable;
+                    Vec2crd top_other = mref + dtouch;
+                    Vec2crd max_nfp = Slic3r::reference_vertex(subnfp);
+                    auto dnfp = top_other - max_nfp;
+
+                    // The NFP does not depend on the translation of the item,
+                    // it is stored relative to the translation of fixed.
+                    auto d = ref_whole - mref + dnfp - fixed_tr;
+                    subnfp.translate(d);
+                    calculated_nfps.emplace_back(subnfp);
+                }
             }
 
-            if (stop_cond())
-                break;
+            calculated_nfps = union_(calculated_nfps);
+            if (can_insert)
+                fixed_nfps = &item.nfp_cache().insert(fixed.shape(), rotation, std::move(calculated_nfps));
+            else
+                fixed_nfps = &calculated_nfps;
+        }
 
-            nfps = union_(nfps);
+        for (const Polygon &nfp : *fixed_nfps) {
+            nfps.emplace_back(nfp);
+            nfps.back().translate(fixed_tr);
         }
 
         if (stop_cond()) {
             nfps.clear();
             break;
         }
+
+        nfps = union_(nfps);
     }
 
     return nfps;
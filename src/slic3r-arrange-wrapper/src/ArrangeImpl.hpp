@@ -17,6 +17,7 @@
 #include <arrange/NFP/Kernels/TMArrangeKernel.hpp>
 #include <arrange/NFP/Kernels/GravityKernel.hpp>
 #include <arrange/NFP/RectangleOverfitPackingStrategy.hpp>
+#include <arrange/Raster/PackStrategyRaster.hpp>
 #include <arrange/Beds.hpp>
 
 #include <arrange-wrapper/Arrange.hpp>
@@ -264,6 +265,10 @@ class DefaultArranger: public Arranger<ArrItem> {
 
     static constexpr auto Accuracy = 1.;
 
+    // From this number of items on, the items are packed onto an occupancy
+    // grid of the bed, as the NFP based packing gets too slow.
+    static constexpr size_t RasterPackingMinItems = 100;
+
     template<class It, class FixIt, class Bed>
     void arrange_(
         const Range<It>     &items,
@@ -317,6 +322,15 @@ class DefaultArranger: public Arranger<ArrItem> {
 
         fill_rotations(items, bed, m_settings);
 
+        if constexpr (!std::is_convertible_v<Bed, InfiniteBed>) {
+            if (items.size() >= RasterPackingMinItems) {
+                PackStrategyRaster ps{ep, stop_cond};
+
+                arr2::arrange(sel, ps, items, fixed, bed);
+                return;
+            }
+        }
+
         bool with_wipe_tower = std::any_of(items.begin(), items.end(),
                                            [](auto &itm) {
                                                return is_wipe_tower(itm);
@@ -5,6 +5,8 @@
 
 #include <numeric>
 
+#include <boost/container_hash/hash.hpp>
+
 #include <libslic3r/Geometry/ConvexHull.hpp>
 #include <arrange/NFP/NFPConcave_Tesselate.hpp>
 
@@ -117,6 +119,52 @@ Vec2crd DecomposedShape::centroid() const
     return m_centroid;
 }
 
+void DecomposedShape::update_contours_hash()
+{
+    size_t seed = 0;
+    for (const Polygon &poly : m_shape) {
+        boost::hash_combine(seed, poly.size());
+        for (const Point &p : poly.points) {
+            boost::hash_combine(seed, p.x());
+            boost::hash_combine(seed, p.y());
+        }
+    }
+    m_contours_hash = seed;
+}
+
+const Polygons *NFPCache::find(const DecomposedShape &fixed, double rotation, bool &can_insert) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    can_insert = true;
+    auto it = m_entries.find(Key{fixed.contours_hash(), fixed.rotation(), rotation});
+    if (it == m_entries.end())
+        return nullptr;
+
+    if (it->second.fixed_contours != fixed.contours()) {
+        // Hash collision, keep the cached entry.
+        can_insert = false;
+        return nullptr;
+    }
+
+    return &it->second.nfp;
+}
+
+const Polygons &NFPCache::insert(const DecomposedShape &fixed, double rotation, Polygons nfp)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // The entries are never modified once inserted, so that the returned
+    // references stay valid without the lock.
+    auto [it, inserted] = m_entries.try_emplace(Key{fixed.contours_hash(), fixed.rotation(), rotation});
+    if (inserted) {
+        it->second.fixed_contours = fixed.contours();
+        it->second.nfp = std::move(nfp);
+    }
+
+    return it->second.nfp;
+}
+
 DecomposedShape decompose(const ExPolygons &shape)
 {
     return DecomposedShape{convex_decomposition_tess(shape)};
@@ -161,6 +209,7 @@ ArrangeItem &ArrangeItem::operator=(const ArrangeItem &other)
     m_bed_idx = other.m_bed_idx;
     m_priority = other.m_priority;
     m_bed_constraint = other.m_bed_constraint;
+    m_nfp_cache = other.m_nfp_cache;
 
     if (other.m_envelope.get() == &other.m_shape)
         m_envelope = &m_shape;
@@ -174,11 +223,13 @@ void ArrangeItem::set_shape(DecomposedShape shape)
 {
     m_shape = std::move(shape);
     m_envelope = &m_shape;
+    m_nfp_cache = std::make_shared<NFPCache>();
 }
 
 void ArrangeItem::set_envelope(DecomposedShape envelope)
 {
     m_envelope = std::make_unique<DecomposedShape>(std::move(envelope));
+    m_nfp_cache = std::make_shared<NFPCache>();
 
     // Initial synch of transformations of envelope and shape.
     // They need to be in synch all the time
@@ -193,6 +244,7 @@ ArrangeItem &ArrangeItem::operator=(ArrangeItem &&other) noexcept
     m_bed_idx = other.m_bed_idx;
     m_priority = other.m_priority;
     m_bed_constraint = other.m_bed_constraint;
+    m_nfp_cache = other.m_nfp_cache;
 
     if (other.m_envelope.get() == &other.m_shape)
         m_envelope = &m_shape;
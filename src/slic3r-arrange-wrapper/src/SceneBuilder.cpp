@@ -94,8 +94,8 @@ BoundingBoxf3 instance_bounding_box(const ModelInstance &mi,
 
     for (ModelVolume *v : mi.get_object()->volumes) {
         if (v->is_model_part()) {
-            bb.merge(v->mesh().transformed_bounding_box(tr * inst_matrix
-                                                        * v->get_matrix()));
+            bb.merge(v->convex_hull_or_mesh().transformed_bounding_box(
+                tr * inst_matrix * v->get_matrix()));
         }
     }
 
@@ -931,7 +931,8 @@ ObjectID ArrangeableFullModel<Mdl, Dup, VBH>::geometry_id() const { return m_mdl
 template<class Mdl, class Dup, class VBH>
 ExPolygons ArrangeableFullModel<Mdl, Dup, VBH>::full_outline() const
 {
-    auto ret = reserve_vector<ExPolygon>(arr2::model_instance_count(*m_mdl));
+    ExPolygons ret;
+    ret.reserve(arr2::model_instance_count(*m_mdl));
 
     auto transl = Transform3d::Identity();
     transl.translate(to_3d(m_dup->tr, 0.));
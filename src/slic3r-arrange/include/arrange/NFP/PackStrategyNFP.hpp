@@ -242,26 +242,62 @@ bool pack(Strategy &strategy,
     bool cancelled = strategy.stop_condition();
     const auto & rotations = allowed_rotations(item);
 
-    // Check all rotations but only if item is not already packed
-    for (auto rot_it = rotations.begin();
-         !cancelled && !packed && rot_it != rotations.end(); ++rot_it) {
+    struct RotationResult
+    {
+        double  score = NaNd;
+        Vec2crd translation = Vec2crd::Zero();
+    };
 
-        double rot = *rot_it;
+    auto eval_rotation = [&](auto &itm, double rot) {
+        RotationResult ret;
 
-        set_rotation(item, orig_rot + rot);
-        set_translation(item, orig_tr);
+        set_rotation(itm, orig_rot + rot);
+        set_translation(itm, orig_tr);
 
-        auto nfp = calculate_nfp(item, packing_context, bed,
+        auto nfp = calculate_nfp(itm, packing_context, bed,
                                  strategy.stop_condition);
-        double score = NaNd;
         if (!nfp.empty()) {
-            score = pick_best_spot_on_nfp(item, nfp, bed, strategy);
+            ret.score       = pick_best_spot_on_nfp(itm, nfp, bed, strategy);
+            ret.translation = get_translation(itm);
+        }
 
-            cancelled = strategy.stop_condition();
-            if (score > final_score) {
-                final_score = score;
-                final_rot   = rot;
-                final_tr    = get_translation(item);
+        return ret;
+    };
+
+    // Check all rotations but only if item is not already packed
+    if (!cancelled && !packed && rotations.size() == 1) {
+        RotationResult res = eval_rotation(item, rotations[0]);
+        cancelled = strategy.stop_condition();
+        if (res.score > final_score) {
+            final_score = res.score;
+            final_rot   = rotations[0];
+            final_tr    = res.translation;
+        }
+    } else if (!cancelled && !packed && rotations.size() > 1) {
+        // The rotations are evaluated in parallel, each on its own copy of
+        // the item. The lazily cached geometry of the fixed items is shared
+        // by the copies, so it has to be calculated in advance.
+        for (const auto &fixed : all_items_range(packing_context))
+            fixed_outline(fixed);
+
+        std::vector<StripCVRef<ArrItem>> items(rotations.size(), item);
+        std::vector<RotationResult> results(rotations.size());
+
+        execution::for_each(strategy.ep, size_t(0), rotations.size(),
+            [&](size_t i) {
+                if (!strategy.stop_condition())
+                    results[i] = eval_rotation(items[i], rotations[i]);
+            }, execution::max_concurrency(strategy.ep));
+
+        cancelled = strategy.stop_condition();
+
+        // Pick the first rotation of the best score, the same way as if the
+        // rotations were evaluated one after the other.
+        for (size_t i = 0; i < results.size(); ++i) {
+            if (results[i].score > final_score) {
+                final_score = results[i].score;
+                final_rot   = rotations[i];
+                final_tr    = results[i].translation;
             }
         }
     }
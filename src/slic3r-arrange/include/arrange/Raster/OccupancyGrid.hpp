@@ -0,0 +1,99 @@
+///|/ Copyright (c) Prusa Research 2023 Tomáš Mészáros @tamasmeszaros
+///|/
+///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
+///|/
+#ifndef OCCUPANCYGRID_HPP
+#define OCCUPANCYGRID_HPP
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include <libslic3r/Point.hpp>
+#include <libslic3r/Polygon.hpp>
+#include <libslic3r/BoundingBox.hpp>
+
+namespace Slic3r { namespace arr2 {
+
+// Bitmap of square cells covering a rectangular area. A cell is occupied if
+// it is touched by any of the polygons filled in, thus the rasterization is
+// conservative: polygons whose cells do not collide do not overlap either.
+// Each row of cells is stored as a bitset, so that the spots where a
+// footprint fits are found by bitwise operations on whole words of the rows.
+class OccupancyGrid {
+public:
+    // Columns [begin, end) of a row of cells.
+    struct Span {
+        int begin = 0;
+        int end   = 0;
+    };
+
+    // Rasterized polygons to be placed into the grid. The min corner of their
+    // bounding box (origin) is placed at the min corner of a cell.
+    struct Footprint {
+        Point                          origin = Point::Zero();
+        Vec2crd                        size   = Vec2crd::Zero();
+        int                            cols   = 0;
+        // Occupied cells of each row, relative to the cell of the origin.
+        std::vector<std::vector<Span>> rows;
+
+        bool empty() const { return rows.empty(); }
+    };
+
+    struct Placement {
+        int    col   = 0;
+        int    row   = 0;
+        double score = 0.;
+    };
+
+    OccupancyGrid() = default;
+
+    // Only the whole cells inside the area are part of the grid.
+    OccupancyGrid(const BoundingBox &area, coord_t cell_size);
+
+    int          cols() const { return m_cols; }
+    int          rows() const { return m_rows; }
+    coord_t      cell_size() const { return m_cell_size; }
+    const Point &origin() const { return m_origin; }
+
+    bool is_occupied(int col, int row) const;
+
+    // Position of the min corner of a cell.
+    Point cell_position(int col, int row) const
+    {
+        return m_origin + Point{coord_t(col) * m_cell_size, coord_t(row) * m_cell_size};
+    }
+
+    // Mark all the cells touched by the polygons as occupied.
+    void fill(const Polygon &poly);
+    void fill(const Polygons &polys);
+
+    // Rasterize the polygons with the cell size of this grid.
+    Footprint footprint(const Polygons &polys) const;
+
+    // Find the cell, at which the footprint fits without touching an occupied
+    // cell or leaving the grid, and which minimizes the distance of the
+    // footprint center to the target. The distance is measured relative to
+    // the size of the grid, thus a pile of items grows with the proportions of
+    // the grid. Returns the placement with the squared distance as its score.
+    std::optional<Placement> find_placement(const Footprint &fp,
+                                            const Point     &target) const;
+
+private:
+    Point                 m_origin    = Point::Zero();
+    coord_t               m_cell_size = 1;
+    int                   m_cols      = 0;
+    int                   m_rows      = 0;
+    int                   m_words     = 0;
+    // Bitset of each row, the bits past the last column are set.
+    std::vector<uint64_t> m_bits;
+    // Longest run of free cells in each row, to reject the rows too
+    // crowded for a footprint without testing the bits.
+    std::vector<int>      m_free_run;
+
+    void update_free_run(int row);
+};
+
+}} // namespace Slic3r::arr2
+
+#endif // OCCUPANCYGRID_HPP
@@ -0,0 +1,189 @@
+///|/ Copyright (c) Prusa Research 2023 Tomáš Mészáros @tamasmeszaros
+///|/
+///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
+///|/
+#ifndef PACKSTRATEGYRASTER_HPP
+#define PACKSTRATEGYRASTER_HPP
+
+#include <arrange/ArrangeBase.hpp>
+#include <arrange/Beds.hpp>
+#include <arrange/NFP/NFPArrangeItemTraits.hpp>
+#include <arrange/Raster/OccupancyGrid.hpp>
+
+#include "libslic3r/ClipperUtils.hpp"
+#include "libslic3r/Execution/ExecutionSeq.hpp"
+
+namespace Slic3r { namespace arr2 {
+
+// Packing strategy placing the items onto an occupancy grid of the bed
+// instead of calculating their no-fit polygons. The envelope of the item
+// is rasterized for each allowed rotation and placed onto the free cells
+// nearest to the center of the bed, the fixed outlines of the fixed and
+// packed items are rasterized into the grid of their bed. The cost of
+// packing an item does not depend on the number of items already packed,
+// thus it is suited for arranging hundreds of items, at the expense of
+// the gaps between the items being up to two cells wider than necessary.
+struct RasterPackingTag {};
+
+template<class ExecPolicy = ExecutionSeq,
+         class StopCond   = DefaultStopCondition>
+struct PackStrategyRaster {
+    // Number of cells along the longer side of the bed.
+    static constexpr int DefaultResolution = 512;
+
+    ExecPolicy ep;
+    StopCond   stop_condition;
+    int        resolution = DefaultResolution;
+
+    explicit PackStrategyRaster(ExecPolicy execpolicy = {},
+                                StopCond   stop_cond  = {},
+                                int        res        = DefaultResolution)
+        : ep{std::move(execpolicy)},
+          stop_condition{std::move(stop_cond)},
+          resolution{res}
+    {}
+};
+
+template<class... Args>
+struct PackStrategyTag_<PackStrategyRaster<Args...>>
+{
+    using Tag = RasterPackingTag;
+};
+
+// Occupancy grid of a bounded bed. The cells outside of a non rectangular
+// bed are occupied from the start.
+template<class Bed>
+OccupancyGrid create_occupancy_grid(const Bed &bed, int resolution)
+{
+    BoundingBox bb   = bounding_box(bed);
+    coord_t     cell = std::max(bb.size().x(), bb.size().y()) / std::max(resolution, 1);
+
+    OccupancyGrid grid{bb, cell};
+
+    if constexpr (!IsRectangular<Bed>)
+        grid.fill(to_polygons(diff_ex(to_rectangle(bb), to_expolygons(bed))));
+
+    return grid;
+}
+
+template<class ArrItem>
+class RasterPackingContext : public DefaultPackingContext<ArrItem>
+{
+    OccupancyGrid m_grid;
+    Point         m_target;
+
+public:
+    RasterPackingContext(OccupancyGrid grid, const Point &target)
+        : m_grid{std::move(grid)}, m_target{target}
+    {}
+
+    const OccupancyGrid &grid() const noexcept { return m_grid; }
+    const Point &target() const noexcept { return m_target; }
+
+    void add_fixed_item(const ArrItem &itm)
+    {
+        DefaultPackingContext<ArrItem>::add_fixed_item(itm);
+        m_grid.fill(fixed_outline(itm));
+    }
+
+    void add_packed_item(ArrItem &itm)
+    {
+        DefaultPackingContext<ArrItem>::add_packed_item(itm);
+        m_grid.fill(fixed_outline(itm));
+    }
+};
+
+template<class... Args>
+struct PackStrategyTraits_<PackStrategyRaster<Args...>> {
+    template<class ArrItem>
+    using Context = RasterPackingContext<StripCVRef<ArrItem>>;
+
+    template<class ArrItem, class Bed>
+    static Context<ArrItem> create_context(PackStrategyRaster<Args...> &ps,
+                                           const Bed &bed,
+                                           int bed_index)
+    {
+        return Context<ArrItem>{create_occupancy_grid(bed, ps.resolution),
+                                bounding_box(bed).center()};
+    }
+};
+
+template<class Strategy, class ArrItem, class Bed, class RemIt>
+bool pack(Strategy &strategy,
+          const Bed &bed,
+          ArrItem &item,
+          const PackStrategyContext<Strategy, ArrItem> &packing_context,
+          const Range<RemIt> &remaining_items,
+          const RasterPackingTag &)
+{
+    const OccupancyGrid &grid = packing_context.grid();
+
+    double  orig_rot    = get_rotation(item);
+    double  final_rot   = 0.;
+    double  final_score = std::numeric_limits<double>::infinity();
+    Vec2crd orig_tr     = get_translation(item);
+    Vec2crd final_tr    = orig_tr;
+
+    bool cancelled = strategy.stop_condition();
+    const auto & rotations = allowed_rotations(item);
+
+    struct RotationResult
+    {
+        double  score = std::numeric_limits<double>::infinity();
+        Vec2crd translation = Vec2crd::Zero();
+    };
+
+    auto eval_rotation = [&](auto &itm, double rot) {
+        RotationResult ret;
+
+        set_rotation(itm, orig_rot + rot);
+        set_translation(itm, orig_tr);
+
+        OccupancyGrid::Footprint fp = grid.footprint(envelope_outline(itm));
+        if (auto placement = grid.find_placement(fp, packing_context.target())) {
+            ret.score       = placement->score;
+            ret.translation = orig_tr + grid.cell_position(placement->col, placement->row) - fp.origin;
+        }
+
+        return ret;
+    };
+
+    std::vector<RotationResult> results(rotations.size());
+
+    if (!cancelled && rotations.size() == 1) {
+        results.front() = eval_rotation(item, rotations[0]);
+    } else if (!cancelled && rotations.size() > 1) {
+        std::vector<StripCVRef<ArrItem>> items(rotations.size(), item);
+
+        execution::for_each(strategy.ep, size_t(0), rotations.size(),
+            [&](size_t i) {
+                if (!strategy.stop_condition())
+                    results[i] = eval_rotation(items[i], rotations[i]);
+            }, execution::max_concurrency(strategy.ep));
+    }
+
+    cancelled = strategy.stop_condition();
+
+    // Pick the first rotation of the best score, the same way as if the
+    // rotations were evaluated one after the other.
+    for (size_t i = 0; i < results.size(); ++i) {
+        if (results[i].score < final_score) {
+            final_score = results[i].score;
+            final_rot   = rotations[i];
+            final_tr    = results[i].translation;
+        }
+    }
+
+    bool packed = !cancelled && !std::isinf(final_score);
+
+    if (packed) {
+        set_translation(item, final_tr);
+        set_rotation(item, orig_rot + final_rot);
+    }
+
+    return packed;
+}
+
+}} // namespace Slic3r::arr2
+
+#endif // PACKSTRATEGYRASTER_HPP
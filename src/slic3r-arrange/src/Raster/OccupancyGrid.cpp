@@ -0,0 +1,375 @@
+///|/ Copyright (c) Prusa Research 2023 Tomáš Mészáros @tamasmeszaros
+///|/
+///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
+///|/
+#include <arrange/Raster/OccupancyGrid.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace Slic3r { namespace arr2 {
+
+static constexpr uint64_t AllBits = ~uint64_t(0);
+
+static int cell_index(double v, coord_t cell_size)
+{
+    return int(std::floor(v / cell_size));
+}
+
+// Sort the spans and merge the overlapping or adjacent ones.
+static void merge_spans(std::vector<OccupancyGrid::Span> &spans)
+{
+    using Span = OccupancyGrid::Span;
+
+    std::sort(spans.begin(), spans.end(),
+              [](const Span &a, const Span &b) { return a.begin < b.begin; });
+
+    size_t n = 0;
+    for (const Span &s : spans) {
+        if (n > 0 && s.begin <= spans[n - 1].end)
+            spans[n - 1].end = std::max(spans[n - 1].end, s.end);
+        else
+            spans[n++] = s;
+    }
+    spans.resize(n);
+}
+
+// Call fn(row, spans) for each row of cells in [0, rows) touched by the
+// polygon. The spans of a row are sorted, disjoint and clipped to [0, cols).
+// A cell is touched either by an edge of the polygon, or it lies inside the
+// polygon and thus the scan line through the middle of its row crosses it.
+template<class Fn>
+static void rasterize(const Polygon &poly,
+                      const Point   &origin,
+                      coord_t        cell_size,
+                      int            cols,
+                      int            rows,
+                      Fn           &&fn)
+{
+    using Span = OccupancyGrid::Span;
+
+    if (poly.empty())
+        return;
+
+    BoundingBox bb      = get_extents(poly);
+    int         row_min = std::max(0, cell_index(double(bb.min.y()) - origin.y(), cell_size));
+    int         row_max = std::min(rows - 1, cell_index(double(bb.max.y()) - origin.y(), cell_size));
+
+    std::vector<Span>   spans;
+    std::vector<double> crossings;
+
+    // Columns of the cells touched by [xmin, xmax], widened by a unit
+    // to stay conservative despite of the rounding errors.
+    auto add_span = [&](double xmin, double xmax) {
+        int b = cell_index(xmin - 1. - origin.x(), cell_size);
+        int e = cell_index(xmax + 1. - origin.x(), cell_size) + 1;
+        b = std::max(b, 0);
+        e = std::min(e, cols);
+        if (b < e)
+            spans.push_back({b, e});
+    };
+
+    for (int r = row_min; r <= row_max; ++r) {
+        double y0 = double(origin.y()) + double(r) * cell_size;
+        double y1 = y0 + cell_size;
+        double ym = y0 + 0.5 * cell_size;
+
+        spans.clear();
+        crossings.clear();
+
+        for (size_t i = 0; i < poly.size(); ++i) {
+            const Point &a  = poly[i];
+            const Point &b  = poly[(i + 1) % poly.size()];
+            double       ay = a.y(), by = b.y();
+
+            if (std::max(ay, by) < y0 || std::min(ay, by) > y1)
+                continue;
+
+            auto x_at = [&a, &b, ay, by](double y) {
+                return a.x() + (double(b.x()) - a.x()) * (y - ay) / (by - ay);
+            };
+
+            // The part of the edge inside the row.
+            if (ay == by) {
+                add_span(std::min(a.x(), b.x()), std::max(a.x(), b.x()));
+            } else {
+                double xa = x_at(std::max(std::min(ay, by), y0));
+                double xb = x_at(std::min(std::max(ay, by), y1));
+                add_span(std::min(xa, xb), std::max(xa, xb));
+            }
+
+            if ((ay <= ym) != (by <= ym))
+                crossings.push_back(x_at(ym));
+        }
+
+        std::sort(crossings.begin(), crossings.end());
+        for (size_t i = 0; i + 1 < crossings.size(); i += 2)
+            add_span(crossings[i], crossings[i + 1]);
+
+        if (!spans.empty()) {
+            merge_spans(spans);
+            fn(r, spans);
+        }
+    }
+}
+
+// dst[i] |= src[i + s], the bits past the end of src are taken as set.
+static void or_shifted(const uint64_t *src, int words, int s, uint64_t *dst)
+{
+    int q = s / 64;
+    int r = s % 64;
+
+    auto word = [src, words](int k) { return k < words ? src[k] : AllBits; };
+
+    for (int k = 0; k < words; ++k) {
+        uint64_t lo = word(k + q);
+        dst[k] |= r == 0 ? lo : (lo >> r) | (word(k + q + 1) << (64 - r));
+    }
+}
+
+// Index of the lowest set bit at or above the bit 'from', or -1.
+static int next_set_bit(const std::vector<uint64_t> &bits, int from)
+{
+    for (int k = from / 64; k < int(bits.size()); ++k) {
+        uint64_t w = bits[k];
+        if (k == from / 64)
+            w &= AllBits << (from % 64);
+        if (w != 0) {
+            int i = 0;
+            for (; (w & 1) == 0; w >>= 1)
+                ++i;
+            return k * 64 + i;
+        }
+    }
+    return -1;
+}
+
+// Index of the highest set bit at or below the bit 'from', or -1.
+static int prev_set_bit(const std::vector<uint64_t> &bits, int from)
+{
+    for (int k = from / 64; k >= 0; --k) {
+        uint64_t w = bits[k];
+        if (k == from / 64 && from % 64 != 63)
+            w &= (uint64_t(1) << (from % 64 + 1)) - 1;
+        if (w != 0) {
+            int i = 63;
+            for (; (w & (uint64_t(1) << 63)) == 0; w <<= 1)
+                --i;
+            return k * 64 + i;
+        }
+    }
+    return -1;
+}
+
+OccupancyGrid::OccupancyGrid(const BoundingBox &area, coord_t cell_size)
+    : m_origin{area.min}, m_cell_size{std::max(cell_size, coord_t(1))}
+{
+    if (area.defined) {
+        m_cols = int(area.size().x() / m_cell_size);
+        m_rows = int(area.size().y() / m_cell_size);
+    }
+
+    m_words = (m_cols + 63) / 64;
+    m_bits.assign(size_t(m_words) * m_rows, 0);
+
+    if (m_cols % 64 != 0)
+        for (int r = 0; r < m_rows; ++r)
+            m_bits[size_t(r) * m_words + m_words - 1] = AllBits << (m_cols % 64);
+
+    m_free_run.assign(m_rows, m_cols);
+}
+
+void OccupancyGrid::update_free_run(int row)
+{
+    const uint64_t *bits = m_bits.data() + size_t(row) * m_words;
+
+    int longest = 0, run = 0;
+    for (int c = 0; c < m_cols; ++c) {
+        if ((bits[c / 64] >> (c % 64)) & 1) {
+            run = 0;
+        } else
+            longest = std::max(longest, ++run);
+    }
+
+    m_free_run[row] = longest;
+}
+
+bool OccupancyGrid::is_occupied(int col, int row) const
+{
+    if (col < 0 || row < 0 || col >= m_cols || row >= m_rows)
+        return true;
+
+    return (m_bits[size_t(row) * m_words + col / 64] >> (col % 64)) & 1;
+}
+
+void OccupancyGrid::fill(const Polygon &poly)
+{
+    rasterize(poly, m_origin, m_cell_size, m_cols, m_rows,
+              [this](int r, const std::vector<Span> &spans) {
+                  uint64_t *row = m_bits.data() + size_t(r) * m_words;
+                  for (const Span &s : spans)
+                      for (int c = s.begin; c < s.end;) {
+                          int      n    = std::min(64 - c % 64, s.end - c);
+                          uint64_t mask = n == 64 ? AllBits : ((uint64_t(1) << n) - 1);
+                          row[c / 64] |= mask << (c % 64);
+                          c += n;
+                      }
+                  update_free_run(r);
+              });
+}
+
+void OccupancyGrid::fill(const Polygons &polys)
+{
+    for (const Polygon &p : polys)
+        fill(p);
+}
+
+OccupancyGrid::Footprint OccupancyGrid::footprint(const Polygons &polys) const
+{
+    Footprint fp;
+
+    BoundingBox bb = get_extents(polys);
+    if (!bb.defined)
+        return fp;
+
+    fp.origin = bb.min;
+    fp.size   = bb.size();
+    fp.cols   = int(fp.size.x() / m_cell_size) + 1;
+    fp.rows.resize(size_t(fp.size.y() / m_cell_size) + 1);
+
+    for (const Polygon &p : polys)
+        rasterize(p, fp.origin, m_cell_size, fp.cols, int(fp.rows.size()),
+                  [&fp](int r, const std::vector<Span> &spans) {
+                      fp.rows[r].insert(fp.rows[r].end(), spans.begin(), spans.end());
+                  });
+
+    if (polys.size() > 1)
+        for (std::vector<Span> &spans : fp.rows)
+            merge_spans(spans);
+
+    return fp;
+}
+
+std::optional<OccupancyGrid::Placement> OccupancyGrid::find_placement(
+    const Footprint &fp, const Point &target) const
+{
+    const int fp_rows = int(fp.rows.size());
+    if (fp.empty() || fp.cols > m_cols || fp_rows > m_rows)
+        return {};
+
+    const int max_col = m_cols - fp.cols;
+    const int max_row = m_rows - fp_rows;
+
+    // A footprint placed at a column collides with a row of the grid if any
+    // of the cells covered by one of its spans is occupied. Dilating the row
+    // by the length of the span turns this test into a single bit per column.
+    // The rows are dilated lazily by the powers of two, a dilation by any
+    // length is then composed of two overlapping power of two dilations.
+    std::vector<int> longest_span(fp_rows, 0);
+    for (int r = 0; r < fp_rows; ++r)
+        for (const Span &s : fp.rows[r])
+            longest_span[r] = std::max(longest_span[r], s.end - s.begin);
+
+    int levels = 1;
+    while ((1 << levels) <= *std::max_element(longest_span.begin(), longest_span.end()))
+        ++levels;
+
+    // Dilations of each row by 2^level, level 0 being the row itself.
+    std::vector<std::vector<uint64_t>> dilated(levels);
+    std::vector<int>                   dilated_levels(m_rows, 1);
+
+    auto dilated_row = [&](int level, int row) -> const uint64_t * {
+        if (level == 0)
+            return m_bits.data() + size_t(row) * m_words;
+        for (int l = dilated_levels[row]; l <= level; ++l) {
+            if (dilated[l].empty())
+                dilated[l].resize(size_t(m_rows) * m_words);
+            const uint64_t *src = l == 1 ? m_bits.data() + size_t(row) * m_words :
+                                           dilated[l - 1].data() + size_t(row) * m_words;
+            uint64_t       *dst = dilated[l].data() + size_t(row) * m_words;
+            std::copy(src, src + m_words, dst);
+            or_shifted(src, m_words, 1 << (l - 1), dst);
+        }
+        dilated_levels[row] = std::max(dilated_levels[row], level + 1);
+        return dilated[level].data() + size_t(row) * m_words;
+    };
+
+    // Squared distances of the footprint center to the target,
+    // relative to the size of the grid.
+    const double sx  = double(m_cols) * m_cell_size;
+    const double sy  = double(m_rows) * m_cell_size;
+    const double cx0 = double(m_origin.x()) + 0.5 * fp.size.x() - target.x();
+    const double cy0 = double(m_origin.y()) + 0.5 * fp.size.y() - target.y();
+
+    auto dist_x = [&](int col) { double d = (cx0 + double(col) * m_cell_size) / sx; return d * d; };
+    auto dist_y = [&](int row) { double d = (cy0 + double(row) * m_cell_size) / sy; return d * d; };
+
+    const int target_col = std::clamp(int(std::lround(-cx0 / m_cell_size)), 0, max_col);
+    const int target_row = std::clamp(int(std::lround(-cy0 / m_cell_size)), 0, max_row);
+
+    std::optional<Placement> best;
+    std::vector<uint64_t>    blocked(m_words);
+    std::vector<uint64_t>    free(m_words);
+
+    auto eval_row = [&](int row) {
+        for (int r = 0; r < fp_rows; ++r)
+            if (longest_span[r] > m_free_run[row + r])
+                return;
+
+        std::fill(blocked.begin(), blocked.end(), 0);
+
+        bool any_free = true;
+        for (int r = 0; r < fp_rows && any_free; ++r) {
+            for (const Span &s : fp.rows[r]) {
+                int len   = s.end - s.begin;
+                int level = 0;
+                while ((2 << level) <= len)
+                    ++level;
+
+                const uint64_t *d = dilated_row(level, row + r);
+                or_shifted(d, m_words, s.begin, blocked.data());
+                if (len != (1 << level))
+                    or_shifted(d, m_words, s.begin + len - (1 << level), blocked.data());
+            }
+
+            any_free = false;
+            for (int k = 0; k < m_words; ++k)
+                any_free |= (free[k] = ~blocked[k]) != 0;
+        }
+
+        if (!any_free)
+            return;
+
+        for (int col : {prev_set_bit(free, target_col), next_set_bit(free, target_col)}) {
+            if (col < 0 || col > max_col)
+                continue;
+
+            double score = dist_x(col) + dist_y(row);
+            if (!best || score < best->score)
+                best = Placement{col, row, score};
+        }
+    };
+
+    // Visit the rows in both directions from the row nearest to the target,
+    // until no row further away can beat the best placement found.
+    bool down = true, up = true;
+    for (int i = 0; down || up; ++i) {
+        int rdown = target_row - i;
+        int rup   = target_row + i;
+
+        down = down && rdown >= 0 && (!best || dist_y(rdown) < best->score);
+        up   = up && i > 0 && rup <= max_row && (!best || dist_y(rup) < best->score);
+
+        if (down)
+            eval_row(rdown);
+        if (up)
+            eval_row(rup);
+
+        if (i == 0)
+            up = target_row < max_row;
+    }
+
+    return best;
+}
+
+}} // namespace Slic3r::arr2
@@ -48,6 +48,8 @@
 
 #include <Eigen/Dense>
 
+#include <tbb/parallel_for.h>
+
 #ifdef HAS_GLSAFE
 void glAssertRecentCallImpl(const char* file_name, unsigned int line, const char* function_name)
 {
@@ -448,6 +450,13 @@ void GLVolume::render_non_manifold_edges()
     m_non_manifold_edges.render();
 }
 
+GLVolumeCollection::~GLVolumeCollection()
+{
+    clear();
+    if (m_instances_vbo != 0)
+        glsafe(::glDeleteBuffers(1, &m_instances_vbo));
+}
+
 std::vector<int> GLVolumeCollection::load_object(
     const ModelObject*      model_object,
     int                     obj_idx,
@@ -456,34 +465,52 @@ std::vector<int> GLVolumeCollection::load_object(
     std::vector<int> volumes_idx;
     for (int volume_idx = 0; volume_idx < int(model_object->volumes.size()); ++volume_idx)
         for (int instance_idx : instance_idxs)
-           volumes_idx.emplace_back(this->GLVolumeCollection::load_object_volume(model_object, obj_idx, volume_idx, instance_idx));
+           volumes_idx.emplace_back(this->GLVolumeCollection::load_object_volume(model_object, obj_idx, volume_idx, instance_idx, false));
+    std::vector<std::pair<GLVolume*, std::shared_ptr<const TriangleMesh>>> to_initialize;
+    to_initialize.reserve(volumes_idx.size());
+    for (int idx : volumes_idx)
+        to_initialize.emplace_back(this->volumes[idx], model_object->volumes[this->volumes[idx]->volume_idx()]->mesh_ptr());
+    this->init_geometries(to_initialize);
     return volumes_idx;
 }
 
+void GLVolumeCollection::init_geometry(GLVolume& volume, const std::shared_ptr<const TriangleMesh>& mesh) const
+{
+#if ENABLE_SMOOTH_NORMALS
+    volume.model.init_from(*mesh, true);
+#else
+    volume.model.init_from(*mesh);
+#endif // ENABLE_SMOOTH_NORMALS
+    if (m_use_raycasters)
+        volume.mesh_raycaster = std::make_unique<GUI::MeshRaycaster>(mesh);
+}
+
+void GLVolumeCollection::init_geometries(const std::vector<std::pair<GLVolume*, std::shared_ptr<const TriangleMesh>>>& volumes_meshes) const
+{
+    // Only CPU side data are built here, the vertex buffers are sent to the GPU by the first render call on the UI thread.
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, volumes_meshes.size()), [this, &volumes_meshes](const tbb::blocked_range<size_t>& range) {
+        for (size_t i = range.begin(); i < range.end(); ++i)
+            init_geometry(*volumes_meshes[i].first, volumes_meshes[i].second);
+        });
+}
+
 int GLVolumeCollection::load_object_volume(
     const ModelObject* model_object,
     int                obj_idx,
     int                volume_idx,
-    int                instance_idx)
+    int                instance_idx,
+    bool               initialize_geometry)
 {
     const ModelVolume   *model_volume = model_object->volumes[volume_idx];
     const int            extruder_id  = model_volume->extruder_id();
     const ModelInstance *instance 	  = model_object->instances[instance_idx];
-    std::shared_ptr<const TriangleMesh> mesh = model_volume->mesh_ptr();
     this->volumes.emplace_back(new GLVolume());
     GLVolume& v = *this->volumes.back();
     v.set_color(color_from_model_volume(*model_volume));
     // apply printable value from the instance
     v.printable = instance->printable;
-#if ENABLE_SMOOTH_NORMALS
-    v.model.init_from(*mesh, true);
-    if (m_use_raycasters)
-      v.mesh_raycaster = std::make_unique<GUI::MeshRaycaster>(mesh);
-#else
-    v.model.init_from(*mesh);
-    if (m_use_raycasters)
-      v.mesh_raycaster = std::make_unique<GUI::MeshRaycaster>(mesh);
-#endif // ENABLE_SMOOTH_NORMALS
+    if (initialize_geometry)
+        this->init_geometry(v, model_volume->mesh_ptr());
     v.composite_id = GLVolume::CompositeID(obj_idx, volume_idx, instance_idx);
     if (model_volume->is_model_part()) {
         // GLVolume will reference a convex hull from model_volume!
@@ -746,10 +773,39 @@ GLVolumeWithIdAndZList volumes_to_render(const GLVolumePtrs& volumes, GLVolumeCo
     return list;
 }
 
+// Returns true if the given box, transformed into the clip space by the given matrix, lies completely
+// on the outer side of one of the planes of the view frustum. The test is conservative, a box
+// intersecting the frustum only near one of its corners may be reported as visible.
+static bool is_outside_frustum(const BoundingBoxf3& box, const Matrix4d& clip_matrix)
+{
+    if (!box.defined)
+        return false;
+
+    std::array<int, 6> outside_cnt{ 0, 0, 0, 0, 0, 0 };
+    for (int i = 0; i < 8; ++i) {
+        const Vec4d corner((i & 1) ? box.max.x() : box.min.x(), (i & 2) ? box.max.y() : box.min.y(), (i & 4) ? box.max.z() : box.min.z(), 1.0);
+        const Vec4d p = clip_matrix * corner;
+        for (int axis = 0; axis < 3; ++axis) {
+            if (p[axis] < -p.w())
+                ++outside_cnt[2 * axis];
+            if (p[axis] > p.w())
+                ++outside_cnt[2 * axis + 1];
+        }
+    }
+    return std::find(outside_cnt.begin(), outside_cnt.end(), 8) != outside_cnt.end();
+}
+
 void GLVolumeCollection::render(GLVolumeCollection::ERenderType type, bool disable_cullface, const Transform3d& view_matrix, const Transform3d& projection_matrix,
     std::function<bool(const GLVolume&)> filter_func) const
 {
     GLVolumeWithIdAndZList to_render = volumes_to_render(volumes, type, view_matrix, filter_func);
+
+    // Skip the volumes whose bounding box is not visible.
+    const Matrix4d view_projection_matrix = (projection_matrix * view_matrix).matrix();
+    to_render.erase(std::remove_if(to_render.begin(), to_render.end(), [&view_projection_matrix](const GLVolumeWithIdAndZ& volume) {
+        return is_outside_frustum(volume.first->bounding_box(), view_projection_matrix * volume.first->world_matrix().matrix());
+        }), to_render.end());
+
     if (to_render.empty())
         return;
 
@@ -793,22 +849,138 @@ void GLVolumeCollection::render(GLVolumeCollection::ERenderType type, bool disab
     }
     auto time_now = std::chrono::system_clock::now();
 
+    auto is_render_as_mmu_painted = [&](const GLVolume& volume) {
+        const int obj_idx = volume.object_idx();
+        const int vol_idx = volume.volume_idx();
+        return is_render_as_mmu_painted_enabled && !volume.selected &&
+            !volume.is_outside && volume.hover == GLVolume::HS_None && !volume.is_wipe_tower() && obj_idx >= 0 && vol_idx >= 0 &&
+            !model_objects[obj_idx]->volumes[vol_idx]->mm_segmentation_facets.empty() &&
+            type != GLVolumeCollection::ERenderType::Transparent; // to filter out shells (not very nice)
+    };
+
+    // Volumes sharing the same geometry (the instances of a ModelVolume or the SLA supports / pad / drilled mesh
+    // of the instances of a ModelObject) are rendered by a single instanced draw call.
+    // Transparent volumes are excluded as they have to be rendered back to front.
+    GLShaderProgram* instanced_shader = (type == ERenderType::Opaque && curr_shader->get_name() == "gouraud") ?
+        GUI::wxGetApp().get_shader("gouraud_instanced") : nullptr;
+    // Index into instanced_groups for each item of to_render, -1 for volumes to be rendered one by one.
+    std::vector<int> instanced_group_idxs(to_render.size(), -1);
+    std::vector<std::vector<GLVolume*>> instanced_groups;
+    if (instanced_shader != nullptr) {
+        // object_idx, volume_idx, geometry_id.first, indices count, left handed
+        using InstancedKey = std::tuple<int, int, size_t, size_t, bool>;
+        std::map<InstancedKey, int> groups_map;
+        for (size_t i = 0; i < to_render.size(); ++i) {
+            GLVolume& volume = *to_render[i].first;
+            if (!volume.is_active || volume.object_idx() < 0 || volume.is_wipe_tower() || volume.is_extrusion_path ||
+                volume.tverts_range != std::make_pair<size_t, size_t>(0, -1) || !volume.model.is_initialized() || is_render_as_mmu_painted(volume))
+                continue;
+            const InstancedKey key{ volume.object_idx(), volume.volume_idx(), volume.geometry_id.first, volume.model.indices_count(), volume.is_left_handed() };
+            auto [it, inserted] = groups_map.insert({ key, int(instanced_groups.size()) });
+            if (inserted)
+                instanced_groups.emplace_back();
+            instanced_groups[it->second].emplace_back(&volume);
+            instanced_group_idxs[i] = it->second;
+        }
+        // Single volumes are rendered the usual way.
+        for (int& group_idx : instanced_group_idxs)
+            if (group_idx != -1 && instanced_groups[group_idx].size() < 2)
+                group_idx = -1;
+    }
+    std::vector<bool> instanced_group_rendered(instanced_groups.size(), false);
+
+    auto render_instanced_group = [&](const std::vector<GLVolume*>& group) {
+        std::vector<float> instances_data;
+        instances_data.reserve(group.size() * GUI::GLModel::TransformedInstanceStrideFloats);
+        for (GLVolume* volume : group) {
+            volume->set_render_color(true);
+            const Transform3d world_matrix = volume->world_matrix();
+            const Matrix4f world_matrix_f = world_matrix.matrix().cast<float>();
+            const Matrix3f world_normal_matrix_f = world_matrix.linear().inverse().transpose().cast<float>();
+            instances_data.insert(instances_data.end(), world_matrix_f.data(), world_matrix_f.data() + 16);
+            instances_data.insert(instances_data.end(), world_normal_matrix_f.data(), world_normal_matrix_f.data() + 9);
+            instances_data.insert(instances_data.end(), volume->render_color.data(), volume->render_color.data() + 4);
+        }
+
+        if (m_instances_vbo == 0)
+            glsafe(::glGenBuffers(1, &m_instances_vbo));
+        glsafe(::glBindBuffer(GL_ARRAY_BUFFER, m_instances_vbo));
+        glsafe(::glBufferData(GL_ARRAY_BUFFER, instances_data.size() * sizeof(float), instances_data.data(), GL_DYNAMIC_DRAW));
+        glsafe(::glBindBuffer(GL_ARRAY_BUFFER, 0));
+
+        GLVolume& first = *group.front();
+        instanced_shader->start_using();
+        instanced_shader->set_uniform("z_range", m_z_range);
+        instanced_shader->set_uniform("clipping_plane", m_clipping_plane);
+        instanced_shader->set_uniform("use_color_clip_plane", m_use_color_clip_plane);
+        instanced_shader->set_uniform("color_clip_plane", m_color_clip_plane);
+        instanced_shader->set_uniform("uniform_color_clip_plane_1", m_color_clip_plane_colors[0]);
+        instanced_shader->set_uniform("uniform_color_clip_plane_2", m_color_clip_plane_colors[1]);
+        instanced_shader->set_uniform("print_volume.type", static_cast<int>(m_print_volume.type));
+        instanced_shader->set_uniform("print_volume.xy_data", m_print_volume.data);
+        instanced_shader->set_uniform("print_volume.z_data", m_print_volume.zs);
+        instanced_shader->set_uniform("slope.actived", m_slope.active && !first.is_modifier && !first.is_wipe_tower());
+        instanced_shader->set_uniform("slope.normal_z", m_slope.normal_z);
+        instanced_shader->set_uniform("view_matrix", view_matrix);
+        instanced_shader->set_uniform("projection_matrix", projection_matrix);
+        instanced_shader->set_uniform("view_normal_matrix", static_cast<Matrix3d>(view_matrix.linear()));
+
+#if ENABLE_ENVIRONMENT_MAP
+        unsigned int environment_texture_id = GUI::wxGetApp().plater()->get_environment_texture_id();
+        bool use_environment_texture = environment_texture_id > 0 && GUI::wxGetApp().app_config->get_bool("use_environment_map");
+        instanced_shader->set_uniform("use_environment_tex", use_environment_texture);
+        if (use_environment_texture)
+            glsafe(::glBindTexture(GL_TEXTURE_2D, environment_texture_id));
+#endif // ENABLE_ENVIRONMENT_MAP
+        glcheck();
+
+        const bool is_left_handed = first.is_left_handed();
+        if (is_left_handed)
+            glsafe(::glFrontFace(GL_CW));
+        glsafe(::glCullFace(GL_BACK));
+
+        first.model.render_instanced_transformed(m_instances_vbo, (unsigned int)group.size());
 
+        if (is_left_handed)
+            glsafe(::glFrontFace(GL_CCW));
 
+#if ENABLE_ENVIRONMENT_MAP
+        if (use_environment_texture)
+            glsafe(::glBindTexture(GL_TEXTURE_2D, 0));
+#endif // ENABLE_ENVIRONMENT_MAP
 
-    for (GLVolumeWithIdAndZ& volume : to_render) {
+        glsafe(::glBindBuffer(GL_ARRAY_BUFFER, 0));
+        glsafe(::glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
+        instanced_shader->stop_using();
+    };
+
+    for (size_t volume_id = 0; volume_id < to_render.size(); ++volume_id) {
+        GLVolumeWithIdAndZ& volume = to_render[volume_id];
         if (!volume.first->is_active)
             continue;
 
+        const int instanced_group_idx = instanced_group_idxs[volume_id];
+        if (instanced_group_idx != -1) {
+            // render sinking contours of non-hovered volumes
+            if (m_show_sinking_contours && volume.first->is_sinking() && !volume.first->is_below_printbed() &&
+                volume.first->hover == GLVolume::HS_None && !volume.first->force_sinking_contours) {
+                sink_shader->start_using();
+                volume.first->render_sinking_contours();
+                sink_shader->stop_using();
+            }
+            if (!instanced_group_rendered[instanced_group_idx]) {
+                render_instanced_group(instanced_groups[instanced_group_idx]);
+                instanced_group_rendered[instanced_group_idx] = true;
+            }
+            continue;
+        }
+
         const Transform3d world_matrix = volume.first->world_matrix();
         const Matrix3d world_matrix_inv_transp = world_matrix.linear().inverse().transpose();
         const Matrix3d view_normal_matrix = view_matrix.linear() * world_matrix_inv_transp;
         const int obj_idx = volume.first->object_idx();
         const int vol_idx = volume.first->volume_idx();
-        const bool render_as_mmu_painted = is_render_as_mmu_painted_enabled && !volume.first->selected &&
-            !volume.first->is_outside && volume.first->hover == GLVolume::HS_None && !volume.first->is_wipe_tower() && obj_idx >= 0 && vol_idx >= 0 &&
-            !model_objects[obj_idx]->volumes[vol_idx]->mm_segmentation_facets.empty() &&
-            type != GLVolumeCollection::ERenderType::Transparent; // to filter out shells (not very nice)
+        const bool render_as_mmu_painted = is_render_as_mmu_painted(*volume.first);
         volume.first->set_render_color(true);
 
         // render sinking contours of non-hovered volumes
@@ -854,7 +1026,7 @@ void GLVolumeCollection::render(GLVolumeCollection::ERenderType type, bool disab
             GUI::TriangleSelectorMmGui* ts = nullptr;
             uint64_t timestamp = model_volume.mm_segmentation_facets.timestamp();
             if (it == m_mm_paint_cache.volume_data.end() || it->second.extruder_id != extruder_idx || timestamp != it->second.mm_timestamp) {
-                auto ts_uptr = std::make_unique<GUI::TriangleSelectorMmGui>(model_volume.mesh(), m_mm_paint_cache.extruders_colors, m_mm_paint_cache.extruders_colors[extruder_idx]);
+                auto ts_uptr = std::make_unique<GUI::TriangleSelectorMmGui>(model_volume.mesh_ptr(), m_mm_paint_cache.extruders_colors, m_mm_paint_cache.extruders_colors[extruder_idx]);
                 ts = ts_uptr.get();
                 ts->deserialize(model_volume.mm_segmentation_facets.get_data(), true);
                 ts->request_update_render_data();
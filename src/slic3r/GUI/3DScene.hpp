@@ -13,6 +13,7 @@
 #define slic3r_3DScene_hpp_
 
 #include "libslic3r/libslic3r.h"
+#include "libslic3r/BuildVolume.hpp"
 #include "libslic3r/Point.hpp"
 #include "libslic3r/Line.hpp"
 #include "libslic3r/TriangleMesh.hpp"
@@ -103,6 +104,8 @@ private:
     std::optional<BoundingBoxf3> m_transformed_convex_hull_bounding_box;
     // Bounding box of the non sinking part of this volume, in unscaled coordinates.
     std::optional<BoundingBoxf3> m_transformed_non_sinking_bounding_box;
+    // Result of the last test of the convex hull against the build volume, reset together with the cached bounding boxes.
+    std::optional<std::pair<size_t, std::pair<BuildVolume::ObjectState, int>>> m_outside_state;
 
     class SinkingContours
     {
@@ -290,11 +293,11 @@ public:
     void set_volume_mirror(Axis axis, double mirror) { m_volume_transformation.set_mirror(axis, mirror); set_bounding_boxes_as_dirty(); }
      
     double get_sla_shift_z() const { return m_sla_shift_z; }
-    void set_sla_shift_z(double z) { m_sla_shift_z = z; }
+    void set_sla_shift_z(double z) { m_sla_shift_z = z; m_outside_state.reset(); }
 
-    void set_convex_hull(std::shared_ptr<const TriangleMesh> convex_hull) { m_convex_hull = std::move(convex_hull); }
-    void set_convex_hull(const TriangleMesh &convex_hull) { m_convex_hull = std::make_shared<const TriangleMesh>(convex_hull); }
-    void set_convex_hull(TriangleMesh &&convex_hull) { m_convex_hull = std::make_shared<const TriangleMesh>(std::move(convex_hull)); }
+    void set_convex_hull(std::shared_ptr<const TriangleMesh> convex_hull) { m_convex_hull = std::move(convex_hull); m_outside_state.reset(); }
+    void set_convex_hull(const TriangleMesh &convex_hull) { m_convex_hull = std::make_shared<const TriangleMesh>(convex_hull); m_outside_state.reset(); }
+    void set_convex_hull(TriangleMesh &&convex_hull) { m_convex_hull = std::make_shared<const TriangleMesh>(std::move(convex_hull)); m_outside_state.reset(); }
 
     int                 object_idx() const   { return this->composite_id.object_id; }
     int                 volume_idx() const   { return this->composite_id.volume_id; }
@@ -314,6 +317,14 @@ public:
     const BoundingBoxf3& transformed_non_sinking_bounding_box() const;
     // convex hull
     const TriangleMesh*  convex_hull() const { return m_convex_hull.get(); }
+    // Cached state and bed index of the convex hull tested against the build volume identified by build_volume_timestamp,
+    // see GLCanvas3D::check_volumes_outside_state().
+    std::optional<std::pair<BuildVolume::ObjectState, int>> outside_state(size_t build_volume_timestamp) const {
+        return m_outside_state && m_outside_state->first == build_volume_timestamp ? std::make_optional(m_outside_state->second) : std::nullopt;
+    }
+    void                 set_outside_state(size_t build_volume_timestamp, BuildVolume::ObjectState state, int bed_idx) {
+        m_outside_state = std::make_pair(build_volume_timestamp, std::make_pair(state, bed_idx));
+    }
 
     bool                empty() const { return this->model.is_empty(); }
 
@@ -325,6 +336,7 @@ public:
         m_transformed_bounding_box.reset();
         m_transformed_convex_hull_bounding_box.reset();
         m_transformed_non_sinking_bounding_box.reset();
+        m_outside_state.reset();
     }
 
     bool                is_sla_support() const;
@@ -412,22 +424,31 @@ private:
     };
     mutable MMPaintCache m_mm_paint_cache;
 
+    // Buffer holding the per instance data of the volumes rendered by instanced draw calls.
+    mutable unsigned int m_instances_vbo{ 0 };
+
 public:
     GLVolumePtrs volumes;
 
     GLVolumeCollection() { set_default_slope_normal_z(); }
-    ~GLVolumeCollection() { clear(); }
+    ~GLVolumeCollection();
 
     std::vector<int> load_object(
         const ModelObject* model_object,
         int                      obj_idx,
         const std::vector<int>& instance_idxs);
 
+    // If initialize_geometry is false, the render geometry and the raycaster of the new volume are left empty
+    // and they have to be created by init_geometries().
     int load_object_volume(
         const ModelObject* model_object,
         int                obj_idx,
         int                volume_idx,
-        int                instance_idx);
+        int                instance_idx,
+        bool               initialize_geometry = true);
+
+    // Create the render geometries and the raycasters of the given volumes from the given meshes, in parallel.
+    void init_geometries(const std::vector<std::pair<GLVolume*, std::shared_ptr<const TriangleMesh>>>& volumes_meshes) const;
 
 #if SLIC3R_OPENGL_ES
     GLVolume* load_wipe_tower_preview(
@@ -501,6 +522,8 @@ public:
     std::string         log_memory_info() const;
 
 private:
+    void init_geometry(GLVolume& volume, const std::shared_ptr<const TriangleMesh>& mesh) const;
+
     GLVolumeCollection(const GLVolumeCollection &other);
     GLVolumeCollection& operator=(const GLVolumeCollection &);
 };
@@ -29,6 +29,7 @@
 #include "libslic3r/GCode/PostProcessor.hpp"
 #include "libslic3r/Format/SL1.hpp"
 #include "libslic3r/Thread.hpp"
+#include "libslic3r/Trace.hpp"
 #include "libslic3r/libslic3r.h"
 
 #include <cassert>
@@ -102,11 +103,16 @@ std::pair<std::string, bool> SlicingProcessCompletedEvent::format_error_message(
 	return std::make_pair(std::move(error), monospace);
 }
 
-void BackgroundSlicingProcess::set_temp_output_path(int bed_idx)
+std::string BackgroundSlicingProcess::temp_output_path(int bed_idx)
 {
     boost::filesystem::path temp_path(wxStandardPaths::Get().GetTempDir().utf8_str().data());
     temp_path /= (boost::format(".%1%_%2%.gcode") % get_current_pid() % bed_idx).str();
-	m_temp_output_path = temp_path.string();
+	return temp_path.string();
+}
+
+void BackgroundSlicingProcess::set_temp_output_path(int bed_idx)
+{
+	m_temp_output_path = temp_output_path(bed_idx);
 }
 
 BackgroundSlicingProcess::~BackgroundSlicingProcess() 
@@ -450,6 +456,9 @@ bool BackgroundSlicingProcess::start()
 		throw Slic3r::RuntimeError("Cannot start a background task, the worker thread is not idle.");
 	m_state = STATE_STARTED;
 	m_print->set_cancel_callback([this](){ this->stop_internal(); });
+	if (Trace::enabled())
+		// Let the performance overlay show the steps of this slicing pass only.
+		Trace::start();
 	lck.unlock();
 	m_condition.notify_one();
 	return true;
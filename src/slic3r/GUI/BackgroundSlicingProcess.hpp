@@ -89,6 +89,8 @@ public:
 	~BackgroundSlicingProcess();
 
 	void set_temp_output_path(int bed_idx);
+	// Path of the temporary G-code of a bed, the G-code of the bed may be exported there ahead of time by the SpeculativeSlicingProcess.
+	static std::string temp_output_path(int bed_idx);
 	void set_fff_print(Print* print) { if (m_fff_print != print) stop(); m_fff_print = print; }
     void set_sla_print(SLAPrint *print) { if (m_sla_print != print) stop(); m_sla_print = print; }
 	void set_thumbnail_cb(ThumbnailsGeneratorCallback cb) { m_thumbnail_cb = cb; }
@@ -383,8 +383,18 @@ class GLCanvas3D
         std::chrono::time_point<std::chrono::high_resolution_clock> m_measuring_start;
         int m_fps_out = -1;
         int m_fps_running = 0;
+        std::chrono::time_point<std::chrono::high_resolution_clock> m_frame_start;
+        // Time spent by rendering the last frame and the longest frame since the last FPS measurement, in milliseconds.
+        float m_frame_time_ms = 0.f;
+        float m_max_frame_time_ms_running = 0.f;
+        float m_max_frame_time_ms_out = 0.f;
     public:
-        void increment_fps_counter() { ++m_fps_running; }
+        void start_frame() { m_frame_start = std::chrono::high_resolution_clock::now(); }
+        void increment_fps_counter() {
+            ++m_fps_running;
+            m_frame_time_ms = 0.001f * float(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - m_frame_start).count());
+            m_max_frame_time_ms_running = std::max(m_max_frame_time_ms_running, m_frame_time_ms);
+        }
         int get_fps() { return m_fps_out; }
         int get_fps_and_reset_if_needed() {
             auto cur_time = std::chrono::high_resolution_clock::now();
@@ -393,9 +403,14 @@ class GLCanvas3D
                 m_measuring_start = cur_time;
                 m_fps_out = int (1000. * m_fps_running / elapsed_ms);
                 m_fps_running = 0;
+                m_max_frame_time_ms_out = m_max_frame_time_ms_running;
+                m_max_frame_time_ms_running = 0.f;
             }
             return m_fps_out;
         }
+        float get_frame_time_ms() const { return m_frame_time_ms; }
+        // Valid after get_fps_and_reset_if_needed().
+        float get_max_frame_time_ms() const { return m_max_frame_time_ms_out; }
 
     };
 
@@ -1015,6 +1030,7 @@ private:
 #endif // ENABLE_RENDER_SELECTION_CENTER
     void _check_and_update_toolbar_icon_scale();
     void _render_overlays();
+    void _render_performance_overlay();
     void _render_bed_selector();
     void _render_volumes_for_picking(const Camera& camera) const;
     void _render_current_gizmo() const { m_gizmos.render_current_gizmo(); }
@@ -34,6 +34,8 @@
 
 #include <GL/glew.h>
 
+#include <cstring>
+
 namespace Slic3r {
 namespace GUI {
 
@@ -681,7 +683,7 @@ void GLModel::reset()
         glsafe(::glDeleteBuffers(1, &m_render_data.vbo_id));
         m_render_data.vbo_id = 0;
 #if ENABLE_GLMODEL_STATISTICS
-        s_statistics.gpu_memory.vertices.current -= vertices_size_bytes();
+        s_statistics.gpu_memory.vertices.current -= gpu_vertices_size_bytes();
 #endif // ENABLE_GLMODEL_STATISTICS
     }
 #if !SLIC3R_OPENGL_ES
@@ -697,6 +699,7 @@ void GLModel::reset()
 
     m_render_data.vertices_count = 0;
     m_render_data.indices_count  = 0;
+    m_render_data.packed_normals = false;
     m_render_data.geometry.vertices = std::vector<float>();
     m_render_data.geometry.indices  = std::vector<unsigned int>();
     m_bounding_box = BoundingBoxf3();
@@ -718,6 +721,23 @@ static GLenum get_primitive_mode(const GLModel::Geometry::Format& format)
     }
 }
 
+// Whether the normals can be sent to the gpu as GL_INT_2_10_10_10_REV values, the format is core since OpenGL 3.3.
+static bool can_pack_normals()
+{
+#if SLIC3R_OPENGL_ES
+    return false;
+#else
+    return OpenGLManager::get_gl_info().is_version_greater_or_equal_to(3, 3);
+#endif // SLIC3R_OPENGL_ES
+}
+
+// Packs a unit vector into a GL_INT_2_10_10_10_REV value, the w component is left zero.
+static uint32_t pack_normal(const Vec3f& normal)
+{
+    auto pack = [](float v) { return uint32_t(int32_t(std::round(std::clamp(v, -1.0f, 1.0f) * 511.0f))) & 0x3FF; };
+    return pack(normal.x()) | (pack(normal.y()) << 10) | (pack(normal.z()) << 20);
+}
+
 static GLenum get_index_type(const GLModel::Geometry& data)
 {
     switch (data.index_type)
@@ -757,7 +777,7 @@ void GLModel::render(const std::pair<size_t, size_t>& range)
     const GLenum mode = get_primitive_mode(data.format);
     const GLenum index_type = get_index_type(data);
 
-    const size_t vertex_stride_bytes = Geometry::vertex_stride_bytes(data.format);
+    const size_t vertex_stride_bytes = gpu_vertex_stride_bytes();
     const bool position = Geometry::has_position(data.format);
     const bool normal = Geometry::has_normal(data.format);
     const bool tex_coord = Geometry::has_tex_coord(data.format);
@@ -781,28 +801,28 @@ void GLModel::render(const std::pair<size_t, size_t>& range)
     if (position) {
         position_id = shader->get_attrib_location("v_position");
         if (position_id != -1) {
-            glsafe(::glVertexAttribPointer(position_id, Geometry::position_stride_floats(data.format), GL_FLOAT, GL_FALSE, vertex_stride_bytes, (const void*)Geometry::position_offset_bytes(data.format)));
+            glsafe(::glVertexAttribPointer(position_id, Geometry::position_stride_floats(data.format), GL_FLOAT, GL_FALSE, vertex_stride_bytes, (const void*)gpu_offset_bytes(Geometry::position_offset_floats(data.format))));
             glsafe(::glEnableVertexAttribArray(position_id));
         }
     }
     if (normal) {
         normal_id = shader->get_attrib_location("v_normal");
         if (normal_id != -1) {
-            glsafe(::glVertexAttribPointer(normal_id, Geometry::normal_stride_floats(data.format), GL_FLOAT, GL_FALSE, vertex_stride_bytes, (const void*)Geometry::normal_offset_bytes(data.format)));
+            set_normal_attribute_pointer(normal_id);
             glsafe(::glEnableVertexAttribArray(normal_id));
         }
     }
     if (tex_coord) {
         tex_coord_id = shader->get_attrib_location("v_tex_coord");
         if (tex_coord_id != -1) {
-            glsafe(::glVertexAttribPointer(tex_coord_id, Geometry::tex_coord_stride_floats(data.format), GL_FLOAT, GL_FALSE, vertex_stride_bytes, (const void*)Geometry::tex_coord_offset_bytes(data.format)));
+            glsafe(::glVertexAttribPointer(tex_coord_id, Geometry::tex_coord_stride_floats(data.format), GL_FLOAT, GL_FALSE, vertex_stride_bytes, (const void*)gpu_offset_bytes(Geometry::tex_coord_offset_floats(data.format))));
             glsafe(::glEnableVertexAttribArray(tex_coord_id));
         }
     }
     if (extra) {
         extra_id = shader->get_attrib_location("v_extra");
         if (extra_id != -1) {
-            glsafe(::glVertexAttribPointer(extra_id, Geometry::extra_stride_floats(data.format), GL_FLOAT, GL_FALSE, vertex_stride_bytes, (const void*)Geometry::extra_offset_bytes(data.format)));
+            glsafe(::glVertexAttribPointer(extra_id, Geometry::extra_stride_floats(data.format), GL_FLOAT, GL_FALSE, vertex_stride_bytes, (const void*)gpu_offset_bytes(Geometry::extra_offset_floats(data.format))));
             glsafe(::glEnableVertexAttribArray(extra_id));
         }
     }
@@ -884,7 +904,7 @@ void GLModel::render_instanced(unsigned int instances_vbo, unsigned int instance
     const GLenum mode = get_primitive_mode(data.format);
     const GLenum index_type = get_index_type(data);
 
-    const size_t vertex_stride_bytes = Geometry::vertex_stride_bytes(data.format);
+    const size_t vertex_stride_bytes = gpu_vertex_stride_bytes();
     const bool position = Geometry::has_position(data.format);
     const bool normal   = Geometry::has_normal(data.format);
 
@@ -892,12 +912,12 @@ void GLModel::render_instanced(unsigned int instances_vbo, unsigned int instance
     glsafe(::glBindBuffer(GL_ARRAY_BUFFER, m_render_data.vbo_id));
 
     if (position) {
-        glsafe(::glVertexAttribPointer(position_id, Geometry::position_stride_floats(data.format), GL_FLOAT, GL_FALSE, vertex_stride_bytes, (const void*)Geometry::position_offset_bytes(data.format)));
+        glsafe(::glVertexAttribPointer(position_id, Geometry::position_stride_floats(data.format), GL_FLOAT, GL_FALSE, vertex_stride_bytes, (const void*)gpu_offset_bytes(Geometry::position_offset_floats(data.format))));
         glsafe(::glEnableVertexAttribArray(position_id));
     }
 
     if (normal) {
-        glsafe(::glVertexAttribPointer(normal_id, Geometry::normal_stride_floats(data.format), GL_FLOAT, GL_FALSE, vertex_stride_bytes, (const void*)Geometry::normal_offset_bytes(data.format)));
+        set_normal_attribute_pointer(normal_id);
         glsafe(::glEnableVertexAttribArray(normal_id));
     }
 
@@ -927,6 +947,137 @@ void GLModel::render_instanced(unsigned int instances_vbo, unsigned int instance
 #endif // ENABLE_GLMODEL_STATISTICS
 }
 
+void GLModel::render_instanced_transformed(unsigned int instances_vbo, unsigned int instances_count)
+{
+    if (instances_vbo == 0 || instances_count == 0)
+        return;
+
+    GLShaderProgram* shader = wxGetApp().get_current_shader();
+    if (shader == nullptr || !boost::algorithm::iends_with(shader->get_name(), "_instanced"))
+        return;
+
+    // vertex attributes
+    const GLint position_id = shader->get_attrib_location("v_position");
+    const GLint normal_id   = shader->get_attrib_location("v_normal");
+    if (position_id == -1 || normal_id == -1)
+        return;
+
+    // instance attributes
+    // matrices take one attribute location per column
+    const GLint world_matrix_id        = shader->get_attrib_location("i_world_matrix");
+    const GLint world_normal_matrix_id = shader->get_attrib_location("i_world_normal_matrix");
+    const GLint color_id               = shader->get_attrib_location("i_color");
+    if (world_matrix_id == -1 || world_normal_matrix_id == -1 || color_id == -1)
+        return;
+
+    if (m_render_data.vbo_id == 0 || m_render_data.ibo_id == 0) {
+        if (!send_to_gpu())
+            return;
+    }
+
+#if !SLIC3R_OPENGL_ES
+    if (OpenGLManager::get_gl_info().is_core_profile()) {
+#endif // !SLIC3R_OPENGL_ES
+        glsafe(::glBindVertexArray(m_render_data.vao_id));
+#if !SLIC3R_OPENGL_ES
+    }
+#endif // !SLIC3R_OPENGL_ES
+
+    glsafe(::glBindBuffer(GL_ARRAY_BUFFER, instances_vbo));
+    const size_t instance_stride = TransformedInstanceStrideFloats * sizeof(float);
+    for (GLint i = 0; i < 4; ++i) {
+        glsafe(::glVertexAttribPointer(world_matrix_id + i, 4, GL_FLOAT, GL_FALSE, instance_stride, (const void*)(4 * i * sizeof(float))));
+        glsafe(::glEnableVertexAttribArray(world_matrix_id + i));
+        glsafe(::glVertexAttribDivisor(world_matrix_id + i, 1));
+    }
+    for (GLint i = 0; i < 3; ++i) {
+        glsafe(::glVertexAttribPointer(world_normal_matrix_id + i, 3, GL_FLOAT, GL_FALSE, instance_stride, (const void*)((16 + 3 * i) * sizeof(float))));
+        glsafe(::glEnableVertexAttribArray(world_normal_matrix_id + i));
+        glsafe(::glVertexAttribDivisor(world_normal_matrix_id + i, 1));
+    }
+    glsafe(::glVertexAttribPointer(color_id, 4, GL_FLOAT, GL_FALSE, instance_stride, (const void*)(25 * sizeof(float))));
+    glsafe(::glEnableVertexAttribArray(color_id));
+    glsafe(::glVertexAttribDivisor(color_id, 1));
+
+    const Geometry& data = m_render_data.geometry;
+
+    const GLenum mode = get_primitive_mode(data.format);
+    const GLenum index_type = get_index_type(data);
+
+    const size_t vertex_stride_bytes = gpu_vertex_stride_bytes();
+    const bool position = Geometry::has_position(data.format);
+    const bool normal   = Geometry::has_normal(data.format);
+
+    // the following binding is needed to set the vertex attributes
+    glsafe(::glBindBuffer(GL_ARRAY_BUFFER, m_render_data.vbo_id));
+
+    if (position) {
+        glsafe(::glVertexAttribPointer(position_id, Geometry::position_stride_floats(data.format), GL_FLOAT, GL_FALSE, vertex_stride_bytes, (const void*)gpu_offset_bytes(Geometry::position_offset_floats(data.format))));
+        glsafe(::glEnableVertexAttribArray(position_id));
+    }
+
+    if (normal) {
+        set_normal_attribute_pointer(normal_id);
+        glsafe(::glEnableVertexAttribArray(normal_id));
+    }
+
+    glsafe(::glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_render_data.ibo_id));
+    glsafe(::glDrawElementsInstanced(mode, indices_count(), index_type, (const void*)0, instances_count));
+
+    if (normal)
+        glsafe(::glDisableVertexAttribArray(normal_id));
+    if (position)
+        glsafe(::glDisableVertexAttribArray(position_id));
+
+    // reset the divisors, the attribute locations may be reused by non instanced shaders
+    glsafe(::glVertexAttribDivisor(color_id, 0));
+    glsafe(::glDisableVertexAttribArray(color_id));
+    for (GLint i = 0; i < 3; ++i) {
+        glsafe(::glVertexAttribDivisor(world_normal_matrix_id + i, 0));
+        glsafe(::glDisableVertexAttribArray(world_normal_matrix_id + i));
+    }
+    for (GLint i = 0; i < 4; ++i) {
+        glsafe(::glVertexAttribDivisor(world_matrix_id + i, 0));
+        glsafe(::glDisableVertexAttribArray(world_matrix_id + i));
+    }
+
+    glsafe(::glBindBuffer(GL_ARRAY_BUFFER, 0));
+#if !SLIC3R_OPENGL_ES
+    if (OpenGLManager::get_gl_info().is_core_profile()) {
+#endif // !SLIC3R_OPENGL_ES
+        glsafe(::glBindVertexArray(0));
+#if !SLIC3R_OPENGL_ES
+    }
+#endif // !SLIC3R_OPENGL_ES
+
+#if ENABLE_GLMODEL_STATISTICS
+    ++s_statistics.render_instanced_calls;
+#endif // ENABLE_GLMODEL_STATISTICS
+}
+
+size_t GLModel::gpu_vertex_stride_bytes() const
+{
+    const size_t stride_bytes = Geometry::vertex_stride_bytes(m_render_data.geometry.format);
+    // the 3 floats of the normal are replaced by a single 32 bits value
+    return m_render_data.packed_normals ? stride_bytes - 2 * sizeof(float) : stride_bytes;
+}
+
+size_t GLModel::gpu_offset_bytes(size_t offset_floats) const
+{
+    if (m_render_data.packed_normals && offset_floats > Geometry::normal_offset_floats(m_render_data.geometry.format))
+        offset_floats -= 2;
+    return offset_floats * sizeof(float);
+}
+
+void GLModel::set_normal_attribute_pointer(int normal_id) const
+{
+    const Geometry::Format& format = m_render_data.geometry.format;
+    if (m_render_data.packed_normals)
+        glsafe(::glVertexAttribPointer(normal_id, 4, GL_INT_2_10_10_10_REV, GL_TRUE, gpu_vertex_stride_bytes(), (const void*)gpu_offset_bytes(Geometry::normal_offset_floats(format))));
+    else
+        glsafe(::glVertexAttribPointer(normal_id, Geometry::normal_stride_floats(format), GL_FLOAT, GL_FALSE, gpu_vertex_stride_bytes(), (const void*)Geometry::normal_offset_bytes(format)));
+}
+
 bool GLModel::send_to_gpu()
 {
     if (m_render_data.vbo_id > 0 || m_render_data.ibo_id > 0) {
@@ -952,11 +1103,29 @@ bool GLModel::send_to_gpu()
     // vertices
     glsafe(::glGenBuffers(1, &m_render_data.vbo_id));
     glsafe(::glBindBuffer(GL_ARRAY_BUFFER, m_render_data.vbo_id));
-    glsafe(::glBufferData(GL_ARRAY_BUFFER, data.vertices_size_bytes(), data.vertices.data(), GL_STATIC_DRAW));
+    m_render_data.packed_normals = can_pack_normals() && Geometry::has_normal(data.format) && Geometry::normal_stride_floats(data.format) == 3;
+    if (m_render_data.packed_normals) {
+        // convert normals to a single GL_INT_2_10_10_10_REV value to save gpu memory
+        const size_t vertices_count = data.vertices_count();
+        const size_t stride_floats = Geometry::vertex_stride_floats(data.format);
+        const size_t packed_stride = stride_floats - 2;
+        const size_t normal_offset = Geometry::normal_offset_floats(data.format);
+        std::vector<uint32_t> packed_vertices(vertices_count * packed_stride);
+        for (size_t i = 0; i < vertices_count; ++i) {
+            const float* src = data.vertices.data() + i * stride_floats;
+            uint32_t* dst = packed_vertices.data() + i * packed_stride;
+            std::memcpy(dst, src, normal_offset * sizeof(float));
+            dst[normal_offset] = pack_normal(Vec3f(src[normal_offset], src[normal_offset + 1], src[normal_offset + 2]));
+            std::memcpy(dst + normal_offset + 1, src + normal_offset + 3, (stride_floats - normal_offset - 3) * sizeof(float));
+        }
+        glsafe(::glBufferData(GL_ARRAY_BUFFER, packed_vertices.size() * sizeof(uint32_t), packed_vertices.data(), GL_STATIC_DRAW));
+    }
+    else
+        glsafe(::glBufferData(GL_ARRAY_BUFFER, data.vertices_size_bytes(), data.vertices.data(), GL_STATIC_DRAW));
     glsafe(::glBindBuffer(GL_ARRAY_BUFFER, 0));
     m_render_data.vertices_count = vertices_count();
 #if ENABLE_GLMODEL_STATISTICS
-    s_statistics.gpu_memory.vertices.current += data.vertices_size_bytes();
+    s_statistics.gpu_memory.vertices.current += gpu_vertices_size_bytes();
     s_statistics.gpu_memory.vertices.max = std::max(s_statistics.gpu_memory.vertices.current, s_statistics.gpu_memory.vertices.max);
 #endif // ENABLE_GLMODEL_STATISTICS
     data.vertices = std::vector<float>();
@@ -159,6 +159,8 @@ namespace GUI {
             unsigned int ibo_id{ 0 };
             size_t vertices_count{ 0 };
             size_t indices_count{ 0 };
+            // Whether the normals were sent to the gpu packed into a single GL_INT_2_10_10_10_REV value.
+            bool packed_normals{ false };
         };
 
     private:
@@ -212,6 +214,10 @@ namespace GUI {
 
         size_t indices_size_bytes() const { return indices_count() * Geometry::index_stride_bytes(m_render_data.geometry); }
 
+        // Size of a vertex into the vbo, smaller than Geometry::vertex_stride_bytes() when the normals are packed.
+        size_t gpu_vertex_stride_bytes() const;
+        size_t gpu_vertices_size_bytes() const { return vertices_count() * gpu_vertex_stride_bytes(); }
+
         const Geometry& get_geometry() const { return m_render_data.geometry; }
 
         void init_from(Geometry&& data);
@@ -232,6 +238,11 @@ namespace GUI {
         void render();
         void render(const std::pair<size_t, size_t>& range);
         void render_instanced(unsigned int instances_vbo, unsigned int instances_count);
+        // Render one copy of the model for each instance stored into the given vbo.
+        // Each instance is described by TransformedInstanceStrideFloats floats: the world matrix (16 floats, column major),
+        // the world normal matrix (9 floats, column major) and the color (4 floats).
+        static constexpr const size_t TransformedInstanceStrideFloats = 16 + 9 + 4;
+        void render_instanced_transformed(unsigned int instances_vbo, unsigned int instances_count);
 
         bool is_initialized() const { return vertices_count() > 0 && indices_count() > 0; }
         bool is_empty() const { return m_render_data.geometry.is_empty(); }
@@ -254,7 +265,7 @@ namespace GUI {
         size_t gpu_memory_used() const {
             size_t ret = 0;
             if (m_render_data.geometry.vertices.empty())
-                ret += vertices_size_bytes();
+                ret += gpu_vertices_size_bytes();
             if (m_render_data.geometry.indices.empty())
                 ret += indices_size_bytes();
             return ret;
@@ -270,6 +281,9 @@ namespace GUI {
 
     private:
         bool send_to_gpu();
+        // Offset into the vbo of the vertex attribute with the given offset into Geometry::vertices.
+        size_t gpu_offset_bytes(size_t offset_floats) const;
+        void set_normal_attribute_pointer(int normal_id) const;
     };
 
     bool contains(const BuildVolume& volume, const GLModel& model, bool ignore_bottom = true);
@@ -78,6 +78,12 @@ std::pair<bool, std::string> GLShadersManager::init()
     // used to render options in gcode preview
     if (GUI::wxGetApp().is_gl_version_greater_or_equal_to(3, 3)) {
         valid &= append_shader("gouraud_light_instanced", { prefix + "gouraud_light_instanced.vs", prefix + "gouraud_light_instanced.fs" });
+        // used to render the instances of objects sharing the same geometry in 3d editor
+        valid &= append_shader("gouraud_instanced", { prefix + "gouraud_instanced.vs", prefix + "gouraud_instanced.fs" }
+#if ENABLE_ENVIRONMENT_MAP
+            , { "ENABLE_ENVIRONMENT_MAP"sv }
+#endif // ENABLE_ENVIRONMENT_MAP
+            );
     }
     // used to render objects in 3d editor
     valid &= append_shader("gouraud", { prefix + "gouraud.vs", prefix + "gouraud.fs" }
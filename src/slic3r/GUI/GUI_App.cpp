@@ -64,6 +64,7 @@
 #include "libslic3r/Model.hpp"
 #include "libslic3r/PresetBundle.hpp"
 #include "libslic3r/Color.hpp"
+#include "libslic3r/SliceCache.hpp"
 #include "libslic3r/Format/SLAArchiveFormatRegistry.hpp"
 #include "libslic3r/Utils/DirectoriesUtils.hpp"
 
@@ -1429,6 +1430,9 @@ bool GUI_App::on_init_inner()
 #endif
 
     if (is_editor()) {
+        // Opt-in persistent cache of object slices, shared by all background slicing processes.
+        SliceCache::set_cache_dir(app_config->get("slice_cache_dir"));
+
         std::string msg = Http::tls_global_init();
         std::string ssl_cert_store = app_config->get("tls_accepted_cert_store_location");
         bool ssl_accept = app_config->get("tls_cert_store_accepted") == "yes" && ssl_cert_store == Http::tls_system_cert_store();
@@ -38,6 +38,7 @@
 
 #include <boost/algorithm/string.hpp>
 #include <wx/progdlg.h>
+#include <numeric>
 #include <wx/listbook.h>
 #include <wx/numformatter.h>
 #include <wx/bookctrl.h> // IWYU pragma: keep
@@ -913,12 +914,10 @@ void ObjectList::paste_objects_into_list(const std::vector<size_t>& object_idxs)
     if (object_idxs.empty())
         return;
 
+    add_objects_to_list(object_idxs, false);
     wxDataViewItemArray items;
     for (const size_t object : object_idxs)
-    {
-        add_object_to_list(object, false);
         items.Add(m_objects_model->GetItemById(object));
-    }
 
     wxGetApp().plater()->changed_objects(object_idxs);
 
@@ -2408,7 +2407,7 @@ wxDataViewItem ObjectList::add_layer_root_item(const wxDataViewItem obj_item)
     for (const auto& range : object(obj_idx)->layer_config_ranges)
         add_layer_item(range.first, layers_item);
 
-    Expand(layers_item);
+    expand_item(layers_item);
     return layers_item;
 }
 
@@ -2889,7 +2888,7 @@ wxDataViewItem ObjectList::add_settings_item(wxDataViewItem parent_item, const D
     if (!ret) ret = m_objects_model->AddSettingsChild(parent_item);
 
     m_objects_model->UpdateSettingsDigest(ret, categories);
-    Expand(parent_item);
+    expand_item(parent_item);
 
     return ret;
 }
@@ -2958,7 +2957,7 @@ void ObjectList::update_info_items(size_t obj_idx, wxDataViewItemArray* selectio
 
         if (! shows && should_show) {
             m_objects_model->AddInfoChild(item_obj, type);
-            Expand(item_obj);
+            expand_item(item_obj);
             if (added_object)
                 wxGetApp().notification_manager()->push_updated_item_info_notification(type); 
         }
@@ -3041,7 +3040,7 @@ wxDataViewItemArray ObjectList::add_volumes_to_object_in_list(size_t obj_idx, st
             if (add_to_selection && add_to_selection(volume))
                 items.Add(vol_item);
         }
-        Expand(object_item);
+        expand_item(object_item);
     }
 
     m_prevent_list_events = is_prevent_list_events;
@@ -3049,6 +3048,35 @@ wxDataViewItemArray ObjectList::add_volumes_to_object_in_list(size_t obj_idx, st
 }
 
 void ObjectList::add_object_to_list(size_t obj_idx, bool call_selection_changed)
+{
+    add_object_to_list_internal(obj_idx, call_selection_changed);
+
+#ifndef __WXOSX__ 
+    if (call_selection_changed)
+	    selection_changed();
+#endif //__WXMSW__
+}
+
+// Number of objects, from which on the objects are added to the list by a batch update.
+static constexpr size_t BATCH_UPDATE_OBJECTS_MIN = 50;
+
+void ObjectList::add_objects_to_list(const std::vector<size_t>& obj_idxs, bool call_selection_changed)
+{
+    const bool batch_update = obj_idxs.size() >= BATCH_UPDATE_OBJECTS_MIN;
+    if (batch_update)
+        m_objects_model->BeginBatchUpdate();
+    for (const size_t obj_idx : obj_idxs)
+        add_object_to_list_internal(obj_idx, call_selection_changed);
+    if (batch_update)
+        m_objects_model->EndBatchUpdate();
+
+#ifndef __WXOSX__ 
+    if (call_selection_changed && !obj_idxs.empty())
+	    selection_changed();
+#endif //__WXMSW__
+}
+
+void ObjectList::add_object_to_list_internal(size_t obj_idx, bool added_object)
 {
     auto model_object = (*m_objects)[obj_idx];
     const wxString& item_name = get_item_name(model_object->name, model_object->is_text());
@@ -3057,7 +3085,7 @@ void ObjectList::add_object_to_list(size_t obj_idx, bool call_selection_changed)
                       get_warning_icon_name(model_object->mesh().stats()),
                       model_object->is_cut());
 
-    update_info_items(obj_idx, nullptr, call_selection_changed);
+    update_info_items(obj_idx, nullptr, added_object);
 
     add_volumes_to_object_in_list(obj_idx);
 
@@ -3070,7 +3098,7 @@ void ObjectList::add_object_to_list(size_t obj_idx, bool call_selection_changed)
 
         const wxDataViewItem object_item = m_objects_model->GetItemById(obj_idx);
         m_objects_model->AddInstanceChild(object_item, print_idicator);
-        Expand(m_objects_model->GetInstanceRootItem(object_item));
+        expand_item(m_objects_model->GetInstanceRootItem(object_item));
     }
     else
         m_objects_model->SetPrintableState(model_object->instances[0]->printable ? piPrintable : piUnprintable, obj_idx);
@@ -3080,11 +3108,12 @@ void ObjectList::add_object_to_list(size_t obj_idx, bool call_selection_changed)
 
     // Add layers if it has
     add_layer_root_item(item);
+}
 
-#ifndef __WXOSX__ 
-    if (call_selection_changed)
-	    selection_changed();
-#endif //__WXMSW__
+void ObjectList::expand_item(const wxDataViewItem& item)
+{
+    if (!m_objects_model->IsBatchUpdate())
+        Expand(item);
 }
 
 void ObjectList::delete_object_from_list()
@@ -4900,14 +4929,9 @@ void ObjectList::update_after_undo_redo()
     m_objects_model->DeleteAll();
     m_prevent_list_events = false;
 
-    size_t obj_idx = 0;
-    std::vector<size_t> obj_idxs;
-    obj_idxs.reserve(m_objects->size());
-    while (obj_idx < m_objects->size()) {
-        add_object_to_list(obj_idx, false);
-        obj_idxs.push_back(obj_idx);
-        ++obj_idx;
-    }
+    std::vector<size_t> obj_idxs(m_objects->size());
+    std::iota(obj_idxs.begin(), obj_idxs.end(), 0);
+    add_objects_to_list(obj_idxs, false);
 
     update_selections();
 
@@ -304,6 +304,9 @@ public:
     wxDataViewItemArray add_volumes_to_object_in_list(size_t obj_idx, std::function<bool(const ModelVolume*)> add_to_selection = nullptr);
     // Add object to the list
     void add_object_to_list(size_t obj_idx, bool call_selection_changed = true);
+    // Add objects to the list, selection_changed() is called once for all of them.
+    // Many objects are added by a batch update of the list, see ObjectDataViewModel::BeginBatchUpdate().
+    void add_objects_to_list(const std::vector<size_t>& obj_idxs, bool call_selection_changed = true);
     // Delete object from the list
     void delete_object_from_list();
     void delete_object_from_list(const size_t obj_idx);
@@ -426,6 +429,11 @@ private:
     bool can_drop(const wxDataViewItem& item) const ;
 
     void ItemValueChanged(wxDataViewEvent &event);
+    // Expand the item unless the list is being batch updated: The control does not know the added items yet
+    // and the items are left collapsed, so that the control does not create the items of their children.
+    void expand_item(const wxDataViewItem& item);
+    // Add object to the list, the selection is not updated.
+    void add_object_to_list_internal(size_t obj_idx, bool added_object);
     // Workaround for entering the column editing mode on Windows. Simulate keyboard enter when another column of the active line is selected.
 	void OnEditingStarted(wxDataViewEvent &event);
     void OnEditingDone(wxDataViewEvent &event);
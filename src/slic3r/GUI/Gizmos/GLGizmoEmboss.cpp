@@ -151,6 +151,8 @@ struct TextDataBase : public DataBase
     /// <returns>True on succes otherwise False(Per glyph shoud be disabled)</returns>
     bool create_text_lines(const Transform3d &tr, const ModelVolumePtrs &vols) override; 
 
+    Slic3r::Emboss::GlyphMeshes *glyph_meshes() override { return m_font_file.mesh_cache.get(); }
+
 private:
     //  Keep pointer on Data of font (glyph shapes)
     FontFileWithCache m_font_file;
@@ -3746,11 +3748,19 @@ void init_face_names(Facenames &face_names)
 
     BOOST_LOG_TRIVIAL(info) << ((face_names.hash == 0) ?
         "FontName list is generate from scratch." :
-        "Hash are different. Only previous bad fonts are used and set again as bad");
+        "Hash are different. Only newly installed fonts are validated, previous good and bad fonts are reused");
     face_names.hash = hash;
-    
+
+    // Validation of a font is slow, it may take seconds with thousands of fonts installed.
+    // Fonts validated before are not validated again, unloadable good font is removed when used.
+    std::vector<wxString> good;
+    good.reserve(face_names.faces.size());
+    for (const FaceName &face : face_names.faces)
+        good.push_back(face.wx_name);
+    assert(std::is_sorted(good.begin(), good.end()));
+
     // validation lambda
-    auto is_valid_font = [encoding = face_names.encoding, bad = face_names.bad /*copy*/](const wxString &name) {
+    auto is_valid_font = [encoding = face_names.encoding, bad = face_names.bad /*copy*/, &good](const wxString &name) {
         if (name.empty()) return false;
 
         // vertical font start with @, we will filter it out
@@ -3761,6 +3771,10 @@ void init_face_names(Facenames &face_names)
         auto it = std::lower_bound(bad.begin(), bad.end(), name);
         if (it != bad.end() && *it == name) return false;
 
+        // previously detected good font
+        auto it_good = std::lower_bound(good.begin(), good.end(), name);
+        if (it_good != good.end() && *it_good == name) return true;
+
         wxFont wx_font(wxFontInfo().FaceName(name).Encoding(encoding));
         //*
         // Faster chech if wx_font is loadable but not 100%
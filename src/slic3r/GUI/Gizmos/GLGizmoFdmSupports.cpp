@@ -416,7 +416,7 @@ void GLGizmoFdmSupports::apply_data_from_backend()
 
     // find the respective PrintObject, we need a pointer to it
     for (const PrintObject *po : m_parent.fff_print()->objects()) {
-        if (po->model_object()->id() == mo->id()) {
+        if (po->prints_model_object(mo->id())) {
             std::unordered_map<size_t, TriangleSelectorWrapper> selectors;
             SupportSpotsGenerator::SupportPoints support_points = po->shared_regions()->generated_support_points->support_points;
             auto                                 obj_transform  = po->shared_regions()->generated_support_points->object_transform;
@@ -424,7 +424,7 @@ void GLGizmoFdmSupports::apply_data_from_backend()
                 if (model_volume->is_model_part()) {
                     Transform3d mesh_transformation = obj_transform * model_volume->get_matrix();
                     Transform3d inv_transform       = mesh_transformation.inverse();
-                    selectors.emplace(model_volume->id().id, TriangleSelectorWrapper{model_volume->mesh(), mesh_transformation});
+                    selectors.emplace(model_volume->id().id, TriangleSelectorWrapper{model_volume->mesh_ptr(), mesh_transformation});
 
                     for (const SupportSpotsGenerator::SupportPoint &support_point : support_points) {
                         Vec3f point  = Vec3f(inv_transform.cast<float>() * support_point.position);
@@ -487,9 +487,9 @@ void GLGizmoFdmSupports::update_from_model_object()
         ++volume_id;
 
         // This mesh does not account for the possible Z up SLA offset.
-        const TriangleMesh* mesh = &mv->mesh();
+        std::shared_ptr<const TriangleMesh> mesh = mv->mesh_ptr();
 
-        m_triangle_selectors.emplace_back(std::make_unique<TriangleSelectorGUI>(*mesh));
+        m_triangle_selectors.emplace_back(std::make_unique<TriangleSelectorGUI>(mesh));
         // Reset of TriangleSelector is done inside TriangleSelectorGUI's constructor, so we don't need it to perform it again in deserialize().
         m_triangle_selectors.back()->deserialize(mv->supported_facets.get_data(), false);
         m_triangle_selectors.back()->request_update_render_data();
@@ -507,7 +507,7 @@ bool GLGizmoFdmSupports::has_backend_supports()
     // find PrintObject with this ID
     bool done = false;
     for (const PrintObject *po : m_parent.fff_print()->objects()) {
-        if (po->model_object()->id() == mo->id())
+        if (po->prints_model_object(mo->id()))
             done = done || po->is_step_done(posSupportSpotsSearch);
     }
 
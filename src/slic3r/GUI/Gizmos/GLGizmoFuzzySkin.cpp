@@ -289,9 +289,9 @@ void GLGizmoFuzzySkin::update_from_model_object()
         ++volume_id;
 
         // This mesh does not account for the possible Z up SLA offset.
-        const TriangleMesh *mesh = &mv->mesh();
+        std::shared_ptr<const TriangleMesh> mesh = mv->mesh_ptr();
 
-        m_triangle_selectors.emplace_back(std::make_unique<TriangleSelectorGUI>(*mesh));
+        m_triangle_selectors.emplace_back(std::make_unique<TriangleSelectorGUI>(mesh));
         // Reset of TriangleSelector is done inside TriangleSelectorGUI's constructor, so we don't need it to perform it again in deserialize().
         m_triangle_selectors.back()->deserialize(mv->fuzzy_skin_facets.get_data(), false);
         m_triangle_selectors.back()->request_update_render_data();
@@ -1064,6 +1064,17 @@ void GLGizmoMeasure::update_if_needed()
     };
 
     auto do_update = [this, update_plane_models_cache](const std::vector<VolumeCacheItem>& volumes_cache, const Selection& selection) {
+        if (auto it = std::find_if(m_measuring_cache.begin(), m_measuring_cache.end(), [&volumes_cache](const MeasuringCacheItem& item) { return item.volumes == volumes_cache; });
+            it != m_measuring_cache.end()) {
+            // The selection was measured before and its meshes did not change, reuse the extracted surface features.
+            std::rotate(m_measuring_cache.begin(), it, it + 1);
+            m_measuring = m_measuring_cache.front().measuring;
+            m_raycaster = m_measuring_cache.front().raycaster;
+            update_plane_models_cache(m_measuring->get_its());
+            m_volumes_cache = volumes_cache;
+            return;
+        }
+
         TriangleMesh composite_mesh;
         for (const auto& vol : volumes_cache) {
 //          if (selection.is_single_full_instance() && vol.volume->is_modifier())
@@ -1078,10 +1089,13 @@ void GLGizmoMeasure::update_if_needed()
             composite_mesh.merge(volume_mesh);
         }
 
-        m_measuring.reset(new Measure::Measuring(composite_mesh.its));
+        m_measuring = std::make_shared<Measure::Measuring>(composite_mesh.its);
         update_plane_models_cache(m_measuring->get_its());
-        m_raycaster.reset(new MeshRaycaster(std::make_shared<const TriangleMesh>(composite_mesh)));
+        m_raycaster = std::make_shared<MeshRaycaster>(std::make_shared<const TriangleMesh>(composite_mesh));
         m_volumes_cache = volumes_cache;
+        m_measuring_cache.insert(m_measuring_cache.begin(), { volumes_cache, m_measuring, m_raycaster });
+        if (m_measuring_cache.size() > MeasuringCacheSize)
+            m_measuring_cache.pop_back();
     };
 
     const Selection& selection = m_parent.get_selection();
@@ -1102,7 +1116,8 @@ void GLGizmoMeasure::update_if_needed()
         const ModelVolume* vol = obj->volumes[volume_idx];
         const VolumeCacheItem item = {
             obj, inst, vol,
-            Geometry::translation_transform(selection.get_first_volume()->get_sla_shift_z() * Vec3d::UnitZ()) * inst->get_matrix() * vol->get_matrix()
+            Geometry::translation_transform(selection.get_first_volume()->get_sla_shift_z() * Vec3d::UnitZ()) * inst->get_matrix() * vol->get_matrix(),
+            vol->id(), vol->mesh_ptr()
         };
         volumes_cache.emplace_back(item);
     }
@@ -79,19 +79,34 @@ class GLGizmoMeasure : public GLGizmoBase
         const ModelInstance* instance{ nullptr };
         const ModelVolume* volume{ nullptr };
         Transform3d world_trafo;
+        // The mesh of a ModelVolume may be replaced while the ModelVolume is kept.
+        ObjectID volume_id;
+        std::weak_ptr<const TriangleMesh> mesh;
 
         bool operator == (const VolumeCacheItem& other) const {
             return this->object == other.object && this->instance == other.instance && this->volume == other.volume &&
+                this->volume_id == other.volume_id && ! this->mesh.owner_before(other.mesh) && ! other.mesh.owner_before(this->mesh) &&
                 this->world_trafo.isApprox(other.world_trafo);
         }
     };
 
     std::vector<VolumeCacheItem> m_volumes_cache;
 
+    // The surface features of the recently measured selections, most recent first. Reused when the gizmo
+    // is opened again or when the selection returns to one measured before, unless the meshes changed.
+    struct MeasuringCacheItem
+    {
+        std::vector<VolumeCacheItem> volumes;
+        std::shared_ptr<Measure::Measuring> measuring;
+        std::shared_ptr<MeshRaycaster> raycaster;
+    };
+    static constexpr const size_t MeasuringCacheSize = 3;
+    std::vector<MeasuringCacheItem> m_measuring_cache;
+
     EMode m_mode{ EMode::FeatureSelection };
     Measure::MeasurementResult m_measurement_result;
 
-    std::unique_ptr<Measure::Measuring> m_measuring; // PIMPL
+    std::shared_ptr<Measure::Measuring> m_measuring; // PIMPL
 
     PickingModel m_sphere;
     PickingModel m_cylinder;
@@ -107,7 +122,7 @@ class GLGizmoMeasure : public GLGizmoBase
 
     // Uses a standalone raycaster and not the shared one because of the
     // difference in how the mesh is updated
-    std::unique_ptr<MeshRaycaster> m_raycaster;
+    std::shared_ptr<MeshRaycaster> m_raycaster;
 
     std::vector<GLModel> m_plane_models_cache;
     std::map<int, std::shared_ptr<SceneRaycasterItem>> m_raycasters;
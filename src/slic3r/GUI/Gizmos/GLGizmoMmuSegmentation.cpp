@@ -595,10 +595,10 @@ void GLGizmoMmuSegmentation::init_model_triangle_selectors()
             continue;
 
         // This mesh does not account for the possible Z up SLA offset.
-        const TriangleMesh *mesh = &mv->mesh();
+        std::shared_ptr<const TriangleMesh> mesh = mv->mesh_ptr();
 
         const size_t extruder_idx = ModelVolume::get_extruder_color_idx(*mv, extruders_count);
-        m_triangle_selectors.emplace_back(std::make_unique<TriangleSelectorMmGui>(*mesh, m_modified_extruders_colors, m_original_extruders_colors[extruder_idx]));
+        m_triangle_selectors.emplace_back(std::make_unique<TriangleSelectorMmGui>(mesh, m_modified_extruders_colors, m_original_extruders_colors[extruder_idx]));
         // Reset of TriangleSelector is done inside TriangleSelectorMmGUI's constructor, so we don't need it to perform it again in deserialize().
         m_triangle_selectors.back()->deserialize(mv->mm_segmentation_facets.get_data(), false);
         m_triangle_selectors.back()->request_update_render_data();
@@ -39,6 +39,8 @@ class TriangleSelectorGUI : public TriangleSelector {
 public:
     explicit TriangleSelectorGUI(const TriangleMesh& mesh)
         : TriangleSelector(mesh) {}
+    explicit TriangleSelectorGUI(const std::shared_ptr<const TriangleMesh> &mesh)
+        : TriangleSelector(mesh) {}
     virtual ~TriangleSelectorGUI() = default;
 
     virtual void render(ImGuiWrapper* imgui, const Transform3d& matrix);
@@ -853,6 +853,12 @@ template<typename Fnc> TriangleMesh create_mesh_per_glyph(DataBase &input, Fnc w
     double depth = shape.projection.depth / shape.scale;
     auto scale_tr = Eigen::Scaling(shape.scale); 
     
+    // same glyphs are extruded only once, cache of font is kept between jobs
+    GlyphMeshes local_glyph_meshes;
+    GlyphMeshes *glyph_meshes = input.glyph_meshes();
+    if (glyph_meshes == nullptr)
+        glyph_meshes = &local_glyph_meshes;
+
     size_t s_i_offset = 0; // shape index offset(for next lines)
     indexed_triangle_set result;
     for (size_t text_line_index = 0; text_line_index < input.text_lines.size(); ++text_line_index) {
@@ -882,11 +888,9 @@ template<typename Fnc> TriangleMesh create_mesh_per_glyph(DataBase &input, Fnc w
             Eigen::Translation<double, 3> offset_tr(offset_vec.x(), 0., -offset_vec.y());
             Transform3d tr = offset_tr * rotate * to_zero * scale_tr;
 
-            const ExPolygons &letter_shape = shape.shapes_with_ids[s_i_offset + i].expoly;
-            assert(get_extents(letter_shape) == letter_bb);
-            auto projectZ = std::make_unique<ProjectZ>(depth);
-            ProjectTransform project(std::move(projectZ), tr);
-            indexed_triangle_set glyph_its = polygons2model(letter_shape, project);
+            const ExPolygonsWithId &letter = shape.shapes_with_ids[s_i_offset + i];
+            assert(get_extents(letter.expoly) == letter_bb);
+            indexed_triangle_set glyph_its = glyph2model(letter.expoly, static_cast<int>(letter.id), depth, tr, *glyph_meshes);
             its_merge(result, std::move(glyph_its));
 
             if (((s_i_offset + i) % 15) && was_canceled())
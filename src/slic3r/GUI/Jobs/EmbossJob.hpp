@@ -73,6 +73,12 @@ public:
     /// <returns>True on succes otherwise False(Per glyph shoud be disabled)</returns>
     virtual bool create_text_lines(const Transform3d& tr, const ModelVolumePtrs &vols) { return false; }
 
+    /// <summary>
+    /// Used only with text for embossing per glyph
+    /// </summary>
+    /// <returns>Cache of glyph meshes kept between jobs, nullptr when shape is not created from font</returns>
+    virtual Slic3r::Emboss::GlyphMeshes *glyph_meshes() { return nullptr; }
+
     // Define per letter projection on one text line
     // [optional] It is not used when empty
     Slic3r::Emboss::TextLines text_lines = {};
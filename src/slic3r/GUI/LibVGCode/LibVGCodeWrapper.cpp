@@ -192,30 +192,44 @@ GCodeInputData convert(const Slic3r::GCodeProcessorResult& result, const std::ve
     }
 
     const std::vector<Slic3r::GCodeProcessorResult::MoveVertex>& moves = result.moves;
-    ret.vertices.reserve(2 * moves.size());
+    // whether or not a 'phantom' vertex has to precede the vertex of the i-th move
+    auto needs_phantom_vertex = [&moves](size_t i) {
+        const Slic3r::GCodeProcessorResult::MoveVertex& curr = moves[i];
+        const Slic3r::GCodeProcessorResult::MoveVertex& prev = moves[i - 1];
+        const EOptionType option_type = move_type_to_option(convert(curr.type));
+        return (option_type == EOptionType::COUNT || option_type == EOptionType::Travels || option_type == EOptionType::Wipes) &&
+            (i == 1 || prev.type != curr.type || prev.extrusion_role != curr.extrusion_role);
+    };
+
+    // count the vertices first, the vertices may take gigabytes for large gcodes and reserving them for the worst case
+    // and shrinking afterwards would double the peak memory
+    size_t vertices_count = moves.empty() ? 0 : moves.size() - 1;
+    for (size_t i = 1; i < moves.size(); ++i) {
+        if (needs_phantom_vertex(i))
+            ++vertices_count;
+    }
+    ret.vertices.reserve(vertices_count);
+
     for (size_t i = 1; i < moves.size(); ++i) {
         const Slic3r::GCodeProcessorResult::MoveVertex& curr = moves[i];
         const Slic3r::GCodeProcessorResult::MoveVertex& prev = moves[i - 1];
         const EMoveType curr_type = convert(curr.type);
-        const EOptionType option_type = move_type_to_option(curr_type);
-        if (option_type == EOptionType::COUNT || option_type == EOptionType::Travels || option_type == EOptionType::Wipes) {
-            if (ret.vertices.empty() || prev.type != curr.type || prev.extrusion_role != curr.extrusion_role) {
-                // to allow libvgcode to properly detect the start/end of a path we need to add a 'phantom' vertex
-                // equal to the current one with the exception of the position, which should match the previous move position,
-                // and the times, which are set to zero
+        if (needs_phantom_vertex(i)) {
+            // to allow libvgcode to properly detect the start/end of a path we need to add a 'phantom' vertex
+            // equal to the current one with the exception of the position, which should match the previous move position,
+            // and the times, which are set to zero
 #if VGCODE_ENABLE_COG_AND_TOOL_MARKERS
-                const libvgcode::PathVertex vertex = { convert(prev.position), curr.height, curr.width, curr.feedrate, prev.actual_feedrate,
-                    curr.mm3_per_mm, curr.fan_speed, curr.temperature, 0.0f, convert(curr.extrusion_role), curr_type,
-                    static_cast<uint32_t>(curr.gcode_id), static_cast<uint32_t>(curr.layer_id),
-                    static_cast<uint8_t>(curr.extruder_id), static_cast<uint8_t>(curr.cp_color_id), { 0.0f, 0.0f } };
+            const libvgcode::PathVertex vertex = { convert(prev.position), curr.height, curr.width, curr.feedrate, prev.actual_feedrate,
+                curr.mm3_per_mm, curr.fan_speed, curr.temperature, 0.0f, convert(curr.extrusion_role), curr_type,
+                static_cast<uint32_t>(curr.gcode_id), static_cast<uint32_t>(curr.layer_id),
+                static_cast<uint8_t>(curr.extruder_id), static_cast<uint8_t>(curr.cp_color_id), { 0.0f, 0.0f } };
 #else
-              const libvgcode::PathVertex vertex = { convert(prev.position), curr.height, curr.width, curr.feedrate, prev.actual_feedrate,
-                    curr.mm3_per_mm, curr.fan_speed, curr.temperature, convert(curr.extrusion_role), curr_type,
-                    static_cast<uint32_t>(curr.gcode_id), static_cast<uint32_t>(curr.layer_id),
-                    static_cast<uint8_t>(curr.extruder_id), static_cast<uint8_t>(curr.cp_color_id), { 0.0f, 0.0f } };
+            const libvgcode::PathVertex vertex = { convert(prev.position), curr.height, curr.width, curr.feedrate, prev.actual_feedrate,
+                curr.mm3_per_mm, curr.fan_speed, curr.temperature, convert(curr.extrusion_role), curr_type,
+                static_cast<uint32_t>(curr.gcode_id), static_cast<uint32_t>(curr.layer_id),
+                static_cast<uint8_t>(curr.extruder_id), static_cast<uint8_t>(curr.cp_color_id), { 0.0f, 0.0f } };
 #endif // VGCODE_ENABLE_COG_AND_TOOL_MARKERS
-                ret.vertices.emplace_back(vertex);
-            }
+            ret.vertices.emplace_back(vertex);
         }
 
 #if VGCODE_ENABLE_COG_AND_TOOL_MARKERS
@@ -232,7 +246,7 @@ GCodeInputData convert(const Slic3r::GCodeProcessorResult& result, const std::ve
 #endif // VGCODE_ENABLE_COG_AND_TOOL_MARKERS
         ret.vertices.emplace_back(vertex);
     }
-    ret.vertices.shrink_to_fit();
+    assert(ret.vertices.size() == vertices_count);
 
     ret.spiral_vase_mode = result.spiral_vase_mode;
 
@@ -632,10 +646,45 @@ private:
     }
 };
 
+// Contours of the coarse slices of a dense object, shown until the toolpaths of the object are finished, see PrintObject::coarse_preview().
+static void convert_coarse_preview_to_vertices(const Slic3r::PrintObject& object, const Slic3r::PrintObject::CoarsePreview& preview,
+    const std::vector<std::string>& str_tool_colors, const std::vector<std::string>& str_color_print_colors,
+    const std::vector<Slic3r::CustomGCode::Item>& color_print_values, size_t extruders_count, VerticesData& data)
+{
+    ObjectHelper object_helper(color_print_values, str_tool_colors.size(), str_color_print_colors.size(), extruders_count);
+    const float width = static_cast<float>(object.print()->config().nozzle_diameter.get_at(0));
+    for (size_t i = 0; i < preview.print_z.size(); ++i) {
+        if (preview.slices[i].empty())
+            continue;
+        const float  layer_z  = static_cast<float>(preview.print_z[i]);
+        const size_t layer_id = data.layers_zs.size();
+        data.layers_zs.emplace_back(layer_z);
+        for (const Slic3r::PrintInstance& instance : object.instances())
+            for (const Slic3r::ExPolygon& expoly : preview.slices[i])
+                for (const Slic3r::Polygon& polygon : Slic3r::to_polygons(expoly)) {
+                    Slic3r::Polygon contour = polygon;
+                    contour.translate(instance.shift);
+                    const Slic3r::Lines lines = contour.lines();
+                    convert_lines_to_vertices(lines, std::vector<float>(lines.size(), width),
+                        std::vector<float>(lines.size(), static_cast<float>(preview.height[i])), layer_z, layer_id, 0,
+                        object_helper.color_id(layer_z, 0), EGCodeExtrusionRole::ExternalPerimeter, false, data.vertices);
+                }
+    }
+}
+
 static void convert_object_to_vertices(const Slic3r::PrintObject& object, const std::vector<std::string>& str_tool_colors,
     const std::vector<std::string>& str_color_print_colors, const std::vector<Slic3r::CustomGCode::Item>& color_print_values,
     size_t extruders_count, VerticesData& data)
 {
+    // The preliminary preview may be loaded while the background slicing is running, see SlicingStatus::RELOAD_FFF_PREVIEW.
+    // Only the objects with all the steps finished are safe to be read, the layers of the others may still be modified.
+    if (!object.is_step_done(Slic3r::posCalculateOverhangingPerimeters)) {
+        // The coarse preview is immutable, thus safe to be read while the object is being sliced.
+        if (std::shared_ptr<const Slic3r::PrintObject::CoarsePreview> preview = object.coarse_preview(); preview)
+            convert_coarse_preview_to_vertices(object, *preview, str_tool_colors, str_color_print_colors, color_print_values, extruders_count, data);
+        return;
+    }
+
     const bool has_perimeters = object.is_step_done(Slic3r::posPerimeters);
     const bool has_infill     = object.is_step_done(Slic3r::posInfill);
     const bool has_support    = object.is_step_done(Slic3r::posSupportMaterial);
@@ -742,7 +791,7 @@ GCodeInputData convert(const Slic3r::Print& print, const std::vector<std::string
     if (print.is_step_done(Slic3r::psSkirtBrim) && (print.has_skirt() || print.has_brim()))
         // extract vertices and layers zs from skirt/brim
         convert_brim_skirt_to_vertices(print, data);
-    if (!print.wipe_tower_data().tool_changes.empty() && print.is_step_done(Slic3r::psWipeTower))
+    if (print.is_step_done(Slic3r::psWipeTower) && !print.wipe_tower_data().tool_changes.empty())
         // extract vertices and layers zs from wipe tower
         convert_wipe_tower_to_vertices(print, str_tool_colors, data);
     // extract vertices and layers zs from objects
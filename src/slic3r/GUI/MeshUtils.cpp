@@ -22,6 +22,10 @@
 #include <igl/unproject.h>
 
 #include <cstdint>
+#include <numeric>
+
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
 
 
 namespace Slic3r {
@@ -218,6 +222,73 @@ std::vector<Vec3d> MeshClipper::point_per_contour() const
 }
 
 
+indexed_triangle_set MeshClipper::PlaneIntervals::crossing(const indexed_triangle_set &mesh, const Vec3d &normal, double height)
+{
+    if (m_mesh != &mesh || m_vertices_data != mesh.vertices.data() || m_indices_data != mesh.indices.data() ||
+        m_num_vertices != mesh.vertices.size() || m_num_indices != mesh.indices.size() || m_normal != normal) {
+        m_mesh          = &mesh;
+        m_vertices_data = mesh.vertices.data();
+        m_indices_data  = mesh.indices.data();
+        m_num_vertices  = mesh.vertices.size();
+        m_num_indices   = mesh.indices.size();
+        m_normal        = normal;
+        std::vector<float> vertex_z(mesh.vertices.size());
+        for (size_t i = 0; i < mesh.vertices.size(); ++ i)
+            vertex_z[i] = float(normal.dot(mesh.vertices[i].cast<double>()));
+        m_face_min.resize(mesh.indices.size());
+        m_face_max.resize(mesh.indices.size());
+        for (size_t i = 0; i < mesh.indices.size(); ++ i) {
+            const stl_triangle_vertex_indices &face = mesh.indices[i];
+            m_face_min[i] = std::min(vertex_z[face(0)], std::min(vertex_z[face(1)], vertex_z[face(2)]));
+            m_face_max[i] = std::max(vertex_z[face(0)], std::max(vertex_z[face(1)], vertex_z[face(2)]));
+        }
+        m_by_min.resize(mesh.indices.size());
+        std::iota(m_by_min.begin(), m_by_min.end(), 0);
+        m_by_max = m_by_min;
+        std::sort(m_by_min.begin(), m_by_min.end(), [this](int l, int r) { return m_face_min[l] < m_face_min[r]; });
+        std::sort(m_by_max.begin(), m_by_max.end(), [this](int l, int r) { return m_face_max[l] < m_face_max[r]; });
+        m_vertex_map.assign(mesh.vertices.size(), -1);
+    }
+
+    // The triangles are selected conservatively, the slicer decides which of them are really crossing the plane.
+    const float z_min = float(height) - 0.01f;
+    const float z_max = float(height) + 0.01f;
+    // Triangles starting below the plane, triangles ending above the plane. The crossing triangles belong to both sets,
+    // the smaller one is traversed.
+    const auto below_end   = std::upper_bound(m_by_min.begin(), m_by_min.end(), z_max, [this](float z, int face) { return z < m_face_min[face]; });
+    const auto above_begin = std::lower_bound(m_by_max.begin(), m_by_max.end(), z_min, [this](int face, float z) { return m_face_max[face] < z; });
+    std::vector<int> faces;
+    if (below_end - m_by_min.begin() < m_by_max.end() - above_begin) {
+        for (auto it = m_by_min.begin(); it != below_end; ++ it)
+            if (m_face_max[*it] >= z_min)
+                faces.emplace_back(*it);
+    } else {
+        for (auto it = above_begin; it != m_by_max.end(); ++ it)
+            if (m_face_min[*it] <= z_max)
+                faces.emplace_back(*it);
+    }
+    // Keep the order of the source mesh, so that the contours are chained the same way as when slicing the whole mesh.
+    std::sort(faces.begin(), faces.end());
+
+    indexed_triangle_set out;
+    out.indices.reserve(faces.size());
+    for (int face : faces) {
+        stl_triangle_vertex_indices &new_face = out.indices.emplace_back();
+        for (int j = 0; j < 3; ++ j) {
+            int &vertex = m_vertex_map[mesh.indices[face](j)];
+            if (vertex == -1) {
+                vertex = int(out.vertices.size());
+                out.vertices.emplace_back(mesh.vertices[mesh.indices[face](j)]);
+            }
+            new_face(j) = vertex;
+        }
+    }
+    for (int face : faces)
+        for (int j = 0; j < 3; ++ j)
+            m_vertex_map[mesh.indices[face](j)] = -1;
+    return out;
+}
+
 void MeshClipper::recalculate_triangles()
 {
     m_result = ClipResult();
@@ -234,10 +305,10 @@ void MeshClipper::recalculate_triangles()
 
     if (m_csgmesh.empty()) {
         if (m_mesh)
-            expolys = union_ex(slice_mesh(*m_mesh, height_mesh, slicing_params));
+            expolys = union_ex(slice_mesh(m_mesh_intervals.crossing(*m_mesh, up, height_mesh), height_mesh, slicing_params));
 
         if (m_negative_mesh && !m_negative_mesh->empty()) {
-            const ExPolygons neg_expolys = union_ex(slice_mesh(*m_negative_mesh, height_mesh, slicing_params));
+            const ExPolygons neg_expolys = union_ex(slice_mesh(m_negative_mesh_intervals.crossing(*m_negative_mesh, up, height_mesh), height_mesh, slicing_params));
             expolys = diff_ex(expolys, neg_expolys);
         }
     } else {
@@ -312,16 +383,65 @@ void MeshClipper::recalculate_triangles()
     tr2.pretranslate(0.002 * m_plane.get_normal().normalized());
 
 
-    std::vector<Vec2f> triangles2d;
+    // Triangulate the cuts and the contours of the islands in parallel, the OpenGL models are initialized on this thread.
+    struct IslandTriangles {
+        std::vector<Vec2f> cut;
+        std::vector<Vec2f> contour;
+    };
+    std::vector<IslandTriangles> islands_triangles(expolys.size());
+    const bool flip = m_trafo.get_matrix().matrix().determinant() < 0.;
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, expolys.size()), [this, &expolys, &islands_triangles, &tr, flip](const tbb::blocked_range<size_t> &range) {
+        for (size_t island_idx = range.begin(); island_idx < range.end(); ++ island_idx) {
+            const ExPolygon &exp = expolys[island_idx];
+            if (m_fill_cut)
+                islands_triangles[island_idx].cut = triangulate_expolygon_2f(exp, flip);
+
+            if (m_contour_width != 0. && ! exp.contour.empty()) {
+                // The contours must not scale with the object. Check the scale factor
+                // in the respective directions, create a scaled copy of the ExPolygon
+                // offset it and then unscale the result again.
+
+                Transform3d t = tr;
+                t.translation() = Vec3d::Zero();
+                double scale_x = (t * Vec3d::UnitX()).norm();
+                double scale_y = (t * Vec3d::UnitY()).norm();
+
+                // To prevent overflow after scaling, downscale the input if needed:
+                double extra_scale = 1.;
+                int32_t limit = int32_t(std::min(std::numeric_limits<coord_t>::max() / (2. * std::max(1., scale_x)), std::numeric_limits<coord_t>::max() / (2. * std::max(1., scale_y))));
+                int32_t max_coord = 0;
+                for (const Point& pt : exp.contour)
+                    max_coord = std::max(max_coord, std::max(std::abs(pt.x()), std::abs(pt.y())));
+                if (max_coord + m_contour_width >= limit)
+                    extra_scale = 0.9 * double(limit) / max_coord;
+
+                ExPolygon exp_copy = exp;
+                if (extra_scale != 1.)
+                    exp_copy.scale(extra_scale);
+                exp_copy.scale(scale_x, scale_y);
+
+                ExPolygons expolys_exp = offset_ex(exp_copy, scale_(m_contour_width));
+                expolys_exp = diff_ex(expolys_exp, ExPolygons({exp_copy}));
+
+                for (ExPolygon& e : expolys_exp) {
+                    e.scale(1./scale_x, 1./scale_y);
+                    if (extra_scale != 1.)
+                        e.scale(1./extra_scale);
+                }
+
+                islands_triangles[island_idx].contour = triangulate_expolygons_2f(expolys_exp, flip);
+            }
+        }
+    });
 
-    for (const ExPolygon& exp : expolys) {
-        triangles2d.clear();
+    for (size_t island_idx = 0; island_idx < expolys.size(); ++ island_idx) {
+        ExPolygon &exp = expolys[island_idx];
 
         m_result->cut_islands.push_back(CutIsland());
         CutIsland& isl = m_result->cut_islands.back();
 
         if (m_fill_cut) {
-            triangles2d = triangulate_expolygon_2f(exp, m_trafo.get_matrix().matrix().determinant() < 0.);
+            const std::vector<Vec2f> &triangles2d = islands_triangles[island_idx].cut;
             GLModel::Geometry init_data;
             init_data.format = { GLModel::Geometry::EPrimitiveType::Triangles, GLModel::Geometry::EVertexLayout::P3N3 };
             init_data.reserve_vertices(triangles2d.size());
@@ -341,42 +461,7 @@ void MeshClipper::recalculate_triangles()
         }
 
         if (m_contour_width != 0. && ! exp.contour.empty()) {
-            triangles2d.clear();
-
-            // The contours must not scale with the object. Check the scale factor
-            // in the respective directions, create a scaled copy of the ExPolygon
-            // offset it and then unscale the result again.
-
-            Transform3d t = tr;
-            t.translation() = Vec3d::Zero();
-            double scale_x = (t * Vec3d::UnitX()).norm();
-            double scale_y = (t * Vec3d::UnitY()).norm();
-
-            // To prevent overflow after scaling, downscale the input if needed:
-            double extra_scale = 1.;
-            int32_t limit = int32_t(std::min(std::numeric_limits<coord_t>::max() / (2. * std::max(1., scale_x)), std::numeric_limits<coord_t>::max() / (2. * std::max(1., scale_y))));
-            int32_t max_coord = 0;
-            for (const Point& pt : exp.contour)
-                max_coord = std::max(max_coord, std::max(std::abs(pt.x()), std::abs(pt.y())));
-            if (max_coord + m_contour_width >= limit)
-                extra_scale = 0.9 * double(limit) / max_coord;
-
-            ExPolygon exp_copy = exp;
-            if (extra_scale != 1.)
-                exp_copy.scale(extra_scale);
-            exp_copy.scale(scale_x, scale_y);
-
-            ExPolygons expolys_exp = offset_ex(exp_copy, scale_(m_contour_width));
-            expolys_exp = diff_ex(expolys_exp, ExPolygons({exp_copy}));
-
-            for (ExPolygon& e : expolys_exp) {
-                e.scale(1./scale_x, 1./scale_y);
-                if (extra_scale != 1.)
-                    e.scale(1./extra_scale);
-            }
-
-
-            triangles2d = triangulate_expolygons_2f(expolys_exp, m_trafo.get_matrix().matrix().determinant() < 0.);
+            const std::vector<Vec2f> &triangles2d = islands_triangles[island_idx].contour;
             GLModel::Geometry init_data = GLModel::Geometry();
             init_data.format = { GLModel::Geometry::EPrimitiveType::Triangles, GLModel::Geometry::EVertexLayout::P3N3 };
             init_data.reserve_vertices(triangles2d.size());
@@ -131,9 +131,36 @@ public:
 private:
     void recalculate_triangles();
 
+    // Triangles of a mesh ordered by their extents along the normal of the cutting plane in mesh coordinates.
+    // While the cutting plane is moved along its normal, only the triangles crossing the plane are sliced.
+    class PlaneIntervals {
+    public:
+        // Triangles of mesh crossing the plane with the given normal at the given height, sharing their vertices.
+        // The intervals are rebuilt if the mesh or the normal changed since the last call.
+        indexed_triangle_set crossing(const indexed_triangle_set &mesh, const Vec3d &normal, double height);
+
+    private:
+        const indexed_triangle_set *m_mesh { nullptr };
+        const stl_vertex           *m_vertices_data { nullptr };
+        const stl_triangle_vertex_indices *m_indices_data { nullptr };
+        size_t                      m_num_vertices { 0 };
+        size_t                      m_num_indices { 0 };
+        Vec3d                       m_normal { Vec3d::Zero() };
+        // Extents of the triangles along m_normal.
+        std::vector<float>          m_face_min;
+        std::vector<float>          m_face_max;
+        // Triangle indices sorted by m_face_min, by m_face_max.
+        std::vector<int>            m_by_min;
+        std::vector<int>            m_by_max;
+        // Map of the vertices of mesh to the vertices of the crossing triangles, reset to -1 after each use.
+        std::vector<int>            m_vertex_map;
+    };
+
     Geometry::Transformation m_trafo;
     AnyPtr<const indexed_triangle_set> m_mesh;
     AnyPtr<const indexed_triangle_set> m_negative_mesh;
+    PlaneIntervals m_mesh_intervals;
+    PlaneIntervals m_negative_mesh_intervals;
     std::vector<csg::CSGPart> m_csgmesh;
 
     ClippingPlane m_plane;
@@ -164,7 +191,7 @@ class MeshRaycaster {
 public:
     explicit MeshRaycaster(std::shared_ptr<const TriangleMesh> mesh)
         : m_mesh(std::move(mesh))
-        , m_emesh(*m_mesh, true) // calculate epsilon for triangle-ray intersection from an average edge length
+        , m_emesh(m_mesh, true) // calculate epsilon for triangle-ray intersection from an average edge length
         , m_normals(its_face_normals(m_mesh->its))
     {
         assert(m_mesh);
@@ -191,6 +218,8 @@ public:
     ) const;
     
     const AABBMesh &get_aabb_mesh() const { return m_emesh; }
+    // Bounding box of the mesh, in mesh coords.
+    BoundingBoxf3 get_bounding_box() const { return m_mesh->bounding_box(); }
 
     // Given a point and direction in world coords, returns whether the respective line
     // intersects the mesh if it is transformed into world by trafo.
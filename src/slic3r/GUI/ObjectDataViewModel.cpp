@@ -405,6 +405,76 @@ void ObjectDataViewModel::UpdateBitmapForNode(ObjectDataViewModelNode* node, con
     UpdateBitmapForNode(node);
 }
 
+void ObjectDataViewModel::BeginBatchUpdate()
+{
+    ++m_batch_update_level;
+}
+
+void ObjectDataViewModel::EndBatchUpdate()
+{
+    assert(m_batch_update_level > 0);
+    if (--m_batch_update_level > 0)
+        return;
+
+    if (m_batch_deleted)
+        // Some of the added nodes may be deleted already, reload the whole control.
+        Cleared();
+    else {
+        // Notify the control about the added subtrees, grouped by their parents.
+        // The children of the added items are requested by the control on demand.
+        while (!m_batch_added.empty()) {
+            ObjectDataViewModelNode* parent = m_batch_added.front()->GetParent();
+            wxDataViewItemArray items;
+            m_batch_added.erase(std::remove_if(m_batch_added.begin(), m_batch_added.end(), [parent, &items](ObjectDataViewModelNode* node) {
+                if (node->GetParent() != parent)
+                    return false;
+                items.Add(wxDataViewItem((void*)node));
+                return true;
+            }), m_batch_added.end());
+            wxDataViewModel::ItemsAdded(wxDataViewItem((void*)parent), items);
+        }
+    }
+    m_batch_added.clear();
+    m_batch_deleted = false;
+}
+
+bool ObjectDataViewModel::IsAddedInBatch(ObjectDataViewModelNode* node) const
+{
+    for (; node != nullptr; node = node->GetParent())
+        if (std::find(m_batch_added.begin(), m_batch_added.end(), node) != m_batch_added.end())
+            return true;
+    return false;
+}
+
+bool ObjectDataViewModel::ItemAdded(const wxDataViewItem &parent, const wxDataViewItem &item)
+{
+    if (!IsBatchUpdate())
+        return wxDataViewModel::ItemAdded(parent, item);
+
+    ObjectDataViewModelNode* node = static_cast<ObjectDataViewModelNode*>(item.GetID());
+    if (!m_batch_deleted && !IsAddedInBatch(node->GetParent()))
+        m_batch_added.emplace_back(node);
+    return true;
+}
+
+bool ObjectDataViewModel::ItemDeleted(const wxDataViewItem &parent, const wxDataViewItem &item)
+{
+    if (!IsBatchUpdate())
+        return wxDataViewModel::ItemDeleted(parent, item);
+
+    // The deleted node may be one of the added nodes or their parent, it is not safe to access the added nodes anymore.
+    m_batch_deleted = true;
+    return true;
+}
+
+bool ObjectDataViewModel::ItemChanged(const wxDataViewItem &item)
+{
+    // The control does not know the nodes added during the batch update, it will request their values once notified.
+    if (IsBatchUpdate() && (m_batch_deleted || IsAddedInBatch(static_cast<ObjectDataViewModelNode*>(item.GetID()))))
+        return true;
+    return wxDataViewModel::ItemChanged(item);
+}
+
 wxDataViewItem ObjectDataViewModel::AddObject(const wxString &name, 
                                         const wxString& extruder,
                                         const std::string& warning_icon_name,
@@ -282,6 +282,13 @@ class ObjectDataViewModel :public wxDataViewModel
 
     wxDataViewCtrl*                             m_ctrl { nullptr };
 
+    // Batch update, see BeginBatchUpdate().
+    int                                         m_batch_update_level { 0 };
+    // Roots of the subtrees added during the batch update, the control was not notified about them yet.
+    std::vector<ObjectDataViewModelNode*>       m_batch_added;
+    // An item was deleted during the batch update, the control will be reloaded completely.
+    bool                                        m_batch_deleted { false };
+
 public:
     ObjectDataViewModel();
     ~ObjectDataViewModel();
@@ -402,6 +409,20 @@ public:
     wxDataViewItem SetObjectPrintableState(PrintIndicator printable, wxDataViewItem obj_item);
 
     void    SetAssociatedControl(wxDataViewCtrl* ctrl) { m_ctrl = ctrl; }
+
+    // Batch update: The control is not notified about the items added during the batch, only about the top most ones
+    // at EndBatchUpdate() in one go. The children of the added items are requested by the control once they are expanded,
+    // thus loading of a project with thousands of objects does not create the control items for all the volumes,
+    // instances and settings. If an item was deleted during the batch, the whole control is reloaded by Cleared().
+    void    BeginBatchUpdate();
+    void    EndBatchUpdate();
+    bool    IsBatchUpdate() const { return m_batch_update_level > 0; }
+
+    // Notifications of the associated control, postponed during a batch update.
+    // They hide the wxDataViewModel methods of the same name.
+    bool    ItemAdded(const wxDataViewItem &parent, const wxDataViewItem &item);
+    bool    ItemDeleted(const wxDataViewItem &parent, const wxDataViewItem &item);
+    bool    ItemChanged(const wxDataViewItem &item);
     // Rescale bitmaps for existing Items 
     void    UpdateBitmaps();
 
@@ -421,6 +442,8 @@ private:
     wxDataViewItem  AddRoot(const wxDataViewItem& parent_item, const ItemType root_type);
     wxDataViewItem  AddInstanceRoot(const wxDataViewItem& parent_item);
     void            AddAllChildren(const wxDataViewItem& parent);
+    // Was the control notified about this node already?
+    bool            IsAddedInBatch(ObjectDataViewModelNode* node) const;
 
     void            UpdateBitmapForNode(ObjectDataViewModelNode* node);
     void            UpdateBitmapForNode(ObjectDataViewModelNode* node, const std::string& warning_icon_name, bool has_lock);
@@ -79,6 +79,7 @@
 #include "libslic3r/ModelProcessing.hpp"
 #include "libslic3r/FileReader.hpp"
 #include "libslic3r/MultipleBeds.hpp"
+#include "libslic3r/Trace.hpp"
 
 // For stl export
 #include "libslic3r/CSGMesh/ModelToCSGMesh.hpp"
@@ -113,6 +114,7 @@
 #include "Jobs/PlaterWorker.hpp"
 #include "Jobs/BoostThreadWorker.hpp"
 #include "BackgroundSlicingProcess.hpp"
+#include "SpeculativeSlicingProcess.hpp"
 #include "PrintHostDialogs.hpp"
 #include "../Utils/ASCIIFolding.hpp"
 #include "../Utils/PrintHost.hpp"
@@ -175,6 +177,8 @@ wxDEFINE_EVENT(EVT_SLICING_UPDATE,                  SlicingStatusEvent);
 wxDEFINE_EVENT(EVT_SLICING_COMPLETED,               wxCommandEvent);
 // BackgroundSlicingProcess finished either with success or error.
 wxDEFINE_EVENT(EVT_PROCESS_COMPLETED,               SlicingProcessCompletedEvent);
+// SpeculativeSlicingProcess exported G-code of an inactive bed, the index of the bed is passed as the event's int.
+wxDEFINE_EVENT(EVT_SPECULATIVE_SLICING_COMPLETED,   wxCommandEvent);
 wxDEFINE_EVENT(EVT_EXPORT_BEGAN,                    wxCommandEvent);
 wxDEFINE_EVENT(EVT_REGENERATE_BED_THUMBNAILS, SimpleEvent);
 
@@ -296,6 +300,8 @@ struct Plater::priv
     ProjectDirtyStateManager dirty_state;
      
     BackgroundSlicingProcess    background_process;
+    // Slices the inactive beds while the active one is processed by the background_process.
+    SpeculativeSlicingProcess   speculative_process;
     bool suppressed_backround_processing_update { false };
 
     // TODO: A mechanism would be useful for blocking the plater interactions:
@@ -496,6 +502,8 @@ struct Plater::priv
     };
     // returns bit mask of UpdateBackgroundProcessReturnState
     unsigned int update_background_process(bool force_validation = false, bool postpone_error_messages = false);
+    // Schedule the slicing of the inactive beds, to be called once the Prints were applied and validated.
+    void update_speculative_slicing(const std::vector<Print::ApplyStatus> &apply_statuses);
     // Restart background processing thread based on a bitmask of UpdateBackgroundProcessReturnState.
     bool restart_background_process(unsigned int state);
     // returns bit mask of UpdateBackgroundProcessReturnState
@@ -517,6 +525,7 @@ struct Plater::priv
     void on_slicing_update(SlicingStatusEvent&);
     void on_slicing_completed(wxCommandEvent&);
     void on_process_completed(SlicingProcessCompletedEvent&);
+    void on_speculative_slicing_completed(wxCommandEvent&);
 	void on_export_began(wxCommandEvent&);
     void on_layer_editing_toggled(bool enable);
 	void on_slicing_began();
@@ -569,7 +578,8 @@ struct Plater::priv
     bool can_scale_to_print_volume() const;
 
     void generate_thumbnail(ThumbnailData& data, unsigned int w, unsigned int h, const ThumbnailsParams& thumbnail_params, Camera::EType camera_type);
-    ThumbnailsList generate_thumbnails(const ThumbnailsParams& params, Camera::EType camera_type);
+    // Renders the thumbnails of the active bed if bed_idx is negative.
+    ThumbnailsList generate_thumbnails(const ThumbnailsParams& params, Camera::EType camera_type, int bed_idx = -1);
     void regenerate_thumbnails(SimpleEvent&);
 
     void bring_instance_forward() const;
@@ -660,6 +670,8 @@ void Plater::priv::init()
     background_process.set_slicing_completed_event(EVT_SLICING_COMPLETED);
     background_process.set_finished_event(EVT_PROCESS_COMPLETED);
     background_process.set_export_began_event(EVT_EXPORT_BEGAN);
+    speculative_process.set_thumbnail_cb([this](const ThumbnailsParams& params, int bed_idx) { return this->generate_thumbnails(params, Camera::EType::Ortho, bed_idx); });
+    speculative_process.set_finished_event(EVT_SPECULATIVE_SLICING_COMPLETED);
     // Default printer technology for default config.
     background_process.select_technology(this->printer_technology);
     // Register progress callback from the Print class to the Plater.
@@ -669,6 +681,7 @@ void Plater::priv::init()
     };
     std::for_each(fff_prints.begin(), fff_prints.end(), [statuscb](std::unique_ptr<Print>& p)    { p->set_status_callback(statuscb); });
     std::for_each(sla_prints.begin(), sla_prints.end(), [statuscb](std::unique_ptr<SLAPrint>& p) { p->set_status_callback(statuscb); });
+    speculative_process.set_status_callback(statuscb);
     this->q->Bind(EVT_SLICING_UPDATE, &priv::on_slicing_update, this);
 
     view3D = new View3D(q, bed, &model, config, &background_process);
@@ -773,6 +786,7 @@ void Plater::priv::init()
     if (wxGetApp().is_editor()) {
         q->Bind(EVT_SLICING_COMPLETED, &priv::on_slicing_completed, this);
         q->Bind(EVT_PROCESS_COMPLETED, &priv::on_process_completed, this);
+        q->Bind(EVT_SPECULATIVE_SLICING_COMPLETED, &priv::on_speculative_slicing_completed, this);
         q->Bind(EVT_EXPORT_BEGAN, &priv::on_export_began, this);
         q->Bind(EVT_GLVIEWTOOLBAR_3D, [this](SimpleEvent&) { q->select_view_3D("3D"); });
         q->Bind(EVT_GLVIEWTOOLBAR_PREVIEW, [this](SimpleEvent&) { q->select_view_3D("Preview"); });
@@ -1209,6 +1223,14 @@ void Plater::priv::update_ui_from_settings()
 {
     apply_free_camera_correction();
 
+    // The performance overlay of GLCanvas3D shows the slicing steps recorded by Trace.
+    if (const bool show_performance_overlay = get_config_bool("show_performance_overlay"); show_performance_overlay != Trace::enabled()) {
+        if (show_performance_overlay)
+            Trace::start();
+        else
+            Trace::stop();
+    }
+
     view3D->get_canvas3d()->update_ui_from_settings();
     preview->get_canvas3d()->update_ui_from_settings();
 
@@ -1739,9 +1761,7 @@ std::vector<size_t> Plater::priv::load_model_objects(const ModelObjectPtrs& mode
     }
 
     notification_manager->close_notification_of_type(NotificationType::UpdatedItemsInfo);
-    for (const size_t idx : obj_idxs) {
-        wxGetApp().obj_list()->add_object_to_list(idx, call_selection_changed);
-    }
+    wxGetApp().obj_list()->add_objects_to_list(obj_idxs, call_selection_changed);
 
     if (call_selection_changed) {
         update();
@@ -2026,6 +2046,7 @@ void Plater::priv::delete_all_objects_from_model()
     m_worker.cancel_all();
 
     // Stop and reset the Print content.
+    speculative_process.stop();
     background_process.reset();
     model.clear_objects();
     update();
@@ -2057,6 +2078,7 @@ void Plater::priv::reset()
     m_worker.cancel_all();
 
     // Stop and reset the Print content.
+    this->speculative_process.stop();
     this->background_process.reset();
     model.clear_objects();
     update();
@@ -2291,13 +2313,40 @@ void Plater::priv::regenerate_thumbnails(SimpleEvent&) {
 
 // Update background processing thread from the current config and Model.
 // Returns a bitmask of UpdateBackgroundProcessReturnState.
+void Plater::priv::update_speculative_slicing(const std::vector<Print::ApplyStatus> &apply_statuses)
+{
+    if (printer_technology != ptFFF || ! background_processing_enabled() || ! get_config_bool("speculative_slicing")) {
+        speculative_process.stop();
+        return;
+    }
+
+    const int active_bed = s_multiple_beds.get_active_bed();
+    const int num_beds   = s_multiple_beds.get_number_of_beds();
+    std::vector<SpeculativeSlicingProcess::Job> jobs;
+    // Slice the beds following the active one first, the user is likely to switch to them next.
+    for (int i = 1; i < num_beds; ++ i) {
+        const int bed_idx = (active_bed + i) % num_beds;
+        Print *print = fff_prints[bed_idx].get();
+        if (apply_statuses[bed_idx] != Print::APPLY_STATUS_UNCHANGED)
+            speculative_process.invalidate(print);
+        if (! print->empty() && is_sliceable(s_print_statuses[bed_idx]) && ! print->finished())
+            jobs.push_back({ print, &gcode_results[bed_idx], bed_idx, BackgroundSlicingProcess::temp_output_path(bed_idx) });
+    }
+    speculative_process.schedule(std::move(jobs));
+}
+
 unsigned int Plater::priv::update_background_process(bool force_validation, bool postpone_error_messages)
 {
 //    assert(! s_beds_just_switched || background_process.idle());
 
     int active_bed = s_multiple_beds.get_active_bed();
+    // Take the Print of the active bed over from the speculative slicing, keeping the steps it finished.
+    speculative_process.release(&q->active_fff_print());
     background_process.set_temp_output_path(active_bed);
     background_process.set_fff_print(&q->active_fff_print());
+    // The coarse preview is only shown for the active bed, the inactive beds are not previewed while being sliced.
+    for (size_t bed_idx = 0; bed_idx < fff_prints.size(); ++ bed_idx)
+        fff_prints[bed_idx]->set_coarse_preview_triangles(int(bed_idx) == active_bed && get_config_bool("coarse_preview_slicing") ? 1000000 : 0);
     background_process.set_sla_print(&q->active_sla_print());
     background_process.set_gcode_result(&gcode_results[active_bed]);
     background_process.select_technology(this->printer_technology);
@@ -2411,6 +2460,8 @@ unsigned int Plater::priv::update_background_process(bool force_validation, bool
         this->show_autoslicing_action_buttons();
     }
 
+    this->update_speculative_slicing(apply_statuses);
+
     // If current bed was invalidated, update thumbnails for all beds:
     if (any_status_changed) {
         wxQueueEvent(this->q, new SimpleEvent(EVT_REGENERATE_BED_THUMBNAILS));
@@ -3229,6 +3280,9 @@ void Plater::priv::on_slicing_update(SlicingStatusEvent &evt)
     } else if (evt.status.flags & PrintBase::SlicingStatus::RELOAD_SLA_PREVIEW) {
         // Update the SLA preview. Only called if not RELOAD_SLA_SUPPORT_POINTS, as the block above will refresh the preview anyways.
         this->preview->reload_print();
+    } else if ((evt.status.flags & PrintBase::SlicingStatus::RELOAD_FFF_PREVIEW) && this->printer_technology == ptFFF) {
+        // Some PrintObject finished its toolpaths, show them in the preliminary preview before the whole print is sliced.
+        this->preview->reload_print();
     }
 
 
@@ -3311,6 +3365,16 @@ void Plater::priv::on_slicing_completed(wxCommandEvent & evt)
     }
 }
 
+void Plater::priv::on_speculative_slicing_completed(wxCommandEvent &evt)
+{
+    if (this->printer_technology != ptFFF || evt.GetInt() == s_multiple_beds.get_active_bed())
+        return;
+    // The bed selector and the autoslicing view show which of the beds are sliced.
+    this->show_autoslicing_action_buttons();
+    view3D->get_canvas3d()->set_as_dirty();
+    view3D->get_canvas3d()->request_extra_frame();
+}
+
 void Plater::priv::on_export_began(wxCommandEvent& evt)
 {
 	if (show_warning_dialog)
@@ -3596,9 +3660,9 @@ void Plater::priv::generate_thumbnail(ThumbnailData& data, unsigned int w, unsig
     view3D->get_canvas3d()->render_thumbnail(data, w, h, thumbnail_params, camera_type);
 }
 
-ThumbnailsList Plater::priv::generate_thumbnails(const ThumbnailsParams& params, Camera::EType camera_type)
+ThumbnailsList Plater::priv::generate_thumbnails(const ThumbnailsParams& params, Camera::EType camera_type, int bed_idx)
 {
-    s_multiple_beds.set_thumbnail_bed_idx(s_multiple_beds.get_active_bed());
+    s_multiple_beds.set_thumbnail_bed_idx(bed_idx < 0 ? s_multiple_beds.get_active_bed() : bed_idx);
     ScopeGuard guard([]() { s_multiple_beds.set_thumbnail_bed_idx(-1); });
     ThumbnailsList thumbnails;
     for (const Vec2d& size : params.sizes) {
@@ -4526,28 +4590,32 @@ void Plater::load_gcode(const wxString& filename)
 
     wxBusyCursor wait;
 
-    // process gcode
-    GCodeProcessor processor;
-    try
-    {
-        p->notification_manager->push_download_progress_notification("Loading...", []() { return false; });
-        processor.process_file(filename.ToUTF8().data(), [this](float value) {
-            p->notification_manager->set_download_progress_percentage(value);
-            static auto clock = std::chrono::steady_clock();
-            static auto old_t = clock.now();
-            auto t = clock.now();
-            if (std::chrono::duration_cast<std::chrono::milliseconds>(t - old_t).count() > 200) {
-                p->get_current_canvas3D()->render();
-                old_t = t;
-            }
-        });
-    }
-    catch (const std::exception& ex)
-    {
-        show_error(this, ex.what());
-        return;
+    // process gcode, unless it was processed before
+    const std::string filename_u8 = filename.ToUTF8().data();
+    if (! GCodeProcessor::load_result_from_cache(filename_u8, p->gcode_results.front())) {
+        GCodeProcessor processor;
+        try
+        {
+            p->notification_manager->push_download_progress_notification("Loading...", []() { return false; });
+            processor.process_file(filename_u8, [this](float value) {
+                p->notification_manager->set_download_progress_percentage(value);
+                static auto clock = std::chrono::steady_clock();
+                static auto old_t = clock.now();
+                auto t = clock.now();
+                if (std::chrono::duration_cast<std::chrono::milliseconds>(t - old_t).count() > 200) {
+                    p->get_current_canvas3D()->render();
+                    old_t = t;
+                }
+            });
+        }
+        catch (const std::exception& ex)
+        {
+            show_error(this, ex.what());
+            return;
+        }
+        p->gcode_results.front() = std::move(processor.extract_result());
+        GCodeProcessor::store_result_to_cache(filename_u8, p->gcode_results.front());
     }
-    p->gcode_results.front() = std::move(processor.extract_result());
 
     // show results
     try
@@ -5900,6 +5968,7 @@ void Plater::with_mocked_fff_background_process(
     const int bed_index,
     const std::function<void()> &callable
 ) {
+    this->p->speculative_process.release(&print);
     Print *original_print{&active_fff_print()};
     GCodeProcessorResult *original_result{this->p->background_process.get_gcode_result()};
     const int original_bed{s_multiple_beds.get_active_bed()};
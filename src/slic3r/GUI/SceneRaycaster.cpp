@@ -6,6 +6,7 @@
 #include "SceneRaycaster.hpp"
 
 #include "Camera.hpp"
+#include "CameraUtils.hpp"
 #include "GUI_App.hpp"
 #include "Selection.hpp"
 #include "Plater.hpp"
@@ -15,6 +16,58 @@
 namespace Slic3r {
 namespace GUI {
 
+// Below this number of items of one type, testing all of them is cheaper than keeping the items tree up to date.
+static constexpr const size_t ItemsTreeMinItems = 16;
+
+namespace {
+
+// Wraps the world bounding box of a SceneRaycasterItem to be passed to AABBTreeIndirect::Tree::build().
+class ItemBoundingBox
+{
+public:
+    using BoundingBox = Eigen::AlignedBox<double, 3>;
+    ItemBoundingBox(size_t idx, const BoundingBoxf3& bbox) :
+        m_idx(idx),
+        // Inflate the bounding box a bit to account for numerical issues.
+        m_bbox(bbox.min - Vec3d(EPSILON, EPSILON, EPSILON), bbox.max + Vec3d(EPSILON, EPSILON, EPSILON)) {}
+    size_t             idx() const { return m_idx; }
+    const BoundingBox& bbox() const { return m_bbox; }
+    Vec3d              centroid() const { return m_bbox.center(); }
+private:
+    size_t             m_idx;
+    BoundingBox        m_bbox;
+};
+
+// Predicate for AABBTreeIndirect::traverse() accepting the nodes whose bounding box is intersected by a line.
+struct IntersectingLine
+{
+    Vec3d point;
+    Vec3d direction;
+
+    bool operator()(const AABBTreeIndirect::Tree3d::Node& node) const {
+        double t_min = -std::numeric_limits<double>::max();
+        double t_max = std::numeric_limits<double>::max();
+        for (int i = 0; i < 3; ++i) {
+            if (direction[i] == 0.0) {
+                if (point[i] < node.bbox.min()[i] || point[i] > node.bbox.max()[i])
+                    return false;
+                continue;
+            }
+            double t1 = (node.bbox.min()[i] - point[i]) / direction[i];
+            double t2 = (node.bbox.max()[i] - point[i]) / direction[i];
+            if (t1 > t2)
+                std::swap(t1, t2);
+            t_min = std::max(t_min, t1);
+            t_max = std::min(t_max, t2);
+            if (t_min > t_max)
+                return false;
+        }
+        return true;
+    }
+};
+
+} // namespace
+
 SceneRaycaster::SceneRaycaster() {
 #if ENABLE_RAYCAST_PICKING_DEBUG
     // hit point
@@ -162,9 +215,9 @@ SceneRaycaster::HitResult SceneRaycaster::hit(const Vec2d& mouse_pos, const Came
         const std::vector<std::shared_ptr<SceneRaycasterItem>>* raycasters = get_raycasters(type);
         const Vec3f camera_forward = camera.get_dir_forward().cast<float>();
         HitResult current_hit = { type };
-        for (const std::shared_ptr<SceneRaycasterItem>& item : *raycasters) {
+        auto test_item = [&](const std::shared_ptr<SceneRaycasterItem>& item) {
             if (!item->is_active())
-                continue;
+                return;
 
             bool sth_hit = false;
 
@@ -200,6 +253,19 @@ SceneRaycaster::HitResult SceneRaycaster::hit(const Vec2d& mouse_pos, const Came
                     }
                 }
             }
+        };
+
+        if (type != EType::Bed && raycasters->size() >= ItemsTreeMinItems) {
+            // Only test the items whose bounding box is crossed by the mouse ray.
+            Vec3d point;
+            Vec3d direction;
+            CameraUtils::ray_from_screen_pos(camera, mouse_pos, point, direction);
+            for (size_t idx : items_along_line(type, point, direction))
+                test_item((*raycasters)[idx]);
+        }
+        else {
+            for (const std::shared_ptr<SceneRaycasterItem>& item : *raycasters)
+                test_item(item);
         }
     };
 
@@ -316,6 +382,44 @@ const std::vector<std::shared_ptr<SceneRaycasterItem>>* SceneRaycaster::get_rayc
     return ret;
 }
 
+std::vector<size_t> SceneRaycaster::items_along_line(EType type, const Vec3d& point, const Vec3d& direction) const
+{
+    const std::vector<std::shared_ptr<SceneRaycasterItem>>& raycasters = *get_raycasters(type);
+    ItemsTree& items_tree = (type == EType::Volume) ? m_volumes_tree : (type == EType::Gizmo) ? m_gizmos_tree : m_fallback_gizmos_tree;
+    assert(type != EType::Bed);
+
+    bool valid = items_tree.items.size() == raycasters.size();
+    for (size_t i = 0; valid && i < raycasters.size(); ++i) {
+        valid = items_tree.items[i] == raycasters[i].get() && items_tree.revisions[i] == raycasters[i]->get_revision();
+    }
+
+    if (!valid) {
+        items_tree.items.clear();
+        items_tree.revisions.clear();
+        std::vector<ItemBoundingBox> bboxes;
+        bboxes.reserve(raycasters.size());
+        for (size_t i = 0; i < raycasters.size(); ++i) {
+            const SceneRaycasterItem& item = *raycasters[i];
+            items_tree.items.emplace_back(&item);
+            items_tree.revisions.emplace_back(item.get_revision());
+            if (item.is_active()) {
+                const BoundingBoxf3 bbox = item.get_raycaster()->get_bounding_box();
+                if (bbox.defined)
+                    bboxes.emplace_back(i, bbox.transformed(item.get_transform()));
+            }
+        }
+        items_tree.tree.build(std::move(bboxes));
+    }
+
+    std::vector<size_t> ret;
+    AABBTreeIndirect::traverse(items_tree.tree, IntersectingLine{ point, direction }, [&ret](const AABBTreeIndirect::Tree3d::Node& node) {
+        ret.emplace_back(node.idx);
+        return true;
+        });
+    std::sort(ret.begin(), ret.end());
+    return ret;
+}
+
 int SceneRaycaster::base_id(EType type)
 {
     switch (type)
@@ -7,6 +7,7 @@
 
 #include "MeshUtils.hpp"
 #include "GLModel.hpp"
+#include "libslic3r/AABBTreeIndirect.hpp"
 #include <vector>
 #include <string>
 #include <optional>
@@ -23,6 +24,8 @@ class SceneRaycasterItem
     bool m_use_back_faces{ false };
     const MeshRaycaster* m_raycaster;
     Transform3d m_trafo;
+    // Incremented whenever the item is activated / deactivated or moved.
+    size_t m_revision{ 0 };
 
 public:
     SceneRaycasterItem(int id, const MeshRaycaster& raycaster, const Transform3d& trafo, bool use_back_faces = false)
@@ -31,11 +34,22 @@ public:
 
     int get_id() const { return m_id; }
     bool is_active() const { return m_active; }
-    void set_active(bool active) { m_active = active; }
+    void set_active(bool active) {
+        if (m_active != active) {
+            m_active = active;
+            ++m_revision;
+        }
+    }
     bool use_back_faces() const { return m_use_back_faces; }
     const MeshRaycaster* get_raycaster() const { return m_raycaster; }
     const Transform3d& get_transform() const { return m_trafo; }
-    void set_transform(const Transform3d& trafo) { m_trafo = trafo; }
+    void set_transform(const Transform3d& trafo) {
+        if (m_trafo.matrix() != trafo.matrix()) {
+            m_trafo = trafo;
+            ++m_revision;
+        }
+    }
+    size_t get_revision() const { return m_revision; }
 };
 
 class SceneRaycaster
@@ -74,6 +88,21 @@ private:
     std::vector<std::shared_ptr<SceneRaycasterItem>> m_gizmos;
     std::vector<std::shared_ptr<SceneRaycasterItem>> m_fallback_gizmos;
 
+    // Bounding volume hierarchy over the world bounding boxes of the active items of one type,
+    // used to find the items which may be hit by the mouse ray without testing all of them.
+    // It is rebuilt lazily by hit() when any item was added, removed, moved or (de)activated.
+    struct ItemsTree
+    {
+        // Items in the order of the raycasters vector and their revisions the tree was built for.
+        std::vector<const SceneRaycasterItem*> items;
+        std::vector<size_t> revisions;
+        // Leaves index into items.
+        AABBTreeIndirect::Tree3d tree;
+    };
+    mutable ItemsTree m_volumes_tree;
+    mutable ItemsTree m_gizmos_tree;
+    mutable ItemsTree m_fallback_gizmos_tree;
+
     // When set to true, if checking gizmos returns a valid hit,
     // the search is not performed on other types
     bool m_gizmos_on_top{ false };
@@ -116,6 +145,10 @@ public:
     static int decode_id(EType type, int id);
 
 private:
+    // Indices into the raycasters of the given type of the active items whose world bounding box
+    // is intersected by the given world space line, in increasing order.
+    std::vector<size_t> items_along_line(EType type, const Vec3d& point, const Vec3d& direction) const;
+
     static int encode_id(EType type, int id);
     static int base_id(EType type);
 };
@@ -5,6 +5,7 @@
 #include "Search.hpp"
 
 #include <cstddef>
+#include <numeric>
 #include <string>
 #include <boost/algorithm/string.hpp>
 #include <boost/optional.hpp>
@@ -255,36 +256,61 @@ bool OptionsSearcher::search(const std::string& search, bool force/* = false*/)
                 opt.group_local + sep + opt.label_local;
     };
 
+    if (full_list) {
+        for (size_t i = 0; i < options.size(); i++) {
+            std::string label = into_u8(get_label(options[i]));
+            found.emplace_back(FoundOption{ label, label, into_u8(get_tooltip(options[i])), i, 0 });
+        }
+        candidates_pattern.clear();
+        if (search_line != search)
+            search_line = search;
+        return true;
+    }
+
+    std::wstring wsearch = boost::nowide::widen(search);
+    boost::trim_left(wsearch);
+
+    // While the pattern is being extended, only the options matching the previous pattern are matched.
+    // A forced search is issued if the options or the view parameters changed, thus the candidates are not valid anymore.
+    const bool narrow_down = ! force && ! candidates_pattern.empty() && boost::starts_with(wsearch, candidates_pattern);
+    std::vector<size_t> new_candidates;
+    if (! narrow_down) {
+        candidates.resize(options.size());
+        std::iota(candidates.begin(), candidates.end(), 0);
+    }
+
     std::vector<uint16_t> matches, matches2;
-    for (size_t i=0; i < options.size(); i++)
+    for (size_t i : candidates)
     {
         const Option &opt = options[i];
-        if (full_list) {
-            std::string label = into_u8(get_label(opt));
-            found.emplace_back(FoundOption{ label, label, into_u8(get_tooltip(opt)), i, 0 });
-            continue;
-        }
-
-        std::wstring wsearch       = boost::nowide::widen(search);
-        boost::trim_left(wsearch);
         std::wstring label         = get_label(opt, false);
-        std::wstring label_english = get_label_english(opt, false);
         int score = std::numeric_limits<int>::min();
         int score2;
         matches.clear();
-        fuzzy_match(wsearch, label, score, matches);
-        if (fuzzy_match(wsearch, opt.key, score2, matches2) && score2 > score) {
-        	for (fts::pos_type &pos : matches2)
-        		pos += label.size() + 1;
-        	label += L"(" + opt.key + L")";
-        	append(matches, matches2);
-        	score = score2;
+        bool matched = fuzzy_match(wsearch, label, score, matches);
+        if (fuzzy_match(wsearch, opt.key, score2, matches2)) {
+            matched = true;
+            if (score2 > score) {
+            	for (fts::pos_type &pos : matches2)
+            		pos += label.size() + 1;
+            	label += L"(" + opt.key + L")";
+            	append(matches, matches2);
+            	score = score2;
+            }
         }
-        if (view_params.english && fuzzy_match(wsearch, label_english, score2, matches2) && score2 > score) {
-        	label   = std::move(label_english);
-        	matches = std::move(matches2);
-        	score   = score2;
+        if (view_params.english) {
+            std::wstring label_english = get_label_english(opt, false);
+            if (fuzzy_match(wsearch, label_english, score2, matches2)) {
+                matched = true;
+                if (score2 > score) {
+                	label   = std::move(label_english);
+                	matches = std::move(matches2);
+                	score   = score2;
+                }
+            }
         }
+        if (matched)
+            new_candidates.emplace_back(i);
         if (score > 90/*std::numeric_limits<int>::min()*/) {
 		    label = mark_string(label, matches, opt.type, printer_technology);
             label += L"  [" + std::to_wstring(score) + L"]";// add score value
@@ -302,8 +328,10 @@ bool OptionsSearcher::search(const std::string& search, bool force/* = false*/)
         }
     }
 
-    if (!full_list)
-        sort_found();
+    candidates         = std::move(new_candidates);
+    candidates_pattern = std::move(wsearch);
+
+    sort_found();
  
     if (search_line != search)
         search_line = search;
@@ -98,12 +98,18 @@ class OptionsSearcher
     std::vector<Option>                     options {};
     std::vector<Option>                     preferences_options {};
     std::vector<FoundOption>                found {};
+    // Indices of the options matching candidates_pattern, regardless of their score.
+    // An option not matching a pattern does not match any extension of the pattern either,
+    // thus the search is narrowed down to the candidates while the user keeps typing.
+    std::wstring                            candidates_pattern;
+    std::vector<size_t>                     candidates {};
 
     void append_options(DynamicPrintConfig* config, Preset::Type type);
 
     void sort_options() {
         std::sort(options.begin(), options.end(), [](const Option& o1, const Option& o2) {
             return o1.label < o2.label; });
+        candidates_pattern.clear();
     }
     void sort_found() {
         std::sort(found.begin(), found.end(), [](const FoundOption& f1, const FoundOption& f2) {
@@ -144,6 +150,7 @@ public:
     void sort_options_by_key() {
         std::sort(options.begin(), options.end(), [](const Option& o1, const Option& o2) {
             return o1.key < o2.key; });
+        candidates_pattern.clear();
     }
     void sort_options_by_label() { sort_options(); }
 
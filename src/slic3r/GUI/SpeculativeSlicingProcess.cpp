@@ -0,0 +1,253 @@
+#include "SpeculativeSlicingProcess.hpp"
+#include "GUI_App.hpp"
+#include "MainFrame.hpp"
+#include "Plater.hpp"
+
+#include <wx/app.h>
+#include <wx/event.h>
+
+// Print now includes tbb, and tbb includes Windows. This breaks compilation of wxWidgets if included before wx.
+#include "libslic3r/Print.hpp"
+#include "libslic3r/Thread.hpp"
+#include "libslic3r/libslic3r.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include <boost/log/trivial.hpp>
+
+namespace Slic3r {
+
+SpeculativeSlicingProcess::~SpeculativeSlicingProcess()
+{
+	this->stop();
+	if (m_thread.joinable()) {
+		{
+			std::scoped_lock<std::mutex> lck(m_mutex);
+			m_exit = true;
+		}
+		m_condition.notify_all();
+		m_thread.join();
+	}
+}
+
+void SpeculativeSlicingProcess::thread_proc()
+{
+	set_current_thread_name("slic3r_SpecSlc");
+	name_tbb_thread_pool_threads_set_locale();
+	TBBLocalesSetter setter;
+
+	std::unique_lock<std::mutex> lck(m_mutex);
+	for (;;) {
+		m_condition.wait(lck, [this](){ return ! m_queue.empty() || m_exit; });
+		if (m_exit)
+			break;
+		Job job = m_queue.front();
+		m_queue.erase(m_queue.begin());
+		m_running = job.print;
+		lck.unlock();
+		bool failed = ! this->process(job);
+		job.print->finalize();
+		if (job.print->cancel_status() == PrintBase::CANCELED_BY_USER)
+			// Canceled by release() or stop(), not from Print::apply(), thus cleanup() was not called yet.
+			job.print->cleanup();
+		bool exported = ! job.print->canceled() && job.print->finished();
+		lck.lock();
+		job.print->restart();
+		if (failed)
+			m_failed.insert(job.print);
+		m_running = nullptr;
+		// Let the UI thread wake up if it is waiting for the job to finish.
+		m_condition.notify_all();
+		if (exported) {
+			wxCommandEvent evt(m_event_finished_id);
+			evt.SetInt(job.bed_idx);
+			wxQueueEvent(GUI::wxGetApp().mainframe->m_plater, evt.Clone());
+		}
+	}
+}
+
+void SpeculativeSlicingProcess::thread_proc_safe() throw()
+{
+	try {
+		this->thread_proc();
+	} catch (...) {
+		wxTheApp->OnUnhandledException();
+	}
+}
+
+bool SpeculativeSlicingProcess::process(const Job &job)
+{
+	try {
+		// Yield the worker threads to the slicing of the active bed.
+		JobArenaConfig config;
+		config.low_priority = true;
+		execute_in_job_arena(config, [this, &job]() {
+			job.print->process();
+			job.print->export_gcode(job.temp_output_path, job.gcode_result,
+				[this, &job](const ThumbnailsParams &params) { return this->render_thumbnails(params, job.bed_idx); });
+		});
+	} catch (const CanceledException &) {
+	} catch (const std::exception &ex) {
+		// The error is reported by the BackgroundSlicingProcess once the bed is activated.
+		BOOST_LOG_TRIVIAL(info) << "Speculative slicing of bed " << job.bed_idx << " failed: " << ex.what();
+		return false;
+	}
+	return true;
+}
+
+void SpeculativeSlicingProcess::schedule(std::vector<Job> jobs)
+{
+	for (Print *print : std::vector<Print*>(m_owned))
+		if (std::find_if(jobs.begin(), jobs.end(), [print](const Job &job){ return job.print == print; }) == jobs.end())
+			this->release(print);
+	jobs.erase(std::remove_if(jobs.begin(), jobs.end(), [this](const Job &job){ return m_failed.count(job.print) > 0; }), jobs.end());
+	for (const Job &job : jobs)
+		if (std::find(m_owned.begin(), m_owned.end(), job.print) == m_owned.end()) {
+			job.print->set_status_silent();
+			job.print->set_cancel_callback([this, print = job.print](){ this->stop_internal(print); });
+			m_owned.emplace_back(job.print);
+		}
+
+	std::unique_lock<std::mutex> lck(m_mutex);
+	m_queue.clear();
+	for (Job &job : jobs)
+		if (job.print != m_running)
+			m_queue.emplace_back(std::move(job));
+	if (m_queue.empty())
+		return;
+	if (! m_thread.joinable())
+		m_thread = create_thread([this]{ this->thread_proc_safe(); });
+	lck.unlock();
+	m_condition.notify_all();
+}
+
+void SpeculativeSlicingProcess::invalidate(const Print *print)
+{
+	m_failed.erase(print);
+}
+
+void SpeculativeSlicingProcess::release(Print *print)
+{
+	{
+		std::unique_lock<std::mutex> lck(m_mutex);
+		m_queue.erase(std::remove_if(m_queue.begin(), m_queue.end(), [print](const Job &job){ return job.print == print; }), m_queue.end());
+		if (m_running == print)
+			this->cancel_running(lck);
+	}
+	if (auto it = std::find(m_owned.begin(), m_owned.end(), print); it != m_owned.end()) {
+		m_owned.erase(it);
+		this->restore_callbacks(print);
+	}
+}
+
+void SpeculativeSlicingProcess::stop()
+{
+	{
+		std::unique_lock<std::mutex> lck(m_mutex);
+		m_queue.clear();
+		if (m_running != nullptr)
+			this->cancel_running(lck);
+	}
+	for (Print *print : m_owned)
+		this->restore_callbacks(print);
+	m_owned.clear();
+}
+
+// To be called by Print::apply() on the UI thread through the Print::m_cancel_callback to stop the speculative
+// processing before changing any data of running or finalized milestones.
+void SpeculativeSlicingProcess::stop_internal(Print *print)
+{
+	// print->state_mutex() shall be held.
+	std::unique_lock<std::mutex> lck(m_mutex);
+	// The Print will be scheduled again once applied.
+	m_queue.erase(std::remove_if(m_queue.begin(), m_queue.end(), [print](const Job &job){ return job.print == print; }), m_queue.end());
+	if (m_running != print)
+		return;
+	// At this point of time the worker thread may be blocking on print->state_mutex().
+	// Set the print state to canceled before unlocking the state_mutex(), so when the worker thread wakes up,
+	// it throws the CanceledException().
+	cancel_ui_task(m_ui_task);
+	print->cancel_internal();
+	print->state_mutex().unlock();
+	m_condition.wait(lck, [this, print](){ return m_running != print; });
+	// Lock it back to be in a consistent state.
+	print->state_mutex().lock();
+}
+
+void SpeculativeSlicingProcess::cancel_running(std::unique_lock<std::mutex> &lck)
+{
+	// The state_mutex() of the running Print shall NOT be held.
+	Print *print = m_running;
+	assert(print != nullptr);
+	// Cancel any task planned by the worker thread on UI thread.
+	cancel_ui_task(m_ui_task);
+	print->cancel();
+	m_condition.wait(lck, [this, print](){ return m_running != print; });
+}
+
+void SpeculativeSlicingProcess::restore_callbacks(Print *print)
+{
+	print->set_cancel_callback([](){});
+	if (m_status_callback)
+		print->set_status_callback(m_status_callback);
+	else
+		print->set_status_default();
+}
+
+// Executed by the worker thread, to start a task on the UI thread.
+ThumbnailsList SpeculativeSlicingProcess::render_thumbnails(const ThumbnailsParams &params, int bed_idx)
+{
+	ThumbnailsList thumbnails;
+	if (m_thumbnail_cb)
+		this->execute_ui_task([this, &params, &thumbnails, bed_idx](){ thumbnails = m_thumbnail_cb(params, bed_idx); });
+	return thumbnails;
+}
+
+// Execute task from the worker thread on the UI thread. Returns true if processed, false if cancelled.
+bool SpeculativeSlicingProcess::execute_ui_task(std::function<void()> task)
+{
+	std::shared_ptr<UITask> ctx;
+	{
+		// Unlike with the BackgroundSlicingProcess, m_mutex is only held by the UI thread for a short time
+		// or while waiting on m_condition for the running Print to be canceled, thus blocking here is safe.
+		std::scoped_lock<std::mutex> lck(m_mutex);
+		assert(! m_ui_task);
+		if (m_running == nullptr || m_running->canceled())
+			return false;
+		ctx = m_ui_task = std::make_shared<UITask>();
+	}
+
+	GUI::wxGetApp().mainframe->m_plater->CallAfter([task, ctx]() {
+		// Running on the UI thread, thus ctx->state does not need to be guarded with mutex against ::cancel_ui_task().
+		assert(ctx->state == UITask::Planned || ctx->state == UITask::Canceled);
+		if (ctx->state == UITask::Planned) {
+			task();
+			std::unique_lock<std::mutex> lck(ctx->mutex);
+			ctx->state = UITask::Finished;
+		}
+		// Wake up the worker thread from the UI thread.
+		ctx->condition.notify_all();
+	});
+
+	{
+		std::unique_lock<std::mutex> lock(ctx->mutex);
+		ctx->condition.wait(lock, [&ctx]{ return ctx->state == UITask::Finished || ctx->state == UITask::Canceled; });
+	}
+	std::scoped_lock<std::mutex> lck(m_mutex);
+	m_ui_task.reset();
+	return ctx->state == UITask::Finished;
+}
+
+// To be called on the UI thread with m_mutex locked.
+void SpeculativeSlicingProcess::cancel_ui_task(std::shared_ptr<UITask> task)
+{
+	if (task) {
+		std::unique_lock<std::mutex> lck(task->mutex);
+		task->state = UITask::Canceled;
+		lck.unlock();
+		task->condition.notify_all();
+	}
+}
+
+} // namespace Slic3r
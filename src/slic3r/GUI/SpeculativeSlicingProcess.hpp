@@ -0,0 +1,114 @@
+#ifndef slic3r_GUI_SpeculativeSlicingProcess_hpp_
+#define slic3r_GUI_SpeculativeSlicingProcess_hpp_
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <boost/thread.hpp>
+
+#include "libslic3r/PrintBase.hpp"
+#include "libslic3r/GCode/ThumbnailData.hpp"
+
+namespace Slic3r {
+
+class Print;
+struct GCodeProcessorResult;
+
+// Slicing of the inactive beds ahead of time, while the active bed is processed by the BackgroundSlicingProcess.
+// The Prints of the inactive beds are sliced and their G-code is exported into the temporary G-code of their bed
+// one after the other by a single worker thread inside a low priority task arena, thus the worker threads are yielded
+// to the slicing of the active bed. Before a bed is activated, its Print is released from the speculative processing
+// and handed over to the BackgroundSlicingProcess, which finds the finished steps and the exported G-code valid
+// unless they were invalidated by Print::apply() in the meantime.
+// As with the BackgroundSlicingProcess, all the methods are to be called on the UI thread.
+class SpeculativeSlicingProcess
+{
+public:
+	struct Job {
+		Print 					*print;
+		// Data structure, to which the G-code export writes its annotations.
+		GCodeProcessorResult 	*gcode_result;
+		int 					 bed_idx;
+		// See BackgroundSlicingProcess::temp_output_path().
+		std::string 			 temp_output_path;
+	};
+	using ThumbnailsCallback = std::function<ThumbnailsList(const ThumbnailsParams &params, int bed_idx)>;
+
+	// Stop the processing and finalize the worker thread.
+	~SpeculativeSlicingProcess();
+
+	// Status callback to be restored on the Prints released from the speculative processing.
+	// The status of a Print being processed speculatively is not reported.
+	void set_status_callback(PrintBase::status_callback_type cb) { m_status_callback = std::move(cb); }
+	// Render the G-code thumbnails of a bed, called on the UI thread.
+	void set_thumbnail_cb(ThumbnailsCallback cb) { m_thumbnail_cb = std::move(cb); }
+	// The following wxCommandEvent will be sent to the UI thread / Plater window with the index of the bed,
+	// when the G-code of an inactive bed was exported.
+	void set_finished_event(int event_id) { m_event_finished_id = event_id; }
+
+	// Replace the queue of the Prints to be processed, ordered by their priority, to be called once the Prints were applied
+	// and validated. The Prints dropped from the queue are released. A Print failed before is not processed again until invalidated.
+	void schedule(std::vector<Job> jobs);
+	// Let a Print failed before be processed again, to be called once its state was changed by Print::apply().
+	void invalidate(const Print *print);
+	// Stop processing the Print if it is being processed, remove it from the queue and restore its callbacks.
+	void release(Print *print);
+	// Stop the processing and release all the Prints.
+	void stop();
+
+private:
+	void 	thread_proc();
+	void 	thread_proc_safe() throw();
+	// Returns false if the processing failed. Cancellation is not a failure.
+	bool 	process(const Job &job);
+	// To be called by Print::apply() through the Print::m_cancel_callback with the state mutex of the Print locked.
+	void 	stop_internal(Print *print);
+	// Cancel the Print being processed and wait for the worker thread to finish it, m_mutex shall be locked.
+	void 	cancel_running(std::unique_lock<std::mutex> &lck);
+	void 	restore_callbacks(Print *print);
+
+	ThumbnailsList 	render_thumbnails(const ThumbnailsParams &params, int bed_idx);
+	// Execute task from the worker thread on the UI thread synchronously. Returns true if processed, false if cancelled before executing the task.
+	bool 			execute_ui_task(std::function<void()> task);
+
+	PrintBase::status_callback_type m_status_callback;
+	ThumbnailsCallback 				m_thumbnail_cb;
+	int 							m_event_finished_id { 0 };
+
+	// Prints with the status and cancel callbacks redirected to this object.
+	std::vector<Print*> 			m_owned;
+	// Prints, which failed to be processed and which were not invalidated since.
+	std::set<const Print*> 			m_failed;
+
+	// Members below are guarded by m_mutex.
+	std::vector<Job> 				m_queue;
+	Print 						   *m_running { nullptr };
+	bool 							m_exit { false };
+
+	boost::thread 					m_thread;
+	std::mutex 						m_mutex;
+	std::condition_variable 		m_condition;
+
+	// For executing tasks from the worker thread on the UI thread synchronously, see BackgroundSlicingProcess::UITask.
+	struct UITask {
+		enum State {
+			Planned,
+			Finished,
+			Canceled,
+		};
+		State 					state = Planned;
+		std::mutex 				mutex;
+		std::condition_variable	condition;
+	};
+	std::shared_ptr<UITask> 		m_ui_task;
+	static void 					cancel_ui_task(std::shared_ptr<UITask> task);
+};
+
+} // namespace Slic3r
+
+#endif /* slic3r_GUI_SpeculativeSlicingProcess_hpp_ */
@@ -1642,6 +1642,7 @@ void TabPrint::build()
         optgroup->append_single_option_line("support_material_interface_extruder");
         optgroup->append_single_option_line("wipe_tower_extruder");
         optgroup->append_single_option_line("bed_temperature_extruder");
+        optgroup->append_single_option_line("optimize_toolchange_order");
 
         optgroup = page->new_optgroup(L("Ooze prevention"));
         optgroup->append_single_option_line("ooze_prevention");
@@ -2760,6 +2761,7 @@ void TabPrinter::build_fff()
         optgroup->append_single_option_line("silent_mode");
         optgroup->append_single_option_line("remaining_times");
         optgroup->append_single_option_line("binary_gcode");
+        optgroup->append_single_option_line("binary_gcode_compression");
 
         optgroup->on_change = [this](t_config_option_key opt_key, boost::any value) {
             wxTheApp->CallAfter([this, opt_key, value]() {
@@ -3402,9 +3404,12 @@ void TabPrinter::build_extruder_pages(size_t n_before_extruders)
     }
 
     // # remove extra pages
-    if (m_extruders_count < m_extruders_count_old)
+    if (m_extruders_count < m_extruders_count_old) {
+        for (size_t i = n_before_extruders + m_extruders_count; i < n_before_extruders + m_extruders_count_old; ++i)
+            m_pages[i]->destroy();
         m_pages.erase(	m_pages.begin() + n_before_extruders + m_extruders_count,
                         m_pages.begin() + n_before_extruders + m_extruders_count_old);
+    }
 }
 
 /* Previous name build_extruder_pages().
@@ -3429,8 +3434,11 @@ void TabPrinter::build_unregular_pages(bool from_initial_build/* = false*/)
     size_t existed_page = 0;
     for (size_t i = n_before_extruders; i < m_pages.size(); ++i) // first make sure it's not there already
         if (m_pages[i]->title().find(L("Machine limits")) != std::string::npos) {
-            if (!show_mach_limits || m_rebuild_kinematics_page)
+            if (!show_mach_limits || m_rebuild_kinematics_page) {
+                m_pages[i]->destroy();
+                m_machine_limits_description_line = nullptr;
                 m_pages.erase(m_pages.begin() + i);
+            }
             else
                 existed_page = i;
             break;
@@ -3454,6 +3462,7 @@ void TabPrinter::build_unregular_pages(bool from_initial_build/* = false*/)
         // if we have a single extruder MM setup, add a page with configuration options:
         for (size_t i = 0; i < m_pages.size(); ++i) // first make sure it's not there already
             if (m_pages[i]->title().find(L("Single extruder MM setup")) != std::string::npos) {
+                m_pages[i]->destroy();
                 m_pages.erase(m_pages.begin() + i);
                 break;
             }
@@ -3587,6 +3596,7 @@ void TabPrinter::toggle_options()
         bool is_marlin_flavor = flavor == gcfMarlinLegacy || flavor == gcfMarlinFirmware;
         // Disable silent mode for non-marlin firmwares.
         toggle_option("silent_mode", is_marlin_flavor);
+        toggle_option("binary_gcode_compression", m_config->opt_bool("binary_gcode"));
     }
 
     wxString extruder_number;
@@ -4215,7 +4225,12 @@ bool Tab::tree_sel_change_delayed()
     if (page == nullptr || m_active_page == page)
         return false;
 
-    // clear pages from the controls
+    // The controls of the previously selected page are just hidden, they are shown again once the page is selected again.
+    // Thus switching between the pages does not rebuild the pages, and a preset switch reloads just the selected page,
+    // the cached pages are reloaded when shown.
+    if (m_active_page)
+        m_active_page->hide();
+    m_highlighter.invalidate();
     m_active_page = page;
     
     auto throw_if_canceled = std::function<void()>([this](){
@@ -4229,7 +4244,6 @@ bool Tab::tree_sel_change_delayed()
         });
 
     try {
-        clear_pages();
         throw_if_canceled();
 
         if (wxGetApp().mainframe!=nullptr && wxGetApp().mainframe->is_active_and_shown_tab(this))
@@ -4246,8 +4260,8 @@ bool Tab::tree_sel_change_delayed()
         throw_if_canceled();
         Refresh();
     } catch (const UIBuildCanceled&) {
-	    if (m_active_page)
-		    m_active_page->clear();
+        // The controls of the page may be built partially, destroy all the cached pages.
+        clear_pages();
         return true;
     }
 
@@ -5269,21 +5283,43 @@ void Page::update_visibility(ConfigOptionMode mode, bool update_contolls_visibil
 void Page::activate(ConfigOptionMode mode, std::function<void()> throw_if_canceled)
 {
     for (auto group : m_optgroups) {
-        if (!group->activate(throw_if_canceled))
+        if (group->activate(throw_if_canceled))
+            m_vsizer->Add(group->sizer, 0, wxEXPAND | (group->is_legend_line() ? (wxLEFT|wxTOP) : wxALL), 10);
+        else if (group->sizer)
+            // The group was activated before and hidden, see Page::hide().
+            m_vsizer->Show(group->sizer);
+        else
             continue;
-        m_vsizer->Add(group->sizer, 0, wxEXPAND | (group->is_legend_line() ? (wxLEFT|wxTOP) : wxALL), 10);
         group->update_visibility(mode);
         group->reload_config();
         throw_if_canceled();
     }
 }
 
+void Page::hide()
+{
+    for (auto group : m_optgroups)
+        if (group->sizer)
+            m_vsizer->Hide(group->sizer);
+}
+
 void Page::clear()
 {
     for (auto group : m_optgroups)
         group->clear();
 }
 
+void Page::destroy()
+{
+    for (auto group : m_optgroups)
+        if (wxSizer* sizer = group->sizer) {
+            m_vsizer->Detach(sizer);
+            group->clear();
+            sizer->Clear(true);
+            delete sizer;
+        }
+}
+
 void Page::msw_rescale()
 {
     for (auto group : m_optgroups)
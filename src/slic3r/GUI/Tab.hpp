@@ -141,8 +141,14 @@ public:
 	void		set_config(DynamicPrintConfig* config_in) { m_config = config_in; }
 	void		reload_config();
     void        update_visibility(ConfigOptionMode mode, bool update_contolls_visibility);
+    // Create the controls of the option groups or show them, if they were created before and hidden.
     void        activate(ConfigOptionMode mode, std::function<void()> throw_if_canceled);
+    // Hide the controls, they are kept for the next activation.
+    void        hide();
+    // Forget the controls, they are destroyed by the caller (see Tab::clear_pages()).
     void        clear();
+    // Destroy the controls of a page removed from the Tab.
+    void        destroy();
     void        msw_rescale();
     void        sys_color_changed();
     void        refresh();
@@ -140,7 +140,7 @@ bool Duet::upload(PrintHostUpload upload_data, ProgressFn prorgess_fn, ErrorFn e
 				res = false;
 			}
 		})
-		.perform_sync();
+		.perform_sync(HttpRetryOpt::upload_retry());
 
 	disconnect(connectionType);
 
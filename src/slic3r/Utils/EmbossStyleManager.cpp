@@ -315,6 +315,7 @@ void StyleManager::clear_glyphs_cache()
     FontFileWithCache &ff = m_style_cache.font_file;
     if (!ff.has_value()) return;
     ff.cache = std::make_shared<Glyphs>();
+    ff.mesh_cache = std::make_shared<GlyphMeshes>();
 }
 
 void StyleManager::clear_imgui_font() { m_style_cache.atlas.Clear(); }
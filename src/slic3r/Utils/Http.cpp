@@ -18,7 +18,6 @@
 #include <boost/filesystem.hpp>
 #include <boost/format.hpp>
 #include <boost/log/trivial.hpp>
-#include <boost/nowide/fstream.hpp>
 
 #include <curl/curl.h>
 
@@ -129,7 +128,8 @@ struct Http::priv
 	std::string error_buffer;    // Used for CURLOPT_ERRORBUFFER
 	size_t limit;
 	bool cancel;
-    std::unique_ptr<fs::ifstream> putFile;
+    // File streamed as a PUT or POST request body.
+    std::unique_ptr<fs::ifstream> body_file;
 
 	std::thread io_thread;
 	Http::CompleteFn completefn;
@@ -146,6 +146,7 @@ struct Http::priv
 	static int xfercb(void *userp, curl_off_t dltotal, curl_off_t dlnow, curl_off_t ultotal, curl_off_t ulnow);
 	static int xfercb_legacy(void *userp, double dltotal, double dlnow, double ultotal, double ulnow);
 	static size_t form_file_read_cb(char *buffer, size_t size, size_t nitems, void *userp);
+	static int body_file_seek_cb(void *userp, curl_off_t offset, int origin);
 
 	void set_timeout_connect(long timeout);
     void set_timeout_max(long timeout);
@@ -153,6 +154,8 @@ struct Http::priv
 	void set_post_body(const fs::path &path);
 	void set_post_body(const std::string &body);
 	void set_put_body(const fs::path &path);
+	void set_body_file(const fs::path &path, CURLoption size_option);
+	void rewind_upload_streams();
 	void set_range(const std::string& range);
 
 	std::string curl_error(CURLcode curlcode);
@@ -263,6 +266,21 @@ size_t Http::priv::form_file_read_cb(char *buffer, size_t size, size_t nitems, v
 	return stream->gcount();
 }
 
+// Called by curl if it needs to send the request body again, for example after a redirect or after a digest authentication challenge.
+int Http::priv::body_file_seek_cb(void *userp, curl_off_t offset, int origin)
+{
+	auto stream = reinterpret_cast<fs::ifstream*>(userp);
+
+	try {
+		stream->clear();
+		stream->seekg(offset, origin == SEEK_CUR ? std::ios::cur : origin == SEEK_END ? std::ios::end : std::ios::beg);
+	} catch (const std::exception &) {
+		return CURL_SEEKFUNC_FAIL;
+	}
+
+	return stream->fail() ? CURL_SEEKFUNC_FAIL : CURL_SEEKFUNC_OK;
+}
+
 void Http::priv::set_timeout_connect(long timeout)
 {
 	::curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, timeout);
@@ -300,12 +318,10 @@ void Http::priv::form_add_file(const char *name, const fs::path &path, const cha
 	}
 }
 
-//FIXME may throw! Is the caller aware of it?
 void Http::priv::set_post_body(const fs::path &path)
 {
-	boost::nowide::ifstream file(path.string());
-	std::string file_content { std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
-	postfields = std::move(file_content);
+	// Stream the file instead of loading it into postfields, the uploaded G-code may be hundreds of megabytes large.
+	set_body_file(path, CURLOPT_POSTFIELDSIZE_LARGE);
 }
 
 void Http::priv::set_post_body(const std::string &body)
@@ -314,13 +330,33 @@ void Http::priv::set_post_body(const std::string &body)
 }
 
 void Http::priv::set_put_body(const fs::path &path)
+{
+	set_body_file(path, CURLOPT_INFILESIZE_LARGE);
+}
+
+void Http::priv::set_body_file(const fs::path &path, CURLoption size_option)
 {
 	boost::system::error_code ec;
 	boost::uintmax_t filesize = file_size(path, ec);
 	if (!ec) {
-        putFile = std::make_unique<fs::ifstream>(path, std::ios::binary);
-        ::curl_easy_setopt(curl, CURLOPT_READDATA, (void *) (putFile.get()));
-		::curl_easy_setopt(curl, CURLOPT_INFILESIZE, filesize);
+        body_file = std::make_unique<fs::ifstream>(path, std::ios::binary);
+        ::curl_easy_setopt(curl, CURLOPT_READDATA, (void *) (body_file.get()));
+        ::curl_easy_setopt(curl, CURLOPT_SEEKFUNCTION, body_file_seek_cb);
+        ::curl_easy_setopt(curl, CURLOPT_SEEKDATA, (void *) (body_file.get()));
+		::curl_easy_setopt(curl, size_option, curl_off_t(filesize));
+	}
+}
+
+// Rewind the uploaded files to be sent again by a retried request.
+void Http::priv::rewind_upload_streams()
+{
+	for (fs::ifstream &stream : form_files) {
+		stream.clear();
+		stream.seekg(0);
+	}
+	if (body_file) {
+		body_file->clear();
+		body_file->seekg(0);
 	}
 }
 
@@ -347,8 +383,9 @@ bool is_transient_error(CURLcode res, long http_status)
 {
     if (res == CURLE_OK  || res == CURLE_HTTP_RETURNED_ERROR)
         return http_status == 408 || http_status >= 500;
+    // Connection dropped while sending or receiving, for example over a flaky Wi-Fi.
     return res == CURLE_COULDNT_CONNECT || res == CURLE_COULDNT_RESOLVE_HOST ||
-        res == CURLE_OPERATION_TIMEDOUT;
+        res == CURLE_OPERATION_TIMEDOUT || res == CURLE_SEND_ERROR || res == CURLE_RECV_ERROR || res == CURLE_GOT_NOTHING;
 }
 
 void Http::priv::http_perform(const HttpRetryOpt& retry_opts)
@@ -376,6 +413,8 @@ void Http::priv::http_perform(const HttpRetryOpt& retry_opts)
 #endif
 
 	::curl_easy_setopt(curl, CURLOPT_VERBOSE, get_logging_level() >= 5);
+	// Detect connections dropped during long uploads or downloads.
+	::curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
 
 	if (headerlist != nullptr) {
 		::curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headerlist);
@@ -416,11 +455,14 @@ void Http::priv::http_perform(const HttpRetryOpt& retry_opts)
                 << "), retrying in " << delay.count() / 1000.0f << " s";
             std::this_thread::sleep_for(delay);
             delay = std::min(delay * 2, retry_opts.max_delay);
-            
+            // Send the request again from the start over the same curl handle, reusing its connection if still alive.
+            // Drop the response of the failed attempt.
+            rewind_upload_streams();
+            buffer.clear();
         }
     } while (retry);
 
-    putFile.reset();
+    body_file.reset();
 
 	if (res != CURLE_OK) {
 		if (res == CURLE_ABORTED_BY_CALLBACK) {
@@ -468,6 +510,13 @@ const HttpRetryOpt& HttpRetryOpt::default_retry()
     return val;
 }
 
+const HttpRetryOpt& HttpRetryOpt::upload_retry()
+{
+	using namespace std::chrono_literals;
+    static HttpRetryOpt val = {1000ms, 16000ms, 5};
+    return val;
+}
+
 const HttpRetryOpt& HttpRetryOpt::no_retry()
 {
     using namespace std::chrono_literals;
@@ -482,7 +531,7 @@ Http::Http(Http &&other) : p(std::move(other.p)) {}
 
 Http::~Http()
 {
-    assert(! p || ! p->putFile);
+    assert(! p || ! p->body_file);
 	if (p && p->io_thread.joinable()) {
 		p->io_thread.detach();
 	}
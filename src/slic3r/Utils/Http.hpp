@@ -25,6 +25,9 @@ struct HttpRetryOpt
 
 	static const HttpRetryOpt& no_retry();
     static const HttpRetryOpt& default_retry();
+    // Few retries with short delays for uploads of files to print hosts, which restart the upload of the file
+    // over a possibly dropped connection. None of the supported print hosts allows to resume a partial upload.
+    static const HttpRetryOpt& upload_retry();
 
     static constexpr size_t MAX_RETRY_DELAY_MS = 4 * 64000;
     static constexpr size_t MAX_RETRIES = 16;
@@ -116,7 +119,7 @@ public:
 	Http& ssl_revoke_best_effort(bool set);
 #endif // WIN32
 
-	// Set the file contents as a POST request body.
+	// Set the file contents as a POST request body. The file is streamed, it is not loaded into memory.
 	// The data is used verbatim, it is not additionally encoded in any way.
 	// This can be used for hosts which do not support multipart requests.
 	Http& set_post_body(const boost::filesystem::path &path);
@@ -232,7 +232,7 @@ bool Moonraker::upload(PrintHostUpload upload_data, ProgressFn prorgess_fn, Erro
 #ifdef WIN32
         .ssl_revoke_best_effort(m_ssl_revoke_best_effort)
 #endif
-        .perform_sync();
+        .perform_sync(HttpRetryOpt::upload_retry());
 
     return res;
 }
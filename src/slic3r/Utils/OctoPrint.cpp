@@ -421,7 +421,7 @@ bool OctoPrint::upload_inner_with_resolved_ip(PrintHostUpload upload_data, Progr
             }
         })
         .ssl_revoke_best_effort(m_ssl_revoke_best_effort)
-        .perform_sync();
+        .perform_sync(HttpRetryOpt::upload_retry());
 
     return result;
 }
@@ -510,7 +510,7 @@ bool OctoPrint::upload_inner_with_host(PrintHostUpload upload_data, ProgressFn p
 #ifdef WIN32
         .ssl_revoke_best_effort(m_ssl_revoke_best_effort)
 #endif
-        .perform_sync();
+        .perform_sync(HttpRetryOpt::upload_retry());
 
     return res;
 }
@@ -1083,7 +1083,7 @@ bool PrusaLink::put_inner(PrintHostUpload upload_data, std::string url, const st
 #ifdef WIN32
         .ssl_revoke_best_effort(m_ssl_revoke_best_effort)
 #endif
-        .perform_sync();
+        .perform_sync(HttpRetryOpt::upload_retry());
 
     return res;
 }
@@ -1142,7 +1142,7 @@ bool PrusaLink::post_inner(PrintHostUpload upload_data, std::string url, const s
 #ifdef WIN32
         .ssl_revoke_best_effort(m_ssl_revoke_best_effort)
 #endif
-        .perform_sync();
+        .perform_sync(HttpRetryOpt::upload_retry());
 
     return res;
 }
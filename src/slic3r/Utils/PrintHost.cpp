@@ -9,6 +9,11 @@
 ///|/
 #include "PrintHost.hpp"
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <set>
 #include <vector>
 #include <thread>
 #include <exception>
@@ -89,38 +94,60 @@ wxString PrintHost::format_error(const std::string &body, const std::string &err
 }
 
 
-struct PrintHostJobQueue::priv
+struct PrintHostJobQueue::priv : public std::enable_shared_from_this<PrintHostJobQueue::priv>
 {
-    // XXX: comment on how bg thread works
+    // The background thread picks up the jobs from channel_jobs in the order they were enqueued,
+    // numbering them the same way as PrintHostQueueDialog numbers its rows. Each job is uploaded
+    // by its own worker thread, at most max_concurrent_jobs at once and at most one at a time to the same host,
+    // so that uploading the same G-code to a group of printers does not flood a single printer or a slow LAN segment.
+
+    // Upper bound of uploads running in parallel.
+    static constexpr size_t max_concurrent_jobs = 4;
+
+    // State of a single job being uploaded, accessed by its worker thread only.
+    struct JobContext {
+        size_t  id;
+        int     prev_progress { -1 };
+    };
 
     PrintHostJobQueue *q;
 
     Channel<PrintHostJob> channel_jobs;
-    Channel<size_t> channel_cancels;
-    size_t job_id = 0;
-    int prev_progress = -1;
-    fs::path source_to_remove;
+
+    // Protects the members below, running_jobs_cv is notified whenever a job finishes or is cancelled.
+    std::mutex              running_jobs_mutex;
+    std::condition_variable running_jobs_cv;
+    // Id of the job to be picked up from channel_jobs next.
+    size_t                  job_id = 0;
+    // Id of the job picked up from channel_jobs, which waits for a free slot.
+    std::optional<size_t>   waiting_job_id;
+    // Jobs being uploaded and the hosts they are being uploaded to.
+    std::set<size_t>        running_jobs;
+    std::multiset<std::string> running_hosts;
+    // Jobs cancelled by the user, which are either running or not started yet.
+    std::set<size_t>        cancelled_jobs;
 
     std::thread bg_thread;
-    bool bg_exit = false;
+    std::atomic<bool> bg_exit { false };
 
     PrintHostQueueDialog *queue_dialog;
 
     priv(PrintHostJobQueue *q) : q(q) {}
 
-    void emit_progress(int progress);
-    void emit_error(wxString error);
+    void emit_progress(size_t id, int progress);
+    void emit_error(size_t id, wxString error);
     void emit_cancel(size_t id);
-    void emit_info(wxString tag, wxString status);
+    void emit_info(size_t id, wxString tag, wxString status);
     void start_bg_thread();
     void stop_bg_thread();
     void bg_thread_main();
-    void progress_fn(Http::Progress progress, bool &cancel);
-    void error_fn(wxString error);
-    void info_fn(wxString tag, wxString status);
+    bool is_cancelled(size_t id);
+    void cancel(size_t id);
+    void progress_fn(JobContext &ctx, Http::Progress progress, bool &cancel);
+    void error_fn(JobContext &ctx, wxString error);
+    void info_fn(JobContext &ctx, wxString tag, wxString status);
     void remove_source(const fs::path &path);
-    void remove_source();
-    void perform_job(PrintHostJob the_job);
+    void perform_job(size_t id, PrintHostJob the_job);
 };
 
 PrintHostJobQueue::PrintHostJobQueue(PrintHostQueueDialog *queue_dialog)
@@ -134,21 +161,21 @@ PrintHostJobQueue::~PrintHostJobQueue()
     if (p) { p->stop_bg_thread(); }
 }
 
-void PrintHostJobQueue::priv::emit_progress(int progress)
+void PrintHostJobQueue::priv::emit_progress(size_t id, int progress)
 {
-    auto evt = new PrintHostQueueDialog::Event(GUI::EVT_PRINTHOST_PROGRESS, queue_dialog->GetId(), job_id, progress);
+    auto evt = new PrintHostQueueDialog::Event(GUI::EVT_PRINTHOST_PROGRESS, queue_dialog->GetId(), id, progress);
     wxQueueEvent(queue_dialog, evt);
 }
 
-void PrintHostJobQueue::priv::emit_error(wxString error)
+void PrintHostJobQueue::priv::emit_error(size_t id, wxString error)
 {
-    auto evt = new PrintHostQueueDialog::Event(GUI::EVT_PRINTHOST_ERROR, queue_dialog->GetId(), job_id, std::move(error));
+    auto evt = new PrintHostQueueDialog::Event(GUI::EVT_PRINTHOST_ERROR, queue_dialog->GetId(), id, std::move(error));
     wxQueueEvent(queue_dialog, evt);
 }
 
-void PrintHostJobQueue::priv::emit_info(wxString tag, wxString status)
+void PrintHostJobQueue::priv::emit_info(size_t id, wxString tag, wxString status)
 {
-    auto evt = new PrintHostQueueDialog::Event(GUI::EVT_PRINTHOST_INFO, queue_dialog->GetId(), job_id, std::move(tag), std::move(status));
+    auto evt = new PrintHostQueueDialog::Event(GUI::EVT_PRINTHOST_INFO, queue_dialog->GetId(), id, std::move(tag), std::move(status));
     wxQueueEvent(queue_dialog, evt);
 }
 
@@ -171,7 +198,11 @@ void PrintHostJobQueue::priv::start_bg_thread()
 void PrintHostJobQueue::priv::stop_bg_thread()
 {
     if (bg_thread.joinable()) {
-        bg_exit = true;
+        {
+            std::lock_guard<std::mutex> lock(running_jobs_mutex);
+            bg_exit = true;
+        }
+        running_jobs_cv.notify_all();
         channel_jobs.push(PrintHostJob()); // Push an empty job to wake up bg_thread in case it's sleeping
         bg_thread.detach();                // Let the background thread go, it should exit on its own
     }
@@ -190,108 +221,127 @@ void PrintHostJobQueue::priv::bg_thread_main()
                 break;
             }
 
-            source_to_remove = job.upload_data.source_path;
+            size_t            id;
+            const std::string host = job.printhost->get_host();
+            {
+                std::lock_guard<std::mutex> lock(running_jobs_mutex);
+                id = job_id ++;
+            }
 
             BOOST_LOG_TRIVIAL(debug) << boost::format("PrintHostJobQueue/bg_thread: Received job: [%1%]: `%2%` -> `%3%`, cancelled: %4%")
-                % job_id
+                % id
                 % job.upload_data.upload_path
-                % job.printhost->get_host()
+                % host
                 % job.cancelled;
 
+            bool start = false;
             if (! job.cancelled) {
-                perform_job(std::move(job));
+                // Wait for a free slot and for the previous upload to the same host to finish.
+                std::unique_lock<std::mutex> lock(running_jobs_mutex);
+                waiting_job_id = id;
+                running_jobs_cv.wait(lock, [this, id, &host]() {
+                    return bg_exit || cancelled_jobs.count(id) > 0 || 
+                           (running_jobs.size() < max_concurrent_jobs && running_hosts.count(host) == 0);
+                });
+                waiting_job_id.reset();
+                // A job cancelled before it started was already reported by cancel().
+                start = ! bg_exit && cancelled_jobs.erase(id) == 0;
+                if (start) {
+                    running_jobs.insert(id);
+                    running_hosts.insert(host);
+                }
             }
 
-            remove_source();
-            job_id++;
+            if (start) {
+                std::shared_ptr<priv> p2 = shared_from_this();
+                std::thread([p2, id, host, job = std::move(job)]() mutable {
+                    const fs::path source_path = job.upload_data.source_path;
+                    try {
+                        p2->perform_job(id, std::move(job));
+                    } catch (const std::exception &e) {
+                        p2->emit_error(id, e.what());
+                    }
+                    p2->remove_source(source_path);
+                    {
+                        std::lock_guard<std::mutex> lock(p2->running_jobs_mutex);
+                        p2->running_jobs.erase(id);
+                        p2->running_hosts.erase(p2->running_hosts.find(host));
+                        p2->cancelled_jobs.erase(id);
+                    }
+                    p2->running_jobs_cv.notify_all();
+                }).detach();
+            } else
+                remove_source(job.upload_data.source_path);
         }
     } catch (const std::exception &e) {
-        emit_error(e.what());
+        emit_error(job_id > 0 ? job_id - 1 : 0, e.what());
     }
 
-    // Cleanup leftover files, if any
-    remove_source();
+    // Cleanup leftover files, if any. The running jobs remove their own files.
     auto jobs = channel_jobs.lock_rw();
     for (const PrintHostJob &job : *jobs) {
         remove_source(job.upload_data.source_path);
     }
 }
 
-void PrintHostJobQueue::priv::progress_fn(Http::Progress progress, bool &cancel)
+bool PrintHostJobQueue::priv::is_cancelled(size_t id)
+{
+    std::lock_guard<std::mutex> lock(running_jobs_mutex);
+    return cancelled_jobs.count(id) > 0;
+}
+
+void PrintHostJobQueue::priv::cancel(size_t id)
+{
+    bool waiting = false;
+    {
+        std::lock_guard<std::mutex> lock(running_jobs_mutex);
+        if (running_jobs.count(id) > 0) {
+            // The running job is stopped by its progress_fn(), which reports the cancellation.
+            cancelled_jobs.insert(id);
+        } else if (id >= job_id || waiting_job_id == id) {
+            // The job was not started yet, it will be skipped by the background thread.
+            waiting = cancelled_jobs.insert(id).second;
+        }
+    }
+    if (waiting) {
+        BOOST_LOG_TRIVIAL(debug) << boost::format("PrintHostJobQueue: Job id %1% cancelled") % id;
+        emit_cancel(id);
+        running_jobs_cv.notify_all();
+    }
+}
+
+void PrintHostJobQueue::priv::progress_fn(JobContext &ctx, Http::Progress progress, bool &cancel)
 {
     if (cancel) {
         // When cancel is true from the start, Http indicates request has been cancelled
-        emit_cancel(job_id);
+        emit_cancel(ctx.id);
         return;
     }
 
-    if (bg_exit) {
+    if (bg_exit || is_cancelled(ctx.id)) {
         cancel = true;
         return;
     }
 
-    if (channel_cancels.size_hint() > 0) {
-        // Lock both queues
-        auto cancels = channel_cancels.lock_rw();
-        auto jobs = channel_jobs.lock_rw();
-
-        for (size_t cancel_id : *cancels) {
-            if (cancel_id == job_id) {
-                cancel = true;
-            } else if (cancel_id > job_id) {
-                const size_t idx = cancel_id - job_id - 1;
-                if (idx < jobs->size()) {
-                    jobs->at(idx).cancelled = true;
-                    BOOST_LOG_TRIVIAL(debug) << boost::format("PrintHostJobQueue: Job id %1% cancelled") % cancel_id;
-                    emit_cancel(cancel_id);
-                }
-            }
-        }
-
-        cancels->clear();
-    }
-
-    if (! cancel) {
-        int gui_progress = progress.ultotal > 0 ? 100*progress.ulnow / progress.ultotal : 0;
-        if (gui_progress != prev_progress) {
-            emit_progress(gui_progress);
-            prev_progress = gui_progress;
-        }
+    int gui_progress = progress.ultotal > 0 ? 100*progress.ulnow / progress.ultotal : 0;
+    if (gui_progress != ctx.prev_progress) {
+        emit_progress(ctx.id, gui_progress);
+        ctx.prev_progress = gui_progress;
     }
 }
 
-void PrintHostJobQueue::priv::error_fn(wxString error)
+void PrintHostJobQueue::priv::error_fn(JobContext &ctx, wxString error)
 {
     // check if transfer was not canceled before error occured - than do not show the error
-    bool do_emit_err = true;
-    if (channel_cancels.size_hint() > 0) {
-        // Lock both queues
-        auto cancels = channel_cancels.lock_rw();
-        auto jobs = channel_jobs.lock_rw();
-
-        for (size_t cancel_id : *cancels) {
-            if (cancel_id == job_id) {
-                do_emit_err = false;
-                emit_cancel(job_id);
-            }
-            else if (cancel_id > job_id) {
-                const size_t idx = cancel_id - job_id - 1;
-                if (idx < jobs->size()) {
-                    jobs->at(idx).cancelled = true;
-                    BOOST_LOG_TRIVIAL(debug) << boost::format("PrintHostJobQueue: Job id %1% cancelled") % cancel_id;
-                    emit_cancel(cancel_id);
-                }
-            }
-        }
-        cancels->clear();
-    }
-    if (do_emit_err)
-        emit_error(std::move(error));
+    if (is_cancelled(ctx.id))
+        emit_cancel(ctx.id);
+    else
+        emit_error(ctx.id, std::move(error));
 }
 
-void PrintHostJobQueue::priv::info_fn(wxString tag, wxString status)
+void PrintHostJobQueue::priv::info_fn(JobContext &ctx, wxString tag, wxString status)
 {
-    emit_info(tag, status);
+    emit_info(ctx.id, tag, status);
 }
 
 void PrintHostJobQueue::priv::remove_source(const fs::path &path)
@@ -305,24 +355,19 @@ void PrintHostJobQueue::priv::remove_source(const fs::path &path)
     }
 }
 
-void PrintHostJobQueue::priv::remove_source()
-{
-    remove_source(source_to_remove);
-    source_to_remove.clear();
-}
-
-void PrintHostJobQueue::priv::perform_job(PrintHostJob the_job)
+void PrintHostJobQueue::priv::perform_job(size_t id, PrintHostJob the_job)
 {
-    emit_progress(0);   // Indicate the upload is starting
+    JobContext ctx { id };
+    emit_progress(id, 0);   // Indicate the upload is starting
 
     bool success = the_job.printhost->upload(std::move(the_job.upload_data),
-        [this](Http::Progress progress, bool &cancel)   { this->progress_fn(std::move(progress), cancel); },
-        [this](wxString error)                          { this->error_fn(std::move(error)); },
-        [this](wxString tag, wxString host)             { this->info_fn(std::move(tag), std::move(host)); }
+        [this, &ctx](Http::Progress progress, bool &cancel)   { this->progress_fn(ctx, std::move(progress), cancel); },
+        [this, &ctx](wxString error)                          { this->error_fn(ctx, std::move(error)); },
+        [this, &ctx](wxString tag, wxString host)             { this->info_fn(ctx, std::move(tag), std::move(host)); }
     );
 
     if (success) {
-        emit_progress(100);
+        emit_progress(id, 100);
     }
 }
 
@@ -335,7 +380,7 @@ void PrintHostJobQueue::enqueue(PrintHostJob job)
 
 void PrintHostJobQueue::cancel(size_t id)
 {
-    p->channel_cancels.push(id);
+    p->cancel(id);
 }
 
 }
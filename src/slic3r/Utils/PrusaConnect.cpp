@@ -187,7 +187,7 @@ bool PrusaConnectNew::upload(PrintHostUpload upload_data, ProgressFn progress_fn
                 res = false;
             }
         })
-        .perform_sync();
+        .perform_sync(HttpRetryOpt::upload_retry());
 
     return res;
 }
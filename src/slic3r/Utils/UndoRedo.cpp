@@ -343,27 +343,132 @@ private:
 	{
 		// Reference counter of this data chunk. We may have used shared_ptr, but the shared_ptr is thread safe
 		// with the associated cost of CPU cache invalidation on refcount change.
+		// Data delta encoded against this data chunk hold a reference to it as well.
 		size_t		refcnt;
+		// If not null, this data chunk is delta encoded: Only the bytes differing from the base data chunk are stored here,
+		// the first prefix and the last suffix bytes are shared with the base data chunk.
+		Data 	   *base;
+		size_t 		prefix;
+		size_t 		suffix;
+		// Number of base data chunks to be visited to reconstruct this data chunk.
+		size_t 		depth;
+		// Number of bytes stored in this data chunk.
 		size_t		size;
 		char 		data[1];
 
+		// Size of the reconstructed serialized data.
+		size_t 		full_size() const { return this->prefix + this->size + this->suffix; }
+
+		// Call fn(ptr, len) for consecutive pieces of the reconstructed serialized data in the range <offset, offset + len).
+		// Stops and returns false as soon as fn returns false.
+		template<typename Fn>
+		bool 		visit(size_t offset, size_t len, Fn &&fn) const {
+			assert(offset + len <= this->full_size());
+			if (this->base == nullptr)
+				return len == 0 || fn(this->data + offset, len);
+			if (len > 0 && offset < this->prefix) {
+				size_t n = std::min(len, this->prefix - offset);
+				if (! this->base->visit(offset, n, fn))
+					return false;
+				offset += n;
+				len    -= n;
+			}
+			if (len > 0 && offset < this->prefix + this->size) {
+				size_t n = std::min(len, this->prefix + this->size - offset);
+				if (! fn(this->data + offset - this->prefix, n))
+					return false;
+				offset += n;
+				len    -= n;
+			}
+			return len == 0 || this->base->visit(this->base->full_size() - this->suffix + (offset - this->prefix - this->size), len, fn);
+		}
+
 		// The serialized data matches the data stored here.
-		bool 		matches(const std::string& rhs) { return this->size == rhs.size() && memcmp(this->data, rhs.data(), this->size) == 0; }
+		bool 		matches(const std::string& rhs) const {
+			const char *ptr = rhs.data();
+			return this->full_size() == rhs.size() && 
+				this->visit(0, rhs.size(), [&ptr](const char *data, size_t len) { bool equal = memcmp(data, ptr, len) == 0; ptr += len; return equal; });
+		}
 
 		// The timestamp matches the timestamp serialized in the data stored here.
-		bool 		matches_timestamp(uint64_t timestamp) { assert(timestamp > 0);  assert(this->size > 8); return memcmp(this->data, &timestamp, 8) == 0; }
+		bool 		matches_timestamp(uint64_t timestamp) const {
+			assert(timestamp > 0);
+			assert(this->full_size() > 8);
+			const char *ptr = reinterpret_cast<const char*>(&timestamp);
+			return this->visit(0, 8, [&ptr](const char *data, size_t len) { bool equal = memcmp(data, ptr, len) == 0; ptr += len; return equal; });
+		}
+
+		// Reconstruct the serialized data.
+		std::string decode() const {
+			std::string out(this->full_size(), 0);
+			char       *ptr = out.data();
+			this->visit(0, out.size(), [&ptr](const char *data, size_t len) { memcpy(ptr, data, len); ptr += len; return true; });
+			return out;
+		}
+
+		// Estimated size in memory per reference, including the share of the base data chunks.
+		size_t 		memsize() const {
+			size_t size = this->size + (this->base ? this->base->memsize() : 0);
+			// Rounded up.
+			return (size + this->refcnt - 1) / this->refcnt;
+		}
+
+		static Data* allocate(const char *data, size_t size) {
+			Data *out   = (Data*)new char[offsetof(Data, data) + size];
+			out->refcnt = 1;
+			out->base   = nullptr;
+			out->prefix = 0;
+			out->suffix = 0;
+			out->depth  = 0;
+			out->size   = size;
+			memcpy(out->data, data, size);
+			return out;
+		}
+
+		// Store the input data delta encoded against the base data chunk if a considerable part of it is shared.
+		// The length of the delta chains is limited to limit the cost of decoding.
+		static Data* encode(const std::string &input_data, Data *base) {
+			if (base != nullptr && input_data.size() >= delta_min_size && base->depth < delta_max_depth) {
+				std::string base_data  = base->decode();
+				size_t      max_shared = std::min(input_data.size(), base_data.size());
+				size_t      prefix     = std::mismatch(input_data.begin(), input_data.begin() + max_shared, base_data.begin()).first - input_data.begin();
+				size_t      suffix     = std::mismatch(input_data.rbegin(), input_data.rbegin() + (max_shared - prefix), base_data.rbegin()).first - input_data.rbegin();
+				if (2 * (prefix + suffix) >= input_data.size()) {
+					Data *out   = allocate(input_data.data() + prefix, input_data.size() - prefix - suffix);
+					out->base   = base;
+					out->prefix = prefix;
+					out->suffix = suffix;
+					out->depth  = base->depth + 1;
+					++ base->refcnt;
+					return out;
+				}
+			}
+			return allocate(input_data.data(), input_data.size());
+		}
+
+		static void release(Data *data) {
+			// Release the delta chain iteratively.
+			while (data != nullptr && -- data->refcnt == 0) {
+				Data *base = data->base;
+				delete[] (char*)data;
+				data = base;
+			}
+		}
 	};
 
+	// Only data of at least this size are delta encoded, as the delta encoding makes sense for
+	// large objects with small changes, for example for painted facets of a large mesh.
+	static constexpr size_t delta_min_size  = 1024;
+	static constexpr size_t delta_max_depth = 16;
+
 	Interval    m_interval;
 	Data	   *m_data;
 
 public:
-	MutableHistoryInterval(const Interval &interval, const std::string &input_data) : m_interval(interval), m_data(nullptr) {
-		m_data = (Data*)new char[offsetof(Data, data) + input_data.size()];
-		m_data->refcnt = 1;
-		m_data->size = input_data.size();
-		memcpy(m_data->data, input_data.data(), input_data.size());
-	}
+	MutableHistoryInterval(const Interval &interval, const std::string &input_data) : m_interval(interval), m_data(Data::allocate(input_data.data(), input_data.size())) {}
+
+	// Store the input data delta encoded against the data of the base interval, if it pays off.
+	MutableHistoryInterval(const Interval &interval, const std::string &input_data, const MutableHistoryInterval &base) : m_interval(interval), m_data(Data::encode(input_data, base.m_data)) {}
 
 	MutableHistoryInterval(const Interval &interval, MutableHistoryInterval &other) : m_interval(interval), m_data(other.m_data) {
 		++ m_data->refcnt;
@@ -373,13 +478,19 @@ public:
 	MutableHistoryInterval(const size_t begin, const size_t end) : m_interval(begin, end), m_data(nullptr) {}
 
 	MutableHistoryInterval(MutableHistoryInterval&& rhs) : m_interval(rhs.m_interval), m_data(rhs.m_data) { rhs.m_data = nullptr; }
-	MutableHistoryInterval& operator=(MutableHistoryInterval&& rhs) { m_interval = rhs.m_interval; m_data = rhs.m_data; rhs.m_data = nullptr; return *this; }
-
-	~MutableHistoryInterval() {
-		if (m_data != nullptr && -- m_data->refcnt == 0)
-			delete[] (char*)m_data;
+	MutableHistoryInterval& operator=(MutableHistoryInterval&& rhs) {
+		if (this != &rhs) {
+			// Release the data overwritten, for example when erasing intervals from the history.
+			Data::release(m_data);
+			m_interval = rhs.m_interval;
+			m_data = rhs.m_data;
+			rhs.m_data = nullptr;
+		}
+		return *this;
 	}
 
+	~MutableHistoryInterval() { Data::release(m_data); }
+
 	const Interval& interval() const { return m_interval; }
 	size_t		begin() const { return m_interval.begin(); }
 	size_t		end()   const { return m_interval.end(); }
@@ -391,18 +502,16 @@ public:
 	bool		operator<(const MutableHistoryInterval& rhs) const { return m_interval < rhs.m_interval; }
 	bool 		operator==(const MutableHistoryInterval& rhs) const { return m_interval == rhs.m_interval; }
 
+	// Identifies the data chunk, its content may be delta encoded. Use decode() to get the serialized data.
 	const char* data() const { return m_data->data; }
-	size_t  	size() const { return m_data->size; }
+	size_t  	size() const { return m_data->full_size(); }
 	size_t		refcnt() const { return m_data->refcnt; }
+	bool 		delta_encoded() const { return m_data->base != nullptr; }
+	std::string decode() const { return m_data->decode(); }
 	bool		matches(const std::string& data) { return m_data->matches(data); }
 	bool		matches_timestamp(uint64_t timestamp) { return m_data->matches_timestamp(timestamp); }
-	size_t 		memsize() const {
-		return m_data->refcnt == 1 ?
-			// Count just the size of the snapshot data.
-			m_data->size :
-			// Count the size of the snapshot data divided by the number of references, rounded up.
-			(m_data->size + m_data->refcnt - 1) / m_data->refcnt;
-	}
+	// Count the size of the snapshot data divided by the number of references, rounded up.
+	size_t 		memsize() const { return m_data->memsize(); }
 
 private:
 	MutableHistoryInterval(const MutableHistoryInterval &rhs);
@@ -413,7 +522,8 @@ private:
 // are mutable and there is not tracking of the changes, therefore a snapshot needs to be
 // taken every time and compared to the previous data at the Undo / Redo stack.
 // The serialized data is stored if it is different from the last value on the stack, otherwise
-// the serialized data is discarded.
+// the serialized data is discarded. Large serialized data (for example painted facets) are stored
+// delta encoded against the last value on the stack, see MutableHistoryInterval::Data::encode().
 // The history of a single mutable object may not be continuous, as an mutable object may
 // be removed from the scene while being kept at the Copy / Paste stack, therefore an object snapshot
 // with the same serialized object data may be shared by multiple history intervals.
@@ -459,12 +569,15 @@ public:
 	void save(size_t active_snapshot_time, size_t current_time, const std::string &data) {
 		assert(m_history.empty() || m_history.back().end() <= active_snapshot_time);
 		if (m_history.empty() || m_history.back().end() < active_snapshot_time) {
-			if (! m_history.empty() && m_history.back().matches(data))
+			if (m_history.empty())
+				// Allocate new data.
+				m_history.emplace_back(Interval(current_time, current_time + 1), data);
+			else if (m_history.back().matches(data))
 				// Share the previous data by reference counting.
 				m_history.emplace_back(Interval(current_time, current_time + 1), m_history.back());
 			else
-				// Allocate new data.
-				m_history.emplace_back(Interval(current_time, current_time + 1), data);
+				// Allocate new data, possibly delta encoded against the previous data.
+				m_history.emplace_back(Interval(current_time, current_time + 1), data, m_history.back());
 		} else {
 			assert(! m_history.empty());
 			assert(m_history.back().end() == active_snapshot_time);
@@ -472,8 +585,8 @@ public:
 				// Just extend the last interval using the old data.
 				m_history.back().extend_end(current_time + 1);
 			else
-				// Allocate new data time continuous with the previous data.
-				m_history.emplace_back(Interval(active_snapshot_time, current_time + 1), data);
+				// Allocate new data time continuous with the previous data, possibly delta encoded against the previous data.
+				m_history.emplace_back(Interval(active_snapshot_time, current_time + 1), data, m_history.back());
 		}
 	}
 
@@ -485,7 +598,7 @@ public:
 			-- it;
 		}
 		assert(timestamp >= it->begin() && timestamp < it->end());
-		return std::string(it->data(), it->data() + it->size());
+		return it->decode();
 	}
 
 	// Currently all mutable snapshots are mandatory.
@@ -497,7 +610,7 @@ public:
 	std::string format() override {
 		std::string out = typeid(T).name();
 		for (const MutableHistoryInterval &interval : m_history)
-			out += std::string(", ptr:") + ptr_to_string(interval.data()) + " len:" + std::to_string(interval.size()) + " <" + std::to_string(interval.begin()) + "," + std::to_string(interval.end()) + ")";
+			out += std::string(", ptr:") + ptr_to_string(interval.data()) + " len:" + std::to_string(interval.size()) + (interval.delta_encoded() ? " delta" : "") + " <" + std::to_string(interval.begin()) + "," + std::to_string(interval.end()) + ")";
 		return out;
 	}
 #endif /* SLIC3R_UNDOREDO_DEBUG */
@@ -536,7 +649,8 @@ bool MutableObjectHistory<T>::valid()
 		}
 		for (const auto &hi : m_history) {
 			assert(hi.data() != nullptr);
-			assert(refcntrs[hi.data()] == hi.refcnt());
+			// Data delta encoded against this data hold a reference to it as well.
+			assert(refcntrs[hi.data()] == hi.refcnt() || (refcntrs[hi.data()] < hi.refcnt() && std::any_of(m_history.begin(), m_history.end(), [](const auto &hi2){ return hi2.delta_encoded(); })));
 		}
 	}
 	return true;
@@ -5,6 +5,7 @@
 #include "test_utils.hpp"
 
 #include <libslic3r/Execution/ExecutionSeq.hpp>
+#include <libslic3r/Execution/ExecutionTBB.hpp>
 
 #include <arrange/ArrangeBase.hpp>
 #include <arrange/ArrangeFirstFit.hpp>
@@ -13,6 +14,7 @@
 #include <arrange/NFP/Kernels/GravityKernel.hpp>
 #include <arrange/NFP/Kernels/TMArrangeKernel.hpp>
 #include <arrange/NFP/NFPConcave_Tesselate.hpp>
+#include <arrange/Raster/PackStrategyRaster.hpp>
 
 #include <arrange-wrapper/Items/SimpleArrangeItem.hpp>
 #include <arrange-wrapper/Items/ArrangeItem.hpp>
@@ -464,6 +466,52 @@ TEST_CASE("NFP should be empty if item cannot fit into bed", "[arrange2]") {
     }
 }
 
+TEST_CASE("Cached NFPs of identical fixed items should match the calculated ones", "[arrange2]") {
+    using namespace Slic3r;
+
+    arr2::InfiniteBed bed;
+
+    // A concave shape, so that the NFP is a union of multiple convex NFPs
+    const Polygon lshape{{0, 0}, {scaled(20.), 0}, {scaled(20.), scaled(5.)},
+                         {scaled(5.), scaled(5.)}, {scaled(5.), scaled(20.)}, {0, scaled(20.)}};
+
+    std::vector<ArrangeItem> fixed_items(3, ArrangeItem{lshape});
+    for (size_t i = 0; i < fixed_items.size(); ++i)
+        arr2::translate(fixed_items[i], Vec2crd{scaled(50.) * coord_t(i), scaled(10.) * coord_t(i)});
+    arr2::rotate(fixed_items[2], PI / 2.);
+
+    auto fixed_context = default_context(fixed_items);
+
+    ArrangeItem orbiter{lshape};
+    auto area = [](const ExPolygons &nfp) {
+        return std::accumulate(nfp.begin(), nfp.end(), 0.,
+                               [](double a, const ExPolygon &p) { return a + p.area(); });
+    };
+
+    for (double rot : {0., PI / 4., 0.}) {
+        arr2::set_rotation(orbiter, rot);
+        ExPolygons nfp = arr2::calculate_nfp(orbiter, fixed_context, bed);
+
+        ArrangeItem fresh{lshape};
+        arr2::set_rotation(fresh, rot);
+        ExPolygons nfp_fresh = arr2::calculate_nfp(fresh, fixed_context, bed);
+
+        REQUIRE(!nfp.empty());
+        REQUIRE(nfp.size() == nfp_fresh.size());
+        REQUIRE(area(nfp) == Approx(area(nfp_fresh)));
+    }
+
+    // Moving the fixed items keeps the cached NFPs valid.
+    ExPolygons nfp_before = arr2::calculate_nfp(orbiter, fixed_context, bed);
+    for (ArrangeItem &itm : fixed_items)
+        arr2::translate(itm, Vec2crd{scaled(3.), -scaled(7.)});
+
+    ExPolygons nfp = arr2::calculate_nfp(orbiter, fixed_context, bed);
+    REQUIRE(nfp.size() == nfp_before.size());
+    REQUIRE(area(nfp) == Approx(area(nfp_before)));
+    REQUIRE(get_extents(nfp).min == Point(get_extents(nfp_before).min + Vec2crd{scaled(3.), -scaled(7.)}));
+}
+
 #include <boost/filesystem/path.hpp>
 #include <boost/filesystem.hpp>
 
@@ -1068,3 +1116,66 @@ TEMPLATE_TEST_CASE("Test if allowed item rotations are considered", "[arrange2]"
     REQUIRE(get_rotation(itm) == Approx(PI));
 }
 
+
+TEST_CASE("Rotations evaluated in parallel should match the sequential evaluation", "[arrange2]")
+{
+    using namespace Slic3r;
+
+    const Polygon lshape{{0, 0}, {scaled(20.), 0}, {scaled(20.), scaled(5.)},
+                         {scaled(5.), scaled(5.)}, {scaled(5.), scaled(20.)}, {0, scaled(20.)}};
+
+    auto bed = arr2::RectangleBed{scaled(100.), scaled(100.)};
+
+    arr2::ArrangeItem fixed{lshape};
+    arr2::translate(fixed, Vec2crd{scaled(40.), scaled(40.)});
+    arr2::set_bed_index(fixed, 0);
+    std::vector<arr2::ArrangeItem> fixed_items = {fixed};
+
+    auto pack_item = [&](const auto &ep) {
+        arr2::ArrangeItem itm{lshape};
+        set_allowed_rotations(itm, {0., PI / 2., PI, 3. * PI / 2., PI / 4.});
+        arr2::PackStrategyNFP strategy{arr2::GravityKernel{}, ep};
+        auto context = default_context(fixed_items);
+        std::vector<arr2::ArrangeItem> remaining;
+        bool packed = pack(strategy, bed, itm, context, crange(remaining));
+        REQUIRE(packed);
+
+        return itm;
+    };
+
+    arr2::ArrangeItem itm_seq = pack_item(ex_seq);
+    arr2::ArrangeItem itm_tbb = pack_item(ex_tbb);
+
+    REQUIRE(get_rotation(itm_seq) == Approx(get_rotation(itm_tbb)));
+    REQUIRE(get_translation(itm_seq) == get_translation(itm_tbb));
+}
+
+TEST_CASE("Items packed onto an occupancy grid should not overlap", "[arrange2]")
+{
+    using namespace Slic3r;
+
+    auto bed = arr2::RectangleBed{scaled(250.), scaled(210.)};
+
+    std::vector<arr2::ArrangeItem> items;
+    for (int i = 0; i < 200; ++i) {
+        coord_t w = scaled(5. + i % 7);
+        coord_t h = scaled(5. + i % 11);
+        arr2::ArrangeItem itm{arr2::to_rectangle(BoundingBox{{0, 0}, {w, h}})};
+        set_allowed_rotations(itm, {0., PI / 4.});
+        items.emplace_back(std::move(itm));
+    }
+
+    arr2::PackStrategyRaster strategy{ex_tbb};
+    arr2::arrange(arr2::firstfit::SelectionStrategy{}, strategy, range(items), bed);
+
+    BoundingBox bedbb = bounding_box(bed);
+    for (size_t i = 0; i < items.size(); ++i) {
+        REQUIRE(arr2::get_bed_index(items[i]) == 0);
+
+        Polygons outline = arr2::fixed_outline(items[i]);
+        REQUIRE(bedbb.contains(get_extents(outline)));
+
+        for (size_t j = i + 1; j < items.size(); ++j)
+            REQUIRE(intersection(outline, arr2::fixed_outline(items[j])).empty());
+    }
+}
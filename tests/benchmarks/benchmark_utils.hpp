@@ -0,0 +1,88 @@
+// Measurement helpers shared by the benchmark executables.
+
+#ifndef slic3r_benchmark_utils_hpp_
+#define slic3r_benchmark_utils_hpp_
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/nowide/fstream.hpp>
+
+#ifdef _WIN32
+    #include <windows.h>
+    #include <psapi.h>
+#else
+    #include <sys/resource.h>
+#endif
+
+namespace Slic3r {
+namespace Benchmark {
+
+// User + system time of all threads of this process, in seconds.
+inline double process_cpu_time()
+{
+#ifdef _WIN32
+    FILETIME creation_time, exit_time, kernel_time, user_time;
+    if (! GetProcessTimes(GetCurrentProcess(), &creation_time, &exit_time, &kernel_time, &user_time))
+        return 0.;
+    auto to_seconds = [](const FILETIME &ft) { return double((uint64_t(ft.dwHighDateTime) << 32) | ft.dwLowDateTime) * 1e-7; };
+    return to_seconds(kernel_time) + to_seconds(user_time);
+#else
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0.;
+    return double(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) + double(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1e-6;
+#endif
+}
+
+// On Linux the peak resident set size may be reset, so that the peak of each step is measured separately.
+// On the other platforms the peak of the whole process so far is reported.
+inline void reset_peak_rss()
+{
+#ifdef __linux__
+    if (FILE *f = fopen("/proc/self/clear_refs", "w")) {
+        fputs("5", f);
+        fclose(f);
+    }
+#endif
+}
+
+inline size_t peak_rss()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS pmc;
+    return GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)) ? size_t(pmc.PeakWorkingSetSize) : 0;
+#elif defined(__linux__)
+    // VmHWM follows the reset by clear_refs, unlike getrusage().
+    boost::nowide::ifstream status("/proc/self/status");
+    for (std::string line; std::getline(status, line);)
+        if (boost::starts_with(line, "VmHWM:"))
+            return size_t(std::atoll(line.c_str() + 6)) * 1024;
+    return 0;
+#else
+    rusage usage;
+    // ru_maxrss is in bytes on macOS.
+    return getrusage(RUSAGE_SELF, &usage) == 0 ? size_t(usage.ru_maxrss) : 0;
+#endif
+}
+
+// Write the statistics of the samples of a single value as a JSON object member.
+inline void write_json_stats(std::ostream &os, const char *name, std::vector<double> values, bool last)
+{
+    std::sort(values.begin(), values.end());
+    double sum = 0.;
+    for (double v : values)
+        sum += v;
+    os << "          \"" << name << "\": { \"min\": " << values.front() << ", \"median\": " << values[values.size() / 2] <<
+        ", \"mean\": " << sum / double(values.size()) << ", \"max\": " << values.back() << " }" << (last ? "\n" : ",\n");
+}
+
+} // namespace Benchmark
+} // namespace Slic3r
+
+#endif // slic3r_benchmark_utils_hpp_
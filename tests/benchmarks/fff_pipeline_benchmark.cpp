@@ -0,0 +1,251 @@
+// Benchmark of the FFF slicing pipeline.
+//
+// Loads a corpus of models, slices each of them with each of the configs and measures
+// every PrintObjectStep and PrintStep in isolation: Print::set_task() is used to stop the processing
+// after a single step, thus each Print::process() call only executes the step being measured.
+// The results are written as JSON, so that they may be compared between releases.
+//
+// Usage:
+//     fff_pipeline_benchmark [--repeat N] [--config file.ini]... [--output results.json] [model.stl|obj|3mf]...
+// Without models / configs a default corpus from tests/data is used.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/nowide/fstream.hpp>
+
+#include "libslic3r/libslic3r.h"
+#include "libslic3r/BoundingBox.hpp"
+#include "libslic3r/FileReader.hpp"
+#include "libslic3r/Model.hpp"
+#include "libslic3r/Print.hpp"
+#include "libslic3r/PrintConfig.hpp"
+#include "libslic3r/Utils.hpp"
+
+#include "benchmark_utils.hpp"
+
+// Count all allocations going through the global operator new.
+// Allocations made by the TBB scalable allocator or by malloc() directly are not counted.
+static std::atomic<size_t> g_num_allocations { 0 };
+static std::atomic<size_t> g_allocated_bytes { 0 };
+
+static void* counted_alloc(std::size_t size)
+{
+    ++ g_num_allocations;
+    g_allocated_bytes += size;
+    if (void *ptr = std::malloc(size == 0 ? 1 : size))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size) { return counted_alloc(size); }
+void* operator new[](std::size_t size) { return counted_alloc(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { try { return counted_alloc(size); } catch (...) { return nullptr; } }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { try { return counted_alloc(size); } catch (...) { return nullptr; } }
+void  operator delete(void *ptr) noexcept { std::free(ptr); }
+void  operator delete[](void *ptr) noexcept { std::free(ptr); }
+void  operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+void  operator delete[](void *ptr, std::size_t) noexcept { std::free(ptr); }
+
+namespace Slic3r {
+namespace Benchmark {
+
+struct Sample
+{
+    double  wall_time { 0. };
+    double  cpu_time  { 0. };
+    size_t  peak_rss  { 0 };
+    size_t  allocations { 0 };
+    size_t  allocated_bytes { 0 };
+};
+
+template<typename Fn>
+static Sample measure(Fn &&fn)
+{
+    reset_peak_rss();
+    const size_t num_allocations = g_num_allocations;
+    const size_t allocated_bytes = g_allocated_bytes;
+    const double cpu_start       = process_cpu_time();
+    const auto   wall_start      = std::chrono::steady_clock::now();
+    fn();
+    Sample out;
+    out.wall_time       = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+    out.cpu_time        = process_cpu_time() - cpu_start;
+    out.peak_rss        = peak_rss();
+    out.allocations     = g_num_allocations - num_allocations;
+    out.allocated_bytes = g_allocated_bytes - allocated_bytes;
+    return out;
+}
+
+static const char* object_step_name(PrintObjectStep step)
+{
+    switch (step) {
+    case posSlice:                          return "posSlice";
+    case posPerimeters:                     return "posPerimeters";
+    case posPrepareInfill:                  return "posPrepareInfill";
+    case posInfill:                         return "posInfill";
+    case posIroning:                        return "posIroning";
+    case posSupportSpotsSearch:             return "posSupportSpotsSearch";
+    case posSupportMaterial:                return "posSupportMaterial";
+    case posEstimateCurledExtrusions:       return "posEstimateCurledExtrusions";
+    case posCalculateOverhangingPerimeters: return "posCalculateOverhangingPerimeters";
+    default:                                return "unknown";
+    }
+}
+
+static const char* print_step_name(PrintStep step)
+{
+    switch (step) {
+    case psWipeTower:               return "psWipeTower";
+    case psAlertWhenSupportsNeeded: return "psAlertWhenSupportsNeeded";
+    case psSkirtBrim:               return "psSkirtBrim";
+    case psGCodeExport:             return "psGCodeExport";
+    default:                        return "unknown";
+    }
+}
+
+using StepSamples = std::vector<std::pair<std::string, std::vector<Sample>>>;
+
+// Run the whole pipeline step by step, append a sample for each step.
+static void run_pipeline(const Model &model, const DynamicPrintConfig &config, const std::string &gcode_path, StepSamples &samples)
+{
+    Print print;
+    print.set_status_silent();
+    print.apply(model, config);
+    if (std::string err = print.validate(); ! err.empty())
+        throw Slic3r::RuntimeError(err);
+
+    size_t idx_sample = 0;
+    auto add_sample = [&samples, &idx_sample](const char *name, const Sample &sample) {
+        if (idx_sample == samples.size())
+            samples.push_back({ name, {} });
+        samples[idx_sample ++].second.emplace_back(sample);
+    };
+    auto run_task = [&print](const PrintBase::TaskParams &params) {
+        print.set_task(params);
+        print.process();
+        print.finalize();
+    };
+
+    for (int step = 0; step < int(posCount); ++ step) {
+        PrintBase::TaskParams params;
+        params.to_object_step = step;
+        add_sample(object_step_name(PrintObjectStep(step)), measure([&run_task, &params]() { run_task(params); }));
+    }
+    for (int step = 0; step < int(psGCodeExport); ++ step) {
+        PrintBase::TaskParams params;
+        params.to_print_step = step;
+        add_sample(print_step_name(PrintStep(step)), measure([&run_task, &params]() { run_task(params); }));
+    }
+    add_sample(print_step_name(psGCodeExport), measure([&print, &gcode_path]() { print.export_gcode(gcode_path, nullptr, nullptr); }));
+}
+
+static void write_json(std::ostream &os, const std::vector<std::pair<std::string, StepSamples>> &results, int repeat)
+{
+    os << "{\n  \"repeat\": " << repeat << ",\n  \"runs\": [\n";
+    for (size_t irun = 0; irun < results.size(); ++ irun) {
+        os << "    {\n      \"name\": \"" << results[irun].first << "\",\n      \"steps\": [\n";
+        const StepSamples &steps = results[irun].second;
+        for (size_t istep = 0; istep < steps.size(); ++ istep) {
+            const std::vector<Sample> &samples = steps[istep].second;
+            std::vector<double> wall, cpu, rss, allocs, bytes;
+            for (const Sample &s : samples) {
+                wall.emplace_back(s.wall_time);
+                cpu.emplace_back(s.cpu_time);
+                rss.emplace_back(double(s.peak_rss));
+                allocs.emplace_back(double(s.allocations));
+                bytes.emplace_back(double(s.allocated_bytes));
+            }
+            os << "        {\n          \"step\": \"" << steps[istep].first << "\",\n";
+            write_json_stats(os, "wall_time_s", wall, false);
+            write_json_stats(os, "cpu_time_s", cpu, false);
+            write_json_stats(os, "peak_rss_bytes", rss, false);
+            write_json_stats(os, "allocations", allocs, false);
+            write_json_stats(os, "allocated_bytes", bytes, true);
+            os << "        }" << (istep + 1 < steps.size() ? ",\n" : "\n");
+        }
+        os << "      ]\n    }" << (irun + 1 < results.size() ? ",\n" : "\n");
+    }
+    os << "  ]\n}\n";
+}
+
+} // namespace Benchmark
+} // namespace Slic3r
+
+int main(int argc, char **argv)
+{
+    using namespace Slic3r;
+    namespace fs = boost::filesystem;
+
+    int                      repeat = 3;
+    std::string              output;
+    std::vector<std::string> models;
+    std::vector<std::string> configs;
+    for (int i = 1; i < argc; ++ i) {
+        std::string arg = argv[i];
+        if (arg == "--repeat" && i + 1 < argc)
+            repeat = std::max(1, atoi(argv[++ i]));
+        else if (arg == "--config" && i + 1 < argc)
+            configs.emplace_back(argv[++ i]);
+        else if (arg == "--output" && i + 1 < argc)
+            output = argv[++ i];
+        else if (arg == "--help" || arg == "-h") {
+            std::cout << "Usage: " << argv[0] << " [--repeat N] [--config file.ini]... [--output results.json] [model]..." << std::endl;
+            return EXIT_SUCCESS;
+        } else
+            models.emplace_back(arg);
+    }
+
+    const fs::path data_dir(TEST_DATA_DIR);
+    if (models.empty())
+        for (const char *name : { "20mm_cube.obj", "extruder_idler.obj", "frog_legs.obj", "ipadstand.obj", "overhang.obj", "pyramid.obj" })
+            models.emplace_back((data_dir / name).string());
+    if (configs.empty())
+        configs.emplace_back((data_dir / "default_fff.ini").string());
+
+    set_logging_level(1);
+
+    const std::string gcode_path = (fs::temp_directory_path() / fs::unique_path("fff_pipeline_benchmark-%%%%-%%%%.gcode")).string();
+    std::vector<std::pair<std::string, Benchmark::StepSamples>> results;
+    try {
+        for (const std::string &config_path : configs) {
+            DynamicPrintConfig config = DynamicPrintConfig::full_print_config();
+            config.load_from_ini(config_path, ForwardCompatibilitySubstitutionRule::Enable);
+            const Vec2d bed_center = BoundingBoxf(config.opt<ConfigOptionPoints>("bed_shape")->values).center();
+            for (const std::string &model_path : models) {
+                Model model = FileReader::load_model(model_path);
+                for (ModelObject *object : model.objects)
+                    object->ensure_on_bed();
+                model.center_instances_around_point(bed_center);
+                std::string name = fs::path(model_path).filename().string() + " / " + fs::path(config_path).filename().string();
+                std::cerr << "Benchmarking " << name << std::endl;
+                Benchmark::StepSamples samples;
+                for (int i = 0; i < repeat; ++ i)
+                    Benchmark::run_pipeline(model, config, gcode_path, samples);
+                results.emplace_back(std::move(name), std::move(samples));
+            }
+        }
+    } catch (const std::exception &ex) {
+        std::cerr << "Benchmark failed: " << ex.what() << std::endl;
+        fs::remove(gcode_path);
+        return EXIT_FAILURE;
+    }
+    fs::remove(gcode_path);
+
+    if (output.empty())
+        Benchmark::write_json(std::cout, results, repeat);
+    else {
+        boost::nowide::ofstream os(output);
+        Benchmark::write_json(os, results, repeat);
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,463 @@
+// Benchmark of the SLA pipeline and of the G-code processing.
+//
+// Processes a corpus of models by the SLA print and measures every SLAPrintObjectStep and SLAPrintStep
+// in isolation the same way as fff_pipeline_benchmark does, followed by the export of the archive.
+// Then it measures the sampling of the support points of the islands from tests/data/sla_islands
+// and GCodeProcessor::process_file() of a synthetic G-code generated from a fixed seed, thus all the inputs
+// are reproducible. For each stage the wall time, the throughput and the peak memory are reported as JSON.
+//
+// With --baseline the median wall times are compared against the JSON written by a previous run.
+// The benchmark fails if a stage got slower by more than the tolerance (0.1 = 10%).
+//
+// Usage:
+//     sla_pipeline_benchmark [--repeat N] [--config file.ini]... [--gcode-layers N] [--output results.json]
+//                            [--baseline baseline.json] [--tolerance 0.1] [model.stl|obj|3mf]...
+// Without models / configs a default corpus from tests/data and the default SLA config are used.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/nowide/fstream.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include "libslic3r/libslic3r.h"
+#include "libslic3r/BoundingBox.hpp"
+#include "libslic3r/FileReader.hpp"
+#include "libslic3r/Model.hpp"
+#include "libslic3r/NSVGUtils.hpp"
+#include "libslic3r/PrintConfig.hpp"
+#include "libslic3r/SLAPrint.hpp"
+#include "libslic3r/Utils.hpp"
+#include "libslic3r/GCode/GCodeProcessor.hpp"
+#include "libslic3r/SLA/SupportIslands/SampleConfigFactory.hpp"
+#include "libslic3r/SLA/SupportIslands/UniformSupportIsland.hpp"
+
+#include "benchmark_utils.hpp"
+
+namespace Slic3r {
+namespace Benchmark {
+
+struct Sample
+{
+    double  wall_time { 0. };
+    double  cpu_time  { 0. };
+    size_t  peak_rss  { 0 };
+};
+
+template<typename Fn>
+static Sample measure(Fn &&fn)
+{
+    reset_peak_rss();
+    const double cpu_start  = process_cpu_time();
+    const auto   wall_start = std::chrono::steady_clock::now();
+    fn();
+    Sample out;
+    out.wall_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+    out.cpu_time  = process_cpu_time() - cpu_start;
+    out.peak_rss  = peak_rss();
+    return out;
+}
+
+using StepSamples = std::vector<std::pair<std::string, std::vector<Sample>>>;
+
+struct Run
+{
+    std::string name;
+    // What the throughput is measured in, for example "layers".
+    std::string unit;
+    // Number of units processed by each step.
+    size_t      count { 0 };
+    StepSamples steps;
+};
+
+static void add_sample(StepSamples &samples, size_t &idx_sample, const char *name, const Sample &sample)
+{
+    if (idx_sample == samples.size())
+        samples.push_back({ name, {} });
+    samples[idx_sample ++].second.emplace_back(sample);
+}
+
+static const char* object_step_name(SLAPrintObjectStep step)
+{
+    switch (step) {
+    case slaposAssembly:      return "slaposAssembly";
+    case slaposHollowing:     return "slaposHollowing";
+    case slaposDrillHoles:    return "slaposDrillHoles";
+    case slaposObjectSlice:   return "slaposObjectSlice";
+    case slaposSupportPoints: return "slaposSupportPoints";
+    case slaposSupportTree:   return "slaposSupportTree";
+    case slaposPad:           return "slaposPad";
+    case slaposSliceSupports: return "slaposSliceSupports";
+    default:                  return "unknown";
+    }
+}
+
+static const char* print_step_name(SLAPrintStep step)
+{
+    switch (step) {
+    case slapsMergeSlicesAndEval: return "slapsMergeSlicesAndEval";
+    case slapsRasterize:          return "slapsRasterize";
+    default:                      return "unknown";
+    }
+}
+
+// Default SLA config with the supports, the pad and the hollowing enabled, so that all the steps have some work to do.
+static DynamicPrintConfig default_sla_config()
+{
+    SLAFullPrintConfig full_config;
+    full_config.printer_technology.setInt(ptSLA);
+    full_config.set("supports_enable", true);
+    full_config.set("pad_enable", true);
+    full_config.set("hollowing_enable", true);
+    DynamicPrintConfig config;
+    config.apply(full_config);
+    return config;
+}
+
+// Run the whole SLA pipeline step by step, append a sample for each step. Returns the number of the printed layers.
+static size_t run_sla_pipeline(const Model &model, const DynamicPrintConfig &config, const std::string &archive_path, StepSamples &samples)
+{
+    SLAPrint print;
+    print.set_status_silent();
+    print.apply(model, config);
+    if (std::string err = print.validate(); ! err.empty())
+        throw Slic3r::RuntimeError(err);
+
+    size_t idx_sample = 0;
+    auto run_task = [&print](const PrintBase::TaskParams &params) {
+        print.set_task(params);
+        print.process();
+        print.finalize();
+    };
+
+    for (int step = 0; step < int(slaposCount); ++ step) {
+        PrintBase::TaskParams params;
+        params.to_object_step = step;
+        add_sample(samples, idx_sample, object_step_name(SLAPrintObjectStep(step)), measure([&run_task, &params]() { run_task(params); }));
+    }
+    for (int step = 0; step < int(slapsCount); ++ step) {
+        PrintBase::TaskParams params;
+        params.to_print_step = step;
+        add_sample(samples, idx_sample, print_step_name(SLAPrintStep(step)), measure([&run_task, &params]() { run_task(params); }));
+    }
+    add_sample(samples, idx_sample, "export", measure([&print, &archive_path]() { print.export_print(archive_path); }));
+    return print.print_layers().size();
+}
+
+// The shapes stroked in the SVG files, the last path of a shape is its contour, the other paths are its holes.
+static ExPolygons load_islands(const std::string &svg_path)
+{
+    ExPolygons out;
+    NSVGimage_ptr image = nsvgParseFromFile(svg_path, "px", 96.f);
+    if (! image)
+        throw Slic3r::RuntimeError("Failed to load " + svg_path);
+    auto to_polygon = [](const NSVGpath *path) {
+        Polygon out;
+        out.points.reserve(path->npts);
+        for (int i = 0; i < path->npts; ++ i)
+            out.points.emplace_back(coord_t(path->pts[2 * i]), coord_t(path->pts[2 * i + 1]));
+        return out;
+    };
+    for (const NSVGshape *shape = image->shapes; shape != nullptr; shape = shape->next) {
+        if (! (shape->flags & NSVG_FLAGS_VISIBLE) || shape->fill.type != NSVG_PAINT_NONE || shape->stroke.type == NSVG_PAINT_NONE)
+            continue;
+        ExPolygon island;
+        for (const NSVGpath *path = shape->paths; path != nullptr; path = path->next)
+            if (path->next == nullptr)
+                island.contour = to_polygon(path);
+            else
+                island.holes.emplace_back(to_polygon(path));
+        out.emplace_back(std::move(island));
+    }
+    return out;
+}
+
+// Generate a G-code resembling the output of PrusaSlicer: per layer a few features of random extrusion moves
+// inside the bed, with the tags and the full config block, so that GCodeProcessor processes it the same way
+// as a G-code exported by PrusaSlicer.
+static void write_synthetic_gcode(const std::string &path, size_t num_layers, unsigned int seed)
+{
+    static constexpr size_t MovesPerFeature = 250;
+    static const char      *features[]      = { "External perimeter", "Perimeter", "Internal infill", "Solid infill" };
+
+    std::mt19937                           rng(seed);
+    std::uniform_real_distribution<double> angle_distribution(0., 2. * PI);
+    std::uniform_real_distribution<double> length_distribution(0.5, 10.);
+    std::uniform_real_distribution<double> x_distribution(10., 240.);
+    std::uniform_real_distribution<double> y_distribution(10., 200.);
+
+    boost::nowide::ofstream os(path);
+    if (! os)
+        throw Slic3r::RuntimeError("Failed to open " + path);
+    os << std::fixed << std::setprecision(3);
+    os << "; generated by PrusaSlicer\n\nG21\nG90\nM83\nM107\nG28\n";
+    for (size_t layer = 0; layer < num_layers; ++ layer) {
+        const double z = 0.2 * double(layer + 1);
+        os << ";LAYER_CHANGE\n;Z:" << z << "\n;HEIGHT:0.2\nG1 Z" << z << " F720\n";
+        for (const char *feature : features) {
+            double x = x_distribution(rng);
+            double y = y_distribution(rng);
+            os << ";TYPE:" << feature << "\n;WIDTH:0.45\nG1 X" << x << " Y" << y << " F9000\nG1 F1800\n";
+            for (size_t i = 0; i < MovesPerFeature; ++ i) {
+                const double length = length_distribution(rng);
+                const double angle  = angle_distribution(rng);
+                const double nx     = std::clamp(x + length * std::cos(angle), 10., 240.);
+                const double ny     = std::clamp(y + length * std::sin(angle), 10., 200.);
+                os << "G1 X" << nx << " Y" << ny << " E" << 0.0333 * std::hypot(nx - x, ny - y) << "\n";
+                x = nx;
+                y = ny;
+            }
+        }
+    }
+    os << "M107\nM84\n";
+
+    const DynamicPrintConfig config = DynamicPrintConfig::full_print_config();
+    os << "\n; prusaslicer_config = begin\n";
+    for (const std::string &key : config.keys())
+        os << "; " << key << " = " << config.opt_serialize(key) << "\n";
+    os << "; prusaslicer_config = end\n";
+}
+
+static void write_json(std::ostream &os, const std::vector<Run> &runs, int repeat)
+{
+    os << "{\n  \"repeat\": " << repeat << ",\n  \"runs\": [\n";
+    for (size_t irun = 0; irun < runs.size(); ++ irun) {
+        const Run &run = runs[irun];
+        os << "    {\n      \"name\": \"" << run.name << "\",\n      \"unit\": \"" << run.unit << "\",\n      \"count\": " << run.count <<
+            ",\n      \"steps\": [\n";
+        const std::string throughput = run.unit + "_per_s";
+        for (size_t istep = 0; istep < run.steps.size(); ++ istep) {
+            const std::vector<Sample> &samples = run.steps[istep].second;
+            std::vector<double> wall, cpu, rss, rate;
+            for (const Sample &s : samples) {
+                wall.emplace_back(s.wall_time);
+                cpu.emplace_back(s.cpu_time);
+                rss.emplace_back(double(s.peak_rss));
+                rate.emplace_back(s.wall_time > 0. ? double(run.count) / s.wall_time : 0.);
+            }
+            os << "        {\n          \"step\": \"" << run.steps[istep].first << "\",\n";
+            write_json_stats(os, "wall_time_s", wall, false);
+            write_json_stats(os, "cpu_time_s", cpu, false);
+            write_json_stats(os, "peak_rss_bytes", rss, false);
+            write_json_stats(os, throughput.c_str(), rate, true);
+            os << "        }" << (istep + 1 < run.steps.size() ? ",\n" : "\n");
+        }
+        os << "      ]\n    }" << (irun + 1 < runs.size() ? ",\n" : "\n");
+    }
+    os << "  ]\n}\n";
+}
+
+static double median_wall_time(const std::vector<Sample> &samples)
+{
+    std::vector<double> wall;
+    for (const Sample &s : samples)
+        wall.emplace_back(s.wall_time);
+    std::sort(wall.begin(), wall.end());
+    return wall[wall.size() / 2];
+}
+
+// Compare the median wall times of the steps against a JSON written by a previous run.
+// Returns false if any step got slower by more than the tolerance. Differences below 10 ms are considered noise.
+static bool compare_with_baseline(const std::string &baseline_path, const std::vector<Run> &runs, double tolerance)
+{
+    static constexpr double NoiseThreshold = 0.01;
+
+    namespace pt = boost::property_tree;
+    pt::ptree tree;
+    boost::nowide::ifstream is(baseline_path);
+    pt::read_json(is, tree);
+
+    std::map<std::pair<std::string, std::string>, double> baseline;
+    for (const auto &run : tree.get_child("runs"))
+        for (const auto &step : run.second.get_child("steps"))
+            baseline[{ run.second.get<std::string>("name"), step.second.get<std::string>("step") }] = step.second.get<double>("wall_time_s.median");
+
+    bool ok = true;
+    std::cerr << std::fixed << std::setprecision(3);
+    for (const Run &run : runs)
+        for (const auto &[step, samples] : run.steps) {
+            auto it = baseline.find({ run.name, step });
+            if (it == baseline.end()) {
+                std::cerr << run.name << " / " << step << ": not in the baseline" << std::endl;
+                continue;
+            }
+            const double current  = median_wall_time(samples);
+            const double previous = it->second;
+            const bool   slower   = current > previous * (1. + tolerance) && current - previous > NoiseThreshold;
+            std::cerr << run.name << " / " << step << ": " << current << " s, baseline " << previous << " s";
+            if (previous > 0.)
+                std::cerr << ", " << std::showpos << 100. * (current / previous - 1.) << std::noshowpos << " %";
+            std::cerr << (slower ? "  SLOWER" : "") << std::endl;
+            ok &= ! slower;
+        }
+    return ok;
+}
+
+} // namespace Benchmark
+} // namespace Slic3r
+
+int main(int argc, char **argv)
+{
+    using namespace Slic3r;
+    namespace fs = boost::filesystem;
+
+    int                      repeat       = 3;
+    size_t                   gcode_layers = 1000;
+    double                   tolerance    = 0.1;
+    std::string              output;
+    std::string              baseline;
+    std::vector<std::string> models;
+    std::vector<std::string> configs;
+    for (int i = 1; i < argc; ++ i) {
+        std::string arg = argv[i];
+        if (arg == "--repeat" && i + 1 < argc)
+            repeat = std::max(1, atoi(argv[++ i]));
+        else if (arg == "--config" && i + 1 < argc)
+            configs.emplace_back(argv[++ i]);
+        else if (arg == "--gcode-layers" && i + 1 < argc)
+            gcode_layers = size_t(std::max(1, atoi(argv[++ i])));
+        else if (arg == "--output" && i + 1 < argc)
+            output = argv[++ i];
+        else if (arg == "--baseline" && i + 1 < argc)
+            baseline = argv[++ i];
+        else if (arg == "--tolerance" && i + 1 < argc)
+            tolerance = std::max(0., atof(argv[++ i]));
+        else if (arg == "--help" || arg == "-h") {
+            std::cout << "Usage: " << argv[0] << " [--repeat N] [--config file.ini]... [--gcode-layers N] [--output results.json]"
+                " [--baseline baseline.json] [--tolerance 0.1] [model]..." << std::endl;
+            return EXIT_SUCCESS;
+        } else
+            models.emplace_back(arg);
+    }
+
+    const fs::path data_dir(TEST_DATA_DIR);
+    if (models.empty())
+        for (const char *name : { "20mm_cube.obj", "extruder_idler.obj", "frog_legs.obj", "cube_with_concave_hole_enlarged.obj" })
+            models.emplace_back((data_dir / name).string());
+
+    set_logging_level(1);
+
+    const fs::path archive_path = fs::temp_directory_path() / fs::unique_path("sla_pipeline_benchmark-%%%%-%%%%.sl1");
+    const fs::path gcode_path   = fs::temp_directory_path() / fs::unique_path("sla_pipeline_benchmark-%%%%-%%%%.gcode");
+    auto remove_files = [&archive_path, &gcode_path]() {
+        boost::system::error_code ec;
+        fs::remove(archive_path, ec);
+        fs::remove(gcode_path, ec);
+    };
+
+    std::vector<Benchmark::Run> runs;
+    try {
+        // SLA pipeline.
+        std::vector<std::pair<std::string, DynamicPrintConfig>> sla_configs;
+        if (configs.empty())
+            sla_configs.emplace_back("default", Benchmark::default_sla_config());
+        else
+            for (const std::string &config_path : configs) {
+                DynamicPrintConfig config = Benchmark::default_sla_config();
+                config.load_from_ini(config_path, ForwardCompatibilitySubstitutionRule::Enable);
+                sla_configs.emplace_back(fs::path(config_path).filename().string(), std::move(config));
+            }
+        for (const auto &[config_name, config] : sla_configs) {
+            const Vec2d bed_center = BoundingBoxf(config.opt<ConfigOptionPoints>("bed_shape")->values).center();
+            for (const std::string &model_path : models) {
+                Model model = FileReader::load_model(model_path);
+                for (ModelObject *object : model.objects)
+                    object->ensure_on_bed();
+                model.center_instances_around_point(bed_center);
+                Benchmark::Run run;
+                run.name = fs::path(model_path).filename().string() + " / " + config_name;
+                run.unit = "layers";
+                std::cerr << "Benchmarking " << run.name << std::endl;
+                for (int i = 0; i < repeat; ++ i)
+                    run.count = Benchmark::run_sla_pipeline(model, config, archive_path.string(), run.steps);
+                runs.emplace_back(std::move(run));
+            }
+        }
+
+        // Support points of the islands, each island rotated to several angles.
+        {
+            std::vector<fs::path> svg_paths;
+            for (const fs::directory_entry &entry : fs::directory_iterator(data_dir / "sla_islands"))
+                if (entry.path().extension() == ".svg")
+                    svg_paths.emplace_back(entry.path());
+            // Keep the order of the islands independent of the file system.
+            std::sort(svg_paths.begin(), svg_paths.end());
+            ExPolygons islands;
+            for (const fs::path &svg_path : svg_paths)
+                append(islands, Benchmark::load_islands(svg_path.string()));
+            ExPolygons rotated;
+            for (int i = 0; i < 6; ++ i)
+                for (ExPolygon island : islands) {
+                    island.rotate(PI * double(i) / 6.);
+                    rotated.emplace_back(std::move(island));
+                }
+            const sla::SampleConfig sample_config = sla::SampleConfigFactory::create(0.4f);
+            Benchmark::Run run;
+            run.name  = "sla_islands";
+            run.unit  = "islands";
+            run.count = rotated.size();
+            std::cerr << "Benchmarking " << run.name << std::endl;
+            for (int i = 0; i < repeat; ++ i) {
+                size_t idx_sample = 0;
+                Benchmark::add_sample(run.steps, idx_sample, "uniform_support_island", Benchmark::measure([&rotated, &sample_config]() {
+                    for (const ExPolygon &island : rotated)
+                        sla::uniform_support_island(island, {}, sample_config);
+                }));
+            }
+            runs.emplace_back(std::move(run));
+        }
+
+        // Loading of a large G-code.
+        {
+            Benchmark::write_synthetic_gcode(gcode_path.string(), gcode_layers, 0);
+            Benchmark::Run run;
+            run.name  = "synthetic.gcode";
+            run.unit  = "layers";
+            run.count = gcode_layers;
+            std::cerr << "Benchmarking " << run.name << std::endl;
+            for (int i = 0; i < repeat; ++ i) {
+                size_t idx_sample = 0;
+                Benchmark::add_sample(run.steps, idx_sample, "GCodeProcessor::process_file", Benchmark::measure([&gcode_path]() {
+                    GCodeProcessor processor;
+                    processor.process_file(gcode_path.string());
+                }));
+            }
+            runs.emplace_back(std::move(run));
+        }
+    } catch (const std::exception &ex) {
+        std::cerr << "Benchmark failed: " << ex.what() << std::endl;
+        remove_files();
+        return EXIT_FAILURE;
+    }
+    remove_files();
+
+    if (output.empty())
+        Benchmark::write_json(std::cout, runs, repeat);
+    else {
+        boost::nowide::ofstream os(output);
+        Benchmark::write_json(os, runs, repeat);
+    }
+
+    if (! baseline.empty()) {
+        try {
+            if (! Benchmark::compare_with_baseline(baseline, runs, tolerance))
+                return EXIT_FAILURE;
+        } catch (const std::exception &ex) {
+            std::cerr << "Failed to compare with the baseline: " << ex.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,110 @@
+// Benchmark of the SLA raster backends.
+//
+// Rasterizes a synthetic layer of many small polygons, some of them with holes, by each RasterBackend
+// and compares the rasterized pixels against the AGG backend. The encoder only copies the pixels,
+// thus the time measured is the time of rasterization, not of PNG compression.
+//
+// Usage:
+//     sla_raster_benchmark [--repeat N] [--resolution W H] [--polygons N]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "libslic3r/libslic3r.h"
+#include "libslic3r/ExPolygon.hpp"
+#include "libslic3r/SLA/RasterBase.hpp"
+
+using namespace Slic3r;
+
+static ExPolygons synthetic_layer(double disp_w, double disp_h, size_t num_polygons)
+{
+    ExPolygons out;
+    const size_t cols = std::max<size_t>(1, size_t(std::sqrt(double(num_polygons) * disp_w / disp_h)));
+    const double step = disp_w / double(cols);
+    for (size_t i = 0; i < num_polygons; ++ i) {
+        const double cx = (double(i % cols) + 0.5) * step - disp_w / 2.;
+        const double cy = (double(i / cols) + 0.5) * step - disp_h / 2.;
+        const double r  = 0.45 * step * (0.5 + 0.5 * double(i % 11) / 10.);
+        const size_t n  = 6 + i % 60;
+        ExPolygon    expoly;
+        for (size_t k = 0; k < n; ++ k) {
+            double a  = 2. * PI * double(k) / double(n);
+            double rr = r * (0.8 + 0.2 * std::sin(5. * a));
+            expoly.contour.points.emplace_back(scaled(cx + rr * std::cos(a)), scaled(cy + rr * std::sin(a)));
+        }
+        if (i % 3 == 0) {
+            Polygon hole;
+            for (size_t k = n; k > 0; -- k) {
+                double a = 2. * PI * double(k) / double(n);
+                hole.points.emplace_back(scaled(cx + 0.3 * r * std::cos(a)), scaled(cy + 0.3 * r * std::sin(a)));
+            }
+            expoly.holes.emplace_back(std::move(hole));
+        }
+        out.emplace_back(std::move(expoly));
+    }
+    return out;
+}
+
+int main(int argc, char **argv)
+{
+    int             repeat       = 5;
+    sla::Resolution res { 2560, 1440 };
+    size_t          num_polygons = 2000;
+    for (int i = 1; i < argc; ++ i) {
+        std::string arg = argv[i];
+        if (arg == "--repeat" && i + 1 < argc)
+            repeat = std::max(1, atoi(argv[++ i]));
+        else if (arg == "--resolution" && i + 2 < argc) {
+            res.width_px  = size_t(std::max(1, atoi(argv[++ i])));
+            res.height_px = size_t(std::max(1, atoi(argv[++ i])));
+        } else if (arg == "--polygons" && i + 1 < argc)
+            num_polygons = size_t(std::max(1, atoi(argv[++ i])));
+        else {
+            std::cout << "Usage: " << argv[0] << " [--repeat N] [--resolution W H] [--polygons N]" << std::endl;
+            return arg == "--help" || arg == "-h" ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    // Prusa SL1 display dimensions.
+    const double           disp_w = 120., disp_h = 68.;
+    const sla::PixelDim    pxdim { disp_w / double(res.width_px), disp_h / double(res.height_px) };
+    const ExPolygons       layer  = synthetic_layer(disp_w, disp_h, num_polygons);
+    sla::RasterBase::Trafo trafo;
+    trafo.center_x = scaled(disp_w / 2.);
+    trafo.center_y = scaled(disp_h / 2.);
+
+    std::vector<uint8_t> reference;
+    for (sla::RasterBackend backend : { sla::RasterBackend::AGG, sla::RasterBackend::Coverage }) {
+        std::vector<uint8_t> pixels;
+        auto copy_pixels = [&pixels](const void *ptr, size_t w, size_t h, size_t num_components) {
+            auto data = static_cast<const uint8_t*>(ptr);
+            pixels.assign(data, data + w * h * num_components);
+            return sla::EncodedRaster({}, "raw");
+        };
+        double best = std::numeric_limits<double>::max();
+        for (int i = 0; i < repeat; ++ i) {
+            auto start = std::chrono::steady_clock::now();
+            std::unique_ptr<sla::RasterBase> raster = sla::create_raster_grayscale_aa(res, pxdim, 1., trafo, backend);
+            for (const ExPolygon &expoly : layer)
+                raster->draw(expoly);
+            raster->encode(copy_pixels);
+            best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        }
+        int max_diff = 0;
+        if (reference.empty())
+            reference = pixels;
+        else
+            for (size_t i = 0; i < pixels.size(); ++ i)
+                max_diff = std::max(max_diff, std::abs(int(pixels[i]) - int(reference[i])));
+        std::cout << (backend == sla::RasterBackend::AGG ? "AGG     " : "Coverage") << " " << res.width_px << "x" << res.height_px
+                  << " best of " << repeat << ": " << best * 1000. << " ms, max difference to AGG: " << max_diff << std::endl;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,41 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark_all.hpp>
+
+#include <random>
+#include <vector>
+
+#include "libslic3r/GCode/GCodeWriter.hpp"
+
+using namespace Slic3r;
+
+TEST_CASE("GCodeWriter benchmarks", "[GCodeWriter][.Benchmarks]") {
+    std::mt19937                           rng(0);
+    std::uniform_real_distribution<double> xy(0., 250.);
+    std::uniform_real_distribution<double> e(0., 2.);
+    std::vector<Vec3d>                     moves(10000);
+    for (Vec3d &move : moves)
+        move = Vec3d(xy(rng), xy(rng), e(rng));
+
+    BENCHMARK("Format G1 XYE") {
+        size_t length = 0;
+        for (const Vec3d &move : moves) {
+            GCodeG1Formatter w;
+            w.emit_xy(move.head<2>());
+            w.emit_e("E", move.z());
+            length += w.string().size();
+        }
+        return length;
+    };
+
+    BENCHMARK_ADVANCED("GCodeWriter extrude_to_xy")(Catch::Benchmark::Chronometer meter) {
+        GCodeWriter writer;
+        writer.set_extruders({ 0 });
+        writer.set_extruder(0);
+        meter.measure([&] {
+            size_t length = 0;
+            for (const Vec3d &move : moves)
+                length += writer.extrude_to_xy(move.head<2>(), move.z()).size();
+            return length;
+        });
+    };
+}
@@ -138,3 +138,30 @@ TEST_CASE_METHOD(Slic3r::Test::SeamsFixture, "Seam benchmarks", "[Seams][.Benchm
         };
     }
 }
+
+TEST_CASE("Seam benchmarks of object copies", "[Seams][.Benchmarks]") {
+    using namespace Slic3r;
+
+    DynamicPrintConfig config;
+    Model model;
+    ConfigSubstitutionContext context{ForwardCompatibilitySubstitutionRule::Disable};
+    boost::optional<Semver> version;
+    const boost::filesystem::path file_3mf{
+        boost::filesystem::path{TEST_DATA_DIR} / boost::filesystem::path{"seam_test_object.3mf"}};
+    load_3mf(file_3mf.string().c_str(), config, context, &model, false, version);
+    // The copies share the meshes, thus the model visibility is only calculated once.
+    for (int i{0}; i < 3; ++i) {
+        model.add_object(*model.objects.front());
+    }
+    Print print;
+    Test::init_print(std::vector<TriangleMesh>{}, print, model, config);
+    print.process();
+    const Seams::Params params{Seams::Placer::get_params(print.full_print_config())};
+
+    BENCHMARK_ADVANCED("Init seam placer aligned 4 copies")(Catch::Benchmark::Chronometer meter) {
+        Seams::Placer placer;
+        meter.measure([&] {
+            return placer.init(print.objects(), params, [](){});
+        });
+    };
+}
@@ -318,6 +318,21 @@ SCENARIO("ExtrusionEntityCollection: Polygon flattening", "[ExtrusionEntity]")
                 CHECK(std::count_if(output.entities.cbegin(), output.entities.cend(), [=](const ExtrusionEntity* e) {return e->is_collection();}) == 0);
             }
         }
+        WHEN("The EEC is flattened as a view") {
+            const std::vector<const ExtrusionEntity*> view = sample.flatten_view();
+            THEN("The view references all the leaves of the original EEC in order") {
+                REQUIRE(view.size() == sample.items_count());
+                size_t idx = 0;
+                for (const ExtrusionEntity *collection : sample.entities)
+                    for (const ExtrusionEntity *e : static_cast<const ExtrusionEntityCollection*>(collection)->entities)
+                        CHECK(view[idx ++] == e);
+            }
+            AND_THEN("Preserving the order keeps the no-sort EEC as a single item") {
+                const std::vector<const ExtrusionEntity*> ordered_view = sample.flatten_view(true);
+                CHECK(ordered_view.size() == sub_sort.size() * 2 + 1);
+                CHECK(ordered_view[sub_sort.size()] == sample.entities[1]);
+            }
+        }
         WHEN("The EEC is flattened with preservation (preserve_order=true)") {
 			output = sample.flatten(true);
             THEN("The output EECs contains one EEC.") {
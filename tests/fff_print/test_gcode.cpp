@@ -9,7 +9,10 @@
 #include <regex>
 #include <fstream>
 
+#include <boost/filesystem/operations.hpp>
+
 #include "libslic3r/GCode.hpp"
+#include "libslic3r/GCodeReader.hpp"
 #include "libslic3r/Geometry/ConvexHull.hpp"
 #include "test_data.hpp"
 
@@ -225,6 +228,39 @@ TEST_CASE("Used filament", "[GCode]") {
     CHECK(print1.print_statistics().total_used_filament == print2.print_statistics().total_used_filament);
 }
 
+TEST_CASE("Estimated statistics without G-code export", "[GCode]") {
+    DynamicPrintConfig config = Slic3r::DynamicPrintConfig::full_print_config();
+    config.set_deserialize_strict({
+        { "gcode_flavor", "marlin2" },
+        { "silent_mode", 1 },
+        { "filament_density", 1.24 },
+        { "filament_cost", 25 },
+    });
+    Print print1;
+    Model model1;
+    Test::init_print({TestMesh::cube_20x20x20}, print1, model1, config);
+    Test::gcode(print1);
+
+    Print print2;
+    Model model2;
+    Test::init_print({TestMesh::cube_20x20x20}, print2, model2, config);
+    print2.set_status_silent();
+    print2.process();
+    print2.estimate_gcode_statistics();
+
+    const PrintStatistics &exported  = print1.print_statistics();
+    const PrintStatistics &estimated = print2.print_statistics();
+    CHECK(estimated.normal_print_time_seconds > 0.f);
+    CHECK(estimated.normal_print_time_seconds == Catch::Approx(exported.normal_print_time_seconds));
+    CHECK(estimated.silent_print_time_seconds == Catch::Approx(exported.silent_print_time_seconds));
+    CHECK(estimated.estimated_silent_print_time == exported.estimated_silent_print_time);
+    CHECK(estimated.total_used_filament > 0.);
+    CHECK(estimated.total_used_filament == Catch::Approx(exported.total_used_filament));
+    CHECK(estimated.total_weight == Catch::Approx(exported.total_weight));
+    CHECK(estimated.total_cost == Catch::Approx(exported.total_cost));
+    CHECK(estimated.filament_stats.size() == exported.filament_stats.size());
+}
+
 void check_m73s(Print& print){
     std::vector<double> percent{};
     bool got_100 = false;
@@ -345,3 +381,24 @@ TEST_CASE("M201 for acceleation reset", "[GCode]") {
     INFO("M204 is not generated for repetier firmware");
     CHECK(!has_m204);
 }
+
+TEST_CASE("GCodeReader parses memory mapped files", "[GCodeReader]") {
+    const boost::filesystem::path path = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("gcode_reader_%%%%-%%%%.gcode");
+    {
+        std::ofstream os(path.string(), std::ios::binary);
+        // Mixed line endings, the last line is not terminated by a new line.
+        os << "G1 X10 Y20 ; move\r\nG1 Z0.3\n\nM104 S200\nG1 E1.5";
+    }
+    GCodeReader reader;
+    std::vector<std::string> lines;
+    std::vector<std::vector<size_t>> lines_ends;
+    REQUIRE(reader.parse_file(path.string(), [&lines](GCodeReader&, const GCodeReader::GCodeLine &line) { lines.emplace_back(line.raw()); }, lines_ends));
+    boost::filesystem::remove(path);
+
+    REQUIRE(lines == std::vector<std::string>{ "G1 X10 Y20 ; move", "G1 Z0.3", "", "M104 S200", "G1 E1.5" });
+    REQUIRE(lines_ends.front() == std::vector<size_t>{ 19, 27, 28, 38 });
+    REQUIRE(reader.x() == Approx(10.));
+    REQUIRE(reader.y() == Approx(20.));
+    REQUIRE(reader.z() == Approx(0.3));
+    REQUIRE(reader.e() == Approx(1.5));
+}
@@ -184,6 +184,50 @@ TEST_CASE("Get first crossed line distance", "[GCode]") {
     CHECK(get_first_crossed_line_distance(tcb::span{travel}.subspan(6), distancer) == std::numeric_limits<double>::max());
 }
 
+TEST_CASE("Get first crossed line distance of instances sharing obstacles", "[GCode]") {
+    // A 2x2 square at 0, 0.
+    const ExPolygon square{
+        scaled(Vec2f{-1, -1}),
+        scaled(Vec2f{1, -1}),
+        scaled(Vec2f{1, 1}),
+        scaled(Vec2f{-1, 1})
+    };
+
+    // Bottom-up travel.
+    const Lines travel{Polyline{
+        scaled(Vec2f{0, -3}),
+        scaled(Vec2f{0, 0}),
+        scaled(Vec2f{0, 5}),
+    }.lines()};
+
+    std::vector<GCode::ObjectOrExtrusionLinef> lines;
+    for (const Line& line : square.lines()) {
+        lines.emplace_back(unscale(line.a), unscale(line.b));
+    }
+
+    GCode::ObjectLayerObstacles object_obstacles;
+    object_obstacles.bbox = BoundingBoxf{Vec2d{-1, -1}, Vec2d{1, 1}};
+    object_obstacles.distancer = std::make_shared<const AABBTreeLines::LinesDistancer<GCode::ObjectOrExtrusionLinef>>(std::move(lines));
+    // The first instance is off the travel, the second one is moved up by 2.
+    object_obstacles.instance_shifts = {Vec2d{10, 0}, Vec2d{0, 2}};
+    const GCode::ObjectsLayerObstacles obstacles{object_obstacles};
+
+    CHECK(get_first_crossed_line_distance(travel, obstacles, {}) == Approx(4));
+    CHECK(get_first_crossed_line_distance(tcb::span{travel}.subspan(1), obstacles, {}) == Approx(1));
+
+    // The predicate receives the line translated to the crossed instance.
+    std::vector<double> crossed_lines_y;
+    CHECK(get_first_crossed_line_distance(travel, obstacles, {}, [&crossed_lines_y](const GCode::ObjectOrExtrusionLinef &line) {
+        CHECK(line.object_layer_idx == 0);
+        CHECK(line.instance_idx == 1);
+        crossed_lines_y.push_back(line.a.y());
+        return false;
+    }) == std::numeric_limits<double>::max());
+    REQUIRE(crossed_lines_y.size() == 2);
+    CHECK(crossed_lines_y[0] == Approx(1));
+    CHECK(crossed_lines_y[1] == Approx(3));
+}
+
 
 TEST_CASE("Elevated travel formula", "[GCode]") {
     const double lift_height{10};
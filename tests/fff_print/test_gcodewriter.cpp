@@ -536,4 +536,27 @@ TEST_CASE("GCodeWriter emits G1 code correctly according to XYZF_EXPORT_DIGITS",
         std::string result3{ writer.travel_to_xyz(v3) };
         CHECK(result3 == "");
     }
-}
\ No newline at end of file
+}
+TEST_CASE("GCodeFormatter emits fixed point numbers", "[GCodeWriter]") {
+    auto emit = [](double v, size_t digits) {
+        GCodeG1Formatter w;
+        w.emit_axis('X', v, digits);
+        return w.string();
+    };
+    CHECK(emit(0., 3) == "G1 X0\n");
+    CHECK(emit(-0.0001, 3) == "G1 X0\n");
+    CHECK(emit(1., 3) == "G1 X1\n");
+    CHECK(emit(-1., 3) == "G1 X-1\n");
+    CHECK(emit(100., 3) == "G1 X100\n");
+    CHECK(emit(0.5, 3) == "G1 X.5\n");
+    CHECK(emit(-0.5, 3) == "G1 X-.5\n");
+    CHECK(emit(-0.05, 5) == "G1 X-.05\n");
+    CHECK(emit(0.0004, 5) == "G1 X.0004\n");
+    CHECK(emit(123.456, 3) == "G1 X123.456\n");
+    CHECK(emit(-123.4567, 3) == "G1 X-123.457\n");
+    CHECK(emit(10.0005, 3) == "G1 X10.001\n");
+    CHECK(emit(0.00001, 5) == "G1 X.00001\n");
+    CHECK(emit(1000000., 5) == "G1 X1000000\n");
+    CHECK(emit(123456789.5, 0) == "G1 X123456790\n");
+    CHECK(emit(123456789.123456789, 9) == "G1 X123456789.123456784\n");
+}
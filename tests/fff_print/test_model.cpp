@@ -2,6 +2,7 @@
 
 #include "libslic3r/libslic3r.h"
 #include "libslic3r/Model.hpp"
+#include "libslic3r/ModelProcessing.hpp"
 #include <arrange-wrapper/ModelArrange.hpp>
 
 #include <boost/nowide/cstdio.hpp>
@@ -63,3 +64,61 @@ SCENARIO("Model construction", "[Model]") {
         }
     }
 }
+
+SCENARIO("Mesh deduplication", "[Model]") {
+    GIVEN("Two objects with identical meshes and one with a different mesh") {
+        Model model;
+        for (double size : { 20., 20., 10. })
+            model.add_object()->add_volume(make_cube(size, size, size));
+        WHEN("The meshes are deduplicated") {
+            size_t shared = ModelProcessing::deduplicate_meshes(model);
+            const ModelVolume &v1 = *model.objects[0]->volumes.front();
+            const ModelVolume &v2 = *model.objects[1]->volumes.front();
+            const ModelVolume &v3 = *model.objects[2]->volumes.front();
+            THEN("Only the identical meshes are shared") {
+                REQUIRE(shared == 1);
+                REQUIRE(v1.mesh_ptr() == v2.mesh_ptr());
+                REQUIRE(v1.mesh_ptr() != v3.mesh_ptr());
+            }
+            THEN("Modifying a shared mesh does not modify the other volume") {
+                model.objects[1]->volumes.front()->scale_geometry_after_creation(Vec3f(2.f, 2.f, 2.f));
+                REQUIRE(v1.mesh_ptr() != v2.mesh_ptr());
+                REQUIRE(v1.mesh().bounding_box().size().isApprox(Vec3d(20., 20., 20.)));
+                REQUIRE(v2.mesh().bounding_box().size().isApprox(Vec3d(40., 40., 40.)));
+            }
+        }
+    }
+}
+
+SCENARIO("Bounding boxes calculated from the convex hulls", "[Model]") {
+    GIVEN("An object with a rotated and scaled instance of a non-convex volume") {
+        Model model;
+        ModelObject *object = model.add_object();
+        ModelVolume *volume = object->add_volume(Slic3r::Test::mesh(Slic3r::Test::TestMesh::V));
+        ModelInstance *instance = object->add_instance();
+        instance->set_rotation(Vec3d(0.3, 0.2, 0.1));
+        instance->set_scaling_factor(Vec3d(1., 2., 0.5));
+        instance->set_offset(Vec3d(10., 20., 5.));
+        const auto mesh_bbox = [object, volume]() { return volume->mesh().transformed_bounding_box(object->instances.front()->get_matrix() * volume->get_matrix()); };
+        THEN("The convex hull is used") {
+            REQUIRE(volume->is_convex_hull_valid());
+            REQUIRE(&volume->convex_hull_or_mesh() == &volume->get_convex_hull());
+        }
+        THEN("The instance bounding box matches the bounding box of the transformed mesh") {
+            BoundingBoxf3 bbox = object->instance_bounding_box(0);
+            REQUIRE(bbox.min.isApprox(mesh_bbox().min, 1e-5));
+            REQUIRE(bbox.max.isApprox(mesh_bbox().max, 1e-5));
+        }
+        WHEN("The mesh is replaced without updating the convex hull") {
+            volume->set_mesh(Slic3r::Test::mesh(Slic3r::Test::TestMesh::cube_20x20x20));
+            object->invalidate_bounding_box();
+            THEN("The mesh is used") {
+                REQUIRE(! volume->is_convex_hull_valid());
+                REQUIRE(&volume->convex_hull_or_mesh() == &volume->mesh());
+                BoundingBoxf3 bbox = object->instance_bounding_box(0);
+                REQUIRE(bbox.min.isApprox(mesh_bbox().min, 1e-5));
+                REQUIRE(bbox.max.isApprox(mesh_bbox().max, 1e-5));
+            }
+        }
+    }
+}
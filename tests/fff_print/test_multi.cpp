@@ -269,3 +269,39 @@ SCENARIO("Stacked cubes", "[Multi]")
         }
     }
 }
+
+SCENARIO("Tool change order optimization", "[Multi]")
+{
+    GIVEN("Cube printed with different perimeter, infill and solid infill extruders") {
+        auto config = Slic3r::DynamicPrintConfig::full_print_config_with({
+            { "nozzle_diameter",        "0.6, 0.6, 0.6, 0.6" },
+            { "perimeter_extruder",     1 },
+            { "infill_extruder",        2 },
+            { "solid_infill_extruder",  3 },
+            { "skirts",                 0 }
+        });
+        auto count_toolchanges = [](const std::string &gcode) {
+            GCodeReader parser;
+            int         tool = -1;
+            size_t      toolchanges = 0;
+            parser.parse_buffer(gcode, [&tool, &toolchanges](Slic3r::GCodeReader &self, const Slic3r::GCodeReader::GCodeLine &line) {
+                if (boost::starts_with(line.cmd(), "T")) {
+                    const int new_tool = atoi(line.cmd().data() + 1);
+                    if (tool != -1 && new_tool != tool)
+                        ++ toolchanges;
+                    tool = new_tool;
+                }
+            });
+            return toolchanges;
+        };
+        const size_t toolchanges_greedy = count_toolchanges(Slic3r::Test::slice({ Slic3r::Test::TestMesh::cube_20x20x20 }, config));
+        WHEN("Tool change order optimization enabled") {
+            config.set_deserialize_strict("optimize_toolchange_order", "1");
+            const size_t toolchanges_optimized = count_toolchanges(Slic3r::Test::slice({ Slic3r::Test::TestMesh::cube_20x20x20 }, config));
+            THEN("No more tool changes than with the greedy ordering") {
+                REQUIRE(toolchanges_optimized > 0);
+                REQUIRE(toolchanges_optimized <= toolchanges_greedy);
+            }
+        }
+    }
+}
@@ -1,4 +1,5 @@
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
 
 #include "libslic3r/libslic3r.h"
 #include "libslic3r/Print.hpp"
@@ -185,3 +186,96 @@ SCENARIO("Ported from Perl", "[Print]") {
         }
     }
 }
+
+SCENARIO("Print: Copies of an object are sliced once", "[Print]") {
+    GIVEN("20mm cube and its copy") {
+        auto config = Slic3r::DynamicPrintConfig::full_print_config();
+        Print print;
+        Model model;
+        Slic3r::Test::init_print({ TestMesh::cube_20x20x20 }, print, model, config);
+        ModelObject *copy = model.add_object(*model.objects.front());
+        copy->instances.front()->set_offset(copy->instances.front()->get_offset() + Vec3d(30., 0., 0.));
+        WHEN("Print is applied") {
+            print.apply(model, config);
+            THEN("the copy is printed as an instance of the original PrintObject") {
+                REQUIRE(print.objects().size() == 1);
+                REQUIRE(print.objects().front()->instances().size() == 2);
+                REQUIRE(print.get_print_object_by_model_object_id(copy->id()) == print.objects().front());
+            }
+        }
+        WHEN("The copy is configured differently") {
+            copy->config.set_deserialize_strict("fill_density", "100%");
+            print.apply(model, config);
+            THEN("the copy is sliced separately") {
+                REQUIRE(print.objects().size() == 2);
+                REQUIRE(print.objects().front()->instances().size() == 1);
+            }
+        }
+        WHEN("The copy is rotated") {
+            copy->instances.front()->set_rotation(Vec3d(0., 0., 0.5 * PI));
+            print.apply(model, config);
+            THEN("the copy is sliced separately") {
+                REQUIRE(print.objects().size() == 2);
+            }
+        }
+    }
+}
+
+SCENARIO("Print: Infill preparation repeated with unchanged fill surfaces", "[Print]") {
+    GIVEN("sliced 50mm sphere") {
+        Slic3r::DynamicPrintConfig config = Slic3r::DynamicPrintConfig::full_print_config();
+        config.set_deserialize_strict({ { "fill_density", "20%" } });
+        Slic3r::Print print;
+        Slic3r::Model model;
+        Slic3r::Test::init_print({TestMesh::sphere_50mm}, print, model, config);
+        print.process();
+        WHEN("Model is re-sliced with a different infill density") {
+            config.set_deserialize_strict({ { "fill_density", "40%" } });
+            print.apply(model, config);
+            print.process();
+            Slic3r::Print print_fresh;
+            Slic3r::Test::init_and_process_print({TestMesh::sphere_50mm}, print_fresh, config);
+            THEN("the fill surfaces match the fill surfaces of a print processed from scratch") {
+                const PrintObject &object       = *print.objects().front();
+                const PrintObject &object_fresh = *print_fresh.objects().front();
+                REQUIRE(object.layers().size() == object_fresh.layers().size());
+                for (size_t layer_idx = 0; layer_idx < object.layers().size(); ++ layer_idx)
+                    for (size_t region_idx = 0; region_idx < object.layers()[layer_idx]->regions().size(); ++ region_idx)
+                        REQUIRE(object.layers()[layer_idx]->regions()[region_idx]->fill_surfaces().surfaces ==
+                                object_fresh.layers()[layer_idx]->regions()[region_idx]->fill_surfaces().surfaces);
+            }
+        }
+    }
+}
+
+SCENARIO("Print: Coarse preview of dense objects", "[Print]") {
+    GIVEN("50mm radius sphere and a coarse preview triggered by a low triangle count") {
+        Slic3r::DynamicPrintConfig config = Slic3r::DynamicPrintConfig::full_print_config();
+        Slic3r::Print print;
+        Slic3r::Model model;
+        Slic3r::Test::init_print({TestMesh::sphere_50mm}, print, model, config);
+        print.set_coarse_preview_triangles(100);
+        std::shared_ptr<const PrintObject::CoarsePreview> preview;
+        print.set_status_callback([&print, &preview](const PrintBase::SlicingStatus &status) {
+            if ((status.flags & PrintBase::SlicingStatus::RELOAD_FFF_PREVIEW) && ! preview)
+                preview = print.objects().front()->coarse_preview();
+        });
+        WHEN("the print is processed") {
+            print.process();
+            THEN("the coarse preview is reported before the toolpaths are finished") {
+                REQUIRE(preview);
+                REQUIRE(preview->print_z.size() <= 100);
+                REQUIRE(preview->print_z.size() < print.objects().front()->layers().size());
+                REQUIRE(preview->slices.size() == preview->print_z.size());
+                REQUIRE(preview->print_z.back() >= print.objects().front()->layers().back()->print_z - EPSILON);
+            }
+            THEN("the estimated volume is close to the volume of the sphere") {
+                REQUIRE(preview);
+                REQUIRE(preview->volume == Catch::Approx(4. / 3. * PI * 50. * 50. * 50.).epsilon(0.05));
+            }
+            THEN("the coarse preview is released once the toolpaths are finished") {
+                REQUIRE(! print.objects().front()->coarse_preview());
+            }
+        }
+    }
+}
@@ -3,6 +3,7 @@
 
 #include "libslic3r/libslic3r.h"
 #include "libslic3r/GCodeReader.hpp"
+#include "libslic3r/Layer.hpp"
 
 #include "test_data.hpp"
 
@@ -271,3 +272,62 @@ SCENARIO( "PrintGCode basic functionality", "[PrintGCode]") {
         }
     }
 }
+
+SCENARIO("PrintGCode reuses the smooth paths of unchanged layers", "[PrintGCode]") {
+    GIVEN("A print exported to G-code with arc fitting") {
+        Slic3r::Print print;
+        Slic3r::Model model;
+        Slic3r::Test::init_print({TestMesh::sphere_50mm}, print, model, {
+            { "arc_fitting",                    "emit_center" },
+            { "gcode_comments",                 true }
+            });
+        // Skip the header line with the time stamp.
+        auto strip_header = [](const std::string &gcode) { return gcode.substr(gcode.find('\n') + 1); };
+        std::string gcode1 = strip_header(Slic3r::Test::gcode(print));
+        const Layer *layer = print.objects().front()->layers()[print.objects().front()->layer_count() / 2];
+        auto smooth_path_cache = layer->smooth_path_cache;
+        WHEN("the G-code is exported again") {
+            std::string gcode2 = strip_header(Slic3r::Test::gcode(print));
+            THEN("the smooth paths cached with the layers are reused") {
+                REQUIRE(smooth_path_cache);
+                REQUIRE(layer->smooth_path_cache == smooth_path_cache);
+            }
+            THEN("the G-code does not change") {
+                REQUIRE(gcode1 == gcode2);
+            }
+        }
+    }
+}
+
+SCENARIO("PrintGCode reuses the seams when only the speeds change", "[PrintGCode]") {
+    GIVEN("A print with aligned seams exported to G-code") {
+        Slic3r::Print print;
+        Slic3r::Model model;
+        Slic3r::DynamicPrintConfig config = Slic3r::DynamicPrintConfig::full_print_config();
+        config.set_deserialize_strict({
+            { "seam_position",                  "aligned" },
+            { "perimeter_speed",                "40" }
+            });
+        Slic3r::Test::init_print({TestMesh::cube_20x20x20}, print, model, config);
+        Slic3r::Test::gcode(print);
+        const PrintObject *object = print.objects().front();
+        auto seam_placement = object->seam_placement_cache;
+        REQUIRE(seam_placement);
+        WHEN("the perimeter speed is changed and the G-code is exported again") {
+            config.set_deserialize_strict({ { "perimeter_speed", "55" } });
+            print.apply(model, config);
+            Slic3r::Test::gcode(print);
+            THEN("the seams are not placed again") {
+                REQUIRE(object->seam_placement_cache == seam_placement);
+            }
+        }
+        WHEN("the seam position is changed and the G-code is exported again") {
+            config.set_deserialize_strict({ { "seam_position", "rear" } });
+            print.apply(model, config);
+            Slic3r::Test::gcode(print);
+            THEN("the seams are placed again") {
+                REQUIRE(object->seam_placement_cache != seam_placement);
+            }
+        }
+    }
+}
@@ -3,6 +3,7 @@
 #include <catch2/catch_approx.hpp>
 #include <libslic3r/GCode/SeamAligned.hpp>
 #include "test_data.hpp"
+#include <algorithm>
 #include <fstream>
 
 using namespace Slic3r;
@@ -164,3 +165,31 @@ TEST_CASE_METHOD(Test::SeamsFixture, "Calculate visibility", "[Seams][SeamAligne
         }
     }
 }
+
+TEST_CASE("Visibility is cached per geometry", "[Seams][SeamAligned]") {
+    Model model;
+    ModelObject *object{model.add_object()};
+    object->add_volume(Test::mesh(Test::TestMesh::L));
+    object->add_instance();
+    ModelInfo::Visibility::Params params{};
+    params.raycasting_visibility_samples_count = 2000;
+    params.fast_decimation_triangle_count_target = 16000;
+    params.sqr_rays_per_sample_point = 5;
+
+    const auto visibility{ModelInfo::Visibility::cached(Transform3d::Identity(), object->volumes, params, [](){})};
+    REQUIRE(visibility);
+    CHECK(ModelInfo::Visibility::cached(Transform3d::Identity(), object->volumes, params, [](){}) == visibility);
+
+    // The inner corner of the L shape is partially occluded, while its outer faces are not.
+    const std::vector<float> &samples_visibility{visibility->mesh_samples_visibility};
+    CHECK(*std::max_element(samples_visibility.begin(), samples_visibility.end()) == Approx(1.0f));
+    CHECK(*std::min_element(samples_visibility.begin(), samples_visibility.end()) < 0.9f);
+
+    SECTION("Different density is calculated again") {
+        ModelInfo::Visibility::Params sparse{params};
+        sparse.raycasting_visibility_samples_count = 500;
+        const auto sparse_visibility{ModelInfo::Visibility::cached(Transform3d::Identity(), object->volumes, sparse, [](){})};
+        CHECK(sparse_visibility != visibility);
+        CHECK(sparse_visibility->mesh_samples.positions.size() < visibility->mesh_samples.positions.size());
+    }
+}
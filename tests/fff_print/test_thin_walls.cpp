@@ -42,6 +42,56 @@ SCENARIO("Medial Axis", "[ThinWalls]") {
             }
         }
     }
+    GIVEN("narrow rectangle with near duplicate and collinear vertices") {
+        ExPolygon expolygon{ Polygon::new_scale({ {100, 100}, {120, 100}, {120, 150}, {120, 150.000001}, {120.0000005, 175}, {120, 200}, {100, 200} }) };
+        WHEN("Medial axis is extracted") {
+            Polylines res = expolygon.medial_axis(scaled<double>(0.5), scaled<double>(20.));
+            THEN("the degenerate vertices don't influence medial axis") {
+                REQUIRE(res.size() == 1);
+                REQUIRE(res.front().length() >= scaled<double>(200.-100. - (120.-100.)) - SCALED_EPSILON);
+            }
+        }
+    }
+    GIVEN("three narrow rectangles") {
+        ExPolygons expolygons;
+        for (double x : { 100., 200., 300. })
+            expolygons.push_back(ExPolygon{ Polygon::new_scale({ {x, 100}, {x + 20, 100}, {x + 20, 200}, {x, 200} }) });
+        WHEN("Medial axes of all of them are extracted at once") {
+            ThickPolylines res;
+            medial_axis(expolygons, scaled<double>(0.5), scaled<double>(20.), &res);
+            THEN("there is a single line for each rectangle, in the order of the rectangles") {
+                REQUIRE(res.size() == 3);
+                for (size_t i = 0; i < res.size(); ++ i)
+                    REQUIRE(expolygons[i].contains(res[i].points[res[i].points.size() / 2]));
+            }
+        }
+    }
+    GIVEN("rotated narrow rectangle, with and without a collinear vertex") {
+        Polygon rectangle = Polygon::new_scale({ {100, 100}, {120, 100}, {120, 200}, {100, 200} });
+        rectangle.rotate(0.3);
+        Polygon with_vertex = rectangle;
+        with_vertex.points.insert(with_vertex.points.begin() + 2, Point((rectangle.points[1] + rectangle.points[2]) / 2));
+        WHEN("Medial axes are extracted") {
+            ThickPolylines res_rectangle, res_with_vertex;
+            // The rectangle takes the shortcut, the other one is processed through the Voronoi diagram.
+            medial_axis({ ExPolygon{ rectangle } }, scaled<double>(0.5), scaled<double>(25.), &res_rectangle);
+            medial_axis({ ExPolygon{ with_vertex } }, scaled<double>(0.5), scaled<double>(25.), &res_with_vertex);
+            THEN("both are a single line") {
+                REQUIRE(res_rectangle.size() == 1);
+                REQUIRE(res_with_vertex.size() == 1);
+            }
+            THEN("both lines connect the same points with the same width") {
+                ThickPolyline &a = res_rectangle.front();
+                ThickPolyline &b = res_with_vertex.front();
+                if ((a.first_point() - b.first_point()).cast<double>().norm() > (a.first_point() - b.last_point()).cast<double>().norm())
+                    b.reverse();
+                REQUIRE((a.first_point() - b.first_point()).cast<double>().norm() < 2. * SCALED_EPSILON);
+                REQUIRE((a.last_point() - b.last_point()).cast<double>().norm() < 2. * SCALED_EPSILON);
+                REQUIRE(std::abs(a.width.front() - b.width.front()) < SCALED_EPSILON);
+                REQUIRE(std::abs(a.width.back() - b.width.back()) < SCALED_EPSILON);
+            }
+        }
+    }
 #if 0
     //FIXME this test never worked
     GIVEN("narrow rectangle with an extra vertex") {
@@ -3,6 +3,7 @@
 #include "libslic3r/Model.hpp"
 #include "libslic3r/Format/3mf.hpp"
 #include "libslic3r/Format/STL.hpp"
+#include "libslic3r/TriangleSelector.hpp"
 
 #include <boost/filesystem/operations.hpp>
 
@@ -133,3 +134,100 @@ SCENARIO("2D convex hull of sinking object", "[3mf]") {
     }
 }
 
+
+SCENARIO("Export+Import of a project with many objects to/from 3mf file cycle", "[3mf]") {
+    GIVEN("many objects, some of them with multiple instances and painted facets") {
+        Model src_model;
+        std::string src_file = std::string(TEST_DATA_DIR) + "/test_3mf/Prusa.stl";
+        load_stl(src_file.c_str(), &src_model);
+        src_model.add_default_instances();
+        for (int i = 1; i < 12; ++ i) {
+            ModelObject *object = src_model.add_object(*src_model.objects.front());
+            object->name = "object " + std::to_string(i);
+            object->instances.front()->set_offset({ 30. * i, 0., 0. });
+            if (i % 3 == 0)
+                object->add_instance()->set_offset({ 30. * i, 30., 0. });
+            if (i % 4 == 0) {
+                ModelVolume     *volume = object->volumes.front();
+                TriangleSelector selector(volume->mesh());
+                selector.set_facet(i, TriangleStateType::ENFORCER);
+                volume->supported_facets.set(selector);
+            }
+        }
+
+        WHEN("model is saved+loaded to/from 3mf file") {
+            std::string test_file = std::string(TEST_DATA_DIR) + "/test_3mf/prusa_many_objects.3mf";
+            store_3mf(test_file.c_str(), &src_model, nullptr, false);
+
+            Model dst_model;
+            DynamicPrintConfig dst_config;
+            {
+                ConfigSubstitutionContext ctxt{ ForwardCompatibilitySubstitutionRule::Disable };
+                boost::optional<Semver> version;
+                load_3mf(test_file.c_str(), dst_config, ctxt, &dst_model, false, version);
+            }
+            boost::filesystem::remove(test_file);
+
+            THEN("the objects, their instances, meshes and painting match") {
+                REQUIRE(dst_model.objects.size() == src_model.objects.size());
+                for (size_t i = 0; i < src_model.objects.size(); ++ i) {
+                    const ModelObject &src_object = *src_model.objects[i];
+                    const ModelObject &dst_object = *dst_model.objects[i];
+                    REQUIRE(dst_object.name == src_object.name);
+                    REQUIRE(dst_object.instances.size() == src_object.instances.size());
+                    REQUIRE(dst_object.volumes.size() == src_object.volumes.size());
+                    const ModelVolume &src_volume = *src_object.volumes.front();
+                    const ModelVolume &dst_volume = *dst_object.volumes.front();
+                    REQUIRE(dst_volume.mesh().its.indices.size() == src_volume.mesh().its.indices.size());
+                    REQUIRE(dst_volume.supported_facets.get_data() == src_volume.supported_facets.get_data());
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("Changing the print config of a 3mf project without loading its geometry", "[3mf]") {
+    GIVEN("a project") {
+        Model src_model;
+        std::string src_file = std::string(TEST_DATA_DIR) + "/test_3mf/Prusa.stl";
+        load_stl(src_file.c_str(), &src_model);
+        src_model.add_default_instances();
+        src_model.get_wipe_tower_vector().front().position = Vec2d(50., 60.);
+        DynamicPrintConfig src_config = DynamicPrintConfig::full_print_config();
+        src_config.set_key_value("layer_height", new ConfigOptionFloat(0.15));
+        std::string project_file = std::string(TEST_DATA_DIR) + "/test_3mf/prusa_config.3mf";
+        store_3mf(project_file.c_str(), &src_model, &src_config, false);
+
+        WHEN("just the config is loaded, changed and stored") {
+            Model config_model;
+            DynamicPrintConfig config;
+            ConfigSubstitutionContext ctxt{ ForwardCompatibilitySubstitutionRule::Disable };
+            boost::optional<Semver> version;
+            bool loaded = load_3mf_config(project_file.c_str(), config, ctxt, &config_model, version);
+            double layer_height = config.opt_float("layer_height");
+            config.set_key_value("layer_height", new ConfigOptionFloat(0.2));
+            std::string test_file = std::string(TEST_DATA_DIR) + "/test_3mf/prusa_config_changed.3mf";
+            bool stored = store_3mf_config(project_file.c_str(), test_file.c_str(), &config_model, &config);
+
+            Model dst_model;
+            DynamicPrintConfig dst_config;
+            load_3mf(test_file.c_str(), dst_config, ctxt, &dst_model, false, version);
+            boost::filesystem::remove(test_file);
+            boost::filesystem::remove(project_file);
+
+            THEN("the config is loaded without the geometry") {
+                REQUIRE(loaded);
+                REQUIRE(config_model.objects.empty());
+                REQUIRE(layer_height == 0.15);
+                REQUIRE(config_model.get_wipe_tower_vector().front().position == Vec2d(50., 60.));
+            }
+            THEN("the stored project contains the changed config and the original geometry") {
+                REQUIRE(stored);
+                REQUIRE(dst_config.opt_float("layer_height") == 0.2);
+                REQUIRE(dst_model.get_wipe_tower_vector().front().position == Vec2d(50., 60.));
+                REQUIRE(dst_model.objects.size() == src_model.objects.size());
+                REQUIRE(dst_model.mesh().its.indices.size() == src_model.mesh().its.indices.size());
+            }
+        }
+    }
+}
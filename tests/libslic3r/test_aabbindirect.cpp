@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <random>
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/catch_approx.hpp>
 #include <test_utils.hpp>
@@ -6,6 +7,8 @@
 #include <libslic3r/TriangleMesh.hpp>
 #include <libslic3r/AABBTreeIndirect.hpp>
 #include <libslic3r/AABBTreeLines.hpp>
+#include <libslic3r/AABBMesh.hpp>
+#include <libslic3r/MeshCache.hpp>
 
 using namespace Slic3r;
 using namespace Catch;
@@ -63,6 +66,76 @@ TEST_CASE("Building a tree over a box, ray caster and closest query", "[AABBIndi
     REQUIRE(closest_point.z() == Approx(1.));
 }
 
+TEST_CASE("Packet ray caster should match the single ray caster", "[AABBIndirect]")
+{
+    indexed_triangle_set its = its_make_sphere(10., PI / 32.);
+    its_merge(its, its_make_cube(5., 5., 5.));
+
+    auto tree = AABBTreeIndirect::build_aabb_tree_over_indexed_triangle_set(its.vertices, its.indices);
+    REQUIRE(! tree.empty());
+
+    static constexpr size_t N = 8;
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<double> dist(-15., 15.);
+    for (size_t ipacket = 0; ipacket < 200; ++ ipacket) {
+        const size_t num_rays = 1 + ipacket % N;
+        std::array<Vec3d, N> origins, dirs;
+        for (size_t i = 0; i < N; ++ i) {
+            origins[i] = Vec3d(dist(rng), dist(rng), dist(rng));
+            // Some of the rays are axis aligned to exercise the division by zero of the ray box test.
+            dirs[i] = ipacket % 4 == 0 ? Vec3d(0., 0., ipacket % 8 == 0 ? 1. : -1.) : Vec3d((Vec3d(dist(rng), dist(rng), dist(rng)) - origins[i]).normalized());
+        }
+        std::array<igl::Hit, N> hits;
+        size_t num_hits = AABBTreeIndirect::intersect_rays_first_hit(its.vertices, its.indices, tree, origins, dirs, num_rays, hits);
+
+        size_t num_hits_single = 0;
+        for (size_t i = 0; i < num_rays; ++ i) {
+            igl::Hit hit;
+            if (AABBTreeIndirect::intersect_ray_first_hit(its.vertices, its.indices, tree, origins[i], dirs[i], hit)) {
+                ++ num_hits_single;
+                REQUIRE(hits[i].id == hit.id);
+                REQUIRE(hits[i].t == Approx(hit.t));
+            } else
+                REQUIRE(hits[i].id == -1);
+        }
+        REQUIRE(num_hits == num_hits_single);
+    }
+}
+
+TEST_CASE("Acceleration structures are built once per shared mesh", "[AABBIndirect]")
+{
+    auto mesh = std::make_shared<const TriangleMesh>(its_make_sphere(1., PI / 16.));
+    const size_t num_cached = mesh_cache_size();
+
+    auto tree      = cached_aabb_tree(mesh);
+    auto neighbors = cached_face_neighbors(mesh);
+    REQUIRE(mesh_cache_size() == num_cached + 1);
+    REQUIRE(tree == cached_aabb_tree(mesh));
+    REQUIRE(*neighbors == its_face_neighbors(mesh->its));
+
+    {
+        AABBMesh emesh(mesh, true);
+        REQUIRE(&emesh.face_neighbor_index() == neighbors.get());
+        AABBMesh::hit_result hit = emesh.query_ray_hit(Vec3d(0., 0., -5.), Vec3d(0., 0., 1.));
+        REQUIRE(hit.is_hit());
+        REQUIRE(hit.distance() == Approx(4.).margin(0.01));
+    }
+
+    SECTION("A copy of the mesh gets its own structures") {
+        auto copy = std::make_shared<const TriangleMesh>(*mesh);
+        REQUIRE(cached_face_neighbors(copy) != neighbors);
+        REQUIRE(mesh_cache_size() == num_cached + 2);
+    }
+
+    SECTION("The structures of a released mesh are released") {
+        std::weak_ptr<const AABBTreeIndirect::Tree3f> weak_tree = tree;
+        tree.reset();
+        mesh.reset();
+        REQUIRE(mesh_cache_size() == num_cached);
+        REQUIRE(weak_tree.expired());
+    }
+}
+
 TEST_CASE("Creating a several 2d lines, testing closest point query", "[AABBIndirect]")
 {
     std::vector<Linef> lines { };
@@ -109,6 +182,31 @@ TEST_CASE("Creating a several 2d lines, testing all lines in radius query", "[AA
     REQUIRE(indices.size() == 3);
 }
 
+TEST_CASE("Large 2d lines tree built in parallel, testing closest point query", "[AABBIndirect]")
+{
+    // Enough lines for the tree to be built in parallel.
+    std::vector<Linef> lines;
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<double> dist(0., 100.);
+    for (size_t i = 0; i < 4 * AABBTreeIndirect::Tree2d::parallel_build_threshold; ++ i) {
+        Vec2d a(dist(rng), dist(rng));
+        lines.emplace_back(a, a + Vec2d(dist(rng), dist(rng)) * 0.01);
+    }
+
+    auto tree = AABBTreeLines::build_aabb_tree_over_indexed_lines(lines);
+
+    for (size_t i = 0; i < 100; ++ i) {
+        Vec2d  pt(dist(rng), dist(rng));
+        double min_sqr_dist = std::numeric_limits<double>::max();
+        for (const Linef &line : lines)
+            min_sqr_dist = std::min(min_sqr_dist, line_alg::distance_to_squared(line, pt));
+        size_t hit_idx_out;
+        Vec2d  hit_point_out;
+        auto   sqr_dist = AABBTreeLines::squared_distance_to_indexed_lines(lines, tree, pt, hit_idx_out, hit_point_out);
+        REQUIRE(sqr_dist == Approx(min_sqr_dist));
+    }
+}
+
 TEST_CASE("Find the closest point from ExPolys", "[ClosestPoint]") {
     //////////////////////////////
     //  0 - 3
@@ -159,6 +257,27 @@ TEST_CASE("Find the closest point from ExPolys", "[ClosestPoint]") {
 #include <ctime>
 #include <ratio>
 #include <chrono>
+TEST_CASE("Large EdgeGrid rasterized in parallel, testing signed distance", "[EdgeGrid]")
+{
+    // Enough line segments for the grid to be rasterized in parallel.
+    const size_t num_points = 50000;
+    const double radius     = 50.;
+    Polygon      circle;
+    for (size_t i = 0; i < num_points; ++ i) {
+        double angle = 2. * PI * double(i) / double(num_points);
+        circle.points.emplace_back(scaled(radius * cos(angle)), scaled(radius * sin(angle)));
+    }
+    EdgeGrid::Grid grid;
+    grid.create(Polygons{ circle }, scaled(1.));
+
+    for (double r : { 40., 49., 51., 55. }) {
+        Point pt(scaled(r * cos(1.)), scaled(r * sin(1.)));
+        auto  result = grid.closest_point_signed_distance(pt, scaled(20.));
+        REQUIRE(result.valid());
+        REQUIRE(unscaled(result.distance) == Approx(r - radius).margin(0.01));
+    }
+}
+
 TEST_CASE("AABBTreeLines vs SignedDistanceGrid time Benchmark", "[AABBIndirect]")
 {
     std::vector<Points> lines { Points { } };
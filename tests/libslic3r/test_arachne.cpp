@@ -2,6 +2,7 @@
 
 #include "libslic3r/Arachne/WallToolPaths.hpp"
 #include "libslic3r/ClipperUtils.hpp"
+#include "libslic3r/PerimeterGenerator.hpp"
 #include "libslic3r/SVG.hpp"
 #include "libslic3r/Utils.hpp"
 
@@ -900,4 +901,47 @@ TEST_CASE("Arachne - SPE-2496 - Negative extrusion width", "[Arachne_Negative_Ex
     }
 
     REQUIRE(!has_negative_extrusion_width);
-}
\ No newline at end of file
+}
+TEST_CASE("Arachne - Walls cache reuses the walls of identical outlines", "[ArachneWallsCache]") {
+    const Polygons polygons = { Polygon::new_scale({ { 0., 0. }, { 20., 0. }, { 20., 10. }, { 10., 15. }, { 0., 10. } }) };
+    const coord_t  spacing  = 407079;
+    const PrintObjectConfig &print_object_config = PrintObjectConfig::defaults();
+    const PrintConfig       &print_config        = PrintConfig::defaults();
+
+    Arachne::WallToolPaths wall_tool_paths(polygons, spacing, spacing, 3, 0, 0.2, print_object_config, print_config);
+    const Arachne::Perimeters &expected = wall_tool_paths.getToolPaths();
+
+    auto same_perimeters = [](const Arachne::Perimeters &lhs, const Arachne::Perimeters &rhs) {
+        if (lhs.size() != rhs.size())
+            return false;
+        for (size_t i = 0; i < lhs.size(); ++ i) {
+            if (lhs[i].size() != rhs[i].size())
+                return false;
+            for (size_t j = 0; j < lhs[i].size(); ++ j) {
+                const Arachne::ExtrusionLine &l = lhs[i][j];
+                const Arachne::ExtrusionLine &r = rhs[i][j];
+                if (l.inset_idx != r.inset_idx || l.is_closed != r.is_closed || l.junctions.size() != r.junctions.size())
+                    return false;
+                for (size_t k = 0; k < l.junctions.size(); ++ k)
+                    if (l.junctions[k].p != r.junctions[k].p || l.junctions[k].w != r.junctions[k].w)
+                        return false;
+            }
+        }
+        return true;
+    };
+
+    PerimeterGenerator::ArachneWallsCache cache;
+    PerimeterGenerator::ArachneWallsCache::Walls walls = cache.walls(polygons, spacing, spacing, 3, 0.2, print_object_config, print_config);
+    REQUIRE(cache.num_hits() == 0);
+    REQUIRE(same_perimeters(walls.perimeters, expected));
+    REQUIRE(walls.inner_contour == wall_tool_paths.getInnerContour());
+
+    walls = cache.walls(polygons, spacing, spacing, 3, 0.2, print_object_config, print_config);
+    REQUIRE(cache.num_hits() == 1);
+    REQUIRE(same_perimeters(walls.perimeters, expected));
+
+    // Different layer height or different number of walls are not served from the cache.
+    cache.walls(polygons, spacing, spacing, 3, 0.3, print_object_config, print_config);
+    cache.walls(polygons, spacing, spacing, 2, 0.2, print_object_config, print_config);
+    REQUIRE(cache.num_hits() == 1);
+}
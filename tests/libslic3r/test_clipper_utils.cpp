@@ -384,3 +384,47 @@ TEST_CASE("Traversing Clipper PolyTree", "[ClipperUtils]") {
         REQUIRE(count_polys(output) == reference.size());
     }
 }
+
+TEST_CASE("Boolean operations with islands not overlapping the other operand", "[ClipperUtils]") {
+    const auto UNIT = coord_t(1. / SCALING_FACTOR);
+    const Polygon unitbox { { 0, 0 }, { UNIT, 0 }, { UNIT, UNIT }, { 0, UNIT } };
+
+    // A row of ten unit squares, two units apart.
+    ExPolygons subject;
+    for (int i = 0; i < 10; ++ i) {
+        subject.emplace_back(unitbox);
+        subject.back().translate(2 * i * UNIT, 0);
+    }
+    // The first square half covered, the second square touched along its right side, the others far away.
+    Polygons clip;
+    clip.emplace_back(unitbox);
+    clip.back().translate(UNIT / 2, 0);
+    clip.emplace_back(unitbox);
+    clip.back().translate(3 * UNIT, 0);
+    for (int i = 0; i < 10; ++ i) {
+        clip.emplace_back(unitbox);
+        clip.back().translate(2 * i * UNIT, 10 * UNIT);
+    }
+    const double unit_area = unitbox.area();
+
+    SECTION("Difference keeps the islands not touched by the clip") {
+        ExPolygons out = diff_ex(subject, clip);
+        REQUIRE(out.size() == 10);
+        REQUIRE(area(out) == Approx(9.5 * unit_area));
+        REQUIRE(area(diff(subject, clip)) == Approx(9.5 * unit_area));
+    }
+    SECTION("Intersection keeps the overlapping parts only") {
+        ExPolygons out = intersection_ex(subject, clip);
+        REQUIRE(out.size() == 1);
+        REQUIRE(area(out) == Approx(0.5 * unit_area));
+    }
+    SECTION("Clip enclosing the subject far from its holes") {
+        ExPolygon frame { Polygon { { -10 * UNIT, -10 * UNIT }, { 30 * UNIT, -10 * UNIT }, { 30 * UNIT, 30 * UNIT }, { -10 * UNIT, 30 * UNIT } } };
+        Polygon   hole = unitbox;
+        hole.translate(20 * UNIT, 20 * UNIT);
+        hole.reverse();
+        frame.holes.emplace_back(hole);
+        REQUIRE(area(intersection_ex(subject, ExPolygons{ frame })) == Approx(10. * unit_area));
+        REQUIRE(diff_ex(subject, ExPolygons{ frame }).empty());
+    }
+}
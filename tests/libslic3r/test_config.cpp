@@ -9,6 +9,7 @@
 #include <cereal/types/polymorphic.hpp>
 #include <cereal/types/string.hpp> 
 #include <cereal/types/vector.hpp> 
+#include <cereal/types/utility.hpp>
 #include <cereal/archives/binary.hpp>
 
 using namespace Slic3r;
@@ -160,6 +161,28 @@ TEST_CASE("No interference between DynamicConfig objects", "[Config]") {
     CHECK(config.opt_string("fill_pattern") == "line");
 }
 
+TEST_CASE("DynamicConfig keys are sorted and unique", "[Config]") {
+    DynamicPrintConfig config;
+    config.set_key_value("perimeters", new ConfigOptionInt(3));
+    config.set_key_value("fill_density", new ConfigOptionPercent(20));
+    config.set_key_value("top_solid_layers", new ConfigOptionInt(4));
+    CHECK(! config.set_key_value("fill_density", new ConfigOptionPercent(15)));
+    config.set_deserialize_strict("bottom_solid_layers", "5");
+    CHECK(config.keys() == t_config_option_keys{ "bottom_solid_layers", "fill_density", "perimeters", "top_solid_layers" });
+    CHECK(config.opt_int("bottom_solid_layers") == 5);
+    CHECK(config.option<ConfigOptionPercent>("fill_density")->value == 15);
+
+    DynamicPrintConfig config2;
+    config2.set_key_value("perimeters", new ConfigOptionInt(2));
+    config2.set_key_value("brim_width", new ConfigOptionFloat(5));
+    config2 += config;
+    CHECK(config2.keys() == t_config_option_keys{ "bottom_solid_layers", "brim_width", "fill_density", "perimeters", "top_solid_layers" });
+    CHECK(config2.opt_int("perimeters") == 3);
+    CHECK(config2.diff(config).empty());
+    CHECK(config2.erase("brim_width"));
+    CHECK(config2 == config);
+}
+
 TEST_CASE("Normalize fdm extruder", "[Config]") {
     DynamicPrintConfig config;
     config.set("extruder", 2, true);
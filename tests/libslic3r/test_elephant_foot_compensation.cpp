@@ -607,4 +607,23 @@ SCENARIO("Elephant foot compensation", "[ElephantFoot]") {
             }
         }
 	}
+
+	GIVEN("Large box and vase with fins") {
+		ExPolygons expolys { ExPolygon( { {50000000, 50000000 }, { 0, 50000000 }, { 0, 0 }, { 50000000, 0 } } ), vase_with_fins() };
+		expolys.back().translate(Point(100000000, 0));
+		Flow flow(0.419999987f, 0.2f, 0.4f);
+		ElephantFootCompensationCache cache;
+        WHEN("Compensated through a cache") {
+			ExPolygons expolys_compensated = cache.compensate(expolys, flow, 0.21f);
+            THEN("the result matches the uncached compensation") {
+                REQUIRE(expolys_compensated == elephant_foot_compensation(expolys, flow, 0.21f));
+            }
+            THEN("the result is reused for the same input") {
+                REQUIRE(cache.compensate(expolys, flow, 0.21f) == expolys_compensated);
+            }
+            THEN("the result is recalculated for a different compensation") {
+                REQUIRE(cache.compensate(expolys, flow, 0.41f) == elephant_foot_compensation(expolys, flow, 0.41f));
+            }
+        }
+	}
 }
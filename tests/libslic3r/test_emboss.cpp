@@ -362,6 +362,32 @@ nor why it should choose to collapse on Betelgeuse Seven\".";
     //its_write_obj(its, "C:/data/temp/text.obj");
 }
 
+TEST_CASE("Instance glyph models from cache", "[Emboss]")
+{
+    auto font = Emboss::create_font_file(get_font_filepath().c_str());
+    REQUIRE(font != nullptr);
+
+    Emboss::FontFileWithCache ffwc(std::move(font));
+    FontProp fp{10.f};
+    ExPolygonsWithIds letters = Emboss::text2vshapes(ffwc, L"aXa", fp);
+    REQUIRE(letters.size() == 3);
+
+    double depth = 100.;
+    Transform3d tr = Eigen::Translation<double, 3>(1., 2., 3.) * Eigen::Scaling(0.01);
+    Emboss::GlyphMeshes cache;
+    for (const ExPolygonsWithId &letter : letters) {
+        indexed_triangle_set its = Emboss::glyph2model(letter.expoly, static_cast<int>(letter.id), depth, tr, cache);
+        Emboss::ProjectTransform projection(std::make_unique<Emboss::ProjectZ>(depth), tr);
+        indexed_triangle_set expected = Emboss::polygons2model(letter.expoly, projection);
+        CHECK(its.indices == expected.indices);
+        REQUIRE(its.vertices.size() == expected.vertices.size());
+        for (size_t i = 0; i < its.vertices.size(); ++i)
+            CHECK(its.vertices[i].isApprox(expected.vertices[i], 1e-5f));
+    }
+    // letter 'a' is extruded only once
+    CHECK(cache.size() == 2);
+}
+
 TEST_CASE("Test hit point", "[AABBTreeIndirect]")
 {
     indexed_triangle_set its;
@@ -0,0 +1,65 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_template_test_macros.hpp>
+
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "libslic3r/Execution/ExecutionSeq.hpp"
+#include "libslic3r/Execution/ExecutionTBB.hpp"
+
+using namespace Slic3r;
+
+TEMPLATE_TEST_CASE("Execution scan computes inclusive prefix sums", "[Execution]", ExecutionSeq, ExecutionTBB) {
+    const TestType ep{};
+
+    std::vector<long> out(10000);
+    const long total = execution::scan(ep, size_t(0), out.size(), out.begin(), 5L,
+                                       [](long a, long b) { return a + b; },
+                                       [](size_t i) { return long(i); }, 16);
+
+    long expected = 5;
+    for (size_t i = 0; i < out.size(); ++i) {
+        expected += long(i);
+        REQUIRE(out[i] == expected);
+    }
+    CHECK(total == expected);
+
+    std::vector<int> empty;
+    CHECK(execution::scan(ep, 0, 0, empty.begin(), 7, std::plus<int>{}, [](int i) { return i; }) == 7);
+}
+
+TEMPLATE_TEST_CASE("Execution pipeline consumes the results in order", "[Execution]", ExecutionSeq, ExecutionTBB) {
+    const TestType ep{};
+
+    std::vector<int> values(1000);
+    std::iota(values.begin(), values.end(), 0);
+
+    std::string result;
+    execution::pipeline(ep, values.begin(), values.end(),
+        [](const int &value) { return std::to_string(2 * value) + ","; },
+        [&result](std::string &&str) { result += str; });
+
+    std::string expected;
+    for (int value : values)
+        expected += std::to_string(2 * value) + ",";
+    CHECK(result == expected);
+
+    std::vector<int> indices;
+    execution::pipeline(ep, 0, 100, [](int i) { return i; }, [&indices](int &&i) { indices.push_back(i); }, 3);
+    CHECK(indices == std::vector<int>(values.begin(), values.begin() + 100));
+}
+
+TEMPLATE_TEST_CASE("Execution invoke runs all the tasks", "[Execution]", ExecutionSeq, ExecutionTBB) {
+    const TestType ep{};
+
+    int a = 0, b = 0, c = 0;
+    execution::invoke(ep, [&a] { a = 1; }, [&b] { b = 2; }, [&c] { c = 3; });
+    // Dependent tasks are run by consecutive calls.
+    execution::invoke(ep, [&a, &b, &c] { a += b + c; });
+    execution::invoke(ep);
+
+    CHECK(a == 6);
+    CHECK(b == 2);
+    CHECK(c == 3);
+}
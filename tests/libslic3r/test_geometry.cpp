@@ -16,6 +16,7 @@
 
 #include "../data/prusaparts.hpp"
 
+#include <set>
 #include <unordered_set>
 
 using namespace Slic3r;
@@ -458,6 +459,45 @@ SCENARIO("Path chaining", "[Geometry]") {
 			}
 		}
 	}
+	GIVEN("Many short lines") {
+		Polylines polylines;
+		for (int row = 0; row < 60; ++ row)
+			for (int col = 0; col < 60; ++ col) {
+				// Slightly perturbed grid of lines to avoid ties in the closest point searches.
+				coord_t jitter = coord_t((row * 7919 + col * 104729) % 1000);
+				polylines.emplace_back(Point(scaled(3. * col) + jitter, scaled(double(row))), Point(scaled(3. * col + 2.) - jitter, scaled(double(row)) + jitter));
+			}
+		auto num_chained_once = [&polylines](const Polylines &chained) {
+			std::set<Point> end_points;
+			for (const Polyline &pl : chained)
+				end_points.insert(std::min(pl.first_point(), pl.last_point()));
+			return chained.size() == polylines.size() ? end_points.size() : 0;
+		};
+		auto connection_length = [](const Polylines &chained) {
+			double length = 0.;
+			for (size_t i = 1; i < chained.size(); ++ i)
+				length += (chained[i].first_point() - chained[i - 1].last_point()).cast<double>().norm();
+			return length;
+		};
+		WHEN("Chained") {
+			Polylines chained = chain_polylines(polylines);
+			THEN("Each line is chained exactly once") {
+				REQUIRE(num_chained_once(chained) == polylines.size());
+			}
+			THEN("Lines are connected mostly to their neighbors") {
+				REQUIRE(connection_length(chained) < scaled(1.5 * polylines.size()));
+			}
+		}
+		WHEN("Chained from a start point") {
+			Polylines chained = chain_polylines(polylines, &polylines.front().first_point());
+			THEN("Each line is chained exactly once") {
+				REQUIRE(num_chained_once(chained) == polylines.size());
+			}
+			THEN("Lines are connected mostly to their neighbors") {
+				REQUIRE(connection_length(chained) < scaled(1.5 * polylines.size()));
+			}
+		}
+	}
 }
 
 SCENARIO("Line distances", "[Geometry]"){
@@ -4,6 +4,7 @@
 #include <catch2/catch_test_macros.hpp>
 
 #include "libslic3r/TriangleMesh.hpp"
+#include "libslic3r/MeshSplitImpl.hpp"
 
 using namespace Slic3r;
 
@@ -103,6 +104,97 @@ TEST_CASE("Split two watertight meshes", "[its_split][its]") {
     debug_write_obj(res, "parts_watertight");
 }
 
+TEST_CASE("Topology of a mesh calculated in parallel", "[its]") {
+    using namespace Slic3r;
+
+    auto sphere1 = its_make_sphere(10., 2 * PI / 200.), sphere2 = sphere1;
+    its_transform(sphere2, identity3f().translate(Vec3f{30.f, 0.f, 0.f}));
+    its_merge(sphere1, sphere2);
+    // Open the second sphere.
+    sphere1.indices.pop_back();
+
+    const MeshTopology topology = its_topology(sphere1);
+    REQUIRE(topology.face_neighbors == its_face_neighbors(sphere1));
+    REQUIRE(topology.number_of_patches == 2);
+    REQUIRE(topology.number_of_patches == its_number_of_patches(sphere1));
+    REQUIRE(topology.open_edges == 3);
+    REQUIRE(topology.open_edges == its_num_open_edges(sphere1));
+    REQUIRE(std::abs(topology.volume - its_volume(sphere1)) < 1e-4 * its_volume(sphere1));
+
+    std::vector<indexed_triangle_set> parts = its_split(sphere1, topology);
+    REQUIRE(parts.size() == 2);
+    REQUIRE(parts[0].indices.size() == sphere2.indices.size());
+    REQUIRE(parts[0].vertices.size() == sphere2.vertices.size());
+    REQUIRE(parts[1].indices.size() == sphere2.indices.size() - 1);
+    REQUIRE(its_num_open_edges(parts[1]) == 3);
+}
+
+TEST_CASE("Patches found in parallel are numbered by their first face", "[its_split][its]") {
+    using namespace Slic3r;
+
+    // Interleave the faces of three spheres, so that the union-find links patches discovered from many seeds.
+    indexed_triangle_set spheres;
+    for (int i = 0; i < 3; ++ i) {
+        auto sphere = its_make_sphere(1., 2 * PI / 100.);
+        its_transform(sphere, identity3f().translate(Vec3f{3.f * float(i), 0.f, 0.f}));
+        its_merge(spheres, sphere);
+    }
+    std::mt19937 rng(3);
+    std::shuffle(spheres.indices.begin(), spheres.indices.end(), rng);
+
+    const std::vector<Vec3i> face_neighbors = its_face_neighbors(spheres);
+    size_t                   num_patches    = 0;
+    const std::vector<int>   face_patches   = create_face_patches_index(ex_tbb, face_neighbors, num_patches);
+    REQUIRE(num_patches == 3);
+
+    // The serial flood fill discovers the patches in the same order.
+    meshsplit_detail::NeighborVisitor visitor(spheres, face_neighbors);
+    for (int patch = 0; patch < 3; ++ patch)
+        visitor.visit([&face_patches, patch](size_t idx) { REQUIRE(face_patches[idx] == patch); return true; });
+
+    std::vector<indexed_triangle_set> parts = its_split(spheres);
+    REQUIRE(parts.size() == 3);
+    for (const indexed_triangle_set &part : parts)
+        REQUIRE(its_num_open_edges(part) == 0);
+}
+
+TEST_CASE("Merge vertices of a triangle soup", "[its]") {
+    using namespace Slic3r;
+
+    // The vertices of the cube in the centers of the cells of a grid of 0.01mm.
+    const float eps  = 0.01f;
+    auto        cube = its_make_cube(10., 10., 10.);
+    its_transform(cube, identity3f().translate(Vec3f{0.5f * eps, 0.5f * eps, 0.5f * eps}));
+
+    // Each triangle with its own vertices, the vertices of a triangle soup.
+    indexed_triangle_set soup;
+    for (const stl_triangle_vertex_indices &face : cube.indices) {
+        int idx = int(soup.vertices.size());
+        for (int i = 0; i < 3; ++ i)
+            soup.vertices.emplace_back(cube.vertices[face(i)]);
+        soup.indices.emplace_back(idx, idx + 1, idx + 2);
+    }
+
+    SECTION("Exactly the same vertices are merged") {
+        REQUIRE(its_merge_vertices(soup) == int(soup.indices.size() * 3 - cube.vertices.size()));
+        REQUIRE(soup.vertices.size() == cube.vertices.size());
+        REQUIRE(its_num_open_edges(soup) == 0);
+    }
+
+    SECTION("Vertices in the same cell of the epsilon grid are merged") {
+        // Move the vertices by a fraction of the grid cell, so that they do not match exactly anymore.
+        std::mt19937 rng(0);
+        std::uniform_real_distribution<float> noise(-0.1f * eps, 0.1f * eps);
+        for (Vec3f &v : soup.vertices)
+            v += Vec3f(noise(rng), noise(rng), noise(rng));
+        indexed_triangle_set exact = soup;
+        REQUIRE(its_merge_vertices(exact) == 0);
+        REQUIRE(its_merge_vertices(soup, true, eps) == int(soup.indices.size() * 3 - cube.vertices.size()));
+        REQUIRE(soup.vertices.size() == cube.vertices.size());
+        REQUIRE(its_num_open_edges(soup) == 0);
+    }
+}
+
 #include <libslic3r/QuadricEdgeCollapse.hpp>
 static float triangle_area(const Vec3f &v0, const Vec3f &v1, const Vec3f &v2)
 {
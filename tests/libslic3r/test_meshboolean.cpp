@@ -4,6 +4,7 @@
 
 #include <libslic3r/TriangleMesh.hpp>
 #include <libslic3r/MeshBoolean.hpp>
+#include <libslic3r/CSGMesh/PerformCSGMeshBooleans.hpp>
 
 using namespace Slic3r;
 using namespace Catch;
@@ -51,3 +52,44 @@ TEST_CASE("Add TriangleMeshes", "[MeshBoolean]")
     //its_write_obj(tm1.its, "test_add.obj");
     CHECK(tm1.its.indices.size() > init_size);
 }
+
+TEST_CASE("CSG booleans reduced in parallel and cached", "[MeshBoolean]")
+{
+    const indexed_triangle_set base = its_make_cube(10., 10., 10.);
+    const indexed_triangle_set hole = its_make_cube(2., 2., 12.);
+
+    auto make_parts = [&base, &hole](const Vec3f &last_hole_pos) {
+        std::vector<csg::CSGPart> parts;
+        parts.emplace_back(&base, csg::CSGType::Union);
+        for (const Vec3f &pos : {Vec3f{1.f, 1.f, -1.f}, Vec3f{4.f, 4.f, -1.f}, last_hole_pos}) {
+            Transform3f tr = Transform3f::Identity();
+            tr.translate(pos);
+            parts.emplace_back(&hole, csg::CSGType::Difference, tr);
+        }
+
+        return parts;
+    };
+
+    MeshBoolean::cgal::CGALMeshCache::global().clear();
+
+    std::vector<csg::CSGPart> parts = make_parts({7.f, 7.f, -1.f});
+    REQUIRE(csg::check_csgmesh_booleans(range(parts)) == parts.end());
+
+    auto cgalm = csg::perform_csgmesh_booleans(range(parts));
+    REQUIRE(cgalm);
+    double volume = its_volume(MeshBoolean::cgal::cgal_to_indexed_triangle_set(*cgalm));
+    CHECK(volume == Approx(1000. - 3 * 40.));
+    CHECK(MeshBoolean::cgal::CGALMeshCache::global().size() > 0);
+
+    // Only the last hole moves, the result of the base part is reused.
+    parts = make_parts({7.f, 1.f, -1.f});
+    cgalm = csg::perform_csgmesh_booleans(range(parts));
+    REQUIRE(cgalm);
+    volume = its_volume(MeshBoolean::cgal::cgal_to_indexed_triangle_set(*cgalm));
+    CHECK(volume == Approx(1000. - 3 * 40.));
+
+    // Nothing changes, the whole result comes from the cache.
+    auto cached = csg::perform_csgmesh_booleans(range(parts));
+    REQUIRE(cached);
+    CHECK(its_volume(MeshBoolean::cgal::cgal_to_indexed_triangle_set(*cached)) == Approx(volume));
+}
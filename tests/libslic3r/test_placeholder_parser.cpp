@@ -45,6 +45,20 @@ SCENARIO("Placeholder parser scripting", "[PlaceholderParser]") {
     SECTION("multiple expressions with semicolons") { REQUIRE(parser.process("{temperature[foo];;;temperature[foo];}") == "357357"); }
     SECTION("multiple expressions with semicolons 2") { REQUIRE(parser.process("{temperature[foo];;temperature[foo];}") == "357357"); }
     SECTION("multiple expressions with semicolons 3") { REQUIRE(parser.process("{temperature[foo];;;temperature[foo];;}") == "357357"); }
+    SECTION("leading whitespaces are skipped") { REQUIRE(parser.process(" \n {2*3} [temperature]") == "6 357"); }
+    SECTION("if spanning text processed repeatedly") {
+        for (int i = 0; i < 3; ++ i)
+            REQUIRE(parser.process("G1 {if bar == 2}two [temperature_[bar]]{else}other{endif} }") == "G1 two 363 }");
+    }
+    SECTION("error in a code block reports the line of the template") {
+        std::string message;
+        try {
+            parser.process("G28\n[temperature]\nG1 {1 +}\n");
+        } catch (const std::runtime_error &err) {
+            message = err.what();
+        }
+        REQUIRE(message.rfind("Parsing error at line 3", 0) == 0);
+    }
 
     SECTION("parsing string with escaped characters") { REQUIRE(parser.process("{\"hu\\nha\\\\\\\"ha\\\"\"}") == "hu\nha\\\"ha\""); }
 
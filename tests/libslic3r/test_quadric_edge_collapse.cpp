@@ -302,3 +302,21 @@ TEST_CASE("Simplified cube should not be empty.", "[its]")
     its_quadric_edge_collapse(its, wanted_count, &max_error);
     CHECK(!its.indices.empty());
 }
+
+TEST_CASE("Simplify a large sphere by partitioned Quadric edge collapse", "[its][quadric_edge_collapse]")
+{
+    // Large enough to be split into blocks decimated in parallel.
+    indexed_triangle_set sphere          = its_make_sphere(10., 2 * PI / 800.);
+    double               original_volume = its_volume(sphere);
+    REQUIRE(sphere.indices.size() > 600000);
+    uint32_t             wanted_count    = sphere.indices.size() * 0.02;
+    indexed_triangle_set its             = sphere; // copy
+    float                max_error       = std::numeric_limits<float>::max();
+    its_quadric_edge_collapse_parallel(its, wanted_count, &max_error);
+    CHECK(its.indices.size() <= wanted_count);
+    CHECK(its_num_open_edges(its) == 0);
+    CHECK(!Private::exist_triangle_with_twice_vertices(its.indices));
+    CHECK(fabs(original_volume - its_volume(its)) < 0.01 * original_volume);
+    Private::Similarity similarity = Private::get_similarity(sphere, its);
+    CHECK(similarity.max_distance < 0.05f);
+}
@@ -0,0 +1,42 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <boost/filesystem/operations.hpp>
+
+#include "libslic3r/SliceCache.hpp"
+#include "libslic3r/TriangleMesh.hpp"
+#include "libslic3r/TriangleMeshSlicer.hpp"
+
+using namespace Slic3r;
+
+TEST_CASE("Slice cache round trip", "[SliceCache]") {
+    const boost::filesystem::path dir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("slice_cache_%%%%-%%%%");
+    SliceCache::set_cache_dir(dir.string());
+
+    indexed_triangle_set its = its_make_cube(10., 10., 10.);
+    std::vector<float>   zs{ 0.1f, 2.5f, 5.f, 9.9f };
+    MeshSlicingParamsEx  params;
+    params.closing_radius = 0.049f;
+
+    std::string key = SliceCache::make_key(its, zs, params);
+    REQUIRE(key.size() == 32);
+
+    std::vector<ExPolygons> layers;
+    REQUIRE(! SliceCache::load(key, layers));
+
+    std::vector<ExPolygons> sliced = slice_mesh_ex(its, zs, params);
+    SliceCache::store(key, sliced);
+    REQUIRE(SliceCache::load(key, layers));
+    REQUIRE(layers == sliced);
+
+    SECTION("Changing the slicing parameters changes the key") {
+        params.extra_offset = 0.1f;
+        REQUIRE(SliceCache::make_key(its, zs, params) != key);
+    }
+    SECTION("Changing the slicing planes changes the key") {
+        zs.back() = 9.8f;
+        REQUIRE(SliceCache::make_key(its, zs, params) != key);
+    }
+
+    SliceCache::set_cache_dir({});
+    boost::filesystem::remove_all(dir);
+}
@@ -1,9 +1,12 @@
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
 
 #include "libslic3r/Model.hpp"
 #include "libslic3r/Format/STL.hpp"
+#include "libslic3r/TriangleMesh.hpp"
 
 using namespace Slic3r;
+using Catch::Approx;
 
 static inline std::string stl_path(const char* path)
 {
@@ -55,3 +58,21 @@ SCENARIO("Reading an STL file", "[stl]") {
 		}
 	}
 }
+
+SCENARIO("Reading an STL file into an indexed triangle set", "[stl]") {
+	for (const char *path : { "Geräte/20mmbox-čřšřěá.stl", "ASCII/20mmbox-LF.stl", "ASCII/20mmbox-CRLF.stl", "ASCII/20mmbox-nonstandard.stl" }) {
+		GIVEN(path) {
+			WHEN("STL file is read directly and through admesh") {
+				indexed_triangle_set its;
+				TriangleMesh         mesh;
+				REQUIRE(Slic3r::load_stl_indexed(stl_path(path).c_str(), its));
+				REQUIRE(mesh.ReadSTLFile(stl_path(path).c_str()));
+				THEN("the meshes should match") {
+					REQUIRE(its.indices.size() == mesh.its.indices.size());
+					REQUIRE(its.vertices.size() == mesh.its.vertices.size());
+					REQUIRE(its_volume(its) == Approx(mesh.volume()));
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,86 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <boost/filesystem/operations.hpp>
+#include <boost/nowide/fstream.hpp>
+#include <sstream>
+#include <thread>
+
+#include "libslic3r/Trace.hpp"
+
+using namespace Slic3r;
+
+static std::string read_file(const std::string &path)
+{
+    boost::nowide::ifstream is(path);
+    std::stringstream ss;
+    ss << is.rdbuf();
+    return ss.str();
+}
+
+TEST_CASE("Trace spans are exported as Chrome trace", "[Trace]") {
+    const std::string path = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("trace_%%%%-%%%%.json")).string();
+
+    { Trace::Span span("not recorded", "Test"); }
+    Trace::start();
+    REQUIRE(Trace::enabled());
+    { Trace::Span span("main thread span", "Test", 42); }
+    std::thread([]() { Trace::Span span("worker thread span", "Test"); }).join();
+    Trace::stop();
+    { Trace::Span span("recorded after stop", "Test"); }
+
+    REQUIRE(Trace::write_chrome_trace(path));
+    const std::string json = read_file(path);
+    boost::filesystem::remove(path);
+
+    CHECK(json.find("\"traceEvents\"") != std::string::npos);
+    CHECK(json.find("\"main thread span\"") != std::string::npos);
+    CHECK(json.find("\"id\":42") != std::string::npos);
+    CHECK(json.find("\"worker thread span\"") != std::string::npos);
+    CHECK(json.find("not recorded") == std::string::npos);
+    CHECK(json.find("recorded after stop") == std::string::npos);
+}
+
+TEST_CASE("Trace counters are exported as Chrome counter events", "[Trace]") {
+    const std::string path = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("trace_%%%%-%%%%.json")).string();
+
+    Trace::counter("not recorded", "Test", -1, 1);
+    Trace::start();
+    Trace::counter("memory counter", "Test", 7, 123456);
+    Trace::stop();
+
+    REQUIRE(Trace::write_chrome_trace(path));
+    const std::string json = read_file(path);
+    boost::filesystem::remove(path);
+
+    CHECK(json.find("\"memory counter\"") != std::string::npos);
+    CHECK(json.find("\"ph\":\"C\"") != std::string::npos);
+    CHECK(json.find("\"id\":7") != std::string::npos);
+    CHECK(json.find("\"value\":123456") != std::string::npos);
+    CHECK(json.find("not recorded") == std::string::npos);
+}
+
+TEST_CASE("Trace spans are aggregated by stats()", "[Trace]") {
+    Trace::start();
+    for (int i = 0; i < 3; ++ i) {
+        Trace::Span outer("outer", "Test", 5);
+        Trace::Span inner("inner", "Test", 5);
+    }
+    Trace::counter("counter", "Test", -1, 1);
+    const Trace::Stats stats = Trace::stats();
+    Trace::stop();
+
+    REQUIRE(stats.spans.size() == 2);
+    for (const Trace::SpanStats &span : stats.spans) {
+        CHECK(span.count == 3);
+        CHECK(span.id == 5);
+        CHECK(span.total_ns <= span.last_end_ns - span.first_start_ns);
+    }
+    REQUIRE(stats.threads.size() == 1);
+    // The inner spans are nested in the outer spans, thus the thread was busy for the duration of the outer spans.
+    const auto outer = std::find_if(stats.spans.begin(), stats.spans.end(), [](const Trace::SpanStats &span){ return std::string(span.name) == "outer"; });
+    REQUIRE(outer != stats.spans.end());
+    CHECK(stats.threads.front().busy_ns == outer->total_ns);
+    CHECK(stats.begin_ns <= outer->first_start_ns);
+    CHECK(stats.end_ns >= outer->last_end_ns);
+}
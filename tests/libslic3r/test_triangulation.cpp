@@ -1,6 +1,8 @@
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
 
 #include <libslic3r/Triangulation.hpp>
+#include <libslic3r/Tesselate.hpp>
 #include <libslic3r/SVG.hpp> // only debug visualization
 
 using namespace Slic3r;
@@ -125,3 +127,62 @@ TEST_CASE("Triangulation 2 polygons with same point", "[triangulation]")
     //Private::store_trinagulation(shape2d, shape_triangles);
     CHECK(shape_triangles.size() == 4);
 }
+
+TEST_CASE("Monotone sweep tesselation", "[triangulation]")
+{
+    // Sum of the triangle areas, negative triangles are counted, zero area triangles are allowed.
+    auto triangles_area = [](const std::vector<Vec3d> &triangles, bool flip, size_t &num_negative) {
+        double area = 0.;
+        num_negative = 0;
+        for (size_t i = 0; i < triangles.size(); i += 3) {
+            double a = 0.5 * cross2(Vec2d((triangles[i + 1] - triangles[i]).head<2>()), Vec2d((triangles[i + 2] - triangles[i]).head<2>()));
+            if (flip)
+                a = -a;
+            if (a < -EPSILON)
+                ++ num_negative;
+            area += a;
+        }
+        return area;
+    };
+
+    // M shape with a comb of holes, the sweep line has to split and merge the monotone polygons.
+    ExPolygon comb({ Point(0, 0), Point(100, 0), Point(100, 50), Point(90, 50), Point(80, 10), Point(70, 50), Point(0, 50) });
+    for (int i = 0; i < 5; ++ i) {
+        Polygon hole({ Point(5 + 12 * i, 5), Point(15 + 12 * i, 5), Point(10 + 12 * i, 25), Point(15 + 12 * i, 45), Point(5 + 12 * i, 45) });
+        hole.reverse();
+        comb.holes.emplace_back(hole);
+    }
+    comb.scale(scale_(1.));
+    const double comb_area = comb.area() * SCALING_FACTOR * SCALING_FACTOR;
+
+    for (bool flip : { NORMALS_UP, NORMALS_DOWN }) {
+        std::vector<Vec3d> triangles = triangulate_expolygon_3d(comb, 1., flip, TesselationMethod::MonotoneSweep);
+        // No vertices are added: n + 2h - 2 triangles.
+        CHECK(triangles.size() == 3 * (count_points(comb) + 2 * comb.holes.size() - 2));
+        size_t num_negative;
+        CHECK(triangles_area(triangles, flip, num_negative) == Catch::Approx(comb_area));
+        CHECK(num_negative == 0);
+        CHECK(std::all_of(triangles.begin(), triangles.end(), [](const Vec3d &pt) { return pt.z() == 1.; }));
+    }
+
+    // Enough points to be triangulated in parallel.
+    ExPolygons expolygons;
+    for (int i = 0; i < 100; ++ i) {
+        ExPolygon &ring = expolygons.emplace_back(make_circle_num_segments(scale_(10.), 64));
+        ring.holes.emplace_back(make_circle_num_segments(scale_(5.), 32));
+        ring.holes.front().reverse();
+        ring.translate(Point::new_scale(30. * (i % 10), 30. * (i / 10)));
+    }
+    REQUIRE(count_points(expolygons) > 4096);
+    double area = 0.;
+    for (const ExPolygon &expoly : expolygons)
+        area += expoly.area() * SCALING_FACTOR * SCALING_FACTOR;
+    std::vector<Vec3d> triangles = triangulate_expolygons_3d(expolygons, 0., NORMALS_UP, TesselationMethod::MonotoneSweep);
+    CHECK(triangles.size() == 3 * 100 * (64 + 32));
+    size_t num_negative;
+    CHECK(triangles_area(triangles, NORMALS_UP, num_negative) == Catch::Approx(area));
+    CHECK(num_negative == 0);
+    // The triangles are concatenated in the order of the input ExPolygons.
+    CHECK(triangles.front().x() < 11.);
+    CHECK(triangles.back().x() > 259.);
+}
@@ -0,0 +1,84 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <set>
+#include <random>
+
+#include "libslic3r/Feature/Interlocking/VoxelUtils.hpp"
+
+using namespace Slic3r;
+
+namespace {
+using CellSet = std::set<std::tuple<coord_t, coord_t, coord_t>>;
+
+CellSet to_set(const VoxelGrid &grid)
+{
+    CellSet out;
+    grid.forEach([&out](const GridPoint3 &p) { out.emplace(p.x(), p.y(), p.z()); });
+    return out;
+}
+
+VoxelGrid random_grid(std::mt19937 &rng, size_t count)
+{
+    std::uniform_int_distribution<coord_t> dist(-20, 20);
+    VoxelGrid grid;
+    for (size_t i = 0; i < count; ++ i)
+        grid.insert(GridPoint3(dist(rng), dist(rng), dist(rng)));
+    return grid;
+}
+} // namespace
+
+TEST_CASE("VoxelGrid set operations", "[VoxelGrid]")
+{
+    std::mt19937 rng(42);
+    const VoxelGrid a = random_grid(rng, 2000);
+    const VoxelGrid b = random_grid(rng, 2000);
+    const CellSet set_a = to_set(a);
+    const CellSet set_b = to_set(b);
+    CHECK(a.size() == set_a.size());
+
+    CellSet expected;
+    VoxelGrid result = a;
+    SECTION("unite") {
+        std::set_union(set_a.begin(), set_a.end(), set_b.begin(), set_b.end(), std::inserter(expected, expected.end()));
+        result.unite(b);
+    }
+    SECTION("intersect") {
+        std::set_intersection(set_a.begin(), set_a.end(), set_b.begin(), set_b.end(), std::inserter(expected, expected.end()));
+        result.intersect(b);
+    }
+    SECTION("subtract") {
+        std::set_difference(set_a.begin(), set_a.end(), set_b.begin(), set_b.end(), std::inserter(expected, expected.end()));
+        result.subtract(b);
+    }
+    SECTION("erase below z") {
+        for (const auto &cell : set_a)
+            if (std::get<2>(cell) >= 3)
+                expected.emplace(cell);
+        result.eraseBelowZ(3);
+    }
+    CHECK(to_set(result) == expected);
+    CHECK(result.size() == expected.size());
+    for (const auto &[x, y, z] : expected)
+        CHECK(result.contains(GridPoint3(x, y, z)));
+}
+
+TEST_CASE("VoxelGrid dilation matches walking dilated polygons", "[VoxelGrid]")
+{
+    const VoxelUtils vu(Vec3crd(100, 100, 2));
+    const ExPolygons polygons{ ExPolygon{ Polygon{ { -250, -130 }, { 730, -40 }, { 510, 660 }, { -80, 380 } } } };
+
+    for (DilationKernel::Type type : { DilationKernel::Type::CUBE, DilationKernel::Type::DIAMOND, DilationKernel::Type::PRISM })
+        for (coord_t kernel_size : { 1, 2, 3 }) {
+            const DilationKernel kernel(GridPoint3(kernel_size, kernel_size, kernel_size), type);
+
+            VoxelGrid expected;
+            vu.walkDilatedPolygons(polygons, 4, kernel, [&expected](GridPoint3 p) {
+                expected.insert(p);
+                return true;
+            });
+
+            VoxelGrid marked;
+            vu.markDilatedPolygons(polygons, 4, kernel, marked);
+            CHECK(to_set(marked.dilated(kernel)) == to_set(expected));
+        }
+}
@@ -69,3 +69,53 @@ TEST_CASE("Archive export test", "[sla_archives]") {
         }
     }
 }
+
+TEST_CASE("Archive export with rasterization on export", "[sla_archives]") {
+    auto registry = registered_sla_archives();
+
+    for (const ArchiveEntry &entry : registry) {
+        INFO(std::string("Testing archive type: ") + entry.id + " -- writing...");
+        SLAPrint print;
+        SLAFullPrintConfig fullcfg;
+
+        auto m = FileReader::load_model(TEST_DATA_DIR PATH_SEPARATOR + std::string("20mm_cube") + ".obj");
+
+        fullcfg.printer_technology.setInt(ptSLA);
+        fullcfg.set("sla_archive_format", entry.id);
+        fullcfg.set("supports_enable", false);
+        fullcfg.set("pad_enable", false);
+
+        DynamicPrintConfig cfg;
+        cfg.apply(fullcfg);
+
+        print.set_status_callback([](const PrintBase::SlicingStatus&) {});
+        print.set_rasterize_on_export(true);
+        print.apply(m, cfg);
+        print.process();
+
+        ThumbnailsList thumbnails;
+        auto outputfname = std::string("output_streamed_20mm_cube.") + entry.ext;
+
+        print.export_print(outputfname, thumbnails, "20mm_cube");
+
+        REQUIRE(boost::filesystem::exists(outputfname));
+
+        if (entry.rdfactoryfn) {
+            INFO(std::string("Testing archive type: ") + entry.id + " -- reading back...");
+            indexed_triangle_set its;
+            DynamicPrintConfig cfg;
+
+            try {
+                import_sla_archive(outputfname, "", its, cfg);
+            } catch (...) {
+                REQUIRE(false);
+            }
+
+            REQUIRE(!its.empty());
+
+            double vol_written = m.mesh().volume();
+            double rel_err     = std::abs(vol_written - its_volume(its)) / vol_written;
+            REQUIRE(rel_err < 0.1);
+        }
+    }
+}
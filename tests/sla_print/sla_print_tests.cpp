@@ -8,6 +8,11 @@
 #include <libslic3r/TriangleMeshSlicer.hpp>
 #include <libslic3r/SLA/SupportTreeMesher.hpp>
 #include <libslic3r/BranchingTree/PointCloud.hpp>
+#include <libslic3r/SLA/CoverageRaster.hpp>
+#include <libslic3r/PNGReadWrite.hpp>
+#include <libslic3r/Model.hpp>
+
+#include "agg/agg_gamma_functions.h"
 
 namespace {
 
@@ -72,6 +77,56 @@ TEST_CASE("WingedPadAroundObjectIsValid", "[SLASupportGeneration]") {
     for (auto &fname : AROUND_PAD_TEST_OBJECTS) test_pad(fname, padcfg);
 }
 
+TEST_CASE("PadFromCachedModelBlueprintShouldMatch", "[SLASupportGeneration]") {
+    indexed_triangle_set cube = its_make_cube(20., 20., 20.);
+
+    sla::SupportTreeConfig supportcfg;
+    supportcfg.enabled = false;
+    sla::SupportableMesh sm{cube, {}, supportcfg};
+
+    sla::PadModelBlueprint blueprint;
+    indexed_triangle_set direct = sla::create_pad(sm, {}, {});
+    indexed_triangle_set cached = sla::create_pad(sm, {}, {}, &blueprint);
+    REQUIRE(!blueprint.heights.empty());
+    REQUIRE(!blueprint.contours.empty());
+
+    // Reused from the blueprint
+    indexed_triangle_set reused = sla::create_pad(sm, {}, {}, &blueprint);
+    REQUIRE(reused.indices.size() == direct.indices.size());
+    REQUIRE(cached.indices.size() == direct.indices.size());
+    REQUIRE(its_volume(reused) == Approx(its_volume(direct)));
+
+    // Other heights are sampled again
+    sm.zoffset = 1.;
+    std::vector<float> prev_heights = blueprint.heights;
+    indexed_triangle_set moved = sla::create_pad(sm, {}, {}, &blueprint);
+    REQUIRE(blueprint.heights != prev_heights);
+    REQUIRE(its_volume(moved) == Approx(its_volume(direct)));
+}
+
+TEST_CASE("BatchedSupportSlicingShouldMatch", "[SLASupportGeneration]") {
+    indexed_triangle_set tree = its_make_cylinder(2., 10.);
+    indexed_triangle_set pad  = its_make_cube(20., 20., 1.);
+    indexed_triangle_set empty;
+
+    std::vector<float> zs = grid(0.05f, 12.f, 0.1f);
+    std::vector<float> other_zs = grid(0.1f, 5.f, 0.05f);
+    std::vector<sla::SupportSlicingInput> inputs = {
+        { &tree, &pad, &zs, 0.005f },
+        { &empty, &pad, &other_zs, 0.005f },
+        { &tree, &empty, &other_zs, 0.005f },
+        { &empty, &empty, &zs, 0.005f },
+    };
+
+    std::vector<std::vector<ExPolygons>> batched = sla::slice(inputs, {});
+    REQUIRE(batched.size() == inputs.size());
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        const sla::SupportSlicingInput &in = inputs[i];
+        REQUIRE(batched[i] == sla::slice(*in.support_mesh, *in.pad_mesh, *in.grid, in.closing_radius, {}));
+    }
+    REQUIRE(batched.back().empty());
+}
+
 TEST_CASE("DefaultSupports::ElevatedSupportGeometryIsValid", "[SLASupportGeneration]") {
     sla::SupportTreeConfig supportcfg;
     supportcfg.object_elevation_mm = 10.;
@@ -205,6 +260,109 @@ TEST_CASE("RasterizedPolygonAreaShouldMatch", "[SLARasterOutput]") {
     REQUIRE(raster_pxsum(raster0) == 0);
 }
 
+TEST_CASE("CoverageRasterShouldMatchAGG", "[SLARasterOutput]") {
+    double disp_w = 120., disp_h = 68.;
+    sla::Resolution res{2560, 1440};
+    sla::PixelDim pixdim{disp_w / res.width_px, disp_h / res.height_px};
+
+    auto bb = BoundingBox({0, 0}, {scaled(disp_w), scaled(disp_h)});
+    sla::RasterBase::Trafo trafo{sla::RasterBase::roPortrait, sla::RasterBase::MirrorX};
+    trafo.center_x = bb.center().x();
+    trafo.center_y = bb.center().y();
+
+    // Disjoint polygons, one of them reaching out of the display.
+    ExPolygons polys;
+    for (double v : { 5., 10., 20. }) {
+        ExPolygon poly = square_with_hole(v);
+        poly.rotate(v / 10.);
+        poly.translate(scaled(2. * v - 40.), scaled(v - 15.));
+        polys.emplace_back(std::move(poly));
+    }
+    polys.emplace_back(Polygon{ {scaled(20.), scaled(-20.)}, {scaled(50.), scaled(-15.)}, {scaled(40.), scaled(10.)} });
+
+    for (double gamma : { 1., 0. }) {
+        sla::RasterGrayscaleAAGammaPower raster_agg(res, pixdim, trafo, gamma > 0 ? gamma : 1.);
+        sla::RasterGrayscaleAA           raster_thr(res, pixdim, trafo, agg::gamma_threshold(.5));
+        sla::RasterGrayscaleCoverage     raster_cov(res, pixdim, trafo, gamma);
+        sla::RasterGrayscaleAA          &raster = gamma > 0 ? static_cast<sla::RasterGrayscaleAA&>(raster_agg) : raster_thr;
+        for (const ExPolygon &poly : polys) {
+            raster.draw(poly);
+            raster_cov.draw(poly);
+        }
+
+        size_t num_diff = 0;
+        int    max_diff = 0;
+        for (size_t row = 0; row < res.height_px; ++ row)
+            for (size_t col = 0; col < res.width_px; ++ col)
+                if (int diff = std::abs(int(raster.read_pixel(col, row)) - int(raster_cov.read_pixel(col, row))); diff > 0) {
+                    ++ num_diff;
+                    max_diff = std::max(max_diff, diff);
+                }
+
+        if (gamma > 0)
+            // Only the rounding of the anti-aliased edges differs.
+            REQUIRE(max_diff <= 4);
+        else
+            // The pixels covered just about half differ.
+            REQUIRE(num_diff < 100);
+    }
+}
+
+
+TEST_CASE("FastPNGEncoderShouldRoundTrip", "[SLARasterOutput]") {
+    double disp_w = 120., disp_h = 68.;
+    sla::Resolution res{2560, 1440};
+    sla::PixelDim pixdim{disp_w / res.width_px, disp_h / res.height_px};
+
+    auto bb = BoundingBox({0, 0}, {scaled(disp_w), scaled(disp_h)});
+    sla::RasterBase::Trafo trafo;
+    trafo.center_x = bb.center().x();
+    trafo.center_y = bb.center().y();
+
+    sla::RasterGrayscaleAAGammaPower raster(res, pixdim, trafo, 1.);
+    for (double v : { 5., 10., 20. }) {
+        ExPolygon poly = square_with_hole(v);
+        poly.translate(scaled(2. * v - 40.), scaled(v - 15.));
+        raster.draw(poly);
+    }
+
+    sla::EncodedRaster encoded = raster.encode(sla::PNGRasterEncoderFast{});
+    REQUIRE(encoded.extension() == std::string("png"));
+
+    png::ImageGreyscale img;
+    REQUIRE(png::decode_png(png::ReadBuf{encoded.data(), encoded.size()}, img));
+    REQUIRE(img.cols == res.width_px);
+    REQUIRE(img.rows == res.height_px);
+
+    size_t num_diff = 0;
+    for (size_t row = 0; row < res.height_px; ++ row)
+        for (size_t col = 0; col < res.width_px; ++ col)
+            num_diff += img.get(row, col) != raster.read_pixel(col, row);
+    REQUIRE(num_diff == 0);
+}
+
+TEST_CASE("InteriorFromReusedGridShouldMatch", "[Hollowing]") {
+    indexed_triangle_set cube = its_make_cube(20., 20., 20.);
+    auto csgmesh = std::array{ csg::CSGPart{&cube} };
+
+    sla::HollowingConfig hcfg;
+    VoxelGridPtr grid = sla::generate_interior_grid(range(csgmesh), hcfg);
+    REQUIRE(grid);
+
+    double prev_volume = its_volume(cube);
+    for (double thickness : { 1., 3. }) {
+        hcfg.min_thickness = thickness;
+        sla::InteriorPtr direct = sla::generate_interior(cube, hcfg);
+        sla::InteriorPtr reused = sla::generate_interior(*grid, hcfg);
+        REQUIRE(direct);
+        REQUIRE(reused);
+
+        double volume = its_volume(sla::get_mesh(*reused));
+        REQUIRE(volume == Approx(its_volume(sla::get_mesh(*direct))));
+        REQUIRE(volume < prev_volume);
+        prev_volume = volume;
+    }
+}
 
 TEST_CASE("halfcone test", "[halfcone]") {
     sla::DiffBridge br{Vec3d{1., 1., 1.}, Vec3d{10., 10., 10.}, 0.25, 0.5};
@@ -225,3 +383,39 @@ TEST_CASE("Test concurrency")
 
     REQUIRE(s == Approx(ref));
 }
+
+TEST_CASE("Slice based preview of negative volumes", "[SLAPrint]")
+{
+    Model m;
+    ModelObject *mo = m.add_object();
+    mo->add_volume(TriangleMesh{its_make_cube(20., 20., 20.)});
+
+    TriangleMesh hole{its_make_cube(10., 10., 30.)};
+    hole.translate(5.f, 5.f, -5.f);
+    mo->add_volume(std::move(hole), ModelVolumeType::NEGATIVE_VOLUME);
+    mo->add_instance();
+
+    SLAFullPrintConfig fullcfg;
+    fullcfg.printer_technology.setInt(ptSLA);
+    fullcfg.set("supports_enable", false);
+    fullcfg.set("pad_enable", false);
+
+    DynamicPrintConfig cfg;
+    cfg.apply(fullcfg);
+
+    SLAPrint print;
+    print.set_slice_based_preview(true);
+    print.set_status_callback([](const PrintBase::SlicingStatus&) {});
+    print.apply(m, cfg);
+    print.process();
+
+    REQUIRE(print.objects().size() == 1);
+
+    std::shared_ptr<const indexed_triangle_set> preview = print.objects().front()->get_mesh_to_print();
+    REQUIRE(preview);
+    REQUIRE(!preview->empty());
+    REQUIRE(its_volume(*preview) == Approx(20. * 20. * 20. - 10. * 10. * 20.).epsilon(0.02));
+
+    // The preview is generated only once.
+    REQUIRE(print.objects().front()->get_mesh_to_print() == preview);
+}
@@ -149,4 +149,31 @@ TEST_CASE("Invalid value Thumbnails", "[Thumbnails]") {
         REQUIRE(errors.has(ThumbnailError::InvalidVal));
         REQUIRE(thumbnails.size() == 2);
     }
-}
\ No newline at end of file
+}
+TEST_CASE("Render and compress Thumbnails", "[Thumbnails]") {
+    auto [thumbnails_list, errors] = make_and_check_thumbnail_list("16x16/PNG, 16x16/QOI, 32x8/JPG");
+    REQUIRE(errors == enum_bitmask<ThumbnailError>());
+
+    size_t calls = 0;
+    ThumbnailsGeneratorCallback thumbnail_cb = [&calls](const ThumbnailsParams &params) {
+        ++ calls;
+        ThumbnailsList thumbnails;
+        for (const Vec2d &size : params.sizes) {
+            ThumbnailData &data = thumbnails.emplace_back();
+            data.set((unsigned int)size.x(), (unsigned int)size.y());
+            std::fill(data.pixels.begin(), data.pixels.end(), 128);
+        }
+        return thumbnails;
+    };
+
+    std::vector<CompressedThumbnail> compressed = render_and_compress_thumbnails(thumbnail_cb, thumbnails_list);
+    REQUIRE(calls == 1);
+    REQUIRE(compressed.size() == 3);
+    CHECK(compressed[0].format == GCodeThumbnailsFormat::PNG);
+    CHECK(compressed[1].format == GCodeThumbnailsFormat::QOI);
+    CHECK(compressed[2].format == GCodeThumbnailsFormat::JPG);
+    CHECK(compressed[2].width == 32);
+    CHECK(compressed[2].height == 8);
+    for (const CompressedThumbnail &thumbnail : compressed)
+        CHECK(thumbnail.buffer->size > 0);
+}
@@ -0,0 +1,38 @@
+#include <catch2/catch_test_macros.hpp>
+#include <test_utils.hpp>
+
+#include <libslic3r/Model.hpp>
+#include <libslic3r/TriangleMesh.hpp>
+#include <libslic3r/GCode/ThumbnailRenderer.hpp>
+
+using namespace Slic3r;
+using namespace GCodeThumbnails;
+
+TEST_CASE("Software thumbnail renderer", "[Thumbnails]") {
+    Model model;
+    ModelObject *object = model.add_object();
+    object->add_volume(make_cube(20., 20., 20.));
+    object->add_instance();
+
+    ThumbnailsParams params{ { Vec2d(16., 16.), Vec2d(64., 32.) }, true, true, false, true };
+    ThumbnailsList thumbnails = render_thumbnails_software(model, params, { ColorRGBA::ORANGE() });
+    REQUIRE(thumbnails.size() == 2);
+    CHECK(thumbnails[1].width == 64);
+    CHECK(thumbnails[1].height == 32);
+
+    for (const ThumbnailData &thumbnail : thumbnails) {
+        REQUIRE(thumbnail.is_valid());
+        auto alpha = [&thumbnail](unsigned int x, unsigned int y) { return thumbnail.pixels[(y * thumbnail.width + x) * 4 + 3]; };
+        // The cube is centered, the corners of the image show the transparent background.
+        CHECK(alpha(thumbnail.width / 2, thumbnail.height / 2) == 255);
+        CHECK(alpha(0, 0) == 0);
+        CHECK(alpha(thumbnail.width - 1, thumbnail.height - 1) == 0);
+    }
+
+    SECTION("Opaque background") {
+        params.transparent_background = false;
+        thumbnails = render_thumbnails_software(model, params, {});
+        REQUIRE(thumbnails.size() == 2);
+        CHECK(thumbnails.front().pixels[3] == 255);
+    }
+}